@@ -0,0 +1,173 @@
+// Name resolution throughput of the binder. Generates one large module whose
+// binding is dominated by lookups: functions with deeply nested blocks that
+// read locals from every enclosing level, module-level helpers called from
+// the innermost blocks, an overload set with many arities, and wide classes
+// whose methods read fields and call each other. Parsing happens once per
+// run and is not timed; the best of several binds is reported.
+//
+//   meson compile -C build zap-binder-bench
+//   ./build/zap-binder-bench          # default size
+//   ./build/zap-binder-bench 4        # four times as many declarations
+
+#include "frontend/frontend_session.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifndef ZAPC_CORE_DIR
+#define ZAPC_CORE_DIR "core"
+#endif
+#ifndef ZAPC_STDLIB_DIR
+#define ZAPC_STDLIB_DIR "std"
+#endif
+
+namespace {
+
+constexpr int Depth = 24;
+constexpr int Arities = 16;
+constexpr int Fields = 128;
+
+std::string generate(int scale) {
+  std::string out;
+  const int helpers = 64 * scale;
+  for (int h = 0; h < helpers; ++h) {
+    const auto id = std::to_string(h);
+    out += "fun helper" + id + "(value: Int) Int {\n    return value + " + id +
+           ";\n}\n\n";
+  }
+
+  for (int arity = 1; arity <= Arities; ++arity) {
+    out += "fun mix(";
+    for (int p = 0; p < arity; ++p) {
+      out += (p ? ", a" : "a") + std::to_string(p) + ": Int";
+    }
+    out += ") Int {\n    return a0 + " + std::to_string(arity) + ";\n}\n\n";
+  }
+
+  for (int cls = 0; cls < 4 * scale; ++cls) {
+    const auto name = "Wide" + std::to_string(cls);
+    out += "class " + name + " {\n";
+    for (int f = 0; f < Fields; ++f) {
+      out += "    pub field" + std::to_string(f) + ": Int;\n";
+    }
+    out += "\n    fun init() {\n";
+    for (int f = 0; f < Fields; ++f) {
+      out += "        self.field" + std::to_string(f) + " = " +
+             std::to_string(f) + ";\n";
+    }
+    out += "    }\n";
+    for (int m = 0; m < Fields / 2; ++m) {
+      const auto id = std::to_string(m);
+      out += "\n    pub fun get" + id + "() Int {\n        return self.field" +
+             id + " + self.field" + std::to_string(Fields - 1 - m) + ";\n    }\n";
+    }
+    out += "\n    pub fun total() Int {\n        var sum: Int = 0;\n";
+    for (int m = 0; m < Fields / 2; ++m) {
+      out += "        sum = sum + self.get" + std::to_string(m) + "();\n";
+    }
+    out += "        return sum;\n    }\n}\n\n";
+  }
+
+  const int functions = 32 * scale;
+  for (int fn = 0; fn < functions; ++fn) {
+    out += "fun nested" + std::to_string(fn) + "(seed: Int) Int {\n";
+    out += "    var result: Int = seed;\n";
+    std::string indent = "    ";
+    for (int d = 0; d < Depth; ++d) {
+      const auto local = "v" + std::to_string(d);
+      out += indent + "if result >= " + std::to_string(d) + " {\n";
+      indent += "    ";
+      out += indent + "var " + local + ": Int = result";
+      for (int outer = 0; outer < d; ++outer) {
+        out += " + v" + std::to_string(outer);
+      }
+      out += ";\n";
+      out += indent + "result = helper" + std::to_string((fn + d) % helpers) +
+             "(" + local + ");\n";
+      out += indent + "result = result + mix(";
+      for (int p = 0; p <= d % Arities; ++p) {
+        out += (p ? ", v" : "v") + std::to_string(d - p % (d + 1));
+      }
+      out += ");\n";
+    }
+    for (int d = Depth; d > 0; --d) {
+      indent.resize(indent.size() - 4);
+      out += indent + "}\n";
+    }
+    out += "    return result;\n}\n\n";
+  }
+
+  out += "fun main() Int {\n    var total: Int = 0;\n";
+  for (int cls = 0; cls < 4 * scale; ++cls) {
+    const auto id = std::to_string(cls);
+    out += "    var wide" + id + " = new Wide" + id + "();\n";
+    out += "    total = total + wide" + id + ".total();\n";
+  }
+  for (int fn = 0; fn < functions; ++fn) {
+    out += "    total = total + nested" + std::to_string(fn) + "(total);\n";
+  }
+  out += "    return total * 0;\n}\n";
+  return out;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int scale = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1;
+  const std::filesystem::path entry = "/binder-bench/main.zp";
+  const std::string source = generate(scale);
+
+  using namespace zap::frontend;
+  FrontendSessionConfig config{
+      RuntimePaths(argv[0], ZAPC_CORE_DIR, ZAPC_STDLIB_DIR, ""), ImportMap{}};
+  FrontendSession session(
+      config,
+      [&](const std::filesystem::path &path) -> std::optional<std::string> {
+        if (path == entry) {
+          return source;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+          return std::nullopt;
+        }
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+      });
+
+  const int repeat = 5;
+  double best = 1e30;
+  size_t diagnostics = 0;
+  for (int i = 0; i < repeat; ++i) {
+    auto project = session.load(entry);
+    if (!project.loaded) {
+      for (const auto &error : project.errors) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+      }
+      return 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const bool bound = session.bind(project);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+    diagnostics = project.diagnostics.size();
+    if (!bound || diagnostics != 0) {
+      for (const auto &diagnostic : project.diagnostics) {
+        std::fprintf(stderr, "%u:%u: %s\n", diagnostic.span.line,
+                     diagnostic.span.column, diagnostic.message.c_str());
+      }
+      return 1;
+    }
+  }
+
+  std::printf("scale %d, %.2f MB of source, best of %d\n", scale,
+              static_cast<double>(source.size()) / 1e6, repeat);
+  std::printf("%-12s %9.2f ms\n", "bind", best * 1e3);
+  return 0;
+}
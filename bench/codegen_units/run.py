@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Time -O3 builds of a synthetic 50k-line program at several --codegen-units.
+
+The runner writes one program of roughly --lines lines: thousands of small
+functions with loops and branches, each also calling a generic helper at a
+few instantiations, then builds it with --codegen-units=1, 2, 4, ... up to
+the core count, using as many --jobs as units. The whole module is still
+optimized on one thread; only the backend is split, so the speed-up column
+shows how much of an -O3 build instruction selection and emission are.
+Every split build is also checked against the one-unit build's output.
+
+    python3 bench/codegen_units/run.py --zapc build/zapc
+    python3 bench/codegen_units/run.py --zapc build/zapc --units 1 8 -O2
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+GENERIC = """fun choose<T>(flag: Bool, first: T, second: T) T {
+    if flag {
+        return first;
+    }
+    return second;
+}
+
+"""
+
+FUNCTION = """fun work{index}(seed: Int) Int {{
+    var total: Int = seed;
+    var half: Float64 = 0.5;
+    var step: Int32 = 1;
+    var scaled: Float64 = choose<Float64>(seed > {index}, half, half * 3.0);
+    var i: Int = 0;
+    while i < {bound} {{
+        if total % 3 == 0 {{
+            total = total / 3 + choose<Int>(i % 2 == 0, i, {index});
+        }} else {{
+            total = total * 2 + choose<Int32>(true, step, step) as Int;
+        }}
+        scaled = scaled * 1.0001;
+        i = i + 1;
+    }}
+    return total + scaled as Int;
+}}
+
+"""
+
+LINES_PER_FUNCTION = FUNCTION.count("\n")
+
+
+def default_units():
+    cores = os.cpu_count() or 1
+    units = [1]
+    while units[-1] * 2 <= cores:
+        units.append(units[-1] * 2)
+    if units[-1] != cores:
+        units.append(cores)
+    return units
+
+
+def write_program(path, lines):
+    functions = max(1, lines // LINES_PER_FUNCTION)
+    with open(path, "w") as f:
+        f.write(GENERIC)
+        for index in range(functions):
+            f.write(FUNCTION.format(index=index, bound=8 + index % 5))
+        f.write("fun main() Int {\n    var total: Int = 0;\n")
+        for index in range(functions):
+            f.write(f"    total = total + work{index}({index}) % 7;\n")
+        f.write("    return total % 2;\n}\n")
+
+
+def build(zapc, source, binary, opt, units, repeat):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        subprocess.run([zapc, source, f"-O{opt}", f"--codegen-units={units}",
+                        f"--jobs={units}", "-o", binary], check=True)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--units", type=int, nargs="+",
+                        default=default_units(),
+                        help="Code generation unit counts to time")
+    parser.add_argument("--lines", type=int, default=50000,
+                        help="Approximate size of the generated program")
+    parser.add_argument("-O", dest="opt", type=int, default=3,
+                        help="Optimization level")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Builds per unit count; the fastest is reported")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    workdir = tempfile.mkdtemp(prefix="zap-codegen-units-bench-")
+    try:
+        source = os.path.join(workdir, "program.zp")
+        write_program(source, args.lines)
+
+        print(f"{'units':>5} {'time (ms)':>10} {'speed-up':>9}")
+        baseline = None
+        expected = None
+        for units in args.units:
+            binary = os.path.join(workdir, f"program-{units}")
+            elapsed = build(args.zapc, source, binary, args.opt, units,
+                            args.repeat)
+            result = subprocess.run([binary]).returncode
+            if expected is None:
+                expected = result
+            elif result != expected:
+                print(f"{units} units changed the exit code to {result}",
+                      file=sys.stderr)
+                return 1
+            baseline = baseline or elapsed
+            print(f"{units:>5} {elapsed * 1000:>10.1f} "
+                  f"{baseline / elapsed:>8.2f}x")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
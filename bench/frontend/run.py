@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Time cold compiles of a program that imports much of std at several --jobs.
+
+The runner writes a program importing std/json, std/http, std/fs,
+std/collection, std/network and friends, then times `zapc -emit-zir` on it
+with --jobs=1, 2, 4, ... up to the core count. Module reading, lexing and
+parsing is what --jobs spreads over threads; binding and ZIR lowering stay
+serial, so the speed-up column shows how much of the front end that is.
+
+    python3 bench/frontend/run.py --zapc build/zapc
+    python3 bench/frontend/run.py --zapc build/zapc --jobs 1 8 --repeat 10
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+PROGRAM = """import "std/json";
+import "std/http";
+import "std/fs";
+import "std/collection";
+import "std/network";
+import "std/path";
+import "std/process";
+import "std/term";
+import "std/random";
+import "std/strings";
+
+fun main() Int {
+    return 0;
+}
+"""
+
+
+def default_jobs():
+    cores = os.cpu_count() or 1
+    jobs = [1]
+    while jobs[-1] * 2 <= cores:
+        jobs.append(jobs[-1] * 2)
+    if jobs[-1] != cores:
+        jobs.append(cores)
+    return jobs
+
+
+def compile_time(zapc, source, output, jobs, repeat):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        subprocess.run([zapc, source, "-emit-zir", f"--jobs={jobs}",
+                        "-o", output], check=True)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--jobs", type=int, nargs="+", default=default_jobs(),
+                        help="Job counts to time")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="Compiles per job count; the fastest is reported")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    workdir = tempfile.mkdtemp(prefix="zap-frontend-bench-")
+    try:
+        source = os.path.join(workdir, "imports.zp")
+        output = os.path.join(workdir, "imports.zir")
+        with open(source, "w") as f:
+            f.write(PROGRAM)
+
+        print(f"{'jobs':>4} {'time (ms)':>10} {'speed-up':>9}")
+        baseline = None
+        for jobs in args.jobs:
+            elapsed = compile_time(args.zapc, source, output, jobs, args.repeat)
+            baseline = baseline or elapsed
+            print(f"{jobs:>4} {elapsed * 1000:>10.1f} "
+                  f"{baseline / elapsed:>8.2f}x")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
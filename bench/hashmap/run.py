@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Compare std/collection HashMap against the legacy chained map.
+
+For each key count the runner generates a small program that inserts N keys,
+looks every key up, removes half of them and looks them up again, compiles it
+with zapc and reports wall time, throughput and peak RSS of the run.
+
+    python3 bench/hashmap/run.py --zapc build/zapc
+    python3 bench/hashmap/run.py --zapc build/zapc --sizes 1000 100000
+
+The legacy map caps out at 1024 buckets, so its cost grows quadratically; it
+is skipped above --legacy-max keys unless that limit is raised.
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+PROGRAM = """import "std/collection" as collection;
+import "std/convert" as convert;
+{imports}
+fun main() Int {{
+    var m: {map_type}<Int> = new {map_type}<Int>();
+    var n: Int = {count};
+    var i: Int = 0;
+    while i < n {{
+        m.put("key" + convert.toString(i), i);
+        i = i + 1;
+    }}
+
+    var sum: Int = 0;
+    i = 0;
+    while i < n {{
+        sum = sum + m.get("key" + convert.toString(i));
+        i = i + 1;
+    }}
+
+    i = 0;
+    while i < n {{
+        m.remove("key" + convert.toString(i));
+        i = i + 2;
+    }}
+
+    var hits: Int = 0;
+    i = 0;
+    while i < n {{
+        if m.contains("key" + convert.toString(i)) {{
+            hits = hits + 1;
+        }}
+        i = i + 1;
+    }}
+
+    if m.len() != n / 2 || hits != n / 2 || sum != n * (n - 1) / 2 {{
+        return 1;
+    }}
+    return 0;
+}}
+"""
+
+IMPLEMENTATIONS = {
+    "open-addressing": {"imports": "", "map_type": "collection.HashMap"},
+    "legacy-chained": {
+        "imports": 'import "legacy_hashmap" as legacy;\n',
+        "map_type": "legacy.LegacyHashMap",
+    },
+}
+
+
+def build(zapc, workdir, name, count, opt):
+    impl = IMPLEMENTATIONS[name]
+    source = os.path.join(workdir, f"{name}_{count}.zp")
+    binary = os.path.join(workdir, f"{name}_{count}")
+    with open(source, "w") as f:
+        f.write(PROGRAM.format(count=count, **impl))
+    subprocess.run([zapc, source, f"-O{opt}", "-o", binary], check=True)
+    return binary
+
+
+def run(binary):
+    # RUSAGE_CHILDREN reports the peak over all waited-for children, so each
+    # measurement runs in its own helper process.
+    probe = (
+        "import resource, subprocess, sys, time\n"
+        "start = time.perf_counter()\n"
+        "code = subprocess.call([sys.argv[1]])\n"
+        "elapsed = time.perf_counter() - start\n"
+        "rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss\n"
+        "print(code, elapsed, rss)\n"
+    )
+    out = subprocess.check_output([sys.executable, "-c", probe, binary], text=True)
+    code, elapsed, rss = out.split()
+    return int(code), float(elapsed), int(rss)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--sizes", type=int, nargs="+",
+                        default=[1_000, 100_000, 10_000_000])
+    parser.add_argument("--legacy-max", type=int, default=100_000,
+                        help="Largest key count to run the legacy map at")
+    parser.add_argument("-O", dest="opt", default="2", help="Optimization level")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Runs per configuration; the fastest is reported")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    workdir = tempfile.mkdtemp(prefix="zap-hashmap-bench-")
+    shutil.copy(os.path.join(HERE, "legacy_hashmap.zp"), workdir)
+    try:
+        print(f"{'map':<16} {'keys':>10} {'time (s)':>10} {'Mops/s':>8} {'RSS (MiB)':>10}")
+        for count in args.sizes:
+            for name in IMPLEMENTATIONS:
+                if name == "legacy-chained" and count > args.legacy_max:
+                    print(f"{name:<16} {count:>10} {'skipped':>10}")
+                    continue
+                binary = build(args.zapc, workdir, name, count, args.opt)
+                best = None
+                for _ in range(args.repeat):
+                    code, elapsed, rss = run(binary)
+                    if code != 0:
+                        print(f"{name} failed at {count} keys (exit {code})",
+                              file=sys.stderr)
+                        return 1
+                    if best is None or elapsed < best[0]:
+                        best = (elapsed, rss)
+                elapsed, rss = best
+                # put + get + remove + contains
+                ops = count * 3 + count // 2
+                print(f"{name:<16} {count:>10} {elapsed:>10.3f} "
+                      f"{ops / elapsed / 1e6:>8.2f} {rss / 1024:>10.1f}")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Time a one-line edit rebuild of a many-module program with --incremental.
+
+The runner writes a program of --modules modules, each with a few dozen
+functions, and builds it at -O2 three ways: a full build without
+--incremental, a cold --incremental build that fills the object cache, and
+a warm --incremental rebuild after changing one constant in one module.
+Only the edited module's object is optimized and emitted again on the warm
+build; parsing, binding and ZIR lowering still cover the whole program.
+
+    python3 bench/incremental/run.py --zapc build/zapc
+    python3 bench/incremental/run.py --zapc build/zapc --modules 80 --repeat 5
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+FUNCTION = """pub fun step{index}(value: Int) Int {{
+    var total: Int = value;
+    var i: Int = 0;
+    while i < {bound} {{
+        if total % 2 == 0 {{
+            total = total / 2 + i;
+        }} else {{
+            total = total * 3 + 1;
+        }}
+        i = i + 1;
+    }}
+    return total;
+}}
+"""
+
+
+def write_module(path, functions, bound):
+    with open(path, "w") as f:
+        for index in range(functions):
+            f.write(FUNCTION.format(index=index, bound=bound))
+            f.write("\n")
+
+
+def write_program(workdir, modules, functions):
+    with open(os.path.join(workdir, "main.zp"), "w") as f:
+        for index in range(modules):
+            f.write(f'import "./m{index}.zp";\n')
+        f.write("\nfun main() Int {\n    var total: Int = 0;\n")
+        for index in range(modules):
+            f.write(f"    total = total + m{index}.step0({index});\n")
+        f.write("    return total % 2;\n}\n")
+    for index in range(modules):
+        write_module(os.path.join(workdir, f"m{index}.zp"), functions, 16)
+
+
+def build(zapc, workdir, extra):
+    start = time.perf_counter()
+    subprocess.run([zapc, "main.zp", "-O2", "-o", "program", *extra],
+                   cwd=workdir, check=True)
+    return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--modules", type=int, default=40,
+                        help="Modules in the generated program")
+    parser.add_argument("--functions", type=int, default=40,
+                        help="Functions per module")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Builds per mode; the fastest is reported")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+    zapc = os.path.abspath(args.zapc)
+
+    workdir = tempfile.mkdtemp(prefix="zap-incremental-bench-")
+    try:
+        write_program(workdir, args.modules, args.functions)
+        cache = os.path.join(workdir, "cache")
+        incremental = ["--incremental", f"--cache-dir={cache}"]
+
+        full = min(build(zapc, workdir, []) for _ in range(args.repeat))
+        cold = None
+        warm = None
+        edited = os.path.join(workdir, "m0.zp")
+        for attempt in range(args.repeat):
+            shutil.rmtree(cache, ignore_errors=True)
+            write_module(edited, args.functions, 16)
+            elapsed = build(zapc, workdir, incremental)
+            cold = elapsed if cold is None else min(cold, elapsed)
+            write_module(edited, args.functions, 17 + attempt)
+            elapsed = build(zapc, workdir, incremental)
+            warm = elapsed if warm is None else min(warm, elapsed)
+
+        print(f"{'build':<24} {'time (ms)':>10} {'speed-up':>9}")
+        for name, elapsed in (("full", full),
+                              ("incremental, cold", cold),
+                              ("incremental, one edit", warm)):
+            print(f"{name:<24} {elapsed * 1000:>10.1f} "
+                  f"{full / elapsed:>8.2f}x")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,197 @@
+// Lexer and parser throughput in MB/s. Without arguments it times a
+// generated source of about 8 MiB (functions with locals, arithmetic, calls,
+// string literals and comments); with arguments it times those files, e.g.
+// the std tree, one after another as a single workload. Lexing is timed once
+// per scanning level the CPU supports (see src/lexer/lexer_scan.hpp), and
+// without arguments also over comment-heavy and string-heavy sources.
+//
+//   meson compile -C build zap-lexer-bench
+//   ./build/zap-lexer-bench
+//   ./build/zap-lexer-bench $(find std -name '*.zp')
+
+#include "lexer/lexer.hpp"
+#include "lexer/lexer_scan.hpp"
+#include "parser/parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Source {
+  std::string name;
+  std::string text;
+};
+
+std::string generate(size_t targetBytes) {
+  std::string out;
+  out.reserve(targetBytes + 4096);
+  for (size_t fn = 0; out.size() < targetBytes; ++fn) {
+    const auto id = std::to_string(fn);
+    out += "/* helper " + id + ": sums a few values and logs the result.\n";
+    out += "   Block comments span lines like real documentation does. */\n";
+    out += "fun compute_" + id + "(seed: Int, scale: Float) Int {\n";
+    out += "    // running total\n";
+    out += "    var total: Int = seed * 31 + 1_000;\n";
+    out += "    var ratio: Float = scale / 2.5;\n";
+    out += "    let label = \"compute_" + id + " finished\\n\";\n";
+    out += "    for (var i: Int = 0; i < 64; i += 1) {\n";
+    out += "        if (i % 3 == 0 && total > 0x7f) {\n";
+    out += "            total = total - i;\n";
+    out += "        } else {\n";
+    out += "            total = total + i * 2;\n";
+    out += "        }\n";
+    out += "    }\n";
+    out += "    return total;\n";
+    out += "}\n\n";
+  }
+  return out;
+}
+
+std::string generateComments(size_t targetBytes) {
+  std::string out;
+  out.reserve(targetBytes + 4096);
+  for (size_t fn = 0; out.size() < targetBytes; ++fn) {
+    out += "/*\n * Documentation block " + std::to_string(fn) + ".\n";
+    for (int line = 0; line < 8; ++line) {
+      out += " * Describes parameters, return values and error cases at "
+             "some length.\n";
+    }
+    out += " */\n";
+    out += "// A trailing line comment that explains the next declaration.\n";
+    out += "fun doc_" + std::to_string(fn) + "() Int { return 0; }\n\n";
+  }
+  return out;
+}
+
+std::string generateStrings(size_t targetBytes) {
+  std::string out;
+  out.reserve(targetBytes + 4096);
+  for (size_t fn = 0; out.size() < targetBytes; ++fn) {
+    out += "fun text_" + std::to_string(fn) + "() Int {\n";
+    for (int line = 0; line < 6; ++line) {
+      out += "    let message = \"A fairly long message with spaces and "
+             "punctuation, then an escape\\t and more text after it.\";\n";
+    }
+    out += "    return 0;\n}\n\n";
+  }
+  return out;
+}
+
+template <typename F> double bestOf(int repeat, F &&run) {
+  double best = 1e30;
+  for (int i = 0; i < repeat; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+void report(const char *phase, size_t bytes, size_t tokens, double seconds) {
+  std::printf("%-12s %9.2f ms %9.1f MB/s %11.1f Mtok/s\n", phase,
+              seconds * 1e3, static_cast<double>(bytes) / seconds / 1e6,
+              static_cast<double>(tokens) / seconds / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<Source> sources;
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream in(argv[i], std::ios::binary);
+    if (!in) {
+      std::fprintf(stderr, "cannot read %s\n", argv[i]);
+      return 1;
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    sources.push_back({argv[i], text.str()});
+  }
+  if (sources.empty()) {
+    sources.push_back({"generated.zp", generate(8u << 20)});
+  }
+
+  size_t bytes = 0;
+  for (const auto &source : sources) {
+    bytes += source.text.size();
+  }
+  const int repeat = 5;
+  size_t tokens = 0;
+  size_t errors = 0;
+
+  auto lex = [&](const std::vector<Source> &workload,
+                 const lexer_scan::Kernels *kernels) {
+    return bestOf(repeat, [&] {
+      tokens = 0;
+      for (const auto &source : workload) {
+        zap::DiagnosticEngine diagnostics(source.text, source.name);
+        Lexer lexer(diagnostics);
+        lexer._scan = kernels;
+        tokens += lexer.tokenize(source.text).size();
+      }
+    });
+  };
+  std::vector<const lexer_scan::Kernels *> levels;
+  for (auto level : {lexer_scan::Level::Scalar, lexer_scan::Level::Sse2,
+                     lexer_scan::Level::Avx2}) {
+    if (const auto *kernels = lexer_scan::kernelsFor(level)) {
+      levels.push_back(kernels);
+    }
+  }
+  std::vector<std::pair<std::string, double>> lexTimes;
+  for (const auto *kernels : levels) {
+    lexTimes.emplace_back(
+        std::string("lex/") + lexer_scan::levelName(kernels->level),
+        lex(sources, kernels));
+  }
+  const double parseSeconds = bestOf(repeat, [&] {
+    errors = 0;
+    for (const auto &source : sources) {
+      zap::DiagnosticEngine diagnostics(source.text, source.name);
+      Lexer lexer(diagnostics);
+      zap::Parser parser(lexer.tokenize(source.text), diagnostics);
+      auto root = parser.parse();
+      errors += diagnostics.hadErrors() ? 1 : 0;
+    }
+  });
+
+  std::printf("%zu file(s), %.2f MB, %zu tokens, best of %d, scanning with "
+              "%s\n",
+              sources.size(), static_cast<double>(bytes) / 1e6, tokens,
+              repeat, lexer_scan::levelName(lexer_scan::kernels().level));
+  for (const auto &[phase, seconds] : lexTimes) {
+    report(phase.c_str(), bytes, tokens, seconds);
+  }
+  report("lex+parse", bytes, tokens, parseSeconds);
+
+  if (argc == 1) {
+    for (auto [shape, generator] :
+         {std::pair{"comments", generateComments},
+          std::pair{"strings", generateStrings}}) {
+      const std::vector<Source> workload{{shape, generator(8u << 20)}};
+      const size_t shapeBytes = workload.front().text.size();
+      std::printf("%s: %.2f MB\n", shape,
+                  static_cast<double>(shapeBytes) / 1e6);
+      for (const auto *kernels : levels) {
+        const double seconds = lex(workload, kernels);
+        report((std::string("lex/") + lexer_scan::levelName(kernels->level))
+                   .c_str(),
+               shapeBytes, tokens, seconds);
+      }
+    }
+  }
+  if (errors != 0) {
+    std::fprintf(stderr, "%zu file(s) had parse errors\n", errors);
+    return 1;
+  }
+  return 0;
+}
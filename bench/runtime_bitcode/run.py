@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Time ownership-heavy programs with the runtime linked as object or bitcode.
+
+With --runtime=object every string and ARC retain/release is a call into
+runtime.o; with --runtime=bitcode runtime.bc is linked into the program
+module and its refcount fast paths can inline. The runner builds two
+generated programs (one copying and releasing Strings, one churning class
+instances) plus tests/string_ownership_runtime_test.zp and
+tests/class_arc_test.zp both ways and reports the best wall time of each.
+
+    python3 bench/runtime_bitcode/run.py --zapc build/zapc
+    python3 bench/runtime_bitcode/run.py --zapc build/zapc --iterations 200000
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+STRINGS = """struct Holder {{
+    text: String;
+}}
+
+fun identity(value: String) String {{
+    return value;
+}}
+
+fun main() Int {{
+    var total: Int = 0;
+    var i: Int = 0;
+    var base: String = "ownership";
+    while i < {iterations} {{
+        var copy: String = identity(base);
+        var holder: Holder = Holder {{ text: copy }};
+        var joined: String = holder.text + "!";
+        if joined != "ownership!" {{
+            return 1;
+        }}
+        total = total + 1;
+        i = i + 1;
+    }}
+    if total != {iterations} {{
+        return 2;
+    }}
+    return 0;
+}}
+"""
+
+CLASSES = """class Leaf {{
+    priv value: Int;
+
+    fun init(value: Int) {{
+        self.value = value;
+    }}
+
+    pub fun current() Int {{
+        return self.value;
+    }}
+}}
+
+class Pair {{
+    priv left: Leaf;
+    priv right: Leaf;
+
+    fun init(left: Leaf, right: Leaf) {{
+        self.left = left;
+        self.right = right;
+    }}
+
+    pub fun sum() Int {{
+        return self.left.current() + self.right.current();
+    }}
+}}
+
+fun main() Int {{
+    var shared: Leaf = new Leaf(1);
+    var total: Int = 0;
+    var i: Int = 0;
+    while i < {iterations} {{
+        var pair: Pair = new Pair(shared, new Leaf(i % 7));
+        var alias: Pair = pair;
+        total = total + alias.sum();
+        i = i + 1;
+    }}
+    if total <= 0 {{
+        return 1;
+    }}
+    return 0;
+}}
+"""
+
+TESTS = ["tests/string_ownership_runtime_test.zp", "tests/class_arc_test.zp"]
+
+
+def build(zapc, source, binary, runtime, opt):
+    subprocess.run([zapc, source, f"-O{opt}", f"--runtime={runtime}",
+                    "-o", binary], check=True)
+
+
+def run(binary, repeat):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        code = subprocess.call([binary])
+        elapsed = time.perf_counter() - start
+        if code != 0:
+            return code, elapsed
+        best = elapsed if best is None else min(best, elapsed)
+    return 0, best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--iterations", type=int, default=2_000_000,
+                        help="Loop iterations of the generated programs")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="Runs per binary; the fastest is reported")
+    parser.add_argument("-O", dest="opt", default="2", help="Optimization level")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    root = os.path.dirname(os.path.dirname(os.path.dirname(
+        os.path.abspath(__file__))))
+    workdir = tempfile.mkdtemp(prefix="zap-runtime-bitcode-bench-")
+    try:
+        sources = []
+        for name, template in (("strings", STRINGS), ("classes", CLASSES)):
+            path = os.path.join(workdir, f"{name}.zp")
+            with open(path, "w") as f:
+                f.write(template.format(iterations=args.iterations))
+            sources.append((name, path))
+        for test in TESTS:
+            name = os.path.splitext(os.path.basename(test))[0]
+            sources.append((name, os.path.join(root, test)))
+
+        print(f"{'program':<36} {'object (s)':>11} {'bitcode (s)':>12} "
+              f"{'speed-up':>9}")
+        for name, source in sources:
+            timings = {}
+            for runtime in ("object", "bitcode"):
+                binary = os.path.join(workdir, f"{name}-{runtime}")
+                build(args.zapc, source, binary, runtime, args.opt)
+                code, elapsed = run(binary, args.repeat)
+                if code != 0:
+                    print(f"{name} failed with --runtime={runtime} "
+                          f"(exit {code})", file=sys.stderr)
+                    return 1
+                timings[runtime] = elapsed
+            print(f"{name:<36} {timings['object']:>11.4f} "
+                  f"{timings['bitcode']:>12.4f} "
+                  f"{timings['object'] / timings['bitcode']:>8.2f}x")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+"""Time zapc on synthetic large programs and compare with a saved baseline.
+
+The runner generates one program per shape, each sized by --scale:
+
+    modules    many modules of many functions, calling along an import chain
+    generics   List<HashMap<List<T>>> over Cell<Cell<...>> chains, --depth deep
+    classes    classes with hundreds of fields, set in init and summed
+    concat     string expressions concatenating a thousand operands
+    branches   functions made of one long if / else if chain
+
+and builds each with `zapc --stats=`, keeping the fastest of --repeat
+builds. It prints wall time, the compiler's own per-phase times, peak RSS
+and executable size, then compares them with --baseline when that file
+exists. Baselines depend on the machine, so none is checked in: save one
+with --save-baseline before a change and compare against it afterwards.
+Exits with 1 when a number grows by more than --tolerance. The `bench`
+meson test suite runs it once at --scale 0.25 to keep every shape building;
+a plain `meson test` skips that suite, so use
+`meson test --setup bench --suite bench`.
+
+    python3 bench/scale/run.py --zapc build/zapc --save-baseline base.json
+    python3 bench/scale/run.py --zapc build/zapc --baseline base.json
+    python3 bench/scale/run.py --shapes generics branches --scale 4
+    python3 bench/scale/run.py --write /tmp/zap-scale --scale 2
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+SHAPES = ("modules", "generics", "classes", "concat", "branches")
+
+# Printed in this order; phases the compiler does not report are left out.
+PHASES = ("load", "bind", "zir", "zir passes", "llvm ir", "optimize", "emit",
+          "link")
+
+
+def scaled(count, scale):
+    return max(1, round(count * scale))
+
+
+def write_modules(workdir, args):
+    modules = scaled(48, args.scale)
+    functions = 24
+    for module in range(modules):
+        with open(os.path.join(workdir, f"m{module}.zp"), "w") as f:
+            if module > 0:
+                f.write(f'import "./m{module - 1}.zp";\n\n')
+            for index in range(functions):
+                if index + 1 < functions:
+                    call = f"f{module}_{index + 1}(total)"
+                elif module > 0:
+                    call = f"m{module - 1}.f{module - 1}_0(total)"
+                else:
+                    call = "total"
+                f.write(f"pub fun f{module}_{index}(seed: Int) Int {{\n"
+                        f"    var total: Int = seed * {index + 3} % 1009;\n"
+                        f"    if total % 2 == 0 {{\n"
+                        f"        total = total / 2 + {module};\n"
+                        f"    }} else {{\n"
+                        f"        total = total * 3 + {index};\n"
+                        f"    }}\n"
+                        f"    return {call} % 1009;\n"
+                        f"}}\n\n")
+    main = os.path.join(workdir, "main.zp")
+    last = modules - 1
+    with open(main, "w") as f:
+        f.write(f'import "./m{last}.zp";\n\n'
+                f"fun main() Int {{\n"
+                f"    return m{last}.f{last}_0(7) * 0;\n"
+                f"}}\n")
+    return main
+
+
+def instance(name, argument):
+    # The parser reads `>>` as a shift, so nested arguments close apart.
+    space = " " if argument.endswith(">") else ""
+    return f"{name}<{argument}{space}>"
+
+
+def write_generics(workdir, args):
+    chains = scaled(16, args.scale)
+    path = os.path.join(workdir, "generics.zp")
+    with open(path, "w") as f:
+        f.write('import "std/collection" as collection;\n\n')
+        for chain in range(chains):
+            f.write(f"class Cell{chain}<T> {{\n"
+                    f"    priv value: T;\n\n"
+                    f"    fun init(value: T) {{\n"
+                    f"        self.value = value;\n"
+                    f"    }}\n"
+                    f"}}\n\n")
+            element = "Int"
+            value = str(chain)
+            for level in range(args.depth):
+                inner = instance("collection.List", element)
+                table = instance("collection.HashMap", inner)
+                outer = instance("collection.List", table)
+                f.write(f"fun chain{chain}_{level}() Int {{\n"
+                        f"    var items: {inner} = new {inner}();\n"
+                        f"    items.push({value});\n"
+                        f"    var table: {table} = new {table}();\n"
+                        f'    table.put("level{level}", items);\n'
+                        f"    var rows: {outer} = new {outer}();\n"
+                        f"    rows.push(table);\n"
+                        f"    return rows.len() + table.len() + items.len();\n"
+                        f"}}\n\n")
+                cell = instance(f"Cell{chain}", element)
+                value = f"new {cell}({value})"
+                element = cell
+        f.write("fun main() Int {\n    var total: Int = 0;\n")
+        for chain in range(chains):
+            for level in range(args.depth):
+                f.write(f"    total = total + chain{chain}_{level}();\n")
+        f.write(f"    return total - {chains * args.depth * 3};\n}}\n")
+    return path
+
+
+def write_classes(workdir, args):
+    classes = scaled(8, args.scale)
+    fields = 256
+    types = ("Int", "Float64", "Bool", "String")
+    values = ("{index}", "{index}.5", "true", '"field{index}"')
+    path = os.path.join(workdir, "classes.zp")
+    with open(path, "w") as f:
+        for cls in range(classes):
+            f.write(f"class Record{cls} {{\n")
+            for index in range(fields):
+                f.write(f"    pub field{index}: {types[index % 4]};\n")
+            f.write("\n    fun init() {\n")
+            for index in range(fields):
+                value = values[index % 4].format(index=index)
+                f.write(f"        self.field{index} = {value};\n")
+            f.write("    }\n\n    pub fun sum() Int {\n"
+                    "        var total: Int = 0;\n")
+            for index in range(0, fields, 4):
+                f.write(f"        total = total + self.field{index};\n")
+            f.write("        return total;\n    }\n}\n\n")
+        f.write("fun main() Int {\n    var total: Int = 0;\n")
+        for cls in range(classes):
+            f.write(f"    var record{cls}: Record{cls} = new Record{cls}();\n"
+                    f"    total = total + record{cls}.sum();\n")
+        f.write("    return total * 0;\n}\n")
+    return path
+
+
+def write_concat(workdir, args):
+    expressions = scaled(8, args.scale)
+    operands = 1000
+    path = os.path.join(workdir, "concat.zp")
+    with open(path, "w") as f:
+        for expression in range(expressions):
+            f.write(f"fun text{expression}(name: String) String {{\n"
+                    f"    return name")
+            for index in range(operands):
+                operand = f'"e{expression}_{index}"'
+                if index % 3 == 2:
+                    operand = "name"
+                f.write(f" +\n        {operand}")
+            f.write(";\n}\n\n")
+        f.write("fun main() Int {\n")
+        for expression in range(expressions):
+            f.write(f"    var value{expression}: String = "
+                    f'text{expression}("x");\n')
+        f.write("    return 0;\n}\n")
+    return path
+
+
+def write_branches(workdir, args):
+    functions = scaled(4, args.scale)
+    cases = 2000
+    path = os.path.join(workdir, "branches.zp")
+    with open(path, "w") as f:
+        for function in range(functions):
+            f.write(f"fun classify{function}(value: Int) Int {{\n"
+                    f"    if value == 0 {{\n"
+                    f"        return {function};\n")
+            for case in range(1, cases):
+                f.write(f"    }} else if value == {case * 7 + function} {{\n"
+                        f"        return {case % 97};\n")
+            f.write("    }\n    return -1;\n}\n\n")
+        f.write("fun main() Int {\n    var total: Int = 0;\n")
+        for function in range(functions):
+            f.write(f"    total = total + "
+                    f"classify{function}({function * 7});\n")
+        f.write("    return total * 0;\n}\n")
+    return path
+
+
+WRITERS = {
+    "modules": write_modules,
+    "generics": write_generics,
+    "classes": write_classes,
+    "concat": write_concat,
+    "branches": write_branches,
+}
+
+
+def source_lines(directory):
+    lines = 0
+    for name in os.listdir(directory):
+        if name.endswith(".zp"):
+            with open(os.path.join(directory, name)) as f:
+                lines += sum(1 for _ in f)
+    return lines
+
+
+def write_shape(workdir, shape, args):
+    directory = os.path.join(workdir, shape)
+    os.makedirs(directory, exist_ok=True)
+    return WRITERS[shape](directory, args), source_lines(directory)
+
+
+def build(zapc, source, opt, repeat):
+    directory = os.path.dirname(source)
+    binary = os.path.join(directory, "program")
+    stats_path = os.path.join(directory, "stats.json")
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        subprocess.run([zapc, source, f"-O{opt}", f"--stats={stats_path}",
+                        "-o", binary], check=True)
+        elapsed = time.perf_counter() - start
+        if best is None or elapsed < best["wall"]:
+            with open(stats_path) as f:
+                stats = json.load(f)
+            best = {
+                "wall": elapsed,
+                "phases": {phase["name"]: phase["wall"]
+                           for phase in stats["phases"]},
+                "rssKiB": stats["total"]["peakRssKiB"],
+                "size": os.path.getsize(binary),
+            }
+    if subprocess.run([binary]).returncode != 0:
+        raise RuntimeError(f"{source} did not exit with 0")
+    return best
+
+
+def change(value, base):
+    if not base:
+        return ""
+    return f"{(value - base) / base * 100:+.1f}%"
+
+
+def compare(results, baseline, tolerance):
+    regressions = []
+    print(f"\n{'shape':<10} {'time':>8} {'peak RSS':>9} {'size':>8}")
+    for shape, result in results.items():
+        base = baseline["shapes"].get(shape)
+        if base is None:
+            print(f"{shape:<10} {'(not in baseline)':>27}")
+            continue
+        row = []
+        for key in ("wall", "rssKiB", "size"):
+            row.append(change(result[key], base[key]))
+            if base[key] and result[key] > base[key] * (1 + tolerance):
+                regressions.append(f"{shape} {key}")
+        print(f"{shape:<10} {row[0]:>8} {row[1]:>9} {row[2]:>8}")
+    for regression in regressions:
+        print(f"regression: {regression} grew by more than "
+              f"{tolerance * 100:.0f}%", file=sys.stderr)
+    return not regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--shapes", nargs="+", choices=SHAPES,
+                        default=list(SHAPES), help="Program shapes to build")
+    parser.add_argument("--scale", type=float, default=1.0,
+                        help="Multiplies the size of every generated program")
+    parser.add_argument("--depth", type=int, default=5,
+                        help="Cell<...> nesting of the generics shape")
+    parser.add_argument("-O", dest="opt", type=int, default=0,
+                        help="Optimization level")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Builds per shape; the fastest is reported")
+    parser.add_argument("--baseline",
+                        help="Results of an earlier run to compare against")
+    parser.add_argument("--save-baseline",
+                        help="Write this run's results to this file")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="Allowed growth over the baseline, as a fraction")
+    parser.add_argument("--write", metavar="DIR",
+                        help="Only write the programs to DIR")
+    args = parser.parse_args()
+
+    if args.write:
+        for shape in args.shapes:
+            source, lines = write_shape(args.write, shape, args)
+            print(f"{source}: {lines} lines")
+        return 0
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    baseline = None
+    if args.baseline and os.path.isfile(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        measured = (baseline["scale"], baseline["depth"], baseline["opt"])
+        if measured != (args.scale, args.depth, args.opt):
+            parser.error(f"{args.baseline} was measured at --scale "
+                         f"{measured[0]} --depth {measured[1]} "
+                         f"-O{measured[2]}")
+
+    workdir = tempfile.mkdtemp(prefix="zap-scale-bench-")
+    try:
+        results = {}
+        for shape in args.shapes:
+            source, lines = write_shape(workdir, shape, args)
+            results[shape] = build(args.zapc, source, args.opt, args.repeat)
+            results[shape]["lines"] = lines
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    phases = [phase for phase in PHASES
+              if any(phase in result["phases"] for result in results.values())]
+    print(f"{'shape':<10} {'lines':>7} {'time (ms)':>10} "
+          f"{'peak RSS (MiB)':>15} {'size (KiB)':>11}")
+    for shape, result in results.items():
+        print(f"{shape:<10} {result['lines']:>7} "
+              f"{result['wall'] * 1000:>10.1f} "
+              f"{result['rssKiB'] / 1024:>15.1f} "
+              f"{result['size'] / 1024:>11.1f}")
+    print(f"\n{'shape':<10}" + "".join(f" {phase:>10}" for phase in phases))
+    for shape, result in results.items():
+        print(f"{shape:<10}" + "".join(
+            f" {result['phases'].get(phase, 0) * 1000:>10.1f}"
+            for phase in phases))
+
+    if args.save_baseline:
+        with open(args.save_baseline, "w") as f:
+            json.dump({"scale": args.scale, "depth": args.depth,
+                       "opt": args.opt, "shapes": results}, f, indent=2)
+            f.write("\n")
+    if baseline is not None and not compare(results, baseline,
+                                            args.tolerance):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
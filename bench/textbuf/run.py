@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Check that std/string TextBuf appends scale linearly.
+
+For each target size the runner generates a program that pushes 64-byte
+chunks (and a trailing pushChar) into a TextBuf until it holds that many bytes,
+builds the String, compiles it with zapc and reports wall time, ns per byte
+and peak RSS. With geometric growth ns/byte stays flat from 1 MB to 100 MB;
+the older concatenating TextBuf was quadratic, which --legacy reproduces by
+building the same output with String concatenation.
+
+    python3 bench/textbuf/run.py --zapc build/zapc
+    python3 bench/textbuf/run.py --zapc build/zapc --sizes 1 10 --legacy
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+CHUNK = "0123456789abcdef" * 4
+
+PROGRAM = """import "std/string" as string;
+
+fun main() Int {{
+    var target: Int = {size};
+{body}
+    if string.len(out) != target {{
+        return 1;
+    }}
+    return 0;
+}}
+"""
+
+TEXTBUF_BODY = """    var b: string.TextBuf = new string.TextBuf();
+    while b.len() + {chunk_len} < target {{
+        b.push("{chunk}");
+    }}
+    while b.len() < target {{
+        b.pushChar('x');
+    }}
+    var out: String = b.build();"""
+
+CONCAT_BODY = """    var out: String = "";
+    while string.len(out) + {chunk_len} < target {{
+        out = out + "{chunk}";
+    }}
+    while string.len(out) < target {{
+        out = out + 'x';
+    }}"""
+
+
+def build(zapc, workdir, name, body, size, opt):
+    source = os.path.join(workdir, f"{name}_{size}.zp")
+    binary = os.path.join(workdir, f"{name}_{size}")
+    with open(source, "w") as f:
+        f.write(PROGRAM.format(
+            size=size,
+            body=body.format(chunk=CHUNK, chunk_len=len(CHUNK))))
+    subprocess.run([zapc, source, f"-O{opt}", "-o", binary], check=True)
+    return binary
+
+
+def run(binary):
+    # RUSAGE_CHILDREN reports the peak over all waited-for children, so each
+    # measurement runs in its own helper process.
+    probe = (
+        "import resource, subprocess, sys, time\n"
+        "start = time.perf_counter()\n"
+        "code = subprocess.call([sys.argv[1]])\n"
+        "elapsed = time.perf_counter() - start\n"
+        "rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss\n"
+        "print(code, elapsed, rss)\n"
+    )
+    out = subprocess.check_output([sys.executable, "-c", probe, binary], text=True)
+    code, elapsed, rss = out.split()
+    return int(code), float(elapsed), int(rss)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--sizes", type=int, nargs="+", default=[1, 10, 100],
+                        help="Output sizes in MB")
+    parser.add_argument("--legacy", action="store_true",
+                        help="Also time plain String concatenation")
+    parser.add_argument("-O", dest="opt", default="2", help="Optimization level")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    variants = [("textbuf", TEXTBUF_BODY)]
+    if args.legacy:
+        variants.append(("concat", CONCAT_BODY))
+
+    workdir = tempfile.mkdtemp(prefix="zap-textbuf-bench-")
+    try:
+        print(f"{'variant':<8} {'MB':>5} {'time (s)':>10} {'ns/byte':>8} {'RSS (MiB)':>10}")
+        for mb in args.sizes:
+            size = mb * 1_000_000
+            for name, body in variants:
+                binary = build(args.zapc, workdir, name, body, size, args.opt)
+                code, elapsed, rss = run(binary)
+                if code != 0:
+                    print(f"{name} failed at {mb} MB (exit {code})", file=sys.stderr)
+                    return 1
+                print(f"{name:<8} {mb:>5} {elapsed:>10.3f} "
+                      f"{elapsed * 1e9 / size:>8.2f} {rss / 1024:>10.1f}")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
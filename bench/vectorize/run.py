@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Compare array kernels built for a generic CPU and for the host CPU.
+
+The runner compiles a few loops over []Int and []Float64 slices (sum, dot
+product, saxpy, element-wise add and an in-place scale) twice, once with
+--cpu=generic and once with --cpu=native, runs each binary and reports wall
+time and the speed-up. Every kernel checks its own result, so a miscompiled
+vector loop shows up as a failing run rather than a fast one.
+
+    python3 bench/vectorize/run.py --zapc build/zapc
+    python3 bench/vectorize/run.py --zapc build/zapc --cpu skylake-avx512
+"""
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+N = 4096
+
+PROGRAM = """fun sumInts(values: []Int) Int {{
+    var total: Int = 0;
+    var i: Int = 0;
+    while i < values.len {{
+        total = total + values[i];
+        i = i + 1;
+    }}
+    return total;
+}}
+
+fun dot(left: []Float64, right: []Float64) Float64 {{
+    var total: Float64 = 0.0;
+    var i: Int = 0;
+    while i < left.len {{
+        total = total + left[i] * right[i];
+        i = i + 1;
+    }}
+    return total;
+}}
+
+fun saxpy(factor: Float64, xs: []Float64, ys: []Float64) {{
+    var i: Int = 0;
+    while i < xs.len {{
+        ys[i] = factor * xs[i] + ys[i];
+        i = i + 1;
+    }}
+}}
+
+fun addInts(left: []Int, right: []Int, out: []Int) {{
+    var i: Int = 0;
+    while i < out.len {{
+        out[i] = left[i] + right[i];
+        i = i + 1;
+    }}
+}}
+
+fun scale(values: []Float64, factor: Float64) {{
+    var i: Int = 0;
+    while i < values.len {{
+        values[i] = values[i] * factor;
+        i = i + 1;
+    }}
+}}
+
+fun main() Int {{
+    var ints: [{n}]Int;
+    var others: [{n}]Int;
+    var sums: [{n}]Int;
+    var xs: [{n}]Float64;
+    var ys: [{n}]Float64;
+    var i: Int = 0;
+    while i < {n} {{
+        ints[i] = i;
+        others[i] = {n} - i;
+        xs[i] = 1.0;
+        ys[i] = 0.0;
+        i = i + 1;
+    }}
+
+    var round: Int = 0;
+    var check: Int = 0;
+    var acc: Float64 = 0.0;
+    while round < {rounds} {{
+        check = check + sumInts(ints);
+        addInts(ints, others, sums);
+        check = check + sums[round % {n}];
+        saxpy(0.5, xs, ys);
+        acc = acc + dot(xs, ys);
+        scale(ys, 0.5);
+        round = round + 1;
+    }}
+
+    if check != {rounds} * ({n} * ({n} - 1) / 2 + {n}) {{
+        return 1;
+    }}
+    if acc <= 0.0 {{
+        return 2;
+    }}
+    return 0;
+}}
+"""
+
+
+def build(zapc, workdir, cpu, rounds, opt):
+    source = os.path.join(workdir, "kernels.zp")
+    binary = os.path.join(workdir, f"kernels_{cpu}")
+    with open(source, "w") as f:
+        f.write(PROGRAM.format(n=N, rounds=rounds))
+    subprocess.run([zapc, source, f"-O{opt}", f"--cpu={cpu}", "-o", binary],
+                   check=True)
+    return binary
+
+
+def run(binary, repeat):
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        code = subprocess.call([binary])
+        elapsed = time.perf_counter() - start
+        if code != 0:
+            return code, elapsed
+        best = elapsed if best is None else min(best, elapsed)
+    return 0, best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--zapc", default="./build/zapc", help="Path to zapc")
+    parser.add_argument("--cpu", default="native",
+                        help="CPU compared against generic")
+    parser.add_argument("--rounds", type=int, default=20000,
+                        help="Kernel rounds per run")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Runs per binary; the fastest is reported")
+    parser.add_argument("-O", dest="opt", default="3", help="Optimization level")
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.zapc):
+        parser.error(f"zapc not found: {args.zapc}")
+
+    workdir = tempfile.mkdtemp(prefix="zap-vectorize-bench-")
+    try:
+        timings = {}
+        for cpu in ("generic", args.cpu):
+            binary = build(args.zapc, workdir, cpu, args.rounds, args.opt)
+            code, elapsed = run(binary, args.repeat)
+            if code != 0:
+                print(f"--cpu={cpu} failed (exit {code})", file=sys.stderr)
+                return 1
+            timings[cpu] = elapsed
+
+        print(f"{'cpu':<16} {'time (s)':>10} {'speed-up':>9}")
+        for cpu, elapsed in timings.items():
+            print(f"{cpu:<16} {elapsed:>10.3f} "
+                  f"{timings['generic'] / elapsed:>8.2f}x")
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -54,6 +54,9 @@ mkdir -p "$STAGE_DIR"
 install -m 755 "$BUILD_DIR/zapc" "$STAGE_DIR/zapc"
 install -m 755 "$BUILD_DIR/src/lsp/zap-lsp" "$STAGE_DIR/zap-lsp"
 install -m 644 "$BUILD_DIR/runtime.o" "$STAGE_DIR/runtime.o"
+if [[ -f "$BUILD_DIR/runtime.bc" ]]; then
+  install -m 644 "$BUILD_DIR/runtime.bc" "$STAGE_DIR/runtime.bc"
+fi
 cp -R "$SCRIPT_DIR/core" "$STAGE_DIR/core"
 cp -R "$SCRIPT_DIR/std" "$STAGE_DIR/std"
 
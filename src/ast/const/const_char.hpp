@@ -1,6 +1,9 @@
 #pragma once
+#include "../expr_node.hpp"
 #include "../visitor.hpp"
 
+#include <string>
+
 class ConstChar : public ExpressionNode {
 public:
   std::string value_;
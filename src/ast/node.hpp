@@ -3,12 +3,29 @@
 #include <cstdint>
 
 #include "../token/token.hpp"
+#include "../utils/arena.hpp"
 
 struct Visitor;
 
 class Node {
 public:
   SourceSpan span;
+  Node() noexcept { ++createdOnThread_; }
   virtual ~Node() noexcept = default;
   virtual void accept(Visitor &v) = 0;
+
+  /// @brief Nodes come from the current 'zap::ArenaScope', or the heap.
+  static void *operator new(size_t size) {
+    return zap::detail::allocateNode(size);
+  }
+  static void operator delete(void *node, size_t size) noexcept {
+    zap::detail::releaseNode(node, size);
+  }
+
+  /// @brief Nodes created on the calling thread so far. FrontendSession
+  /// reads it around each module it parses, for compile statistics.
+  static size_t createdOnThisThread() noexcept { return createdOnThread_; }
+
+private:
+  inline static thread_local size_t createdOnThread_ = 0;
 };
@@ -357,8 +357,8 @@ void ClassArcEmitter::emitReleaseIfNeeded(
   codegen_.builder_.CreateCondBr(isMarked, skipBB, callBB);
 
   codegen_.builder_.SetInsertPoint(callBB);
-  auto *releaseAddr = codegen_.builder_.CreateStructGEP(
-      objectTy, typedPtr, kClassReleaseFnIndex, "arc.release.fn.addr");
+  auto *releaseAddr = codegen_.emitClassTypeFieldAddr(
+      objectTy, typedPtr, kClassTypeReleaseFnIndex, "arc.release.fn");
   auto *releaseFn = codegen_.builder_.CreateLoad(
       llvm::PointerType::getUnqual(codegen_.ctx_),
       releaseAddr, "arc.release.fn");
@@ -412,10 +412,10 @@ void ClassArcEmitter::emitRetainWeakIfNeeded(
   auto *countAddr = codegen_.builder_.CreateStructGEP(
       objectTy, typedPtr, kClassWeakCountIndex, "arc.weak.count.addr");
   auto *count = codegen_.builder_.CreateLoad(
-      llvm::Type::getInt64Ty(codegen_.ctx_), countAddr, "arc.weak.count");
-  auto *maximum = llvm::ConstantInt::getSigned(
-      llvm::Type::getInt64Ty(codegen_.ctx_), INT64_MAX);
-  auto *isOverflow = codegen_.builder_.CreateICmpSGE(
+      llvm::Type::getInt32Ty(codegen_.ctx_), countAddr, "arc.weak.count");
+  auto *maximum = llvm::ConstantInt::get(
+      llvm::Type::getInt32Ty(codegen_.ctx_), UINT32_MAX);
+  auto *isOverflow = codegen_.builder_.CreateICmpEQ(
       count, maximum, "arc.weak.retain.overflowed");
   codegen_.builder_.CreateCondBr(isOverflow, overflowBB, incrementBB);
 
@@ -424,7 +424,7 @@ void ClassArcEmitter::emitRetainWeakIfNeeded(
 
   codegen_.builder_.SetInsertPoint(incrementBB);
   auto *next = codegen_.builder_.CreateAdd(
-      count, llvm::ConstantInt::get(llvm::Type::getInt64Ty(codegen_.ctx_), 1),
+      count, llvm::ConstantInt::get(llvm::Type::getInt32Ty(codegen_.ctx_), 1),
       "arc.weak.next");
   codegen_.builder_.CreateStore(next, countAddr);
   codegen_.builder_.CreateBr(contBB);
@@ -468,10 +468,10 @@ void ClassArcEmitter::emitReleaseWeakIfNeeded(
   auto *weakAddr = codegen_.builder_.CreateStructGEP(
       objectTy, typedPtr, kClassWeakCountIndex, "arc.weak.release.count.addr");
   auto *weakCount =
-      codegen_.builder_.CreateLoad(llvm::Type::getInt64Ty(codegen_.ctx_),
+      codegen_.builder_.CreateLoad(llvm::Type::getInt32Ty(codegen_.ctx_),
                                    weakAddr, "arc.weak.release.count");
-  auto *isUnderflow = codegen_.builder_.CreateICmpSLE(
-      weakCount, llvm::ConstantInt::get(llvm::Type::getInt64Ty(codegen_.ctx_),
+  auto *isUnderflow = codegen_.builder_.CreateICmpEQ(
+      weakCount, llvm::ConstantInt::get(llvm::Type::getInt32Ty(codegen_.ctx_),
                                          0),
       "arc.weak.release.underflowed");
   codegen_.builder_.CreateCondBr(isUnderflow, underflowBB, decrementBB);
@@ -482,12 +482,12 @@ void ClassArcEmitter::emitReleaseWeakIfNeeded(
   codegen_.builder_.SetInsertPoint(decrementBB);
   auto *nextWeak = codegen_.builder_.CreateSub(
       weakCount,
-      llvm::ConstantInt::get(llvm::Type::getInt64Ty(codegen_.ctx_), 1),
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(codegen_.ctx_), 1),
       "arc.weak.release.next");
   codegen_.builder_.CreateStore(nextWeak, weakAddr);
   auto *isWeakZero = codegen_.builder_.CreateICmpEQ(
       nextWeak,
-      llvm::ConstantInt::get(llvm::Type::getInt64Ty(codegen_.ctx_), 0));
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(codegen_.ctx_), 0));
   codegen_.builder_.CreateCondBr(isWeakZero, checkDeadBB, contBB);
 
   codegen_.builder_.SetInsertPoint(checkDeadBB);
@@ -702,15 +702,20 @@ void ClassArcEmitter::ensureClassArcSupport(
     ensureNestedClassArcSupport(field.type);
   }
 
-  if (!codegen_.classVTables_.count(classType->getCodegenName())) {
+  if (!codegen_.classTypeDescriptors_.count(classType->getCodegenName())) {
+    auto *i8PtrTy = llvm::PointerType::getUnqual(codegen_.ctx_);
     std::vector<llvm::Constant *> entries;
     if (auto base = classType->getBase()) {
       ensureClassArcSupport(base);
-      auto *baseVTable = codegen_.classVTables_.at(base->getCodegenName());
-      if (auto *baseInit = baseVTable->getInitializer()) {
-        for (unsigned i = 0; i < baseInit->getNumOperands(); ++i) {
+      auto *baseType =
+          codegen_.classTypeDescriptors_.at(base->getCodegenName());
+      if (auto *baseInit = baseType->getInitializer()) {
+        auto *baseVTable =
+            baseInit->getAggregateElement(kClassTypeVTableIndex);
+        auto *baseVTableTy = llvm::cast<llvm::ArrayType>(baseVTable->getType());
+        for (uint64_t i = 0; i < baseVTableTy->getNumElements(); ++i) {
           entries.push_back(
-              llvm::cast<llvm::Constant>(baseInit->getOperand(i)));
+              baseVTable->getAggregateElement(static_cast<unsigned>(i)));
         }
       }
     }
@@ -718,8 +723,6 @@ void ClassArcEmitter::ensureClassArcSupport(
     auto methodsIt =
         codegen_.classVirtualMethodFns_.find(classType->getCodegenName());
     if (methodsIt != codegen_.classVirtualMethodFns_.end()) {
-      auto *i8PtrTy =
-          llvm::PointerType::getUnqual(codegen_.ctx_);
       for (const auto &[slot, fn] : methodsIt->second) {
         if (slot >= static_cast<int>(entries.size())) {
           entries.resize(static_cast<size_t>(slot + 1),
@@ -729,29 +732,30 @@ void ClassArcEmitter::ensureClassArcSupport(
       }
     }
 
-    auto *i8PtrTy =
-        llvm::PointerType::getUnqual(codegen_.ctx_);
+    // The descriptor is the generic type struct with the class's vtable
+    // laid out inline, so a virtual call needs a single load through the
+    // object's type pointer.
+    // Classes that cannot reach a cycle get no trace function; the collector
+    // never needs to look inside them.
+    llvm::Constant *traceHelper = llvm::ConstantPointerNull::get(i8PtrTy);
+    if (codegen_.tracedClasses_.count(classType->getCodegenName()) != 0) {
+      traceHelper = llvm::ConstantExpr::getBitCast(
+          emitClassTraceFunction(classType, objectTy), i8PtrTy);
+    }
     auto *vtableTy =
         llvm::ArrayType::get(i8PtrTy, static_cast<uint64_t>(entries.size()));
-    auto *init = llvm::ConstantArray::get(vtableTy, entries);
-    auto *gv = new llvm::GlobalVariable(
-        *codegen_.module_, vtableTy, true, llvm::GlobalValue::InternalLinkage,
-        init, "__zap_vtable_" + classType->getCodegenName());
-    codegen_.classVTables_[classType->getCodegenName()] = gv;
-  }
-
-  if (!codegen_.classMetadataGlobals_.count(classType->getCodegenName())) {
-    auto *traceHelper = emitClassTraceFunction(classType, objectTy);
-    auto *i32PtrTy = llvm::PointerType::getUnqual(codegen_.ctx_);
-    auto *metaTy = llvm::StructType::create(
-        codegen_.ctx_, "__zap_arc_meta_" + classType->getCodegenName());
-    metaTy->setBody({i32PtrTy});
-    auto *metaInit = llvm::ConstantStruct::get(
-        metaTy, llvm::ConstantExpr::getBitCast(traceHelper, i32PtrTy));
-    auto *metaGlobal = new llvm::GlobalVariable(
-        *codegen_.module_, metaTy, true, llvm::GlobalValue::InternalLinkage,
-        metaInit, "__zap_arc_meta_" + classType->getCodegenName());
-    codegen_.classMetadataGlobals_[classType->getCodegenName()] = metaGlobal;
+    auto *descriptorTy = llvm::StructType::get(
+        codegen_.ctx_, {i8PtrTy, i8PtrTy, i8PtrTy, vtableTy});
+    auto *descriptorInit = llvm::ConstantStruct::get(
+        descriptorTy, {llvm::ConstantExpr::getBitCast(releaseHelper, i8PtrTy),
+                       llvm::ConstantExpr::getBitCast(destroyHelper, i8PtrTy),
+                       traceHelper,
+                       llvm::ConstantArray::get(vtableTy, entries)});
+    auto *descriptor = new llvm::GlobalVariable(
+        *codegen_.module_, descriptorTy, true,
+        llvm::GlobalValue::InternalLinkage, descriptorInit,
+        "__zap_arc_type_" + classType->getCodegenName());
+    codegen_.classTypeDescriptors_[classType->getCodegenName()] = descriptor;
   }
 
   auto savedFn = codegen_.currentFn_;
@@ -886,32 +890,30 @@ void ClassArcEmitter::ensureClassArcSupport(
                                  canBeCyclic ? cycleBB : returnBB);
 
   codegen_.builder_.SetInsertPoint(destroyBB);
-  if (codegen_.functionMap_.count("zap_arc_remove_possible_root") == 0) {
-    auto *removeTy = llvm::FunctionType::get(
-        llvm::Type::getVoidTy(codegen_.ctx_), {rawPtrTy, rawPtrTy}, false);
-    auto *removeFn = llvm::Function::Create(
-        removeTy, llvm::Function::ExternalLinkage,
-        "zap_arc_remove_possible_root", *codegen_.module_);
-    codegen_.functionMap_["zap_arc_remove_possible_root"] = removeFn;
-  }
-  codegen_.builder_.CreateCall(
-      codegen_.functionMap_.at("zap_arc_remove_possible_root"),
-      {emitArcRuntimeContext(), rawObject});
-  auto *destroyAddr = codegen_.builder_.CreateStructGEP(
-      objectTy, typedObject, kClassDestroyFnIndex, "destroy.addr");
-  auto *destroyFn = codegen_.builder_.CreateLoad(
-      llvm::PointerType::getUnqual(codegen_.ctx_),
-      destroyAddr, "destroy.fn");
-  auto *destroyTy = llvm::FunctionType::get(
-      llvm::Type::getVoidTy(codegen_.ctx_), {rawPtrTy}, false);
-  codegen_.builder_.CreateCall(destroyTy, destroyFn, {rawObject});
+  // Only cyclic classes are ever buffered as possible roots.
+  if (canBeCyclic) {
+    if (codegen_.functionMap_.count("zap_arc_remove_possible_root") == 0) {
+      auto *removeTy = llvm::FunctionType::get(
+          llvm::Type::getVoidTy(codegen_.ctx_), {rawPtrTy, rawPtrTy}, false);
+      auto *removeFn = llvm::Function::Create(
+          removeTy, llvm::Function::ExternalLinkage,
+          "zap_arc_remove_possible_root", *codegen_.module_);
+      codegen_.functionMap_["zap_arc_remove_possible_root"] = removeFn;
+    }
+    codegen_.builder_.CreateCall(
+        codegen_.functionMap_.at("zap_arc_remove_possible_root"),
+        {emitArcRuntimeContext(), rawObject});
+  }
+  // The release helper is always reached through the object's own type
+  // descriptor, so its destroy helper is known statically.
+  codegen_.builder_.CreateCall(destroyHelper, {rawObject});
   auto *weakAddr = codegen_.builder_.CreateStructGEP(
       objectTy, typedObject, kClassWeakCountIndex, "weakcount.addr");
   auto *weakCount = codegen_.builder_.CreateLoad(
-      llvm::Type::getInt64Ty(codegen_.ctx_), weakAddr, "weakcount");
+      llvm::Type::getInt32Ty(codegen_.ctx_), weakAddr, "weakcount");
   auto *isWeakZero = codegen_.builder_.CreateICmpEQ(
       weakCount,
-      llvm::ConstantInt::get(llvm::Type::getInt64Ty(codegen_.ctx_), 0));
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(codegen_.ctx_), 0));
   codegen_.builder_.CreateCondBr(isWeakZero, deallocateBB, returnBB);
 
   codegen_.builder_.SetInsertPoint(deallocateBB);
@@ -9,15 +9,18 @@ constexpr unsigned kClassStrongCountIndex = ZAP_ARC_STRONG_COUNT_INDEX;
 constexpr unsigned kClassWeakCountIndex = ZAP_ARC_WEAK_COUNT_INDEX;
 constexpr unsigned kClassAliveIndex = ZAP_ARC_ALIVE_INDEX;
 constexpr unsigned kClassGcMarkIndex = ZAP_ARC_GC_MARK_INDEX;
-constexpr unsigned kClassReleaseFnIndex = ZAP_ARC_RELEASE_FN_INDEX;
-constexpr unsigned kClassDestroyFnIndex = ZAP_ARC_DESTROY_FN_INDEX;
-constexpr unsigned kClassMetadataIndex = ZAP_ARC_METADATA_INDEX;
-constexpr unsigned kClassVTableIndex = ZAP_ARC_VTABLE_INDEX;
+constexpr unsigned kClassTypeIndex = ZAP_ARC_TYPE_INDEX;
 constexpr unsigned kClassFieldStartIndex = ZAP_ARC_FIELD_START_INDEX;
 constexpr unsigned kClassHeaderFieldCount = ZAP_ARC_HEADER_FIELD_COUNT;
 static_assert(kClassHeaderFieldCount == kClassFieldStartIndex,
               "ARC header field count must match the first class field index");
 
+// Layout of the per-class type descriptor the header's type field points at.
+constexpr unsigned kClassTypeReleaseFnIndex = ZAP_ARC_TYPE_RELEASE_FN_INDEX;
+constexpr unsigned kClassTypeDestroyFnIndex = ZAP_ARC_TYPE_DESTROY_FN_INDEX;
+constexpr unsigned kClassTypeTraceFnIndex = ZAP_ARC_TYPE_TRACE_FN_INDEX;
+constexpr unsigned kClassTypeVTableIndex = ZAP_ARC_TYPE_VTABLE_INDEX;
+
 // Flag bits packed into the gc_mark byte (see arc_layout.h).
 constexpr unsigned kClassGcGarbageMask = ZAP_ARC_GC_GARBAGE;
 constexpr unsigned kClassGcBufferedMask = ZAP_ARC_GC_BUFFERED;
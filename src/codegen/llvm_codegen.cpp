@@ -2,25 +2,35 @@
 #include "../ir/string_type.hpp"
 #include "class_arc_emitter.hpp"
 #include "class_layout.hpp"
+#include "../utils/compile_stats.hpp"
 #include <cctype>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/InlineAsm.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/IR/PassTimingInfo.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/Timer.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/TargetParser/Host.h>
 #include <llvm/TargetParser/Triple.h>
+#include <llvm/Transforms/IPO/Internalize.h>
 #include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 
 namespace codegen {
@@ -186,16 +196,93 @@ llvm::OptimizationLevel toOptimizationLevel(int optimizationLevel) {
   return llvm::OptimizationLevel::O3;
 }
 
-void optimizeModule(llvm::Module &module, int optimizationLevel) {
+// Resolves "native" to the host CPU and its feature set; features given
+// explicitly come last so they override the detected ones.
+std::pair<std::string, std::string> resolveTargetCpu(std::string cpu,
+                                                     std::string features) {
+  if (cpu.empty()) {
+    return {"generic", std::move(features)};
+  }
+  if (cpu != "native") {
+    return {std::move(cpu), std::move(features)};
+  }
+
+  std::string hostFeatures;
+  for (const auto &feature : llvm::sys::getHostCPUFeatures()) {
+    if (!hostFeatures.empty()) {
+      hostFeatures += ',';
+    }
+    hostFeatures += feature.second ? '+' : '-';
+    hostFeatures += feature.first();
+  }
+  if (!features.empty()) {
+    if (!hostFeatures.empty()) {
+      hostFeatures += ',';
+    }
+    hostFeatures += features;
+  }
+  return {llvm::sys::getHostCPUName().str(), std::move(hostFeatures)};
+}
+
+size_t instructionCount(const llvm::Module &module) {
+  size_t count = 0;
+  for (const auto &function : module) {
+    count += function.getInstructionCount();
+  }
+  return count;
+}
+
+// Hands the times LLVM measured per pass to the compile statistics, both
+// as numbers and as LLVM's own report.
+void recordPassTimes(llvm::TimePassesHandler &timePasses) {
+  std::string values;
+  llvm::raw_string_ostream valuesStream(values);
+  llvm::TimerGroup::printAllJSONValues(valuesStream, "\n");
+  valuesStream.flush();
+  constexpr llvm::StringRef prefix = "\"time.pass.";
+  constexpr llvm::StringRef suffix = ".wall\"";
+  llvm::SmallVector<llvm::StringRef, 64> lines;
+  llvm::StringRef(values).split(lines, '\n', -1, false);
+  for (auto line : lines) {
+    auto [key, value] = line.trim().split(": ");
+    double seconds = 0;
+    if (key.consume_front(prefix) && key.consume_back(suffix) &&
+        !value.trim().getAsDouble(seconds)) {
+      zap::stats::passTime(key.str(), seconds);
+    }
+  }
+
+  std::string report;
+  llvm::raw_string_ostream reportStream(report);
+  timePasses.setOutStream(reportStream);
+  timePasses.print();
+  reportStream.flush();
+  zap::stats::passReport(std::move(report));
+}
+
+void optimizeModule(llvm::Module &module, int optimizationLevel,
+                    llvm::TargetMachine &targetMachine) {
   if (optimizationLevel <= 0) {
     return;
   }
 
+  llvm::PipelineTuningOptions tuning;
+  tuning.LoopVectorization = optimizationLevel >= 2;
+  tuning.SLPVectorization = optimizationLevel >= 2;
+
+  llvm::PassInstrumentationCallbacks instrumentation;
+  std::optional<llvm::TimePassesHandler> timePasses;
+  if (zap::stats::enabled()) {
+    timePasses.emplace(true);
+    timePasses->registerCallbacks(instrumentation);
+  }
+
   llvm::LoopAnalysisManager loopAnalysisManager;
   llvm::FunctionAnalysisManager functionAnalysisManager;
   llvm::CGSCCAnalysisManager cgsccAnalysisManager;
   llvm::ModuleAnalysisManager moduleAnalysisManager;
-  llvm::PassBuilder passBuilder;
+  llvm::PassBuilder passBuilder(&targetMachine, tuning, std::nullopt,
+                                &instrumentation);
   passBuilder.registerModuleAnalyses(moduleAnalysisManager);
   passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
   passBuilder.registerFunctionAnalyses(functionAnalysisManager);
@@ -206,14 +293,19 @@ void optimizeModule(llvm::Module &module, int optimizationLevel) {
   auto pipeline = passBuilder.buildPerModuleDefaultPipeline(
       toOptimizationLevel(optimizationLevel));
   pipeline.run(module, moduleAnalysisManager);
+  if (timePasses) {
+    recordPassTimes(*timePasses);
+  }
 }
 
 } // namespace
-LLVMCodeGen::LLVMCodeGen(std::string targetTriple, bool freestanding)
+LLVMCodeGen::LLVMCodeGen(CodeGenTarget target)
     : builder_(ctx_),
-      targetTriple_(normalizeTargetTriple(std::move(targetTriple))),
-      freestanding_(freestanding),
+      targetTriple_(normalizeTargetTriple(std::move(target.triple))),
+      freestanding_(target.freestanding),
       arcEmitter_(std::make_unique<ClassArcEmitter>(*this)), nextStringId_(0) {
+  std::tie(targetCpu_, targetFeatures_) =
+      resolveTargetCpu(std::move(target.cpu), std::move(target.features));
   initializeLLVMTargets();
 }
 
@@ -221,8 +313,18 @@ LLVMCodeGen::~LLVMCodeGen() = default;
 
 void LLVMCodeGen::initializeModule() {
   module_ = std::make_unique<llvm::Module>("zap_module", ctx_);
+  module_->setTargetTriple(llvm::Triple(targetTriple_));
+  targetMachine_ = createTargetMachine();
+  if (targetCpu_ != "generic" &&
+      !targetMachine_->getMCSubtargetInfo()->isCPUStringValid(targetCpu_)) {
+    throw std::runtime_error("unknown CPU '" + targetCpu_ + "' for target '" +
+                             targetTriple_ + "'");
+  }
+  module_->setDataLayout(targetMachine_->createDataLayout());
+}
+
+std::unique_ptr<llvm::TargetMachine> LLVMCodeGen::createTargetMachine() const {
   llvm::Triple triple(targetTriple_);
-  module_->setTargetTriple(triple);
   std::string error;
   const auto *target = llvm::TargetRegistry::lookupTarget(triple, error);
   if (!target) {
@@ -231,13 +333,13 @@ void LLVMCodeGen::initializeModule() {
   }
 
   llvm::TargetOptions opts;
-  std::unique_ptr<llvm::TargetMachine> tm(target->createTargetMachine(
-      triple, "generic", "", opts, llvm::Reloc::PIC_));
-  if (!tm) {
+  std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(
+      triple, targetCpu_, targetFeatures_, opts, llvm::Reloc::PIC_));
+  if (!machine) {
     throw std::runtime_error("failed to create target machine for '" +
                              targetTriple_ + "'");
   }
-  module_->setDataLayout(tm->createDataLayout());
+  return machine;
 }
 
 llvm::StructType *
@@ -257,14 +359,10 @@ void LLVMCodeGen::finalizeClassStruct(const zir::ClassType &ct) {
   if (!objectTy->isOpaque()) {
     return;
   }
-  auto *i8PtrTy = llvm::PointerType::getUnqual(ctx_);
   std::vector<llvm::Type *> fieldTypes = {llvm::Type::getInt64Ty(ctx_),
-                                          llvm::Type::getInt64Ty(ctx_),
+                                          llvm::Type::getInt32Ty(ctx_),
                                           llvm::Type::getInt8Ty(ctx_),
                                           llvm::Type::getInt8Ty(ctx_),
-                                          i8PtrTy,
-                                          i8PtrTy,
-                                          i8PtrTy,
                                           llvm::PointerType::getUnqual(ctx_)};
   fieldTypes.reserve(kClassHeaderFieldCount + ct.getFields().size());
   for (const auto &f : ct.getFields()) {
@@ -275,6 +373,7 @@ void LLVMCodeGen::finalizeClassStruct(const zir::ClassType &ct) {
 
 void LLVMCodeGen::computeCyclicClasses(const zir::Module &module) {
   cyclicClasses_.clear();
+  tracedClasses_.clear();
 
   std::unordered_map<std::string, std::shared_ptr<zir::ClassType>> classes;
   for (const auto &type : module.getTypes()) {
@@ -339,6 +438,27 @@ void LLVMCodeGen::computeCyclicClasses(const zir::Module &module) {
       cyclicClasses_.insert(start);
     }
   }
+
+  // A class needs a trace function only when some cyclic class is reachable
+  // from it. Everything below an untraced object is acyclic, so the
+  // collector treats it as an opaque referrer without missing any garbage
+  // cycle.
+  tracedClasses_ = cyclicClasses_;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const auto &[name, out] : edges) {
+      if (tracedClasses_.count(name) != 0) {
+        continue;
+      }
+      for (const auto &next : out) {
+        if (tracedClasses_.count(next) != 0) {
+          tracedClasses_.insert(name);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
 }
 
 void LLVMCodeGen::printIR(llvm::raw_ostream &os) const {
@@ -364,96 +484,131 @@ bool LLVMCodeGen::verifyModule(llvm::raw_ostream &diagnostics) const {
   return false;
 }
 
-bool LLVMCodeGen::emitObjectFile(const std::string &path,
-                                 int optimization_level) {
-  llvm::Triple triple(targetTriple_);
-  module_->setTargetTriple(triple);
-  std::string error;
-  const auto *target = llvm::TargetRegistry::lookupTarget(triple, error);
-  if (!target) {
-    llvm::errs() << "Target lookup failed: " << error << "\n";
+bool LLVMCodeGen::linkRuntimeBitcode(const std::string &path,
+                                     std::string &error) {
+  if (!module_) {
+    error = "no module to link into";
     return false;
   }
-
-  llvm::TargetOptions opts;
-  std::unique_ptr<llvm::TargetMachine> tm(target->createTargetMachine(
-      triple, "generic", "", opts, llvm::Reloc::PIC_, std::nullopt,
-      toCodeGenOptLevel(optimization_level)));
-  if (!tm) {
-    llvm::errs() << "Failed to create target machine for: " << targetTriple_
-                 << "\n";
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    error = "cannot read '" + path + "': " + buffer.getError().message();
     return false;
   }
-  module_->setDataLayout(tm->createDataLayout());
-
-  if (!verifyModule(llvm::errs())) {
+  auto runtime = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), ctx_);
+  if (!runtime) {
+    error = "cannot parse '" + path +
+            "': " + llvm::toString(runtime.takeError());
     return false;
   }
-
-  optimizeModule(*module_, optimization_level);
-
-  std::error_code ec;
-  llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OF_None);
-  if (ec) {
-    llvm::errs() << "Cannot open output file: " << ec.message() << "\n";
+  // Vendors differ between toolchains building for the same system, so only
+  // the architecture, OS and environment have to agree.
+  const llvm::Triple &runtimeTriple = (*runtime)->getTargetTriple();
+  const llvm::Triple &moduleTriple = module_->getTargetTriple();
+  if (runtimeTriple.getArch() != moduleTriple.getArch() ||
+      runtimeTriple.getOS() != moduleTriple.getOS() ||
+      runtimeTriple.getEnvironment() != moduleTriple.getEnvironment()) {
+    error = "'" + path + "' was built for " + runtimeTriple.str() + ", not " +
+            targetTriple_;
     return false;
   }
 
-  llvm::legacy::PassManager pm;
-  if (tm->addPassesToEmitFile(pm, dest, nullptr,
-                              llvm::CodeGenFileType::ObjectFile)) {
-    llvm::errs() << "TargetMachine cannot emit object file\n";
-    return false;
+  // The runtime was compiled for the machine that built zapc. Let its
+  // functions take the module's CPU and features instead, which also keeps
+  // them inline-compatible with the generated code.
+  for (auto &function : **runtime) {
+    function.removeFnAttr("target-cpu");
+    function.removeFnAttr("target-features");
+    function.removeFnAttr("tune-cpu");
+  }
+  (*runtime)->setTargetTriple(moduleTriple);
+  (*runtime)->setDataLayout(module_->getDataLayout());
+
+  const bool failed = llvm::Linker::linkModules(
+      *module_, std::move(*runtime), llvm::Linker::Flags::LinkOnlyNeeded,
+      [](llvm::Module &module, const llvm::StringSet<> &runtimeSymbols) {
+        llvm::internalizeModule(module, [&](const llvm::GlobalValue &value) {
+          return !value.hasName() ||
+                 runtimeSymbols.count(value.getName()) == 0;
+        });
+      });
+  if (failed) {
+    throw std::runtime_error("linking runtime bitcode '" + path +
+                             "' failed");
   }
-
-  pm.run(*module_);
-  dest.flush();
   return true;
 }
 
+bool LLVMCodeGen::emitObjectFile(const std::string &path,
+                                 int optimization_level) {
+  return emitFile(path, optimization_level, llvm::CodeGenFileType::ObjectFile);
+}
+
 bool LLVMCodeGen::emitAssemblyFile(const std::string &path,
                                    int optimization_level) {
-  llvm::Triple triple(targetTriple_);
-  module_->setTargetTriple(triple);
-  std::string error;
-  const auto *target = llvm::TargetRegistry::lookupTarget(triple, error);
-  if (!target) {
-    llvm::errs() << "Target lookup failed: " << error << "\n";
-    return false;
-  }
+  return emitFile(path, optimization_level,
+                  llvm::CodeGenFileType::AssemblyFile);
+}
 
-  llvm::TargetOptions opts;
-  std::unique_ptr<llvm::TargetMachine> tm(target->createTargetMachine(
-      triple, "generic", "", opts, llvm::Reloc::PIC_, std::nullopt,
-      toCodeGenOptLevel(optimization_level)));
-  if (!tm) {
-    llvm::errs() << "Failed to create target machine for: " << targetTriple_
-                 << "\n";
+bool LLVMCodeGen::emitFile(const std::string &path, int optimizationLevel,
+                           llvm::CodeGenFileType fileType) {
+  if (!module_ || !targetMachine_) {
+    llvm::errs() << "No module to emit for: " << targetTriple_ << "\n";
     return false;
   }
-  module_->setDataLayout(tm->createDataLayout());
-
   if (!verifyModule(llvm::errs())) {
     return false;
   }
+  return emitModule(*module_, path, optimizationLevel, fileType);
+}
+
+bool LLVMCodeGen::emitModule(llvm::Module &module, const std::string &path,
+                             int optimizationLevel,
+                             llvm::CodeGenFileType fileType) {
+  optimize(module, optimizationLevel);
+  zap::stats::PhaseTimer timer("emit");
+  return emitCode(module, *targetMachine_, path, fileType, llvm::errs());
+}
 
-  optimizeModule(*module_, optimization_level);
+void LLVMCodeGen::optimize(llvm::Module &module, int optimizationLevel) {
+  if (zap::stats::enabled()) {
+    zap::stats::count("llvm functions", module.size());
+    zap::stats::count("llvm instructions", instructionCount(module));
+  }
+  {
+    zap::stats::PhaseTimer timer("optimize");
+    targetMachine_->setOptLevel(toCodeGenOptLevel(optimizationLevel));
+    optimizeModule(module, optimizationLevel, *targetMachine_);
+  }
+  if (zap::stats::enabled()) {
+    zap::stats::count("llvm instructions optimized",
+                      instructionCount(module));
+  }
+}
 
+bool LLVMCodeGen::emitCode(llvm::Module &module,
+                           llvm::TargetMachine &targetMachine,
+                           const std::string &path,
+                           llvm::CodeGenFileType fileType,
+                           llvm::raw_ostream &errors) {
   std::error_code ec;
   llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OF_None);
   if (ec) {
-    llvm::errs() << "Cannot open output file: " << ec.message() << "\n";
+    errors << "Cannot open output file: " << ec.message() << "\n";
     return false;
   }
 
   llvm::legacy::PassManager pm;
-  if (tm->addPassesToEmitFile(pm, dest, nullptr,
-                              llvm::CodeGenFileType::AssemblyFile)) {
-    llvm::errs() << "TargetMachine cannot emit assembly file\n";
+  if (targetMachine.addPassesToEmitFile(pm, dest, nullptr, fileType)) {
+    errors << "TargetMachine cannot emit "
+                 << (fileType == llvm::CodeGenFileType::ObjectFile
+                         ? "object"
+                         : "assembly")
+                 << " file\n";
     return false;
   }
 
-  pm.run(*module_);
+  pm.run(module);
   dest.flush();
   return true;
 }
@@ -594,7 +749,8 @@ llvm::FunctionType *LLVMCodeGen::buildFunctionType(const zir::Function &fn) {
     paramTypes.push_back(llvm::Type::getInt32Ty(ctx_));
     paramTypes.push_back(llvm::PointerType::getUnqual(ctx_));
   }
-  for (const auto &param : fn.getArguments()) {
+  for (size_t i = 0; i < fn.getArguments().size(); ++i) {
+    const auto *param = fn.getArgument(i);
     if (param->isVariadicPack()) {
       paramTypes.push_back(llvm::Type::getInt32Ty(ctx_));
       paramTypes.push_back(llvm::PointerType::getUnqual(ctx_));
@@ -643,54 +799,66 @@ LLVMCodeGen::emitStringConversion(llvm::Value *source,
   return builder_.CreateInsertValue(result, len, {1}, namePrefix + ".len.i");
 }
 
+LLVMCodeGen::StringConcatPart
+LLVMCodeGen::emitStringConcatPart(llvm::Value *value,
+                                  const std::shared_ptr<zir::Type> &type) {
+  if (type && type->getKind() == zir::TypeKind::Char) {
+    auto *buf = createEntryAlloca(currentFn_, "zir_char_buf",
+                                  llvm::Type::getInt8Ty(ctx_));
+    builder_.CreateStore(value, buf);
+    return {buf, llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), 1)};
+  }
+  return {builder_.CreateExtractValue(value, {0}),
+          builder_.CreateExtractValue(value, {1})};
+}
+
 llvm::Value *
-LLVMCodeGen::emitStringConcat(llvm::Value *lhs, llvm::Value *rhs,
-                              const std::shared_ptr<zir::Type> &lhsType,
-                              const std::shared_ptr<zir::Type> &rhsType,
+LLVMCodeGen::emitStringConcat(const std::vector<StringConcatPart> &parts,
                               const std::shared_ptr<zir::Type> &resultType) {
-  auto *i8Ty = llvm::Type::getInt8Ty(ctx_);
   auto *i64Ty = llvm::Type::getInt64Ty(ctx_);
+  auto *ptrTy = llvm::PointerType::getUnqual(ctx_);
+
+  llvm::Value *call = nullptr;
+  if (parts.size() == 2) {
+    auto concatIt = functionMap_.find("string_concat_ptrlen");
+    if (concatIt == functionMap_.end()) {
+      std::vector<llvm::Type *> params = {ptrTy, i64Ty, ptrTy, i64Ty};
+      auto *ft = llvm::FunctionType::get(ptrTy, params, false);
+      auto *fn = llvm::Function::Create(ft, llvm::Function::ExternalLinkage,
+                                        "string_concat_ptrlen", *module_);
+      concatIt = functionMap_.emplace("string_concat_ptrlen", fn).first;
+    }
+    call = builder_.CreateCall(concatIt->second,
+                               {parts[0].ptr, parts[0].len, parts[1].ptr,
+                                parts[1].len});
+  } else {
+    auto concatIt = functionMap_.find("zap_string_concat_n");
+    if (concatIt == functionMap_.end()) {
+      auto *ft = llvm::FunctionType::get(ptrTy, {ptrTy, i64Ty}, false);
+      auto *fn = llvm::Function::Create(ft, llvm::Function::ExternalLinkage,
+                                        "zap_string_concat_n", *module_);
+      concatIt = functionMap_.emplace("zap_string_concat_n", fn).first;
+    }
+    auto *partTy = llvm::StructType::get(ctx_, {ptrTy, i64Ty});
+    auto *partsTy = llvm::ArrayType::get(partTy, parts.size());
+    auto *partsBuf = createEntryAlloca(currentFn_, "zir_concat_parts", partsTy);
+    for (size_t i = 0; i < parts.size(); ++i) {
+      auto *slot = builder_.CreateConstInBoundsGEP2_32(
+          partsTy, partsBuf, 0, static_cast<unsigned>(i));
+      builder_.CreateStore(parts[i].ptr,
+                           builder_.CreateStructGEP(partTy, slot, 0));
+      builder_.CreateStore(parts[i].len,
+                           builder_.CreateStructGEP(partTy, slot, 1));
+    }
+    call = builder_.CreateCall(
+        concatIt->second,
+        {partsBuf, llvm::ConstantInt::get(i64Ty, parts.size())});
+  }
 
-  llvm::Value *lhsPtr = nullptr;
-  llvm::Value *lhsLen = nullptr;
-  llvm::Value *rhsPtr = nullptr;
-  llvm::Value *rhsLen = nullptr;
-
-  if (isStringType(lhsType)) {
-    lhsPtr = builder_.CreateExtractValue(lhs, {0});
-    lhsLen = builder_.CreateExtractValue(lhs, {1});
-  } else if (lhsType && lhsType->getKind() == zir::TypeKind::Char) {
-    auto *buf = createEntryAlloca(currentFn_, "zir_char_buf_l", i8Ty);
-    builder_.CreateStore(lhs, buf);
-    lhsPtr = buf;
-    lhsLen = llvm::ConstantInt::get(i64Ty, 1);
-  }
-
-  if (isStringType(rhsType)) {
-    rhsPtr = builder_.CreateExtractValue(rhs, {0});
-    rhsLen = builder_.CreateExtractValue(rhs, {1});
-  } else if (rhsType && rhsType->getKind() == zir::TypeKind::Char) {
-    auto *buf = createEntryAlloca(currentFn_, "zir_char_buf_r", i8Ty);
-    builder_.CreateStore(rhs, buf);
-    rhsPtr = buf;
-    rhsLen = llvm::ConstantInt::get(i64Ty, 1);
-  }
-
-  auto concatIt = functionMap_.find("string_concat_ptrlen");
-  if (concatIt == functionMap_.end()) {
-    std::vector<llvm::Type *> params = {
-        llvm::PointerType::getUnqual(ctx_), i64Ty,
-        llvm::PointerType::getUnqual(ctx_), i64Ty};
-    auto *ft = llvm::FunctionType::get(llvm::PointerType::getUnqual(ctx_),
-                                       params, false);
-    auto *fn = llvm::Function::Create(ft, llvm::Function::ExternalLinkage,
-                                      "string_concat_ptrlen", *module_);
-    concatIt = functionMap_.emplace("string_concat_ptrlen", fn).first;
-  }
-
-  auto *concatFn = concatIt->second;
-  auto *call = builder_.CreateCall(concatFn, {lhsPtr, lhsLen, rhsPtr, rhsLen});
-  auto *sumLen = builder_.CreateAdd(lhsLen, rhsLen);
+  llvm::Value *sumLen = parts.front().len;
+  for (size_t i = 1; i < parts.size(); ++i) {
+    sumLen = builder_.CreateAdd(sumLen, parts[i].len);
+  }
 
   auto *structTy = static_cast<llvm::StructType *>(toLLVMType(*resultType));
   llvm::Value *res = llvm::UndefValue::get(structTy);
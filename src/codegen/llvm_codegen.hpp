@@ -15,10 +15,19 @@
 namespace codegen {
 class ClassArcEmitter;
 
+/// Machine the generated code is tuned for. An empty triple means the host,
+/// an empty CPU means "generic", and the CPU name "native" selects the host
+/// CPU together with its features.
+struct CodeGenTarget {
+  std::string triple;
+  std::string cpu;
+  std::string features; ///< LLVM feature string, e.g. "+avx2,-sse4a".
+  bool freestanding = false;
+};
+
 class LLVMCodeGen {
 public:
-  explicit LLVMCodeGen(std::string targetTriple = {},
-                       bool freestanding = false);
+  explicit LLVMCodeGen(CodeGenTarget target = {});
   ~LLVMCodeGen();
 
   void generate(const zir::Module &module);
@@ -26,15 +35,47 @@ public:
   void printIR(llvm::raw_ostream &) const;
   bool verifyModule(llvm::raw_ostream &diagnostics) const;
 
+  // Links the runtime bitcode at `path` into the generated module, keeping
+  // only what the module uses and making it internal so the optimizer can
+  // inline it. Returns false, leaving the module untouched, when the file
+  // cannot be used; `error` then says why.
+  bool linkRuntimeBitcode(const std::string &path, std::string &error);
+
   bool emitObjectFile(const std::string &path, int optimization_level = 0);
   bool emitAssemblyFile(const std::string &path, int optimization_level = 0);
 
+  // Emits the module as one object per Zap module (the `zap$<module>$`
+  // symbol prefix) plus one for all other symbols, into `directory`. Each
+  // object is named after a hash of its IR, the target, the optimization
+  // level and `cacheSalt`, so objects already in `directory` are reused and
+  // only partitions whose IR changed are optimized and emitted again. Code
+  // is not inlined across partitions. Object paths are appended to
+  // `objects`; `reused` counts the partitions that were cache hits.
+  bool emitIncrementalObjects(const std::string &directory,
+                              int optimization_level,
+                              const std::string &cacheSalt,
+                              std::vector<std::string> &objects,
+                              size_t *reused = nullptr);
+
+  // Optimizes the whole module, then splits it into one part per entry of
+  // `paths` and generates each part's object on up to `threads` threads
+  // (0 means one per core), every thread with its own context and target
+  // machine. The split depends only on the module and the number of paths,
+  // so the objects are the same for any thread count.
+  bool emitSplitObjectFiles(const std::vector<std::string> &paths,
+                            int optimization_level, unsigned threads);
+
 private:
   llvm::LLVMContext ctx_;
   llvm::IRBuilder<> builder_;
   std::unique_ptr<llvm::Module> module_;
   std::string targetTriple_;
+  std::string targetCpu_;
+  std::string targetFeatures_;
   bool freestanding_ = false;
+  // Created with the module and shared by the optimizer, so cost models see
+  // the real subtarget, and by object/assembly emission.
+  std::unique_ptr<llvm::TargetMachine> targetMachine_;
 
   llvm::Function *currentFn_ = nullptr;
   std::map<std::string, llvm::GlobalVariable *> globalValues_;
@@ -42,27 +83,28 @@ private:
   std::map<std::string, const zir::Function *> zirFunctionMap_;
   std::map<std::string, llvm::StructType *> structCache_;
   std::map<std::string, std::map<int, llvm::Function *>> classVirtualMethodFns_;
-  std::map<std::string, llvm::GlobalVariable *> classVTables_;
   std::map<std::string, llvm::Function *> classRetainFns_;
   std::map<std::string, llvm::Function *> classReleaseFns_;
   std::map<std::string, llvm::Function *> classDestroyFns_;
   std::map<std::string, llvm::Function *> classTraceFns_;
   std::map<std::string, llvm::Function *> classDestructorFns_;
-  std::map<std::string, llvm::GlobalVariable *> classMetadataGlobals_;
+  std::map<std::string, llvm::GlobalVariable *> classTypeDescriptors_;
   std::map<std::string, std::shared_ptr<zir::ClassType>> classTypes_;
   std::unordered_set<std::string> cyclicClasses_;
+  std::unordered_set<std::string> tracedClasses_;
   std::unique_ptr<ClassArcEmitter> arcEmitter_;
-  std::unordered_map<const zir::Value *, llvm::Value *> zirValueMap_;
-  std::unordered_set<const zir::Value *> refReturnValues_;
-  std::unordered_map<std::string, llvm::BasicBlock *> zirBlockMap_;
-  std::unordered_map<std::string, llvm::BasicBlock *> zirBlockExitMap_;
+  // Indexed by zir::ValueId and zir::BlockId of the function being emitted.
+  std::vector<llvm::Value *> zirValueMap_;
+  std::unordered_set<zir::ValueId> refReturnValues_;
+  std::vector<llvm::BasicBlock *> zirBlockMap_;
+  std::vector<llvm::BasicBlock *> zirBlockExitMap_;
   struct PendingPhiIncoming {
     llvm::PHINode *phi;
-    std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>> incoming;
+    const zir::PhiInst *inst;
   };
   std::vector<PendingPhiIncoming> pendingPhiIncoming_;
-  std::unordered_set<const zir::Value *> zirClassParamAllocas_;
-  std::unordered_set<const zir::Value *> zirPendingClassParamInitAllocas_;
+  std::unordered_set<zir::ValueId> zirClassParamAllocas_;
+  std::unordered_set<zir::ValueId> zirPendingClassParamInitAllocas_;
   std::vector<std::pair<std::shared_ptr<zir::Type>, llvm::Value *>>
       zirFunctionClassLocals_;
   std::vector<std::pair<std::shared_ptr<zir::Type>, llvm::Value *>>
@@ -71,6 +113,18 @@ private:
       zirFunctionAggregateLocals_;
   const zir::Function *currentZIRFunction_ = nullptr;
   size_t zirParamSpillIndex_ = 0;
+  // String `+` chains lower to one zap_string_concat_n call. A fused concat
+  // only feeds the next `+` of its chain, so it is never materialised: its
+  // parts wait in pendingStringConcats_ and Destroys seen while a chain is
+  // open are replayed once the final concat has been emitted.
+  struct StringConcatPart {
+    llvm::Value *ptr;
+    llvm::Value *len;
+  };
+  std::unordered_set<zir::ValueId> fusedStringConcats_;
+  std::unordered_map<zir::ValueId, std::vector<StringConcatPart>>
+      pendingStringConcats_;
+  std::vector<const zir::Instruction *> deferredConcatDestroys_;
 
   int nextStringId_ = 0;
 
@@ -83,6 +137,17 @@ private:
   llvm::Type *toLLVMAggregateFieldType(const std::shared_ptr<zir::Type> &type);
   llvm::FunctionType *buildFunctionType(const zir::Function &fn);
   void initializeModule();
+  bool emitFile(const std::string &path, int optimizationLevel,
+                llvm::CodeGenFileType fileType);
+  bool emitModule(llvm::Module &module, const std::string &path,
+                  int optimizationLevel, llvm::CodeGenFileType fileType);
+  std::unique_ptr<llvm::TargetMachine> createTargetMachine() const;
+  void optimize(llvm::Module &module, int optimizationLevel);
+  static bool emitCode(llvm::Module &module,
+                       llvm::TargetMachine &targetMachine,
+                       const std::string &path,
+                       llvm::CodeGenFileType fileType,
+                       llvm::raw_ostream &errors);
   void declareZIRFunction(const zir::Function &fn, bool isExternal);
   void emitZIRFunction(const zir::Function &fn);
   void emitZIRInstruction(const zir::Instruction &inst);
@@ -94,8 +159,10 @@ private:
                           const std::vector<std::string> &inConstraints,
                           const std::vector<llvm::Value *> &inValues,
                           const std::vector<std::string> &clobbers);
-  llvm::Value *lowerZIRValue(const std::shared_ptr<zir::Value> &value);
-  llvm::Value *lowerZIRRValue(const std::shared_ptr<zir::Value> &value);
+  const zir::Value &zirValue(zir::ValueId id) const;
+  const std::shared_ptr<zir::Type> &zirValueType(zir::ValueId id) const;
+  llvm::Value *lowerZIRValue(zir::ValueId id);
+  llvm::Value *lowerZIRRValue(zir::ValueId id);
   llvm::Constant *lowerZIRConstant(const zir::Constant &constant);
   llvm::Constant *
   lowerZIRAggregateConstant(const zir::AggregateConstant &constant);
@@ -107,10 +174,12 @@ private:
       llvm::Value *source, const std::shared_ptr<zir::Type> &sourceType,
       const std::shared_ptr<zir::Type> &targetType,
       const llvm::Twine &namePrefix);
-  llvm::Value *emitStringConcat(llvm::Value *lhs, llvm::Value *rhs,
-                                const std::shared_ptr<zir::Type> &lhsType,
-                                const std::shared_ptr<zir::Type> &rhsType,
-                                const std::shared_ptr<zir::Type> &resultType);
+  StringConcatPart emitStringConcatPart(llvm::Value *value,
+                                        const std::shared_ptr<zir::Type> &type);
+  llvm::Value *
+  emitStringConcat(const std::vector<StringConcatPart> &parts,
+                   const std::shared_ptr<zir::Type> &resultType);
+  void collectFusedStringConcats(const zir::Function &fn);
 
   llvm::AllocaInst *createEntryAlloca(llvm::Function *fn,
                                       const std::string &name, llvm::Type *ty);
@@ -142,6 +211,9 @@ private:
                                         const std::shared_ptr<zir::Type> &type);
   void emitStringReleaseIfNeeded(llvm::Value *value,
                                  const std::shared_ptr<zir::Type> &type);
+  llvm::Value *coerceStringValue(llvm::Value *value, llvm::Type *stringTy);
+  void emitStringRefCountCall(llvm::Value *value, const char *runtimeFn,
+                              llvm::Type *resultTy, const std::string &prefix);
   void emitRetainWeakIfNeeded(llvm::Value *value,
                               const std::shared_ptr<zir::Type> &type);
   void emitReleaseWeakIfNeeded(llvm::Value *value,
@@ -158,6 +230,10 @@ private:
                               const std::shared_ptr<zir::Type> &type,
                               bool valueIsOwned, bool skipReleaseOld = false);
   void ensureClassArcSupport(const std::shared_ptr<zir::ClassType> &classType);
+  llvm::StructType *getOrCreateArcTypeStruct();
+  llvm::Value *emitClassTypeFieldAddr(llvm::StructType *objectTy,
+                                      llvm::Value *object, unsigned field,
+                                      const std::string &prefix);
   void computeCyclicClasses(const zir::Module &module);
   llvm::StructType *getOrCreateClassStruct(const zir::ClassType &ct);
   void finalizeClassStruct(const zir::ClassType &ct);
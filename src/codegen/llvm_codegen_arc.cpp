@@ -1,6 +1,8 @@
 #include "../ir/string_type.hpp"
 #include "class_arc_emitter.hpp"
+#include "class_layout.hpp"
 #include "llvm_codegen.hpp"
+#include "string_layout.hpp"
 
 namespace codegen {
 namespace {
@@ -243,21 +245,10 @@ LLVMCodeGen::emitStringRetainIfNeeded(llvm::Value *value,
   if (!isOwnedStringType(type)) {
     return value;
   }
-  auto *stringTy = toLLVMType(*type);
-  if (value->getType() != stringTy && isStringLikeStruct(value->getType()) &&
-      isStringLikeStruct(stringTy)) {
-    auto *ptr = builder_.CreateExtractValue(value, {0}, "str.cvt.ptr");
-    auto *len = builder_.CreateExtractValue(value, {1}, "str.cvt.len");
-    llvm::Value *converted = llvm::UndefValue::get(stringTy);
-    converted =
-        builder_.CreateInsertValue(converted, ptr, {0}, "str.cvt.ptr.i");
-    converted =
-        builder_.CreateInsertValue(converted, len, {1}, "str.cvt.len.i");
-    value = converted;
-  }
-  auto *fnTy = llvm::FunctionType::get(stringTy, {stringTy}, false);
-  auto callee = module_->getOrInsertFunction("zap_string_retain", fnTy);
-  return builder_.CreateCall(fnTy, callee.getCallee(), {value}, "str.retain");
+  value = coerceStringValue(value, toLLVMType(*type));
+  emitStringRefCountCall(value, "zap_string_retain", value->getType(),
+                         "str.retain");
+  return value;
 }
 
 void LLVMCodeGen::emitStringReleaseIfNeeded(
@@ -265,22 +256,60 @@ void LLVMCodeGen::emitStringReleaseIfNeeded(
   if (!isOwnedStringType(type)) {
     return;
   }
-  auto *stringTy = toLLVMType(*type);
-  if (value->getType() != stringTy && isStringLikeStruct(value->getType()) &&
-      isStringLikeStruct(stringTy)) {
-    auto *ptr = builder_.CreateExtractValue(value, {0}, "str.cvt.ptr");
-    auto *len = builder_.CreateExtractValue(value, {1}, "str.cvt.len");
-    llvm::Value *converted = llvm::UndefValue::get(stringTy);
-    converted =
-        builder_.CreateInsertValue(converted, ptr, {0}, "str.cvt.ptr.i");
-    converted =
-        builder_.CreateInsertValue(converted, len, {1}, "str.cvt.len.i");
-    value = converted;
+  value = coerceStringValue(value, toLLVMType(*type));
+  emitStringRefCountCall(value, "zap_string_release",
+                         llvm::Type::getVoidTy(ctx_), "str.release");
+}
+
+llvm::Value *LLVMCodeGen::coerceStringValue(llvm::Value *value,
+                                            llvm::Type *stringTy) {
+  if (value->getType() == stringTy || !isStringLikeStruct(value->getType()) ||
+      !isStringLikeStruct(stringTy)) {
+    return value;
   }
-  auto *fnTy =
-      llvm::FunctionType::get(llvm::Type::getVoidTy(ctx_), {stringTy}, false);
-  auto callee = module_->getOrInsertFunction("zap_string_release", fnTy);
+  auto *ptr = builder_.CreateExtractValue(value, {0}, "str.cvt.ptr");
+  auto *len = builder_.CreateExtractValue(value, {1}, "str.cvt.len");
+  llvm::Value *converted = llvm::UndefValue::get(stringTy);
+  converted = builder_.CreateInsertValue(converted, ptr, {0}, "str.cvt.ptr.i");
+  return builder_.CreateInsertValue(converted, len, {1}, "str.cvt.len.i");
+}
+
+// The empty String, literals and single-byte Strings carry no refcount
+// traffic (null pointer or immortal header), so retain/release checks for
+// them inline and only calls into the runtime for counted strings.
+void LLVMCodeGen::emitStringRefCountCall(llvm::Value *value,
+                                         const char *runtimeFn,
+                                         llvm::Type *resultTy,
+                                         const std::string &prefix) {
+  auto *i64Ty = llvm::Type::getInt64Ty(ctx_);
+  auto *fn = builder_.GetInsertBlock()->getParent();
+  auto *checkBB = llvm::BasicBlock::Create(ctx_, prefix + ".check", fn);
+  auto *callBB = llvm::BasicBlock::Create(ctx_, prefix + ".call", fn);
+  auto *contBB = llvm::BasicBlock::Create(ctx_, prefix + ".cont", fn);
+
+  auto *ptr = builder_.CreateExtractValue(value, {0}, prefix + ".ptr");
+  auto *isNull = builder_.CreateIsNull(ptr, prefix + ".isnull");
+  builder_.CreateCondBr(isNull, contBB, checkBB);
+
+  builder_.SetInsertPoint(checkBB);
+  auto *refsAddr = builder_.CreateConstGEP1_64(
+      i64Ty, ptr,
+      static_cast<uint64_t>(static_cast<int64_t>(kStringRefCountIndex) -
+                            static_cast<int64_t>(kStringDataIndex)),
+      prefix + ".refs.addr");
+  auto *refs = builder_.CreateLoad(i64Ty, refsAddr, prefix + ".refs");
+  auto *isImmortal = builder_.CreateICmpEQ(
+      refs, llvm::ConstantInt::getSigned(i64Ty, kStringImmortalRefCount),
+      prefix + ".immortal");
+  builder_.CreateCondBr(isImmortal, contBB, callBB);
+
+  builder_.SetInsertPoint(callBB);
+  auto *fnTy = llvm::FunctionType::get(resultTy, {value->getType()}, false);
+  auto callee = module_->getOrInsertFunction(runtimeFn, fnTy);
   builder_.CreateCall(fnTy, callee.getCallee(), {value});
+  builder_.CreateBr(contBB);
+
+  builder_.SetInsertPoint(contBB);
 }
 
 void LLVMCodeGen::emitRetainWeakIfNeeded(
@@ -336,4 +365,29 @@ void LLVMCodeGen::ensureClassArcSupport(
   arcEmitter_->ensureClassArcSupport(classType);
 }
 
+llvm::StructType *LLVMCodeGen::getOrCreateArcTypeStruct() {
+  auto it = structCache_.find("zap.arc.type");
+  if (it != structCache_.end()) {
+    return it->second;
+  }
+  auto *ptrTy = llvm::PointerType::getUnqual(ctx_);
+  auto *typeTy = llvm::StructType::create(
+      ctx_, {ptrTy, ptrTy, ptrTy, llvm::ArrayType::get(ptrTy, 0)},
+      "zap.arc.type");
+  structCache_["zap.arc.type"] = typeTy;
+  return typeTy;
+}
+
+llvm::Value *LLVMCodeGen::emitClassTypeFieldAddr(llvm::StructType *objectTy,
+                                                 llvm::Value *object,
+                                                 unsigned field,
+                                                 const std::string &prefix) {
+  auto *typeAddr = builder_.CreateStructGEP(objectTy, object, kClassTypeIndex,
+                                            prefix + ".type.addr");
+  auto *type = builder_.CreateLoad(llvm::PointerType::getUnqual(ctx_),
+                                   typeAddr, prefix + ".type");
+  return builder_.CreateStructGEP(getOrCreateArcTypeStruct(), type, field,
+                                  prefix + ".addr");
+}
+
 } // namespace codegen
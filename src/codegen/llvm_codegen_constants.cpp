@@ -45,11 +45,13 @@ llvm::Constant *LLVMCodeGen::getOrCreateGlobalString(const std::string &str,
           llvm::PointerType::getUnqual(ctx_));
     }
 
-    auto *storageTy = llvm::StructType::get(i64Ty, i64Ty, arrayTy);
+    auto *storageTy = llvm::StructType::get(i64Ty, i64Ty, i64Ty, arrayTy);
     auto *initializer = llvm::ConstantStruct::get(
         storageTy,
         {llvm::ConstantInt::getSigned(i64Ty, kStringImmortalRefCount),
          llvm::ConstantInt::get(i64Ty, static_cast<uint64_t>(str.size())),
+         llvm::ConstantInt::get(i64Ty,
+                                zap_string_hash_bytes(str.data(), str.size())),
          constArray});
     auto *storage = new llvm::GlobalVariable(
         *module_, storageTy, /*isConstant=*/true,
@@ -173,7 +175,7 @@ LLVMCodeGen::lowerZIRAggregateConstant(const zir::AggregateConstant &constant) {
   }
 
   const auto *recordTy =
-      static_cast<const zir::RecordType *>(constant.getType().get());
+      static_cast<const zir::RecordType *>(constant.getType());
 
   const auto &recordFields = recordTy->getFields();
   std::vector<llvm::Constant *> elems(recordFields.size(), nullptr);
@@ -208,7 +210,8 @@ LLVMCodeGen::lowerZIRAggregateConstant(const zir::AggregateConstant &constant) {
         auto sourceFieldType = fieldInit.value->getType();
         auto targetFieldType =
             recordFields[static_cast<size_t>(fieldIndex)].type;
-        if (isStringType(sourceFieldType) && isStringType(targetFieldType)) {
+        if (zir::isIntrinsicStringType(*sourceFieldType) &&
+            isStringType(targetFieldType)) {
           if (auto *srcStruct =
                   llvm::dyn_cast<llvm::ConstantStruct>(fieldConst)) {
             auto *ptr = srcStruct->getAggregateElement((unsigned)0);
@@ -0,0 +1,207 @@
+#include "llvm_codegen.hpp"
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace codegen {
+namespace {
+
+// Symbols of a Zap module are named `zap$<module>$<name>`; everything else
+// (main, ARC helpers, literals shared between modules) shares one partition.
+std::string partitionOfName(llvm::StringRef name) {
+  constexpr llvm::StringRef prefix = "zap$";
+  if (!name.starts_with(prefix)) {
+    return "";
+  }
+  const auto end = name.find('$', prefix.size());
+  return end == llvm::StringRef::npos ? "" : name.take_front(end).str();
+}
+
+void collectOwners(const llvm::Value &value,
+                   std::set<const llvm::GlobalValue *> &owners) {
+  for (const llvm::User *user : value.users()) {
+    if (const auto *inst = llvm::dyn_cast<llvm::Instruction>(user)) {
+      owners.insert(inst->getFunction());
+    } else if (const auto *global = llvm::dyn_cast<llvm::GlobalValue>(user)) {
+      owners.insert(global);
+    } else {
+      collectOwners(*user, owners);
+    }
+  }
+}
+
+// Assigns every definition of a module to a partition. Local variables
+// (string literals, mostly) follow their only user so they can stay local;
+// locals reached from another partition are made hidden globals instead.
+class Partitioner {
+public:
+  explicit Partitioner(llvm::Module &module) {
+    for (auto &global : module.global_values()) {
+      if (!global.isDeclaration()) {
+        partitionOf(global);
+      }
+    }
+    for (auto &global : module.global_values()) {
+      if (global.isDeclaration() || !global.hasLocalLinkage()) {
+        continue;
+      }
+      std::set<const llvm::GlobalValue *> owners;
+      collectOwners(global, owners);
+      for (const auto *owner : owners) {
+        if (partitionOf(*owner) != partitions_[&global]) {
+          if (!global.hasName()) {
+            global.setName("__zap_shared");
+          }
+          global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+          global.setVisibility(llvm::GlobalValue::HiddenVisibility);
+          break;
+        }
+      }
+    }
+  }
+
+  const std::string &partitionOf(const llvm::GlobalValue &global) {
+    auto found = partitions_.find(&global);
+    if (found != partitions_.end()) {
+      return found->second;
+    }
+    // The entry is provisional while users are visited, in case locals
+    // refer to each other in a cycle.
+    auto &partition = partitions_[&global];
+    if (!global.hasLocalLinkage() || llvm::isa<llvm::Function>(global)) {
+      partition = partitionOfName(global.getName());
+      return partition;
+    }
+    std::set<const llvm::GlobalValue *> owners;
+    collectOwners(global, owners);
+    std::set<std::string> ownerPartitions;
+    for (const auto *owner : owners) {
+      if (owner != &global) {
+        ownerPartitions.insert(partitionOf(*owner));
+      }
+    }
+    partition = ownerPartitions.size() == 1 ? *ownerPartitions.begin() : "";
+    return partition;
+  }
+
+  std::set<std::string> partitions() const {
+    std::set<std::string> names;
+    for (const auto &[_, partition] : partitions_) {
+      names.insert(partition);
+    }
+    return names;
+  }
+
+private:
+  std::unordered_map<const llvm::GlobalValue *, std::string> partitions_;
+};
+
+// Drops declarations nothing in the partition uses and gives private
+// symbols names in order of appearance, so a partition's IR only changes
+// when its own code or the signatures it calls change.
+void canonicalizePartition(llvm::Module &partition) {
+  for (auto it = partition.global_values().begin();
+       it != partition.global_values().end();) {
+    auto &global = *it++;
+    if (global.isDeclaration() && global.use_empty() &&
+        !(llvm::isa<llvm::Function>(global) &&
+          llvm::cast<llvm::Function>(global).isIntrinsic())) {
+      global.eraseFromParent();
+    }
+  }
+  size_t nextPrivate = 0;
+  for (auto &global : partition.global_values()) {
+    if (global.hasPrivateLinkage()) {
+      global.setName(".zap.private." + std::to_string(nextPrivate++));
+    }
+  }
+}
+
+} // namespace
+
+bool LLVMCodeGen::emitIncrementalObjects(const std::string &directory,
+                                         int optimization_level,
+                                         const std::string &cacheSalt,
+                                         std::vector<std::string> &objects,
+                                         size_t *reused) {
+  if (!module_ || !targetMachine_) {
+    llvm::errs() << "No module to emit for: " << targetTriple_ << "\n";
+    return false;
+  }
+  if (!verifyModule(llvm::errs())) {
+    return false;
+  }
+  if (auto ec = llvm::sys::fs::create_directories(directory)) {
+    llvm::errs() << "Cannot create cache directory '" << directory
+                 << "': " << ec.message() << "\n";
+    return false;
+  }
+
+  Partitioner partitioner(*module_);
+  for (const auto &name : partitioner.partitions()) {
+    llvm::ValueToValueMapTy map;
+    auto partition = llvm::CloneModule(
+        *module_, map, [&](const llvm::GlobalValue *global) {
+          return partitioner.partitionOf(*global) == name;
+        });
+    canonicalizePartition(*partition);
+
+    std::string ir;
+    llvm::raw_string_ostream irStream(ir);
+    partition->print(irStream, nullptr);
+    irStream.flush();
+
+    llvm::MD5 hash;
+    const uint8_t separator = 0;
+    for (llvm::StringRef part :
+         {llvm::StringRef(cacheSalt), llvm::StringRef(targetTriple_),
+          llvm::StringRef(targetCpu_), llvm::StringRef(targetFeatures_)}) {
+      hash.update(part);
+      hash.update(llvm::ArrayRef<uint8_t>(separator));
+    }
+    const auto level = static_cast<uint8_t>(optimization_level);
+    hash.update(llvm::ArrayRef<uint8_t>(level));
+    hash.update(ir);
+    llvm::MD5::MD5Result digest;
+    hash.final(digest);
+
+    llvm::SmallString<128> path(directory);
+    llvm::sys::path::append(path, llvm::Twine(digest.digest()) + ".o");
+    objects.push_back(path.str().str());
+    if (llvm::sys::fs::exists(path)) {
+      if (reused) {
+        ++*reused;
+      }
+      continue;
+    }
+
+    // Emit under a private name and rename, so concurrent builds sharing
+    // the directory never link half an object.
+    llvm::SmallString<128> temporary;
+    if (auto ec = llvm::sys::fs::createUniqueFile(
+            llvm::Twine(path) + ".tmp%%%%%%", temporary)) {
+      llvm::errs() << "Cannot create object in '" << directory
+                   << "': " << ec.message() << "\n";
+      return false;
+    }
+    if (!emitModule(*partition, temporary.str().str(), optimization_level,
+                    llvm::CodeGenFileType::ObjectFile) ||
+        llvm::sys::fs::rename(temporary, path)) {
+      llvm::sys::fs::remove(temporary);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace codegen
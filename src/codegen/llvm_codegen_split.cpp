@@ -0,0 +1,99 @@
+#include "llvm_codegen.hpp"
+#include "../utils/compile_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+#include <thread>
+
+namespace codegen {
+
+bool LLVMCodeGen::emitSplitObjectFiles(const std::vector<std::string> &paths,
+                                       int optimization_level,
+                                       unsigned threads) {
+  if (!module_ || !targetMachine_) {
+    llvm::errs() << "No module to emit for: " << targetTriple_ << "\n";
+    return false;
+  }
+  if (!verifyModule(llvm::errs())) {
+    return false;
+  }
+  if (paths.size() <= 1) {
+    return paths.empty() ||
+           emitModule(*module_, paths.front(), optimization_level,
+                      llvm::CodeGenFileType::ObjectFile);
+  }
+
+  // The optimizer still sees the whole program, so inlining is unaffected;
+  // only instruction selection and the rest of the backend run in parallel.
+  optimize(*module_, optimization_level);
+
+  // LLVM contexts are single-threaded, so every part travels to its thread
+  // as bitcode and is read back into a context of its own.
+  std::vector<llvm::SmallString<0>> parts;
+  parts.reserve(paths.size());
+  llvm::SplitModule(*module_, static_cast<unsigned>(paths.size()),
+                    [&](std::unique_ptr<llvm::Module> part) {
+                      llvm::raw_svector_ostream stream(parts.emplace_back());
+                      llvm::WriteBitcodeToFile(*part, stream);
+                    });
+  // Only the bitcode is needed from here on.
+  module_.reset();
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min<unsigned>(threads, static_cast<unsigned>(parts.size()));
+
+  // Each unit reports into its own slot; the messages are printed in unit
+  // order once every thread is done, so they never interleave.
+  std::vector<std::string> errors(parts.size());
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  auto work = [&] {
+    for (size_t index = next++; index < parts.size(); index = next++) {
+      llvm::raw_string_ostream unitErrors(errors[index]);
+      llvm::LLVMContext context;
+      auto part = llvm::parseBitcodeFile(
+          llvm::MemoryBufferRef(parts[index].str(), paths[index]), context);
+      if (!part) {
+        unitErrors << "Cannot read back code generation unit " << index
+                   << ": " << llvm::toString(part.takeError()) << "\n";
+        failed = true;
+        continue;
+      }
+      try {
+        auto targetMachine = createTargetMachine();
+        targetMachine->setOptLevel(targetMachine_->getOptLevel());
+        if (!emitCode(**part, *targetMachine, paths[index],
+                      llvm::CodeGenFileType::ObjectFile, unitErrors)) {
+          failed = true;
+        }
+      } catch (const std::exception &ex) {
+        unitErrors << ex.what() << "\n";
+        failed = true;
+      }
+    }
+  };
+
+  zap::stats::PhaseTimer timer("emit");
+  std::vector<std::thread> helpers;
+  for (unsigned i = 1; i < threads; ++i) {
+    helpers.emplace_back(work);
+  }
+  work();
+  for (auto &helper : helpers) {
+    helper.join();
+  }
+  for (const auto &message : errors) {
+    llvm::errs() << message;
+  }
+  return !failed;
+}
+
+} // namespace codegen
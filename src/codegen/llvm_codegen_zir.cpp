@@ -1,4 +1,5 @@
 #include "../ir/string_type.hpp"
+#include "../utils/compile_stats.hpp"
 #include "class_layout.hpp"
 #include "llvm_codegen.hpp"
 #include <llvm/IR/BasicBlock.h>
@@ -7,16 +8,248 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Type.h>
+#include <algorithm>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace codegen {
 namespace {
 bool isStringType(const std::shared_ptr<zir::Type> &type) {
   return zir::isIntrinsicStringType(type);
 }
+
+bool isStringConcatOperand(const zir::Value &value) {
+  return zir::isIntrinsicStringType(*value.getType()) ||
+         value.getType()->getKind() == zir::TypeKind::Char;
+}
+
+bool isStringConcat(const zir::Function &fn, const zir::Instruction &inst) {
+  if (inst.getOpCode() != zir::OpCode::Add) {
+    return false;
+  }
+  const auto &binaryInst = static_cast<const zir::BinaryInst &>(inst);
+  return isStringConcatOperand(fn.values[binaryInst.getLhs()]) ||
+         isStringConcatOperand(fn.values[binaryInst.getRhs()]);
+}
+
+template <typename Visitor>
+void forEachZIROperand(const zir::Instruction &inst, Visitor &&visit) {
+  using namespace zir;
+  auto visitValue = [&](ValueId value) {
+    if (value != NoValue) {
+      visit(value);
+    }
+  };
+  switch (inst.getOpCode()) {
+  case OpCode::Alloca:
+  case OpCode::Alloc:
+  case OpCode::Br:
+    return;
+  case OpCode::Phi:
+    for (const auto &incoming :
+         static_cast<const PhiInst &>(inst).getIncoming()) {
+      visitValue(incoming.second);
+    }
+    return;
+  case OpCode::Load:
+    visitValue(static_cast<const LoadInst &>(inst).getSource());
+    return;
+  case OpCode::Store: {
+    const auto &store = static_cast<const StoreInst &>(inst);
+    visitValue(store.getSource());
+    visitValue(store.getDestination());
+    return;
+  }
+  case OpCode::Add:
+  case OpCode::Sub:
+  case OpCode::Mul:
+  case OpCode::SDiv:
+  case OpCode::UDiv:
+  case OpCode::SRem:
+  case OpCode::URem:
+  case OpCode::Shl:
+  case OpCode::LShr:
+  case OpCode::AShr:
+  case OpCode::BitAnd:
+  case OpCode::BitOr:
+  case OpCode::BitXor: {
+    const auto &binary = static_cast<const BinaryInst &>(inst);
+    visitValue(binary.getLhs());
+    visitValue(binary.getRhs());
+    return;
+  }
+  case OpCode::Cmp: {
+    const auto &comparison = static_cast<const CmpInst &>(inst);
+    visitValue(comparison.getLhs());
+    visitValue(comparison.getRhs());
+    return;
+  }
+  case OpCode::CondBr:
+    visitValue(static_cast<const CondBranchInst &>(inst).getCondition());
+    return;
+  case OpCode::Ret:
+    visitValue(static_cast<const ReturnInst &>(inst).getValue());
+    return;
+  case OpCode::Call: {
+    const auto &call = static_cast<const CallInst &>(inst);
+    visitValue(call.getCalleeValue());
+    for (const auto &argument : call.getArguments()) {
+      visitValue(argument);
+    }
+    visitValue(call.getVariadicPack());
+    return;
+  }
+  case OpCode::Copy:
+    visitValue(static_cast<const CopyInst &>(inst).getSource());
+    return;
+  case OpCode::Move:
+    visitValue(static_cast<const MoveInst &>(inst).getSource());
+    return;
+  case OpCode::Borrow:
+    visitValue(static_cast<const BorrowInst &>(inst).getOwner());
+    return;
+  case OpCode::Destroy:
+    visitValue(static_cast<const DestroyInst &>(inst).getValue());
+    return;
+  case OpCode::GetElementPtr: {
+    const auto &gep = static_cast<const GetElementPtrInst &>(inst);
+    visitValue(gep.getPointer());
+    visitValue(gep.getIndexValue());
+    return;
+  }
+  case OpCode::Cast:
+    visitValue(static_cast<const CastInst &>(inst).getSource());
+    return;
+  case OpCode::WeakLock:
+    visitValue(static_cast<const WeakLockInst &>(inst).getWeakValue());
+    return;
+  case OpCode::WeakAlive:
+    visitValue(static_cast<const WeakAliveInst &>(inst).getWeakValue());
+    return;
+  case OpCode::ClassIs:
+    visitValue(static_cast<const ClassIsInst &>(inst).getObject());
+    return;
+  case OpCode::InlineAsm: {
+    const auto &inlineAsm = static_cast<const InlineAsmInst &>(inst);
+    for (const auto &operand : inlineAsm.getOutputs()) {
+      visitValue(operand.value);
+    }
+    for (const auto &operand : inlineAsm.getInputs()) {
+      visitValue(operand.value);
+    }
+    return;
+  }
+  }
+}
+
+// A chain part can be read after an intervening call only if that call
+// cannot release it: literals, arguments (kept alive by the caller), chars
+// (copied into a stack byte) and owned temporaries whose Destroy the chain
+// defers.
+bool isStableStringConcatPart(const zir::Value &value) {
+  return value.getKind() == zir::ValueKind::Constant ||
+         value.getKind() == zir::ValueKind::Argument ||
+         value.getType()->getKind() == zir::TypeKind::Char ||
+         (value.getKind() == zir::ValueKind::Register &&
+          zir::isOwned(value.getOwnership()));
+}
 } // namespace
 
+void LLVMCodeGen::collectFusedStringConcats(const zir::Function &fn) {
+  using namespace zir;
+  std::vector<size_t> useCounts(fn.values.size());
+  for (const auto &block : fn.getBlocks()) {
+    for (const auto &inst : block->getInstructions()) {
+      if (inst->getOpCode() == OpCode::Destroy) {
+        continue;
+      }
+      forEachZIROperand(*inst, [&](ValueId value) { ++useCounts[value]; });
+    }
+  }
+
+  // Leaves of every chain found so far, used to check call safety.
+  std::unordered_map<ValueId, std::vector<ValueId>> chainParts;
+  auto collectParts = [&](ValueId value, std::vector<ValueId> &parts) {
+    auto it = chainParts.find(value);
+    if (it != chainParts.end() && fusedStringConcats_.count(value)) {
+      parts.insert(parts.end(), it->second.begin(), it->second.end());
+    } else {
+      parts.push_back(value);
+    }
+  };
+
+  for (const auto &block : fn.getBlocks()) {
+    const auto &insts = block->getInstructions();
+    for (size_t i = 0; i < insts.size(); ++i) {
+      if (!isStringConcat(fn, *insts[i])) {
+        continue;
+      }
+      const auto &concat = static_cast<const BinaryInst &>(*insts[i]);
+      const ValueId result = concat.getResult();
+      auto &parts = chainParts[result];
+      collectParts(concat.getLhs(), parts);
+      collectParts(concat.getRhs(), parts);
+      if (fn.values[result].getKind() != ValueKind::Register ||
+          useCounts[result] != 1) {
+        continue;
+      }
+
+      bool stable =
+          std::all_of(parts.begin(), parts.end(), [&](ValueId part) {
+            return isStableStringConcatPart(fn.values[part]);
+          });
+      for (size_t j = i + 1; j < insts.size(); ++j) {
+        const auto &next = *insts[j];
+        bool usesResult = false;
+        forEachZIROperand(next, [&](ValueId value) {
+          usesResult = usesResult || value == result;
+        });
+        if (usesResult) {
+          if (isStringConcat(fn, next)) {
+            fusedStringConcats_.insert(result);
+          }
+          break;
+        }
+        bool inert = false;
+        switch (next.getOpCode()) {
+        case OpCode::Load:
+        case OpCode::GetElementPtr:
+        case OpCode::Cast:
+        case OpCode::Borrow:
+        case OpCode::Copy:
+        case OpCode::Cmp:
+        case OpCode::Destroy:
+        case OpCode::Add:
+        case OpCode::Sub:
+        case OpCode::Mul:
+        case OpCode::SDiv:
+        case OpCode::UDiv:
+        case OpCode::SRem:
+        case OpCode::URem:
+        case OpCode::Shl:
+        case OpCode::LShr:
+        case OpCode::AShr:
+        case OpCode::BitAnd:
+        case OpCode::BitOr:
+        case OpCode::BitXor:
+          inert = true;
+          break;
+        case OpCode::Call:
+          inert = stable;
+          break;
+        default:
+          break;
+        }
+        if (!inert) {
+          break;
+        }
+      }
+    }
+  }
+}
+
 void LLVMCodeGen::generate(const zir::Module &module) {
+  zap::stats::PhaseTimer timer("llvm ir");
   initializeModule();
 
   functionMap_.clear();
@@ -132,7 +365,8 @@ void LLVMCodeGen::declareZIRFunction(const zir::Function &fn, bool isExternal) {
   auto linkage = llvm::Function::ExternalLinkage;
   auto *llvmFn = llvm::Function::Create(ft, linkage, fn.name, *module_);
   auto argIt = llvmFn->arg_begin();
-  for (const auto &arg : fn.getArguments()) {
+  for (size_t i = 0; i < fn.getArguments().size(); ++i) {
+    const auto *arg = fn.getArgument(i);
     if (arg->isVariadicPack()) {
       argIt->setName(arg->getRawName() + ".count");
       ++argIt;
@@ -147,8 +381,18 @@ void LLVMCodeGen::declareZIRFunction(const zir::Function &fn, bool isExternal) {
   (void)isExternal;
 }
 
-llvm::Value *
-LLVMCodeGen::lowerZIRValue(const std::shared_ptr<zir::Value> &value) {
+const zir::Value &LLVMCodeGen::zirValue(zir::ValueId id) const {
+  return currentZIRFunction_->values[id];
+}
+
+const std::shared_ptr<zir::Type> &
+LLVMCodeGen::zirValueType(zir::ValueId id) const {
+  const auto &values = currentZIRFunction_->values;
+  return values.share(values[id].getType());
+}
+
+llvm::Value *LLVMCodeGen::lowerZIRValue(zir::ValueId id) {
+  const auto *value = currentZIRFunction_->getValue(id);
   if (!value) {
     return nullptr;
   }
@@ -181,16 +425,15 @@ LLVMCodeGen::lowerZIRValue(const std::shared_ptr<zir::Value> &value) {
     return globalValues_.at(g.getLinkName());
   }
 
-  auto it = zirValueMap_.find(value.get());
-  if (it == zirValueMap_.end()) {
+  if (!zirValueMap_[id]) {
     throw std::runtime_error("unmapped ZIR value: " + value->getName());
   }
-  return it->second;
+  return zirValueMap_[id];
 }
 
-llvm::Value *
-LLVMCodeGen::lowerZIRRValue(const std::shared_ptr<zir::Value> &value) {
-  auto *raw = lowerZIRValue(value);
+llvm::Value *LLVMCodeGen::lowerZIRRValue(zir::ValueId id) {
+  auto *raw = lowerZIRValue(id);
+  const auto *value = currentZIRFunction_->getValue(id);
   if (!value) {
     return raw;
   }
@@ -331,14 +574,15 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     bool isBorrowedSelf = false;
     if (isParamSpill) {
       isBorrowedSelf = !currentZIRFunction_->ownerTypeCodegenName.empty() &&
-                       currentZIRFunction_->getArguments()[zirParamSpillIndex_]
+                       currentZIRFunction_->getArgument(zirParamSpillIndex_)
                                ->getRawName() == "self";
     }
     auto *alloca = createEntryAlloca(
         currentFn_,
-        static_cast<const Register &>(*allocaInst.getResult()).getRawName(),
+        static_cast<const Register &>(zirValue(allocaInst.getResult()))
+            .getRawName(),
         toLLVMType(*allocaInst.getAllocatedType()));
-    zirValueMap_[allocaInst.getResult().get()] = alloca;
+    zirValueMap_[allocaInst.getResult()] = alloca;
     auto initializeInEntry = [&]() {
       llvm::IRBuilder<> entryBuilder(ctx_);
       if (auto *next = alloca->getNextNode()) {
@@ -353,8 +597,8 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     if (isClassType(allocaInst.getAllocatedType())) {
       initializeInEntry();
       if (isParamSpill) {
-        zirClassParamAllocas_.insert(allocaInst.getResult().get());
-        zirPendingClassParamInitAllocas_.insert(allocaInst.getResult().get());
+        zirClassParamAllocas_.insert(allocaInst.getResult());
+        zirPendingClassParamInitAllocas_.insert(allocaInst.getResult());
       }
       if (!isBorrowedSelf) {
         zirFunctionClassLocals_.push_back(
@@ -385,16 +629,17 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     const auto &loadInst = static_cast<const LoadInst &>(inst);
     auto *src = lowerZIRValue(loadInst.getSource());
     auto *value = builder_.CreateLoad(
-        toLLVMType(*loadInst.getResult()->getType()), src,
-        static_cast<const Register &>(*loadInst.getResult()).getRawName());
-    zirValueMap_[loadInst.getResult().get()] = value;
+        toLLVMType(*zirValueType(loadInst.getResult())), src,
+        static_cast<const Register &>(zirValue(loadInst.getResult()))
+            .getRawName());
+    zirValueMap_[loadInst.getResult()] = value;
     return;
   }
   case OpCode::Store: {
     const auto &storeInst = static_cast<const StoreInst &>(inst);
     auto *dst = lowerZIRValue(storeInst.getDestination());
     auto *src = lowerZIRRValue(storeInst.getSource());
-    auto dstType = storeInst.getDestination()->getType();
+    auto dstType = zirValueType(storeInst.getDestination());
     auto ptrType = std::dynamic_pointer_cast<zir::PointerType>(dstType);
     auto valueType = ptrType ? ptrType->getBaseType() : nullptr;
     bool skipReleaseOld = false;
@@ -410,18 +655,18 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       break;
     }
     if (valueType && isClassType(valueType)) {
-      if (zirPendingClassParamInitAllocas_.count(
-              storeInst.getDestination().get()) > 0) {
+      if (zirPendingClassParamInitAllocas_.count(storeInst.getDestination()) >
+          0) {
         builder_.CreateStore(src, dst);
-        zirPendingClassParamInitAllocas_.erase(
-            storeInst.getDestination().get());
+        zirPendingClassParamInitAllocas_.erase(storeInst.getDestination());
       } else {
         emitStoreWithArc(dst, src, valueType,
-                         storeInst.getSource()->getOwnership(), skipReleaseOld);
+                         zirValue(storeInst.getSource()).getOwnership(),
+                         skipReleaseOld);
       }
     } else if (valueType && isOwnedStringType(valueType)) {
       const bool valueIsOwned =
-          zir::isOwned(storeInst.getSource()->getOwnership());
+          zir::isOwned(zirValue(storeInst.getSource()).getOwnership());
       emitStoreWithStringArc(dst, src, valueType, valueIsOwned, skipReleaseOld);
     } else if (valueType && containsManagedValues(valueType)) {
       if (!skipReleaseOld) {
@@ -430,7 +675,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         emitManagedRelease(oldValue, valueType);
       }
       const bool valueIsOwned =
-          zir::isOwned(storeInst.getSource()->getOwnership());
+          zir::isOwned(zirValue(storeInst.getSource()).getOwnership());
       if (!valueIsOwned) {
         emitManagedRetain(src, valueType);
       }
@@ -454,28 +699,49 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
   case OpCode::BitOr:
   case OpCode::BitXor: {
     const auto &binaryInst = static_cast<const BinaryInst &>(inst);
+    if (isStringConcat(*currentZIRFunction_, inst)) {
+      std::vector<StringConcatPart> parts;
+      for (const ValueId operand : {binaryInst.getLhs(), binaryInst.getRhs()}) {
+        auto pending = pendingStringConcats_.find(operand);
+        if (pending != pendingStringConcats_.end()) {
+          parts.insert(parts.end(), pending->second.begin(),
+                       pending->second.end());
+          pendingStringConcats_.erase(pending);
+        } else {
+          parts.push_back(emitStringConcatPart(lowerZIRRValue(operand),
+                                               zirValueType(operand)));
+        }
+      }
+      if (fusedStringConcats_.count(binaryInst.getResult())) {
+        pendingStringConcats_[binaryInst.getResult()] = std::move(parts);
+        return;
+      }
+      zirValueMap_[binaryInst.getResult()] =
+          emitStringConcat(parts, zirValueType(binaryInst.getResult()));
+      if (pendingStringConcats_.empty()) {
+        auto destroys = std::move(deferredConcatDestroys_);
+        deferredConcatDestroys_.clear();
+        for (const auto *destroy : destroys) {
+          emitZIRInstruction(*destroy);
+        }
+      }
+      return;
+    }
     auto *lhs = lowerZIRRValue(binaryInst.getLhs());
     auto *rhs = lowerZIRRValue(binaryInst.getRhs());
     llvm::Value *result = nullptr;
     bool lhsIsPointer =
-        binaryInst.getLhs()->getType()->getKind() == zir::TypeKind::Pointer;
+        zirValueType(binaryInst.getLhs())->getKind() == zir::TypeKind::Pointer;
     bool rhsIsPointer =
-        binaryInst.getRhs()->getType()->getKind() == zir::TypeKind::Pointer;
+        zirValueType(binaryInst.getRhs())->getKind() == zir::TypeKind::Pointer;
     switch (inst.getOpCode()) {
     case OpCode::Add:
-      if (isStringType(binaryInst.getLhs()->getType()) ||
-          isStringType(binaryInst.getRhs()->getType()) ||
-          binaryInst.getLhs()->getType()->getKind() == zir::TypeKind::Char ||
-          binaryInst.getRhs()->getType()->getKind() == zir::TypeKind::Char) {
-        result = emitStringConcat(lhs, rhs, binaryInst.getLhs()->getType(),
-                                  binaryInst.getRhs()->getType(),
-                                  binaryInst.getResult()->getType());
-      } else if (lhsIsPointer || rhsIsPointer) {
+      if (lhsIsPointer || rhsIsPointer) {
         llvm::Value *pointerValue = lhsIsPointer ? lhs : rhs;
         llvm::Value *offsetValue = lhsIsPointer ? rhs : lhs;
         auto pointerType = std::static_pointer_cast<zir::PointerType>(
-            lhsIsPointer ? binaryInst.getLhs()->getType()
-                         : binaryInst.getRhs()->getType());
+            lhsIsPointer ? zirValueType(binaryInst.getLhs())
+                         : zirValueType(binaryInst.getRhs()));
         auto *elemTy = toLLVMType(*pointerType->getBaseType());
         auto *indexTy = nativeIntegerType();
         auto *index =
@@ -490,7 +756,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     case OpCode::Sub:
       if (lhsIsPointer && rhsIsPointer) {
         auto pointerType = std::static_pointer_cast<zir::PointerType>(
-            binaryInst.getLhs()->getType());
+            zirValueType(binaryInst.getLhs()));
         auto *elemTy = toLLVMType(*pointerType->getBaseType());
         auto *pointerIntTy = nativeIntegerType();
         auto *lhsInt = builder_.CreatePtrToInt(lhs, pointerIntTy);
@@ -503,7 +769,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         result = builder_.CreateSDiv(bytes, elemSize);
       } else if (lhsIsPointer) {
         auto pointerType = std::static_pointer_cast<zir::PointerType>(
-            binaryInst.getLhs()->getType());
+            zirValueType(binaryInst.getLhs()));
         auto *elemTy = toLLVMType(*pointerType->getBaseType());
         auto *indexTy = nativeIntegerType();
         auto *index = builder_.CreateIntCast(rhs, indexTy, /*isSigned=*/true);
@@ -561,7 +827,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     default:
       break;
     }
-    zirValueMap_[binaryInst.getResult().get()] = result;
+    zirValueMap_[binaryInst.getResult()] = result;
     return;
   }
   case OpCode::Cmp: {
@@ -577,16 +843,12 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         unsigned lhsBits = lhsTy->getIntegerBitWidth();
         unsigned rhsBits = rhsTy->getIntegerBitWidth();
         if (lhsBits < rhsBits) {
-          bool lhsUnsigned = cmpInst.getLhs() && cmpInst.getLhs()->getType()
-                                 ? cmpInst.getLhs()->getType()->isUnsigned()
-                                 : false;
+          bool lhsUnsigned = zirValueType(cmpInst.getLhs())->isUnsigned();
           lhs = lhsUnsigned ? builder_.CreateZExt(lhs, rhsTy)
                             : builder_.CreateSExt(lhs, rhsTy);
           lhsTy = lhs->getType();
         } else if (rhsBits < lhsBits) {
-          bool rhsUnsigned = cmpInst.getRhs() && cmpInst.getRhs()->getType()
-                                 ? cmpInst.getRhs()->getType()->isUnsigned()
-                                 : false;
+          bool rhsUnsigned = zirValueType(cmpInst.getRhs())->isUnsigned();
           rhs = rhsUnsigned ? builder_.CreateZExt(rhs, lhsTy)
                             : builder_.CreateSExt(rhs, lhsTy);
           rhsTy = rhs->getType();
@@ -602,16 +864,12 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
           rhsTy = rhs->getType();
         }
       } else if (lhsTy->isIntegerTy() && rhsTy->isFloatingPointTy()) {
-        bool lhsUnsigned = cmpInst.getLhs() && cmpInst.getLhs()->getType()
-                               ? cmpInst.getLhs()->getType()->isUnsigned()
-                               : false;
+        bool lhsUnsigned = zirValueType(cmpInst.getLhs())->isUnsigned();
         lhs = lhsUnsigned ? builder_.CreateUIToFP(lhs, rhsTy)
                           : builder_.CreateSIToFP(lhs, rhsTy);
         lhsTy = lhs->getType();
       } else if (lhsTy->isFloatingPointTy() && rhsTy->isIntegerTy()) {
-        bool rhsUnsigned = cmpInst.getRhs() && cmpInst.getRhs()->getType()
-                               ? cmpInst.getRhs()->getType()->isUnsigned()
-                               : false;
+        bool rhsUnsigned = zirValueType(cmpInst.getRhs())->isUnsigned();
         rhs = rhsUnsigned ? builder_.CreateUIToFP(rhs, lhsTy)
                           : builder_.CreateSIToFP(rhs, lhsTy);
         rhsTy = rhs->getType();
@@ -620,11 +878,11 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     if (lhsTy != rhsTy) {
       throw std::runtime_error(
           "ZIR cmp operand type mismatch after coercion: " +
-          cmpInst.getLhs()->getTypeName() + " vs " +
-          cmpInst.getRhs()->getTypeName());
+          zirValue(cmpInst.getLhs()).getTypeName() + " vs " +
+          zirValue(cmpInst.getRhs()).getTypeName());
     }
-    if (isStringType(cmpInst.getLhs()->getType()) &&
-        isStringType(cmpInst.getRhs()->getType()) &&
+    if (isStringType(zirValueType(cmpInst.getLhs())) &&
+        isStringType(zirValueType(cmpInst.getRhs())) &&
         (pred == "eq" || pred == "ne")) {
       auto *boolTy = llvm::Type::getInt1Ty(ctx_);
       auto *strTy = lhsTy;
@@ -632,7 +890,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       auto eqCallee = module_->getOrInsertFunction("eq", eqFnTy);
       auto *isEq = builder_.CreateCall(eqFnTy, eqCallee.getCallee(), {lhs, rhs},
                                        "str.eq");
-      zirValueMap_[cmpInst.getResult().get()] =
+      zirValueMap_[cmpInst.getResult()] =
           pred == "eq" ? isEq : builder_.CreateNot(isEq, "str.ne");
       return;
     }
@@ -672,22 +930,23 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         result = builder_.CreateICmpUGE(lhs, rhs);
     }
     if (!result) {
-      throw std::runtime_error("unsupported ZIR cmp predicate/type: " + pred +
-                               " on " + cmpInst.getLhs()->getTypeName());
+      throw std::runtime_error(
+          "unsupported ZIR cmp predicate/type: " + pred + " on " +
+          zirValue(cmpInst.getLhs()).getTypeName());
     }
-    zirValueMap_[cmpInst.getResult().get()] = result;
+    zirValueMap_[cmpInst.getResult()] = result;
     return;
   }
   case OpCode::ClassIs: {
     const auto &classIs = static_cast<const ClassIsInst &>(inst);
     auto *object = lowerZIRRValue(classIs.getObject());
     auto sourceType = std::static_pointer_cast<zir::ClassType>(
-        classIs.getObject()->getType());
+        zirValueType(classIs.getObject()));
     auto *objectTy = structCache_.at(sourceType->getCodegenName() + ".obj");
-    auto *metadataAddr = builder_.CreateStructGEP(
-        objectTy, object, kClassMetadataIndex, "classis.metadata.addr");
-    auto *metadata = builder_.CreateLoad(llvm::PointerType::getUnqual(ctx_),
-                                         metadataAddr, "classis.metadata");
+    auto *typeAddr = builder_.CreateStructGEP(
+        objectTy, object, kClassTypeIndex, "classis.type.addr");
+    auto *dynamicType = builder_.CreateLoad(llvm::PointerType::getUnqual(ctx_),
+                                            typeAddr, "classis.type");
     llvm::Value *result = llvm::ConstantInt::getFalse(ctx_);
     for (const auto &[name, classType] : classTypes_) {
       bool matches = false;
@@ -702,32 +961,32 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         continue;
       }
       auto *candidate = llvm::ConstantExpr::getBitCast(
-          classMetadataGlobals_.at(name), llvm::PointerType::getUnqual(ctx_));
+          classTypeDescriptors_.at(name), llvm::PointerType::getUnqual(ctx_));
       auto *isCandidate =
-          builder_.CreateICmpEQ(metadata, candidate, "classis");
+          builder_.CreateICmpEQ(dynamicType, candidate, "classis");
       result = builder_.CreateOr(result, isCandidate, "classis.any");
     }
-    zirValueMap_[classIs.getResult().get()] = result;
+    zirValueMap_[classIs.getResult()] = result;
     return;
   }
   case OpCode::Br: {
     const auto &branchInst = static_cast<const BranchInst &>(inst);
-    builder_.CreateBr(zirBlockMap_.at(branchInst.getTarget()));
+    builder_.CreateBr(zirBlockMap_.at(branchInst.getTargetBlock()));
     return;
   }
   case OpCode::CondBr: {
     const auto &branchInst = static_cast<const CondBranchInst &>(inst);
     builder_.CreateCondBr(lowerZIRRValue(branchInst.getCondition()),
-                          zirBlockMap_.at(branchInst.getTrueLabel()),
-                          zirBlockMap_.at(branchInst.getFalseLabel()));
+                          zirBlockMap_.at(branchInst.getTrueBlock()),
+                          zirBlockMap_.at(branchInst.getFalseBlock()));
     return;
   }
   case OpCode::Ret: {
     const auto &returnInst = static_cast<const ReturnInst &>(inst);
-    if (returnInst.getValue()) {
+    if (returnInst.getValue() != NoValue) {
       auto *retValue = lowerZIRRValue(returnInst.getValue());
-      auto retType = returnInst.getValue()->getType();
-      if (returnInst.getValue()->getOwnership() ==
+      auto retType = zirValueType(returnInst.getValue());
+      if (zirValue(returnInst.getValue()).getOwnership() ==
           zir::ValueOwnership::Borrowed) {
         if (isClassType(retType)) {
           emitRetainIfNeeded(retValue, retType);
@@ -758,7 +1017,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     if (callInst.isIndirect()) {
       auto *calleePtr = lowerZIRRValue(callInst.getCalleeValue());
       const auto &fpType = static_cast<const zir::FunctionPointerType &>(
-          *callInst.getCalleeValue()->getType());
+          *zirValueType(callInst.getCalleeValue()));
       std::vector<llvm::Type *> paramTypes;
       for (const auto &p : fpType.getParams())
         paramTypes.push_back(toLLVMType(*p));
@@ -772,10 +1031,10 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         args.push_back(lowered);
       }
       auto *call = builder_.CreateCall(fnTy, calleePtr, args);
-      if (callInst.getResult()) {
-        zirValueMap_[callInst.getResult().get()] = call;
+      if (callInst.getResult() != NoValue) {
+        zirValueMap_[callInst.getResult()] = call;
         if (fpType.returnsRef()) {
-          refReturnValues_.insert(callInst.getResult().get());
+          refReturnValues_.insert(callInst.getResult());
         }
       }
       return;
@@ -804,8 +1063,8 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         }
 
         llvm::Type *retTy = llvm::Type::getVoidTy(ctx_);
-        if (callInst.getResult()) {
-          retTy = toLLVMType(*callInst.getResult()->getType());
+        if (callInst.getResult() != NoValue) {
+          retTy = toLLVMType(*zirValueType(callInst.getResult()));
         }
 
         auto *fnTy = llvm::FunctionType::get(retTy, inferredParamTypes, false);
@@ -828,11 +1087,14 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     std::shared_ptr<zir::Type> variadicElementType = nullptr;
     bool isCVariadic = calleeTy->isVarArg();
     if (zirIt != zirFunctionMap_.end()) {
+      const auto &calleeFn = *zirIt->second;
       fixedParamCount = 0;
-      for (const auto &param : zirIt->second->getArguments()) {
+      for (size_t i = 0; i < calleeFn.getArguments().size(); ++i) {
+        const auto *param = calleeFn.getArgument(i);
         if (param->isVariadicPack()) {
           hasVariadicParameter = true;
-          variadicElementType = param->getVariadicElementType();
+          variadicElementType =
+              calleeFn.values.share(param->getVariadicElementType());
           break;
         }
         ++fixedParamCount;
@@ -847,7 +1109,9 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       std::shared_ptr<zir::Type> calleeParamType = nullptr;
       if (zirIt != zirFunctionMap_.end() && i < fixedParamCount &&
           i < zirIt->second->getArguments().size()) {
-        calleeParamType = zirIt->second->getArguments()[i]->getType();
+        const auto &calleeFn = *zirIt->second;
+        calleeParamType =
+            calleeFn.values.share(calleeFn.getArgument(i)->getType());
       }
       llvm::Type *paramTy = nullptr;
       if (i < fixedParamCount &&
@@ -855,9 +1119,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         paramTy = calleeTy->getParamType(static_cast<unsigned>(i));
       }
       if (paramTy && arg->getType() != paramTy) {
-        auto argumentType = callInst.getArguments()[i]
-                                ? callInst.getArguments()[i]->getType()
-                                : nullptr;
+        auto argumentType = zirValueType(callInst.getArguments()[i]);
         if (isStringType(argumentType) && isStringType(calleeParamType)) {
           auto *ptr = builder_.CreateExtractValue(arg, {0}, "zir.call.str.ptr");
           auto *len = builder_.CreateExtractValue(arg, {1}, "zir.call.str.len");
@@ -881,9 +1143,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         if (argTy->isIntegerTy()) {
           unsigned bits = argTy->getIntegerBitWidth();
           if (bits < 32) {
-            auto argType = callInst.getArguments()[i]
-                               ? callInst.getArguments()[i]->getType()
-                               : nullptr;
+            auto argType = zirValueType(callInst.getArguments()[i]);
             bool isUnsignedArg =
                 argType && (argType->isUnsigned() ||
                             argType->getKind() == zir::TypeKind::Bool ||
@@ -909,7 +1169,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       llvm::Value *forwardedCount =
           llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0);
       llvm::Value *forwardedData = llvm::ConstantPointerNull::get(elemPtrTy);
-      if (callInst.getVariadicPack()) {
+      if (callInst.getVariadicPack() != NoValue) {
         auto *packValue = lowerZIRRValue(callInst.getVariadicPack());
         forwardedData =
             builder_.CreateExtractValue(packValue, {0}, "varargs.forward.data");
@@ -925,7 +1185,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
           llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_),
                                  static_cast<uint64_t>(explicitVariadicCount));
 
-      if (explicitVariadicCount == 0 && !callInst.getVariadicPack()) {
+      if (explicitVariadicCount == 0 && callInst.getVariadicPack() == NoValue) {
         args.push_back(explicitCount);
         args.push_back(llvm::ConstantPointerNull::get(elemPtrTy));
       } else if (explicitVariadicCount == 0) {
@@ -933,7 +1193,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         args.push_back(forwardedData);
       } else {
         llvm::Value *totalCount = explicitCount;
-        if (callInst.getVariadicPack()) {
+        if (callInst.getVariadicPack() != NoValue) {
           totalCount = builder_.CreateAdd(explicitCount, forwardedCount,
                                           "varargs.total");
         }
@@ -947,7 +1207,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
           builder_.CreateStore(args[fixedParamCount + i], dst);
         }
 
-        if (callInst.getVariadicPack()) {
+        if (callInst.getVariadicPack() != NoValue) {
           auto *copyCondBB =
               llvm::BasicBlock::Create(ctx_, "varargs.copy.cond", currentFn_);
           auto *copyBodyBB =
@@ -995,7 +1255,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     llvm::Value *call = nullptr;
     if (zirIt != zirFunctionMap_.end() && zirIt->second->vtableSlot >= 0 &&
         !args.empty()) {
-      auto receiverType = callInst.getArguments().front()->getType();
+      auto receiverType = zirValueType(callInst.getArguments().front());
       std::shared_ptr<zir::ClassType> classType = nullptr;
       if (receiverType->getKind() == zir::TypeKind::Class) {
         classType = std::static_pointer_cast<zir::ClassType>(receiverType);
@@ -1011,14 +1271,11 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         auto *objectTy = structCache_.at(classType->getCodegenName() + ".obj");
         auto *selfPtr = builder_.CreateBitCast(
             args[0], llvm::PointerType::getUnqual(ctx_), "zir.method.self");
-        auto *vtableAddr = builder_.CreateStructGEP(
-            objectTy, selfPtr, kClassVTableIndex, "zir.method.vtable.addr");
         auto *i8PtrTy = llvm::PointerType::getUnqual(ctx_);
-        auto *vtablePtrTy = llvm::PointerType::getUnqual(ctx_);
-        auto *vtablePtr =
-            builder_.CreateLoad(vtablePtrTy, vtableAddr, "zir.method.vtable");
+        auto *vtableAddr = emitClassTypeFieldAddr(
+            objectTy, selfPtr, kClassTypeVTableIndex, "zir.method.vtable");
         auto *slotAddr = builder_.CreateInBoundsGEP(
-            i8PtrTy, vtablePtr,
+            i8PtrTy, vtableAddr,
             llvm::ConstantInt::get(
                 llvm::Type::getInt32Ty(ctx_),
                 static_cast<uint64_t>(zirIt->second->vtableSlot)));
@@ -1032,10 +1289,10 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     if (!call) {
       call = builder_.CreateCall(callee, args);
     }
-    if (callInst.getResult()) {
-      zirValueMap_[callInst.getResult().get()] = call;
+    if (callInst.getResult() != NoValue) {
+      zirValueMap_[callInst.getResult()] = call;
       if (zirIt != zirFunctionMap_.end() && zirIt->second->returnsRef) {
-        refReturnValues_.insert(callInst.getResult().get());
+        refReturnValues_.insert(callInst.getResult());
       }
     }
     return;
@@ -1043,9 +1300,12 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
   case OpCode::GetElementPtr: {
     const auto &gepInst = static_cast<const GetElementPtrInst &>(inst);
     auto *ptr = lowerZIRValue(gepInst.getPointer());
-    auto operandType = gepInst.getPointer()->getType();
+    auto operandType = zirValueType(gepInst.getPointer());
     auto pointerType = std::dynamic_pointer_cast<zir::PointerType>(operandType);
     auto baseType = pointerType ? pointerType->getBaseType() : operandType;
+    const auto &resultName =
+        static_cast<const Register &>(zirValue(gepInst.getResult()))
+            .getRawName();
     llvm::Value *gep = nullptr;
 
     if (baseType->getKind() == zir::TypeKind::Record) {
@@ -1053,17 +1313,14 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       auto *structTy = llvm::cast<llvm::StructType>(toLLVMType(*recordType));
       llvm::Value *structPtr = ptr;
       if (!pointerType) {
-        auto *tmp = createEntryAlloca(
-            currentFn_,
-            static_cast<const Register &>(*gepInst.getResult()).getRawName() +
-                ".addr",
-            structTy);
+        auto *tmp =
+            createEntryAlloca(currentFn_, resultName + ".addr", structTy);
         builder_.CreateStore(ptr, tmp);
         structPtr = tmp;
       }
       gep = builder_.CreateStructGEP(
           structTy, structPtr, static_cast<unsigned>(gepInst.getIndex()),
-          static_cast<const Register &>(*gepInst.getResult()).getRawName());
+          resultName);
     } else if (baseType->getKind() == zir::TypeKind::TaggedUnion) {
       auto taggedUnionType =
           std::static_pointer_cast<zir::TaggedUnionType>(baseType);
@@ -1071,17 +1328,14 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
           llvm::cast<llvm::StructType>(toLLVMType(*taggedUnionType));
       llvm::Value *structPtr = ptr;
       if (!pointerType) {
-        auto *tmp = createEntryAlloca(
-            currentFn_,
-            static_cast<const Register &>(*gepInst.getResult()).getRawName() +
-                ".addr",
-            structTy);
+        auto *tmp =
+            createEntryAlloca(currentFn_, resultName + ".addr", structTy);
         builder_.CreateStore(ptr, tmp);
         structPtr = tmp;
       }
       gep = builder_.CreateStructGEP(
           structTy, structPtr, static_cast<unsigned>(gepInst.getIndex()),
-          static_cast<const Register &>(*gepInst.getResult()).getRawName());
+          resultName);
     } else if (baseType->getKind() == zir::TypeKind::Class) {
       auto classType = std::static_pointer_cast<zir::ClassType>(baseType);
       auto *objectTy = structCache_.at(classType->getCodegenName() + ".obj");
@@ -1089,59 +1343,54 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
       gep = builder_.CreateStructGEP(
           objectTy, objectPtr,
           static_cast<unsigned>(gepInst.getIndex() + kClassFieldStartIndex),
-          static_cast<const Register &>(*gepInst.getResult()).getRawName());
+          resultName);
     } else {
       llvm::Value *basePtr = ptr;
       llvm::Value *index =
-          gepInst.getIndexValue()
+          gepInst.getIndexValue() != NoValue
               ? lowerZIRRValue(gepInst.getIndexValue())
               : llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_),
                                        gepInst.getIndex());
       if (baseType->getKind() == zir::TypeKind::Array) {
         auto *arrayTy = toLLVMType(*baseType);
         if (!pointerType) {
-          auto *tmp = createEntryAlloca(
-              currentFn_,
-              static_cast<const Register &>(*gepInst.getResult()).getRawName() +
-                  ".array.addr",
-              arrayTy);
+          auto *tmp = createEntryAlloca(currentFn_, resultName + ".array.addr",
+                                        arrayTy);
           builder_.CreateStore(ptr, tmp);
           basePtr = tmp;
         }
         auto *i32Ty = llvm::Type::getInt32Ty(ctx_);
         llvm::Value *indices[] = {llvm::ConstantInt::get(i32Ty, 0), index};
-        gep = builder_.CreateInBoundsGEP(
-            arrayTy, basePtr, indices,
-            static_cast<const Register &>(*gepInst.getResult()).getRawName());
+        gep = builder_.CreateInBoundsGEP(arrayTy, basePtr, indices,
+                                         resultName);
       } else {
         if (!pointerType) {
           throw std::runtime_error("ZIR getelementptr expects pointer operand");
         }
         auto *elemTy = toLLVMType(*baseType);
-        gep = builder_.CreateInBoundsGEP(
-            elemTy, ptr, index,
-            static_cast<const Register &>(*gepInst.getResult()).getRawName());
+        gep = builder_.CreateInBoundsGEP(elemTy, ptr, index, resultName);
       }
     }
-    zirValueMap_[gepInst.getResult().get()] = gep;
+    zirValueMap_[gepInst.getResult()] = gep;
     return;
   }
   case OpCode::Phi: {
     const auto &phiInst = static_cast<const PhiInst &>(inst);
     auto *phi = builder_.CreatePHI(
-        toLLVMType(*phiInst.getResult()->getType()),
+        toLLVMType(*zirValueType(phiInst.getResult())),
         phiInst.getIncoming().size(),
-        static_cast<const Register &>(*phiInst.getResult()).getRawName());
-    pendingPhiIncoming_.push_back({phi, phiInst.getIncoming()});
-    zirValueMap_[phiInst.getResult().get()] = phi;
+        static_cast<const Register &>(zirValue(phiInst.getResult()))
+            .getRawName());
+    pendingPhiIncoming_.push_back({phi, &phiInst});
+    zirValueMap_[phiInst.getResult()] = phi;
     return;
   }
   case OpCode::Cast: {
     const auto &castInst = static_cast<const CastInst &>(inst);
     auto *source = lowerZIRRValue(castInst.getSource());
-    auto *result = lowerZIRCast(source, castInst.getSource()->getType(),
+    auto *result = lowerZIRCast(source, zirValueType(castInst.getSource()),
                                 castInst.getTargetType());
-    zirValueMap_[castInst.getResult().get()] = result;
+    zirValueMap_[castInst.getResult()] = result;
     return;
   }
   case OpCode::Copy: {
@@ -1150,36 +1399,36 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
     emitRuntimeOwnershipEvent("zap_runtime_ownership_note_copy");
 #endif
-    emitManagedRetain(source, copyInst.getSource()->getType());
-    zirValueMap_[copyInst.getResult().get()] = source;
+    emitManagedRetain(source, zirValueType(copyInst.getSource()));
+    zirValueMap_[copyInst.getResult()] = source;
     return;
   }
   case OpCode::Move: {
     const auto &moveInst = static_cast<const MoveInst &>(inst);
-    zirValueMap_[moveInst.getResult().get()] =
+    zirValueMap_[moveInst.getResult()] =
         lowerZIRRValue(moveInst.getSource());
     return;
   }
   case OpCode::Borrow: {
     const auto &borrowInst = static_cast<const BorrowInst &>(inst);
     auto *source = lowerZIRRValue(borrowInst.getOwner());
-    auto *result = lowerZIRCast(source, borrowInst.getOwner()->getType(),
-                                borrowInst.getResult()->getType());
-    zirValueMap_[borrowInst.getResult().get()] = result;
+    auto *result = lowerZIRCast(source, zirValueType(borrowInst.getOwner()),
+                                zirValueType(borrowInst.getResult()));
+    zirValueMap_[borrowInst.getResult()] = result;
     return;
   }
   case OpCode::WeakLock: {
     const auto &weakLockInst = static_cast<const WeakLockInst &>(inst);
     auto *result = emitWeakLock(lowerZIRRValue(weakLockInst.getWeakValue()),
-                                weakLockInst.getWeakValue()->getType());
-    zirValueMap_[weakLockInst.getResult().get()] = result;
+                                zirValueType(weakLockInst.getWeakValue()));
+    zirValueMap_[weakLockInst.getResult()] = result;
     return;
   }
   case OpCode::WeakAlive: {
     const auto &weakAliveInst = static_cast<const WeakAliveInst &>(inst);
     auto *result = emitWeakAlive(lowerZIRRValue(weakAliveInst.getWeakValue()),
-                                 weakAliveInst.getWeakValue()->getType());
-    zirValueMap_[weakAliveInst.getResult().get()] = result;
+                                 zirValueType(weakAliveInst.getWeakValue()));
+    zirValueMap_[weakAliveInst.getResult()] = result;
     return;
   }
   case OpCode::Alloc: {
@@ -1221,7 +1470,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
     auto *weakCountAddr = builder_.CreateStructGEP(
         objectTy, typedPtr, kClassWeakCountIndex, "weakcount.addr");
     builder_.CreateStore(
-        llvm::ConstantInt::get(llvm::Type::getInt64Ty(ctx_), 0), weakCountAddr);
+        llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0), weakCountAddr);
     auto *aliveAddr = builder_.CreateStructGEP(objectTy, typedPtr,
                                                kClassAliveIndex, "alive.addr");
     builder_.CreateStore(llvm::ConstantInt::get(llvm::Type::getInt8Ty(ctx_), 1),
@@ -1230,34 +1479,12 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
         objectTy, typedPtr, kClassGcMarkIndex, "gcmark.addr");
     builder_.CreateStore(llvm::ConstantInt::get(llvm::Type::getInt8Ty(ctx_), 0),
                          gcMarkAddr);
-    auto *releaseFnAddr = builder_.CreateStructGEP(
-        objectTy, typedPtr, kClassReleaseFnIndex, "release.fn.addr");
-    auto *releaseFnPtr =
-        builder_.CreateBitCast(classReleaseFns_.at(classType->getCodegenName()),
-                               llvm::PointerType::getUnqual(ctx_));
-    builder_.CreateStore(releaseFnPtr, releaseFnAddr);
-    auto *destroyFnAddr = builder_.CreateStructGEP(
-        objectTy, typedPtr, kClassDestroyFnIndex, "destroy.fn.addr");
-    auto *destroyFnPtr =
-        builder_.CreateBitCast(classDestroyFns_.at(classType->getCodegenName()),
-                               llvm::PointerType::getUnqual(ctx_));
-    builder_.CreateStore(destroyFnPtr, destroyFnAddr);
-    auto *metadataAddr = builder_.CreateStructGEP(
-        objectTy, typedPtr, kClassMetadataIndex, "metadata.addr");
-    auto *metadataPtr = builder_.CreateBitCast(
-        classMetadataGlobals_.at(classType->getCodegenName()),
+    auto *typeAddr = builder_.CreateStructGEP(objectTy, typedPtr,
+                                              kClassTypeIndex, "type.addr");
+    auto *typePtr = builder_.CreateBitCast(
+        classTypeDescriptors_.at(classType->getCodegenName()),
         llvm::PointerType::getUnqual(ctx_));
-    builder_.CreateStore(metadataPtr, metadataAddr);
-    auto *vtableAddr = builder_.CreateStructGEP(
-        objectTy, typedPtr, kClassVTableIndex, "vtable.addr");
-    auto *vtablePtrTy = llvm::PointerType::getUnqual(ctx_);
-    auto *vtableGlobal = classVTables_.at(classType->getCodegenName());
-    auto *zero = llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx_), 0);
-    llvm::Constant *vtableIndices[] = {zero, zero};
-    auto *vtablePtr = llvm::ConstantExpr::getInBoundsGetElementPtr(
-        vtableGlobal->getValueType(), vtableGlobal, vtableIndices);
-    builder_.CreateStore(llvm::ConstantExpr::getBitCast(vtablePtr, vtablePtrTy),
-                         vtableAddr);
+    builder_.CreateStore(typePtr, typeAddr);
 
     for (size_t i = 0; i < classType->getFields().size(); ++i) {
       auto *fieldAddr = builder_.CreateStructGEP(
@@ -1267,7 +1494,7 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
                            fieldAddr);
     }
 
-    zirValueMap_[allocInst.getResult().get()] = typedPtr;
+    zirValueMap_[allocInst.getResult()] = typedPtr;
     return;
   }
   case OpCode::InlineAsm: {
@@ -1291,12 +1518,19 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
   }
   case OpCode::Destroy: {
     const auto &destroyInst = static_cast<const DestroyInst &>(inst);
+    if (fusedStringConcats_.count(destroyInst.getValue())) {
+      return;
+    }
+    if (!pendingStringConcats_.empty()) {
+      deferredConcatDestroys_.push_back(&inst);
+      return;
+    }
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
     emitRuntimeOwnershipEvent("zap_runtime_ownership_note_drop");
 #endif
     emitOwnershipRelease(lowerZIRRValue(destroyInst.getValue()),
-                         destroyInst.getValue()->getType(),
-                         destroyInst.getValue()->getOwnership());
+                         zirValueType(destroyInst.getValue()),
+                         zirValue(destroyInst.getValue()).getOwnership());
     return;
   }
   }
@@ -1304,9 +1538,11 @@ void LLVMCodeGen::emitZIRInstruction(const zir::Instruction &inst) {
 
 void LLVMCodeGen::resolveZIRPhiIncomingBlocks() {
   for (const auto &pending : pendingPhiIncoming_) {
-    for (const auto &incoming : pending.incoming) {
-      pending.phi->addIncoming(lowerZIRValue(incoming.second),
-                               zirBlockExitMap_.at(incoming.first));
+    const auto &incoming = pending.inst->getIncoming();
+    for (size_t i = 0; i < incoming.size(); ++i) {
+      pending.phi->addIncoming(
+          lowerZIRValue(incoming[i].second),
+          zirBlockExitMap_.at(pending.inst->getIncomingBlock(i)));
     }
   }
   pendingPhiIncoming_.clear();
@@ -1315,16 +1551,20 @@ void LLVMCodeGen::resolveZIRPhiIncomingBlocks() {
 void LLVMCodeGen::emitZIRFunction(const zir::Function &fn) {
   currentZIRFunction_ = &fn;
   currentFn_ = functionMap_.at(fn.name);
-  zirBlockMap_.clear();
-  zirValueMap_.clear();
+  zirBlockMap_.assign(fn.getBlockIdCount(), nullptr);
+  zirValueMap_.assign(fn.values.size(), nullptr);
   zirClassParamAllocas_.clear();
   zirPendingClassParamInitAllocas_.clear();
   zirFunctionClassLocals_.clear();
   zirFunctionStringLocals_.clear();
   zirFunctionAggregateLocals_.clear();
   zirParamSpillIndex_ = 0;
-  zirBlockExitMap_.clear();
+  zirBlockExitMap_.assign(fn.getBlockIdCount(), nullptr);
   pendingPhiIncoming_.clear();
+  fusedStringConcats_.clear();
+  pendingStringConcats_.clear();
+  deferredConcatDestroys_.clear();
+  collectFusedStringConcats(fn);
 
   auto llvmArgIt = currentFn_->arg_begin();
   if (!freestanding_ && fn.name == "main") {
@@ -1353,7 +1593,7 @@ void LLVMCodeGen::emitZIRFunction(const zir::Function &fn) {
         {builder_.CreateIntCast(argcValue, i32Ty, true), argvValue});
     builder_.CreateBr(llvm::BasicBlock::Create(
         ctx_, fn.getBlocks().front()->label, currentFn_));
-    zirBlockMap_[fn.getBlocks().front()->label] = &currentFn_->back();
+    zirBlockMap_[fn.getBlocks().front()->id] = &currentFn_->back();
   }
 
   std::vector<llvm::Value *> physicalArgs;
@@ -1364,17 +1604,18 @@ void LLVMCodeGen::emitZIRFunction(const zir::Function &fn) {
   for (size_t i = 0; i < fn.getBlocks().size(); ++i) {
     const auto &block = fn.getBlocks()[i];
     if (!freestanding_ && fn.name == "main" && i == 0 &&
-        zirBlockMap_.count(block->label) != 0) {
+        zirBlockMap_[block->id]) {
       continue;
     }
-    zirBlockMap_[block->label] =
+    zirBlockMap_[block->id] =
         llvm::BasicBlock::Create(ctx_, block->label, currentFn_);
   }
 
-  auto *argInsertBlock = zirBlockMap_.at(fn.getBlocks().front()->label);
+  auto *argInsertBlock = zirBlockMap_.at(fn.getBlocks().front()->id);
   builder_.SetInsertPoint(argInsertBlock, argInsertBlock->begin());
   size_t physicalArgIndex = 0;
-  for (const auto &arg : fn.getArguments()) {
+  for (size_t i = 0; i < fn.getArguments().size(); ++i) {
+    const auto *arg = fn.getArgument(i);
     if (arg->isVariadicPack()) {
       auto *sliceTy =
           static_cast<llvm::StructType *>(toLLVMType(*arg->getType()));
@@ -1390,14 +1631,14 @@ void LLVMCodeGen::emitZIRFunction(const zir::Function &fn) {
       }
       sliceValue = builder_.CreateInsertValue(sliceValue, countValue, {1},
                                               arg->getRawName() + ".len");
-      zirValueMap_[arg.get()] = sliceValue;
+      zirValueMap_[fn.getArguments()[i]] = sliceValue;
       continue;
     }
-    zirValueMap_[arg.get()] = physicalArgs.at(physicalArgIndex++);
+    zirValueMap_[fn.getArguments()[i]] = physicalArgs.at(physicalArgIndex++);
   }
 
   for (const auto &block : fn.getBlocks()) {
-    builder_.SetInsertPoint(zirBlockMap_.at(block->label));
+    builder_.SetInsertPoint(zirBlockMap_.at(block->id));
     for (const auto &inst : block->getInstructions()) {
       emitZIRInstruction(*inst);
       if (builder_.GetInsertBlock()->getTerminator()) {
@@ -1407,9 +1648,9 @@ void LLVMCodeGen::emitZIRFunction(const zir::Function &fn) {
 
     auto *endBlock = builder_.GetInsertBlock();
     if (endBlock && endBlock->getTerminator()) {
-      zirBlockExitMap_[block->label] = endBlock;
+      zirBlockExitMap_[block->id] = endBlock;
     } else {
-      zirBlockExitMap_[block->label] = zirBlockMap_.at(block->label);
+      zirBlockExitMap_[block->id] = zirBlockMap_.at(block->id);
     }
   }
 
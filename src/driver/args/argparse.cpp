@@ -2,6 +2,9 @@
 #include "args.hpp"
 
 #include "../compiler.hpp"
+#include "../lld_link.hpp"
+
+#include <charconv>
 
 namespace zap {
 
@@ -102,6 +105,12 @@ public:
   }
 };
 
+bool parsePositive(std::string_view text, unsigned &value) {
+  auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                   value);
+  return ec == std::errc() && end == text.data() + text.size() && value != 0;
+}
+
 ParseResult parse(const std::vector<std::string_view> &cmdline,
                   CmdlineArgs &args) {
   bool ok = true;
@@ -229,6 +238,97 @@ ParseResult parse(const std::vector<std::string_view> &cmdline,
     args.targetTriple = std::string(target);
   }
 
+  if (holder.has(ArgTypes::Cpu)) {
+    std::string_view cpu = holder.get(ArgTypes::Cpu)->optional;
+    if (cpu.empty()) {
+      reportError("--cpu requires a CPU name or 'native'");
+      return ParseResult::Failed;
+    }
+    args.targetCpu = std::string(cpu);
+  }
+
+  for (const ArgVal *arg : holder.getAll(ArgTypes::Features)) {
+    if (arg->optional.empty()) {
+      continue;
+    }
+    if (!args.targetFeatures.empty()) {
+      args.targetFeatures += ',';
+    }
+    args.targetFeatures += arg->optional;
+  }
+
+  if (holder.has(ArgTypes::Runtime)) {
+    std::string_view runtime = holder.get(ArgTypes::Runtime)->optional;
+    if (runtime == "auto") {
+      args.runtimeLinkage = RuntimeLinkage::Auto;
+    } else if (runtime == "bitcode") {
+      args.runtimeLinkage = RuntimeLinkage::Bitcode;
+    } else if (runtime == "object") {
+      args.runtimeLinkage = RuntimeLinkage::Object;
+    } else {
+      reportError("unknown runtime linkage '", runtime,
+                  "' (expected auto, bitcode or object)");
+      return ParseResult::Failed;
+    }
+  }
+
+  if (holder.has(ArgTypes::Linker)) {
+    std::string_view linker = holder.get(ArgTypes::Linker)->optional;
+    if (linker == "cc") {
+      args.linker = Linker::Cc;
+    } else if (linker == "lld") {
+      if (!zap::linker::lldAvailable()) {
+        reportError("--linker=lld is not available: zapc was built without "
+                    "LLD");
+        return ParseResult::Failed;
+      }
+      args.linker = Linker::Lld;
+    } else {
+      reportError("unknown linker '", linker, "' (expected cc or lld)");
+      return ParseResult::Failed;
+    }
+  }
+
+  if (holder.has(ArgTypes::Jobs)) {
+    std::string_view jobs = holder.get(ArgTypes::Jobs)->optional;
+    if (!parsePositive(jobs, args.jobs)) {
+      reportError("--jobs requires a positive number, got '", jobs, "'");
+      return ParseResult::Failed;
+    }
+  }
+
+  if (holder.has(ArgTypes::CodegenUnits)) {
+    std::string_view units = holder.get(ArgTypes::CodegenUnits)->optional;
+    if (!parsePositive(units, args.codegenUnits)) {
+      reportError("--codegen-units requires a positive number, got '", units,
+                  "'");
+      return ParseResult::Failed;
+    }
+  }
+
+  if (holder.has(ArgTypes::CacheDir)) {
+    std::string_view cacheDir = holder.get(ArgTypes::CacheDir)->optional;
+    if (cacheDir.empty()) {
+      reportError("--cache-dir requires a directory");
+      return ParseResult::Failed;
+    }
+    args.cacheDir = FilePath(cacheDir);
+  } else if (holder.has(ArgTypes::Cache) ||
+             holder.has(ArgTypes::Incremental)) {
+    args.cacheDir = ".zapcache";
+  }
+  args.incremental = holder.has(ArgTypes::Incremental);
+
+  args.timeReport = holder.has(ArgTypes::TimeReport);
+  if (holder.has(ArgTypes::Stats)) {
+    std::string_view stats = holder.get(ArgTypes::Stats)->optional;
+    if (stats.empty()) {
+      reportError("--stats requires a file name");
+      return ParseResult::Failed;
+    }
+    args.statsPath = FilePath(stats);
+  }
+
   for (const ArgVal *arg : holder.getAll(ArgTypes::LinkDir)) {
     std::string val = "-L";
     val += arg->optional;
@@ -28,6 +28,19 @@ enum class OptLevel : uint8_t {
   O3, ///< More optimizations.
 };
 
+/// @brief How the runtime is linked into executables.
+enum class RuntimeLinkage : uint8_t {
+  Auto,    ///< Bitcode when optimizing and runtime.bc exists, else object.
+  Bitcode, ///< Link runtime.bc into the module so its fast paths inline.
+  Object,  ///< Link the prebuilt runtime object.
+};
+
+/// @brief What links executables.
+enum class Linker : uint8_t {
+  Cc,  ///< Run the system C compiler.
+  Lld, ///< Run LLD inside zapc with the C compiler's link line.
+};
+
 struct CmdlineArgs {
   std::vector<std::string_view> inputs; ///< A vector of input files.
   std::vector<FilePath> sources;        ///< A vector of .zp files.
@@ -46,8 +59,18 @@ struct CmdlineArgs {
   bool printCorePath = false;   ///< Print the resolved core library directory.
 
   OptLevel optLevel = OptLevel::O1; ///< Optimization level (0-3).
+  RuntimeLinkage runtimeLinkage = RuntimeLinkage::Auto; ///< See --runtime=.
+  Linker linker = Linker::Cc; ///< See --linker=.
+  unsigned jobs = 0; ///< Compiler threads; 0 means one per core.
+  unsigned codegenUnits = 1; ///< Objects code generation is split into.
+  FilePath cacheDir;  ///< Build cache directory; empty disables caching.
+  bool incremental = false; ///< Emit and cache one object per module.
+  bool timeReport = false;  ///< Print phase timings and counters.
+  FilePath statsPath;       ///< Write phase timings and counters as JSON.
 
   std::string targetTriple; ///< LLVM target triple; empty means host target.
+  std::string targetCpu;    ///< Target CPU, "native" for the host CPU.
+  std::string targetFeatures; ///< Comma-separated LLVM target features.
 
   std::vector<std::string>
       linkerArgs; ///< Extra linker arguments (e.g. -lSDL2, -L/path).
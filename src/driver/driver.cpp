@@ -1,17 +1,22 @@
 #include "driver/driver.hpp"
 #include "ast/import_node.hpp"
 #include "codegen/llvm_codegen.hpp"
+#include "driver/compiler.hpp"
+#include "driver/lld_link.hpp"
 #include "driver/process.hpp"
 #include "frontend/frontend_session.hpp"
 #include "frontend/module_loader.hpp"
 #include "ir/ir_generator.hpp"
 #include "ir/ownership_lowering.hpp"
+#include "ir/ownership_optimization.hpp"
 #include "ir/zir_verifier.hpp"
 #include "lexer/lexer.hpp"
 #include "parser/parser.hpp"
 #include "sema/binder.hpp"
 #include "sema/bound_nodes.hpp"
 #include "sema/module_info.hpp"
+#include "utils/arena.hpp"
+#include "utils/compile_stats.hpp"
 #include "utils/diagnostics.hpp"
 #include "utils/stream.hpp"
 #include <algorithm>
@@ -25,24 +30,35 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <sstream>
 #include <string_view>
+#include <thread>
 
 namespace zap {
 bool compileSourceZIR(sema::BoundRootNode &node, std::ostream &ofoutput);
 bool compileSourceLLVMFromZIR(sema::BoundRootNode &node, std::string &output,
-                              const std::string &targetTriple,
-                              bool freestanding);
+                              const codegen::CodeGenTarget &target);
 std::unique_ptr<zir::Module> generateZIRModule(sema::BoundRootNode &node);
-bool compileObjectFromZIR(sema::BoundRootNode &node,
-                          const std::string &output_path,
-                          int optimization_level,
-                          const std::string &targetTriple, bool freestanding);
+bool compileObjectFromZIR(
+    sema::BoundRootNode &node,
+    const std::vector<std::filesystem::path> &output_paths,
+    int optimization_level, const codegen::CodeGenTarget &target,
+    unsigned threads, std::optional<std::filesystem::path> &runtimeBitcode);
+bool compileIncrementalObjectsFromZIR(
+    sema::BoundRootNode &node, const std::filesystem::path &cacheDir,
+    int optimization_level, const codegen::CodeGenTarget &target,
+    std::vector<std::filesystem::path> &objects);
 bool compileAssemblyFromZIR(sema::BoundRootNode &node,
                             const std::string &output_path,
                             int optimization_level,
-                            const std::string &targetTriple, bool freestanding);
+                            const codegen::CodeGenTarget &target);
 namespace {
 
+codegen::CodeGenTarget codegenTarget(const driver &drv) {
+  return {drv.get_target_triple(), drv.get_target_cpu(),
+          drv.get_target_features(), drv.is_freestanding()};
+}
+
 std::optional<sema::TargetInfo>
 targetInfoForTriple(const std::string &requestedTriple) {
   auto normalized = requestedTriple.empty()
@@ -58,6 +74,39 @@ targetInfoForTriple(const std::string &requestedTriple) {
   return std::nullopt;
 }
 
+void recordLoadStats(const frontend::FrontendProject &project) {
+  if (!stats::enabled()) {
+    return;
+  }
+  stats::count("modules", project.modules.size());
+  stats::count("modules from cache", project.cachedModules);
+  stats::count("tokens", project.tokenCount);
+  stats::count("ast nodes", project.nodeCount);
+  size_t arenaBytes = 0;
+  for (const auto &[_, module] : project.modules) {
+    arenaBytes += module->arena ? module->arena->bytesReserved() : 0;
+  }
+  stats::count("ast arena bytes", arenaBytes);
+}
+
+void recordBindStats(const frontend::FrontendProject &project) {
+  if (!stats::enabled()) {
+    return;
+  }
+  const auto &root = *project.boundRoot;
+  size_t instances = 0;
+  for (const auto &function : root.functions) {
+    instances += function->symbol->isGenericInstantiation ? 1 : 0;
+  }
+  stats::count("bound functions", root.functions.size());
+  stats::count("generic function instances", instances);
+  stats::count("generic type instances", root.genericTypes.size());
+  stats::count("generic instantiation hits", project.genericInstantiationHits);
+  stats::count("generic instantiation misses",
+               project.genericInstantiationMisses);
+  stats::count("bound arena bytes", project.boundArena->bytesReserved());
+}
+
 std::filesystem::path
 executableObjectPath(const std::filesystem::path &executablePath,
                      const std::filesystem::path &sourcePath) {
@@ -75,6 +124,22 @@ executableObjectPath(const std::filesystem::path &executablePath,
   return objectPath;
 }
 
+// Objects of an executable built in `units` code generation units:
+// `<object>` itself for one unit, `<object stem>.<i>.o` otherwise.
+std::vector<std::filesystem::path>
+codegenUnitPaths(const std::filesystem::path &objectPath, unsigned units) {
+  if (units <= 1) {
+    return {objectPath};
+  }
+  std::vector<std::filesystem::path> paths;
+  for (unsigned i = 0; i < units; ++i) {
+    auto path = objectPath;
+    path.replace_extension(std::to_string(i) + ".o");
+    paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
 bool emitRequestedTextOutputs(driver &drv, sema::BoundRootNode &node,
                               const std::filesystem::path &base_output_path) {
   bool direct_output =
@@ -104,8 +169,7 @@ bool emitRequestedTextOutputs(driver &drv, sema::BoundRootNode &node,
                                .replace_extension(driver::format_fileextension(
                                    args::OutputType::TEXT_LLVM));
     std::string llvmIr;
-    if (compileSourceLLVMFromZIR(node, llvmIr, drv.get_target_triple(),
-                                 drv.is_freestanding())) {
+    if (compileSourceLLVMFromZIR(node, llvmIr, codegenTarget(drv))) {
       return true;
     }
 
@@ -130,6 +194,13 @@ frontend::RuntimePaths runtimePaths() {
                                 std::filesystem::path(ZAPC_RUNTIME_PATH)};
 }
 
+// Rebuilding zapc invalidates cached modules even within one version.
+std::string compilerIdentity() {
+  std::ostringstream version;
+  version << ZAP_VERSION;
+  return frontend::moduleCacheIdentity(version.str(), g_executable_path);
+}
+
 bool readSourceFile(const std::filesystem::path &path, std::string &content) {
   std::ifstream file(path, std::ios::binary | std::ios::ate);
   if (!file) {
@@ -169,14 +240,22 @@ bool compileLoadedModules(driver &drv, const std::filesystem::path &entryPath) {
   }
   frontend::FrontendSession session(
       {runtimePaths(), drv.cmdArgs.importMap,
-       drv.cmdArgs.incStdlib && drv.cmdArgs.incPrelude, false, *targetInfo},
+       drv.cmdArgs.incStdlib && drv.cmdArgs.incPrelude, false, *targetInfo,
+       drv.cmdArgs.jobs != 0
+           ? drv.cmdArgs.jobs
+           : std::max(1u, std::thread::hardware_concurrency()),
+       drv.cmdArgs.cacheDir,
+       drv.cmdArgs.cacheDir.empty() ? std::string() : compilerIdentity()},
       [](const std::filesystem::path &path) -> std::optional<std::string> {
         std::string source;
         return readSourceFile(path, source)
                    ? std::nullopt
                    : std::optional<std::string>(std::move(source));
       });
-  auto project = session.load(entryPath);
+  auto project = [&] {
+    stats::PhaseTimer timer("load");
+    return session.load(entryPath);
+  }();
   for (const auto &error : project.errors) {
     driver::reportError(error);
   }
@@ -184,36 +263,58 @@ bool compileLoadedModules(driver &drv, const std::filesystem::path &entryPath) {
     DiagnosticTextFormatter::print(err(), project.diagnostics);
     return true;
   }
-  if (!session.bind(project)) {
+  recordLoadStats(project);
+  bool bound = false;
+  {
+    stats::PhaseTimer timer("bind");
+    bound = session.bind(project);
+  }
+  if (!bound) {
     DiagnosticTextFormatter::print(err(), project.diagnostics);
     driver::reportError(entryPath, ": semantic analysis failed");
     return true;
   }
   DiagnosticTextFormatter::print(err(), project.diagnostics);
   auto &boundAst = project.boundRoot;
+  recordBindStats(project);
+
+  if (drv.get_output_type() == args::OutputType::EXEC &&
+      drv.cmdArgs.incremental) {
+    // Cached objects stay in the cache directory and are linked from there.
+    return compileIncrementalObjectsFromZIR(
+        *boundAst, drv.cmdArgs.cacheDir,
+        static_cast<int>(drv.cmdArgs.optLevel), codegenTarget(drv),
+        drv.cmdArgs.objects);
+  }
 
   if (drv.binary_output()) {
-    std::filesystem::path out_path;
+    std::vector<std::filesystem::path> out_paths;
 
     if (drv.get_output_type() == args::OutputType::EXEC) {
-      out_path = executableObjectPath(drv.get_output(), entryPath);
-      drv.cleanups.emplace_back(out_path);
+      out_paths =
+          codegenUnitPaths(executableObjectPath(drv.get_output(), entryPath),
+                           drv.cmdArgs.codegenUnits);
+      drv.cleanups.insert(drv.cleanups.end(), out_paths.begin(),
+                          out_paths.end());
     } else if (drv.get_output_type() == args::OutputType::OBJECT) {
       if (drv.is_implicit_output()) {
-        out_path = entryPath.string() + ".o";
+        out_paths.emplace_back(entryPath.string() + ".o");
       } else {
-        out_path = drv.get_output();
+        out_paths.emplace_back(drv.get_output());
       }
     }
 
-    if (compileObjectFromZIR(*boundAst, out_path.string(),
+    auto runtimeBitcode = drv.runtimeBitcode();
+    if (compileObjectFromZIR(*boundAst, out_paths,
                              static_cast<int>(drv.cmdArgs.optLevel),
-                             drv.cmdArgs.targetTriple,
-                             drv.cmdArgs.freestanding)) {
+                             codegenTarget(drv), drv.cmdArgs.jobs,
+                             runtimeBitcode)) {
       return true;
     }
+    drv.runtime_linked_as_bitcode = runtimeBitcode.has_value();
 
-    drv.cmdArgs.objects.emplace_back(std::move(out_path));
+    drv.cmdArgs.objects.insert(drv.cmdArgs.objects.end(), out_paths.begin(),
+                               out_paths.end());
   } else if (drv.get_output_type() == args::OutputType::ASM) {
     std::filesystem::path out_path =
         drv.is_implicit_output() ? entryPath : drv.get_output();
@@ -221,8 +322,7 @@ bool compileLoadedModules(driver &drv, const std::filesystem::path &entryPath) {
         driver::format_fileextension(args::OutputType::ASM));
     if (compileAssemblyFromZIR(*boundAst, out_path.string(),
                                static_cast<int>(drv.cmdArgs.optLevel),
-                               drv.cmdArgs.targetTriple,
-                               drv.cmdArgs.freestanding)) {
+                               codegenTarget(drv))) {
       return true;
     }
   } else if (drv.emits_text_output()) {
@@ -248,6 +348,9 @@ args::ParseResult driver::parseArgs(int argc, char **argv) {
     out() << frontend::coreRootPath(runtimePaths()) << '\n';
     return args::ParseResult::SkipCompilation;
   }
+  if (cmdArgs.timeReport || !cmdArgs.statsPath.empty()) {
+    stats::enable();
+  }
   return result;
 }
 
@@ -325,17 +428,33 @@ bool driver::verifySources() {
 }
 
 std::unique_ptr<zir::Module> generateZIRModule(sema::BoundRootNode &node) {
-  zir::BoundIRGenerator irGen;
-  auto module = irGen.generate(node);
+  std::unique_ptr<zir::Module> module;
+  {
+    stats::PhaseTimer timer("zir");
+    zir::BoundIRGenerator irGen;
+    module = irGen.generate(node);
+  }
   if (!module) {
     return nullptr;
   }
+  stats::PhaseTimer timer("zir passes");
   zir::lowerDeadOwnedResults(*module);
+  zir::optimizeOwnershipOperations(*module);
   auto verification = zir::ZirVerifier().verifyForCodegen(*module);
   if (!verification) {
     throw std::runtime_error("ZIR verification failed:\n" +
                              verification.format());
   }
+  if (stats::enabled()) {
+    size_t instructions = 0;
+    for (const auto &function : module->functions) {
+      for (const auto &block : function->blocks) {
+        instructions += block->instructions.size();
+      }
+    }
+    stats::count("zir functions", module->functions.size());
+    stats::count("zir instructions", instructions);
+  }
   return module;
 }
 
@@ -356,8 +475,7 @@ bool compileSourceZIR(sema::BoundRootNode &node, std::ostream &ofoutput) {
 }
 
 bool compileSourceLLVMFromZIR(sema::BoundRootNode &node, std::string &output,
-                              const std::string &targetTriple,
-                              bool freestanding) {
+                              const codegen::CodeGenTarget &target) {
   try {
     auto mod = generateZIRModule(node);
     if (!mod) {
@@ -365,7 +483,7 @@ bool compileSourceLLVMFromZIR(sema::BoundRootNode &node, std::string &output,
       return true;
     }
 
-    codegen::LLVMCodeGen llvmGen(targetTriple, freestanding);
+    codegen::LLVMCodeGen llvmGen(target);
     llvmGen.generate(*mod);
     if (!llvmGen.verifyModule(llvm::errs())) {
       return true;
@@ -381,10 +499,46 @@ bool compileSourceLLVMFromZIR(sema::BoundRootNode &node, std::string &output,
   return false;
 }
 
-bool compileObjectFromZIR(sema::BoundRootNode &node,
-                          const std::string &output_path,
-                          int optimization_level,
-                          const std::string &targetTriple, bool freestanding) {
+bool compileObjectFromZIR(
+    sema::BoundRootNode &node,
+    const std::vector<std::filesystem::path> &output_paths,
+    int optimization_level, const codegen::CodeGenTarget &target,
+    unsigned threads, std::optional<std::filesystem::path> &runtimeBitcode) {
+  try {
+    auto mod = generateZIRModule(node);
+    if (!mod) {
+      driver::reportError("failed to generate ZIR");
+      return true;
+    }
+
+    codegen::LLVMCodeGen llvmGen(target);
+    llvmGen.generate(*mod);
+    std::string runtimeError;
+    if (runtimeBitcode &&
+        !llvmGen.linkRuntimeBitcode(runtimeBitcode->string(), runtimeError)) {
+      driver::reportWarning("cannot use runtime bitcode: ", runtimeError,
+                            "; linking the runtime object instead");
+      runtimeBitcode.reset();
+    }
+    std::vector<std::string> paths;
+    for (const auto &path : output_paths) {
+      paths.push_back(path.string());
+    }
+    if (!llvmGen.emitSplitObjectFiles(paths, optimization_level, threads)) {
+      driver::reportError("object file emission failed");
+      return true;
+    }
+  } catch (const std::exception &ex) {
+    driver::reportError("Object generation failed: ", ex.what());
+    return true;
+  }
+  return false;
+}
+
+bool compileIncrementalObjectsFromZIR(
+    sema::BoundRootNode &node, const std::filesystem::path &cacheDir,
+    int optimization_level, const codegen::CodeGenTarget &target,
+    std::vector<std::filesystem::path> &objects) {
   try {
     auto mod = generateZIRModule(node);
     if (!mod) {
@@ -392,12 +546,15 @@ bool compileObjectFromZIR(sema::BoundRootNode &node,
       return true;
     }
 
-    codegen::LLVMCodeGen llvmGen(targetTriple, freestanding);
+    codegen::LLVMCodeGen llvmGen(target);
     llvmGen.generate(*mod);
-    if (!llvmGen.emitObjectFile(output_path, optimization_level)) {
+    std::vector<std::string> paths;
+    if (!llvmGen.emitIncrementalObjects(cacheDir.string(), optimization_level,
+                                        compilerIdentity(), paths)) {
       driver::reportError("object file emission failed");
       return true;
     }
+    objects.insert(objects.end(), paths.begin(), paths.end());
   } catch (const std::exception &ex) {
     driver::reportError("Object generation failed: ", ex.what());
     return true;
@@ -408,8 +565,7 @@ bool compileObjectFromZIR(sema::BoundRootNode &node,
 bool compileAssemblyFromZIR(sema::BoundRootNode &node,
                             const std::string &output_path,
                             int optimization_level,
-                            const std::string &targetTriple,
-                            bool freestanding) {
+                            const codegen::CodeGenTarget &target) {
   try {
     auto mod = generateZIRModule(node);
     if (!mod) {
@@ -417,7 +573,7 @@ bool compileAssemblyFromZIR(sema::BoundRootNode &node,
       return true;
     }
 
-    codegen::LLVMCodeGen llvmGen(targetTriple, freestanding);
+    codegen::LLVMCodeGen llvmGen(target);
     llvmGen.generate(*mod);
     if (!llvmGen.emitAssemblyFile(output_path, optimization_level)) {
       driver::reportError("assembly file emission failed");
@@ -432,12 +588,14 @@ bool compileAssemblyFromZIR(sema::BoundRootNode &node,
 
 bool driver::compileSourceFile(const std::string &source,
                                const std::string &source_name) {
+  auto arena = Arena::create();
+  ArenaScope arenaScope(arena.get());
   zap::DiagnosticEngine diagnostics(source, source_name);
   Lexer lex(diagnostics);
 
   auto tokens = lex.tokenize(source);
 
-  zap::Parser parser(tokens, diagnostics);
+  zap::Parser parser(std::move(tokens), diagnostics);
   auto ast = parser.parse();
 
   if (diagnostics.hadErrors()) {
@@ -467,26 +625,32 @@ bool driver::compileSourceFile(const std::string &source,
   }
 
   if (binary_output()) {
-    std::filesystem::path out_path;
+    std::vector<std::filesystem::path> out_paths;
 
     if (cmdArgs.output.type == args::OutputType::EXEC) {
-      out_path = executableObjectPath(cmdArgs.output.path, source_name);
-      cleanups.emplace_back(out_path);
+      out_paths =
+          codegenUnitPaths(executableObjectPath(cmdArgs.output.path,
+                                                source_name),
+                           cmdArgs.codegenUnits);
+      cleanups.insert(cleanups.end(), out_paths.begin(), out_paths.end());
     } else if (cmdArgs.output.type == args::OutputType::OBJECT) {
       if (cmdArgs.output.implicit) {
-        out_path = source_name + ".o";
+        out_paths.emplace_back(source_name + ".o");
       } else {
-        out_path = cmdArgs.output.path;
+        out_paths.emplace_back(cmdArgs.output.path);
       }
     }
 
-    if (compileObjectFromZIR(*boundAst, out_path.string(),
+    std::optional<std::filesystem::path> runtimeBitcode;
+    if (compileObjectFromZIR(*boundAst, out_paths,
                              static_cast<int>(cmdArgs.optLevel),
-                             cmdArgs.targetTriple, cmdArgs.freestanding)) {
+                             codegenTarget(*this), cmdArgs.jobs,
+                             runtimeBitcode)) {
       return true;
     }
 
-    cmdArgs.objects.emplace_back(std::move(out_path));
+    cmdArgs.objects.insert(cmdArgs.objects.end(), out_paths.begin(),
+                           out_paths.end());
   } else if (cmdArgs.output.type == args::OutputType::ASM) {
     std::filesystem::path out_path = cmdArgs.output.implicit
                                          ? std::filesystem::path(source_name)
@@ -495,7 +659,7 @@ bool driver::compileSourceFile(const std::string &source,
         driver::format_fileextension(args::OutputType::ASM));
     if (compileAssemblyFromZIR(*boundAst, out_path.string(),
                                static_cast<int>(cmdArgs.optLevel),
-                               cmdArgs.targetTriple, cmdArgs.freestanding)) {
+                               codegenTarget(*this))) {
       return true;
     }
   } else if (emits_text_output()) {
@@ -521,21 +685,60 @@ bool driver::compile() {
   return false;
 }
 
+std::optional<std::filesystem::path> driver::runtimeBitcode() const {
+  const auto linkage = cmdArgs.runtimeLinkage;
+  if (linkage == args::RuntimeLinkage::Object || !needs_linking() ||
+      !cmdArgs.incStdlib) {
+    return std::nullopt;
+  }
+  if (linkage == args::RuntimeLinkage::Auto &&
+      cmdArgs.optLevel == args::OptLevel::O0) {
+    return std::nullopt;
+  }
+  // Runtime symbols become internal to the program's module, so nothing
+  // else in the executable may need the runtime. Incremental builds split
+  // that module, which would also split the runtime.
+  if (cmdArgs.sources.size() != 1 || !cmdArgs.objects.empty() ||
+      cmdArgs.incremental) {
+    if (linkage == args::RuntimeLinkage::Bitcode) {
+      reportWarning("--runtime=bitcode needs a single source file, no "
+                    "object inputs and no --incremental; linking the "
+                    "runtime object instead");
+    }
+    return std::nullopt;
+  }
+
+  auto path = frontend::runtimeBitcodePath(frontend::RuntimePaths{
+      executable_path, std::filesystem::path(ZAPC_CORE_DIR),
+      std::filesystem::path(ZAPC_STDLIB_DIR),
+      std::filesystem::path(ZAPC_RUNTIME_PATH)});
+  if (!std::filesystem::is_regular_file(path)) {
+    if (linkage == args::RuntimeLinkage::Bitcode) {
+      reportWarning("runtime bitcode not found at ", path,
+                    "; linking the runtime object instead");
+    }
+    return std::nullopt;
+  }
+  return path;
+}
+
 bool driver::link() {
   if (!needs_linking())
     return false;
+  stats::PhaseTimer timer("link");
 
   const std::filesystem::path linker = "/usr/bin/cc";
   std::vector<std::string> arguments;
 
   if (cmdArgs.incStdlib) {
-    auto paths = frontend::RuntimePaths{
-        executable_path, std::filesystem::path(ZAPC_CORE_DIR),
-        std::filesystem::path(ZAPC_STDLIB_DIR),
-        std::filesystem::path(ZAPC_RUNTIME_PATH)};
-    arguments.push_back(frontend::stdlibObjectPath(paths).string());
-  } else {
-    arguments.emplace_back("-nostdlib");
+    // A runtime linked in as bitcode is already part of the program object.
+    if (!runtime_linked_as_bitcode) {
+      auto paths = frontend::RuntimePaths{
+          executable_path, std::filesystem::path(ZAPC_CORE_DIR),
+          std::filesystem::path(ZAPC_STDLIB_DIR),
+          std::filesystem::path(ZAPC_RUNTIME_PATH)};
+      arguments.push_back(frontend::stdlibObjectPath(paths).string());
+    }
   }
 
   for (const auto &obj : cmdArgs.objects) {
@@ -549,6 +752,21 @@ bool driver::link() {
   arguments.emplace_back("-lm");
   arguments.emplace_back("-lssl");
   arguments.emplace_back("-lcrypto");
+
+  if (cmdArgs.linker == args::Linker::Lld) {
+    std::string error;
+    if (!zap::linker::linkWithLld(linker, arguments, cmdArgs.output.path,
+                                  !cmdArgs.incStdlib, cmdArgs.cacheDir,
+                                  error)) {
+      reportError("linking failed: ", error);
+      return true;
+    }
+    return false;
+  }
+
+  if (!cmdArgs.incStdlib) {
+    arguments.insert(arguments.begin(), "-nostdlib");
+  }
   arguments.emplace_back("-o");
   arguments.push_back(cmdArgs.output.path.string());
 
@@ -567,6 +785,20 @@ bool driver::link() {
   return true;
 }
 
+bool driver::report() {
+  if (!stats::enabled()) {
+    return false;
+  }
+  if (cmdArgs.timeReport) {
+    stats::printReport(err());
+  }
+  if (!cmdArgs.statsPath.empty() && !stats::writeJson(cmdArgs.statsPath)) {
+    reportError("cannot write statistics to ", cmdArgs.statsPath);
+    return true;
+  }
+  return false;
+}
+
 bool driver::cleanup() {
   bool errs = false;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
@@ -52,6 +53,11 @@ public:
   /// Should be called sixth after compiling.
   bool link();
 
+  /// @brief Prints the --time-report and writes the --stats= file, if asked.
+  /// @return True if an error has occured.
+  /// Should be called after linking, before cleaning up.
+  bool report();
+
   /// @brief Cleans up the files in the cleanup queue.
   /// @return True if an error has occured.
   /// Should be called seventh after linking.
@@ -91,6 +97,12 @@ public:
   const std::string &get_target_triple() const noexcept {
     return cmdArgs.targetTriple;
   }
+  const std::string &get_target_cpu() const noexcept {
+    return cmdArgs.targetCpu;
+  }
+  const std::string &get_target_features() const noexcept {
+    return cmdArgs.targetFeatures;
+  }
   bool is_freestanding() const noexcept { return cmdArgs.freestanding; }
   bool emits_text_output() const noexcept {
     return cmdArgs.output.type == args::OutputType::TEXT_LLVM ||
@@ -182,10 +194,16 @@ private:
   bool compileSourceFile(const std::string &source,
                          const std::string &source_name);
 
+  /// @brief Runtime bitcode to link into the program's module, if the
+  /// requested runtime linkage and the inputs allow it.
+  std::optional<std::filesystem::path> runtimeBitcode() const;
+
   args::CmdlineArgs cmdArgs; ///< Parsed command line arguments.
   std::vector<std::filesystem::path>
       cleanups; ///< A vector of files that need to be deleted.
   std::filesystem::path executable_path; ///< Path to the running executable.
+  bool runtime_linked_as_bitcode =
+      false; ///< The runtime was linked into the program's object.
 };
 
 } // namespace zap
@@ -0,0 +1,220 @@
+#include "driver/lld_link.hpp"
+#include "driver/process.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <system_error>
+
+#ifdef ZAPC_HAVE_LLD
+#include <lld/Common/Driver.h>
+#include <llvm/Support/raw_ostream.h>
+
+LLD_HAS_DRIVER(elf)
+#endif
+
+namespace zap::linker {
+namespace {
+
+// Stand-ins for the inputs and the output in the discovered link line.
+constexpr const char *inputsMarker = "--zap-inputs";
+constexpr const char *outputMarker = "zap-link-output";
+
+// Splits one command line as printed by `cc -###`: gcc quotes some
+// arguments, clang all of them, both escape `"` and `\` inside quotes.
+std::vector<std::string> splitCommand(const std::string &line) {
+  std::vector<std::string> words;
+  std::string word;
+  bool inWord = false;
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const char ch = line[i];
+    if (ch == '\\' && i + 1 < line.size()) {
+      word += line[++i];
+      inWord = true;
+    } else if (ch == '"') {
+      quoted = !quoted;
+      inWord = true;
+    } else if (!quoted && (ch == ' ' || ch == '\t')) {
+      if (inWord) {
+        words.push_back(std::move(word));
+        word.clear();
+        inWord = false;
+      }
+    } else {
+      word += ch;
+      inWord = true;
+    }
+  }
+  if (inWord) {
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+// Anything that changes with the C compiler's installation: its path,
+// size and modification time.
+std::string compilerStamp(const std::filesystem::path &cc) {
+  std::error_code ec;
+  const auto canonical = std::filesystem::canonical(cc, ec);
+  const auto &path = ec ? cc : canonical;
+  const auto size = std::filesystem::file_size(path, ec);
+  const auto time = std::filesystem::last_write_time(path, ec);
+  std::ostringstream stamp;
+  stamp << path.string() << ' ' << size << ' '
+        << time.time_since_epoch().count();
+  return stamp.str();
+}
+
+// Asks `cc -###` for its link command, with the markers in place of the
+// inputs and the output. The linker's own name and gcc's LTO plugin
+// options are dropped; LLD needs neither.
+std::optional<std::vector<std::string>>
+discoverLinkLine(const std::filesystem::path &cc, bool nostdlib,
+                 std::string &error) {
+  std::vector<std::string> arguments{"-###"};
+  if (nostdlib) {
+    arguments.emplace_back("-nostdlib");
+  }
+  arguments.push_back(std::string("-Wl,") + inputsMarker);
+  arguments.emplace_back("-o");
+  arguments.emplace_back(outputMarker);
+
+  std::string output;
+  const auto result = process::capture(cc, arguments, output);
+  if (!result.succeeded()) {
+    error = "cannot ask '" + cc.string() + "' for its link command";
+    return std::nullopt;
+  }
+
+  std::istringstream lines(output);
+  for (std::string line; std::getline(lines, line);) {
+    auto words = splitCommand(line);
+    bool hasInputs = false;
+    for (const auto &word : words) {
+      hasInputs = hasInputs || word == inputsMarker;
+    }
+    if (!hasInputs) {
+      continue;
+    }
+    std::vector<std::string> linkLine;
+    for (size_t i = 1; i < words.size(); ++i) {
+      if (words[i] == "-plugin" && i + 1 < words.size()) {
+        ++i;
+      } else if (words[i].rfind("-plugin-opt", 0) != 0) {
+        linkLine.push_back(std::move(words[i]));
+      }
+    }
+    return linkLine;
+  }
+  error = "'" + cc.string() + "' did not print a link command";
+  return std::nullopt;
+}
+
+std::optional<std::vector<std::string>>
+systemLinkLine(const std::filesystem::path &cc, bool nostdlib,
+               const std::filesystem::path &cacheDir, std::string &error) {
+  const auto stamp = compilerStamp(cc);
+  const auto cachePath =
+      cacheDir.empty() ? std::filesystem::path()
+                       : cacheDir / (nostdlib ? "link-nostdlib" : "link");
+  if (!cachePath.empty()) {
+    std::ifstream input(cachePath);
+    std::string line;
+    if (std::getline(input, line) && line == stamp) {
+      std::vector<std::string> linkLine;
+      while (std::getline(input, line)) {
+        linkLine.push_back(line);
+      }
+      return linkLine;
+    }
+  }
+
+  auto linkLine = discoverLinkLine(cc, nostdlib, error);
+  if (linkLine && !cachePath.empty()) {
+    // Written to a file of this process's own and renamed, so a concurrent
+    // build never reads half of it. Failures only cost the next build
+    // another `cc -###`.
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+    llvm::SmallString<128> temporary;
+    if (!llvm::sys::fs::createUniqueFile(cachePath.string() + ".tmp%%%%%%",
+                                         temporary)) {
+      bool written = false;
+      {
+        std::ofstream out(temporary.str().str(), std::ios::trunc);
+        out << stamp << '\n';
+        for (const auto &word : *linkLine) {
+          out << word << '\n';
+        }
+        written = static_cast<bool>(out.flush());
+      }
+      if (written) {
+        std::filesystem::rename(temporary.str().str(), cachePath, ec);
+      }
+      if (!written || ec) {
+        std::filesystem::remove(temporary.str().str(), ec);
+      }
+    }
+  }
+  return linkLine;
+}
+
+} // namespace
+
+bool lldAvailable() {
+#ifdef ZAPC_HAVE_LLD
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool linkWithLld(const std::filesystem::path &cc,
+                 const std::vector<std::string> &inputs,
+                 const std::filesystem::path &output, bool nostdlib,
+                 const std::filesystem::path &cacheDir, std::string &error) {
+#ifdef ZAPC_HAVE_LLD
+  auto linkLine = systemLinkLine(cc, nostdlib, cacheDir, error);
+  if (!linkLine) {
+    return false;
+  }
+
+  std::vector<std::string> arguments{"ld.lld"};
+  for (auto &word : *linkLine) {
+    if (word == inputsMarker) {
+      arguments.insert(arguments.end(), inputs.begin(), inputs.end());
+    } else if (word == outputMarker) {
+      arguments.push_back(output.string());
+    } else {
+      arguments.push_back(std::move(word));
+    }
+  }
+  std::vector<const char *> argv;
+  argv.reserve(arguments.size());
+  for (const auto &argument : arguments) {
+    argv.push_back(argument.c_str());
+  }
+
+  const auto result = lld::lldMain(argv, llvm::outs(), llvm::errs(),
+                                   {{lld::Gnu, &lld::elf::link}});
+  if (result.retCode != 0) {
+    error = "ld.lld failed with exit code " + std::to_string(result.retCode);
+    return false;
+  }
+  return true;
+#else
+  (void)cc;
+  (void)inputs;
+  (void)output;
+  (void)nostdlib;
+  (void)cacheDir;
+  error = "zapc was built without LLD";
+  return false;
+#endif
+}
+
+} // namespace zap::linker
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace zap::linker {
+
+/// @brief Whether zapc was built with LLD and can link in process.
+bool lldAvailable();
+
+/// @brief Links the executable @p output with LLD inside the compiler.
+///
+/// The crt objects, library directories, libc and dynamic linker are those
+/// the system C compiler @p cc would use; they come from `cc -###` and, when
+/// @p cacheDir is not empty, are kept there until @p cc changes, so repeated
+/// builds do not start any process at all. @p inputs are objects and
+/// `-l`/`-L` options, in the order the C compiler would receive them.
+bool linkWithLld(const std::filesystem::path &cc,
+                 const std::vector<std::string> &inputs,
+                 const std::filesystem::path &output, bool nostdlib,
+                 const std::filesystem::path &cacheDir, std::string &error);
+
+} // namespace zap::linker
@@ -8,6 +8,7 @@
 #else
 #include <spawn.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 extern char **environ;
 #endif
@@ -25,6 +26,28 @@ std::vector<char *> makeArgv(std::vector<std::string> &storage) {
   return argv;
 }
 
+#ifndef _WIN32
+Result waitFor(pid_t child) {
+  int status = 0;
+  while (waitpid(child, &status, 0) == -1) {
+    if (errno == EINTR) {
+      continue;
+    }
+    return {Termination::LaunchFailed, 0,
+            std::error_code(errno, std::generic_category())};
+  }
+
+  if (WIFEXITED(status)) {
+    return {Termination::Exited, WEXITSTATUS(status), {}};
+  }
+  if (WIFSIGNALED(status)) {
+    return {Termination::Signaled, WTERMSIG(status), {}};
+  }
+  return {Termination::LaunchFailed, 0,
+          std::make_error_code(std::errc::state_not_recoverable)};
+}
+#endif
+
 } // namespace
 
 Result execute(const std::filesystem::path &executable,
@@ -52,24 +75,59 @@ Result execute(const std::filesystem::path &executable,
     return {Termination::LaunchFailed, 0,
             std::error_code(spawnError, std::generic_category())};
   }
+  return waitFor(child);
+#endif
+}
 
-  int status = 0;
-  while (waitpid(child, &status, 0) == -1) {
-    if (errno == EINTR) {
-      continue;
-    }
+Result capture(const std::filesystem::path &executable,
+               const std::vector<std::string> &arguments, std::string &output) {
+#ifdef _WIN32
+  (void)executable;
+  (void)arguments;
+  (void)output;
+  return {Termination::LaunchFailed, 0,
+          std::make_error_code(std::errc::not_supported)};
+#else
+  std::vector<std::string> argvStorage;
+  argvStorage.reserve(arguments.size() + 1);
+  argvStorage.push_back(executable.string());
+  argvStorage.insert(argvStorage.end(), arguments.begin(), arguments.end());
+  auto argv = makeArgv(argvStorage);
+
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0) {
     return {Termination::LaunchFailed, 0,
             std::error_code(errno, std::generic_category())};
   }
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+  posix_spawn_file_actions_addclose(&actions, pipeFds[1]);
 
-  if (WIFEXITED(status)) {
-    return {Termination::Exited, WEXITSTATUS(status), {}};
+  pid_t child = 0;
+  const int spawnError = posix_spawn(&child, argvStorage.front().c_str(),
+                                     &actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(pipeFds[1]);
+  if (spawnError != 0) {
+    close(pipeFds[0]);
+    return {Termination::LaunchFailed, 0,
+            std::error_code(spawnError, std::generic_category())};
   }
-  if (WIFSIGNALED(status)) {
-    return {Termination::Signaled, WTERMSIG(status), {}};
+
+  char buffer[4096];
+  for (;;) {
+    const auto count = read(pipeFds[0], buffer, sizeof(buffer));
+    if (count > 0) {
+      output.append(buffer, static_cast<size_t>(count));
+    } else if (count == 0 || errno != EINTR) {
+      break;
+    }
   }
-  return {Termination::LaunchFailed, 0,
-          std::make_error_code(std::errc::state_not_recoverable)};
+  close(pipeFds[0]);
+  return waitFor(child);
 #endif
 }
 
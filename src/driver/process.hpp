@@ -22,4 +22,9 @@ struct Result {
 Result execute(const std::filesystem::path &executable,
                const std::vector<std::string> &arguments);
 
+/// @brief Like execute(), but collects everything the child writes to its
+/// standard output and standard error in @p output.
+Result capture(const std::filesystem::path &executable,
+               const std::vector<std::string> &arguments, std::string &output);
+
 } // namespace zap::process
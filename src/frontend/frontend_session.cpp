@@ -5,19 +5,29 @@
 #include "parser/parser.hpp"
 #include "sema/binder.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
 namespace zap::frontend {
 
 FrontendSession::FrontendSession(FrontendSessionConfig config,
                                  SourceLoader sourceLoader)
-    : config_(std::move(config)), sourceLoader_(std::move(sourceLoader)) {}
+    : config_(std::move(config)), sourceLoader_(std::move(sourceLoader)) {
+  if (!config_.cacheDir.empty()) {
+    moduleCache_.emplace(config_.cacheDir, config_.compilerIdentity,
+                         config_.targetInfo.pointerBitWidth);
+  }
+}
 
 FrontendProject FrontendSession::load(const std::filesystem::path &entryPath) {
   FrontendProject project;
   const auto canonicalEntry = std::filesystem::weakly_canonical(entryPath);
   project.entryModuleId = canonicalEntry.string();
+  auto parsed = parseModules(canonicalEntry, project.entryModuleId);
   std::unordered_map<std::string, bool> visiting;
   project.loaded = loadModule(canonicalEntry, canonicalEntry.string(), project,
-                              visiting);
+                              visiting, parsed);
   auto entry = project.modules.find(canonicalEntry.string());
   if (entry != project.modules.end()) {
     entry->second->isEntry = true;
@@ -25,40 +35,112 @@ FrontendProject FrontendSession::load(const std::filesystem::path &entryPath) {
   return project;
 }
 
-bool FrontendSession::loadModule(
-    const std::filesystem::path &modulePath, const std::string &entryModuleId,
-    FrontendProject &project, std::unordered_map<std::string, bool> &visiting) {
-  const auto canonicalPath = std::filesystem::weakly_canonical(modulePath);
-  const auto moduleId = canonicalPath.string();
-  project.visitedModuleIds.insert(moduleId);
-  if (project.modules.count(moduleId) != 0) {
-    return true;
+// Parses every module reachable from the entry. Workers take modules off a
+// shared queue and push the imports they find; the calling thread works too,
+// so one job parses everything in place.
+FrontendSession::ParsedModules
+FrontendSession::parseModules(const std::filesystem::path &canonicalEntry,
+                              const std::string &entryModuleId) {
+  ParsedModules parsed;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::filesystem::path> pending{canonicalEntry};
+  std::unordered_set<std::string> queued{canonicalEntry.string()};
+  size_t active = 0;
+
+  auto work = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [&] { return !pending.empty() || active == 0; });
+      if (pending.empty()) {
+        return;
+      }
+      auto path = std::move(pending.front());
+      pending.pop_front();
+      ++active;
+      lock.unlock();
+
+      ParsedModule module;
+      std::vector<std::filesystem::path> imports;
+      try {
+        module = parseModule(path, entryModuleId);
+        if (module.module) {
+          for (const auto &import : module.module->imports) {
+            for (const auto &target : import.targetModuleIds) {
+              imports.push_back(std::filesystem::weakly_canonical(target));
+            }
+          }
+        }
+      } catch (...) {
+        module.failure = std::current_exception();
+      }
+
+      lock.lock();
+      for (auto &import : imports) {
+        if (queued.insert(import.string()).second) {
+          pending.push_back(std::move(import));
+        }
+      }
+      parsed[path.string()] = std::move(module);
+      --active;
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> helpers;
+  for (unsigned i = 1; i < config_.jobs; ++i) {
+    helpers.emplace_back(work);
   }
-  if (visiting[moduleId]) {
-    project.errors.push_back("cyclic import detected involving " + moduleId);
-    return false;
+  work();
+  for (auto &helper : helpers) {
+    helper.join();
   }
+  return parsed;
+}
 
-  auto source = sourceLoader_(canonicalPath);
+FrontendSession::ParsedModule
+FrontendSession::parseModule(const std::filesystem::path &canonicalPath,
+                             const std::string &entryModuleId) {
+  ParsedModule parsed;
+  const auto moduleId = canonicalPath.string();
+  std::optional<std::string> source;
+  {
+    // Loaders (the LSP's open documents, for one) need not be thread-safe.
+    std::lock_guard<std::mutex> lock(sourceLoaderMutex_);
+    source = sourceLoader_(canonicalPath);
+  }
   if (!source) {
-    project.errors.push_back("couldn't open source file: " + moduleId);
-    return false;
+    return parsed;
   }
+  parsed.opened = true;
 
-  visiting[moduleId] = true;
+  // Each module gets an arena of its own: modules are parsed on several
+  // threads and an arena is only allocated from by one.
+  auto arena = Arena::create();
+  ArenaScope arenaScope(arena.get());
+  const size_t nodesBefore = Node::createdOnThisThread();
   DiagnosticEngine diagnostics(*source, moduleId);
-  Lexer lexer(diagnostics);
-  Parser parser(lexer.tokenize(*source), diagnostics);
-  auto root = parser.parse();
+  std::unique_ptr<RootNode> root;
+  if (moduleCache_) {
+    root = moduleCache_->load(*source, moduleId);
+    parsed.fromCache = root != nullptr;
+  }
+  if (!root) {
+    Lexer lexer(diagnostics);
+    auto tokens = lexer.tokenize(*source);
+    parsed.tokenCount = tokens.size();
+    Parser parser(std::move(tokens), diagnostics);
+    root = parser.parse();
+    // Cached trees carry no diagnostics, so only clean parses are stored.
+    if (moduleCache_ && root && diagnostics.diagnostics().empty()) {
+      moduleCache_->store(*source, moduleId, *root);
+    }
+  }
   const bool isEntry = moduleId == entryModuleId;
   if (!root ||
       (diagnostics.hadErrors() && !(config_.allowEntryErrors && isEntry))) {
-    const auto &moduleDiagnostics = diagnostics.diagnostics();
-    project.diagnostics.insert(project.diagnostics.end(),
-                               moduleDiagnostics.begin(),
-                               moduleDiagnostics.end());
-    visiting.erase(moduleId);
-    return false;
+    parsed.diagnostics = diagnostics.diagnostics();
+    return parsed;
   }
 
   auto module = std::make_unique<sema::ModuleInfo>();
@@ -68,10 +150,11 @@ bool FrontendSession::loadModule(
       computeLogicalModulePath(canonicalPath, config_.runtimePaths, config_.importMap);
   module->sourceName = moduleId;
   module->sourceText = std::move(*source);
+  module->arena = std::move(arena);
   module->root = std::move(root);
   injectImplicitPreludeImportIfNeeded(*module, config_.includePrelude);
+  parsed.nodeCount = Node::createdOnThisThread() - nodesBefore;
 
-  bool complete = true;
   for (const auto &child : module->root->children) {
     auto *importNode = dynamic_cast<ImportNode *>(child.get());
     if (!importNode) {
@@ -83,26 +166,72 @@ bool FrontendSession::loadModule(
                               config_.importMap, config_.runtimePaths,
                               &error)) {
       diagnostics.report(importNode->span, DiagnosticLevel::Error, error);
-      complete = false;
+      parsed.importsResolved = false;
       continue;
     }
     module->imports.push_back(makeResolvedImport(*importNode, targets));
   }
 
-  for (const auto &import : module->imports) {
+  parsed.diagnostics = diagnostics.diagnostics();
+  parsed.module = std::move(module);
+  return parsed;
+}
+
+bool FrontendSession::loadModule(
+    const std::filesystem::path &modulePath, const std::string &entryModuleId,
+    FrontendProject &project, std::unordered_map<std::string, bool> &visiting,
+    ParsedModules &parsed) {
+  const auto canonicalPath = std::filesystem::weakly_canonical(modulePath);
+  const auto moduleId = canonicalPath.string();
+  project.visitedModuleIds.insert(moduleId);
+  if (project.modules.count(moduleId) != 0) {
+    return true;
+  }
+  if (visiting[moduleId]) {
+    project.errors.push_back("cyclic import detected involving " + moduleId);
+    return false;
+  }
+
+  auto parsedIt = parsed.find(moduleId);
+  if (parsedIt == parsed.end()) {
+    parsedIt =
+        parsed.emplace(moduleId, parseModule(canonicalPath, entryModuleId))
+            .first;
+  }
+  auto &parsedModule = parsedIt->second;
+  if (parsedModule.failure) {
+    std::rethrow_exception(parsedModule.failure);
+  }
+  if (!parsedModule.opened) {
+    project.errors.push_back("couldn't open source file: " + moduleId);
+    return false;
+  }
+  // A module that failed to parse reports its diagnostics on every import.
+  if (!parsedModule.module) {
+    project.diagnostics.insert(project.diagnostics.end(),
+                               parsedModule.diagnostics.begin(),
+                               parsedModule.diagnostics.end());
+    return false;
+  }
+
+  visiting[moduleId] = true;
+  bool complete = parsedModule.importsResolved;
+  for (const auto &import : parsedModule.module->imports) {
     for (const auto &target : import.targetModuleIds) {
-      if (!loadModule(target, entryModuleId, project, visiting)) {
+      if (!loadModule(target, entryModuleId, project, visiting, parsed)) {
         complete = false;
       }
     }
   }
 
-  const auto &moduleDiagnostics = diagnostics.diagnostics();
   project.diagnostics.insert(project.diagnostics.end(),
-                             moduleDiagnostics.begin(),
-                             moduleDiagnostics.end());
+                             parsedModule.diagnostics.begin(),
+                             parsedModule.diagnostics.end());
   visiting.erase(moduleId);
-  project.modules[moduleId] = std::move(module);
+  project.tokenCount += parsedModule.tokenCount;
+  project.nodeCount += parsedModule.nodeCount;
+  project.cachedModules += parsedModule.fromCache ? 1 : 0;
+  project.modules[moduleId] = std::move(parsedModule.module);
   return complete;
 }
 
@@ -124,9 +253,14 @@ bool FrontendSession::bind(FrontendProject &project) {
     modules.push_back(module.get());
   }
 
+  project.boundArena = Arena::create();
+  ArenaScope arenaScope(project.boundArena.get());
   sema::Binder binder(diagnostics, true, &project.semanticInfo,
                       config_.targetInfo);
   project.boundRoot = binder.bind(std::move(modules));
+  project.genericInstantiationHits = binder.genericInstantiationStats().hits;
+  project.genericInstantiationMisses =
+      binder.genericInstantiationStats().misses;
   const auto &bindingDiagnostics = diagnostics.diagnostics();
   project.diagnostics.insert(project.diagnostics.end(), bindingDiagnostics.begin(),
                              bindingDiagnostics.end());
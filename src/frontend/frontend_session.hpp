@@ -1,15 +1,19 @@
 #pragma once
 
+#include "frontend/module_cache.hpp"
 #include "frontend/module_loader.hpp"
 #include "sema/bound_nodes.hpp"
 #include "sema/module_info.hpp"
 #include "sema/semantic_info.hpp"
 #include "sema/target_info.hpp"
+#include "utils/arena.hpp"
 #include "utils/diagnostics.hpp"
+#include <exception>
 #include <filesystem>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -24,6 +28,9 @@ struct FrontendSessionConfig {
   bool includePrelude = true;
   bool allowEntryErrors = false;
   sema::TargetInfo targetInfo{};
+  unsigned jobs = 1; ///< Threads used to read, lex and parse modules.
+  std::filesystem::path cacheDir{}; ///< Parsed module cache; empty disables it.
+  std::string compilerIdentity{};   ///< See moduleCacheIdentity().
 };
 
 struct FrontendProject {
@@ -33,8 +40,14 @@ struct FrontendProject {
   std::vector<Diagnostic> diagnostics;
   std::vector<std::string> errors;
   sema::SemanticInfo semanticInfo;
+  ArenaRef boundArena; ///< Where the nodes of 'boundRoot' were allocated.
   std::unique_ptr<sema::BoundRootNode> boundRoot;
   bool loaded = false;
+  size_t tokenCount = 0;    ///< Tokens lexed; cached modules add none.
+  size_t nodeCount = 0;     ///< AST nodes parsed or loaded from the cache.
+  size_t cachedModules = 0; ///< Modules loaded from the module cache.
+  size_t genericInstantiationHits = 0;   ///< Instantiations bind() reused.
+  size_t genericInstantiationMisses = 0; ///< Instantiations bind() built.
 };
 
 using SourceLoader = std::function<std::optional<std::string>(
@@ -48,12 +61,35 @@ public:
   bool bind(FrontendProject &project);
 
 private:
+  // One module read, lexed and parsed, with its imports resolved but not
+  // yet loaded. Modules are parsed in parallel and then loaded in import
+  // order, so projects and their diagnostics come out the same for any
+  // number of jobs.
+  struct ParsedModule {
+    bool opened = false;
+    std::unique_ptr<sema::ModuleInfo> module; ///< Null if parsing failed.
+    std::vector<Diagnostic> diagnostics;
+    bool importsResolved = true;
+    bool fromCache = false;
+    size_t tokenCount = 0;
+    size_t nodeCount = 0;
+    std::exception_ptr failure;
+  };
+  using ParsedModules = std::unordered_map<std::string, ParsedModule>;
+
   FrontendSessionConfig config_;
   SourceLoader sourceLoader_;
+  std::mutex sourceLoaderMutex_;
+  std::optional<ModuleCache> moduleCache_;
 
+  ParsedModules parseModules(const std::filesystem::path &canonicalEntry,
+                             const std::string &entryModuleId);
+  ParsedModule parseModule(const std::filesystem::path &canonicalPath,
+                           const std::string &entryModuleId);
   bool loadModule(const std::filesystem::path &modulePath,
                   const std::string &entryModuleId, FrontendProject &project,
-                  std::unordered_map<std::string, bool> &visiting);
+                  std::unordered_map<std::string, bool> &visiting,
+                  ParsedModules &parsed);
 };
 
 } // namespace zap::frontend
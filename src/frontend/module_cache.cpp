@@ -0,0 +1,1179 @@
+#include "frontend/module_cache.hpp"
+
+#include "ast/const/const_char.hpp"
+#include "ast/nodes.hpp"
+#include "frontend/module_loader.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace zap::frontend {
+namespace {
+
+// Bump whenever the entry layout or the syntax tree changes shape.
+constexpr uint8_t formatVersion = 1;
+constexpr char magic[3] = {'Z', 'M', 'I'};
+
+enum class Tag : uint8_t {
+  Null,
+  Root,
+  FunDecl,
+  ExtDecl,
+  Body,
+  UnsafeBlock,
+  Binding,
+  Return,
+  If,
+  IfType,
+  While,
+  For,
+  ForIn,
+  Break,
+  Continue,
+  MemberAccess,
+  Enum,
+  Record,
+  TypeAlias,
+  Struct,
+  StructLiteral,
+  Class,
+  Import,
+  Parameter,
+  Type,
+  IndexAccess,
+  Asm,
+  Try,
+  Fallback,
+  FailableHandle,
+  Fail,
+  Bin,
+  Ternary,
+  Unary,
+  Cast,
+  Call,
+  ArrayLiteral,
+  Assign,
+  New,
+  Int,
+  Float,
+  String,
+  Char,
+  Bool,
+  Id,
+  NullLiteral,
+};
+
+uint64_t fnv1a(uint64_t hash, const void *data, size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Serializes a syntax tree. Integers are LEB128 varints, which keeps spans
+// (four numbers on every node) small.
+class TreeWriter : public Visitor {
+public:
+  TreeWriter(std::string &out, const std::string &sourceName)
+      : out_(out), sourceId_(internSource(sourceName)) {}
+
+  bool failed() const { return failed_; }
+
+  void node(const Node *node) {
+    if (!node) {
+      tag(Tag::Null);
+      return;
+    }
+    const_cast<Node *>(node)->accept(*this);
+  }
+
+  void visit(Node &) override { failed_ = true; }
+  void visit(TopLevel &) override { failed_ = true; }
+  void visit(StatementNode &) override { failed_ = true; }
+  void visit(ExpressionNode &) override { failed_ = true; }
+
+  void visit(RootNode &node) override {
+    header(Tag::Root, node);
+    nodes(node.children);
+  }
+
+  void visit(FunDecl &node) override {
+    header(Tag::FunDecl, node);
+    topLevel(node);
+    str(node.name_);
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    nodes(node.params_);
+    this->node(node.returnType_.get());
+    this->node(node.body_.get());
+    this->node(node.lambdaExpr_.get());
+    optionalStr(node.resultBorrowSource_);
+    flags({node.isExtern_, node.isStatic_, node.isUnsafe_, node.returnsRef_});
+  }
+
+  void visit(ExtDecl &node) override {
+    header(Tag::ExtDecl, node);
+    topLevel(node);
+    str(node.name_);
+    nodes(node.params_);
+    this->node(node.returnType_.get());
+    optionalStr(node.resultBorrowSource_);
+    flags({node.isCVariadic_});
+  }
+
+  void visit(BodyNode &node) override {
+    header(Tag::Body, node);
+    body(node);
+  }
+
+  void visit(UnsafeBlockNode &node) override {
+    header(Tag::UnsafeBlock, node);
+    body(node);
+  }
+
+  void visit(BindingDecl &node) override {
+    header(Tag::Binding, node);
+    topLevel(node);
+    str(node.name_);
+    this->node(node.type_.get());
+    this->node(node.initializer_.get());
+    number(static_cast<uint64_t>(node.kind_));
+    flags({node.isGlobal_, node.isExternal_});
+  }
+
+  void visit(ReturnNode &node) override {
+    header(Tag::Return, node);
+    this->node(node.returnValue.get());
+  }
+
+  void visit(IfNode &node) override {
+    header(Tag::If, node);
+    this->node(node.condition_.get());
+    this->node(node.thenBody_.get());
+    this->node(node.elseBody_.get());
+  }
+
+  void visit(IfTypeNode &node) override {
+    header(Tag::IfType, node);
+    str(node.parameterName_);
+    this->node(node.matchType_.get());
+    this->node(node.thenBody_.get());
+    this->node(node.elseBody_.get());
+  }
+
+  void visit(WhileNode &node) override {
+    header(Tag::While, node);
+    this->node(node.condition_.get());
+    this->node(node.body_.get());
+  }
+
+  void visit(ForNode &node) override {
+    header(Tag::For, node);
+    this->node(node.initializer_.get());
+    this->node(node.condition_.get());
+    this->node(node.increment_.get());
+    this->node(node.body_.get());
+  }
+
+  void visit(ForInNode &node) override {
+    header(Tag::ForIn, node);
+    str(node.indexName_);
+    str(node.itemName_);
+    this->node(node.iterable_.get());
+    this->node(node.body_.get());
+  }
+
+  void visit(BreakNode &node) override { header(Tag::Break, node); }
+  void visit(ContinueNode &node) override { header(Tag::Continue, node); }
+
+  void visit(MemberAccessNode &node) override {
+    header(Tag::MemberAccess, node);
+    this->node(node.left_.get());
+    str(node.member_);
+  }
+
+  void visit(EnumDecl &node) override {
+    header(Tag::Enum, node);
+    topLevel(node);
+    str(node.name_);
+    number(node.entries_.size());
+    for (const auto &entry : node.entries_) {
+      str(entry.name_);
+      flags({entry.hasExplicitValue_});
+      number(static_cast<uint64_t>(entry.value_));
+      this->node(entry.payloadType_.get());
+    }
+  }
+
+  void visit(RecordDecl &node) override {
+    header(Tag::Record, node);
+    topLevel(node);
+    str(node.name_);
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    nodes(node.fields_);
+  }
+
+  void visit(TypeAliasDecl &node) override {
+    header(Tag::TypeAlias, node);
+    topLevel(node);
+    str(node.name_);
+    this->node(node.type_.get());
+  }
+
+  void visit(StructDeclarationNode &node) override {
+    header(Tag::Struct, node);
+    topLevel(node);
+    str(node.name_);
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    nodes(node.fields_);
+    flags({node.isUnsafe_});
+  }
+
+  void visit(StructLiteralNode &node) override {
+    header(Tag::StructLiteral, node);
+    this->node(node.type_.get());
+    number(node.fields_.size());
+    for (const auto &field : node.fields_) {
+      str(field.name);
+      this->node(field.value.get());
+    }
+  }
+
+  void visit(ClassDecl &node) override {
+    header(Tag::Class, node);
+    topLevel(node);
+    str(node.name_);
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    this->node(node.baseType_.get());
+    nodes(node.fields_);
+    nodes(node.methods_);
+  }
+
+  void visit(ImportNode &node) override {
+    header(Tag::Import, node);
+    topLevel(node);
+    str(node.path);
+    str(node.moduleAlias);
+    number(node.bindings.size());
+    for (const auto &binding : node.bindings) {
+      str(binding.sourceName);
+      str(binding.localName);
+    }
+  }
+
+  void visit(ParameterNode &node) override {
+    header(Tag::Parameter, node);
+    str(node.name);
+    this->node(node.type.get());
+    this->node(node.defaultValue.get());
+    flags({node.isRef, node.isSink, node.isNoEscape, node.isVariadic});
+    number(static_cast<uint64_t>(node.visibility_));
+  }
+
+  void visit(TypeNode &node) override {
+    header(Tag::Type, node);
+    str(node.typeName);
+    number(node.qualifiers.size());
+    for (const auto &qualifier : node.qualifiers) {
+      str(qualifier);
+    }
+    nodes(node.genericArgs);
+    this->node(node.defaultType.get());
+    flags({node.isReference, node.isPointer, node.isArray, node.isVarArgs,
+           node.isWeak, node.isFailable, node.isFunPtr,
+           node.funPtrReturnsRef});
+    nodes(node.funPtrParams);
+    bits(node.funPtrParamSinks);
+    bits(node.funPtrParamNoEscapes);
+    this->node(node.funPtrReturn.get());
+    optionalStr(node.funPtrResultBorrowSource);
+    this->node(node.errorType.get());
+    this->node(node.arraySize.get());
+    this->node(node.baseType.get());
+  }
+
+  void visit(IndexAccessNode &node) override {
+    header(Tag::IndexAccess, node);
+    this->node(node.left_.get());
+    this->node(node.index_.get());
+  }
+
+  void visit(AsmStmtNode &node) override {
+    header(Tag::Asm, node);
+    str(node.assembly);
+    asmOperands(node.outputs);
+    asmOperands(node.inputs);
+    number(node.clobbers.size());
+    for (const auto &clobber : node.clobbers) {
+      str(clobber);
+    }
+  }
+
+  void visit(TryExpr &node) override {
+    header(Tag::Try, node);
+    this->node(node.expression_.get());
+  }
+
+  void visit(FallbackExpr &node) override {
+    header(Tag::Fallback, node);
+    this->node(node.expression_.get());
+    this->node(node.fallback_.get());
+  }
+
+  void visit(FailableHandleExpr &node) override {
+    header(Tag::FailableHandle, node);
+    this->node(node.expression_.get());
+    str(node.errorName_);
+    this->node(node.handler_.get());
+  }
+
+  void visit(FailNode &node) override {
+    header(Tag::Fail, node);
+    this->node(node.errorValue_.get());
+  }
+
+  void visit(BinExpr &node) override {
+    header(Tag::Bin, node);
+    this->node(node.left_.get());
+    str(node.op_);
+    this->node(node.right_.get());
+  }
+
+  void visit(TernaryExpr &node) override {
+    header(Tag::Ternary, node);
+    this->node(node.condition_.get());
+    this->node(node.thenExpr_.get());
+    this->node(node.elseExpr_.get());
+  }
+
+  void visit(UnaryExpr &node) override {
+    header(Tag::Unary, node);
+    str(node.op_);
+    this->node(node.expr_.get());
+  }
+
+  void visit(CastExpr &node) override {
+    header(Tag::Cast, node);
+    this->node(node.expr_.get());
+    this->node(node.type_.get());
+  }
+
+  void visit(FunCall &node) override {
+    header(Tag::Call, node);
+    this->node(node.callee_.get());
+    nodes(node.genericArgs_);
+    arguments(node.params_);
+  }
+
+  void visit(ArrayLiteralNode &node) override {
+    header(Tag::ArrayLiteral, node);
+    nodes(node.elements_);
+  }
+
+  void visit(AssignNode &node) override {
+    header(Tag::Assign, node);
+    this->node(node.target_.get());
+    this->node(node.expr_.get());
+    str(node.op_);
+  }
+
+  void visit(NewExpr &node) override {
+    header(Tag::New, node);
+    this->node(node.type_.get());
+    arguments(node.args_);
+  }
+
+  void visit(ConstInt &node) override {
+    header(Tag::Int, node);
+    str(node.value_);
+    number(static_cast<uint64_t>(node.value_i64_));
+    flags({node.has_value_i64_});
+    str(node.typeName_);
+  }
+
+  void visit(ConstFloat &node) override {
+    header(Tag::Float, node);
+    uint64_t bits;
+    std::memcpy(&bits, &node.value_, sizeof(bits));
+    number(bits);
+  }
+
+  void visit(ConstString &node) override {
+    header(Tag::String, node);
+    str(node.value_);
+  }
+
+  void visit(ConstChar &node) override {
+    header(Tag::Char, node);
+    str(node.value_);
+  }
+
+  void visit(ConstBool &node) override {
+    header(Tag::Bool, node);
+    flags({node.value_});
+  }
+
+  void visit(ConstId &node) override {
+    header(Tag::Id, node);
+    str(node.value_);
+  }
+
+  void visit(ConstNull &node) override { header(Tag::NullLiteral, node); }
+
+private:
+  std::string &out_;
+  SourceId sourceId_;
+  bool failed_ = false;
+
+  void tag(Tag tag) { out_.push_back(static_cast<char>(tag)); }
+
+  void number(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  void str(const std::string &value) {
+    number(value.size());
+    out_.append(value);
+  }
+
+  void optionalStr(const std::optional<std::string> &value) {
+    flags({value.has_value()});
+    if (value) {
+      str(*value);
+    }
+  }
+
+  void flags(std::initializer_list<bool> values) {
+    uint64_t packed = 0;
+    unsigned bit = 0;
+    for (bool value : values) {
+      packed |= static_cast<uint64_t>(value) << bit++;
+    }
+    number(packed);
+  }
+
+  void bits(const std::vector<bool> &values) {
+    number(values.size());
+    for (bool value : values) {
+      out_.push_back(static_cast<char>(value));
+    }
+  }
+
+  // Spans nearly always point into the module itself; only the odd one
+  // (none today) names another source.
+  void span(const SourceSpan &span) {
+    number(span.line);
+    number(span.column);
+    number(span.offset);
+    number(span.length);
+    const bool own = span.source == sourceId_;
+    flags({own});
+    if (!own) {
+      str(span.sourceName());
+    }
+  }
+
+  void header(Tag kind, const Node &node) {
+    tag(kind);
+    span(node.span);
+  }
+
+  template <typename T>
+  void nodes(const std::vector<std::unique_ptr<T>> &values) {
+    number(values.size());
+    for (const auto &value : values) {
+      node(value.get());
+    }
+  }
+
+  void topLevel(const TopLevel &node) {
+    number(static_cast<uint64_t>(node.visibility_));
+    number(node.attributes_.size());
+    for (const auto &attribute : node.attributes_) {
+      str(attribute.name);
+      span(attribute.span);
+      number(attribute.arguments.size());
+      for (const auto &argument : attribute.arguments) {
+        number(static_cast<uint64_t>(argument.kind));
+        str(argument.name);
+        this->node(argument.value.get());
+      }
+    }
+  }
+
+  void constraints(const std::vector<GenericConstraint> &values) {
+    number(values.size());
+    for (const auto &constraint : values) {
+      str(constraint.parameterName);
+      node(constraint.boundType.get());
+    }
+  }
+
+  void body(const BodyNode &node) {
+    nodes(node.statements);
+    this->node(node.result.get());
+  }
+
+  void arguments(const std::vector<std::unique_ptr<Argument>> &values) {
+    number(values.size());
+    for (const auto &argument : values) {
+      str(argument->name);
+      node(argument->value.get());
+      flags({argument->isRef, argument->isSpread});
+    }
+  }
+
+  void asmOperands(const std::vector<AsmOperandNode> &values) {
+    number(values.size());
+    for (const auto &operand : values) {
+      str(operand.constraint);
+      node(operand.expr.get());
+    }
+  }
+};
+
+struct CorruptEntry : std::runtime_error {
+  CorruptEntry() : std::runtime_error("corrupt module cache entry") {}
+};
+
+// Rebuilds a syntax tree written by TreeWriter. Anything unexpected throws
+// CorruptEntry, which load() turns into a miss.
+class TreeReader {
+public:
+  TreeReader(const char *data, size_t size, const std::string &sourceName)
+      : cursor_(data), end_(data + size), sourceId_(internSource(sourceName)) {}
+
+  bool atEnd() const { return cursor_ == end_; }
+
+  uint64_t number() {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      const auto byte = static_cast<unsigned char>(byte8());
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw CorruptEntry();
+  }
+
+  std::unique_ptr<Node> node() {
+    const auto kind = static_cast<Tag>(byte8());
+    if (kind == Tag::Null) {
+      return nullptr;
+    }
+    const SourceSpan nodeSpan = span();
+    auto result = build(kind);
+    result->span = nodeSpan;
+    return result;
+  }
+
+  template <typename T> std::unique_ptr<T> nodeAs() {
+    auto generic = node();
+    if (!generic) {
+      return nullptr;
+    }
+    auto *typed = dynamic_cast<T *>(generic.get());
+    if (!typed) {
+      throw CorruptEntry();
+    }
+    generic.release();
+    return std::unique_ptr<T>(typed);
+  }
+
+private:
+  const char *cursor_;
+  const char *end_;
+  SourceId sourceId_;
+
+  char byte8() {
+    if (cursor_ == end_) {
+      throw CorruptEntry();
+    }
+    return *cursor_++;
+  }
+
+  // Element counts are bounded by the bytes left, so a damaged entry cannot
+  // make the reader allocate without limit.
+  size_t count() {
+    const auto value = number();
+    if (value > static_cast<uint64_t>(end_ - cursor_)) {
+      throw CorruptEntry();
+    }
+    return static_cast<size_t>(value);
+  }
+
+  std::string str() {
+    const auto size = number();
+    if (size > static_cast<uint64_t>(end_ - cursor_)) {
+      throw CorruptEntry();
+    }
+    std::string value(cursor_, size);
+    cursor_ += size;
+    return value;
+  }
+
+  std::optional<std::string> optionalStr() {
+    if (number() == 0) {
+      return std::nullopt;
+    }
+    return str();
+  }
+
+  bool flag(uint64_t packed, unsigned bit) { return (packed >> bit) & 1; }
+
+  std::vector<bool> bits() {
+    std::vector<bool> values(count());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = byte8() != 0;
+    }
+    return values;
+  }
+
+  SourceSpan span() {
+    SourceSpan result;
+    result.line = number();
+    result.column = number();
+    result.offset = number();
+    result.length = number();
+    result.source = number() != 0 ? sourceId_ : internSource(str());
+    return result;
+  }
+
+  template <typename T> std::vector<std::unique_ptr<T>> nodes() {
+    std::vector<std::unique_ptr<T>> values(count());
+    for (auto &value : values) {
+      value = nodeAs<T>();
+    }
+    return values;
+  }
+
+  void topLevel(TopLevel &node) {
+    node.visibility_ = static_cast<Visibility>(number());
+    node.attributes_.resize(count());
+    for (auto &attribute : node.attributes_) {
+      attribute.name = str();
+      attribute.span = span();
+      attribute.arguments.resize(count());
+      for (auto &argument : attribute.arguments) {
+        argument.kind = static_cast<AttributeArgumentKind>(number());
+        argument.name = str();
+        argument.value = nodeAs<ExpressionNode>();
+      }
+    }
+  }
+
+  std::vector<GenericConstraint> constraints() {
+    std::vector<GenericConstraint> values(count());
+    for (auto &constraint : values) {
+      constraint.parameterName = str();
+      constraint.boundType = nodeAs<TypeNode>();
+    }
+    return values;
+  }
+
+  void body(BodyNode &node) {
+    node.statements = nodes<Node>();
+    node.result = nodeAs<ExpressionNode>();
+  }
+
+  std::vector<std::unique_ptr<Argument>> arguments() {
+    std::vector<std::unique_ptr<Argument>> values(count());
+    for (auto &value : values) {
+      auto name = str();
+      auto argument = nodeAs<ExpressionNode>();
+      const auto packed = number();
+      value = std::make_unique<Argument>(name, std::move(argument),
+                                         flag(packed, 0), flag(packed, 1));
+    }
+    return values;
+  }
+
+  std::vector<AsmOperandNode> asmOperands() {
+    std::vector<AsmOperandNode> values(count());
+    for (auto &operand : values) {
+      operand.constraint = str();
+      operand.expr = nodeAs<ExpressionNode>();
+    }
+    return values;
+  }
+
+  std::unique_ptr<Node> build(Tag kind) {
+    switch (kind) {
+    case Tag::Null:
+      break;
+    case Tag::Root: {
+      auto node = std::make_unique<RootNode>();
+      node->children = nodes<Node>();
+      return node;
+    }
+    case Tag::FunDecl: {
+      auto node = std::make_unique<FunDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->genericParams_ = nodes<TypeNode>();
+      node->genericConstraints_ = constraints();
+      node->params_ = nodes<ParameterNode>();
+      node->returnType_ = nodeAs<TypeNode>();
+      node->body_ = nodeAs<BodyNode>();
+      node->lambdaExpr_ = nodeAs<ExpressionNode>();
+      node->resultBorrowSource_ = optionalStr();
+      const auto packed = number();
+      node->isExtern_ = flag(packed, 0);
+      node->isStatic_ = flag(packed, 1);
+      node->isUnsafe_ = flag(packed, 2);
+      node->returnsRef_ = flag(packed, 3);
+      return node;
+    }
+    case Tag::ExtDecl: {
+      auto node = std::make_unique<ExtDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->params_ = nodes<ParameterNode>();
+      node->returnType_ = nodeAs<TypeNode>();
+      node->resultBorrowSource_ = optionalStr();
+      node->isCVariadic_ = flag(number(), 0);
+      return node;
+    }
+    case Tag::Body: {
+      auto node = std::make_unique<BodyNode>();
+      body(*node);
+      return node;
+    }
+    case Tag::UnsafeBlock: {
+      auto node = std::make_unique<UnsafeBlockNode>();
+      body(*node);
+      return node;
+    }
+    case Tag::Binding: {
+      auto node = std::make_unique<BindingDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->type_ = nodeAs<TypeNode>();
+      node->initializer_ = nodeAs<ExpressionNode>();
+      node->kind_ = static_cast<BindingKind>(number());
+      const auto packed = number();
+      node->isGlobal_ = flag(packed, 0);
+      node->isExternal_ = flag(packed, 1);
+      return node;
+    }
+    case Tag::Return: {
+      auto node = std::make_unique<ReturnNode>();
+      node->returnValue = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::If: {
+      auto node = std::make_unique<IfNode>();
+      node->condition_ = nodeAs<ExpressionNode>();
+      node->thenBody_ = nodeAs<BodyNode>();
+      node->elseBody_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::IfType: {
+      auto node = std::make_unique<IfTypeNode>();
+      node->parameterName_ = str();
+      node->matchType_ = nodeAs<TypeNode>();
+      node->thenBody_ = nodeAs<BodyNode>();
+      node->elseBody_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::While: {
+      auto node = std::make_unique<WhileNode>();
+      node->condition_ = nodeAs<ExpressionNode>();
+      node->body_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::For: {
+      auto node = std::make_unique<ForNode>();
+      node->initializer_ = nodeAs<BindingDecl>();
+      node->condition_ = nodeAs<ExpressionNode>();
+      node->increment_ = nodeAs<AssignNode>();
+      node->body_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::ForIn: {
+      auto node = std::make_unique<ForInNode>();
+      node->indexName_ = str();
+      node->itemName_ = str();
+      node->iterable_ = nodeAs<ExpressionNode>();
+      node->body_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::Break:
+      return std::make_unique<BreakNode>();
+    case Tag::Continue:
+      return std::make_unique<ContinueNode>();
+    case Tag::MemberAccess: {
+      auto left = nodeAs<ExpressionNode>();
+      auto member = str();
+      return std::make_unique<MemberAccessNode>(std::move(left),
+                                                std::move(member));
+    }
+    case Tag::Enum: {
+      auto node = std::make_unique<EnumDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->entries_.resize(count());
+      for (auto &entry : node->entries_) {
+        entry.name_ = str();
+        entry.hasExplicitValue_ = flag(number(), 0);
+        entry.value_ = static_cast<int64_t>(number());
+        entry.payloadType_ = nodeAs<TypeNode>();
+      }
+      return node;
+    }
+    case Tag::Record: {
+      auto node = std::make_unique<RecordDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->genericParams_ = nodes<TypeNode>();
+      node->genericConstraints_ = constraints();
+      node->fields_ = nodes<ParameterNode>();
+      return node;
+    }
+    case Tag::TypeAlias: {
+      auto node = std::make_unique<TypeAliasDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->type_ = nodeAs<TypeNode>();
+      return node;
+    }
+    case Tag::Struct: {
+      auto node = std::make_unique<StructDeclarationNode>();
+      topLevel(*node);
+      node->name_ = str();
+      node->genericParams_ = nodes<TypeNode>();
+      node->genericConstraints_ = constraints();
+      node->fields_ = nodes<ParameterNode>();
+      node->isUnsafe_ = flag(number(), 0);
+      return node;
+    }
+    case Tag::StructLiteral: {
+      auto type = nodeAs<TypeNode>();
+      std::vector<StructFieldInit> fields;
+      const auto fieldCount = count();
+      fields.reserve(fieldCount);
+      for (size_t i = 0; i < fieldCount; ++i) {
+        auto name = str();
+        fields.emplace_back(std::move(name), nodeAs<ExpressionNode>());
+      }
+      return std::make_unique<StructLiteralNode>(std::move(type),
+                                                 std::move(fields));
+    }
+    case Tag::Class: {
+      auto node = std::make_unique<ClassDecl>();
+      topLevel(*node);
+      node->name_ = str();
+      node->genericParams_ = nodes<TypeNode>();
+      node->genericConstraints_ = constraints();
+      node->baseType_ = nodeAs<TypeNode>();
+      node->fields_ = nodes<ParameterNode>();
+      node->methods_ = nodes<FunDecl>();
+      return node;
+    }
+    case Tag::Import: {
+      auto node = std::make_unique<ImportNode>();
+      topLevel(*node);
+      node->path = str();
+      node->moduleAlias = str();
+      node->bindings.resize(count());
+      for (auto &binding : node->bindings) {
+        binding.sourceName = str();
+        binding.localName = str();
+      }
+      return node;
+    }
+    case Tag::Parameter: {
+      auto name = str();
+      auto type = nodeAs<TypeNode>();
+      auto defaultValue = nodeAs<ExpressionNode>();
+      const auto packed = number();
+      auto node = std::make_unique<ParameterNode>(
+          name, std::move(type), flag(packed, 0), flag(packed, 1),
+          flag(packed, 2), flag(packed, 3), std::move(defaultValue));
+      node->visibility_ = static_cast<Visibility>(number());
+      return node;
+    }
+    case Tag::Type: {
+      auto node = std::make_unique<TypeNode>();
+      node->typeName = str();
+      node->qualifiers.resize(count());
+      for (auto &qualifier : node->qualifiers) {
+        qualifier = str();
+      }
+      node->genericArgs = nodes<TypeNode>();
+      node->defaultType = nodeAs<TypeNode>();
+      const auto packed = number();
+      node->isReference = flag(packed, 0);
+      node->isPointer = flag(packed, 1);
+      node->isArray = flag(packed, 2);
+      node->isVarArgs = flag(packed, 3);
+      node->isWeak = flag(packed, 4);
+      node->isFailable = flag(packed, 5);
+      node->isFunPtr = flag(packed, 6);
+      node->funPtrReturnsRef = flag(packed, 7);
+      node->funPtrParams = nodes<TypeNode>();
+      node->funPtrParamSinks = bits();
+      node->funPtrParamNoEscapes = bits();
+      node->funPtrReturn = nodeAs<TypeNode>();
+      node->funPtrResultBorrowSource = optionalStr();
+      node->errorType = nodeAs<TypeNode>();
+      node->arraySize = nodeAs<ExpressionNode>();
+      node->baseType = nodeAs<TypeNode>();
+      return node;
+    }
+    case Tag::IndexAccess: {
+      auto left = nodeAs<ExpressionNode>();
+      auto index = nodeAs<ExpressionNode>();
+      return std::make_unique<IndexAccessNode>(std::move(left),
+                                               std::move(index));
+    }
+    case Tag::Asm: {
+      auto node = std::make_unique<AsmStmtNode>();
+      node->assembly = str();
+      node->outputs = asmOperands();
+      node->inputs = asmOperands();
+      node->clobbers.resize(count());
+      for (auto &clobber : node->clobbers) {
+        clobber = str();
+      }
+      return node;
+    }
+    case Tag::Try: {
+      auto node = std::make_unique<TryExpr>();
+      node->expression_ = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::Fallback: {
+      auto node = std::make_unique<FallbackExpr>();
+      node->expression_ = nodeAs<ExpressionNode>();
+      node->fallback_ = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::FailableHandle: {
+      auto node = std::make_unique<FailableHandleExpr>();
+      node->expression_ = nodeAs<ExpressionNode>();
+      node->errorName_ = str();
+      node->handler_ = nodeAs<BodyNode>();
+      return node;
+    }
+    case Tag::Fail: {
+      auto node = std::make_unique<FailNode>();
+      node->errorValue_ = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::Bin: {
+      auto node = std::make_unique<BinExpr>();
+      node->left_ = nodeAs<ExpressionNode>();
+      node->op_ = str();
+      node->right_ = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::Ternary: {
+      auto condition = nodeAs<ExpressionNode>();
+      auto thenExpr = nodeAs<ExpressionNode>();
+      auto elseExpr = nodeAs<ExpressionNode>();
+      return std::make_unique<TernaryExpr>(
+          std::move(condition), std::move(thenExpr), std::move(elseExpr));
+    }
+    case Tag::Unary: {
+      auto node = std::make_unique<UnaryExpr>();
+      node->op_ = str();
+      node->expr_ = nodeAs<ExpressionNode>();
+      return node;
+    }
+    case Tag::Cast: {
+      auto expr = nodeAs<ExpressionNode>();
+      auto type = nodeAs<TypeNode>();
+      return std::make_unique<CastExpr>(std::move(expr), std::move(type));
+    }
+    case Tag::Call: {
+      auto node = std::make_unique<FunCall>();
+      node->callee_ = nodeAs<ExpressionNode>();
+      node->genericArgs_ = nodes<TypeNode>();
+      node->params_ = arguments();
+      return node;
+    }
+    case Tag::ArrayLiteral: {
+      auto node = std::make_unique<ArrayLiteralNode>();
+      node->elements_ = nodes<ExpressionNode>();
+      return node;
+    }
+    case Tag::Assign: {
+      auto node = std::make_unique<AssignNode>();
+      node->target_ = nodeAs<ExpressionNode>();
+      node->expr_ = nodeAs<ExpressionNode>();
+      node->op_ = str();
+      return node;
+    }
+    case Tag::New: {
+      auto node = std::make_unique<NewExpr>(nodeAs<TypeNode>());
+      node->args_ = arguments();
+      return node;
+    }
+    case Tag::Int: {
+      auto node = std::make_unique<ConstInt>(str());
+      node->value_i64_ = static_cast<int64_t>(number());
+      node->has_value_i64_ = flag(number(), 0);
+      node->typeName_ = str();
+      return node;
+    }
+    case Tag::Float: {
+      const uint64_t bits = number();
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return std::make_unique<ConstFloat>(value);
+    }
+    case Tag::String:
+      return std::make_unique<ConstString>(str());
+    case Tag::Char:
+      return std::make_unique<ConstChar>(str());
+    case Tag::Bool:
+      return std::make_unique<ConstBool>(flag(number(), 0));
+    case Tag::Id:
+      return std::make_unique<ConstId>(str());
+    case Tag::NullLiteral:
+      return std::make_unique<ConstNull>();
+    }
+    throw CorruptEntry();
+  }
+};
+
+void appendFixed(std::string &out, uint64_t value) {
+  char bytes[sizeof(value)];
+  std::memcpy(bytes, &value, sizeof(value));
+  out.append(bytes, sizeof(bytes));
+}
+
+uint64_t readFixed(const char *data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// magic, format version, key, source size
+constexpr size_t entryHeaderSize = sizeof(magic) + 1 + 2 * sizeof(uint64_t);
+
+} // namespace
+
+ModuleCache::ModuleCache(std::filesystem::path directory,
+                         std::string compilerIdentity,
+                         uint16_t pointerBitWidth)
+    : directory_(std::move(directory)), seed_(14695981039346656037ull) {
+  seed_ = fnv1a(seed_, &formatVersion, sizeof(formatVersion));
+  seed_ = fnv1a(seed_, compilerIdentity.data(), compilerIdentity.size() + 1);
+  seed_ = fnv1a(seed_, &pointerBitWidth, sizeof(pointerBitWidth));
+}
+
+std::filesystem::path ModuleCache::entryPath(uint64_t key) const {
+  static constexpr char digits[] = "0123456789abcdef";
+  std::string name(16, '0');
+  for (int i = 15; i >= 0; --i, key >>= 4) {
+    name[i] = digits[key & 0xf];
+  }
+  return directory_ / (name + ".zmi");
+}
+
+uint64_t ModuleCache::keyFor(const std::string &source) const {
+  return fnv1a(seed_, source.data(), source.size());
+}
+
+std::unique_ptr<RootNode>
+ModuleCache::load(const std::string &source,
+                  const std::string &sourceName) const {
+  const auto key = keyFor(source);
+  std::ifstream file(entryPath(key), std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  const std::string entry = std::move(contents).str();
+  if (entry.size() < entryHeaderSize ||
+      std::memcmp(entry.data(), magic, sizeof(magic)) != 0 ||
+      static_cast<uint8_t>(entry[sizeof(magic)]) != formatVersion ||
+      readFixed(entry.data() + sizeof(magic) + 1) != key ||
+      readFixed(entry.data() + sizeof(magic) + 9) != source.size()) {
+    return nullptr;
+  }
+
+  try {
+    TreeReader reader(entry.data() + entryHeaderSize,
+                      entry.size() - entryHeaderSize, sourceName);
+    auto root = reader.nodeAs<RootNode>();
+    return reader.atEnd() ? std::move(root) : nullptr;
+  } catch (const CorruptEntry &) {
+    return nullptr;
+  }
+}
+
+void ModuleCache::store(const std::string &source,
+                        const std::string &sourceName,
+                        const RootNode &root) const {
+  const auto key = keyFor(source);
+  std::string entry(magic, sizeof(magic));
+  entry.push_back(static_cast<char>(formatVersion));
+  appendFixed(entry, key);
+  appendFixed(entry, source.size());
+  TreeWriter writer(entry, sourceName);
+  writer.node(&root);
+  if (writer.failed()) {
+    return;
+  }
+
+  // Write to a private file and rename it into place, so concurrent
+  // compiles never see half an entry.
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  const auto path = entryPath(key);
+  const auto nonce =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+      static_cast<size_t>(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  auto temporary = path;
+  temporary += ".tmp" + std::to_string(nonce);
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.write(entry.data(), static_cast<std::streamsize>(entry.size()))) {
+      file.close();
+      std::filesystem::remove(temporary, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(temporary, path, ec);
+  if (ec) {
+    std::filesystem::remove(temporary, ec);
+  }
+}
+
+std::string moduleCacheIdentity(const std::string &version,
+                                const std::filesystem::path &argv0Hint) {
+  std::string identity = version;
+  if (auto executable = currentExecutablePath(argv0Hint)) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(*executable, ec);
+    const auto modified = std::filesystem::last_write_time(*executable, ec);
+    if (!ec) {
+      identity += ';' + std::to_string(size) + ';' +
+                  std::to_string(modified.time_since_epoch().count());
+    }
+  }
+  return identity;
+}
+
+} // namespace zap::frontend
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ast/root_node.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace zap::frontend {
+
+/// @brief On-disk cache of parsed modules.
+///
+/// Entries live in `<directory>/<key>.zmi`, where the key hashes the module
+/// source together with the compiler identity and the target word size, so
+/// an edited file, a rebuilt compiler or another target simply misses.
+/// Only modules that parsed without any diagnostic are stored; everything
+/// else is parsed again so its diagnostics are reported as usual.
+class ModuleCache {
+public:
+  /// @param directory Directory holding the entries, created on first store.
+  /// @param compilerIdentity Anything that changes with the parser, e.g. the
+  /// compiler version and the build stamp of its executable.
+  ModuleCache(std::filesystem::path directory, std::string compilerIdentity,
+              uint16_t pointerBitWidth);
+
+  /// @brief Returns the cached syntax tree of @p source, or null on a miss.
+  /// Spans are attributed to @p sourceName.
+  std::unique_ptr<RootNode> load(const std::string &source,
+                                 const std::string &sourceName) const;
+  /// @brief Stores the syntax tree @p root parsed from @p source. Failures
+  /// are ignored; the cache only ever makes loading faster.
+  void store(const std::string &source, const std::string &sourceName,
+             const RootNode &root) const;
+
+  const std::filesystem::path &directory() const { return directory_; }
+
+private:
+  std::filesystem::path directory_;
+  uint64_t seed_;
+
+  std::filesystem::path entryPath(uint64_t key) const;
+  uint64_t keyFor(const std::string &source) const;
+};
+
+/// @brief Identity of the running compiler for module cache keys: @p version
+/// plus the size and modification time of the executable, so rebuilding the
+/// compiler invalidates the cache even when the version stays the same.
+std::string moduleCacheIdentity(const std::string &version,
+                                const std::filesystem::path &argv0Hint);
+
+} // namespace zap::frontend
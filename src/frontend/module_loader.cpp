@@ -114,6 +114,11 @@ std::filesystem::path stdlibObjectPath(const RuntimePaths &paths) {
   return paths.configuredStdlibObject;
 }
 
+// The bitcode build of the runtime is installed next to the runtime object.
+std::filesystem::path runtimeBitcodePath(const RuntimePaths &paths) {
+  return stdlibObjectPath(paths).replace_extension(".bc");
+}
+
 std::string stripSourceExtension(const std::filesystem::path &path) {
   auto normalized = path.generic_string();
   if (path.extension() == ".zp" && normalized.size() >= 3) {
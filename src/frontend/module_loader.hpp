@@ -43,6 +43,7 @@ currentExecutablePath(const std::filesystem::path &argv0Hint);
 std::filesystem::path stdlibRootPath(const RuntimePaths &paths);
 std::filesystem::path coreRootPath(const RuntimePaths &paths);
 std::filesystem::path stdlibObjectPath(const RuntimePaths &paths);
+std::filesystem::path runtimeBitcodePath(const RuntimePaths &paths);
 
 std::string stripSourceExtension(const std::filesystem::path &path);
 std::string computeLogicalModulePath(const std::filesystem::path &canonicalPath,
@@ -2,18 +2,83 @@
 #include "instruction.hpp"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace zir {
 
+class BasicBlock;
+
+/// @brief Numbers the block labels of one function. A label gets its id the
+/// first time a block or a branch names it, so a branch to a block that is
+/// only added later still resolves when the branch is added.
+class BlockTable {
+public:
+  BlockId intern(const std::string &label) {
+    const auto [entry, inserted] =
+        ids_.try_emplace(label, static_cast<BlockId>(blocks_.size()));
+    if (inserted) {
+      blocks_.push_back(nullptr);
+    }
+    return entry->second;
+  }
+
+  BlockId find(const std::string &label) const {
+    const auto entry = ids_.find(label);
+    return entry == ids_.end() ? NoBlock : entry->second;
+  }
+
+  /// @brief The block with id @p id, or null if no block has that label.
+  BasicBlock *block(BlockId id) const {
+    return id < blocks_.size() ? blocks_[id] : nullptr;
+  }
+
+  size_t size() const { return blocks_.size(); }
+
+  inline void add(BasicBlock &block);
+
+  void bind(Instruction &instruction) {
+    switch (instruction.getOpCode()) {
+    case OpCode::Br: {
+      auto &branch = static_cast<BranchInst &>(instruction);
+      branch.setTargetBlock(intern(branch.getTarget()));
+      return;
+    }
+    case OpCode::CondBr: {
+      auto &branch = static_cast<CondBranchInst &>(instruction);
+      branch.setTargetBlocks(intern(branch.getTrueLabel()),
+                             intern(branch.getFalseLabel()));
+      return;
+    }
+    case OpCode::Phi: {
+      auto &phi = static_cast<PhiInst &>(instruction);
+      for (size_t i = 0; i < phi.getIncoming().size(); ++i) {
+        phi.setIncomingBlock(i, intern(phi.getIncoming()[i].first));
+      }
+      return;
+    }
+    default:
+      return;
+    }
+  }
+
+private:
+  std::unordered_map<std::string, BlockId> ids_;
+  std::vector<BasicBlock *> blocks_;
+};
+
 class BasicBlock {
 public:
   std::string label;
+  BlockId id = NoBlock;
   std::vector<std::unique_ptr<Instruction>> instructions;
 
   BasicBlock(std::string label) : label(std::move(label)) {}
 
   void addInstruction(std::unique_ptr<Instruction> inst) {
+    if (table_ && inst) {
+      table_->bind(*inst);
+    }
     instructions.push_back(std::move(inst));
   }
 
@@ -23,13 +88,31 @@ public:
 
   bool empty() const { return instructions.empty(); }
 
-  std::string toString() const {
+  std::string toString(const ValueTable &values) const {
     std::string res = label + ":\n";
     for (const auto &inst : instructions) {
-      res += "    " + inst->toString() + "\n";
+      res += "    " + inst->toString(values) + "\n";
     }
     return res;
   }
+
+private:
+  friend class BlockTable;
+  BlockTable *table_ = nullptr;
 };
 
+// The first block with a label owns it; the verifier reports the others.
+void BlockTable::add(BasicBlock &block) {
+  block.id = intern(block.label);
+  block.table_ = this;
+  if (!blocks_[block.id]) {
+    blocks_[block.id] = &block;
+  }
+  for (const auto &instruction : block.instructions) {
+    if (instruction) {
+      bind(*instruction);
+    }
+  }
+}
+
 } // namespace zir
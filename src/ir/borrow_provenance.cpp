@@ -8,8 +8,8 @@ namespace zir {
 namespace {
 
 using OwnerSet = BorrowProvenance::OwnerSet;
-using OwnerMap = std::unordered_map<const Value *, OwnerSet>;
-using StorageState = std::unordered_map<const Value *, OwnerSet>;
+using OwnerMap = std::unordered_map<ValueId, OwnerSet>;
+using StorageState = std::unordered_map<ValueId, OwnerSet>;
 using StorageStates = std::unordered_map<const BasicBlock *, StorageState>;
 
 const OwnerSet &emptyOwners() {
@@ -17,14 +17,21 @@ const OwnerSet &emptyOwners() {
   return empty;
 }
 
-bool tracksOwnership(const std::shared_ptr<Value> &value) {
+bool tracksOwnership(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
   return value && isOwned(value->getOwnership()) &&
          containsManagedValues(value->getType());
 }
 
-bool addOwners(OwnerMap &owners, const Value *destination,
+bool isStringView(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
+  return value && value->getType()->getIntrinsicKind() ==
+                      IntrinsicTypeKind::StringView;
+}
+
+bool addOwners(OwnerMap &owners, ValueId destination,
                const OwnerSet &sources) {
-  if (!destination || sources.empty()) {
+  if (destination == NoValue || sources.empty()) {
     return false;
   }
   auto &destinationOwners = owners[destination];
@@ -33,21 +40,21 @@ bool addOwners(OwnerMap &owners, const Value *destination,
   return destinationOwners.size() != previousSize;
 }
 
-bool addOwnersFromValue(OwnerMap &owners, const Value *destination,
-                        const std::shared_ptr<Value> &source) {
-  if (!destination || !source) {
+bool addOwnersFromValue(OwnerMap &owners, ValueId destination,
+                        ValueId source) {
+  if (destination == NoValue || source == NoValue) {
     return false;
   }
-  const auto sourceOwners = owners.find(source.get());
+  const auto sourceOwners = owners.find(source);
   return sourceOwners != owners.end() &&
          addOwners(owners, destination, sourceOwners->second);
 }
 
-bool addBorrowSourcesFromValue(OwnerMap &owners, const Value *destination,
-                               const std::shared_ptr<Value> &source) {
+bool addBorrowSourcesFromValue(const Function &function, OwnerMap &owners,
+                               ValueId destination, ValueId source) {
   bool changed = false;
-  if (tracksOwnership(source)) {
-    changed = addOwners(owners, destination, {source.get()});
+  if (tracksOwnership(function, source)) {
+    changed = addOwners(owners, destination, {source});
   }
   return addOwnersFromValue(owners, destination, source) || changed;
 }
@@ -68,16 +75,15 @@ OwnerSet collectLocalStorage(const Function &function) {
         if (instruction->getOpCode() == OpCode::Alloca) {
           changed = localStorage
                         .insert(static_cast<const AllocaInst &>(*instruction)
-                                    .getResult()
-                                    .get())
+                                    .getResult())
                         .second ||
                     changed;
         } else if (instruction->getOpCode() == OpCode::GetElementPtr) {
           const auto &gep =
               static_cast<const GetElementPtrInst &>(*instruction);
-          if (localStorage.count(gep.getPointer().get()) != 0) {
+          if (localStorage.count(gep.getPointer()) != 0) {
             changed =
-                localStorage.insert(gep.getResult().get()).second || changed;
+                localStorage.insert(gep.getResult()).second || changed;
           }
         }
       }
@@ -89,11 +95,11 @@ OwnerSet collectLocalStorage(const Function &function) {
 OwnerMap collectValueOwners(
     const Module &module, const Function &function,
     const OwnerSet &localStorage,
-    std::unordered_map<const Value *, std::shared_ptr<Value>> &derivedFrom,
+    std::unordered_map<ValueId, ValueId> &derivedFrom,
     OwnerMap owners = {}) {
   const auto resultSource = function.resultBorrow.sourceParameter();
   for (size_t i = 0; i < function.getArguments().size(); ++i) {
-    const auto &argument = function.getArguments()[i];
+    const auto *argument = function.getArgument(i);
     const bool noescapeView =
         argument &&
         argument->getParameterEscape() == ParameterEscape::NoEscape &&
@@ -102,7 +108,8 @@ OwnerMap collectValueOwners(
             IntrinsicTypeKind::StringView;
     if (argument &&
         (noescapeView || (resultSource && *resultSource == i))) {
-      owners[argument.get()].insert(argument.get());
+      const auto id = function.getArguments()[i];
+      owners[id].insert(id);
     }
   }
   bool changed = true;
@@ -119,30 +126,31 @@ OwnerMap collectValueOwners(
         switch (instruction->getOpCode()) {
         case OpCode::Borrow: {
           const auto &borrow = static_cast<const BorrowInst &>(*instruction);
-          if (borrow.getResult()) {
-            changed = addBorrowSourcesFromValue(
-                          owners, borrow.getResult().get(), borrow.getOwner()) ||
+          if (borrow.getResult() != NoValue) {
+            changed = addBorrowSourcesFromValue(function, owners,
+                                                borrow.getResult(),
+                                                borrow.getOwner()) ||
                       changed;
           }
           break;
         }
         case OpCode::Phi: {
           const auto &phi = static_cast<const PhiInst &>(*instruction);
-          if (!phi.getResult()) {
+          if (phi.getResult() == NoValue) {
             break;
           }
           for (const auto &[_, incoming] : phi.getIncoming()) {
             changed =
-                addOwnersFromValue(owners, phi.getResult().get(), incoming) ||
+                addOwnersFromValue(owners, phi.getResult(), incoming) ||
                 changed;
           }
           break;
         }
         case OpCode::Store: {
           const auto &store = static_cast<const StoreInst &>(*instruction);
-          if (store.getDestination() &&
-              localStorage.count(store.getDestination().get()) != 0) {
-            changed = addOwnersFromValue(owners, store.getDestination().get(),
+          if (store.getDestination() != NoValue &&
+              localStorage.count(store.getDestination()) != 0) {
+            changed = addOwnersFromValue(owners, store.getDestination(),
                                          store.getSource()) ||
                       changed;
           }
@@ -150,8 +158,8 @@ OwnerMap collectValueOwners(
         }
         case OpCode::Load: {
           const auto &load = static_cast<const LoadInst &>(*instruction);
-          if (load.getResult()) {
-            changed = addOwnersFromValue(owners, load.getResult().get(),
+          if (load.getResult() != NoValue) {
+            changed = addOwnersFromValue(owners, load.getResult(),
                                          load.getSource()) ||
                       changed;
           }
@@ -160,8 +168,8 @@ OwnerMap collectValueOwners(
         case OpCode::GetElementPtr: {
           const auto &gep =
               static_cast<const GetElementPtrInst &>(*instruction);
-          if (gep.getResult()) {
-            changed = addOwnersFromValue(owners, gep.getResult().get(),
+          if (gep.getResult() != NoValue) {
+            changed = addOwnersFromValue(owners, gep.getResult(),
                                          gep.getPointer()) ||
                       changed;
           }
@@ -169,13 +177,10 @@ OwnerMap collectValueOwners(
         }
         case OpCode::Cast: {
           const auto &cast = static_cast<const CastInst &>(*instruction);
-          if (cast.getResult() && cast.getSource() &&
-              cast.getResult()->getType()->getIntrinsicKind() ==
-                  IntrinsicTypeKind::StringView &&
-              cast.getSource()->getType()->getIntrinsicKind() ==
-                  IntrinsicTypeKind::StringView) {
-            derivedFrom[cast.getResult().get()] = cast.getSource();
-            changed = addOwnersFromValue(owners, cast.getResult().get(),
+          if (isStringView(function, cast.getResult()) &&
+              isStringView(function, cast.getSource())) {
+            derivedFrom[cast.getResult()] = cast.getSource();
+            changed = addOwnersFromValue(owners, cast.getResult(),
                                          cast.getSource()) ||
                       changed;
           }
@@ -184,14 +189,14 @@ OwnerMap collectValueOwners(
         case OpCode::Call: {
           const auto &call = static_cast<const CallInst &>(*instruction);
           const auto resultBorrow =
-              resolveCallResultBorrowContract(module, call);
-          if (!call.getResult() || !resultBorrow.hasSource()) {
+              resolveCallResultBorrowContract(module, function, call);
+          if (call.getResult() == NoValue || !resultBorrow.hasSource()) {
             break;
           }
           const size_t sourceIndex = *resultBorrow.sourceParameter();
           if (sourceIndex < call.getArguments().size()) {
             changed = addBorrowSourcesFromValue(
-                          owners, call.getResult().get(),
+                          function, owners, call.getResult(),
                           call.getArguments()[sourceIndex]) ||
                       changed;
           }
@@ -226,16 +231,16 @@ void collectEntryLoads(
       }
       if (instruction->getOpCode() == OpCode::Store) {
         const auto &store = static_cast<const StoreInst &>(*instruction);
-        if (store.getDestination() &&
-            localStorage.count(store.getDestination().get()) != 0) {
-          writtenStorage.insert(store.getDestination().get());
+        if (store.getDestination() != NoValue &&
+            localStorage.count(store.getDestination()) != 0) {
+          writtenStorage.insert(store.getDestination());
         }
       } else if (instruction->getOpCode() == OpCode::Load) {
         const auto &load = static_cast<const LoadInst &>(*instruction);
-        if (load.getResult() && load.getSource() &&
-            localStorage.count(load.getSource().get()) != 0 &&
-            writtenStorage.count(load.getSource().get()) == 0) {
-          entryLoads[blockOwner.get()].insert(load.getResult().get());
+        if (load.getResult() != NoValue && load.getSource() != NoValue &&
+            localStorage.count(load.getSource()) != 0 &&
+            writtenStorage.count(load.getSource()) == 0) {
+          entryLoads[blockOwner.get()].insert(load.getResult());
         }
       }
     }
@@ -272,9 +277,9 @@ StorageStates analyzeStorageOwners(const Function &function,
         }
         if (instruction->getOpCode() == OpCode::Load) {
           const auto &load = static_cast<const LoadInst &>(*instruction);
-          if (load.getResult() && load.getSource() &&
-              localStorage.count(load.getSource().get()) != 0) {
-            loadOwners[load.getResult().get()] = state[load.getSource().get()];
+          if (load.getResult() != NoValue && load.getSource() != NoValue &&
+              localStorage.count(load.getSource()) != 0) {
+            loadOwners[load.getResult()] = state[load.getSource()];
           }
           continue;
         }
@@ -282,22 +287,22 @@ StorageStates analyzeStorageOwners(const Function &function,
           continue;
         }
         const auto &store = static_cast<const StoreInst &>(*instruction);
-        if (!store.getDestination() ||
-            localStorage.count(store.getDestination().get()) == 0) {
+        if (store.getDestination() == NoValue ||
+            localStorage.count(store.getDestination()) == 0) {
           continue;
         }
         OwnerSet owners;
-        if (store.getSource()) {
-          if (tracksOwnership(store.getSource())) {
-            owners.insert(store.getSource().get());
+        if (store.getSource() != NoValue) {
+          if (tracksOwnership(function, store.getSource())) {
+            owners.insert(store.getSource());
           }
-          const auto ownerIt = valueOwners.find(store.getSource().get());
+          const auto ownerIt = valueOwners.find(store.getSource());
           if (ownerIt != valueOwners.end()) {
             owners = ownerIt->second;
           }
         }
-        if (state[store.getDestination().get()] != owners) {
-          state[store.getDestination().get()] = std::move(owners);
+        if (state[store.getDestination()] != owners) {
+          state[store.getDestination()] = std::move(owners);
         }
       }
       if (exitStates[blockOwner.get()] != state) {
@@ -312,36 +317,36 @@ StorageStates analyzeStorageOwners(const Function &function,
 } // namespace
 
 const BorrowProvenance::OwnerSet &
-BorrowProvenance::ownersOf(const std::shared_ptr<Value> &value) const {
-  if (!value) {
+BorrowProvenance::ownersOf(ValueId value) const {
+  if (value == NoValue) {
     return emptyOwners();
   }
-  const auto owners = owners_.find(value.get());
+  const auto owners = owners_.find(value);
   return owners == owners_.end() ? emptyOwners() : owners->second;
 }
 
-BorrowProvenance::OwnerSet BorrowProvenance::ownersAtDefinition(
-    const std::shared_ptr<Value> &value) const {
+BorrowProvenance::OwnerSet
+BorrowProvenance::ownersAtDefinition(ValueId value) const {
   OwnerSet result;
   OwnerSet visited;
-  std::vector<std::shared_ptr<Value>> pending{value};
+  std::vector<ValueId> pending{value};
   while (!pending.empty()) {
     auto current = std::move(pending.back());
     pending.pop_back();
-    if (!current || !visited.insert(current.get()).second) {
+    if (current == NoValue || !visited.insert(current).second) {
       continue;
     }
-    const auto load = loadOwners_.find(current.get());
+    const auto load = loadOwners_.find(current);
     if (load != loadOwners_.end()) {
       result.insert(load->second.begin(), load->second.end());
       continue;
     }
-    const auto derived = derivedFrom_.find(current.get());
+    const auto derived = derivedFrom_.find(current);
     if (derived != derivedFrom_.end()) {
       pending.push_back(derived->second);
       continue;
     }
-    const auto phi = phiIncoming_.find(current.get());
+    const auto phi = phiIncoming_.find(current);
     if (phi != phiIncoming_.end()) {
       pending.insert(pending.end(), phi->second.begin(), phi->second.end());
       continue;
@@ -353,12 +358,11 @@ BorrowProvenance::OwnerSet BorrowProvenance::ownersAtDefinition(
 }
 
 BorrowProvenance::OwnerSet
-BorrowProvenance::ownersOnEdge(const std::shared_ptr<Value> &value,
-                               const BasicBlock &source,
+BorrowProvenance::ownersOnEdge(ValueId value, const BasicBlock &source,
                                const BasicBlock &destination) const {
-  std::shared_ptr<Value> current = value;
+  ValueId current = value;
   OwnerSet visited;
-  while (current && visited.insert(current.get()).second) {
+  while (current != NoValue && visited.insert(current).second) {
     for (const auto &instruction : destination.getInstructions()) {
       if (!instruction) {
         continue;
@@ -368,12 +372,8 @@ BorrowProvenance::ownersOnEdge(const std::shared_ptr<Value> &value,
         if (phi.getResult() != current) {
           continue;
         }
-        for (const auto &[label, incoming] : phi.getIncoming()) {
-          if (label == source.label) {
-            return ownersOf(incoming);
-          }
-        }
-        return {};
+        const auto *incoming = phi.findIncoming(source.id);
+        return incoming ? ownersOf(*incoming) : OwnerSet{};
       }
       if (instruction->getOpCode() == OpCode::Load) {
         const auto &load = static_cast<const LoadInst &>(*instruction);
@@ -383,7 +383,7 @@ BorrowProvenance::ownersOnEdge(const std::shared_ptr<Value> &value,
         }
       }
     }
-    const auto derived = derivedFrom_.find(current.get());
+    const auto derived = derivedFrom_.find(current);
     if (derived == derivedFrom_.end()) {
       return ownersOf(current);
     }
@@ -393,28 +393,27 @@ BorrowProvenance::ownersOnEdge(const std::shared_ptr<Value> &value,
 }
 
 const BorrowProvenance::OwnerSet &BorrowProvenance::ownersStoredAtExit(
-    const BasicBlock &block, const std::shared_ptr<Value> &storage) const {
-  if (!storage) {
+    const BasicBlock &block, ValueId storage) const {
+  if (storage == NoValue) {
     return emptyOwners();
   }
   const auto blockState = exitStorage_.find(&block);
   if (blockState == exitStorage_.end()) {
     return emptyOwners();
   }
-  const auto owners = blockState->second.find(storage.get());
+  const auto owners = blockState->second.find(storage);
   return owners == blockState->second.end() ? emptyOwners() : owners->second;
 }
 
-bool BorrowProvenance::isLocalStorage(
-    const std::shared_ptr<Value> &value) const {
-  return value && localStorage_.count(value.get()) != 0;
+bool BorrowProvenance::isLocalStorage(ValueId value) const {
+  return value != NoValue && localStorage_.count(value) != 0;
 }
 
 bool BorrowProvenance::isEntryLoad(const BasicBlock &block,
-                                   const std::shared_ptr<Value> &result) const {
+                                   ValueId result) const {
   const auto loads = entryLoads_.find(&block);
-  return result && loads != entryLoads_.end() &&
-         loads->second.count(result.get()) != 0;
+  return result != NoValue && loads != entryLoads_.end() &&
+         loads->second.count(result) != 0;
 }
 
 BorrowProvenance analyzeBorrowProvenance(const Module &module,
@@ -433,10 +432,10 @@ BorrowProvenance analyzeBorrowProvenance(const Module &module,
         continue;
       }
       const auto &phi = static_cast<const PhiInst &>(*instruction);
-      if (!phi.getResult()) {
+      if (phi.getResult() == NoValue) {
         continue;
       }
-      auto &incoming = result.phiIncoming_[phi.getResult().get()];
+      auto &incoming = result.phiIncoming_[phi.getResult()];
       for (const auto &[_, value] : phi.getIncoming()) {
         incoming.push_back(value);
       }
@@ -454,9 +453,10 @@ BorrowProvenance analyzeBorrowProvenance(const Module &module,
         continue;
       }
       const auto &borrow = static_cast<const BorrowInst &>(*instruction);
-      const auto loadedOwners = result.loadOwners_.find(borrow.getOwner().get());
-      if (borrow.getResult() && loadedOwners != result.loadOwners_.end()) {
-        addOwners(result.owners_, borrow.getResult().get(),
+      const auto loadedOwners = result.loadOwners_.find(borrow.getOwner());
+      if (borrow.getResult() != NoValue &&
+          loadedOwners != result.loadOwners_.end()) {
+        addOwners(result.owners_, borrow.getResult(),
                   loadedOwners->second);
       }
     }
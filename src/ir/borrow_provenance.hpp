@@ -2,7 +2,6 @@
 
 #include "control_flow_graph.hpp"
 
-#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -13,30 +12,26 @@ class Module;
 
 class BorrowProvenance {
 public:
-  using OwnerSet = std::unordered_set<const Value *>;
+  using OwnerSet = std::unordered_set<ValueId>;
 
-  const OwnerSet &ownersOf(const std::shared_ptr<Value> &value) const;
-  OwnerSet ownersAtDefinition(const std::shared_ptr<Value> &value) const;
-  OwnerSet ownersOnEdge(const std::shared_ptr<Value> &value,
-                        const BasicBlock &source,
+  const OwnerSet &ownersOf(ValueId value) const;
+  OwnerSet ownersAtDefinition(ValueId value) const;
+  OwnerSet ownersOnEdge(ValueId value, const BasicBlock &source,
                         const BasicBlock &destination) const;
-  const OwnerSet &
-  ownersStoredAtExit(const BasicBlock &block,
-                     const std::shared_ptr<Value> &storage) const;
-  bool isLocalStorage(const std::shared_ptr<Value> &value) const;
-  bool isEntryLoad(const BasicBlock &block,
-                   const std::shared_ptr<Value> &result) const;
+  const OwnerSet &ownersStoredAtExit(const BasicBlock &block,
+                                     ValueId storage) const;
+  bool isLocalStorage(ValueId value) const;
+  bool isEntryLoad(const BasicBlock &block, ValueId result) const;
 
 private:
-  using OwnerMap = std::unordered_map<const Value *, OwnerSet>;
-  using StorageState = std::unordered_map<const Value *, OwnerSet>;
+  using OwnerMap = std::unordered_map<ValueId, OwnerSet>;
+  using StorageState = std::unordered_map<ValueId, OwnerSet>;
   using StorageStates = std::unordered_map<const BasicBlock *, StorageState>;
 
   OwnerMap owners_;
   OwnerMap loadOwners_;
-  std::unordered_map<const Value *, std::shared_ptr<Value>> derivedFrom_;
-  std::unordered_map<const Value *, std::vector<std::shared_ptr<Value>>>
-      phiIncoming_;
+  std::unordered_map<ValueId, ValueId> derivedFrom_;
+  std::unordered_map<ValueId, std::vector<ValueId>> phiIncoming_;
   OwnerSet localStorage_;
   StorageStates exitStorage_;
   std::unordered_map<const BasicBlock *, OwnerSet> entryLoads_;
@@ -9,12 +9,13 @@
 namespace zir::verifier_detail {
 namespace {
 
-std::string formatSources(const BorrowProvenance::OwnerSet &sources) {
+std::string formatSources(const Function &function,
+                          const BorrowProvenance::OwnerSet &sources) {
   std::vector<std::string> names;
   names.reserve(sources.size());
-  for (const auto *source : sources) {
-    if (source) {
-      names.push_back(source->getName());
+  for (const auto source : sources) {
+    if (const auto *value = function.getValue(source)) {
+      names.push_back(value->getName());
     }
   }
   std::sort(names.begin(), names.end());
@@ -29,27 +30,27 @@ std::string formatSources(const BorrowProvenance::OwnerSet &sources) {
   return result;
 }
 
-const Value *resultBorrowSource(const Function &function) {
+ValueId resultBorrowSource(const Function &function) {
   if (!function.resultBorrow.hasSource()) {
-    return nullptr;
+    return NoValue;
   }
   const size_t sourceIndex = *function.resultBorrow.sourceParameter();
   return sourceIndex < function.getArguments().size()
-             ? function.getArguments()[sourceIndex].get()
-             : nullptr;
+             ? function.getArguments()[sourceIndex]
+             : NoValue;
 }
 
 bool hasDisallowedReturnSource(
     const Function &function,
     const BorrowProvenance::OwnerSet &sources) {
-  const Value *allowedSource = resultBorrowSource(function);
+  const ValueId allowedSource = resultBorrowSource(function);
   return std::any_of(sources.begin(), sources.end(),
-                     [allowedSource](const Value *source) {
+                     [allowedSource](ValueId source) {
                        return source != allowedSource;
                      });
 }
 
-bool isBorrowTrackedValue(const std::shared_ptr<Value> &value) {
+bool isBorrowTrackedValue(const Value *value) {
   return value && value->getType() &&
          value->getType()->getIntrinsicKind() ==
              IntrinsicTypeKind::StringView;
@@ -80,20 +81,21 @@ void verifyEscapes(const Module &module, const Function &function,
       }
       if (instruction->getOpCode() == OpCode::Ret) {
         const auto &ret = static_cast<const ReturnInst &>(*instruction);
-        if (!isBorrowTrackedValue(ret.getValue())) {
+        if (!isBorrowTrackedValue(function.getValue(ret.getValue()))) {
           continue;
         }
         const auto sources = provenance.ownersAtDefinition(ret.getValue());
         if (hasDisallowedReturnSource(function, sources)) {
           addError(errors, function, VerificationErrorCode::InvalidReturn,
                    &block, i,
-                   "cannot return " + ret.getValue()->getName() +
+                   "cannot return " +
+                       function.getValue(ret.getValue())->getName() +
                        " backed by non-escaping borrow source " +
-                       formatSources(sources));
+                       formatSources(function, sources));
         }
       } else if (instruction->getOpCode() == OpCode::Store) {
         const auto &store = static_cast<const StoreInst &>(*instruction);
-        if (!isBorrowTrackedValue(store.getSource())) {
+        if (!isBorrowTrackedValue(function.getValue(store.getSource()))) {
           continue;
         }
         const auto sources =
@@ -102,36 +104,38 @@ void verifyEscapes(const Module &module, const Function &function,
             !provenance.isLocalStorage(store.getDestination())) {
           addError(errors, function, VerificationErrorCode::InvalidOperand,
                    &block, i,
-                   "cannot store " + store.getSource()->getName() +
+                   "cannot store " +
+                       function.getValue(store.getSource())->getName() +
                        " backed by non-escaping borrow source " +
-                       formatSources(sources) + " outside local storage");
+                       formatSources(function, sources) +
+                       " outside local storage");
         }
       } else if (instruction->getOpCode() == OpCode::Call) {
         const auto &call = static_cast<const CallInst &>(*instruction);
         for (size_t argumentIndex = 0;
              argumentIndex < call.getArguments().size(); ++argumentIndex) {
-          if (!isBorrowTrackedValue(call.getArguments()[argumentIndex])) {
+          const ValueId argument = call.getArguments()[argumentIndex];
+          if (!isBorrowTrackedValue(function.getValue(argument))) {
             continue;
           }
-          const auto sources = provenance.ownersAtDefinition(
-              call.getArguments()[argumentIndex]);
+          const auto sources = provenance.ownersAtDefinition(argument);
           const auto resultBorrow =
-              resolveCallResultBorrowContract(module, call);
+              resolveCallResultBorrowContract(module, function, call);
           const bool mayBackResult =
               resultBorrow.hasSource() &&
               *resultBorrow.sourceParameter() == argumentIndex;
           const auto contract =
-              resolveCallParameterContract(module, call, argumentIndex);
+              resolveCallParameterContract(module, function, call,
+                                           argumentIndex);
           if (!sources.empty() &&
               (!contract || contract->escape != ParameterEscape::NoEscape) &&
               !mayBackResult) {
             addError(
                 errors, function, VerificationErrorCode::InvalidCall, &block,
                 i,
-                "cannot pass " +
-                    call.getArguments()[argumentIndex]->getName() +
+                "cannot pass " + function.getValue(argument)->getName() +
                     " backed by tracked borrow source " +
-                    formatSources(sources) +
+                    formatSources(function, sources) +
                     " to a parameter with an unspecified escape contract");
           }
         }
@@ -151,7 +155,7 @@ void verifyResultContract(const Function &function,
     addError(errors, function, VerificationErrorCode::InvalidReturn, nullptr,
              std::nullopt, "result borrow source parameter is out of range");
   } else {
-    const auto &source = function.getArguments()[sourceIndex];
+    const auto *source = function.getArgument(sourceIndex);
     if (!source ||
         source->getParameterOwnership() != ParameterOwnership::Borrow) {
       addError(errors, function, VerificationErrorCode::InvalidReturn, nullptr,
@@ -5,11 +5,18 @@
 namespace zir {
 namespace {
 
-bool ownsManagedValue(const std::shared_ptr<Value> &value) {
+bool ownsManagedValue(const Value *value) {
   return value && isOwned(value->getOwnership()) &&
          containsManagedValues(value->getType());
 }
 
+const FunctionPointerType *calleeType(const Function &function,
+                                      const CallInst &call) {
+  const Value *callee = function.getValue(call.getCalleeValue());
+  return callee ? dynamic_cast<const FunctionPointerType *>(callee->getType())
+                : nullptr;
+}
+
 bool isBorrowedMethodSelf(const Module &module, const CallInst &call,
                           size_t argumentIndex) {
   if (call.isIndirect() || argumentIndex != 0) {
@@ -17,20 +24,17 @@ bool isBorrowedMethodSelf(const Module &module, const CallInst &call,
   }
   const auto *callee = module.findFunction(call.getFunctionName());
   return callee && !callee->ownerTypeCodegenName.empty() &&
-         !callee->getArguments().empty() && callee->getArguments().front() &&
-         callee->getArguments().front()->getRawName() == "self";
+         !callee->getArguments().empty() &&
+         callee->getArgument(0)->getRawName() == "self";
 }
 
 } // namespace
 
 std::optional<CallParameterContract>
-resolveCallParameterContract(const Module &module, const CallInst &call,
-                             size_t argumentIndex) {
+resolveCallParameterContract(const Module &module, const Function &function,
+                             const CallInst &call, size_t argumentIndex) {
   if (call.isIndirect()) {
-    const auto functionType = call.getCalleeValue()
-                                  ? std::dynamic_pointer_cast<FunctionPointerType>(
-                                        call.getCalleeValue()->getType())
-                                  : nullptr;
+    const auto *functionType = calleeType(function, call);
     if (!functionType ||
         argumentIndex >= functionType->getParameterOwnership().size()) {
       return std::nullopt;
@@ -47,7 +51,8 @@ resolveCallParameterContract(const Module &module, const CallInst &call,
     return std::nullopt;
   }
   size_t fixedIndex = 0;
-  for (const auto &parameter : callee->getArguments()) {
+  for (size_t i = 0; i < callee->getArguments().size(); ++i) {
+    const auto *parameter = callee->getArgument(i);
     if (!parameter || parameter->isVariadicPack()) {
       continue;
     }
@@ -60,12 +65,10 @@ resolveCallParameterContract(const Module &module, const CallInst &call,
 }
 
 ResultBorrowContract resolveCallResultBorrowContract(const Module &module,
+                                                     const Function &function,
                                                      const CallInst &call) {
   if (call.isIndirect()) {
-    const auto functionType = call.getCalleeValue()
-                                  ? std::dynamic_pointer_cast<FunctionPointerType>(
-                                        call.getCalleeValue()->getType())
-                                  : nullptr;
+    const auto *functionType = calleeType(function, call);
     return functionType ? functionType->getResultBorrow()
                         : ResultBorrowContract{};
   }
@@ -73,28 +76,27 @@ ResultBorrowContract resolveCallResultBorrowContract(const Module &module,
   return callee ? callee->resultBorrow : ResultBorrowContract{};
 }
 
-bool callReturnsRef(const Module &module, const CallInst &call) {
+bool callReturnsRef(const Module &module, const Function &function,
+                    const CallInst &call) {
   if (call.isIndirect()) {
-    const auto functionType = call.getCalleeValue()
-                                  ? std::dynamic_pointer_cast<FunctionPointerType>(
-                                        call.getCalleeValue()->getType())
-                                  : nullptr;
+    const auto *functionType = calleeType(function, call);
     return functionType && functionType->returnsRef();
   }
   const auto *callee = module.findFunction(call.getFunctionName());
   return callee && callee->returnsRef;
 }
 
-bool callTransfersOwnership(const Module &module, const CallInst &call,
-                            size_t argumentIndex) {
+bool callTransfersOwnership(const Module &module, const Function &function,
+                            const CallInst &call, size_t argumentIndex) {
   if (argumentIndex >= call.getArguments().size() ||
-      !ownsManagedValue(call.getArguments()[argumentIndex]) ||
+      !ownsManagedValue(
+          function.getValue(call.getArguments()[argumentIndex])) ||
       (argumentIndex < call.getArgumentIsRef().size() &&
        call.getArgumentIsRef()[argumentIndex])) {
     return false;
   }
   const auto contract =
-      resolveCallParameterContract(module, call, argumentIndex);
+      resolveCallParameterContract(module, function, call, argumentIndex);
   return contract && transfersOwnership(contract->ownership) &&
          !isBorrowedMethodSelf(module, call, argumentIndex);
 }
@@ -7,6 +7,7 @@
 
 namespace zir {
 
+class Function;
 class Module;
 
 struct CallParameterContract {
@@ -14,18 +15,23 @@ struct CallParameterContract {
   ParameterEscape escape;
 };
 
+// Each helper takes the function making the call, whose value table holds
+// the callee of an indirect call.
+
 // Resolves the declared contract for a fixed call argument. Variadic arguments
 // have no ownership or escape contract and therefore return std::nullopt.
 std::optional<CallParameterContract>
-resolveCallParameterContract(const Module &module, const CallInst &call,
-                             size_t argumentIndex);
+resolveCallParameterContract(const Module &module, const Function &function,
+                             const CallInst &call, size_t argumentIndex);
 
 ResultBorrowContract resolveCallResultBorrowContract(const Module &module,
+                                                     const Function &function,
                                                      const CallInst &call);
 
-bool callReturnsRef(const Module &module, const CallInst &call);
+bool callReturnsRef(const Module &module, const Function &function,
+                    const CallInst &call);
 
-bool callTransfersOwnership(const Module &module, const CallInst &call,
-                            size_t argumentIndex);
+bool callTransfersOwnership(const Module &module, const Function &function,
+                            const CallInst &call, size_t argumentIndex);
 
 } // namespace zir
@@ -5,12 +5,12 @@
 
 namespace zir {
 
-ControlFlowGraph::ControlFlowGraph(const Function &function) {
+ControlFlowGraph::ControlFlowGraph(const Function &function)
+    : function_(function) {
   for (const auto &blockOwner : function.getBlocks()) {
     if (!blockOwner) {
       continue;
     }
-    blocks_.emplace(blockOwner->label, blockOwner.get());
     predecessors_.try_emplace(blockOwner.get());
     successors_.try_emplace(blockOwner.get());
   }
@@ -19,8 +19,8 @@ ControlFlowGraph::ControlFlowGraph(const Function &function) {
       continue;
     }
     const auto &block = *blockOwner;
-    auto addEdge = [&](const std::string &label) {
-      const auto *target = findBlock(label);
+    auto addEdge = [&](BlockId id) {
+      const auto *target = function.getBlock(id);
       if (!target) {
         return;
       }
@@ -32,11 +32,12 @@ ControlFlowGraph::ControlFlowGraph(const Function &function) {
         continue;
       }
       if (instruction->getOpCode() == OpCode::Br) {
-        addEdge(static_cast<const BranchInst &>(*instruction).getTarget());
+        addEdge(
+            static_cast<const BranchInst &>(*instruction).getTargetBlock());
       } else if (instruction->getOpCode() == OpCode::CondBr) {
         const auto &branch = static_cast<const CondBranchInst &>(*instruction);
-        addEdge(branch.getTrueLabel());
-        addEdge(branch.getFalseLabel());
+        addEdge(branch.getTrueBlock());
+        addEdge(branch.getFalseBlock());
       }
     }
   }
@@ -110,8 +111,7 @@ ControlFlowGraph::ControlFlowGraph(const Function &function) {
 }
 
 const BasicBlock *ControlFlowGraph::findBlock(const std::string &label) const {
-  const auto block = blocks_.find(label);
-  return block == blocks_.end() ? nullptr : block->second;
+  return function_.findBlock(label);
 }
 
 bool ControlFlowGraph::isReachable(const BasicBlock &block) const {
@@ -28,7 +28,7 @@ public:
   bool dominates(const BasicBlock &dominator, const BasicBlock &block) const;
 
 private:
-  std::unordered_map<std::string, const BasicBlock *> blocks_;
+  const Function &function_;
   BlockEdges predecessors_;
   BlockEdges successors_;
   std::unordered_set<const BasicBlock *> reachable_;
@@ -1,15 +1,15 @@
 #include "dead_phi_elimination.hpp"
 
 #include <algorithm>
-#include <unordered_set>
+#include <vector>
 
 namespace zir {
 namespace {
 
 template <typename Visitor>
-void visitValue(const std::shared_ptr<Value> &value, Visitor &visitor) {
-  if (value) {
-    visitor(value.get());
+void visitValue(ValueId value, Visitor &visitor) {
+  if (value != NoValue) {
+    visitor(value);
   }
 }
 
@@ -126,8 +126,9 @@ void visitInstructionOperands(const Instruction &instruction,
   }
 }
 
-std::unordered_set<const Value *> collectUsedValues(const Function &function) {
-  std::unordered_set<const Value *> phiResults;
+// Flags, by ValueId, the phi results some instruction reads.
+std::vector<bool> collectUsedPhis(const Function &function) {
+  std::vector<bool> phiResults(function.values.size());
   for (const auto &block : function.getBlocks()) {
     if (!block) {
       continue;
@@ -136,15 +137,15 @@ std::unordered_set<const Value *> collectUsedValues(const Function &function) {
       if (!instruction || instruction->getOpCode() != OpCode::Phi) {
         continue;
       }
-      const auto &result =
+      const ValueId result =
           static_cast<const PhiInst &>(*instruction).getResult();
-      if (result) {
-        phiResults.insert(result.get());
+      if (result < phiResults.size()) {
+        phiResults[result] = true;
       }
     }
   }
 
-  std::unordered_set<const Value *> used;
+  std::vector<bool> used(phiResults.size());
   for (const auto &block : function.getBlocks()) {
     if (!block) {
       continue;
@@ -153,9 +154,9 @@ std::unordered_set<const Value *> collectUsedValues(const Function &function) {
       if (!candidate) {
         continue;
       }
-      auto recordPhiUse = [&](const Value *operand) {
-        if (phiResults.count(operand) != 0) {
-          used.insert(operand);
+      auto recordPhiUse = [&](ValueId operand) {
+        if (operand < phiResults.size() && phiResults[operand]) {
+          used[operand] = true;
         }
       };
       visitInstructionOperands(*candidate, recordPhiUse);
@@ -170,7 +171,7 @@ void removeDeadPhiInstructions(Function &function) {
   bool changed = true;
   while (changed) {
     changed = false;
-    const auto used = collectUsedValues(function);
+    const auto used = collectUsedPhis(function);
     for (const auto &block : function.getBlocks()) {
       if (!block) {
         continue;
@@ -182,9 +183,9 @@ void removeDeadPhiInstructions(Function &function) {
             if (!instruction || instruction->getOpCode() != OpCode::Phi) {
               return false;
             }
-            const auto &result =
+            const ValueId result =
                 static_cast<const PhiInst &>(*instruction).getResult();
-            const bool dead = result && used.count(result.get()) == 0;
+            const bool dead = result < used.size() && !used[result];
             changed = changed || dead;
             return dead;
           });
@@ -17,7 +17,9 @@ public:
   bool returnsRef = false;
   ResultBorrowContract resultBorrow;
   int vtableSlot = -1;
-  std::vector<std::shared_ptr<Argument>> arguments;
+  // Declared ahead of the blocks, whose instructions name its values.
+  ValueTable values;
+  std::vector<ValueId> arguments;
   std::vector<std::unique_ptr<BasicBlock>> blocks;
 
   Function(std::string name, std::shared_ptr<Type> returnType,
@@ -29,33 +31,51 @@ public:
         vtableSlot(vtableSlot) {}
 
   void addBlock(std::unique_ptr<BasicBlock> block) {
+    if (block) {
+      blockTable_->add(*block);
+    }
     blocks.push_back(std::move(block));
   }
 
   const std::shared_ptr<Type> &getReturnType() const { return returnType; }
 
-  const std::vector<std::shared_ptr<Argument>> &getArguments() const {
-    return arguments;
+  const std::vector<ValueId> &getArguments() const { return arguments; }
+
+  const Argument *getArgument(size_t index) const {
+    return static_cast<const Argument *>(values.get(arguments[index]));
   }
 
+  Value *getValue(ValueId id) const { return values.get(id); }
+
   const std::vector<std::unique_ptr<BasicBlock>> &getBlocks() const {
     return blocks;
   }
 
   BasicBlock *findBlock(const std::string &label) const {
-    for (const auto &block : blocks) {
-      if (block->label == label) {
-        return block.get();
-      }
-    }
-    return nullptr;
+    return blockTable_->block(blockTable_->find(label));
+  }
+
+  BasicBlock *getBlock(BlockId id) const { return blockTable_->block(id); }
+
+  /// @brief Upper bound of the block ids in this function, for tables
+  /// indexed by BlockId. Ids of labels no block carries map to null.
+  size_t getBlockIdCount() const { return blockTable_->size(); }
+
+  /// @brief The id of @p label, reserving one if nothing named it yet.
+  BlockId internBlockLabel(const std::string &label) {
+    return blockTable_->intern(label);
+  }
+
+  bool hasBlockLabel(const std::string &label) const {
+    return blockTable_->find(label) != NoBlock;
   }
 
   std::string toString() const {
     std::string res = "@" + name + "(";
     for (size_t i = 0; i < arguments.size(); ++i) {
-      if (containsManagedValues(arguments[i]->getType())) {
-        switch (arguments[i]->getParameterOwnership()) {
+      const Argument &argument = *getArgument(i);
+      if (containsManagedValues(argument.getType())) {
+        switch (argument.getParameterOwnership()) {
         case ParameterOwnership::Borrow:
           res += "borrow ";
           break;
@@ -67,10 +87,10 @@ public:
           break;
         }
       }
-      if (arguments[i]->getParameterEscape() == ParameterEscape::NoEscape) {
+      if (argument.getParameterEscape() == ParameterEscape::NoEscape) {
         res += "noescape ";
       }
-      res += arguments[i]->getTypeName() + " " + arguments[i]->getName();
+      res += argument.getTypeName() + " " + argument.getName();
       if (i < arguments.size() - 1)
         res += ", ";
     }
@@ -83,11 +103,14 @@ public:
     }
     res += " {\n";
     for (const auto &block : blocks) {
-      res += block->toString();
+      res += block->toString(values);
     }
     res += "}\n";
     return res;
   }
+
+private:
+  std::unique_ptr<BlockTable> blockTable_ = std::make_unique<BlockTable>();
 };
 
 } // namespace zir
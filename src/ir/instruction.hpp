@@ -1,11 +1,18 @@
 #pragma once
 #include "value.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace zir {
 
+/// @brief Number of a block label within one function, handed out by
+/// BlockTable. Branches and phis keep their labels for printing but are
+/// followed by id, so passes and codegen never look labels up by name.
+using BlockId = uint32_t;
+constexpr BlockId NoBlock = ~BlockId{0};
+
 enum class OpCode {
   Alloca,
   Load,
@@ -46,22 +53,21 @@ class Instruction {
 public:
   virtual ~Instruction() = default;
   virtual OpCode getOpCode() const = 0;
-  virtual std::string toString() const = 0;
+  virtual std::string toString(const ValueTable &values) const = 0;
 };
 
 class BinaryInst : public Instruction {
   OpCode op;
-  std::shared_ptr<Value> result, lhs, rhs;
+  ValueId result, lhs, rhs;
 
 public:
-  BinaryInst(OpCode o, std::shared_ptr<Value> res, std::shared_ptr<Value> l,
-             std::shared_ptr<Value> r)
-      : op(o), result(std::move(res)), lhs(std::move(l)), rhs(std::move(r)) {}
+  BinaryInst(OpCode o, ValueId res, ValueId l, ValueId r)
+      : op(o), result(res), lhs(l), rhs(r) {}
   OpCode getOpCode() const override { return op; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getLhs() const { return lhs; }
-  const std::shared_ptr<Value> &getRhs() const { return rhs; }
-  std::string toString() const override {
+  ValueId getResult() const { return result; }
+  ValueId getLhs() const { return lhs; }
+  ValueId getRhs() const { return rhs; }
+  std::string toString(const ValueTable &values) const override {
     std::string opStr;
     switch (op) {
     case OpCode::Add:
@@ -107,8 +113,9 @@ public:
       opStr = "binary";
       break;
     }
-    return result->getName() + " = " + opStr + " " + lhs->getTypeName() + " " +
-           lhs->getName() + ", " + rhs->getName();
+    return values[result].getName() + " = " + opStr + " " +
+           values[lhs].getTypeName() + " " + values[lhs].getName() + ", " +
+           values[rhs].getName();
   }
 };
 
@@ -120,17 +127,17 @@ enum class StoreMode {
 };
 
 class StoreInst : public Instruction {
-  std::shared_ptr<Value> src, dest;
+  ValueId src, dest;
   StoreMode mode_;
 
 public:
-  StoreInst(std::shared_ptr<Value> s, std::shared_ptr<Value> d, StoreMode mode)
-      : src(std::move(s)), dest(std::move(d)), mode_(mode) {}
+  StoreInst(ValueId s, ValueId d, StoreMode mode)
+      : src(s), dest(d), mode_(mode) {}
   OpCode getOpCode() const override { return OpCode::Store; }
-  const std::shared_ptr<Value> &getSource() const { return src; }
-  const std::shared_ptr<Value> &getDestination() const { return dest; }
+  ValueId getSource() const { return src; }
+  ValueId getDestination() const { return dest; }
   StoreMode getMode() const { return mode_; }
-  std::string toString() const override {
+  std::string toString(const ValueTable &values) const override {
     const char *modeName = "invalid";
     switch (mode_) {
     case StoreMode::Assign:
@@ -146,309 +153,336 @@ public:
       modeName = "raw_initialize";
       break;
     }
-    return "store." + std::string(modeName) + " " + src->getTypeName() + " " +
-           src->getName() + ", " + dest->getTypeName() + " " + dest->getName();
+    return "store." + std::string(modeName) + " " +
+           values[src].getTypeName() + " " + values[src].getName() + ", " +
+           values[dest].getTypeName() + " " + values[dest].getName();
   }
 };
 
 class LoadInst : public Instruction {
-  std::shared_ptr<Value> result, src;
+  ValueId result, src;
 
 public:
-  LoadInst(std::shared_ptr<Value> res, std::shared_ptr<Value> s)
-      : result(std::move(res)), src(std::move(s)) {}
+  LoadInst(ValueId res, ValueId s) : result(res), src(s) {}
   OpCode getOpCode() const override { return OpCode::Load; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getSource() const { return src; }
-  std::string toString() const override {
-    return result->getName() + " = load " + result->getTypeName() + ", " +
-           src->getTypeName() + " " + src->getName();
+  ValueId getResult() const { return result; }
+  ValueId getSource() const { return src; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = load " +
+           values[result].getTypeName() + ", " + values[src].getTypeName() +
+           " " + values[src].getName();
   }
 };
 
 class AllocaInst : public Instruction {
-  std::shared_ptr<Value> result;
+  ValueId result;
   std::shared_ptr<Type> type;
 
 public:
-  AllocaInst(std::shared_ptr<Value> res, std::shared_ptr<Type> t)
-      : result(std::move(res)), type(std::move(t)) {}
+  AllocaInst(ValueId res, std::shared_ptr<Type> t)
+      : result(res), type(std::move(t)) {}
   OpCode getOpCode() const override { return OpCode::Alloca; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
+  ValueId getResult() const { return result; }
   const std::shared_ptr<Type> &getAllocatedType() const { return type; }
-  std::string toString() const override {
-    return result->getName() + " = alloca " + type->toString();
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = alloca " + type->toString();
   }
 };
 
 class BranchInst : public Instruction {
   std::string target;
+  BlockId targetBlock = NoBlock;
 
 public:
   BranchInst(std::string t) : target(std::move(t)) {}
   OpCode getOpCode() const override { return OpCode::Br; }
   const std::string &getTarget() const { return target; }
-  void setTarget(std::string value) { target = std::move(value); }
-  std::string toString() const override { return "br label %" + target; }
+  BlockId getTargetBlock() const { return targetBlock; }
+  void setTargetBlock(BlockId block) { targetBlock = block; }
+  void setTarget(std::string label, BlockId block) {
+    target = std::move(label);
+    targetBlock = block;
+  }
+  std::string toString(const ValueTable &) const override {
+    return "br label %" + target;
+  }
 };
 
 class CondBranchInst : public Instruction {
-  std::shared_ptr<Value> cond;
+  ValueId cond;
   std::string trueL, falseL;
+  BlockId trueBlock = NoBlock, falseBlock = NoBlock;
 
 public:
-  CondBranchInst(std::shared_ptr<Value> c, std::string t, std::string f)
-      : cond(std::move(c)), trueL(std::move(t)), falseL(std::move(f)) {}
+  CondBranchInst(ValueId c, std::string t, std::string f)
+      : cond(c), trueL(std::move(t)), falseL(std::move(f)) {}
   OpCode getOpCode() const override { return OpCode::CondBr; }
-  const std::shared_ptr<Value> &getCondition() const { return cond; }
+  ValueId getCondition() const { return cond; }
   const std::string &getTrueLabel() const { return trueL; }
   const std::string &getFalseLabel() const { return falseL; }
-  void replaceTarget(const std::string &from, std::string to) {
-    if (trueL == from) {
+  BlockId getTrueBlock() const { return trueBlock; }
+  BlockId getFalseBlock() const { return falseBlock; }
+  void setTargetBlocks(BlockId t, BlockId f) {
+    trueBlock = t;
+    falseBlock = f;
+  }
+  void replaceTarget(BlockId from, const std::string &to, BlockId toBlock) {
+    if (trueBlock == from) {
       trueL = to;
+      trueBlock = toBlock;
     }
-    if (falseL == from) {
-      falseL = std::move(to);
+    if (falseBlock == from) {
+      falseL = to;
+      falseBlock = toBlock;
     }
   }
-  std::string toString() const override {
-    return "br i1 " + cond->getName() + ", label %" + trueL + ", label %" +
-           falseL;
+  std::string toString(const ValueTable &values) const override {
+    return "br i1 " + values[cond].getName() + ", label %" + trueL +
+           ", label %" + falseL;
   }
 };
 
 class CallInst : public Instruction {
 private:
-  std::shared_ptr<Value> result;
+  ValueId result;
   std::string funcName;
-  std::shared_ptr<Value> calleeValue; // non-null for indirect calls
-  std::vector<std::shared_ptr<Value>> args;
+  ValueId calleeValue = NoValue; // set for indirect calls
+  std::vector<ValueId> args;
   std::vector<bool> argIsRef;
-  std::shared_ptr<Value> variadicPack;
+  ValueId variadicPack = NoValue;
 
 public:
-  CallInst(std::shared_ptr<Value> res, std::string name,
-           std::vector<std::shared_ptr<Value>> arguments,
+  CallInst(ValueId res, std::string name, std::vector<ValueId> arguments,
            std::vector<bool> argumentIsRef = {},
-           std::shared_ptr<Value> pack = nullptr)
-      : result(std::move(res)), funcName(std::move(name)),
-        args(std::move(arguments)), argIsRef(std::move(argumentIsRef)),
-        variadicPack(std::move(pack)) {}
+           ValueId pack = NoValue)
+      : result(res), funcName(std::move(name)), args(std::move(arguments)),
+        argIsRef(std::move(argumentIsRef)), variadicPack(pack) {}
   // Indirect call constructor
-  CallInst(std::shared_ptr<Value> res, std::shared_ptr<Value> callee,
-           std::vector<std::shared_ptr<Value>> arguments)
-      : result(std::move(res)), calleeValue(std::move(callee)),
-        args(std::move(arguments)) {}
+  CallInst(ValueId res, ValueId callee, std::vector<ValueId> arguments)
+      : result(res), calleeValue(callee), args(std::move(arguments)) {}
   OpCode getOpCode() const override { return OpCode::Call; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
+  ValueId getResult() const { return result; }
   const std::string &getFunctionName() const { return funcName; }
-  const std::shared_ptr<Value> &getCalleeValue() const { return calleeValue; }
-  bool isIndirect() const { return calleeValue != nullptr; }
-  const std::vector<std::shared_ptr<Value>> &getArguments() const {
-    return args;
-  }
+  ValueId getCalleeValue() const { return calleeValue; }
+  bool isIndirect() const { return calleeValue != NoValue; }
+  const std::vector<ValueId> &getArguments() const { return args; }
   const std::vector<bool> &getArgumentIsRef() const { return argIsRef; }
-  const std::shared_ptr<Value> &getVariadicPack() const { return variadicPack; }
-  std::string toString() const override {
-    std::string s = result ? result->getName() + " = call " : "call ";
-    s += calleeValue ? calleeValue->getName() : "@" + funcName;
+  ValueId getVariadicPack() const { return variadicPack; }
+  std::string toString(const ValueTable &values) const override {
+    std::string s =
+        result != NoValue ? values[result].getName() + " = call " : "call ";
+    s += calleeValue != NoValue ? values[calleeValue].getName()
+                                : "@" + funcName;
     s += "(";
     for (size_t i = 0; i < args.size(); ++i) {
-      s += args[i]->getTypeName() + " " + args[i]->getName() +
+      s += values[args[i]].getTypeName() + " " + values[args[i]].getName() +
            (i < args.size() - 1 ? ", " : "");
     }
     s += ")";
-    if (variadicPack) {
-      s += " spread " + variadicPack->getTypeName() + " " +
-           variadicPack->getName();
+    if (variadicPack != NoValue) {
+      s += " spread " + values[variadicPack].getTypeName() + " " +
+           values[variadicPack].getName();
     }
     return s;
   }
 };
 
 class ReturnInst : public Instruction {
-  std::shared_ptr<Value> value;
+  ValueId value;
 
 public:
-  explicit ReturnInst(std::shared_ptr<Value> v = nullptr)
-      : value(std::move(v)) {}
+  explicit ReturnInst(ValueId v = NoValue) : value(v) {}
   OpCode getOpCode() const override { return OpCode::Ret; }
-  const std::shared_ptr<Value> &getValue() const { return value; }
-  std::string toString() const override {
-    if (value)
-      return "ret " + value->getTypeName() + " " + value->getName();
+  ValueId getValue() const { return value; }
+  std::string toString(const ValueTable &values) const override {
+    if (value != NoValue)
+      return "ret " + values[value].getTypeName() + " " +
+             values[value].getName();
     return "ret void";
   }
 };
 
 class CopyInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::shared_ptr<Value> source;
+  ValueId result;
+  ValueId source;
 
 public:
-  CopyInst(std::shared_ptr<Value> res, std::shared_ptr<Value> src)
-      : result(std::move(res)), source(std::move(src)) {}
+  CopyInst(ValueId res, ValueId src) : result(res), source(src) {}
   OpCode getOpCode() const override { return OpCode::Copy; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getSource() const { return source; }
-  std::string toString() const override {
-    return result->getName() + " = copy " + source->getTypeName() + " " +
-           source->getName();
+  ValueId getResult() const { return result; }
+  ValueId getSource() const { return source; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = copy " +
+           values[source].getTypeName() + " " + values[source].getName();
   }
 };
 
 class MoveInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::shared_ptr<Value> source;
+  ValueId result;
+  ValueId source;
 
 public:
-  MoveInst(std::shared_ptr<Value> res, std::shared_ptr<Value> src)
-      : result(std::move(res)), source(std::move(src)) {}
+  MoveInst(ValueId res, ValueId src) : result(res), source(src) {}
   OpCode getOpCode() const override { return OpCode::Move; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getSource() const { return source; }
-  std::string toString() const override {
-    return result->getName() + " = move " + source->getTypeName() + " " +
-           source->getName();
+  ValueId getResult() const { return result; }
+  ValueId getSource() const { return source; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = move " +
+           values[source].getTypeName() + " " + values[source].getName();
   }
 };
 
 class BorrowInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::shared_ptr<Value> owner;
+  ValueId result;
+  ValueId owner;
 
 public:
-  BorrowInst(std::shared_ptr<Value> res, std::shared_ptr<Value> source)
-      : result(std::move(res)), owner(std::move(source)) {}
+  BorrowInst(ValueId res, ValueId source) : result(res), owner(source) {}
   OpCode getOpCode() const override { return OpCode::Borrow; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getOwner() const { return owner; }
-  std::string toString() const override {
-    return result->getName() + " = borrow " + result->getTypeName() + " " +
-           owner->getTypeName() + " " + owner->getName();
+  ValueId getResult() const { return result; }
+  ValueId getOwner() const { return owner; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = borrow " +
+           values[result].getTypeName() + " " + values[owner].getTypeName() +
+           " " + values[owner].getName();
   }
 };
 
 class DestroyInst : public Instruction {
-  std::shared_ptr<Value> value;
+  ValueId value;
 
 public:
-  explicit DestroyInst(std::shared_ptr<Value> v) : value(std::move(v)) {}
+  explicit DestroyInst(ValueId v) : value(v) {}
   OpCode getOpCode() const override { return OpCode::Destroy; }
-  const std::shared_ptr<Value> &getValue() const { return value; }
-  std::string toString() const override {
-    return "destroy " + value->getTypeName() + " " + value->getName();
+  ValueId getValue() const { return value; }
+  std::string toString(const ValueTable &values) const override {
+    return "destroy " + values[value].getTypeName() + " " +
+           values[value].getName();
   }
 };
 
 class AllocInst : public Instruction {
-  std::shared_ptr<Value> result;
+  ValueId result;
   std::shared_ptr<Type> type;
 
 public:
-  AllocInst(std::shared_ptr<Value> res, std::shared_ptr<Type> t)
-      : result(std::move(res)), type(std::move(t)) {}
+  AllocInst(ValueId res, std::shared_ptr<Type> t)
+      : result(res), type(std::move(t)) {}
   OpCode getOpCode() const override { return OpCode::Alloc; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
+  ValueId getResult() const { return result; }
   const std::shared_ptr<Type> &getAllocatedType() const { return type; }
-  std::string toString() const override {
-    return result->getName() + " = alloc " + type->toString();
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = alloc " + type->toString();
   }
 };
 
 class CmpInst : public Instruction {
   std::string predicate;
-  std::shared_ptr<Value> result, lhs, rhs;
+  ValueId result, lhs, rhs;
 
 public:
-  CmpInst(std::string pred, std::shared_ptr<Value> res,
-          std::shared_ptr<Value> l, std::shared_ptr<Value> r)
-      : predicate(std::move(pred)), result(std::move(res)), lhs(std::move(l)),
-        rhs(std::move(r)) {}
+  CmpInst(std::string pred, ValueId res, ValueId l, ValueId r)
+      : predicate(std::move(pred)), result(res), lhs(l), rhs(r) {}
   OpCode getOpCode() const override { return OpCode::Cmp; }
   const std::string &getPredicate() const { return predicate; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getLhs() const { return lhs; }
-  const std::shared_ptr<Value> &getRhs() const { return rhs; }
-  std::string toString() const override {
-    return result->getName() + " = icmp " + predicate + " " +
-           lhs->getTypeName() + " " + lhs->getName() + ", " + rhs->getName();
+  ValueId getResult() const { return result; }
+  ValueId getLhs() const { return lhs; }
+  ValueId getRhs() const { return rhs; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = icmp " + predicate + " " +
+           values[lhs].getTypeName() + " " + values[lhs].getName() + ", " +
+           values[rhs].getName();
   }
 };
 
 class ClassIsInst : public Instruction {
-  std::shared_ptr<Value> result, object;
+  ValueId result, object;
   std::shared_ptr<ClassType> targetType;
 
 public:
-  ClassIsInst(std::shared_ptr<Value> res, std::shared_ptr<Value> value,
-              std::shared_ptr<ClassType> target)
-      : result(std::move(res)), object(std::move(value)),
-        targetType(std::move(target)) {}
+  ClassIsInst(ValueId res, ValueId value, std::shared_ptr<ClassType> target)
+      : result(res), object(value), targetType(std::move(target)) {}
   OpCode getOpCode() const override { return OpCode::ClassIs; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getObject() const { return object; }
+  ValueId getResult() const { return result; }
+  ValueId getObject() const { return object; }
   const std::shared_ptr<ClassType> &getTargetType() const { return targetType; }
-  std::string toString() const override {
-    return result->getName() + " = classis " + object->getName() + ", " +
-           targetType->getName();
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = classis " +
+           values[object].getName() + ", " + targetType->getName();
   }
 };
 
 class GetElementPtrInst : public Instruction {
-  std::shared_ptr<Value> result, ptr;
+  ValueId result, ptr;
   int index;
-  std::shared_ptr<Value> indexValue;
+  ValueId indexValue = NoValue;
 
 public:
-  GetElementPtrInst(std::shared_ptr<Value> res, std::shared_ptr<Value> p,
-                    int idx)
-      : result(std::move(res)), ptr(std::move(p)), index(idx) {}
-  GetElementPtrInst(std::shared_ptr<Value> res, std::shared_ptr<Value> p,
-                    std::shared_ptr<Value> idx)
-      : result(std::move(res)), ptr(std::move(p)), index(0),
-        indexValue(std::move(idx)) {}
+  GetElementPtrInst(ValueId res, ValueId p, int idx)
+      : result(res), ptr(p), index(idx) {}
+  GetElementPtrInst(ValueId res, ValueId p, ValueId idx)
+      : result(res), ptr(p), index(0), indexValue(idx) {}
   OpCode getOpCode() const override { return OpCode::GetElementPtr; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getPointer() const { return ptr; }
+  ValueId getResult() const { return result; }
+  ValueId getPointer() const { return ptr; }
   int getIndex() const { return index; }
-  const std::shared_ptr<Value> &getIndexValue() const { return indexValue; }
-  std::string toString() const override {
-    return result->getName() + " = getelementptr " + ptr->getTypeName() + " " +
-           ptr->getName() + ", " +
-           (indexValue ? indexValue->getTypeName() + " " + indexValue->getName()
-                       : "i32 " + std::to_string(index));
+  ValueId getIndexValue() const { return indexValue; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = getelementptr " +
+           values[ptr].getTypeName() + " " + values[ptr].getName() + ", " +
+           (indexValue != NoValue ? values[indexValue].getTypeName() + " " +
+                                        values[indexValue].getName()
+                                  : "i32 " + std::to_string(index));
   }
 };
 
 class PhiInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
+  ValueId result;
+  std::vector<std::pair<std::string, ValueId>> incoming;
+  std::vector<BlockId> incomingBlocks;
 
 public:
-  PhiInst(std::shared_ptr<Value> res,
-          std::vector<std::pair<std::string, std::shared_ptr<Value>>> inc)
-      : result(std::move(res)), incoming(std::move(inc)) {}
+  PhiInst(ValueId res, std::vector<std::pair<std::string, ValueId>> inc)
+      : result(res), incoming(std::move(inc)),
+        incomingBlocks(incoming.size(), NoBlock) {}
   OpCode getOpCode() const override { return OpCode::Phi; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::vector<std::pair<std::string, std::shared_ptr<Value>>> &
-  getIncoming() const {
+  ValueId getResult() const { return result; }
+  const std::vector<std::pair<std::string, ValueId>> &getIncoming() const {
     return incoming;
   }
-  void replaceIncomingLabel(const std::string &from, std::string to) {
-    for (auto &[label, value] : incoming) {
-      (void)value;
-      if (label == from) {
-        label = std::move(to);
+  BlockId getIncomingBlock(size_t index) const {
+    return incomingBlocks[index];
+  }
+  void setIncomingBlock(size_t index, BlockId block) {
+    incomingBlocks[index] = block;
+  }
+  /// @brief The value flowing in from @p block, or null if no edge from it
+  /// is listed.
+  const ValueId *findIncoming(BlockId block) const {
+    for (size_t i = 0; i < incoming.size(); ++i) {
+      if (incomingBlocks[i] == block) {
+        return &incoming[i].second;
+      }
+    }
+    return nullptr;
+  }
+  void replaceIncomingBlock(BlockId from, const std::string &to,
+                            BlockId toBlock) {
+    for (size_t i = 0; i < incoming.size(); ++i) {
+      if (incomingBlocks[i] == from) {
+        incoming[i].first = to;
+        incomingBlocks[i] = toBlock;
         return;
       }
     }
   }
-  std::string toString() const override {
-    std::string s = result->getName() + " = phi " + result->getTypeName() + " ";
+  std::string toString(const ValueTable &values) const override {
+    std::string s = values[result].getName() + " = phi " +
+                    values[result].getTypeName() + " ";
     for (size_t i = 0; i < incoming.size(); ++i) {
-      std::string valName =
-          incoming[i].second ? incoming[i].second->getName() : "undef";
+      std::string valName = incoming[i].second != NoValue
+                                ? values[incoming[i].second].getName()
+                                : "undef";
       s += "[ " + valName + ", %" + incoming[i].first + " ]" +
            (i < incoming.size() - 1 ? ", " : "");
     }
@@ -457,58 +491,57 @@ public:
 };
 
 class CastInst : public Instruction {
-  std::shared_ptr<Value> result, src;
+  ValueId result, src;
   std::shared_ptr<Type> targetType;
 
 public:
-  CastInst(std::shared_ptr<Value> res, std::shared_ptr<Value> s,
-           std::shared_ptr<Type> t)
-      : result(std::move(res)), src(std::move(s)), targetType(std::move(t)) {}
+  CastInst(ValueId res, ValueId s, std::shared_ptr<Type> t)
+      : result(res), src(s), targetType(std::move(t)) {}
   OpCode getOpCode() const override { return OpCode::Cast; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getSource() const { return src; }
+  ValueId getResult() const { return result; }
+  ValueId getSource() const { return src; }
   const std::shared_ptr<Type> &getTargetType() const { return targetType; }
-  std::string toString() const override {
-    return result->getName() + " = cast " + src->getTypeName() + " " +
-           src->getName() + " to " + targetType->toString();
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = cast " + values[src].getTypeName() +
+           " " + values[src].getName() + " to " + targetType->toString();
   }
 };
 
 class WeakLockInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::shared_ptr<Value> weakValue;
+  ValueId result;
+  ValueId weakValue;
 
 public:
-  WeakLockInst(std::shared_ptr<Value> res, std::shared_ptr<Value> value)
-      : result(std::move(res)), weakValue(std::move(value)) {}
+  WeakLockInst(ValueId res, ValueId value) : result(res), weakValue(value) {}
   OpCode getOpCode() const override { return OpCode::WeakLock; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getWeakValue() const { return weakValue; }
-  std::string toString() const override {
-    return result->getName() + " = weak.lock " + weakValue->getTypeName() +
-           " " + weakValue->getName();
+  ValueId getResult() const { return result; }
+  ValueId getWeakValue() const { return weakValue; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = weak.lock " +
+           values[weakValue].getTypeName() + " " +
+           values[weakValue].getName();
   }
 };
 
 class WeakAliveInst : public Instruction {
-  std::shared_ptr<Value> result;
-  std::shared_ptr<Value> weakValue;
+  ValueId result;
+  ValueId weakValue;
 
 public:
-  WeakAliveInst(std::shared_ptr<Value> res, std::shared_ptr<Value> value)
-      : result(std::move(res)), weakValue(std::move(value)) {}
+  WeakAliveInst(ValueId res, ValueId value) : result(res), weakValue(value) {}
   OpCode getOpCode() const override { return OpCode::WeakAlive; }
-  const std::shared_ptr<Value> &getResult() const { return result; }
-  const std::shared_ptr<Value> &getWeakValue() const { return weakValue; }
-  std::string toString() const override {
-    return result->getName() + " = weak.alive " + weakValue->getTypeName() +
-           " " + weakValue->getName();
+  ValueId getResult() const { return result; }
+  ValueId getWeakValue() const { return weakValue; }
+  std::string toString(const ValueTable &values) const override {
+    return values[result].getName() + " = weak.alive " +
+           values[weakValue].getTypeName() + " " +
+           values[weakValue].getName();
   }
 };
 
 struct AsmOperand {
   std::string constraint;
-  std::shared_ptr<Value> value;
+  ValueId value;
   std::shared_ptr<Type> valueType;
 };
 
@@ -528,7 +561,7 @@ public:
   const std::vector<AsmOperand> &getOutputs() const { return outputs; }
   const std::vector<AsmOperand> &getInputs() const { return inputs; }
   const std::vector<std::string> &getClobbers() const { return clobbers; }
-  std::string toString() const override {
+  std::string toString(const ValueTable &values) const override {
     std::string s = "asm \"" + assembly + "\"";
     auto appendOperands = [&](const char *label,
                               const std::vector<AsmOperand> &ops) {
@@ -537,7 +570,9 @@ public:
       s += std::string(" ") + label + " ";
       for (size_t i = 0; i < ops.size(); ++i) {
         s += "\"" + ops[i].constraint + "\"(" +
-             (ops[i].value ? ops[i].value->getName() : "?") + ")" +
+             (ops[i].value != NoValue ? values[ops[i].value].getName()
+                                      : "?") +
+             ")" +
              (i + 1 < ops.size() ? ", " : "");
       }
     };
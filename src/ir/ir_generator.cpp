@@ -47,21 +47,21 @@ bool isTerminated(const BasicBlock *block) {
          opcode == OpCode::CondBr;
 }
 
-ValueOwnership ownershipForPhi(
-    const std::shared_ptr<Type> &type,
-    const std::vector<std::pair<std::string, std::shared_ptr<Value>>>
-        &incoming) {
+ValueOwnership
+ownershipForPhi(const ValueTable &values, const std::shared_ptr<Type> &type,
+                const std::vector<std::pair<std::string, ValueId>> &incoming) {
   if (!containsManagedValues(type) || incoming.empty()) {
     return ValueOwnership::Borrowed;
   }
-  const auto ownership = incoming.front().second
-                             ? incoming.front().second->getOwnership()
-                             : ValueOwnership::Borrowed;
+  const Value *first = values.get(incoming.front().second);
+  const auto ownership =
+      first ? first->getOwnership() : ValueOwnership::Borrowed;
   if (!isOwned(ownership)) {
     return ValueOwnership::Borrowed;
   }
-  for (const auto &[label, value] : incoming) {
+  for (const auto &[label, id] : incoming) {
     (void)label;
+    const Value *value = values.get(id);
     if (!value || value->getOwnership() != ownership) {
       return ValueOwnership::Borrowed;
     }
@@ -69,7 +69,7 @@ ValueOwnership ownershipForPhi(
   return ownership;
 }
 
-ValueOwnership ownershipForCast(const std::shared_ptr<Value> &source,
+ValueOwnership ownershipForCast(const Value &source,
                                 const std::shared_ptr<Type> &targetType) {
   if (!targetType || !containsManagedValues(targetType)) {
     return ValueOwnership::Borrowed;
@@ -77,8 +77,8 @@ ValueOwnership ownershipForCast(const std::shared_ptr<Value> &source,
   if (targetType->getIntrinsicKind() == IntrinsicTypeKind::String) {
     return ValueOwnership::OwnedStrong;
   }
-  return source && isOwned(source->getOwnership()) ? source->getOwnership()
-                                                   : ValueOwnership::Borrowed;
+  return isOwned(source.getOwnership()) ? source.getOwnership()
+                                        : ValueOwnership::Borrowed;
 }
 
 ParameterOwnership parameterOwnershipFor(const sema::FunctionSymbol &function,
@@ -109,28 +109,28 @@ ParameterEscape parameterEscapeFor(const sema::FunctionSymbol &function,
 }
 } // namespace
 
-std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
+ValueId BoundIRGenerator::lowerConstantExpression(
     const sema::BoundExpression &expression) {
   if (!sema::ConstantEvaluator::isConstant(expression)) {
-    return nullptr;
+    return NoValue;
   }
   std::set<const sema::VariableSymbol *> resolvingConstants;
   return lowerConstantExpression(expression, resolvingConstants);
 }
 
-std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
+ValueId BoundIRGenerator::lowerConstantExpression(
     const sema::BoundExpression &expression,
     std::set<const sema::VariableSymbol *> &resolvingConstants) {
   if (auto unary =
           dynamic_cast<const sema::BoundUnaryExpression *>(&expression)) {
     if (unary->op != "&") {
-      return nullptr;
+      return NoValue;
     }
 
     if (auto variable = dynamic_cast<const sema::BoundVariableExpression *>(
             unary->expr.get())) {
-      return std::make_shared<GlobalAddress>(variable->symbol->linkName,
-                                             unary->type);
+      return values().add<GlobalAddress>(variable->symbol->linkName,
+                                         unary->type);
     }
 
     if (auto index =
@@ -139,23 +139,23 @@ std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
           index->left.get());
       auto indexValue =
           lowerConstantExpression(*index->index, resolvingConstants);
-      auto constantIndex = std::dynamic_pointer_cast<Constant>(indexValue);
+      auto constantIndex = valueAs<Constant>(indexValue);
       if (!variable || !constantIndex) {
-        return nullptr;
+        return NoValue;
       }
       try {
-        return std::make_shared<GlobalAddress>(
+        return values().add<GlobalAddress>(
             variable->symbol->linkName, unary->type,
             static_cast<size_t>(std::stoull(constantIndex->getLiteral())));
       } catch (const std::exception &) {
-        return nullptr;
+        return NoValue;
       }
     }
-    return nullptr;
+    return NoValue;
   }
 
   if (auto literal = dynamic_cast<const sema::BoundLiteral *>(&expression)) {
-    return std::make_shared<Constant>(literal->value, literal->type);
+    return createConstant(literal->value, literal->type);
   }
 
   if (auto variable =
@@ -163,24 +163,24 @@ std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
     auto symbol = variable->symbol;
     if (symbol && symbol->isCompileTimeConstant() && symbol->constant_value) {
       if (!resolvingConstants.insert(symbol.get()).second) {
-        return nullptr;
+        return NoValue;
       }
       auto value =
           lowerConstantExpression(*symbol->constant_value, resolvingConstants);
       resolvingConstants.erase(symbol.get());
       return value;
     }
-    return nullptr;
+    return NoValue;
   }
 
   if (auto binary =
           dynamic_cast<const sema::BoundBinaryExpression *>(&expression)) {
     auto left = lowerConstantExpression(*binary->left, resolvingConstants);
     auto right = lowerConstantExpression(*binary->right, resolvingConstants);
-    auto leftConstant = std::dynamic_pointer_cast<Constant>(left);
-    auto rightConstant = std::dynamic_pointer_cast<Constant>(right);
+    auto leftConstant = valueAs<Constant>(left);
+    auto rightConstant = valueAs<Constant>(right);
     if (!leftConstant || !rightConstant) {
-      return nullptr;
+      return NoValue;
     }
 
     try {
@@ -197,22 +197,21 @@ std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
         else if (binary->op == "/" && rhs != 0.0)
           result = lhs / rhs;
         if (result) {
-          return std::make_shared<Constant>(std::to_string(*result),
-                                            binary->type);
+          return createConstant(std::to_string(*result), binary->type);
         }
-        return nullptr;
+        return NoValue;
       }
 
       if ((binary->type->getIntrinsicKind() == IntrinsicTypeKind::String ||
            binary->type->getIntrinsicKind() == IntrinsicTypeKind::StringView) &&
           binary->op == "+") {
-        return std::make_shared<Constant>(leftConstant->getLiteral() +
-                                              rightConstant->getLiteral(),
-                                          binary->type);
+        return createConstant(leftConstant->getLiteral() +
+                                  rightConstant->getLiteral(),
+                              binary->type);
       }
 
       if (!binary->type->isInteger()) {
-        return nullptr;
+        return NoValue;
       }
       const int64_t lhs = std::stoll(leftConstant->getLiteral(), nullptr, 0);
       const int64_t rhs = std::stoll(rightConstant->getLiteral(), nullptr, 0);
@@ -238,47 +237,44 @@ std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
       else if (binary->op == ">>" && rhs >= 0)
         result = lhs >> rhs;
       if (result) {
-        return std::make_shared<Constant>(std::to_string(*result),
-                                          binary->type);
+        return createConstant(std::to_string(*result), binary->type);
       }
     } catch (const std::exception &) {
     }
-    return nullptr;
+    return NoValue;
   }
 
   if (auto unary =
           dynamic_cast<const sema::BoundUnaryExpression *>(&expression)) {
     auto value = lowerConstantExpression(*unary->expr, resolvingConstants);
-    auto constant = std::dynamic_pointer_cast<Constant>(value);
+    auto constant = valueAs<Constant>(value);
     if (!constant || !unary->type->isInteger()) {
-      return nullptr;
+      return NoValue;
     }
     try {
       const int64_t operand = std::stoll(constant->getLiteral(), nullptr, 0);
       if (unary->op == "-") {
-        return std::make_shared<Constant>(std::to_string(-operand),
-                                          unary->type);
+        return createConstant(std::to_string(-operand), unary->type);
       }
       if (unary->op == "~") {
-        return std::make_shared<Constant>(std::to_string(~operand),
-                                          unary->type);
+        return createConstant(std::to_string(~operand), unary->type);
       }
     } catch (const std::exception &) {
     }
-    return nullptr;
+    return NoValue;
   }
 
   if (auto array = dynamic_cast<const sema::BoundArrayLiteral *>(&expression)) {
-    std::vector<std::shared_ptr<Value>> elements;
+    std::vector<const Value *> elements;
     elements.reserve(array->elements.size());
     for (const auto &element : array->elements) {
       auto value = lowerConstantExpression(*element, resolvingConstants);
-      if (!value) {
-        return nullptr;
+      if (value == NoValue) {
+        return NoValue;
       }
-      elements.push_back(std::move(value));
+      elements.push_back(&valueOf(value));
     }
-    return std::make_shared<ArrayConstant>(array->type, std::move(elements));
+    return values().add<ArrayConstant>(array->type, std::move(elements));
   }
 
   if (auto record =
@@ -287,30 +283,29 @@ std::shared_ptr<Value> BoundIRGenerator::lowerConstantExpression(
     fields.reserve(record->fields.size());
     for (const auto &field : record->fields) {
       auto value = lowerConstantExpression(*field.second, resolvingConstants);
-      if (!value) {
-        return nullptr;
+      if (value == NoValue) {
+        return NoValue;
       }
-      fields.push_back({field.first, std::move(value)});
+      fields.push_back({field.first, &valueOf(value)});
     }
-    return std::make_shared<AggregateConstant>(record->type, std::move(fields));
+    return values().add<AggregateConstant>(record->type, std::move(fields));
   }
 
   if (auto cast = dynamic_cast<const sema::BoundCast *>(&expression)) {
     auto value = lowerConstantExpression(*cast->expression, resolvingConstants);
-    if (auto constant = std::dynamic_pointer_cast<Constant>(value)) {
-      return std::make_shared<Constant>(constant->getLiteral(), cast->type);
+    if (auto constant = valueAs<Constant>(value)) {
+      return createConstant(constant->getLiteral(), cast->type);
     }
     return value;
   }
 
-  return nullptr;
+  return NoValue;
 }
 
-std::shared_ptr<Value> BoundIRGenerator::emitFailableFieldLoad(
-    const std::shared_ptr<Value> &value, int fieldIndex,
-    const std::shared_ptr<Type> &fieldType) {
+ValueId BoundIRGenerator::emitFailableFieldLoad(
+    ValueId value, int fieldIndex, const std::shared_ptr<Type> &fieldType) {
   if (fieldType && fieldType->getKind() == TypeKind::Void) {
-    return std::make_shared<Constant>("0", fieldType);
+    return createConstant("0", fieldType);
   }
   auto fieldAddr = createRegister(std::make_shared<PointerType>(fieldType));
   currentBlock_->addInstruction(
@@ -329,22 +324,19 @@ std::shared_ptr<Value> BoundIRGenerator::emitFailableFieldLoad(
   return copied;
 }
 
-std::shared_ptr<Value>
-BoundIRGenerator::emitFailableOk(const std::shared_ptr<Value> &value) {
+ValueId BoundIRGenerator::emitFailableOk(ValueId value) {
   return emitFailableFieldLoad(value, FailableTypeLayout::OkField,
                                std::make_shared<PrimitiveType>(TypeKind::Bool));
 }
 
-std::shared_ptr<Value>
-BoundIRGenerator::emitFailableValue(const std::shared_ptr<Value> &value) {
-  auto layout = getFailableTypeLayout(value->getType());
+ValueId BoundIRGenerator::emitFailableValue(ValueId value) {
+  auto layout = getFailableTypeLayout(typeOf(value));
   return emitFailableFieldLoad(value, FailableTypeLayout::ValueField,
                                layout ? layout->valueType : nullptr);
 }
 
-std::shared_ptr<Value>
-BoundIRGenerator::emitFailableError(const std::shared_ptr<Value> &value) {
-  auto layout = getFailableTypeLayout(value->getType());
+ValueId BoundIRGenerator::emitFailableError(ValueId value) {
+  auto layout = getFailableTypeLayout(typeOf(value));
   return emitFailableFieldLoad(value, FailableTypeLayout::ErrorField,
                                layout ? layout->errorType : nullptr);
 }
@@ -410,7 +402,7 @@ void BoundIRGenerator::visit(sema::BoundFunctionDeclaration &node) {
     const size_t parameterIndex = currentFunction_->arguments.size();
     const auto parameterOwnership =
         parameterOwnershipFor(*symbol, parameterIndex);
-    auto arg = std::make_shared<Argument>(
+    auto arg = values().add<Argument>(
         paramSymbol->name, argType, paramSymbol->is_ref,
         paramSymbol->is_variadic_pack, paramSymbol->variadic_element_type,
         parameterOwnership, parameterEscapeFor(*symbol, parameterIndex));
@@ -418,7 +410,7 @@ void BoundIRGenerator::visit(sema::BoundFunctionDeclaration &node) {
         !symbol->ownerTypeCodegenName.empty() && paramSymbol->name == "self";
     if (!paramSymbol->is_ref && !paramSymbol->is_variadic_pack &&
         !borrowedSelf && containsManagedValues(argType)) {
-      arg->setOwnership(ownedForType(argType));
+      valueOf(arg).setOwnership(ownedForType(argType));
     }
     currentFunction_->arguments.push_back(arg);
 
@@ -442,8 +434,7 @@ void BoundIRGenerator::visit(sema::BoundFunctionDeclaration &node) {
     if (symbol->returnType->getKind() == TypeKind::Void) {
       emitReturn();
     } else {
-      auto dummy = std::make_shared<Constant>("0", symbol->returnType);
-      emitReturn(dummy);
+      emitReturn(createConstant("0", symbol->returnType));
     }
   }
 
@@ -468,7 +459,7 @@ void BoundIRGenerator::visit(sema::BoundExternalFunctionDeclaration &node) {
                        ? std::static_pointer_cast<Type>(
                              std::make_shared<PointerType>(paramSymbol->type))
                        : paramSymbol->type;
-    auto arg = std::make_shared<Argument>(
+    auto arg = func->values.add<Argument>(
         paramSymbol->name, argType, paramSymbol->is_ref,
         paramSymbol->is_variadic_pack, paramSymbol->variadic_element_type,
         ParameterOwnership::Borrow,
@@ -508,7 +499,7 @@ void BoundIRGenerator::visit(sema::BoundBlock &node) {
         continue;
       }
       currentBlock_->addInstruction(std::make_unique<StoreInst>(
-          std::make_shared<Constant>("null", (*it)->type), symbolIt->second,
+          createConstant("null", (*it)->type), symbolIt->second,
           StoreMode::Assign));
     }
   }
@@ -518,17 +509,20 @@ void BoundIRGenerator::visit(sema::BoundVariableDeclaration &node) {
   auto type = node.symbol->type;
 
   if (!currentFunction_) {
+    auto &globals = module_->values;
     if (node.symbol->is_external) {
-      auto global = std::make_shared<Global>(
-          node.symbol->name, node.symbol->linkName, type, nullptr, false);
-      module_->addExternalGlobal(global);
+      auto global = globals.add<Global>(node.symbol->name,
+                                        node.symbol->linkName,
+                                        std::make_shared<PointerType>(type),
+                                        type);
+      module_->addExternalGlobal(static_cast<Global *>(globals.get(global)));
       globalSymbolMap_[node.symbol] = global;
       return;
     }
-    std::shared_ptr<Value> initializer = nullptr;
+    ValueId initializer = NoValue;
     if (node.initializer) {
       initializer = lowerConstantExpression(*node.initializer);
-      if (!initializer) {
+      if (initializer == NoValue) {
         node.initializer->accept(*this);
         if (!valueStack_.empty()) {
           initializer = valueStack_.top();
@@ -536,10 +530,11 @@ void BoundIRGenerator::visit(sema::BoundVariableDeclaration &node) {
         }
       }
     }
-    auto global = std::make_shared<Global>(
-        node.symbol->name, node.symbol->linkName, type, initializer,
+    auto global = globals.add<Global>(
+        node.symbol->name, node.symbol->linkName,
+        std::make_shared<PointerType>(type), type, globals.get(initializer),
         node.symbol->isCompileTimeConstant());
-    module_->addGlobal(global);
+    module_->addGlobal(static_cast<Global *>(globals.get(global)));
     globalSymbolMap_[node.symbol] = global;
     return;
   }
@@ -558,7 +553,7 @@ void BoundIRGenerator::visit(sema::BoundVariableDeclaration &node) {
       evaluateAsAddress_ = old;
       auto addr = valueStack_.top();
       valueStack_.pop();
-      emitInitializationStore(std::move(addr), refReg);
+      emitInitializationStore(addr, refReg);
     }
     return;
   }
@@ -572,12 +567,12 @@ void BoundIRGenerator::visit(sema::BoundVariableDeclaration &node) {
     auto val = valueStack_.top();
     valueStack_.pop();
 
-    emitInitializationStore(std::move(val), reg);
+    emitInitializationStore(val, reg);
   }
 }
 
 void BoundIRGenerator::visit(sema::BoundReturnStatement &node) {
-  std::shared_ptr<Value> val = nullptr;
+  ValueId val = NoValue;
   if (node.expression) {
     bool oldEvaluateAsAddress = evaluateAsAddress_;
     if (node.returnsRef) {
@@ -596,7 +591,7 @@ void BoundIRGenerator::visit(sema::BoundFailStatement &node) {
     return;
   }
 
-  std::shared_ptr<Value> errValue = nullptr;
+  ValueId errValue = NoValue;
   if (node.errorExpression) {
     node.errorExpression->accept(*this);
     errValue = valueStack_.top();
@@ -617,7 +612,7 @@ void BoundIRGenerator::visit(sema::BoundFailStatement &node) {
   currentBlock_->addInstruction(std::make_unique<GetElementPtrInst>(
       okAddr, allocaReg, FailableTypeLayout::OkField));
   currentBlock_->addInstruction(std::make_unique<StoreInst>(
-      std::make_shared<Constant>(
+      createConstant(
           "false", std::make_shared<PrimitiveType>(TypeKind::Bool)),
       okAddr, StoreMode::Assign));
 
@@ -626,21 +621,19 @@ void BoundIRGenerator::visit(sema::BoundFailStatement &node) {
       valueAddr, allocaReg, FailableTypeLayout::ValueField));
   if (valueType && valueType->getKind() != TypeKind::Void) {
     // The value field is unused on the error path; zero it without ARC.
-    currentBlock_->addInstruction(
-        std::make_unique<StoreInst>(std::make_shared<Constant>("0", valueType),
-                                    valueAddr, StoreMode::RawInitialize));
+    currentBlock_->addInstruction(std::make_unique<StoreInst>(
+        createConstant("0", valueType), valueAddr, StoreMode::RawInitialize));
   }
 
   auto errAddr = createRegister(std::make_shared<PointerType>(errorType));
   currentBlock_->addInstruction(std::make_unique<GetElementPtrInst>(
       errAddr, allocaReg, FailableTypeLayout::ErrorField));
-  if (errValue) {
+  if (errValue != NoValue) {
     currentBlock_->addInstruction(
         std::make_unique<StoreInst>(errValue, errAddr, StoreMode::Assign));
   } else {
-    currentBlock_->addInstruction(
-        std::make_unique<StoreInst>(std::make_shared<Constant>("0", errorType),
-                                    errAddr, StoreMode::Assign));
+    currentBlock_->addInstruction(std::make_unique<StoreInst>(
+        createConstant("0", errorType), errAddr, StoreMode::Assign));
   }
 
   auto loaded = createRegister(failableType);
@@ -665,10 +658,10 @@ void BoundIRGenerator::visit(sema::BoundAssignment &node) {
   valueStack_.pop();
 
   compoundTargetAddr_ = oldCompoundTargetAddr;
-  if (val && containsManagedValues(val->getType())) {
-    auto copied = createRegister(val->getType(), ownedForType(val->getType()));
+  if (val != NoValue && containsManagedValues(valueOf(val).getType())) {
+    auto copied = createRegister(typeOf(val), ownedForType(typeOf(val)));
     currentBlock_->addInstruction(std::make_unique<CopyInst>(copied, val));
-    val = std::move(copied);
+    val = copied;
   }
   currentBlock_->addInstruction(
       std::make_unique<StoreInst>(val, target, StoreMode::Assign));
@@ -688,21 +681,21 @@ void BoundIRGenerator::visit(sema::BoundExpressionStatement &node) {
 }
 
 void BoundIRGenerator::visit(sema::BoundLiteral &node) {
-  valueStack_.push(std::make_shared<Constant>(node.value, node.type));
+  valueStack_.push(createConstant(node.value, node.type));
 }
 
 void BoundIRGenerator::visit(sema::BoundVariableExpression &node) {
-  std::shared_ptr<Value> addr = nullptr;
+  ValueId addr = NoValue;
   auto localIt = symbolMap_.find(node.symbol);
   if (localIt != symbolMap_.end()) {
     addr = localIt->second;
   } else {
     auto globalIt = globalSymbolMap_.find(node.symbol);
     if (globalIt != globalSymbolMap_.end()) {
-      addr = globalIt->second;
+      addr = importGlobal(globalIt->second);
     }
   }
-  if (!addr) {
+  if (addr == NoValue) {
     std::cerr << "Error: Symbol " << node.symbol->name
               << " not found in IR symbol map\n";
     return;
@@ -725,7 +718,7 @@ void BoundIRGenerator::visit(sema::BoundVariableExpression &node) {
     return;
   }
   auto storedType =
-      std::static_pointer_cast<PointerType>(addr->getType())->getBaseType();
+      static_cast<PointerType *>(valueOf(addr).getType())->getBaseType();
   auto loaded = createRegister(storedType);
   currentBlock_->addInstruction(std::make_unique<LoadInst>(loaded, addr));
   if (storedType->toString() == node.type->toString()) {
@@ -777,12 +770,12 @@ void BoundIRGenerator::visit(sema::BoundBinaryExpression &node) {
     currentFunction_->addBlock(std::move(mergeBlock));
     currentBlock_ = mergeBlockPtr;
 
-    std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
-    incoming.push_back(
-        {leftBlockLabel, std::make_shared<Constant>("false", node.type)});
+    std::vector<std::pair<std::string, ValueId>> incoming;
+    incoming.push_back({leftBlockLabel, createConstant("false", node.type)});
     incoming.push_back({actualRhsBlockLabel, rightVal});
 
-    auto res = createRegister(node.type, ownershipForPhi(node.type, incoming));
+    auto res = createRegister(
+        node.type, ownershipForPhi(values(), node.type, incoming));
     currentBlock_->addInstruction(std::make_unique<PhiInst>(res, incoming));
     valueStack_.push(res);
     return;
@@ -816,12 +809,12 @@ void BoundIRGenerator::visit(sema::BoundBinaryExpression &node) {
     currentFunction_->addBlock(std::move(mergeBlock));
     currentBlock_ = mergeBlockPtr;
 
-    std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
-    incoming.push_back(
-        {leftBlockLabel, std::make_shared<Constant>("true", node.type)});
+    std::vector<std::pair<std::string, ValueId>> incoming;
+    incoming.push_back({leftBlockLabel, createConstant("true", node.type)});
     incoming.push_back({actualRhsBlockLabel, rightVal});
 
-    auto res = createRegister(node.type, ownershipForPhi(node.type, incoming));
+    auto res = createRegister(
+        node.type, ownershipForPhi(values(), node.type, incoming));
     currentBlock_->addInstruction(std::make_unique<PhiInst>(res, incoming));
     valueStack_.push(res);
     return;
@@ -933,16 +926,17 @@ void BoundIRGenerator::visit(sema::BoundTernaryExpression &node) {
   currentFunction_->addBlock(std::move(mergeBlock));
   currentBlock_ = mergeBlockPtr;
 
-  std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
+  std::vector<std::pair<std::string, ValueId>> incoming;
   incoming.push_back({actualThenLabel, thenVal});
   incoming.push_back({actualElseLabel, elseVal});
-  auto res = createRegister(node.type, ownershipForPhi(node.type, incoming));
+  auto res = createRegister(
+      node.type, ownershipForPhi(values(), node.type, incoming));
   currentBlock_->addInstruction(std::make_unique<PhiInst>(res, incoming));
   valueStack_.push(res);
 }
 
 void BoundIRGenerator::visit(sema::BoundFunctionCall &node) {
-  std::vector<std::shared_ptr<Value>> args;
+  std::vector<ValueId> args;
   for (size_t i = 0; i < node.arguments.size(); ++i) {
     bool oldEvaluateAsAddress = evaluateAsAddress_;
     evaluateAsAddress_ =
@@ -953,10 +947,10 @@ void BoundIRGenerator::visit(sema::BoundFunctionCall &node) {
     valueStack_.pop();
     const auto parameterOwnership = parameterOwnershipFor(*node.symbol, i);
     prepareCallArgument(argument, parameterOwnership);
-    args.push_back(std::move(argument));
+    args.push_back(argument);
   }
 
-  std::shared_ptr<Value> variadicPack = nullptr;
+  ValueId variadicPack = NoValue;
   if (node.variadicPack) {
     node.variadicPack->accept(*this);
     variadicPack = valueStack_.top();
@@ -987,8 +981,8 @@ void BoundIRGenerator::visit(sema::BoundFunctionCall &node) {
 
 void BoundIRGenerator::visit(sema::BoundFunctionReference &node) {
   auto functionType = std::static_pointer_cast<FunctionPointerType>(node.type);
-  valueStack_.push(std::make_shared<FunctionReference>(
-      node.symbol->linkName, std::move(functionType)));
+  valueStack_.push(values().add<FunctionReference>(node.symbol->linkName,
+                                                   functionType));
 }
 
 void BoundIRGenerator::visit(sema::BoundIndirectCall &node) {
@@ -996,9 +990,9 @@ void BoundIRGenerator::visit(sema::BoundIndirectCall &node) {
   auto calleeVal = valueStack_.top();
   valueStack_.pop();
 
-  std::vector<std::shared_ptr<Value>> args;
-  const auto functionType =
-      std::static_pointer_cast<FunctionPointerType>(calleeVal->getType());
+  std::vector<ValueId> args;
+  const auto *functionType =
+      static_cast<FunctionPointerType *>(valueOf(calleeVal).getType());
   for (size_t i = 0; i < node.arguments.size(); ++i) {
     auto &arg = node.arguments[i];
     arg->accept(*this);
@@ -1009,7 +1003,7 @@ void BoundIRGenerator::visit(sema::BoundIndirectCall &node) {
             ? functionType->getParameterOwnership()[i]
             : ParameterOwnership::Borrow;
     prepareCallArgument(argument, parameterOwnership);
-    args.push_back(std::move(argument));
+    args.push_back(argument);
   }
 
   const bool returnsRef = functionType->returnsRef();
@@ -1030,76 +1024,91 @@ void BoundIRGenerator::visit(sema::BoundIndirectCall &node) {
   }
 }
 
-std::shared_ptr<Value>
-BoundIRGenerator::createRegister(std::shared_ptr<Type> type,
-                                 ValueOwnership ownership) {
+ValueId BoundIRGenerator::createRegister(std::shared_ptr<Type> type,
+                                         ValueOwnership ownership) {
   auto result =
-      std::make_shared<Register>(std::to_string(nextRegisterId_++), type);
-  result->setOwnership(ownership);
+      values().add<Register>(std::to_string(nextRegisterId_++), type);
+  valueOf(result).setOwnership(ownership);
   return result;
 }
 
-void BoundIRGenerator::emitInitializationStore(
-    std::shared_ptr<Value> value, std::shared_ptr<Value> destination) {
-  if (value && containsManagedValues(value->getType())) {
-    const auto resultOwnership = isOwned(value->getOwnership())
-                                     ? value->getOwnership()
-                                     : ownedForType(value->getType());
-    auto prepared = createRegister(value->getType(), resultOwnership);
-    if (isOwned(value->getOwnership())) {
+ValueId BoundIRGenerator::createConstant(std::string literal,
+                                         std::shared_ptr<Type> type) {
+  return values().add<Constant>(std::move(literal), type);
+}
+
+ValueId BoundIRGenerator::importGlobal(ValueId global) {
+  if (!currentFunction_) {
+    return global;
+  }
+  return currentFunction_->values.reference(*module_->values.get(global),
+                                            module_->values);
+}
+
+void BoundIRGenerator::emitInitializationStore(ValueId value,
+                                               ValueId destination) {
+  const Value *source = values().get(value);
+  if (source && containsManagedValues(source->getType())) {
+    const auto resultOwnership = isOwned(source->getOwnership())
+                                     ? source->getOwnership()
+                                     : ownedForType(source->getType());
+    auto prepared = createRegister(typeOf(value), resultOwnership);
+    if (isOwned(source->getOwnership())) {
       currentBlock_->addInstruction(
           std::make_unique<MoveInst>(prepared, value));
     } else {
       currentBlock_->addInstruction(
           std::make_unique<CopyInst>(prepared, value));
     }
-    value = std::move(prepared);
+    value = prepared;
   }
-  currentBlock_->addInstruction(std::make_unique<StoreInst>(
-      std::move(value), std::move(destination), StoreMode::Initialize));
+  currentBlock_->addInstruction(
+      std::make_unique<StoreInst>(value, destination, StoreMode::Initialize));
 }
 
-std::shared_ptr<Value>
-BoundIRGenerator::materializeOwnedValue(std::shared_ptr<Value> value) {
-  if (!value || !containsManagedValues(value->getType()) ||
-      isOwned(value->getOwnership())) {
+ValueId BoundIRGenerator::materializeOwnedValue(ValueId value) {
+  const Value *source = values().get(value);
+  if (!source || !containsManagedValues(source->getType()) ||
+      isOwned(source->getOwnership())) {
     return value;
   }
 
-  auto copied =
-      createRegister(value->getType(), ownedForType(value->getType()));
+  auto copied = createRegister(typeOf(value), ownedForType(source->getType()));
   currentBlock_->addInstruction(std::make_unique<CopyInst>(copied, value));
   return copied;
 }
 
 void BoundIRGenerator::prepareCallArgument(
-    std::shared_ptr<Value> &value, ParameterOwnership parameterOwnership) {
-  if (!transfersOwnership(parameterOwnership) || !value ||
-      !containsManagedValues(value->getType())) {
+    ValueId &value, ParameterOwnership parameterOwnership) {
+  const Value *source = values().get(value);
+  if (!transfersOwnership(parameterOwnership) || !source ||
+      !containsManagedValues(source->getType())) {
     return;
   }
 
   const bool moveOwnedValue = parameterOwnership == ParameterOwnership::Sink &&
-                              isOwned(value->getOwnership());
-  const auto resultOwnership =
-      moveOwnedValue ? value->getOwnership() : ownedForType(value->getType());
-  auto prepared = createRegister(value->getType(), resultOwnership);
+                              isOwned(source->getOwnership());
+  const auto resultOwnership = moveOwnedValue
+                                   ? source->getOwnership()
+                                   : ownedForType(source->getType());
+  auto prepared = createRegister(typeOf(value), resultOwnership);
   if (moveOwnedValue) {
     currentBlock_->addInstruction(std::make_unique<MoveInst>(prepared, value));
   } else {
     currentBlock_->addInstruction(std::make_unique<CopyInst>(prepared, value));
   }
-  value = std::move(prepared);
+  value = prepared;
 }
 
-void BoundIRGenerator::emitReturn(std::shared_ptr<Value> value) {
-  if (value && isOwned(value->getOwnership()) &&
-      containsManagedValues(value->getType())) {
-    auto moved = createRegister(value->getType(), value->getOwnership());
+void BoundIRGenerator::emitReturn(ValueId value) {
+  const Value *source = values().get(value);
+  if (source && isOwned(source->getOwnership()) &&
+      containsManagedValues(source->getType())) {
+    auto moved = createRegister(typeOf(value), source->getOwnership());
     currentBlock_->addInstruction(std::make_unique<MoveInst>(moved, value));
-    value = std::move(moved);
+    value = moved;
   }
-  currentBlock_->addInstruction(std::make_unique<ReturnInst>(std::move(value)));
+  currentBlock_->addInstruction(std::make_unique<ReturnInst>(value));
 }
 
 std::string BoundIRGenerator::createBlockLabel(const std::string &prefix) {
@@ -1141,11 +1150,11 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
   // Global initializers are lowered as constants only. Fold unary operators on
   // constants instead of emitting runtime IR outside functions.
   if (!currentFunction_ || !currentBlock_) {
-    if (auto c = std::dynamic_pointer_cast<Constant>(expr)) {
+    if (auto c = valueAs<Constant>(expr)) {
       const auto &lit = c->getLiteral();
 
       if (node.op == "+") {
-        valueStack_.push(c);
+        valueStack_.push(expr);
         return;
       }
 
@@ -1155,8 +1164,7 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
           try {
             if (c->getType() && c->getType()->isFloatingPoint()) {
               auto v = std::stod(lit);
-              valueStack_.push(
-                  std::make_shared<Constant>(std::to_string(-v), node.type));
+              valueStack_.push(createConstant(std::to_string(-v), node.type));
               return;
             }
             if (c->getType() && c->getType()->isInteger()) {
@@ -1164,11 +1172,10 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
                 auto v = std::stoull(lit);
                 auto out = static_cast<int64_t>(-(static_cast<int64_t>(v)));
                 valueStack_.push(
-                    std::make_shared<Constant>(std::to_string(out), node.type));
+                    createConstant(std::to_string(out), node.type));
               } else {
                 auto v = std::stoll(lit);
-                valueStack_.push(
-                    std::make_shared<Constant>(std::to_string(-v), node.type));
+                valueStack_.push(createConstant(std::to_string(-v), node.type));
               }
               return;
             }
@@ -1179,11 +1186,11 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
 
       if (node.op == "!") {
         if (lit == "true") {
-          valueStack_.push(std::make_shared<Constant>("false", node.type));
+          valueStack_.push(createConstant("false", node.type));
           return;
         }
         if (lit == "false") {
-          valueStack_.push(std::make_shared<Constant>("true", node.type));
+          valueStack_.push(createConstant("true", node.type));
           return;
         }
       }
@@ -1193,8 +1200,7 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
             lit[0] != '\'' && lit[0] != '\\') {
           try {
             auto v = std::stoll(lit);
-            valueStack_.push(
-                std::make_shared<Constant>(std::to_string(~v), node.type));
+            valueStack_.push(createConstant(std::to_string(~v), node.type));
             return;
           } catch (...) {
           }
@@ -1212,7 +1218,7 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
   }
 
   if (node.op == "-") {
-    auto zero = std::make_shared<Constant>("0", node.type);
+    auto zero = createConstant("0", node.type);
     auto reg = createRegister(node.type);
     currentBlock_->addInstruction(
         std::make_unique<BinaryInst>(OpCode::Sub, reg, zero, expr));
@@ -1221,7 +1227,7 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
   }
 
   if (node.op == "!") {
-    auto zero = std::make_shared<Constant>(
+    auto zero = createConstant(
         "false", std::make_shared<PrimitiveType>(TypeKind::Bool));
     auto reg = createRegister(node.type);
     currentBlock_->addInstruction(
@@ -1231,7 +1237,7 @@ void BoundIRGenerator::visit(sema::BoundUnaryExpression &node) {
   }
 
   if (node.op == "~") {
-    auto allOnes = std::make_shared<Constant>("-1", node.type);
+    auto allOnes = createConstant("-1", node.type);
     auto reg = createRegister(node.type);
     currentBlock_->addInstruction(
         std::make_unique<BinaryInst>(OpCode::BitXor, reg, expr, allOnes));
@@ -1250,7 +1256,7 @@ void BoundIRGenerator::visit(sema::BoundArrayLiteral &node) {
 
   for (size_t i = 0; i < node.elements.size(); ++i) {
     node.elements[i]->accept(*this);
-    auto value = std::move(valueStack_.top());
+    auto value = valueStack_.top();
     valueStack_.pop();
 
     auto elementAddr =
@@ -1281,13 +1287,13 @@ void BoundIRGenerator::visit(sema::BoundTaggedUnionDeclaration &node) {
 void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
   if (node.left->type->getKind() == zir::TypeKind::Enum) {
     node.left->accept(*this);
-    auto left = std::move(valueStack_.top());
+    auto left = valueStack_.top();
     valueStack_.pop();
 
-    auto enumType = std::static_pointer_cast<zir::EnumType>(left->getType());
+    auto enumType = std::static_pointer_cast<zir::EnumType>(typeOf(left));
     int64_t value = enumType->getVariantDiscriminant(node.member);
     if (value != -1) {
-      valueStack_.push(std::make_shared<Constant>(
+      valueStack_.push(createConstant(
           std::to_string(value),
           std::make_shared<zir::PrimitiveType>(zir::TypeKind::Int)));
       return;
@@ -1300,7 +1306,7 @@ void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
     node.left->accept(*this);
     evaluateAsAddress_ = oldEvaluateAsAddress;
 
-    auto left = std::move(valueStack_.top());
+    auto left = valueStack_.top();
     valueStack_.pop();
     auto fieldAddr = createRegister(std::make_shared<PointerType>(
         std::make_shared<PrimitiveType>(TypeKind::Int32)));
@@ -1323,7 +1329,7 @@ void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
   node.left->accept(*this);
   evaluateAsAddress_ = oldEvaluateAsAddress;
 
-  auto left = std::move(valueStack_.top());
+  auto left = valueStack_.top();
   valueStack_.pop();
 
   if (node.left->type->getKind() == zir::TypeKind::Class) {
@@ -1352,9 +1358,9 @@ void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
       }
       return;
     }
-  } else if (left->getType()->getKind() == zir::TypeKind::Pointer) {
-    auto baseType = std::static_pointer_cast<zir::PointerType>(left->getType())
-                        ->getBaseType();
+  } else if (valueOf(left).getType()->getKind() == zir::TypeKind::Pointer) {
+    auto baseType =
+        static_cast<zir::PointerType *>(valueOf(left).getType())->getBaseType();
     if (baseType->getKind() == zir::TypeKind::Class) {
       auto classType = std::static_pointer_cast<zir::ClassType>(baseType);
       int fieldIndex = -1;
@@ -1408,9 +1414,8 @@ void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
         return;
       }
     }
-  } else if (left->getType()->getKind() == zir::TypeKind::Record) {
-    auto recordType =
-        std::static_pointer_cast<zir::RecordType>(left->getType());
+  } else if (valueOf(left).getType()->getKind() == zir::TypeKind::Record) {
+    auto *recordType = static_cast<zir::RecordType *>(valueOf(left).getType());
     int fieldIndex = -1;
     const auto &fields = recordType->getFields();
     for (size_t i = 0; i < fields.size(); ++i) {
@@ -1439,7 +1444,7 @@ void BoundIRGenerator::visit(sema::BoundMemberAccess &node) {
 
   throw std::runtime_error("IR member access failed: member '" + node.member +
                            "' not found in type '" +
-                           renderTypeForUser(left->getType()) + "'");
+                           renderTypeForUser(typeOf(left)) + "'");
 }
 
 void BoundIRGenerator::visit(sema::BoundStructLiteral &node) {
@@ -1452,12 +1457,12 @@ void BoundIRGenerator::visit(sema::BoundStructLiteral &node) {
 
     for (const auto &fieldInit : node.fields) {
       fieldInit.second->accept(*this);
-      auto val = std::move(valueStack_.top());
+      auto val = valueStack_.top();
       valueStack_.pop();
-      aggregateFields.push_back({fieldInit.first, val});
+      aggregateFields.push_back({fieldInit.first, &valueOf(val)});
     }
 
-    valueStack_.push(std::make_shared<AggregateConstant>(
+    valueStack_.push(values().add<AggregateConstant>(
         node.type, std::move(aggregateFields)));
     return;
   }
@@ -1478,7 +1483,7 @@ void BoundIRGenerator::visit(sema::BoundStructLiteral &node) {
     }
 
     fieldInit.second->accept(*this);
-    auto val = std::move(valueStack_.top());
+    auto val = valueStack_.top();
     valueStack_.pop();
 
     if (fields[fieldIndex].type &&
@@ -1487,7 +1492,7 @@ void BoundIRGenerator::visit(sema::BoundStructLiteral &node) {
           std::make_shared<PointerType>(fields[fieldIndex].type));
       currentBlock_->addInstruction(std::make_unique<GetElementPtrInst>(
           fieldAddr, allocaReg, fieldIndex));
-      emitInitializationStore(std::move(val), fieldAddr);
+      emitInitializationStore(val, fieldAddr);
     }
   }
 
@@ -1507,19 +1512,19 @@ void BoundIRGenerator::visit(sema::BoundTaggedUnionLiteral &node) {
   auto tagAddr = createRegister(std::make_shared<PointerType>(tagType));
   currentBlock_->addInstruction(
       std::make_unique<GetElementPtrInst>(tagAddr, allocaReg, 0));
-  auto tagValue = std::make_shared<Constant>(std::to_string(node.tag), tagType);
+  auto tagValue = createConstant(std::to_string(node.tag), tagType);
   currentBlock_->addInstruction(
       std::make_unique<StoreInst>(tagValue, tagAddr, StoreMode::RawInitialize));
 
   if (node.payload) {
     node.payload->accept(*this);
-    auto payload = std::move(valueStack_.top());
+    auto payload = valueStack_.top();
     valueStack_.pop();
     auto payloadAddr =
         createRegister(std::make_shared<PointerType>(node.payload->type));
     currentBlock_->addInstruction(
         std::make_unique<GetElementPtrInst>(payloadAddr, allocaReg, 1));
-    emitInitializationStore(std::move(payload), payloadAddr);
+    emitInitializationStore(payload, payloadAddr);
   }
 
   auto result = createRegister(taggedUnionType);
@@ -1578,7 +1583,7 @@ void BoundIRGenerator::visit(sema::BoundTryExpression &node) {
   currentBlock_->addInstruction(std::make_unique<GetElementPtrInst>(
       okAddr, propagatedAlloca, FailableTypeLayout::OkField));
   currentBlock_->addInstruction(std::make_unique<StoreInst>(
-      std::make_shared<Constant>(
+      createConstant(
           "false", std::make_shared<PrimitiveType>(TypeKind::Bool)),
       okAddr, StoreMode::Assign));
 
@@ -1588,7 +1593,7 @@ void BoundIRGenerator::visit(sema::BoundTryExpression &node) {
       valueAddr, propagatedAlloca, FailableTypeLayout::ValueField));
   if (propagatedValueType && propagatedValueType->getKind() != TypeKind::Void) {
     currentBlock_->addInstruction(std::make_unique<StoreInst>(
-        std::make_shared<Constant>("0", propagatedValueType), valueAddr,
+        createConstant("0", propagatedValueType), valueAddr,
         StoreMode::Assign));
   }
 
@@ -1610,13 +1615,14 @@ void BoundIRGenerator::visit(sema::BoundTryExpression &node) {
   currentBlock_ = mergeBlockPtr;
 
   if (resultIsVoid) {
-    valueStack_.push(std::make_shared<Constant>("0", node.type));
+    valueStack_.push(createConstant("0", node.type));
     return;
   }
 
-  std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
+  std::vector<std::pair<std::string, ValueId>> incoming;
   incoming.push_back({successFrom, successValue});
-  auto result = createRegister(node.type, ownershipForPhi(node.type, incoming));
+  auto result = createRegister(
+      node.type, ownershipForPhi(values(), node.type, incoming));
   currentBlock_->addInstruction(std::make_unique<PhiInst>(result, incoming));
   valueStack_.push(result);
 }
@@ -1665,14 +1671,15 @@ void BoundIRGenerator::visit(sema::BoundFallbackExpression &node) {
   currentBlock_ = mergeBlockPtr;
 
   if (resultIsVoid) {
-    valueStack_.push(std::make_shared<Constant>("0", node.type));
+    valueStack_.push(createConstant("0", node.type));
     return;
   }
 
-  std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
+  std::vector<std::pair<std::string, ValueId>> incoming;
   incoming.push_back({successFrom, successValue});
   incoming.push_back({fallbackFrom, fallbackValue});
-  auto result = createRegister(node.type, ownershipForPhi(node.type, incoming));
+  auto result = createRegister(
+      node.type, ownershipForPhi(values(), node.type, incoming));
   currentBlock_->addInstruction(std::make_unique<PhiInst>(result, incoming));
   valueStack_.push(result);
 }
@@ -1724,12 +1731,12 @@ void BoundIRGenerator::visit(sema::BoundFailableHandleExpression &node) {
   }
 
   bool resultIsVoid = node.type && node.type->getKind() == TypeKind::Void;
-  std::shared_ptr<Value> handlerValue = nullptr;
+  ValueId handlerValue = NoValue;
   if (node.handler && node.handler->result) {
     handlerValue = valueStack_.top();
     valueStack_.pop();
   } else {
-    handlerValue = std::make_shared<Constant>("0", node.type);
+    handlerValue = createConstant("0", node.type);
   }
 
   bool handlerReachesMerge = !isTerminated(currentBlock_);
@@ -1747,20 +1754,21 @@ void BoundIRGenerator::visit(sema::BoundFailableHandleExpression &node) {
   currentBlock_ = mergeBlockPtr;
 
   if (!handlerReachesMerge) {
-    valueStack_.push(resultIsVoid ? std::make_shared<Constant>("0", node.type)
+    valueStack_.push(resultIsVoid ? createConstant("0", node.type)
                                   : successValue);
     return;
   }
 
   if (resultIsVoid) {
-    valueStack_.push(std::make_shared<Constant>("0", node.type));
+    valueStack_.push(createConstant("0", node.type));
     return;
   }
 
-  std::vector<std::pair<std::string, std::shared_ptr<Value>>> incoming;
+  std::vector<std::pair<std::string, ValueId>> incoming;
   incoming.push_back({successFrom, successValue});
   incoming.push_back({handlerFrom, handlerValue});
-  auto result = createRegister(node.type, ownershipForPhi(node.type, incoming));
+  auto result = createRegister(
+      node.type, ownershipForPhi(values(), node.type, incoming));
   currentBlock_->addInstruction(std::make_unique<PhiInst>(result, incoming));
   valueStack_.push(result);
 }
@@ -1792,7 +1800,7 @@ void BoundIRGenerator::visit(sema::BoundIfStatement &node) {
   currentFunction_->addBlock(std::move(thenBlock));
   currentBlock_ = thenBlockPtr;
 
-  std::shared_ptr<Value> narrowedAddress;
+  ValueId narrowedAddress = NoValue;
   if (node.narrowedSource && node.narrowedVariable) {
     auto sourceIt = symbolMap_.find(node.narrowedSource);
     if (sourceIt != symbolMap_.end()) {
@@ -1802,7 +1810,7 @@ void BoundIRGenerator::visit(sema::BoundIfStatement &node) {
   }
   if (node.thenBody)
     node.thenBody->accept(*this);
-  if (node.narrowedVariable && narrowedAddress) {
+  if (node.narrowedVariable && narrowedAddress != NoValue) {
     symbolMap_.erase(node.narrowedVariable);
   }
 
@@ -2051,7 +2059,7 @@ void BoundIRGenerator::visit(sema::BoundIndexAccess &node) {
   evaluateAsAddress_ = oldEvaluateAsAddress;
 
   auto ptr = createRegister(std::make_shared<PointerType>(node.type));
-  if (auto *c = dynamic_cast<Constant *>(indexVal.get())) {
+  if (auto *c = valueAs<Constant>(indexVal)) {
     int idx = 0;
     try {
       idx = std::stoi(c->getName());
@@ -2115,7 +2123,7 @@ void BoundIRGenerator::visit(sema::BoundCast &node) {
     currentBlock_->addInstruction(
         std::make_unique<GetElementPtrInst>(lenFieldAddr, viewAddr, 1));
     currentBlock_->addInstruction(std::make_unique<StoreInst>(
-        std::make_shared<Constant>(std::to_string(arrayType->getSize()),
+        createConstant(std::to_string(arrayType->getSize()),
                                    lenType),
         lenFieldAddr, StoreMode::Assign));
 
@@ -2132,7 +2140,7 @@ void BoundIRGenerator::visit(sema::BoundCast &node) {
   // Global initializers are lowered as constants only. Fold casted constants
   // immediately to the target type so LLVM sees a correctly-typed initializer.
   if (!currentFunction_ || !currentBlock_) {
-    if (auto c = std::dynamic_pointer_cast<Constant>(src)) {
+    if (auto c = valueAs<Constant>(src)) {
       auto folded = c->getLiteral();
       auto srcTy = c->getType();
       auto dstTy = node.type;
@@ -2186,7 +2194,7 @@ void BoundIRGenerator::visit(sema::BoundCast &node) {
         }
       }
 
-      valueStack_.push(std::make_shared<Constant>(folded, node.type));
+      valueStack_.push(createConstant(folded, node.type));
       return;
     }
 
@@ -2195,13 +2203,14 @@ void BoundIRGenerator::visit(sema::BoundCast &node) {
   }
 
   if (node.type->getIntrinsicKind() == IntrinsicTypeKind::StringView &&
-      src->getType()->getIntrinsicKind() == IntrinsicTypeKind::String) {
+      valueOf(src).getType()->getIntrinsicKind() == IntrinsicTypeKind::String) {
     auto result = createRegister(node.type, ValueOwnership::Borrowed);
     currentBlock_->addInstruction(std::make_unique<BorrowInst>(result, src));
     valueStack_.push(result);
     return;
   }
-  auto res = createRegister(node.type, ownershipForCast(src, node.type));
+  auto res =
+      createRegister(node.type, ownershipForCast(valueOf(src), node.type));
   currentBlock_->addInstruction(
       std::make_unique<CastInst>(res, src, node.type));
   valueStack_.push(res);
@@ -2213,7 +2222,7 @@ void BoundIRGenerator::visit(sema::BoundNewExpression &node) {
       std::make_unique<AllocInst>(result, node.classType));
 
   if (node.constructor) {
-    std::vector<std::shared_ptr<Value>> args;
+    std::vector<ValueId> args;
     args.push_back(result);
     std::vector<bool> argumentIsRef{false};
     for (size_t i = 0; i < node.arguments.size(); ++i) {
@@ -2229,14 +2238,14 @@ void BoundIRGenerator::visit(sema::BoundNewExpression &node) {
       const auto parameterOwnership =
           parameterOwnershipFor(*node.constructor, parameterIndex);
       prepareCallArgument(argument, parameterOwnership);
-      args.push_back(std::move(argument));
+      args.push_back(argument);
       argumentIsRef.push_back(i < node.argumentIsRef.size() &&
                               node.argumentIsRef[i]);
     }
 
     currentBlock_->addInstruction(std::make_unique<CallInst>(
-        nullptr, node.constructor->linkName, std::move(args),
-        std::move(argumentIsRef), nullptr));
+        NoValue, node.constructor->linkName, std::move(args),
+        std::move(argumentIsRef), NoValue));
   }
 
   valueStack_.push(result);
@@ -63,41 +63,53 @@ private:
   Function *currentFunction_ = nullptr;
   BasicBlock *currentBlock_ = nullptr;
 
-  std::map<std::shared_ptr<sema::Symbol>, std::shared_ptr<Value>> symbolMap_;
-  std::map<std::shared_ptr<sema::Symbol>, std::shared_ptr<Value>>
-      globalSymbolMap_;
-  std::stack<std::shared_ptr<Value>> valueStack_;
+  std::map<std::shared_ptr<sema::Symbol>, ValueId> symbolMap_;
+  // Ids in the module's value table.
+  std::map<std::shared_ptr<sema::Symbol>, ValueId> globalSymbolMap_;
+  std::stack<ValueId> valueStack_;
 
   int nextRegisterId_ = 0;
   int nextBlockId_ = 0;
 
   std::vector<std::pair<std::string, std::string>> loopLabelStack_;
 
-  std::shared_ptr<Value> lastResultValue_ = nullptr;
+  ValueId lastResultValue_ = NoValue;
   bool evaluateAsAddress_ = false;
-  std::shared_ptr<Value> compoundTargetAddr_ = nullptr;
-  std::shared_ptr<Value>
-  createRegister(std::shared_ptr<Type> type,
-                 ValueOwnership ownership = ValueOwnership::Borrowed);
-  void emitInitializationStore(std::shared_ptr<Value> value,
-                               std::shared_ptr<Value> destination);
-  std::shared_ptr<Value> materializeOwnedValue(std::shared_ptr<Value> value);
-  void prepareCallArgument(std::shared_ptr<Value> &value,
+  ValueId compoundTargetAddr_ = NoValue;
+
+  /// @brief The table new values go to: the current function's, or the
+  /// module's while lowering globals.
+  ValueTable &values() {
+    return currentFunction_ ? currentFunction_->values : module_->values;
+  }
+  Value &valueOf(ValueId id) { return *values().get(id); }
+  template <typename T> T *valueAs(ValueId id) {
+    return dynamic_cast<T *>(values().get(id));
+  }
+  const std::shared_ptr<Type> &typeOf(ValueId id) {
+    return values().share(valueOf(id).getType());
+  }
+  ValueId importGlobal(ValueId global);
+
+  ValueId createRegister(std::shared_ptr<Type> type,
+                         ValueOwnership ownership = ValueOwnership::Borrowed);
+  ValueId createConstant(std::string literal, std::shared_ptr<Type> type);
+  void emitInitializationStore(ValueId value, ValueId destination);
+  ValueId materializeOwnedValue(ValueId value);
+  void prepareCallArgument(ValueId &value,
                            ParameterOwnership parameterOwnership);
-  void emitReturn(std::shared_ptr<Value> value = nullptr);
+  void emitReturn(ValueId value = NoValue);
   std::string createBlockLabel(const std::string &prefix);
-  std::shared_ptr<Value>
-  lowerConstantExpression(const sema::BoundExpression &expression);
-  std::shared_ptr<Value> lowerConstantExpression(
+  ValueId lowerConstantExpression(const sema::BoundExpression &expression);
+  ValueId lowerConstantExpression(
       const sema::BoundExpression &expression,
       std::set<const sema::VariableSymbol *> &resolvingConstants);
 
-  std::shared_ptr<Value>
-  emitFailableFieldLoad(const std::shared_ptr<Value> &value, int fieldIndex,
-                        const std::shared_ptr<Type> &fieldType);
-  std::shared_ptr<Value> emitFailableOk(const std::shared_ptr<Value> &value);
-  std::shared_ptr<Value> emitFailableValue(const std::shared_ptr<Value> &value);
-  std::shared_ptr<Value> emitFailableError(const std::shared_ptr<Value> &value);
+  ValueId emitFailableFieldLoad(ValueId value, int fieldIndex,
+                                const std::shared_ptr<Type> &fieldType);
+  ValueId emitFailableOk(ValueId value);
+  ValueId emitFailableValue(ValueId value);
+  ValueId emitFailableError(ValueId value);
 };
 
 } // namespace zir
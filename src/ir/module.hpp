@@ -10,8 +10,11 @@ class Module {
 public:
   std::string name;
   std::vector<std::shared_ptr<Type>> types;
-  std::vector<std::shared_ptr<Global>> globals;
-  std::vector<std::shared_ptr<Global>> externalGlobals;
+  // Owns the globals and their initializers; declared ahead of the
+  // functions, which refer to them.
+  ValueTable values;
+  std::vector<Global *> globals;
+  std::vector<Global *> externalGlobals;
   std::vector<std::unique_ptr<Function>> functions;
   std::vector<std::unique_ptr<Function>> externalFunctions;
 
@@ -23,12 +26,10 @@ public:
     functions.push_back(std::move(func));
   }
 
-  void addGlobal(std::shared_ptr<Global> global) {
-    globals.push_back(std::move(global));
-  }
+  void addGlobal(Global *global) { globals.push_back(global); }
 
-  void addExternalGlobal(std::shared_ptr<Global> global) {
-    externalGlobals.push_back(std::move(global));
+  void addExternalGlobal(Global *global) {
+    externalGlobals.push_back(global);
   }
 
   void addExternalFunction(std::unique_ptr<Function> func) {
@@ -37,11 +38,9 @@ public:
 
   const std::vector<std::shared_ptr<Type>> &getTypes() const { return types; }
 
-  const std::vector<std::shared_ptr<Global>> &getGlobals() const {
-    return globals;
-  }
+  const std::vector<Global *> &getGlobals() const { return globals; }
 
-  const std::vector<std::shared_ptr<Global>> &getExternalGlobals() const {
+  const std::vector<Global *> &getExternalGlobals() const {
     return externalGlobals;
   }
 
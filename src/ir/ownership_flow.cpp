@@ -19,12 +19,13 @@ constexpr unsigned char destroyed =
 constexpr unsigned char unavailable =
     static_cast<unsigned char>(OwnershipFlowState::Unavailable);
 
-bool ownsManagedValue(const std::shared_ptr<Value> &value) {
+bool ownsManagedValue(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
   return value && isOwned(value->getOwnership()) &&
          containsManagedValues(value->getType());
 }
 
-std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
+ValueId instructionResult(const Instruction &instruction) {
   switch (instruction.getOpCode()) {
   case OpCode::Alloca:
     return static_cast<const AllocaInst &>(instruction).getResult();
@@ -74,17 +75,18 @@ std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
   case OpCode::Ret:
   case OpCode::Destroy:
   case OpCode::InlineAsm:
-    return nullptr;
+    return NoValue;
   }
-  return nullptr;
+  return NoValue;
 }
 
-std::vector<const Value *> collectOwnedValues(const Function &function) {
-  std::vector<const Value *> values;
-  std::unordered_set<const Value *> seen;
-  auto add = [&](const std::shared_ptr<Value> &value) {
-    if (ownsManagedValue(value) && seen.insert(value.get()).second) {
-      values.push_back(value.get());
+std::vector<ValueId> collectOwnedValues(const Function &function) {
+  std::vector<ValueId> values;
+  std::vector<bool> seen(function.values.size());
+  auto add = [&](ValueId value) {
+    if (ownsManagedValue(function, value) && !seen[value]) {
+      seen[value] = true;
+      values.push_back(value);
     }
   };
   for (const auto &argument : function.getArguments()) {
@@ -103,9 +105,10 @@ std::vector<const Value *> collectOwnedValues(const Function &function) {
   return values;
 }
 
-bool transfersThroughCast(const CastInst &cast) {
-  return ownsManagedValue(cast.getSource()) && cast.getTargetType() &&
-         cast.getResult() && isOwned(cast.getResult()->getOwnership());
+bool transfersThroughCast(const Function &function, const CastInst &cast) {
+  const Value *result = function.getValue(cast.getResult());
+  return ownsManagedValue(function, cast.getSource()) &&
+         cast.getTargetType() && result && isOwned(result->getOwnership());
 }
 
 } // namespace
@@ -139,26 +142,19 @@ OwnershipFlowAnalysis::OwnershipFlowAnalysis(
 OwnershipFlowState
 OwnershipFlowAnalysis::stateOnEdge(const BasicBlock &source,
                                    const BasicBlock &destination,
-                                   const std::shared_ptr<Value> &value) const {
-  return stateOnEdge(source, destination, value.get());
-}
-
-OwnershipFlowState
-OwnershipFlowAnalysis::stateOnEdge(const BasicBlock &source,
-                                   const BasicBlock &destination,
-                                   const Value *value) const {
+                                   ValueId value) const {
   const auto sourceStates = edgeStates_.find(&source);
-  if (!value || sourceStates == edgeStates_.end()) {
+  if (sourceStates == edgeStates_.end()) {
     return OwnershipFlowState::Unavailable;
   }
   const auto destinationStates = sourceStates->second.find(&destination);
   if (destinationStates == sourceStates->second.end()) {
     return OwnershipFlowState::Unavailable;
   }
-  const auto state = destinationStates->second.find(value);
-  return state == destinationStates->second.end()
-             ? OwnershipFlowState::Unavailable
-             : static_cast<OwnershipFlowState>(state->second);
+  const auto &states = destinationStates->second;
+  return value < states.size() && states[value] != 0
+             ? static_cast<OwnershipFlowState>(states[value])
+             : OwnershipFlowState::Unavailable;
 }
 
 std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
@@ -169,29 +165,29 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
   edgeStates_.clear();
   returnStates_.clear();
   const auto ownedValues = collectOwnedValues(function_);
-  OwnershipStates entryStates;
-  for (const auto *value : ownedValues) {
+  const size_t valueCount = function_.values.size();
+  OwnershipStates entryStates(valueCount);
+  for (const auto value : ownedValues) {
     entryStates[value] = unavailable;
   }
-  for (const auto &argument : function_.getArguments()) {
-    if (ownsManagedValue(argument)) {
-      entryStates[argument.get()] = live;
+  for (const auto argument : function_.getArguments()) {
+    if (ownsManagedValue(function_, argument)) {
+      entryStates[argument] = live;
     }
   }
 
   std::vector<OwnershipTransferViolation> violations;
   std::unordered_set<std::string> reported;
-  auto transition = [&](OwnershipStates &states,
-                        const std::shared_ptr<Value> &value,
+  auto transition = [&](OwnershipStates &states, ValueId value,
                         const BasicBlock &block, size_t instructionIndex,
                         const char *operation, unsigned char nextState) {
-    if (!ownsManagedValue(value)) {
+    if (!ownsManagedValue(function_, value)) {
       return;
     }
-    auto &state = states[value.get()];
+    auto &state = states[value];
     if (state != live) {
       const auto key = block.label + ":" + std::to_string(instructionIndex) +
-                       ":" + value->getName();
+                       ":" + function_.values[value].getName();
       if (reported.insert(key).second) {
         violations.push_back({&block, instructionIndex, value,
                               std::string(operation),
@@ -200,21 +196,18 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
     }
     state = nextState;
   };
-  auto requireLive = [&](const OwnershipStates &states,
-                         const std::shared_ptr<Value> &value,
+  auto requireLive = [&](const OwnershipStates &states, ValueId value,
                          const BasicBlock &block, size_t instructionIndex,
                          const char *operation) {
-    if (!ownsManagedValue(value)) {
+    if (!ownsManagedValue(function_, value)) {
       return;
     }
-    const auto state = states.find(value.get());
-    const auto currentState =
-        state == states.end() ? unavailable : state->second;
+    const auto currentState = states[value] != 0 ? states[value] : unavailable;
     if (currentState == live) {
       return;
     }
     const auto key = block.label + ":" + std::to_string(instructionIndex) +
-                     ":" + value->getName();
+                     ":" + function_.values[value].getName();
     if (reported.insert(key).second) {
       violations.push_back({&block, instructionIndex, value,
                             std::string(operation),
@@ -230,7 +223,7 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
         continue;
       }
       const auto &block = *blockOwner;
-      OwnershipStates states;
+      OwnershipStates states(valueCount);
       if (!function_.getBlocks().empty() &&
           function_.getBlocks().front().get() == &block) {
         states = entryStates;
@@ -249,8 +242,8 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
             if (destinationStates == sourceStates->second.end()) {
               continue;
             }
-            for (const auto *value : ownedValues) {
-              states[value] |= destinationStates->second.at(value);
+            for (const auto value : ownedValues) {
+              states[value] |= destinationStates->second[value];
             }
           }
         }
@@ -287,21 +280,23 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
         }
         case OpCode::Store: {
           const auto &store = static_cast<const StoreInst &>(*instruction);
-          if (store.getSource() && isOwned(store.getSource()->getOwnership())) {
+          const Value *source = function_.getValue(store.getSource());
+          if (source && isOwned(source->getOwnership())) {
             transition(states, store.getSource(), block, i, "store", moved);
           }
           break;
         }
         case OpCode::Ret: {
           const auto &ret = static_cast<const ReturnInst &>(*instruction);
-          if (ret.getValue() && isOwned(ret.getValue()->getOwnership())) {
+          const Value *value = function_.getValue(ret.getValue());
+          if (value && isOwned(value->getOwnership())) {
             transition(states, ret.getValue(), block, i, "return", moved);
           }
           break;
         }
         case OpCode::Cast: {
           const auto &cast = static_cast<const CastInst &>(*instruction);
-          if (transfersThroughCast(cast)) {
+          if (transfersThroughCast(function_, cast)) {
             transition(states, cast.getSource(), block, i, "cast", moved);
           } else {
             requireLive(states, cast.getSource(), block, i, "cast");
@@ -312,7 +307,8 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
           const auto &call = static_cast<const CallInst &>(*instruction);
           for (size_t argumentIndex = 0;
                argumentIndex < call.getArguments().size(); ++argumentIndex) {
-            if (callTransfersOwnership(module_, call, argumentIndex)) {
+            if (callTransfersOwnership(module_, function_, call,
+                                       argumentIndex)) {
               transition(states, call.getArguments()[argumentIndex], block, i,
                          "call", moved);
             } else {
@@ -346,8 +342,8 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
           break;
         }
         if (const auto result = instructionResult(*instruction);
-            ownsManagedValue(result)) {
-          states[result.get()] = live;
+            ownsManagedValue(function_, result)) {
+          states[result] = live;
         }
         if (instruction->getOpCode() == OpCode::Ret) {
           returnStates_[&block][i] = states;
@@ -359,8 +355,10 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
       }
       for (const auto *successor : successors->second) {
         auto edgeState = states;
-        for (const auto *value : ownedValues) {
-          edgeState.try_emplace(value, unavailable);
+        for (const auto value : ownedValues) {
+          if (edgeState[value] == 0) {
+            edgeState[value] = unavailable;
+          }
         }
         for (size_t i = 0; i < successor->getInstructions().size(); ++i) {
           const auto &instruction = successor->getInstructions()[i];
@@ -368,14 +366,11 @@ std::vector<OwnershipTransferViolation> OwnershipFlowAnalysis::analyze() {
             continue;
           }
           const auto &phi = static_cast<const PhiInst &>(*instruction);
-          if (!ownsManagedValue(phi.getResult())) {
+          if (!ownsManagedValue(function_, phi.getResult())) {
             continue;
           }
-          for (const auto &[label, value] : phi.getIncoming()) {
-            if (label == block.label) {
-              transition(edgeState, value, *successor, i, "phi", moved);
-              break;
-            }
+          if (const auto *value = phi.findIncoming(block.id)) {
+            transition(edgeState, *value, *successor, i, "phi", moved);
           }
         }
         auto &storedState = edgeStates_[&block][successor];
@@ -395,10 +390,12 @@ std::vector<OwnershipExitObligation>
 OwnershipFlowAnalysis::analyzeExitObligations() {
   analyze();
 
+  const auto ownedValues = collectOwnedValues(function_);
   std::vector<OwnershipExitObligation> obligations;
   for (const auto &[block, returns] : returnStates_) {
     for (const auto &[instructionIndex, states] : returns) {
-      for (const auto &[value, state] : states) {
+      for (const auto value : ownedValues) {
+        const auto state = states[value];
         if ((state & live) != 0) {
           obligations.push_back({block, instructionIndex, value,
                                  static_cast<OwnershipFlowState>(state)});
@@ -413,10 +410,10 @@ std::vector<OwnershipClosurePlan>
 OwnershipFlowAnalysis::analyzeOwnershipClosurePlans() {
   const auto obligations = analyzeExitObligations();
   const auto ownedValues = collectOwnedValues(function_);
-  std::unordered_map<const Value *, OwnershipDefinitionSite> definitions;
-  for (const auto &argument : function_.getArguments()) {
-    if (ownsManagedValue(argument)) {
-      definitions.emplace(argument.get(),
+  std::unordered_map<ValueId, OwnershipDefinitionSite> definitions;
+  for (const auto argument : function_.getArguments()) {
+    if (ownsManagedValue(function_, argument)) {
+      definitions.emplace(argument,
                           OwnershipDefinitionSite{nullptr, std::nullopt});
     }
   }
@@ -427,16 +424,16 @@ OwnershipFlowAnalysis::analyzeOwnershipClosurePlans() {
     for (size_t i = 0; i < blockOwner->getInstructions().size(); ++i) {
       const auto &instruction = blockOwner->getInstructions()[i];
       if (const auto value =
-              instruction ? instructionResult(*instruction) : nullptr;
-          ownsManagedValue(value)) {
-        definitions.emplace(value.get(),
+              instruction ? instructionResult(*instruction) : NoValue;
+          ownsManagedValue(function_, value)) {
+        definitions.emplace(value,
                             OwnershipDefinitionSite{blockOwner.get(), i});
       }
     }
   }
 
   std::vector<OwnershipClosurePlan> plans;
-  for (const auto *value : ownedValues) {
+  for (const auto value : ownedValues) {
     OwnershipClosurePlan plan{value, definitions[value], {}, {}};
     for (const auto &obligation : obligations) {
       if (obligation.value == value) {
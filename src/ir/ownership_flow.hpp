@@ -3,7 +3,6 @@
 #include "function.hpp"
 
 #include <cstddef>
-#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -27,7 +26,7 @@ std::string formatOwnershipFlowState(OwnershipFlowState state);
 struct OwnershipTransferViolation {
   const BasicBlock *block;
   size_t instructionIndex;
-  std::shared_ptr<Value> value;
+  ValueId value;
   std::string operation;
   OwnershipFlowState priorState;
 };
@@ -35,7 +34,7 @@ struct OwnershipTransferViolation {
 struct OwnershipExitObligation {
   const BasicBlock *block;
   size_t instructionIndex;
-  const Value *value;
+  ValueId value;
   OwnershipFlowState state;
 };
 
@@ -58,7 +57,7 @@ struct OwnershipDestroyPlacement {
 };
 
 struct OwnershipClosurePlan {
-  const Value *value;
+  ValueId value;
   OwnershipDefinitionSite definition;
   std::vector<OwnershipExitObligation> liveExits;
   std::vector<OwnershipDestroyPlacement> destroyPlacements;
@@ -79,13 +78,11 @@ public:
   std::vector<OwnershipClosurePlan> analyzeOwnershipClosurePlans();
   OwnershipFlowState stateOnEdge(const BasicBlock &source,
                                  const BasicBlock &destination,
-                                 const std::shared_ptr<Value> &value) const;
-  OwnershipFlowState stateOnEdge(const BasicBlock &source,
-                                 const BasicBlock &destination,
-                                 const Value *value) const;
+                                 ValueId value) const;
 
 private:
-  using OwnershipStates = std::unordered_map<const Value *, unsigned char>;
+  // Indexed by ValueId; zero for a value no path has reached yet.
+  using OwnershipStates = std::vector<unsigned char>;
   using OwnershipEdgeStates = std::unordered_map<
       const BasicBlock *,
       std::unordered_map<const BasicBlock *, OwnershipStates>>;
@@ -11,23 +11,25 @@
 namespace zir {
 namespace {
 
-using ValueSet = std::unordered_set<const Value *>;
+using ValueSet = std::unordered_set<ValueId>;
 
-bool tracksOwnership(const std::shared_ptr<Value> &value) {
+bool tracksOwnership(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
   return value && isOwned(value->getOwnership()) &&
          containsManagedValues(value->getType());
 }
 
-void addUse(ValueSet &values, const std::shared_ptr<Value> &value,
+void addUse(ValueSet &values, const Function &function, ValueId value,
             const BorrowProvenance &provenance) {
-  if (tracksOwnership(value)) {
-    values.insert(value.get());
+  if (tracksOwnership(function, value)) {
+    values.insert(value);
   }
   const auto &owners = provenance.ownersOf(value);
   values.insert(owners.begin(), owners.end());
 }
 
-void addInstructionUses(ValueSet &values, const Instruction &instruction,
+void addInstructionUses(ValueSet &values, const Function &function,
+                        const Instruction &instruction,
                         const BorrowProvenance &provenance) {
   switch (instruction.getOpCode()) {
   case OpCode::Alloca:
@@ -36,13 +38,13 @@ void addInstructionUses(ValueSet &values, const Instruction &instruction,
   case OpCode::Phi:
     return;
   case OpCode::Load:
-    addUse(values, static_cast<const LoadInst &>(instruction).getSource(),
-           provenance);
+    addUse(values, function,
+           static_cast<const LoadInst &>(instruction).getSource(), provenance);
     return;
   case OpCode::Store: {
     const auto &store = static_cast<const StoreInst &>(instruction);
-    addUse(values, store.getSource(), provenance);
-    addUse(values, store.getDestination(), provenance);
+    addUse(values, function, store.getSource(), provenance);
+    addUse(values, function, store.getDestination(), provenance);
     return;
   }
   case OpCode::Add:
@@ -59,98 +61,101 @@ void addInstructionUses(ValueSet &values, const Instruction &instruction,
   case OpCode::BitOr:
   case OpCode::BitXor: {
     const auto &binary = static_cast<const BinaryInst &>(instruction);
-    addUse(values, binary.getLhs(), provenance);
-    addUse(values, binary.getRhs(), provenance);
+    addUse(values, function, binary.getLhs(), provenance);
+    addUse(values, function, binary.getRhs(), provenance);
     return;
   }
   case OpCode::Cmp: {
     const auto &comparison = static_cast<const CmpInst &>(instruction);
-    addUse(values, comparison.getLhs(), provenance);
-    addUse(values, comparison.getRhs(), provenance);
+    addUse(values, function, comparison.getLhs(), provenance);
+    addUse(values, function, comparison.getRhs(), provenance);
     return;
   }
   case OpCode::CondBr:
-    addUse(values,
+    addUse(values, function,
            static_cast<const CondBranchInst &>(instruction).getCondition(),
            provenance);
     return;
   case OpCode::Ret:
-    addUse(values, static_cast<const ReturnInst &>(instruction).getValue(),
-           provenance);
+    addUse(values, function,
+           static_cast<const ReturnInst &>(instruction).getValue(), provenance);
     return;
   case OpCode::Call: {
     const auto &call = static_cast<const CallInst &>(instruction);
-    addUse(values, call.getCalleeValue(), provenance);
+    addUse(values, function, call.getCalleeValue(), provenance);
     for (const auto &argument : call.getArguments()) {
-      addUse(values, argument, provenance);
+      addUse(values, function, argument, provenance);
     }
-    addUse(values, call.getVariadicPack(), provenance);
+    addUse(values, function, call.getVariadicPack(), provenance);
     return;
   }
   case OpCode::Copy:
-    addUse(values, static_cast<const CopyInst &>(instruction).getSource(),
-           provenance);
+    addUse(values, function,
+           static_cast<const CopyInst &>(instruction).getSource(), provenance);
     return;
   case OpCode::Move:
-    addUse(values, static_cast<const MoveInst &>(instruction).getSource(),
-           provenance);
+    addUse(values, function,
+           static_cast<const MoveInst &>(instruction).getSource(), provenance);
     return;
   case OpCode::Borrow:
-    addUse(values, static_cast<const BorrowInst &>(instruction).getOwner(),
-           provenance);
+    addUse(values, function,
+           static_cast<const BorrowInst &>(instruction).getOwner(), provenance);
     return;
   case OpCode::Destroy:
-    addUse(values, static_cast<const DestroyInst &>(instruction).getValue(),
+    addUse(values, function,
+           static_cast<const DestroyInst &>(instruction).getValue(),
            provenance);
     return;
   case OpCode::GetElementPtr: {
     const auto &gep = static_cast<const GetElementPtrInst &>(instruction);
-    addUse(values, gep.getPointer(), provenance);
-    addUse(values, gep.getIndexValue(), provenance);
+    addUse(values, function, gep.getPointer(), provenance);
+    addUse(values, function, gep.getIndexValue(), provenance);
     return;
   }
   case OpCode::Cast:
-    addUse(values, static_cast<const CastInst &>(instruction).getSource(),
-           provenance);
+    addUse(values, function,
+           static_cast<const CastInst &>(instruction).getSource(), provenance);
     return;
   case OpCode::WeakLock:
-    addUse(values,
+    addUse(values, function,
            static_cast<const WeakLockInst &>(instruction).getWeakValue(),
            provenance);
     return;
   case OpCode::WeakAlive:
-    addUse(values,
+    addUse(values, function,
            static_cast<const WeakAliveInst &>(instruction).getWeakValue(),
            provenance);
     return;
   case OpCode::ClassIs:
-    addUse(values, static_cast<const ClassIsInst &>(instruction).getObject(),
+    addUse(values, function,
+           static_cast<const ClassIsInst &>(instruction).getObject(),
            provenance);
     return;
   case OpCode::InlineAsm: {
     const auto &inlineAsm = static_cast<const InlineAsmInst &>(instruction);
     for (const auto &operand : inlineAsm.getOutputs()) {
-      addUse(values, operand.value, provenance);
+      addUse(values, function, operand.value, provenance);
     }
     for (const auto &operand : inlineAsm.getInputs()) {
-      addUse(values, operand.value, provenance);
+      addUse(values, function, operand.value, provenance);
     }
     return;
   }
   }
 }
 
-bool instructionUsesValue(const Instruction &instruction, const Value *value,
+bool instructionUsesValue(const Function &function,
+                          const Instruction &instruction, ValueId value,
                           const BorrowProvenance &provenance) {
-  if (!value) {
+  if (value == NoValue) {
     return false;
   }
   ValueSet uses;
-  addInstructionUses(uses, instruction, provenance);
+  addInstructionUses(uses, function, instruction, provenance);
   return uses.count(value) != 0;
 }
 
-std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
+ValueId instructionResult(const Instruction &instruction) {
   switch (instruction.getOpCode()) {
   case OpCode::Alloca:
     return static_cast<const AllocaInst &>(instruction).getResult();
@@ -200,40 +205,39 @@ std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
   case OpCode::Ret:
   case OpCode::Destroy:
   case OpCode::InlineAsm:
-    return nullptr;
+    return NoValue;
   }
-  return nullptr;
+  return NoValue;
 }
 
 void unionInto(ValueSet &destination, const ValueSet &source) {
   destination.insert(source.begin(), source.end());
 }
 
-void replacePhiResultWithIncoming(ValueSet &live,
-                                  const std::shared_ptr<Value> &result,
-                                  const std::shared_ptr<Value> &incoming,
+void replacePhiResultWithIncoming(ValueSet &live, const Function &function,
+                                  ValueId result, ValueId incoming,
                                   const BorrowProvenance &provenance) {
-  if (!result) {
+  if (result == NoValue) {
     return;
   }
 
-  if (tracksOwnership(result)) {
-    live.erase(result.get());
+  if (tracksOwnership(function, result)) {
+    live.erase(result);
   }
-  for (const auto *owner : provenance.ownersOf(result)) {
+  for (const auto owner : provenance.ownersOf(result)) {
     live.erase(owner);
   }
-  addUse(live, incoming, provenance);
+  addUse(live, function, incoming, provenance);
 }
 
 void replaceLoadResultWithStorage(ValueSet &live, const LoadInst &load,
                                   const BasicBlock &source,
                                   const BasicBlock &destination,
                                   const BorrowProvenance &provenance) {
-  if (!load.getResult() || !load.getSource()) {
+  if (load.getResult() == NoValue || load.getSource() == NoValue) {
     return;
   }
-  for (const auto *owner : provenance.ownersOf(load.getResult())) {
+  for (const auto owner : provenance.ownersOf(load.getResult())) {
     live.erase(owner);
   }
   const auto actualOwners =
@@ -243,47 +247,54 @@ void replaceLoadResultWithStorage(ValueSet &live, const LoadInst &load,
 
 } // namespace
 
-bool OwnershipLiveness::isLiveAtBlockEntry(
-    const BasicBlock &block, const std::shared_ptr<Value> &value) const {
+bool OwnershipLiveness::isLiveAtBlockEntry(const BasicBlock &block,
+                                           ValueId value) const {
   const auto states = entryStates_.find(&block);
-  return value && states != entryStates_.end() &&
-         states->second.count(value.get()) != 0;
+  return value != NoValue && states != entryStates_.end() &&
+         states->second.count(value) != 0;
 }
 
 bool OwnershipLiveness::isLiveAfter(const BasicBlock &block,
                                     size_t instructionIndex,
-                                    const std::shared_ptr<Value> &value) const {
+                                    ValueId value) const {
   const auto blockStates = afterStates_.find(&block);
-  if (!value || blockStates == afterStates_.end()) {
+  if (value == NoValue || blockStates == afterStates_.end()) {
     return false;
   }
   const auto states = blockStates->second.find(instructionIndex);
   return states != blockStates->second.end() &&
-         states->second.count(value.get()) != 0;
+         states->second.count(value) != 0;
 }
 
 bool OwnershipLiveness::isLastUse(const BasicBlock &block,
                                   size_t instructionIndex,
-                                  const std::shared_ptr<Value> &value) const {
-  if (!value || instructionIndex >= block.getInstructions().size() ||
+                                  ValueId value) const {
+  if (value == NoValue || instructionIndex >= block.getInstructions().size() ||
       !block.getInstructions()[instructionIndex]) {
     return false;
   }
-  return instructionUsesValue(*block.getInstructions()[instructionIndex],
-                              value.get(), borrowProvenance_) &&
+  return instructionUsesValue(*function_,
+                              *block.getInstructions()[instructionIndex],
+                              value, borrowProvenance_) &&
          !isLiveAfter(block, instructionIndex, value);
 }
 
-bool OwnershipLiveness::isLiveOnEdge(
-    const BasicBlock &source, const BasicBlock &destination,
-    const std::shared_ptr<Value> &value) const {
+bool OwnershipLiveness::isLiveOnEdge(const BasicBlock &source,
+                                     const BasicBlock &destination,
+                                     ValueId value) const {
   const auto sourceStates = edgeStates_.find(&source);
-  if (!value || sourceStates == edgeStates_.end()) {
+  if (value == NoValue || sourceStates == edgeStates_.end()) {
     return false;
   }
   const auto states = sourceStates->second.find(&destination);
   return states != sourceStates->second.end() &&
-         states->second.count(value.get()) != 0;
+         states->second.count(value) != 0;
+}
+
+bool OwnershipLiveness::usesValue(const Instruction &instruction,
+                                  ValueId value) const {
+  return instructionUsesValue(*function_, instruction, value,
+                              borrowProvenance_);
 }
 
 OwnershipLiveness analyzeOwnershipLiveness(const Module &module,
@@ -297,6 +308,7 @@ OwnershipLiveness analyzeOwnershipLiveness(const Module &module,
                                            const ControlFlowGraph &cfg) {
   OwnershipLiveness result;
   result.borrowProvenance_ = analyzeBorrowProvenance(module, function, cfg);
+  result.function_ = &function;
 
   bool changed = true;
   while (changed) {
@@ -315,12 +327,9 @@ OwnershipLiveness analyzeOwnershipLiveness(const Module &module,
             continue;
           }
           const auto &phi = static_cast<const PhiInst &>(*instruction);
-          for (const auto &[label, value] : phi.getIncoming()) {
-            if (label == block.label) {
-              replacePhiResultWithIncoming(edgeState, phi.getResult(), value,
-                                           result.borrowProvenance_);
-              break;
-            }
+          if (const auto *value = phi.findIncoming(block.id)) {
+            replacePhiResultWithIncoming(edgeState, function, phi.getResult(),
+                                         *value, result.borrowProvenance_);
           }
         }
         for (const auto &instruction : successor->getInstructions()) {
@@ -350,10 +359,11 @@ OwnershipLiveness analyzeOwnershipLiveness(const Module &module,
         }
         afterStates.emplace(i, live);
         if (const auto value = instructionResult(*instruction);
-            tracksOwnership(value)) {
-          live.erase(value.get());
+            tracksOwnership(function, value)) {
+          live.erase(value);
         }
-        addInstructionUses(live, *instruction, result.borrowProvenance_);
+        addInstructionUses(live, function, *instruction,
+                           result.borrowProvenance_);
       }
       if (result.entryStates_[&block] != live) {
         result.entryStates_[&block] = std::move(live);
@@ -4,7 +4,6 @@
 #include "function.hpp"
 
 #include <cstddef>
-#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -15,17 +14,19 @@ class ControlFlowGraph;
 
 class OwnershipLiveness {
 public:
-  bool isLiveAtBlockEntry(const BasicBlock &block,
-                          const std::shared_ptr<Value> &value) const;
+  bool isLiveAtBlockEntry(const BasicBlock &block, ValueId value) const;
   bool isLiveAfter(const BasicBlock &block, size_t instructionIndex,
-                   const std::shared_ptr<Value> &value) const;
+                   ValueId value) const;
   bool isLastUse(const BasicBlock &block, size_t instructionIndex,
-                 const std::shared_ptr<Value> &value) const;
+                 ValueId value) const;
   bool isLiveOnEdge(const BasicBlock &source, const BasicBlock &destination,
-                    const std::shared_ptr<Value> &value) const;
+                    ValueId value) const;
+  // True when the instruction reads the value itself or a borrow derived
+  // from it. Phi incoming values are edge uses and are not counted here.
+  bool usesValue(const Instruction &instruction, ValueId value) const;
 
 private:
-  using ValueSet = std::unordered_set<const Value *>;
+  using ValueSet = std::unordered_set<ValueId>;
   using InstructionStates = std::unordered_map<size_t, ValueSet>;
   using EdgeStates =
       std::unordered_map<const BasicBlock *,
@@ -35,6 +36,7 @@ private:
   std::unordered_map<const BasicBlock *, InstructionStates> afterStates_;
   EdgeStates edgeStates_;
   BorrowProvenance borrowProvenance_;
+  const Function *function_ = nullptr;
 
   friend OwnershipLiveness analyzeOwnershipLiveness(const Module &module,
                                                     const Function &function);
@@ -14,7 +14,7 @@
 namespace zir {
 namespace {
 
-std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
+ValueId instructionResult(const Instruction &instruction) {
   switch (instruction.getOpCode()) {
   case OpCode::Alloca:
     return static_cast<const AllocaInst &>(instruction).getResult();
@@ -64,16 +64,22 @@ std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
   case OpCode::Ret:
   case OpCode::Destroy:
   case OpCode::InlineAsm:
-    return nullptr;
+    return NoValue;
   }
-  return nullptr;
+  return NoValue;
 }
 
-bool ownsManagedValue(const std::shared_ptr<Value> &value) {
+bool ownsManagedValue(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
   return value && isOwned(value->getOwnership()) &&
          containsManagedValues(value->getType());
 }
 
+bool isOwnedValue(const Function &function, ValueId id) {
+  const Value *value = function.getValue(id);
+  return value && isOwned(value->getOwnership());
+}
+
 size_t destroyInsertionIndex(const BasicBlock &block, size_t resultIndex) {
   if (block.getInstructions()[resultIndex]->getOpCode() != OpCode::Phi) {
     return resultIndex + 1;
@@ -87,28 +93,28 @@ size_t destroyInsertionIndex(const BasicBlock &block, size_t resultIndex) {
   return index;
 }
 
-bool transfersOwnership(const Module &module, const Instruction &instruction,
-                        const std::shared_ptr<Value> &value) {
+bool transfersOwnership(const Module &module, const Function &function,
+                        const Instruction &instruction, ValueId value) {
   switch (instruction.getOpCode()) {
   case OpCode::Store: {
     const auto &store = static_cast<const StoreInst &>(instruction);
     return store.getSource() == value &&
-           isOwned(store.getSource()->getOwnership());
+           isOwnedValue(function, store.getSource());
   }
   case OpCode::Ret: {
     const auto &ret = static_cast<const ReturnInst &>(instruction);
-    return ret.getValue() == value && isOwned(ret.getValue()->getOwnership());
+    return ret.getValue() == value && isOwnedValue(function, ret.getValue());
   }
   case OpCode::Cast: {
     const auto &cast = static_cast<const CastInst &>(instruction);
-    return cast.getSource() == value && cast.getResult() &&
-           isOwned(cast.getResult()->getOwnership());
+    return cast.getSource() == value &&
+           isOwnedValue(function, cast.getResult());
   }
   case OpCode::Call: {
     const auto &call = static_cast<const CallInst &>(instruction);
     for (size_t i = 0; i < call.getArguments().size(); ++i) {
       if (call.getArguments()[i] == value &&
-          callTransfersOwnership(module, call, i)) {
+          callTransfersOwnership(module, function, call, i)) {
         return true;
       }
     }
@@ -123,47 +129,47 @@ bool transfersOwnership(const Module &module, const Instruction &instruction,
   }
 }
 
-void collectTransferredValues(const Module &module,
+void collectTransferredValues(const Module &module, const Function &function,
                               const Instruction &instruction,
-                              std::unordered_set<const Value *> &values) {
+                              std::unordered_set<ValueId> &values) {
   switch (instruction.getOpCode()) {
   case OpCode::Store: {
     const auto &store = static_cast<const StoreInst &>(instruction);
-    if (store.getSource() && isOwned(store.getSource()->getOwnership())) {
-      values.insert(store.getSource().get());
+    if (isOwnedValue(function, store.getSource())) {
+      values.insert(store.getSource());
     }
     return;
   }
   case OpCode::Ret: {
     const auto &ret = static_cast<const ReturnInst &>(instruction);
-    if (ret.getValue() && isOwned(ret.getValue()->getOwnership())) {
-      values.insert(ret.getValue().get());
+    if (isOwnedValue(function, ret.getValue())) {
+      values.insert(ret.getValue());
     }
     return;
   }
   case OpCode::Cast: {
     const auto &cast = static_cast<const CastInst &>(instruction);
-    if (cast.getSource() && cast.getResult() &&
-        isOwned(cast.getResult()->getOwnership())) {
-      values.insert(cast.getSource().get());
+    if (cast.getSource() != NoValue &&
+        isOwnedValue(function, cast.getResult())) {
+      values.insert(cast.getSource());
     }
     return;
   }
   case OpCode::Call: {
     const auto &call = static_cast<const CallInst &>(instruction);
     for (size_t i = 0; i < call.getArguments().size(); ++i) {
-      if (call.getArguments()[i] && callTransfersOwnership(module, call, i)) {
-        values.insert(call.getArguments()[i].get());
+      if (call.getArguments()[i] != NoValue &&
+          callTransfersOwnership(module, function, call, i)) {
+        values.insert(call.getArguments()[i]);
       }
     }
     return;
   }
   case OpCode::Move:
-    values.insert(static_cast<const MoveInst &>(instruction).getSource().get());
+    values.insert(static_cast<const MoveInst &>(instruction).getSource());
     return;
   case OpCode::Destroy:
-    values.insert(
-        static_cast<const DestroyInst &>(instruction).getValue().get());
+    values.insert(static_cast<const DestroyInst &>(instruction).getValue());
     return;
   default:
     return;
@@ -173,14 +179,13 @@ void collectTransferredValues(const Module &module,
 struct PendingEdgeClosure {
   BasicBlock *source;
   BasicBlock *destination;
-  std::vector<std::shared_ptr<Value>> values;
+  std::vector<ValueId> values;
 };
 
 bool splitEdgeWithDestroys(
-    BasicBlock &source, BasicBlock &destination,
-    const std::vector<std::shared_ptr<Value>> &values, const char *labelPrefix,
-    std::unordered_set<std::string> &labels, size_t &edgeIndex,
-    std::vector<std::unique_ptr<BasicBlock>> &edgeBlocks) {
+    Function &function, BasicBlock &source, BasicBlock &destination,
+    const std::vector<ValueId> &values, const char *labelPrefix,
+    size_t &edgeIndex, std::vector<std::unique_ptr<BasicBlock>> &edgeBlocks) {
   if (values.empty() || source.getInstructions().empty()) {
     return false;
   }
@@ -189,14 +194,14 @@ bool splitEdgeWithDestroys(
     return false;
   }
   if (terminator->getOpCode() == OpCode::Br) {
-    if (static_cast<const BranchInst &>(*terminator).getTarget() !=
-        destination.label) {
+    if (static_cast<const BranchInst &>(*terminator).getTargetBlock() !=
+        destination.id) {
       return false;
     }
   } else if (terminator->getOpCode() == OpCode::CondBr) {
     const auto &branch = static_cast<const CondBranchInst &>(*terminator);
-    if (branch.getTrueLabel() != destination.label &&
-        branch.getFalseLabel() != destination.label) {
+    if (branch.getTrueBlock() != destination.id &&
+        branch.getFalseBlock() != destination.id) {
       return false;
     }
   } else {
@@ -206,22 +211,23 @@ bool splitEdgeWithDestroys(
   std::string edgeLabel;
   do {
     edgeLabel = std::string(labelPrefix) + std::to_string(edgeIndex++);
-  } while (!labels.insert(edgeLabel).second);
+  } while (function.hasBlockLabel(edgeLabel));
+  const auto edgeId = function.internBlockLabel(edgeLabel);
   auto edge = std::make_unique<BasicBlock>(edgeLabel);
-  for (const auto &value : values) {
+  for (const auto value : values) {
     edge->addInstruction(std::make_unique<DestroyInst>(value));
   }
   edge->addInstruction(std::make_unique<BranchInst>(destination.label));
   if (terminator->getOpCode() == OpCode::Br) {
-    static_cast<BranchInst &>(*terminator).setTarget(edgeLabel);
+    static_cast<BranchInst &>(*terminator).setTarget(edgeLabel, edgeId);
   } else {
     static_cast<CondBranchInst &>(*terminator)
-        .replaceTarget(destination.label, edgeLabel);
+        .replaceTarget(destination.id, edgeLabel, edgeId);
   }
   for (const auto &instruction : destination.getInstructions()) {
     if (instruction && instruction->getOpCode() == OpCode::Phi) {
       static_cast<PhiInst &>(*instruction)
-          .replaceIncomingLabel(source.label, edgeLabel);
+          .replaceIncomingBlock(source.id, edgeLabel, edgeId);
     }
   }
   edgeBlocks.push_back(std::move(edge));
@@ -229,46 +235,21 @@ bool splitEdgeWithDestroys(
 }
 
 void lowerUnambiguousOwnershipClosures(Module &module, Function &function) {
-  std::unordered_map<const Value *, std::shared_ptr<Value>> values;
-  for (const auto &argument : function.getArguments()) {
-    if (argument) {
-      values.emplace(argument.get(), argument);
-    }
-  }
-  for (const auto &blockOwner : function.getBlocks()) {
-    if (!blockOwner) {
-      continue;
-    }
-    for (const auto &instruction : blockOwner->getInstructions()) {
-      if (const auto value =
-              instruction ? instructionResult(*instruction) : nullptr;
-          value) {
-        values.emplace(value.get(), value);
-      }
-    }
-  }
-
   ControlFlowGraph cfg(function);
   OwnershipFlowAnalysis analysis(module, function, cfg.predecessors(),
                                  cfg.successors(), cfg.reachable());
-  std::unordered_map<BasicBlock *,
-                     std::vector<std::pair<size_t, std::shared_ptr<Value>>>>
+  std::unordered_map<BasicBlock *, std::vector<std::pair<size_t, ValueId>>>
       destroys;
   std::vector<PendingEdgeClosure> criticalEdgeClosures;
   for (const auto &plan : analysis.analyzeOwnershipClosurePlans()) {
     for (const auto &placement : plan.destroyPlacements) {
-      const auto value = values.find(plan.value);
-      if (value == values.end()) {
-        continue;
-      }
-
       BasicBlock *block = nullptr;
       size_t insertionIndex = 0;
       if (placement.kind == OwnershipDestroyPlacementKind::BeforeReturn) {
         if (!placement.destination || !placement.instructionIndex) {
           continue;
         }
-        block = function.findBlock(placement.destination->label);
+        block = function.getBlock(placement.destination->id);
         insertionIndex = *placement.instructionIndex;
         const auto *returnInstruction =
             block && insertionIndex < block->getInstructions().size()
@@ -282,11 +263,11 @@ void lowerUnambiguousOwnershipClosures(Module &module, Function &function) {
         if (!placement.source || !placement.destination) {
           continue;
         }
-        block = function.findBlock(placement.source->label);
+        block = function.getBlock(placement.source->id);
         const auto successors =
             block ? cfg.successors().find(block) : cfg.successors().end();
         if (placement.requiresEdgeSplit) {
-          auto *destination = function.findBlock(placement.destination->label);
+          auto *destination = function.getBlock(placement.destination->id);
           if (!block || !destination || successors == cfg.successors().end() ||
               successors->second.size() <= 1) {
             continue;
@@ -298,10 +279,9 @@ void lowerUnambiguousOwnershipClosures(Module &module, Function &function) {
                        candidate.destination == destination;
               });
           if (closure == criticalEdgeClosures.end()) {
-            criticalEdgeClosures.push_back(
-                {block, destination, {value->second}});
+            criticalEdgeClosures.push_back({block, destination, {plan.value}});
           } else {
-            closure->values.push_back(value->second);
+            closure->values.push_back(plan.value);
           }
           continue;
         }
@@ -319,7 +299,7 @@ void lowerUnambiguousOwnershipClosures(Module &module, Function &function) {
       } else {
         continue;
       }
-      destroys[block].emplace_back(insertionIndex, value->second);
+      destroys[block].emplace_back(insertionIndex, plan.value);
     }
   }
 
@@ -336,17 +316,12 @@ void lowerUnambiguousOwnershipClosures(Module &module, Function &function) {
     }
   }
 
-  std::unordered_set<std::string> labels;
-  for (const auto &blockOwner : function.getBlocks()) {
-    if (blockOwner) {
-      labels.insert(blockOwner->label);
-    }
-  }
   size_t edgeIndex = 0;
   std::vector<std::unique_ptr<BasicBlock>> edgeBlocks;
   for (const auto &closure : criticalEdgeClosures) {
-    splitEdgeWithDestroys(*closure.source, *closure.destination, closure.values,
-                          "ownership.close.", labels, edgeIndex, edgeBlocks);
+    splitEdgeWithDestroys(function, *closure.source, *closure.destination,
+                          closure.values, "ownership.close.", edgeIndex,
+                          edgeBlocks);
   }
   for (auto &edge : edgeBlocks) {
     function.addBlock(std::move(edge));
@@ -367,19 +342,19 @@ void lowerDeadOwnedResults(Module &module) {
         continue;
       }
       auto &instructions = blockOwner->instructions;
-      std::vector<std::pair<size_t, std::shared_ptr<Value>>> destroys;
-      std::vector<std::shared_ptr<Value>> ownedResults;
-      std::unordered_set<const Value *> seenResults;
-      std::unordered_set<const Value *> transferredBefore;
+      std::vector<std::pair<size_t, ValueId>> destroys;
+      std::vector<ValueId> ownedResults;
+      std::unordered_set<ValueId> seenResults;
+      std::unordered_set<ValueId> transferredBefore;
       for (size_t i = 0; i < instructions.size(); ++i) {
         if (!instructions[i]) {
           continue;
         }
         const auto result = instructionResult(*instructions[i]);
-        if (!ownsManagedValue(result)) {
+        if (!ownsManagedValue(*function, result)) {
           continue;
         }
-        if (seenResults.insert(result.get()).second) {
+        if (seenResults.insert(result).second) {
           ownedResults.push_back(result);
         }
         if (!liveness.isLiveAfter(*blockOwner, i, result)) {
@@ -390,14 +365,16 @@ void lowerDeadOwnedResults(Module &module) {
         if (!instructions[i]) {
           continue;
         }
-        for (const auto &value : ownedResults) {
+        for (const auto value : ownedResults) {
           if (liveness.isLastUse(*blockOwner, i, value) &&
-              !transfersOwnership(module, *instructions[i], value) &&
-              transferredBefore.count(value.get()) == 0) {
+              !transfersOwnership(module, *function, *instructions[i],
+                                  value) &&
+              transferredBefore.count(value) == 0) {
             destroys.emplace_back(destroyInsertionIndex(*blockOwner, i), value);
           }
         }
-        collectTransferredValues(module, *instructions[i], transferredBefore);
+        collectTransferredValues(module, *function, *instructions[i],
+                                 transferredBefore);
       }
       std::sort(destroys.begin(), destroys.end(),
                 [](const auto &lhs, const auto &rhs) {
@@ -411,12 +388,6 @@ void lowerDeadOwnedResults(Module &module) {
       }
     }
 
-    std::unordered_set<std::string> labels;
-    for (const auto &blockOwner : function->getBlocks()) {
-      if (blockOwner) {
-        labels.insert(blockOwner->label);
-      }
-    }
     size_t edgeIndex = 0;
     std::vector<std::unique_ptr<BasicBlock>> edgeBlocks;
     for (const auto &sourceOwner : function->getBlocks()) {
@@ -429,27 +400,28 @@ void lowerDeadOwnedResults(Module &module) {
                           terminator->getOpCode() != OpCode::CondBr)) {
         continue;
       }
-      std::vector<std::string> targets;
+      std::vector<BlockId> targets;
       if (terminator->getOpCode() == OpCode::Br) {
         targets.push_back(
-            static_cast<const BranchInst &>(*terminator).getTarget());
+            static_cast<const BranchInst &>(*terminator).getTargetBlock());
       } else {
         const auto &branch = static_cast<const CondBranchInst &>(*terminator);
-        targets.push_back(branch.getTrueLabel());
-        if (branch.getFalseLabel() != branch.getTrueLabel()) {
-          targets.push_back(branch.getFalseLabel());
+        targets.push_back(branch.getTrueBlock());
+        if (branch.getFalseBlock() != branch.getTrueBlock()) {
+          targets.push_back(branch.getFalseBlock());
         }
       }
-      for (const auto &targetLabel : targets) {
-        auto *destination = function->findBlock(targetLabel);
+      for (const auto target : targets) {
+        auto *destination = function->getBlock(target);
         if (!destination) {
           continue;
         }
-        std::vector<std::shared_ptr<Value>> destroys;
-        std::unordered_set<const Value *> transferredValues;
+        std::vector<ValueId> destroys;
+        std::unordered_set<ValueId> transferredValues;
         for (const auto &use : source.getInstructions()) {
           if (use) {
-            collectTransferredValues(module, *use, transferredValues);
+            collectTransferredValues(module, *function, *use,
+                                     transferredValues);
           }
         }
         for (const auto &instruction : source.getInstructions()) {
@@ -457,20 +429,19 @@ void lowerDeadOwnedResults(Module &module) {
             continue;
           }
           const auto value = instructionResult(*instruction);
-          if (!ownsManagedValue(value) ||
+          if (!ownsManagedValue(*function, value) ||
               liveness.isLiveOnEdge(source, *destination, value)) {
             continue;
           }
-          if (transferredValues.count(value.get()) == 0) {
+          if (transferredValues.count(value) == 0) {
             destroys.push_back(value);
           }
         }
         if (destroys.empty()) {
           continue;
         }
-        splitEdgeWithDestroys(source, *destination, destroys,
-                              "ownership.destroy.", labels, edgeIndex,
-                              edgeBlocks);
+        splitEdgeWithDestroys(*function, source, *destination, destroys,
+                              "ownership.destroy.", edgeIndex, edgeBlocks);
       }
     }
     for (auto &edge : edgeBlocks) {
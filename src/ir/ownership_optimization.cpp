@@ -0,0 +1,243 @@
+#include "ownership_optimization.hpp"
+
+#include "control_flow_graph.hpp"
+#include "ownership_liveness.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+namespace zir {
+namespace {
+
+// Runs after ownership lowering, when every owned value already ends in an
+// explicit Destroy. A Copy lowers to a retain and a Destroy to a release, so
+// each pair removed here saves one of each at run time.
+
+bool tracksOwnership(const Value *value) {
+  return value && isOwned(value->getOwnership()) &&
+         containsManagedValues(value->getType());
+}
+
+bool destroys(const Instruction &instruction, ValueId value) {
+  return instruction.getOpCode() == OpCode::Destroy &&
+         static_cast<const DestroyInst &>(instruction).getValue() == value;
+}
+
+// Instructions that cannot release anything, so a reference held across
+// them keeps no object alive that would otherwise die there.
+bool cannotRelease(const Instruction &instruction) {
+  switch (instruction.getOpCode()) {
+  case OpCode::Alloca:
+  case OpCode::Load:
+  case OpCode::Add:
+  case OpCode::Sub:
+  case OpCode::Mul:
+  case OpCode::SDiv:
+  case OpCode::UDiv:
+  case OpCode::SRem:
+  case OpCode::URem:
+  case OpCode::Shl:
+  case OpCode::LShr:
+  case OpCode::AShr:
+  case OpCode::BitAnd:
+  case OpCode::BitOr:
+  case OpCode::BitXor:
+  case OpCode::Cmp:
+  case OpCode::Copy:
+  case OpCode::Borrow:
+  case OpCode::GetElementPtr:
+  case OpCode::Cast:
+  case OpCode::WeakAlive:
+  case OpCode::ClassIs:
+    return true;
+  case OpCode::Store:
+  case OpCode::Br:
+  case OpCode::CondBr:
+  case OpCode::Ret:
+  case OpCode::Call:
+  case OpCode::Move:
+  case OpCode::Destroy:
+  case OpCode::Alloc:
+  case OpCode::Phi:
+  case OpCode::WeakLock:
+  case OpCode::InlineAsm:
+    return false;
+  }
+  return false;
+}
+
+class OwnershipOptimizer {
+public:
+  OwnershipOptimizer(const Module &module, Function &function)
+      : function_(function), cfg_(function),
+        liveness_(analyzeOwnershipLiveness(module, function, cfg_)) {}
+
+  void run() {
+    for (const auto &blockOwner : function_.getBlocks()) {
+      if (!blockOwner || !cfg_.isReachable(*blockOwner)) {
+        continue;
+      }
+      auto &instructions = blockOwner->instructions;
+      for (size_t i = 0; i < instructions.size(); ++i) {
+        if (!instructions[i] || instructions[i]->getOpCode() != OpCode::Copy) {
+          continue;
+        }
+        const auto &copy = static_cast<const CopyInst &>(*instructions[i]);
+        if (removeDeadCopy(*blockOwner, i, copy)) {
+          continue;
+        }
+        forwardLastUse(*blockOwner, i, copy);
+      }
+    }
+    for (const auto &blockOwner : function_.getBlocks()) {
+      if (!blockOwner) {
+        continue;
+      }
+      auto &instructions = blockOwner->instructions;
+      instructions.erase(
+          std::remove_if(instructions.begin(), instructions.end(),
+                         [&](const std::unique_ptr<Instruction> &instruction) {
+                           return removed_.count(instruction.get()) != 0;
+                         }),
+          instructions.end());
+    }
+  }
+
+private:
+  Function &function_;
+  ControlFlowGraph cfg_;
+  OwnershipLiveness liveness_;
+  std::unordered_set<const Instruction *> removed_;
+
+  bool usesValue(const Instruction &instruction, ValueId value) const {
+    if (instruction.getOpCode() == OpCode::Phi) {
+      for (const auto &incoming :
+           static_cast<const PhiInst &>(instruction).getIncoming()) {
+        if (incoming.second == value) {
+          return true;
+        }
+      }
+      return false;
+    }
+    return liveness_.usesValue(instruction, value);
+  }
+
+  // Index of the Destroy that ends `value` in `block` when nothing else
+  // reads it from `start` on.
+  std::optional<size_t> findClosingDestroy(const BasicBlock &block,
+                                           size_t start, ValueId value) const {
+    const auto &instructions = block.getInstructions();
+    for (size_t i = start; i < instructions.size(); ++i) {
+      const auto *instruction = instructions[i].get();
+      if (!instruction) {
+        continue;
+      }
+      if (destroys(*instruction, value)) {
+        if (removed_.count(instruction) != 0) {
+          return std::nullopt;
+        }
+        return i;
+      }
+      if (usesValue(*instruction, value)) {
+        return std::nullopt;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // `%copy = copy %x` whose result is only destroyed, with nothing in
+  // between that could release %x: the retain and release cancel out.
+  bool removeDeadCopy(BasicBlock &block, size_t index, const CopyInst &copy) {
+    const ValueId result = copy.getResult();
+    if (!tracksOwnership(function_.getValue(result))) {
+      return false;
+    }
+    const auto &instructions = block.getInstructions();
+    for (size_t i = index + 1; i < instructions.size(); ++i) {
+      const auto *instruction = instructions[i].get();
+      if (!instruction) {
+        continue;
+      }
+      if (destroys(*instruction, result)) {
+        removed_.insert(instructions[index].get());
+        removed_.insert(instruction);
+        return true;
+      }
+      if (usesValue(*instruction, result) || !cannotRelease(*instruction)) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // `%copy = copy %owned` where the only thing left to do with %owned on
+  // every path is destroying it: hand its reference over instead. The
+  // closing Destroy may sit in the same block or, past a branch, at the top
+  // of successors that are reached only from here (the edge blocks
+  // ownership lowering splits out).
+  void forwardLastUse(BasicBlock &block, size_t index, const CopyInst &copy) {
+    const ValueId source = copy.getSource();
+    const Value *sourceValue = function_.getValue(source);
+    const Value *resultValue = function_.getValue(copy.getResult());
+    if (!tracksOwnership(sourceValue) || !resultValue ||
+        resultValue->getOwnership() != sourceValue->getOwnership()) {
+      return;
+    }
+
+    std::vector<const Instruction *> closingDestroys;
+    const auto &instructions = block.getInstructions();
+    if (const auto destroyIndex = findClosingDestroy(block, index + 1, source);
+        destroyIndex) {
+      closingDestroys.push_back(instructions[*destroyIndex].get());
+    } else {
+      const auto *terminator =
+          instructions.empty() ? nullptr : instructions.back().get();
+      if (!terminator || (terminator->getOpCode() != OpCode::Br &&
+                          terminator->getOpCode() != OpCode::CondBr)) {
+        return;
+      }
+      for (size_t i = index + 1; i < instructions.size(); ++i) {
+        if (instructions[i] && usesValue(*instructions[i], source)) {
+          return;
+        }
+      }
+      const auto successors = cfg_.successors().find(&block);
+      if (successors == cfg_.successors().end() ||
+          successors->second.empty()) {
+        return;
+      }
+      for (const auto *successor : successors->second) {
+        const auto predecessors = cfg_.predecessors().find(successor);
+        if (predecessors == cfg_.predecessors().end() ||
+            predecessors->second.size() != 1 ||
+            !liveness_.isLiveOnEdge(block, *successor, source)) {
+          return;
+        }
+        const auto destroyIndex = findClosingDestroy(*successor, 0, source);
+        if (!destroyIndex) {
+          return;
+        }
+        closingDestroys.push_back(
+            successor->getInstructions()[*destroyIndex].get());
+      }
+    }
+
+    removed_.insert(closingDestroys.begin(), closingDestroys.end());
+    block.instructions[index] =
+        std::make_unique<MoveInst>(copy.getResult(), source);
+  }
+};
+
+} // namespace
+
+void optimizeOwnershipOperations(Module &module) {
+  for (const auto &function : module.getFunctions()) {
+    if (function) {
+      OwnershipOptimizer(module, *function).run();
+    }
+  }
+}
+
+} // namespace zir
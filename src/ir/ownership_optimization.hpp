@@ -0,0 +1,9 @@
+#pragma once
+
+#include "module.hpp"
+
+namespace zir {
+
+void optimizeOwnershipOperations(Module &module);
+
+} // namespace zir
@@ -378,7 +378,10 @@ inline bool transfersOwnership(ParameterOwnership ownership) {
          ownership == ParameterOwnership::Sink;
 }
 
-inline bool containsManagedValues(const std::shared_ptr<Type> &type);
+inline bool containsManagedValues(const Type *type);
+inline bool containsManagedValues(const std::shared_ptr<Type> &type) {
+  return containsManagedValues(type.get());
+}
 
 class FunctionPointerType : public Type {
   std::vector<std::shared_ptr<Type>> params;
@@ -462,7 +465,7 @@ public:
   bool returnsRef() const { return returnsRef_; }
 };
 
-inline bool containsManagedValues(const std::shared_ptr<Type> &type) {
+inline bool containsManagedValues(const Type *type) {
   if (!type) {
     return false;
   }
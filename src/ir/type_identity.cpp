@@ -28,6 +28,7 @@ class TypeIdentityBuilder {
 public:
   static TypeId build(const Type &type) {
     std::vector<TypeId::Atom> atoms;
+    atoms.reserve(4);
     append(type, atoms);
     return TypeId(std::move(atoms));
   }
@@ -168,11 +169,11 @@ std::string TypeId::mangleKey() const {
   return result;
 }
 
-TypeId TypeInterner::intern(const Type &type) const {
+const TypeId &TypeInterner::intern(const Type &type) const {
   return *identities_.emplace(TypeIdentityBuilder::build(type)).first;
 }
 
-TypeId TypeInterner::intern(const std::shared_ptr<Type> &type) const {
+const TypeId &TypeInterner::intern(const std::shared_ptr<Type> &type) const {
   if (!type) {
     throw std::invalid_argument("cannot intern a null type");
   }
@@ -183,15 +184,14 @@ std::string TypeInterner::mangleKey(const std::shared_ptr<Type> &type) const {
   return intern(type).mangleKey();
 }
 
-bool TypeInterner::same(const std::shared_ptr<Type> &lhs,
-                        const std::shared_ptr<Type> &rhs) const {
+bool TypeInterner::same(const Type *lhs, const Type *rhs) const {
   if (lhs == rhs) {
     return true;
   }
   if (!lhs || !rhs) {
     return false;
   }
-  return intern(lhs) == intern(rhs);
+  return &intern(*lhs) == &intern(*rhs);
 }
 
 bool sameType(const std::shared_ptr<Type> &lhs,
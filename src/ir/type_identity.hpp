@@ -42,14 +42,20 @@ struct TypeIdHash {
   size_t operator()(const TypeId &id) const;
 };
 
+/// @brief Hash-conses type identities. Equal types intern to the same
+/// 'TypeId' object, which stays put for the interner's lifetime, so callers
+/// may compare and hash identities by address.
 class TypeInterner {
 public:
-  TypeId intern(const Type &type) const;
-  TypeId intern(const std::shared_ptr<Type> &type) const;
+  const TypeId &intern(const Type &type) const;
+  const TypeId &intern(const std::shared_ptr<Type> &type) const;
   std::string mangleKey(const std::shared_ptr<Type> &type) const;
 
+  bool same(const Type *lhs, const Type *rhs) const;
   bool same(const std::shared_ptr<Type> &lhs,
-            const std::shared_ptr<Type> &rhs) const;
+            const std::shared_ptr<Type> &rhs) const {
+    return same(lhs.get(), rhs.get());
+  }
 
   size_t size() const { return identities_.size(); }
 
@@ -1,8 +1,13 @@
 #pragma once
+#include "../utils/arena.hpp"
 #include "type.hpp"
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <optional>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace zir {
@@ -29,138 +34,131 @@ inline bool isOwned(ValueOwnership ownership) {
   return ownership != ValueOwnership::Borrowed;
 }
 
-inline ValueOwnership ownedForType(const std::shared_ptr<Type> &type) {
+inline ValueOwnership ownedForType(const Type *type) {
   if (type && type->getKind() == TypeKind::Class &&
-      std::static_pointer_cast<ClassType>(type)->isWeak()) {
+      static_cast<const ClassType *>(type)->isWeak()) {
     return ValueOwnership::OwnedWeak;
   }
   return ValueOwnership::OwnedStrong;
 }
 
+inline ValueOwnership ownedForType(const std::shared_ptr<Type> &type) {
+  return ownedForType(type.get());
+}
+
 class Value {
+  Type *type_;
   ValueOwnership ownership_ = ValueOwnership::Borrowed;
 
+protected:
+  explicit Value(Type *type) : type_(type) {}
+
 public:
+  Value(const Value &) = delete;
+  Value &operator=(const Value &) = delete;
   virtual ~Value() = default;
   virtual ValueKind getKind() const = 0;
   virtual std::string getName() const = 0;
-  virtual std::shared_ptr<Type> getType() const = 0;
-  std::string getTypeName() const { return getType()->toString(); }
+  Type *getType() const { return type_; }
+  std::string getTypeName() const { return type_->toString(); }
   ValueOwnership getOwnership() const { return ownership_; }
   void setOwnership(ValueOwnership ownership) { ownership_ = ownership; }
 };
 
 class GlobalAddress : public Value {
   std::string linkName;
-  std::shared_ptr<Type> type;
   std::optional<size_t> arrayIndex;
 
 public:
-  GlobalAddress(std::string ln, std::shared_ptr<Type> t,
+  GlobalAddress(std::string ln, Type *t,
                 std::optional<size_t> index = std::nullopt)
-      : linkName(std::move(ln)), type(std::move(t)), arrayIndex(index) {}
+      : Value(t), linkName(std::move(ln)), arrayIndex(index) {}
 
   ValueKind getKind() const override { return ValueKind::GlobalAddress; }
   std::string getName() const override { return "@" + linkName; }
-  std::shared_ptr<Type> getType() const override { return type; }
   const std::string &getLinkName() const { return linkName; }
   const std::optional<size_t> &getArrayIndex() const { return arrayIndex; }
 };
 
 class Register : public Value {
   std::string name;
-  std::shared_ptr<Type> type;
 
 public:
-  Register(std::string n, std::shared_ptr<Type> t)
-      : name(std::move(n)), type(std::move(t)) {}
+  Register(std::string n, Type *t) : Value(t), name(std::move(n)) {}
   ValueKind getKind() const override { return ValueKind::Register; }
   std::string getName() const override { return "%" + name; }
-  std::shared_ptr<Type> getType() const override { return type; }
   const std::string &getRawName() const { return name; }
 };
 
 class Constant : public Value {
   std::string value;
-  std::shared_ptr<Type> type;
 
 public:
-  Constant(std::string v, std::shared_ptr<Type> t)
-      : value(std::move(v)), type(std::move(t)) {}
+  Constant(std::string v, Type *t) : Value(t), value(std::move(v)) {}
   ValueKind getKind() const override { return ValueKind::Constant; }
   std::string getName() const override { return value; }
-  std::shared_ptr<Type> getType() const override { return type; }
   const std::string &getLiteral() const { return value; }
 };
 
+/// @brief Constant initializer of a record. Fields are values of the same
+/// table, so they are held by pointer rather than by id.
 class AggregateConstant : public Value {
 public:
   struct FieldValue {
     std::string name;
-    std::shared_ptr<Value> value;
+    const Value *value;
   };
 
 private:
-  std::shared_ptr<Type> type;
   std::vector<FieldValue> fields;
 
 public:
-  AggregateConstant(std::shared_ptr<Type> t, std::vector<FieldValue> f)
-      : type(std::move(t)), fields(std::move(f)) {}
+  AggregateConstant(Type *t, std::vector<FieldValue> f)
+      : Value(t), fields(std::move(f)) {}
 
   ValueKind getKind() const override { return ValueKind::AggregateConstant; }
   std::string getName() const override { return "<aggregate>"; }
-  std::shared_ptr<Type> getType() const override { return type; }
 
   const std::vector<FieldValue> &getFields() const { return fields; }
 };
 
 class ArrayConstant : public Value {
-  std::shared_ptr<Type> type;
-  std::vector<std::shared_ptr<Value>> elements;
+  std::vector<const Value *> elements;
 
 public:
-  ArrayConstant(std::shared_ptr<Type> t, std::vector<std::shared_ptr<Value>> e)
-      : type(std::move(t)), elements(std::move(e)) {}
+  ArrayConstant(Type *t, std::vector<const Value *> e)
+      : Value(t), elements(std::move(e)) {}
 
   ValueKind getKind() const override { return ValueKind::ArrayConstant; }
   std::string getName() const override { return "<array>"; }
-  std::shared_ptr<Type> getType() const override { return type; }
 
-  const std::vector<std::shared_ptr<Value>> &getElements() const {
-    return elements;
-  }
+  const std::vector<const Value *> &getElements() const { return elements; }
 };
 
 class Argument : public Value {
   std::string name;
-  std::shared_ptr<Type> type;
   bool isRef_;
   bool isVariadicPack_;
-  std::shared_ptr<Type> variadicElementType_;
+  Type *variadicElementType_;
   ParameterOwnership parameterOwnership_;
   ParameterEscape parameterEscape_;
 
 public:
-  Argument(std::string n, std::shared_ptr<Type> t, bool isRef = false,
-           bool isVariadicPack = false,
-           std::shared_ptr<Type> variadicElementType = nullptr,
+  Argument(std::string n, Type *t, bool isRef = false,
+           bool isVariadicPack = false, Type *variadicElementType = nullptr,
            ParameterOwnership parameterOwnership = ParameterOwnership::Borrow,
            ParameterEscape parameterEscape = ParameterEscape::Unspecified)
-      : name(std::move(n)), type(std::move(t)), isRef_(isRef),
+      : Value(t), name(std::move(n)), isRef_(isRef),
         isVariadicPack_(isVariadicPack),
-        variadicElementType_(std::move(variadicElementType)),
+        variadicElementType_(variadicElementType),
         parameterOwnership_(parameterOwnership),
         parameterEscape_(parameterEscape) {}
   ValueKind getKind() const override { return ValueKind::Argument; }
   std::string getName() const override { return "%" + name; }
-  std::shared_ptr<Type> getType() const override { return type; }
   const std::string &getRawName() const { return name; }
   bool isRef() const { return isRef_; }
   bool isVariadicPack() const { return isVariadicPack_; }
-  const std::shared_ptr<Type> &getVariadicElementType() const {
-    return variadicElementType_;
-  }
+  Type *getVariadicElementType() const { return variadicElementType_; }
   ParameterOwnership getParameterOwnership() const {
     return parameterOwnership_;
   }
@@ -169,40 +167,141 @@ public:
 
 class FunctionReference : public Value {
   std::string linkName;
-  std::shared_ptr<FunctionPointerType> type;
 
 public:
-  FunctionReference(std::string name, std::shared_ptr<FunctionPointerType> type)
-      : linkName(std::move(name)), type(std::move(type)) {}
+  FunctionReference(std::string name, FunctionPointerType *type)
+      : Value(type), linkName(std::move(name)) {}
 
   ValueKind getKind() const override { return ValueKind::FunctionReference; }
   std::string getName() const override { return "@" + linkName; }
-  std::shared_ptr<Type> getType() const override { return type; }
+  const FunctionPointerType &getFunctionType() const {
+    return static_cast<const FunctionPointerType &>(*getType());
+  }
   const std::string &getLinkName() const { return linkName; }
 };
 
+/// @brief A module variable. Its value is the variable's address, so
+/// getType() is the pointer type and getValueType() the stored one.
 class Global : public Value {
   std::string name;
   std::string linkName;
-  std::shared_ptr<Type> type;
-  std::shared_ptr<Value> initializer;
+  Type *valueType;
+  const Value *initializer;
   bool isConst;
 
 public:
-  Global(std::string n, std::string ln, std::shared_ptr<Type> t,
-         std::shared_ptr<Value> init = nullptr, bool isConstant = false)
-      : name(std::move(n)), linkName(std::move(ln)), type(std::move(t)),
-        initializer(std::move(init)), isConst(isConstant) {}
+  Global(std::string n, std::string ln, PointerType *pointerType,
+         Type *storedType, const Value *init = nullptr,
+         bool isConstant = false)
+      : Value(pointerType), name(std::move(n)), linkName(std::move(ln)),
+        valueType(storedType), initializer(init), isConst(isConstant) {}
   ValueKind getKind() const override { return ValueKind::Global; }
   std::string getName() const override { return "@" + linkName; }
-  std::shared_ptr<Type> getType() const override {
-    return std::make_shared<PointerType>(type);
-  }
   const std::string &getRawName() const { return name; }
   const std::string &getLinkName() const { return linkName; }
-  const std::shared_ptr<Type> &getValueType() const { return type; }
-  const std::shared_ptr<Value> &getInitializer() const { return initializer; }
+  Type *getValueType() const { return valueType; }
+  const Value *getInitializer() const { return initializer; }
   bool isConstant() const { return isConst; }
 };
 
+/// @brief Number of a value within one ValueTable. Instructions name their
+/// operands and results by id; NoValue stands for an absent operand, such
+/// as the result of a call returning nothing.
+using ValueId = uint32_t;
+constexpr ValueId NoValue = ~ValueId{0};
+
+namespace detail {
+template <typename T> struct IsTypeHandle : std::false_type {};
+template <typename T>
+struct IsTypeHandle<std::shared_ptr<T>> : std::is_base_of<Type, T> {};
+} // namespace detail
+
+/// @brief Owns the values of a function, or of the module for globals and
+/// their initializers. Values are placed in the table's arena and dropped
+/// with it; the types they point at are interned here, so a value holds a
+/// plain 'Type *' and copying or comparing it costs no reference count.
+/// Values owned by another table, such as module globals used in a
+/// function, are entered by reference() and get an id like any other.
+class ValueTable {
+public:
+  ValueTable() = default;
+  ValueTable(const ValueTable &) = delete;
+  ValueTable &operator=(const ValueTable &) = delete;
+  ~ValueTable() {
+    for (size_t i = 0; i < values_.size(); ++i) {
+      if (!external_[i]) {
+        values_[i]->~Value();
+      }
+    }
+  }
+
+  /// @brief Creates a @p T from @p args. Type handles among them are
+  /// interned and passed on as plain pointers.
+  template <typename T, typename... Args> ValueId add(Args &&...args) {
+    static_assert(std::is_base_of_v<Value, T>);
+    static_assert(alignof(T) <= zap::Arena::alignment);
+    void *memory = arena_->allocate(sizeof(T));
+    return push(new (memory) T(internArgument(std::forward<Args>(args))...),
+                false);
+  }
+
+  /// @brief The id of @p value, owned by @p owner, entering it on first
+  /// use.
+  ValueId reference(Value &value, const ValueTable &owner) {
+    const auto [entry, inserted] =
+        references_.try_emplace(&value, static_cast<ValueId>(size()));
+    if (inserted) {
+      intern(owner.share(value.getType()));
+      push(&value, true);
+    }
+    return entry->second;
+  }
+
+  /// @brief The value with id @p id, or null for NoValue.
+  Value *get(ValueId id) const {
+    return id < values_.size() ? values_[id] : nullptr;
+  }
+
+  const Value &operator[](ValueId id) const { return *values_[id]; }
+
+  size_t size() const { return values_.size(); }
+
+  template <typename T> T *intern(const std::shared_ptr<T> &type) {
+    static_assert(std::is_base_of_v<Type, T>);
+    if (type) {
+      types_.try_emplace(type.get(), type);
+    }
+    return type.get();
+  }
+
+  /// @brief The owning handle of @p type, which a value of this table
+  /// points at, for code that keeps types by shared_ptr.
+  const std::shared_ptr<Type> &share(const Type *type) const {
+    static const std::shared_ptr<Type> none;
+    const auto entry = types_.find(type);
+    return entry == types_.end() ? none : entry->second;
+  }
+
+private:
+  template <typename A> decltype(auto) internArgument(A &&argument) {
+    if constexpr (detail::IsTypeHandle<std::decay_t<A>>::value) {
+      return intern(argument);
+    } else {
+      return std::forward<A>(argument);
+    }
+  }
+
+  ValueId push(Value *value, bool external) {
+    values_.push_back(value);
+    external_.push_back(external);
+    return static_cast<ValueId>(values_.size() - 1);
+  }
+
+  zap::ArenaRef arena_ = zap::Arena::create();
+  std::vector<Value *> values_;
+  std::vector<bool> external_;
+  std::unordered_map<const Value *, ValueId> references_;
+  std::unordered_map<const Type *, std::shared_ptr<Type>> types_;
+};
+
 } // namespace zir
@@ -139,8 +139,9 @@ ZirVerifier::verifyOwnershipObligations(const Module &module) const {
              obligation.block ? obligation.block->label : std::string{},
              obligation.instructionIndex,
              "owned value may remain live at function exit: " +
-                 plan.value->getName() + " (defined in " + definition + "; " +
-                 "state: " + formatOwnershipFlowState(obligation.state) + "; " +
+                 function->getValue(plan.value)->getName() + " (defined in " +
+                 definition + "; state: " +
+                 formatOwnershipFlowState(obligation.state) + "; " +
                  placement + ")"});
       }
     }
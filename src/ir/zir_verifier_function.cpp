@@ -61,8 +61,9 @@ private:
   std::vector<VerificationError> &errors_;
   TypeInterner &typeInterner_;
   bool includeOwnershipObligations_;
-  std::unordered_map<const Value *, DefinitionSite> definitions_;
-  std::unordered_map<std::string, const Value *> valueNames_;
+  // Indexed by ValueId; a null block marks a value no instruction defines.
+  std::vector<DefinitionSite> definitions_;
+  std::unordered_map<std::string, ValueId> valueNames_;
   ControlFlowGraph cfg_;
 
   void error(VerificationErrorCode code, const BasicBlock *block,
@@ -72,18 +73,22 @@ private:
                        std::move(message)});
   }
 
+  const Value *valueOf(ValueId id) const { return function_.getValue(id); }
+
   void verifySignature() {
     if (!function_.getReturnType()) {
       error(VerificationErrorCode::NullNode, nullptr, std::nullopt,
             "function has no return type");
     }
-    for (const auto &argument : function_.getArguments()) {
+    for (size_t i = 0; i < function_.getArguments().size(); ++i) {
+      const auto *argument = function_.getArgument(i);
       if (!argument || !argument->getType()) {
         error(VerificationErrorCode::NullNode, nullptr, std::nullopt,
               "function has a null argument or argument type");
         continue;
       }
-      if (!valueNames_.emplace(argument->getName(), argument.get()).second) {
+      if (!valueNames_.emplace(argument->getName(), function_.getArguments()[i])
+               .second) {
         error(VerificationErrorCode::DuplicateValue, nullptr, std::nullopt,
               "duplicate argument name " + argument->getName());
       }
@@ -110,7 +115,7 @@ private:
               "function contains a null basic block");
         continue;
       }
-      if (cfg_.findBlock(block->label) != block.get()) {
+      if (function_.getBlock(block->id) != block.get()) {
         error(VerificationErrorCode::DuplicateBlock, block.get(), std::nullopt,
               "duplicate basic block label " + block->label);
       }
@@ -118,6 +123,7 @@ private:
   }
 
   void collectDefinitionsAndEdges() {
+    definitions_.assign(function_.values.size(), DefinitionSite{nullptr, 0});
     for (const auto &blockOwner : function_.getBlocks()) {
       if (!blockOwner) {
         continue;
@@ -137,18 +143,19 @@ private:
         }
         sawTerminator = sawTerminator || isTerminator(instruction->getOpCode());
 
-        if (auto result = instructionResult(*instruction)) {
+        const ValueId id = instructionResult(*instruction);
+        if (const auto *result = valueOf(id)) {
           if (!result->getType()) {
             error(VerificationErrorCode::NullNode, &block, i,
                   "instruction result has no type");
           }
-          if (!definitions_.emplace(result.get(), DefinitionSite{&block, i})
-                   .second) {
+          if (definitions_[id].block) {
             error(VerificationErrorCode::DuplicateValue, &block, i,
                   "value is defined more than once: " + result->getName());
+          } else {
+            definitions_[id] = DefinitionSite{&block, i};
           }
-          auto [_, inserted] =
-              valueNames_.emplace(result->getName(), result.get());
+          auto [_, inserted] = valueNames_.emplace(result->getName(), id);
           if (!inserted) {
             error(VerificationErrorCode::DuplicateValue, &block, i,
                   "duplicate value name " + result->getName());
@@ -157,19 +164,20 @@ private:
 
         if (instruction->getOpCode() == OpCode::Br) {
           const auto &branch = static_cast<const BranchInst &>(*instruction);
-          if (!cfg_.findBlock(branch.getTarget())) {
+          if (!function_.getBlock(branch.getTargetBlock())) {
             error(VerificationErrorCode::InvalidBranchTarget, &block, i,
                   "branch targets unknown block " + branch.getTarget());
           }
         } else if (instruction->getOpCode() == OpCode::CondBr) {
           const auto &branch =
               static_cast<const CondBranchInst &>(*instruction);
-          for (const auto &label :
-               {branch.getTrueLabel(), branch.getFalseLabel()}) {
-            if (!cfg_.findBlock(label)) {
-              error(VerificationErrorCode::InvalidBranchTarget, &block, i,
-                    "branch targets unknown block " + label);
-            }
+          if (!function_.getBlock(branch.getTrueBlock())) {
+            error(VerificationErrorCode::InvalidBranchTarget, &block, i,
+                  "branch targets unknown block " + branch.getTrueLabel());
+          }
+          if (!function_.getBlock(branch.getFalseBlock())) {
+            error(VerificationErrorCode::InvalidBranchTarget, &block, i,
+                  "branch targets unknown block " + branch.getFalseLabel());
           }
         }
       }
@@ -180,9 +188,9 @@ private:
     }
   }
 
-  bool verifyValue(const std::shared_ptr<Value> &value,
-                   const BasicBlock &useBlock, size_t useIndex,
+  bool verifyValue(ValueId id, const BasicBlock &useBlock, size_t useIndex,
                    const BasicBlock *edgePredecessor = nullptr) {
+    const auto *value = valueOf(id);
     if (!value || !value->getType()) {
       error(VerificationErrorCode::NullNode, &useBlock, useIndex,
             "instruction contains a null value or value type");
@@ -192,18 +200,18 @@ private:
       return true;
     }
 
-    auto definition = definitions_.find(value.get());
-    if (definition == definitions_.end()) {
+    const auto &definition = definitions_[id];
+    if (!definition.block) {
       error(VerificationErrorCode::UndefinedValue, &useBlock, useIndex,
             "use of undefined value " + value->getName());
       return false;
     }
 
     const auto *effectiveBlock = edgePredecessor ? edgePredecessor : &useBlock;
-    if (definition->second.block == effectiveBlock) {
+    if (definition.block == effectiveBlock) {
       const size_t effectiveIndex =
           edgePredecessor ? effectiveBlock->getInstructions().size() : useIndex;
-      if (definition->second.instructionIndex >= effectiveIndex) {
+      if (definition.instructionIndex >= effectiveIndex) {
         error(VerificationErrorCode::UseBeforeDefinition, &useBlock, useIndex,
               "value is used before its definition: " + value->getName());
         return false;
@@ -212,7 +220,7 @@ private:
     }
 
     if (cfg_.isReachable(*effectiveBlock) &&
-        !cfg_.dominates(*definition->second.block, *effectiveBlock)) {
+        !cfg_.dominates(*definition.block, *effectiveBlock)) {
       error(VerificationErrorCode::DominanceViolation, &useBlock, useIndex,
             "definition of " + value->getName() + " does not dominate its use");
       return false;
@@ -220,8 +228,7 @@ private:
     return true;
   }
 
-  void expectSameType(const std::shared_ptr<Type> &actual,
-                      const std::shared_ptr<Type> &expected,
+  void expectSameType(const Type *actual, const Type *expected,
                       const BasicBlock &block, size_t index,
                       const std::string &context) {
     if (!typeInterner_.same(actual, expected)) {
@@ -231,8 +238,7 @@ private:
     }
   }
 
-  void expectAssignable(const std::shared_ptr<Type> &actual,
-                        const std::shared_ptr<Type> &expected,
+  void expectAssignable(const Type *actual, const Type *expected,
                         const BasicBlock &block, size_t index,
                         const std::string &context) {
     if (!isAssignable(actual, expected, typeInterner_)) {
@@ -257,7 +263,7 @@ private:
     }
   }
 
-  static bool ownsManagedValue(const std::shared_ptr<Value> &value) {
+  static bool ownsManagedValue(const Value *value) {
     return value && isOwned(value->getOwnership()) &&
            containsManagedValues(value->getType());
   }
@@ -268,8 +274,8 @@ private:
     }
     const auto *callee = module_.findFunction(call.getFunctionName());
     return callee && !callee->ownerTypeCodegenName.empty() &&
-           !callee->getArguments().empty() && callee->getArguments().front() &&
-           callee->getArguments().front()->getRawName() == "self";
+           !callee->getArguments().empty() &&
+           callee->getArgument(0)->getRawName() == "self";
   }
 
   void verifyOwnershipTransfers() {
@@ -279,7 +285,7 @@ private:
       error(VerificationErrorCode::OwnershipViolation, violation.block,
             violation.instructionIndex,
             "owned value is not live for " + violation.operation + ": " +
-                violation.value->getName() + " (state: " +
+                valueOf(violation.value)->getName() + " (state: " +
                 formatOwnershipFlowState(violation.priorState) + ")");
     }
     if (includeOwnershipObligations_) {
@@ -297,7 +303,7 @@ private:
         if (!instruction || instruction->getOpCode() != OpCode::Destroy) {
           continue;
         }
-        const auto &value =
+        const ValueId value =
             static_cast<const DestroyInst &>(*instruction).getValue();
         if (liveness.isLiveAfter(block, i, value)) {
           error(VerificationErrorCode::OwnershipViolation, &block, i,
@@ -341,9 +347,10 @@ private:
         error(VerificationErrorCode::OwnershipViolation, obligation.block,
               obligation.instructionIndex,
               "owned value may remain live at function exit: " +
-                  plan.value->getName() + " (defined in " + definition +
-                  "; state: " + formatOwnershipFlowState(obligation.state) +
-                  "; " + placement + ")");
+                  valueOf(plan.value)->getName() + " (defined in " +
+                  definition + "; state: " +
+                  formatOwnershipFlowState(obligation.state) + "; " +
+                  placement + ")");
       }
     }
   }
@@ -353,15 +360,16 @@ private:
     switch (instruction.getOpCode()) {
     case OpCode::Alloca: {
       const auto &alloca = static_cast<const AllocaInst &>(instruction);
-      if (!alloca.getResult() || !alloca.getAllocatedType()) {
+      const auto *result = valueOf(alloca.getResult());
+      if (!result || !alloca.getAllocatedType()) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "alloca requires a result and allocated type");
         return;
       }
-      auto pointer =
-          std::dynamic_pointer_cast<PointerType>(alloca.getResult()->getType());
-      if (!pointer || !typeInterner_.same(pointer->getBaseType(),
-                                          alloca.getAllocatedType())) {
+      const auto *pointer =
+          dynamic_cast<const PointerType *>(result->getType());
+      if (!pointer || !typeInterner_.same(pointer->getBaseType().get(),
+                                          alloca.getAllocatedType().get())) {
         error(VerificationErrorCode::TypeMismatch, &block, index,
               "alloca result must point to the allocated type");
       }
@@ -370,15 +378,17 @@ private:
     case OpCode::Load: {
       const auto &load = static_cast<const LoadInst &>(instruction);
       verifyValue(load.getSource(), block, index);
-      auto pointer = load.getSource() ? std::dynamic_pointer_cast<PointerType>(
-                                            load.getSource()->getType())
-                                      : nullptr;
-      if (!pointer || !load.getResult()) {
+      const auto *source = valueOf(load.getSource());
+      const auto *result = valueOf(load.getResult());
+      const auto *pointer =
+          source ? dynamic_cast<const PointerType *>(source->getType())
+                 : nullptr;
+      if (!pointer || !result) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "load requires a pointer source and result");
       } else {
-        expectSameType(load.getResult()->getType(), pointer->getBaseType(),
-                       block, index, "load result type");
+        expectSameType(result->getType(), pointer->getBaseType().get(), block,
+                       index, "load result type");
       }
       return;
     }
@@ -386,19 +396,21 @@ private:
       const auto &store = static_cast<const StoreInst &>(instruction);
       verifyValue(store.getSource(), block, index);
       verifyValue(store.getDestination(), block, index);
-      auto pointer = store.getDestination()
-                         ? std::dynamic_pointer_cast<PointerType>(
-                               store.getDestination()->getType())
-                         : nullptr;
-      if (!pointer || !store.getSource()) {
+      const auto *source = valueOf(store.getSource());
+      const auto *destination = valueOf(store.getDestination());
+      const auto *pointer =
+          destination
+              ? dynamic_cast<const PointerType *>(destination->getType())
+              : nullptr;
+      if (!pointer || !source) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "store requires a value and pointer destination");
       } else {
-        expectAssignable(store.getSource()->getType(), pointer->getBaseType(),
+        expectAssignable(source->getType(), pointer->getBaseType().get(),
                          block, index, "stored value type");
         if (store.getMode() == StoreMode::Initialize &&
-            containsManagedValues(store.getSource()->getType()) &&
-            !isOwned(store.getSource()->getOwnership())) {
+            containsManagedValues(source->getType()) &&
+            !isOwned(source->getOwnership())) {
           error(VerificationErrorCode::InvalidOperand, &block, index,
                 "managed initialization must transfer ownership");
         }
@@ -421,14 +433,17 @@ private:
       const auto &binary = static_cast<const BinaryInst &>(instruction);
       verifyValue(binary.getLhs(), block, index);
       verifyValue(binary.getRhs(), block, index);
-      if (!binary.getResult() || !binary.getLhs() || !binary.getRhs()) {
+      const auto *result = valueOf(binary.getResult());
+      const auto *lhs = valueOf(binary.getLhs());
+      const auto *rhs = valueOf(binary.getRhs());
+      if (!result || !lhs || !rhs) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "binary instruction requires two operands and a result");
         return;
       }
 
-      const auto lhsType = binary.getLhs()->getType();
-      const auto rhsType = binary.getRhs()->getType();
+      const auto *lhsType = lhs->getType();
+      const auto *rhsType = rhs->getType();
       const bool isAdd = instruction.getOpCode() == OpCode::Add;
       const bool isSubtract = instruction.getOpCode() == OpCode::Sub;
       const bool isStringConcat =
@@ -441,25 +456,25 @@ private:
       if (isStringConcat) {
         if ((!isStringType(lhsType) && lhsType->getKind() != TypeKind::Char) ||
             (!isStringType(rhsType) && rhsType->getKind() != TypeKind::Char) ||
-            binary.getResult()->getType()->getIntrinsicKind() !=
+            result->getType()->getIntrinsicKind() !=
                 IntrinsicTypeKind::String) {
           error(VerificationErrorCode::TypeMismatch, &block, index,
                 "string concatenation requires String/StringView/Char "
                 "operands and a String result");
         }
       } else if (isAdd && lhsPointer != rhsPointer) {
-        const auto offsetType = lhsPointer ? rhsType : lhsType;
-        const auto pointerType = lhsPointer ? lhsType : rhsType;
+        const auto *offsetType = lhsPointer ? rhsType : lhsType;
+        const auto *pointerType = lhsPointer ? lhsType : rhsType;
         if (!offsetType->isInteger()) {
           error(VerificationErrorCode::TypeMismatch, &block, index,
                 "pointer offset must be an integer");
         }
-        expectSameType(binary.getResult()->getType(), pointerType, block, index,
+        expectSameType(result->getType(), pointerType, block, index,
                        "pointer addition result type");
       } else if (isSubtract && lhsPointer && rhsPointer) {
         expectSameType(lhsType, rhsType, block, index,
                        "pointer subtraction operand type");
-        if (!binary.getResult()->getType()->isInteger()) {
+        if (!result->getType()->isInteger()) {
           error(VerificationErrorCode::TypeMismatch, &block, index,
                 "pointer subtraction result must be an integer");
         }
@@ -468,11 +483,11 @@ private:
           error(VerificationErrorCode::TypeMismatch, &block, index,
                 "pointer offset must be an integer");
         }
-        expectSameType(binary.getResult()->getType(), lhsType, block, index,
+        expectSameType(result->getType(), lhsType, block, index,
                        "pointer subtraction result type");
       } else {
         expectSameType(rhsType, lhsType, block, index, "binary operand type");
-        expectSameType(binary.getResult()->getType(), lhsType, block, index,
+        expectSameType(result->getType(), lhsType, block, index,
                        "binary result type");
       }
       return;
@@ -481,12 +496,14 @@ private:
       const auto &compare = static_cast<const CmpInst &>(instruction);
       verifyValue(compare.getLhs(), block, index);
       verifyValue(compare.getRhs(), block, index);
-      if (compare.getLhs() && compare.getRhs()) {
-        expectSameType(compare.getRhs()->getType(), compare.getLhs()->getType(),
-                       block, index, "comparison operand type");
-      }
-      if (!compare.getResult() ||
-          compare.getResult()->getType()->getKind() != TypeKind::Bool) {
+      const auto *lhs = valueOf(compare.getLhs());
+      const auto *rhs = valueOf(compare.getRhs());
+      const auto *result = valueOf(compare.getResult());
+      if (lhs && rhs) {
+        expectSameType(rhs->getType(), lhs->getType(), block, index,
+                       "comparison operand type");
+      }
+      if (!result || result->getType()->getKind() != TypeKind::Bool) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "comparison result must be Bool");
       }
@@ -497,8 +514,8 @@ private:
     case OpCode::CondBr: {
       const auto &branch = static_cast<const CondBranchInst &>(instruction);
       verifyValue(branch.getCondition(), block, index);
-      if (!branch.getCondition() ||
-          branch.getCondition()->getType()->getKind() != TypeKind::Bool) {
+      const auto *condition = valueOf(branch.getCondition());
+      if (!condition || condition->getType()->getKind() != TypeKind::Bool) {
         error(VerificationErrorCode::InvalidConditionType, &block, index,
               "conditional branch requires a Bool condition");
       }
@@ -507,28 +524,29 @@ private:
     case OpCode::Ret: {
       const auto &returnInstruction =
           static_cast<const ReturnInst &>(instruction);
-      if (returnInstruction.getValue()) {
+      const bool hasValue = returnInstruction.getValue() != NoValue;
+      if (hasValue) {
         verifyValue(returnInstruction.getValue(), block, index);
       }
+      const auto *value = valueOf(returnInstruction.getValue());
       const bool returnsVoid =
           function_.getReturnType() &&
           function_.getReturnType()->getKind() == TypeKind::Void;
-      if (returnsVoid && returnInstruction.getValue()) {
+      if (returnsVoid && hasValue) {
         error(VerificationErrorCode::InvalidReturn, &block, index,
               "void function returns a value");
-      } else if (!returnsVoid && !returnInstruction.getValue()) {
+      } else if (!returnsVoid && !hasValue) {
         error(VerificationErrorCode::InvalidReturn, &block, index,
               "non-void function returns no value");
-      } else if (returnInstruction.getValue()) {
+      } else if (value) {
         auto expectedReturnType = function_.getReturnType();
         if (function_.returnsRef) {
           expectedReturnType =
               std::make_shared<PointerType>(expectedReturnType);
         }
-        expectAssignable(returnInstruction.getValue()->getType(),
-                         expectedReturnType, block, index, "return value type");
-        if (function_.returnsRef &&
-            isOwned(returnInstruction.getValue()->getOwnership())) {
+        expectAssignable(value->getType(), expectedReturnType.get(), block,
+                         index, "return value type");
+        if (function_.returnsRef && isOwned(value->getOwnership())) {
           error(VerificationErrorCode::InvalidReturn, &block, index,
                 "ref return cannot transfer ownership");
         }
@@ -541,43 +559,44 @@ private:
     case OpCode::Copy: {
       const auto &copy = static_cast<const CopyInst &>(instruction);
       verifyValue(copy.getSource(), block, index);
-      if (!copy.getResult() || !copy.getSource() ||
-          !containsManagedValues(copy.getSource()->getType()) ||
-          copy.getResult() == copy.getSource() ||
-          copy.getResult()->getOwnership() !=
-              ownedForType(copy.getSource()->getType())) {
+      const auto *source = valueOf(copy.getSource());
+      const auto *result = valueOf(copy.getResult());
+      if (!result || !source || !containsManagedValues(source->getType()) ||
+          result == source ||
+          result->getOwnership() != ownedForType(source->getType())) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "copy requires a distinct owned result and managed source");
       } else {
-        expectSameType(copy.getResult()->getType(), copy.getSource()->getType(),
-                       block, index, "copy result type");
+        expectSameType(result->getType(), source->getType(), block, index,
+                       "copy result type");
       }
       return;
     }
     case OpCode::Move: {
       const auto &move = static_cast<const MoveInst &>(instruction);
       verifyValue(move.getSource(), block, index);
-      if (!move.getResult() || !ownsManagedValue(move.getSource()) ||
-          move.getResult() == move.getSource() ||
-          move.getResult()->getOwnership() !=
-              move.getSource()->getOwnership()) {
+      const auto *source = valueOf(move.getSource());
+      const auto *result = valueOf(move.getResult());
+      if (!result || !ownsManagedValue(source) || result == source ||
+          result->getOwnership() != source->getOwnership()) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "move requires a distinct owned result and owned managed source");
       } else {
-        expectSameType(move.getResult()->getType(), move.getSource()->getType(),
-                       block, index, "move result type");
+        expectSameType(result->getType(), source->getType(), block, index,
+                       "move result type");
       }
       return;
     }
     case OpCode::Borrow: {
       const auto &borrow = static_cast<const BorrowInst &>(instruction);
       verifyValue(borrow.getOwner(), block, index);
-      if (!borrow.getResult() || !borrow.getOwner() ||
-          borrow.getOwner()->getType()->getIntrinsicKind() !=
-              IntrinsicTypeKind::String ||
-          borrow.getResult()->getType()->getIntrinsicKind() !=
+      const auto *owner = valueOf(borrow.getOwner());
+      const auto *result = valueOf(borrow.getResult());
+      if (!result || !owner ||
+          owner->getType()->getIntrinsicKind() != IntrinsicTypeKind::String ||
+          result->getType()->getIntrinsicKind() !=
               IntrinsicTypeKind::StringView ||
-          borrow.getResult()->getOwnership() != ValueOwnership::Borrowed) {
+          result->getOwnership() != ValueOwnership::Borrowed) {
         error(
             VerificationErrorCode::InvalidOperand, &block, index,
             "borrow requires a String owner and a borrowed StringView result");
@@ -587,7 +606,7 @@ private:
     case OpCode::Destroy: {
       const auto &destroy = static_cast<const DestroyInst &>(instruction);
       verifyValue(destroy.getValue(), block, index);
-      if (!ownsManagedValue(destroy.getValue())) {
+      if (!ownsManagedValue(valueOf(destroy.getValue()))) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "destroy requires an owned managed value");
       }
@@ -595,13 +614,14 @@ private:
     }
     case OpCode::Alloc: {
       const auto &alloc = static_cast<const AllocInst &>(instruction);
-      if (!alloc.getResult() || !alloc.getAllocatedType()) {
+      const auto *result = valueOf(alloc.getResult());
+      if (!result || !alloc.getAllocatedType()) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "alloc requires a result and allocated type");
       } else {
-        expectSameType(alloc.getResult()->getType(), alloc.getAllocatedType(),
+        expectSameType(result->getType(), alloc.getAllocatedType().get(),
                        block, index, "alloc result type");
-        if (alloc.getResult()->getOwnership() != ValueOwnership::OwnedStrong) {
+        if (result->getOwnership() != ValueOwnership::OwnedStrong) {
           error(VerificationErrorCode::InvalidResult, &block, index,
                 "alloc result must be owned");
         }
@@ -618,21 +638,23 @@ private:
     case OpCode::Cast: {
       const auto &cast = static_cast<const CastInst &>(instruction);
       verifyValue(cast.getSource(), block, index);
-      if (!cast.getResult() || !cast.getTargetType() || !cast.getSource()) {
+      const auto *source = valueOf(cast.getSource());
+      const auto *result = valueOf(cast.getResult());
+      if (!result || !cast.getTargetType() || !source) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "cast requires a source, result, and target type");
       } else {
-        expectSameType(cast.getResult()->getType(), cast.getTargetType(), block,
+        expectSameType(result->getType(), cast.getTargetType().get(), block,
                        index, "cast result type");
         const auto expectedOwnership =
             cast.getTargetType()->getIntrinsicKind() ==
                     IntrinsicTypeKind::String
                 ? ValueOwnership::OwnedStrong
             : containsManagedValues(cast.getTargetType()) &&
-                    isOwned(cast.getSource()->getOwnership())
-                ? cast.getSource()->getOwnership()
+                    isOwned(source->getOwnership())
+                ? source->getOwnership()
                 : ValueOwnership::Borrowed;
-        if (cast.getResult()->getOwnership() != expectedOwnership) {
+        if (result->getOwnership() != expectedOwnership) {
           error(VerificationErrorCode::InvalidResult, &block, index,
                 "cast result ownership does not match source and target");
         }
@@ -642,27 +664,28 @@ private:
     case OpCode::WeakLock: {
       const auto &weakLock = static_cast<const WeakLockInst &>(instruction);
       verifyValue(weakLock.getWeakValue(), block, index);
-      if (!weakLock.getResult() || !weakLock.getWeakValue() ||
-          weakLock.getResult()->getType()->getKind() != TypeKind::Class ||
-          weakLock.getWeakValue()->getType()->getKind() != TypeKind::Class) {
+      const auto *weakValue = valueOf(weakLock.getWeakValue());
+      const auto *result = valueOf(weakLock.getResult());
+      if (!result || !weakValue ||
+          result->getType()->getKind() != TypeKind::Class ||
+          weakValue->getType()->getKind() != TypeKind::Class) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "weak.lock requires class operands");
       } else {
-        const auto weakType = std::static_pointer_cast<ClassType>(
-            weakLock.getWeakValue()->getType());
-        const auto resultType = std::static_pointer_cast<ClassType>(
-            weakLock.getResult()->getType());
+        const auto *weakType =
+            static_cast<const ClassType *>(weakValue->getType());
+        const auto *resultType =
+            static_cast<const ClassType *>(result->getType());
         if (!weakType->isWeak() || resultType->isWeak()) {
           error(VerificationErrorCode::InvalidOperand, &block, index,
                 "weak.lock requires a weak source and strong result");
         } else {
           auto expectedResultType = std::make_shared<ClassType>(*weakType);
           expectedResultType->setWeak(false);
-          expectSameType(weakLock.getResult()->getType(), expectedResultType,
-                         block, index, "weak.lock result type");
+          expectSameType(result->getType(), expectedResultType.get(), block,
+                         index, "weak.lock result type");
         }
-        if (weakLock.getResult()->getOwnership() !=
-            ValueOwnership::OwnedStrong) {
+        if (result->getOwnership() != ValueOwnership::OwnedStrong) {
           error(VerificationErrorCode::InvalidResult, &block, index,
                 "weak.lock result must be owned");
         }
@@ -672,8 +695,8 @@ private:
     case OpCode::WeakAlive: {
       const auto &weakAlive = static_cast<const WeakAliveInst &>(instruction);
       verifyValue(weakAlive.getWeakValue(), block, index);
-      if (!weakAlive.getResult() ||
-          weakAlive.getResult()->getType()->getKind() != TypeKind::Bool) {
+      const auto *result = valueOf(weakAlive.getResult());
+      if (!result || result->getType()->getKind() != TypeKind::Bool) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "weak.alive result must be Bool");
       }
@@ -682,10 +705,11 @@ private:
     case OpCode::ClassIs: {
       const auto &classIs = static_cast<const ClassIsInst &>(instruction);
       verifyValue(classIs.getObject(), block, index);
-      if (!classIs.getResult() || !classIs.getObject() ||
-          !classIs.getTargetType() ||
-          classIs.getResult()->getType()->getKind() != TypeKind::Bool ||
-          classIs.getObject()->getType()->getKind() != TypeKind::Class) {
+      const auto *object = valueOf(classIs.getObject());
+      const auto *result = valueOf(classIs.getResult());
+      if (!result || !object || !classIs.getTargetType() ||
+          result->getType()->getKind() != TypeKind::Bool ||
+          object->getType()->getKind() != TypeKind::Class) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "classis requires a class operand and Bool result");
       }
@@ -705,31 +729,33 @@ private:
   }
 
   void verifyCall(const CallInst &call, const BasicBlock &block, size_t index) {
-    for (const auto &argument : call.getArguments()) {
+    for (const auto argument : call.getArguments()) {
       verifyValue(argument, block, index);
     }
-    if (call.getVariadicPack()) {
+    if (call.getVariadicPack() != NoValue) {
       verifyValue(call.getVariadicPack(), block, index);
     }
 
-    std::vector<std::shared_ptr<Type>> parameterTypes;
+    std::vector<const Type *> parameterTypes;
     std::vector<ParameterOwnership> parameterOwnership;
     ResultBorrowContract resultBorrow;
     std::shared_ptr<Type> returnType;
-    const bool returnsRef = callReturnsRef(module_, call);
+    const bool returnsRef = callReturnsRef(module_, function_, call);
     bool variadic = false;
     if (call.isIndirect()) {
       verifyValue(call.getCalleeValue(), block, index);
-      auto functionType = call.getCalleeValue()
-                              ? std::dynamic_pointer_cast<FunctionPointerType>(
-                                    call.getCalleeValue()->getType())
-                              : nullptr;
+      const auto *callee = valueOf(call.getCalleeValue());
+      const auto *functionType =
+          callee ? dynamic_cast<const FunctionPointerType *>(callee->getType())
+                 : nullptr;
       if (!functionType) {
         error(VerificationErrorCode::InvalidCall, &block, index,
               "indirect call requires a function pointer");
         return;
       }
-      parameterTypes = functionType->getParams();
+      for (const auto &parameter : functionType->getParams()) {
+        parameterTypes.push_back(parameter.get());
+      }
       parameterOwnership = functionType->getParameterOwnership();
       resultBorrow = functionType->getResultBorrow();
       returnType = functionType->getReturnType();
@@ -740,7 +766,8 @@ private:
               "call targets unknown function " + call.getFunctionName());
         return;
       }
-      for (const auto &argument : callee->getArguments()) {
+      for (size_t i = 0; i < callee->getArguments().size(); ++i) {
+        const auto *argument = callee->getArgument(i);
         if (argument && !argument->isVariadicPack()) {
           parameterTypes.push_back(argument->getType());
           parameterOwnership.push_back(argument->getParameterOwnership());
@@ -750,7 +777,8 @@ private:
       resultBorrow = callee->resultBorrow;
       variadic = callee->isCVariadic ||
                  (!callee->getArguments().empty() &&
-                  callee->getArguments().back()->isVariadicPack());
+                  callee->getArgument(callee->getArguments().size() - 1)
+                      ->isVariadicPack());
     }
 
     if ((!variadic && call.getArguments().size() != parameterTypes.size()) ||
@@ -761,24 +789,24 @@ private:
     const size_t checkedArguments =
         std::min(call.getArguments().size(), parameterTypes.size());
     for (size_t i = 0; i < checkedArguments; ++i) {
-      if (call.getArguments()[i]) {
-        expectAssignable(call.getArguments()[i]->getType(), parameterTypes[i],
-                         block, index,
-                         "call argument " + std::to_string(i) + " type");
+      if (const auto *argument = valueOf(call.getArguments()[i])) {
+        expectAssignable(argument->getType(), parameterTypes[i], block,
+                         index, "call argument " + std::to_string(i) + " type");
       }
     }
-    if (call.getResult() && returnType) {
+    const auto *result = valueOf(call.getResult());
+    if (result && returnType) {
       auto expectedReturnType = returnType;
       if (returnsRef) {
         expectedReturnType = std::make_shared<PointerType>(returnType);
       }
-      expectSameType(call.getResult()->getType(), expectedReturnType, block,
-                     index, "call result type");
+      expectSameType(result->getType(), expectedReturnType.get(), block, index,
+                     "call result type");
       const auto expectedOwnership =
           !returnsRef && containsManagedValues(returnType)
               ? ownedForType(returnType)
               : ValueOwnership::Borrowed;
-      if (call.getResult()->getOwnership() != expectedOwnership) {
+      if (result->getOwnership() != expectedOwnership) {
         error(VerificationErrorCode::InvalidResult, &block, index,
               "call result ownership does not match its return type");
       }
@@ -794,7 +822,7 @@ private:
             "call result borrow source argument is out of range");
     }
     for (size_t i = 0; i < call.getArguments().size(); ++i) {
-      const auto &argument = call.getArguments()[i];
+      const auto *argument = valueOf(call.getArguments()[i]);
       const bool transfers = i < parameterOwnership.size() &&
                              transfersOwnership(parameterOwnership[i]);
       if (transfers && !ownsManagedValue(argument)) {
@@ -816,33 +844,37 @@ private:
   void verifyGetElementPtr(const GetElementPtrInst &gep,
                            const BasicBlock &block, size_t index) {
     verifyValue(gep.getPointer(), block, index);
-    if (gep.getIndexValue()) {
+    if (gep.getIndexValue() != NoValue) {
       verifyValue(gep.getIndexValue(), block, index);
-      if (!gep.getIndexValue()->getType()->isInteger()) {
+      const auto *indexValue = valueOf(gep.getIndexValue());
+      if (indexValue && !indexValue->getType()->isInteger()) {
         error(VerificationErrorCode::InvalidOperand, &block, index,
               "dynamic getelementptr index must be an integer");
       }
     }
-    if (!gep.getResult() || !gep.getPointer()) {
+    const auto *result = valueOf(gep.getResult());
+    if (!result || !valueOf(gep.getPointer())) {
       error(VerificationErrorCode::InvalidResult, &block, index,
             "getelementptr requires pointer and result operands");
       return;
     }
-    if (gep.getResult()->getType()->getKind() != TypeKind::Pointer) {
+    if (result->getType()->getKind() != TypeKind::Pointer) {
       error(VerificationErrorCode::TypeMismatch, &block, index,
             "getelementptr result must be a pointer");
     }
   }
 
   void verifyPhi(const PhiInst &phi, const BasicBlock &block, size_t index) {
-    if (!phi.getResult()) {
+    const auto *result = valueOf(phi.getResult());
+    if (!result) {
       error(VerificationErrorCode::InvalidResult, &block, index,
             "phi requires a result");
       return;
     }
     std::unordered_set<const BasicBlock *> incomingBlocks;
-    for (const auto &[label, value] : phi.getIncoming()) {
-      const auto *incomingBlock = cfg_.findBlock(label);
+    for (size_t i = 0; i < phi.getIncoming().size(); ++i) {
+      const auto &[label, id] = phi.getIncoming()[i];
+      const auto *incomingBlock = function_.getBlock(phi.getIncomingBlock(i));
       const auto &predecessors = cfg_.predecessors().at(&block);
       if (!incomingBlock || std::find(predecessors.begin(), predecessors.end(),
                                       incomingBlock) == predecessors.end()) {
@@ -854,10 +886,12 @@ private:
         error(VerificationErrorCode::InvalidPhi, &block, index,
               "phi contains duplicate incoming block " + label);
       }
-      if (value) {
-        verifyValue(value, block, index, incomingBlock);
-        expectSameType(value->getType(), phi.getResult()->getType(), block,
-                       index, "phi incoming value type");
+      if (id != NoValue) {
+        verifyValue(id, block, index, incomingBlock);
+        if (const auto *value = valueOf(id)) {
+          expectSameType(value->getType(), result->getType(), block, index,
+                         "phi incoming value type");
+        }
       }
     }
     std::unordered_set<const BasicBlock *> expectedPredecessors(
@@ -869,15 +903,16 @@ private:
     }
 
     ValueOwnership expectedOwnership = ValueOwnership::Borrowed;
-    if (containsManagedValues(phi.getResult()->getType()) &&
-        !phi.getIncoming().empty() && phi.getIncoming().front().second) {
-      const auto incomingOwnership =
-          phi.getIncoming().front().second->getOwnership();
+    const auto *first = phi.getIncoming().empty()
+                            ? nullptr
+                            : valueOf(phi.getIncoming().front().second);
+    if (containsManagedValues(result->getType()) && first) {
+      const auto incomingOwnership = first->getOwnership();
       const bool allIncomingHaveSameOwnership = std::all_of(
           phi.getIncoming().begin(), phi.getIncoming().end(),
-          [incomingOwnership](const auto &incoming) {
-            return incoming.second &&
-                   incoming.second->getOwnership() == incomingOwnership;
+          [&](const auto &incoming) {
+            const auto *value = valueOf(incoming.second);
+            return value && value->getOwnership() == incomingOwnership;
           });
       if (!allIncomingHaveSameOwnership) {
         error(VerificationErrorCode::InvalidResult, &block, index,
@@ -886,7 +921,7 @@ private:
       }
       expectedOwnership = incomingOwnership;
     }
-    if (phi.getResult()->getOwnership() != expectedOwnership) {
+    if (result->getOwnership() != expectedOwnership) {
       error(VerificationErrorCode::InvalidResult, &block, index,
             "phi result ownership does not match incoming values");
     }
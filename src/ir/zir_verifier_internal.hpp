@@ -5,13 +5,12 @@
 
 namespace zir::verifier_detail {
 
-bool isAssignable(const std::shared_ptr<Type> &actual,
-                  const std::shared_ptr<Type> &expected,
+bool isAssignable(const Type *actual, const Type *expected,
                   TypeInterner &typeInterner);
 bool isTerminator(OpCode opcode);
-bool isStringType(const std::shared_ptr<Type> &type);
-std::shared_ptr<Value> instructionResult(const Instruction &instruction);
-std::string typeName(const std::shared_ptr<Type> &type);
+bool isStringType(const Type *type);
+ValueId instructionResult(const Instruction &instruction);
+std::string typeName(const Type *type);
 
 void verifyDefinedFunction(const Module &module, const Function &function,
                            std::vector<VerificationError> &errors,
@@ -2,8 +2,7 @@
 
 namespace zir::verifier_detail {
 
-bool isAssignable(const std::shared_ptr<Type> &actual,
-                  const std::shared_ptr<Type> &expected,
+bool isAssignable(const Type *actual, const Type *expected,
                   TypeInterner &typeInterner) {
   if (typeInterner.same(actual, expected)) {
     return true;
@@ -21,12 +20,13 @@ bool isAssignable(const std::shared_ptr<Type> &actual,
     return false;
   }
 
-  const auto actualClass = std::static_pointer_cast<ClassType>(actual);
-  const auto expectedClass = std::static_pointer_cast<ClassType>(expected);
+  const auto *actualClass = static_cast<const ClassType *>(actual);
+  const auto *expectedClass = static_cast<const ClassType *>(expected);
   if (actualClass->isWeak() && !expectedClass->isWeak()) {
     return false;
   }
-  for (auto current = actualClass; current; current = current->getBase()) {
+  for (auto *current = actualClass; current;
+       current = current->getBase().get()) {
     if (current->getCodegenName() == expectedClass->getCodegenName()) {
       return true;
     }
@@ -39,11 +39,11 @@ bool isTerminator(OpCode opcode) {
          opcode == OpCode::Ret;
 }
 
-bool isStringType(const std::shared_ptr<Type> &type) {
+bool isStringType(const Type *type) {
   return type && type->getIntrinsicKind() != IntrinsicTypeKind::None;
 }
 
-std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
+ValueId instructionResult(const Instruction &instruction) {
   switch (instruction.getOpCode()) {
   case OpCode::Alloca:
     return static_cast<const AllocaInst &>(instruction).getResult();
@@ -88,11 +88,11 @@ std::shared_ptr<Value> instructionResult(const Instruction &instruction) {
   case OpCode::ClassIs:
     return static_cast<const ClassIsInst &>(instruction).getResult();
   default:
-    return nullptr;
+    return NoValue;
   }
 }
 
-std::string typeName(const std::shared_ptr<Type> &type) {
+std::string typeName(const Type *type) {
   return type ? type->toString() : "<null type>";
 }
 
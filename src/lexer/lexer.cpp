@@ -1,10 +1,12 @@
 #include "lexer.hpp"
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_map>
 
-static const std::unordered_map<std::string, TokenType> KEYWORDS = {
+static const std::unordered_map<std::string_view, TokenType> KEYWORDS = {
     {"if", TokenType::IF},
     {"else", TokenType::ELSE},
     {"while", TokenType::WHILE},
@@ -48,13 +50,14 @@ static const std::unordered_map<std::string, TokenType> KEYWORDS = {
     {"weak", TokenType::WEAK},
 };
 
-std::vector<Token> Lexer::tokenize(const std::string &input) {
+std::vector<Token> Lexer::tokenize(std::string_view input) {
   std::vector<Token> tokens;
   tokens.reserve(input.size() / 4);
   _pos = 0;
   _line = 1;
   _column = 1;
   _input = input;
+  _source = internSource(_diag.sourceName());
 
   while (!isAtEnd()) {
     char _cur = _input[_pos];
@@ -64,62 +67,62 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
 
     if (_cur == '(') {
       tokens.emplace_back(TokenType::LPAREN, "(", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == ')') {
       tokens.emplace_back(TokenType::RPAREN, ")", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '{') {
       tokens.emplace_back(TokenType::LBRACE, "{", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '}') {
       tokens.emplace_back(TokenType::RBRACE, "}", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '[') {
       tokens.emplace_back(TokenType::SQUARE_LBRACE, "[", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == ']') {
       tokens.emplace_back(TokenType::SQUARE_RBRACE, "]", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == ';') {
       tokens.emplace_back(TokenType::SEMICOLON, ";", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == ',') {
       tokens.emplace_back(TokenType::COMMA, ",", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == ':') {
       if (Peek2() == ':') {
         tokens.emplace_back(TokenType::DOUBLECOLON, "::", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::COLON, ":", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -127,110 +130,108 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '.') {
       if (Peek2() == '.' && Peek3() == '.') {
         tokens.emplace_back(TokenType::ELLIPSIS, "...", startLine, startColumn,
-                            startPos, 3);
+                            startPos, 3, _source);
         _pos += 3;
         _column += 3;
         continue;
       } else {
         tokens.emplace_back(TokenType::DOT, ".", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
       }
     } else if (_cur == '@') {
       tokens.emplace_back(TokenType::AT, "@", startLine, startColumn, startPos,
-                          1);
+                          1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '?') {
       tokens.emplace_back(TokenType::QUESTION, "?", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '+') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::PLUS_ASSIGN, "+=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '+') {
         tokens.emplace_back(TokenType::INCREMENT, "++", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       }
       tokens.emplace_back(TokenType::PLUS, "+", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '*') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::STAR_ASSIGN, "*=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       }
       tokens.emplace_back(TokenType::MULTIPLY, "*", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '-') {
       if (Peek2() == '>') {
         tokens.emplace_back(TokenType::ARROW, "->", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::MINUS_ASSIGN, "-=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '-') {
         tokens.emplace_back(TokenType::DECREMENT, "--", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       }
       tokens.emplace_back(TokenType::MINUS, "-", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '/') {
       if (Peek2() == '/') {
-        while (!isAtEnd() && _input[_pos] != '\n') {
-          ++_pos;
-        }
+        _pos = std::min(_input.find('\n', _pos), _input.size());
         continue;
       } else if (Peek2() == '*') {
         _pos += 2;
         _column += 2;
         bool closed = false;
-        while (!isAtEnd()) {
-          if (_input[_pos] == '*' && Peek2() == '/') {
+        while (true) {
+          _pos = _scan->skipUntil(_input.data(), _pos, _input.size(), '*',
+                                  '*', _line, _column);
+          if (isAtEnd()) {
+            break;
+          }
+          if (Peek2() == '/') {
             _pos += 2;
             _column += 2;
             closed = true;
             break;
           }
-          if (_input[_pos] == '\n') {
-            ++_line;
-            _column = 1;
-          } else {
-            ++_column;
-          }
           ++_pos;
+          ++_column;
         }
         if (!closed) {
           _diag.report(
@@ -241,13 +242,13 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::SLASH_ASSIGN, "/=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::DIVIDE, "/", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -255,45 +256,45 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '%') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::PERCENT_ASSIGN, "%=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       }
       tokens.emplace_back(TokenType::MODULO, "%", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '^') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::CARET_ASSIGN, "^=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       }
       tokens.emplace_back(TokenType::POW, "^", startLine, startColumn, startPos,
-                          1);
+                          1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '&') {
       if (Peek2() == '&') {
         tokens.emplace_back(TokenType::AND, "&&", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::AMP_ASSIGN, "&=", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::REFERENCE, "&", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -301,39 +302,39 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '|') {
       if (Peek2() == '|') {
         tokens.emplace_back(TokenType::OR, "||", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::PIPE_ASSIGN, "|=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::BIT_OR, "|", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
       }
     } else if (_cur == '~') {
       tokens.emplace_back(TokenType::CONCAT, "~", startLine, startColumn,
-                          startPos, 1);
+                          startPos, 1, _source);
       ++_pos;
       ++_column;
       continue;
     } else if (_cur == '=') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::EQUAL, "==", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::ASSIGN, "=", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -341,13 +342,13 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '!') {
       if (Peek2() == '=') {
         tokens.emplace_back(TokenType::NOTEQUAL, "!=", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::NOT, "!", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -355,25 +356,25 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '<') {
       if (Peek2() == '<' && Peek3() == '=') {
         tokens.emplace_back(TokenType::LSHIFT_ASSIGN, "<<=", startLine,
-                            startColumn, startPos, 3);
+                            startColumn, startPos, 3, _source);
         _pos += 3;
         _column += 3;
         continue;
       } else if (Peek2() == '<') {
         tokens.emplace_back(TokenType::LSHIFT, "<<", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::LESSEQUAL, "<=", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::LESS, "<", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -381,25 +382,25 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
     } else if (_cur == '>') {
       if (Peek2() == '>' && Peek3() == '=') {
         tokens.emplace_back(TokenType::RSHIFT_ASSIGN, ">>=", startLine,
-                            startColumn, startPos, 3);
+                            startColumn, startPos, 3, _source);
         _pos += 3;
         _column += 3;
         continue;
       } else if (Peek2() == '>') {
         tokens.emplace_back(TokenType::RSHIFT, ">>", startLine, startColumn,
-                            startPos, 2);
+                            startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else if (Peek2() == '=') {
         tokens.emplace_back(TokenType::GREATEREQUAL, ">=", startLine,
-                            startColumn, startPos, 2);
+                            startColumn, startPos, 2, _source);
         _pos += 2;
         _column += 2;
         continue;
       } else {
         tokens.emplace_back(TokenType::GREATER, ">", startLine, startColumn,
-                            startPos, 1);
+                            startPos, 1, _source);
         ++_pos;
         ++_column;
         continue;
@@ -469,128 +470,68 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
         }
 
         size_t len = _pos - startPos;
-        tokens.emplace_back(TokenType::INTEGER, std::move(parsed), startLine,
-                            startColumn, startPos, len);
+        tokens.emplace_back(TokenType::INTEGER, _input.substr(startPos, len),
+                            startLine, startColumn, startPos, len, _source);
         continue;
       }
 
-      // decimal / float: scan forward, strip underscores
-      std::string numStr;
-      numStr.reserve(20);
-      while (!isAtEnd() &&
-             (std::isdigit(_input[_pos]) || _input[_pos] == '_')) {
-        if (_input[_pos] != '_') {
-          numStr += _input[_pos];
-        }
-        ++_pos;
-        ++_column;
-      }
+      // decimal / float: underscores stay in the token text, see
+      // literalValue()
+      _pos = _scan->skipDigits(_input.data(), _pos, _input.size());
       if (!isAtEnd() && _input[_pos] == '.') {
         isFloat = true;
-        numStr += _input[_pos++];
-        ++_column;
-        while (!isAtEnd() &&
-               (std::isdigit(_input[_pos]) || _input[_pos] == '_')) {
-          if (_input[_pos] != '_') {
-            numStr += _input[_pos];
-          }
-          ++_pos;
-          ++_column;
-        }
-      }
-      size_t len = numStr.length();
-      if (isFloat) {
-        tokens.emplace_back(TokenType::FLOAT, std::move(numStr), startLine,
-                            startColumn, startPos, len);
-      } else {
-        tokens.emplace_back(TokenType::INTEGER, std::move(numStr), startLine,
-                            startColumn, startPos, len);
+        _pos = _scan->skipDigits(_input.data(), _pos + 1, _input.size());
       }
+      _column += _pos - startPos;
+      size_t len = _pos - startPos;
+      tokens.emplace_back(isFloat ? TokenType::FLOAT : TokenType::INTEGER,
+                          _input.substr(startPos, len), startLine, startColumn,
+                          startPos, len, _source);
       continue;
     } else if (std::isalpha(_cur) || _cur == '_') {
-      // scan to end of identifier, then construct string once
       size_t identStart = _pos;
-      while (!isAtEnd() &&
-             (std::isalnum(_input[_pos]) || _input[_pos] == '_')) {
-        ++_pos;
-        ++_column;
-      }
-      std::string identStr(_input.data() + identStart, _pos - identStart);
-      size_t len = identStr.size();
+      _pos = _scan->skipIdentifier(_input.data(), _pos, _input.size());
+      _column += _pos - identStart;
+      std::string_view ident = _input.substr(identStart, _pos - identStart);
 
-      auto it = KEYWORDS.find(identStr);
+      auto it = KEYWORDS.find(ident);
       TokenType type = (it != KEYWORDS.end()) ? it->second : TokenType::ID;
 
-      tokens.emplace_back(type, std::move(identStr), startLine, startColumn,
-                          startPos, len);
+      tokens.emplace_back(type, ident, startLine, startColumn, startPos,
+                          ident.size(), _source);
       continue;
     } else if (std::isspace(_cur)) {
-      if (_cur == '\n') {
-        ++_line;
-        _column = 1;
-      } else {
-        ++_column;
-      }
-      ++_pos;
+      _pos = _scan->skipWhitespace(_input.data(), _pos, _input.size(), _line,
+                                   _column);
       continue;
     } else if (_cur == '"') {
-      std::string strVal;
-      strVal.reserve(64);
+      // Escapes are only skipped here; literalValue() decodes them.
       size_t strStart = _pos;
       ++_pos;
       ++_column;
 
-      while (!isAtEnd() && _input[_pos] != '"') {
-        if (_input[_pos] == '\n') {
-          ++_line;
-          _column = 1;
-        } else {
-          ++_column;
+      while (true) {
+        _pos = _scan->skipUntil(_input.data(), _pos, _input.size(), '"', '\\',
+                                _line, _column);
+        if (isAtEnd() || _input[_pos] == '"') {
+          break;
         }
-
-        if (_input[_pos] == '\\') {
-          ++_pos;
-          if (isAtEnd())
-            break;
-
-          switch (_input[_pos]) {
-          case 'n':
-            strVal += '\n';
-            break;
-          case 't':
-            strVal += '\t';
-            break;
-          case 'r':
-            strVal += '\r';
-            break;
-          case '\\':
-            strVal += '\\';
-            break;
-          case '"':
-            strVal += '"';
-            break;
-          case '0':
-            strVal += '\0';
-            break;
-          case 'w':
-            strVal += ' ';
-            break;
-          default:
-            strVal += _input[_pos];
-            break;
-          }
-        } else {
-          strVal += _input[_pos];
+        // A backslash counts one column together with the byte it escapes.
+        ++_column;
+        _pos += 2;
+        if (_pos > _input.size()) {
+          _pos = _input.size();
+          break;
         }
-        ++_pos;
       }
 
       if (!isAtEnd() && _input[_pos] == '"') {
         ++_pos;
         ++_column;
         size_t len = _pos - strStart;
-        tokens.emplace_back(TokenType::STRING, std::move(strVal), startLine,
-                            startColumn, startPos, len);
+        tokens.emplace_back(TokenType::STRING,
+                            _input.substr(strStart + 1, len - 2), startLine,
+                            startColumn, startPos, len, _source);
         continue;
       } else {
         _diag.report(
@@ -607,7 +548,6 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
                      zap::DiagnosticLevel::Error, "Unterminated char literal");
         return tokens;
       }
-      char ch;
       if (_input[_pos] == '\\') {
         ++_pos;
         if (isAtEnd()) {
@@ -616,31 +556,6 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
                        "Unterminated char literal");
           return tokens;
         }
-        switch (_input[_pos]) {
-        case 'n':
-          ch = '\n';
-          break;
-        case 't':
-          ch = '\t';
-          break;
-        case 'r':
-          ch = '\r';
-          break;
-        case '\\':
-          ch = '\\';
-          break;
-        case '\'':
-          ch = '\'';
-          break;
-        case '0':
-          ch = '\0';
-          break;
-        default:
-          ch = _input[_pos];
-          break;
-        }
-      } else {
-        ch = _input[_pos];
       }
       ++_pos;
       ++_column;
@@ -651,8 +566,9 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
       }
       ++_pos;
       ++_column;
-      tokens.emplace_back(TokenType::CHAR, std::string(1, ch), startLine,
-                          startColumn, startPos, 3);
+      tokens.emplace_back(TokenType::CHAR,
+                          _input.substr(charStart + 1, _pos - charStart - 2),
+                          startLine, startColumn, startPos, 3, _source);
       continue;
     } else {
       _diag.report(SourceSpan(startLine, startColumn, _pos, 1),
@@ -662,12 +578,59 @@ std::vector<Token> Lexer::tokenize(const std::string &input) {
       ++_column;
     }
   }
-  for (auto &token : tokens) {
-    token.span.sourceName = _diag.sourceName();
-  }
   return tokens;
 }
 
+namespace {
+
+char unescape(char escaped, bool inString) {
+  switch (escaped) {
+  case 'n':
+    return '\n';
+  case 't':
+    return '\t';
+  case 'r':
+    return '\r';
+  case '0':
+    return '\0';
+  case 'w':
+    return inString ? ' ' : 'w';
+  default:
+    return escaped;
+  }
+}
+
+} // namespace
+
+std::string Lexer::literalValue(const Token &token) {
+  const std::string_view text = token.value;
+  std::string value;
+  switch (token.type) {
+  case TokenType::STRING:
+  case TokenType::CHAR:
+    value.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+      if (text[i] == '\\' && i + 1 < text.size()) {
+        value += unescape(text[++i], token.type == TokenType::STRING);
+      } else {
+        value += text[i];
+      }
+    }
+    return value;
+  case TokenType::INTEGER:
+  case TokenType::FLOAT:
+    value.reserve(text.size());
+    for (char ch : text) {
+      if (ch != '_') {
+        value += ch;
+      }
+    }
+    return value;
+  default:
+    return std::string(text);
+  }
+}
+
 char Lexer::Peek2() {
   if (_pos + 1 < _input.size()) {
     return _input[_pos + 1];
@@ -1,7 +1,9 @@
 #pragma once
 #include "../token/token.hpp"
 #include "../utils/diagnostics.hpp"
+#include "lexer_scan.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Lexer {
@@ -10,13 +12,21 @@ public:
   size_t _pos;
   size_t _line;
   size_t _column;
-  std::string _input;
+  std::string_view _input;
+  SourceId _source = 0;
+  /// @brief Scanning kernels for whitespace, comments, identifiers, numbers
+  /// and strings; the widest the CPU supports unless set otherwise.
+  const lexer_scan::Kernels *_scan = &lexer_scan::kernels();
 
-  Lexer(zap::DiagnosticEngine &diag) noexcept(
-      std::is_nothrow_default_constructible<std::string>::value)
-      : _diag(diag) {}
+  Lexer(zap::DiagnosticEngine &diag) noexcept : _diag(diag) {}
   ~Lexer() noexcept {}
-  std::vector<Token> tokenize(const std::string &input);
+  /// @brief Splits @p input into tokens. Token text points into @p input,
+  /// which has to outlive the tokens.
+  std::vector<Token> tokenize(std::string_view input);
+  /// @brief Returns the value a literal token stands for: escapes decoded
+  /// in string and char literals, '_' separators dropped from numbers. Any
+  /// other token's text is returned as is.
+  static std::string literalValue(const Token &token);
   char Peek2();
   char Peek3();
   bool isAtEnd() const noexcept;
@@ -0,0 +1,117 @@
+#include "lexer_scan.hpp"
+#include "lexer_scan_kernels.hpp"
+
+#include <initializer_list>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define ZAP_LEXER_SSE2 1
+#endif
+
+namespace lexer_scan {
+
+#if defined(ZAP_LEXER_AVX2)
+// Defined in lexer_scan_avx2.cpp, the only file built with -mavx2.
+const Kernels &avx2Kernels();
+#endif
+
+namespace {
+
+size_t scalarSkipIdentifier(const char *data, size_t pos, size_t size) {
+  return scalarAdvance(data, pos, size, nullptr, nullptr,
+                       [](char ch) { return !isIdentifierByte(ch); });
+}
+
+size_t scalarSkipDigits(const char *data, size_t pos, size_t size) {
+  return scalarAdvance(data, pos, size, nullptr, nullptr,
+                       [](char ch) { return !isDigitByte(ch); });
+}
+
+size_t scalarSkipWhitespace(const char *data, size_t pos, size_t size,
+                            size_t &line, size_t &column) {
+  return scalarAdvance(data, pos, size, &line, &column,
+                       [](char ch) { return !isWhitespaceByte(ch); });
+}
+
+size_t scalarSkipUntil(const char *data, size_t pos, size_t size, char a,
+                       char b, size_t &line, size_t &column) {
+  return scalarAdvance(data, pos, size, &line, &column,
+                       [&](char ch) { return ch == a || ch == b; });
+}
+
+const Kernels scalarKernels{Level::Scalar, scalarSkipIdentifier,
+                            scalarSkipDigits, scalarSkipWhitespace,
+                            scalarSkipUntil};
+
+#if defined(ZAP_LEXER_SSE2)
+struct Sse2 {
+  using Reg = __m128i;
+  static constexpr size_t width = 16;
+  static constexpr uint32_t allBits = 0xffff;
+
+  static Reg load(const char *data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  }
+  static Reg splat(char ch) { return _mm_set1_epi8(ch); }
+  static Reg eq(Reg a, Reg b) { return _mm_cmpeq_epi8(a, b); }
+  static Reg gt(Reg a, Reg b) { return _mm_cmpgt_epi8(a, b); }
+  static Reg bitOr(Reg a, Reg b) { return _mm_or_si128(a, b); }
+  static Reg bitAnd(Reg a, Reg b) { return _mm_and_si128(a, b); }
+  static uint32_t mask(Reg a) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(a));
+  }
+};
+
+const Kernels sse2Kernels{Level::Sse2, vectorSkipIdentifier<Sse2>,
+                          vectorSkipDigits<Sse2>, vectorSkipWhitespace<Sse2>,
+                          vectorSkipUntil<Sse2>};
+#endif
+
+} // namespace
+
+const Kernels *kernelsFor(Level level) {
+  switch (level) {
+  case Level::Scalar:
+    return &scalarKernels;
+  case Level::Sse2:
+#if defined(ZAP_LEXER_SSE2)
+    return &sse2Kernels;
+#else
+    return nullptr;
+#endif
+  case Level::Avx2:
+#if defined(ZAP_LEXER_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+      return &avx2Kernels();
+    }
+#endif
+    return nullptr;
+  }
+  return nullptr;
+}
+
+const Kernels &kernels() {
+  static const Kernels *best = [] {
+    for (Level level : {Level::Avx2, Level::Sse2}) {
+      if (const Kernels *found = kernelsFor(level)) {
+        return found;
+      }
+    }
+    return &scalarKernels;
+  }();
+  return *best;
+}
+
+const char *levelName(Level level) {
+  switch (level) {
+  case Level::Scalar:
+    return "scalar";
+  case Level::Sse2:
+    return "sse2";
+  case Level::Avx2:
+    return "avx2";
+  }
+  return "unknown";
+}
+
+} // namespace lexer_scan
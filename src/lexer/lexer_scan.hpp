@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+
+/// @brief Byte scanning used by the lexer, in scalar, SSE2 and AVX2
+/// versions. Every function starts at @p pos, stops at @p size at the
+/// latest and returns where it stopped; the vector versions look at 16 or
+/// 32 bytes per step and give the same results as the scalar ones.
+namespace lexer_scan {
+
+enum class Level { Scalar, Sse2, Avx2 };
+
+struct Kernels {
+  Level level;
+  /// @brief Skips [A-Za-z0-9_].
+  size_t (*skipIdentifier)(const char *data, size_t pos, size_t size);
+  /// @brief Skips [0-9_].
+  size_t (*skipDigits)(const char *data, size_t pos, size_t size);
+  /// @brief Skips ' ' and '\t' to '\r'. @p line and @p column move past the
+  /// skipped bytes, counting lines from the newlines among them.
+  size_t (*skipWhitespace)(const char *data, size_t pos, size_t size,
+                           size_t &line, size_t &column);
+  /// @brief Skips to the first @p a or @p b, moving @p line and @p column
+  /// like skipWhitespace().
+  size_t (*skipUntil)(const char *data, size_t pos, size_t size, char a,
+                      char b, size_t &line, size_t &column);
+};
+
+/// @brief The kernels for @p level, or null when this build or CPU lacks
+/// them.
+const Kernels *kernelsFor(Level level);
+
+/// @brief The widest kernels this build and CPU support.
+const Kernels &kernels();
+
+const char *levelName(Level level);
+
+} // namespace lexer_scan
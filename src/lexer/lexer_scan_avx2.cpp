@@ -0,0 +1,39 @@
+// Built with -mavx2 and only called after kernelsFor() has checked the CPU.
+#include "lexer_scan.hpp"
+#include "lexer_scan_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace lexer_scan {
+
+namespace {
+
+struct Avx2 {
+  using Reg = __m256i;
+  static constexpr size_t width = 32;
+  static constexpr uint32_t allBits = 0xffffffff;
+
+  static Reg load(const char *data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  }
+  static Reg splat(char ch) { return _mm256_set1_epi8(ch); }
+  static Reg eq(Reg a, Reg b) { return _mm256_cmpeq_epi8(a, b); }
+  static Reg gt(Reg a, Reg b) { return _mm256_cmpgt_epi8(a, b); }
+  static Reg bitOr(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+  static Reg bitAnd(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+  static uint32_t mask(Reg a) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(a));
+  }
+};
+
+} // namespace
+
+const Kernels &avx2Kernels() {
+  static const Kernels kernels{Level::Avx2, vectorSkipIdentifier<Avx2>,
+                               vectorSkipDigits<Avx2>,
+                               vectorSkipWhitespace<Avx2>,
+                               vectorSkipUntil<Avx2>};
+  return kernels;
+}
+
+} // namespace lexer_scan
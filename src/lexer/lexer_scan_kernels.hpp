@@ -0,0 +1,141 @@
+#pragma once
+// Scanning loops shared by the SSE2 and AVX2 kernels. Each includer
+// instantiates them for its own vector type; everything here has internal
+// linkage so code built with -mavx2 never stands in for the SSE2 copy.
+#include <cstddef>
+#include <cstdint>
+
+namespace lexer_scan {
+namespace {
+
+inline bool isIdentifierByte(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+         (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+inline bool isDigitByte(char ch) { return (ch >= '0' && ch <= '9') || ch == '_'; }
+
+inline bool isWhitespaceByte(char ch) {
+  return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+/// @brief Advances over bytes until @p stopByte holds. With @p line set,
+/// also counts the newlines passed and leaves @p column just past them.
+template <typename StopByte>
+size_t scalarAdvance(const char *data, size_t pos, size_t size, size_t *line,
+                     size_t *column, StopByte stopByte) {
+  for (; pos < size && !stopByte(data[pos]); ++pos) {
+    if (line) {
+      if (data[pos] == '\n') {
+        ++*line;
+        *column = 1;
+      } else {
+        ++*column;
+      }
+    }
+  }
+  return pos;
+}
+
+#if defined(__GNUC__)
+/// @brief Vector form of scalarAdvance(). @p stopMask gives a mask of the
+/// bytes in a block that stop the scan; the tail shorter than one block is
+/// scanned with @p stopByte.
+template <typename V, typename StopMask, typename StopByte>
+size_t vectorAdvance(const char *data, size_t pos, size_t size, size_t *line,
+                     size_t *column, StopMask stopMask, StopByte stopByte) {
+  const size_t start = pos;
+  size_t lines = 0;
+  size_t lastNewline = 0;
+  while (pos + V::width <= size) {
+    const auto block = V::load(data + pos);
+    const uint32_t stops = stopMask(block);
+    const size_t length = stops ? __builtin_ctz(stops) : V::width;
+    if (line) {
+      uint32_t newlines = V::mask(V::eq(block, V::splat('\n')));
+      if (length < V::width) {
+        newlines &= (uint32_t{1} << length) - 1;
+      }
+      if (newlines) {
+        lines += __builtin_popcount(newlines);
+        lastNewline = pos + 31 - __builtin_clz(newlines) + 1;
+      }
+    }
+    pos += length;
+    if (stops) {
+      break;
+    }
+  }
+  if (line) {
+    *line += lines;
+    *column = lines ? 1 + (pos - lastNewline) : *column + (pos - start);
+  }
+  if (pos + V::width > size) {
+    pos = scalarAdvance(data, pos, size, line, column, stopByte);
+  }
+  return pos;
+}
+
+/// @brief Bytes of @p block in ['lo', 'hi']. Only ASCII ranges are asked
+/// for, so the signed compares leave bytes >= 0x80 outside.
+template <typename V>
+typename V::Reg inRange(typename V::Reg block, char lo, char hi) {
+  return V::bitAnd(V::gt(block, V::splat(static_cast<char>(lo - 1))),
+                   V::gt(V::splat(static_cast<char>(hi + 1)), block));
+}
+
+template <typename V>
+size_t vectorSkipIdentifier(const char *data, size_t pos, size_t size) {
+  return vectorAdvance<V>(
+      data, pos, size, nullptr, nullptr,
+      [](typename V::Reg block) {
+        const auto lower = V::bitOr(block, V::splat(0x20));
+        const auto word = V::bitOr(
+            V::bitOr(inRange<V>(lower, 'a', 'z'), inRange<V>(block, '0', '9')),
+            V::eq(block, V::splat('_')));
+        return ~V::mask(word) & V::allBits;
+      },
+      [](char ch) { return !isIdentifierByte(ch); });
+}
+
+template <typename V>
+size_t vectorSkipDigits(const char *data, size_t pos, size_t size) {
+  return vectorAdvance<V>(
+      data, pos, size, nullptr, nullptr,
+      [](typename V::Reg block) {
+        const auto digit = V::bitOr(inRange<V>(block, '0', '9'),
+                                    V::eq(block, V::splat('_')));
+        return ~V::mask(digit) & V::allBits;
+      },
+      [](char ch) { return !isDigitByte(ch); });
+}
+
+template <typename V>
+size_t vectorSkipWhitespace(const char *data, size_t pos, size_t size,
+                            size_t &line, size_t &column) {
+  return vectorAdvance<V>(
+      data, pos, size, &line, &column,
+      [](typename V::Reg block) {
+        const auto space = V::bitOr(inRange<V>(block, '\t', '\r'),
+                                    V::eq(block, V::splat(' ')));
+        return ~V::mask(space) & V::allBits;
+      },
+      [](char ch) { return !isWhitespaceByte(ch); });
+}
+
+template <typename V>
+size_t vectorSkipUntil(const char *data, size_t pos, size_t size, char a,
+                       char b, size_t &line, size_t &column) {
+  const auto splatA = V::splat(a);
+  const auto splatB = V::splat(b);
+  return vectorAdvance<V>(
+      data, pos, size, &line, &column,
+      [&](typename V::Reg block) {
+        return V::mask(V::bitOr(V::eq(block, splatA), V::eq(block, splatB)));
+      },
+      [&](char ch) { return ch == a || ch == b; });
+}
+#endif
+
+} // namespace
+} // namespace lexer_scan
@@ -250,6 +250,7 @@ Workspace::buildSnapshot(const SourceSnapshot &document,
   }
   appendDiagnostics(snapshot->project.analysis, project.diagnostics,
                     sourceManager_.uriForPath(document.path));
+  snapshot->project.boundArena = std::move(project.boundArena);
   snapshot->project.boundRoot = std::move(project.boundRoot);
   snapshot->project.semanticInfo = std::move(project.semanticInfo);
   snapshot->project.moduleMap = std::move(project.modules);
@@ -4,6 +4,7 @@
 #include "sema/module_info.hpp"
 #include "sema/semantic_info.hpp"
 #include "lsp/source_manager.hpp"
+#include "utils/arena.hpp"
 #include "utils/diagnostics.hpp"
 #include <cstdint>
 #include <filesystem>
@@ -23,6 +24,7 @@ struct AnalysisResult {
 
 struct ProjectState {
   std::map<std::string, std::unique_ptr<sema::ModuleInfo>> moduleMap;
+  ArenaRef boundArena;
   std::unique_ptr<sema::BoundRootNode> boundRoot;
   std::unordered_map<std::string, std::string> uriByModuleId;
   std::unordered_set<std::string> dependencyModuleIds;
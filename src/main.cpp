@@ -40,6 +40,10 @@ int main(int argc, char **argv) {
       err = 1;
     }
 
+    if (zapcDriver.report()) {
+      err = 1;
+    }
+
     if (zapcDriver.cleanup()) {
       return 1;
     }
@@ -1,5 +1,6 @@
 #include "parser.hpp"
 #include "../ast/fun_call.hpp"
+#include "../lexer/lexer.hpp"
 #include <cstdlib>
 #include <iostream>
 #include <limits>
@@ -58,8 +59,8 @@ std::string qualifiedNameFromExpression(const ExpressionNode *expr) {
 }
 } // namespace
 
-Parser::Parser(const std::vector<Token> &tokens, DiagnosticEngine &diag)
-    : _diag(diag), _tokens(tokens), _pos(0) {}
+Parser::Parser(std::vector<Token> tokens, DiagnosticEngine &diag)
+    : _diag(diag), _tokens(std::move(tokens)), _pos(0) {}
 
 Parser::~Parser() {}
 
@@ -93,7 +94,7 @@ std::vector<AttributeNode> Parser::parseAttributes() {
 AttributeNode Parser::parseSingleAttribute() {
   Token nameToken = eat(TokenType::ID);
   AttributeNode attr;
-  attr.name = nameToken.value;
+  attr.name = std::string(nameToken.value);
   attr.span = nameToken.span;
 
   if (peek().type == TokenType::LPAREN) {
@@ -107,7 +108,7 @@ AttributeNode Parser::parseSingleAttribute() {
           Token argName = eat(TokenType::ID);
           eat(TokenType::COLON);
           arg.kind = AttributeArgumentKind::Named;
-          arg.name = argName.value;
+          arg.name = std::string(argName.value);
           arg.value = parseExpression();
         } else {
           arg.kind = AttributeArgumentKind::Positional;
@@ -170,8 +171,9 @@ std::unique_ptr<RootNode> Parser::parse() {
           auto typeNode = parseType();
           Token semiToken = eat(TokenType::SEMICOLON);
           auto varDecl =
-              _builder.makeBindingDecl(nameToken.value, std::move(typeNode),
-                                       nullptr, BindingKind::Mutable);
+              _builder.makeBindingDecl(std::string(nameToken.value),
+                                       std::move(typeNode), nullptr,
+                                       BindingKind::Mutable);
           varDecl->isGlobal_ = true;
           varDecl->isExternal_ = true;
           _builder.setSpan(varDecl.get(),
@@ -230,7 +232,7 @@ std::unique_ptr<RootNode> Parser::parse() {
         }
       } else {
         _diag.report(peek().span, DiagnosticLevel::Error,
-                     "Unexpected token " + peek().value);
+                     "Unexpected token " + std::string(peek().value));
         _pos++;
         synchronize(SyncContext::TopLevel);
       }
@@ -249,7 +251,7 @@ std::unique_ptr<ImportNode> Parser::parseImportDecl() {
 
   if (peek().type == TokenType::AS) {
     eat(TokenType::AS);
-    moduleAlias = eat(TokenType::ID).value;
+    moduleAlias = std::string(eat(TokenType::ID).value);
   }
 
   if (peek().type == TokenType::LBRACE) {
@@ -257,12 +259,12 @@ std::unique_ptr<ImportNode> Parser::parseImportDecl() {
     if (peek().type != TokenType::RBRACE) {
       do {
         Token sourceToken = eat(TokenType::ID);
-        std::string localName = sourceToken.value;
+        std::string localName(sourceToken.value);
         if (peek().type == TokenType::AS) {
           eat(TokenType::AS);
-          localName = eat(TokenType::ID).value;
+          localName = std::string(eat(TokenType::ID).value);
         }
-        bindings.push_back({sourceToken.value, localName});
+        bindings.push_back({std::string(sourceToken.value), localName});
       } while (peek().type == TokenType::COMMA &&
                eat(TokenType::COMMA).type == TokenType::COMMA);
     }
@@ -270,8 +272,9 @@ std::unique_ptr<ImportNode> Parser::parseImportDecl() {
   }
 
   Token semiToken = eat(TokenType::SEMICOLON);
-  auto importDecl = _builder.makeImport(pathToken.value, std::move(moduleAlias),
-                                        std::move(bindings));
+  auto importDecl =
+      _builder.makeImport(Lexer::literalValue(pathToken),
+                          std::move(moduleAlias), std::move(bindings));
   _builder.setSpan(importDecl.get(),
                    SourceSpan::merge(importKeyword.span, semiToken.span));
   return importDecl;
@@ -291,7 +294,7 @@ std::unique_ptr<FunDecl> Parser::parseFunDecl(bool isUnsafe) {
   Token funKeyword = eat(TokenType::FUN);
 
   Token funNameToken = eat(TokenType::ID);
-  auto funDecl = _builder.makeFunDecl(funNameToken.value);
+  auto funDecl = _builder.makeFunDecl(std::string(funNameToken.value));
   funDecl->isUnsafe_ = isUnsafe;
   funDecl->isStatic_ = isStatic;
   if (peek().type == TokenType::LESS && isTypeStartToken(peek(1).type)) {
@@ -341,7 +344,7 @@ std::unique_ptr<ExtDecl> Parser::parseExtDecl() {
 
   Token funNameToken = eat(TokenType::ID);
   auto extDecl = std::make_unique<ExtDecl>();
-  extDecl->name_ = funNameToken.value;
+  extDecl->name_ = std::string(funNameToken.value);
 
   eat(TokenType::LPAREN);
 
@@ -368,7 +371,7 @@ std::unique_ptr<ExtDecl> Parser::parseExtDecl() {
     _builder.setSpan(extDecl->returnType_.get(),
                      SourceSpan(nextToken.span.line, nextToken.span.column,
                                 nextToken.span.offset, 0,
-                                nextToken.span.sourceName));
+                                nextToken.span.source));
   }
 
   Token semiToken = eat(TokenType::SEMICOLON);
@@ -387,9 +390,9 @@ std::optional<std::string> Parser::parseResultBorrowSource() {
   eat(TokenType::LPAREN);
   std::string source;
   if (peek().type == TokenType::ID) {
-    source = eat(TokenType::ID).value;
+    source = std::string(eat(TokenType::ID).value);
   } else {
-    source = eat(TokenType::INTEGER).value;
+    source = Lexer::literalValue(eat(TokenType::INTEGER));
   }
   eat(TokenType::RPAREN);
   return source;
@@ -555,9 +558,9 @@ std::unique_ptr<ParameterNode> Parser::parseParameter(bool allowDefault) {
     defaultValue = parseExpression();
   }
   auto endSpan = defaultValue ? defaultValue->span : typeNodePtr->span;
-  auto paramNode = _builder.makeParam(paramNameToken.value, std::move(typeNode),
-                                      isRef, isSink, isVariadic, isNoEscape,
-                                      std::move(defaultValue));
+  auto paramNode = _builder.makeParam(
+      std::string(paramNameToken.value), std::move(typeNode), isRef, isSink,
+      isVariadic, isNoEscape, std::move(defaultValue));
   _builder.setSpan(paramNode.get(),
                    SourceSpan::merge(paramNameToken.span, endSpan));
   return paramNode;
@@ -617,7 +620,8 @@ std::vector<GenericConstraint> Parser::parseWhereClauses() {
     Token paramToken = eat(TokenType::ID);
     eat(TokenType::COLON);
     auto boundType = parseType();
-    constraints.push_back({paramToken.value, std::move(boundType)});
+    constraints.push_back(
+        {std::string(paramToken.value), std::move(boundType)});
   }
   return constraints;
 }
@@ -1013,7 +1017,7 @@ std::unique_ptr<IfTypeNode> Parser::parseIfType() {
   }
 
   auto ifTypeNode =
-      _builder.makeIfType(paramToken.value, std::move(matchType),
+      _builder.makeIfType(std::string(paramToken.value), std::move(matchType),
                           std::move(thenBody), std::move(elseBody));
   _builder.setSpan(ifTypeNode.get(),
                    SourceSpan::merge(iftypeKeyword.span, endSpan));
@@ -1125,7 +1129,7 @@ std::unique_ptr<ForInNode> Parser::parseForIn() {
   Token itemToken = eat(TokenType::ID);
   if (peek().type == TokenType::COMMA) {
     eat(TokenType::COMMA);
-    indexName = itemToken.value;
+    indexName = std::string(itemToken.value);
     itemToken = eat(TokenType::ID);
   }
 
@@ -1149,7 +1153,7 @@ std::unique_ptr<ForInNode> Parser::parseForIn() {
   auto body = parseBody();
   Token rbraceToken = eat(TokenType::RBRACE);
 
-  auto forInNode = _builder.makeForIn(indexName, itemToken.value,
+  auto forInNode = _builder.makeForIn(indexName, std::string(itemToken.value),
                                       std::move(iterable), std::move(body));
   _builder.setSpan(forInNode.get(),
                    SourceSpan::merge(forKeyword.span, rbraceToken.span));
@@ -1220,7 +1224,7 @@ std::unique_ptr<ExpressionNode> Parser::parseFailableExpression() {
       Token rbraceToken = eat(TokenType::RBRACE);
 
       auto handled = _builder.makeFailableHandleExpr(
-          std::move(expr), errToken.value, std::move(handler));
+          std::move(expr), std::string(errToken.value), std::move(handler));
       _builder.setSpan(handled.get(),
                        SourceSpan::merge(startSpan, rbraceToken.span));
       expr = std::move(handled);
@@ -1233,7 +1237,7 @@ std::unique_ptr<ExpressionNode> Parser::parseFailableExpression() {
     std::unique_ptr<ExpressionNode> fallback;
     if (peek().type == TokenType::ID && peek(1).type == TokenType::LBRACE) {
       Token typeToken = eat(TokenType::ID);
-      auto typeNode = _builder.makeType(typeToken.value);
+      auto typeNode = _builder.makeType(std::string(typeToken.value));
       _builder.setSpan(typeNode.get(), typeToken.span);
       fallback = parseStructLiteral(std::move(typeNode));
     } else {
@@ -1270,7 +1274,7 @@ std::vector<AsmOperandNode> Parser::parseAsmOperandList() {
   std::vector<AsmOperandNode> operands;
   while (true) {
     AsmOperandNode operand;
-    operand.constraint = eat(TokenType::STRING).value;
+    operand.constraint = Lexer::literalValue(eat(TokenType::STRING));
     eat(TokenType::LPAREN);
     operand.expr = parseExpression();
     eat(TokenType::RPAREN);
@@ -1287,7 +1291,7 @@ std::unique_ptr<AsmStmtNode> Parser::parseAsm() {
   eat(TokenType::LPAREN);
   Token templateToken = eat(TokenType::STRING);
 
-  auto node = _builder.makeAsm(templateToken.value);
+  auto node = _builder.makeAsm(Lexer::literalValue(templateToken));
 
   // The lexer merges adjacent ':' into '::', so consume colon separators one
   // at a time, buffering the second half of a '::' token.
@@ -1324,10 +1328,12 @@ std::unique_ptr<AsmStmtNode> Parser::parseAsm() {
 
       if (consumeColon()) {
         if (!sectionEmpty()) {
-          node->clobbers.push_back(eat(TokenType::STRING).value);
+          node->clobbers.push_back(
+              Lexer::literalValue(eat(TokenType::STRING)));
           while (peek().type == TokenType::COMMA) {
             eat(TokenType::COMMA);
-            node->clobbers.push_back(eat(TokenType::STRING).value);
+            node->clobbers.push_back(
+                Lexer::literalValue(eat(TokenType::STRING)));
           }
         }
       }
@@ -1402,8 +1408,8 @@ Parser::parseBinaryExpression(int minPrecedence) {
 
     SourceSpan leftSpan = left->span;
     SourceSpan rightSpan = right->span;
-    left =
-        _builder.makeBinExpr(std::move(left), opToken.value, std::move(right));
+    left = _builder.makeBinExpr(std::move(left), std::string(opToken.value),
+                                std::move(right));
     _builder.setSpan(static_cast<BinExpr *>(left.get()),
                      SourceSpan::merge(leftSpan, rightSpan));
   }
@@ -1417,7 +1423,8 @@ std::unique_ptr<ExpressionNode> Parser::parseUnaryExpression() {
     Token opToken = eat(peek().type);
     auto expr = parseUnaryExpression();
     SourceSpan endSpan = expr->span;
-    auto node = _builder.makeUnaryExpr(opToken.value, std::move(expr));
+    auto node =
+        _builder.makeUnaryExpr(std::string(opToken.value), std::move(expr));
     _builder.setSpan(node.get(), SourceSpan::merge(opToken.span, endSpan));
     return node;
   }
@@ -1436,8 +1443,8 @@ std::unique_ptr<ExpressionNode> Parser::parsePostfixExpression() {
       eat(TokenType::DOT);
       Token memberToken = eat(TokenType::ID);
       SourceSpan leftSpan = left->span;
-      left = std::move(
-          _builder.makeMemberAccess(std::move(left), memberToken.value));
+      left = std::move(_builder.makeMemberAccess(
+          std::move(left), std::string(memberToken.value)));
       _builder.setSpan(left.get(),
                        SourceSpan::merge(leftSpan, memberToken.span));
     } else if (opToken.type == TokenType::SQUARE_LBRACE) {
@@ -1584,45 +1591,47 @@ std::unique_ptr<ExpressionNode> Parser::parsePrimaryExpression() {
     return newExpr;
   } else if (current.type == TokenType::INTEGER) {
     eat(TokenType::INTEGER);
+    const std::string literal = Lexer::literalValue(current);
 
     try {
       int base = 10;
-      std::string parseValue = current.value;
-      if (current.value.size() > 2 && current.value[0] == '0') {
-        if (current.value[1] == 'x' || current.value[1] == 'X') {
+      std::string parseValue = literal;
+      if (literal.size() > 2 && literal[0] == '0') {
+        if (literal[1] == 'x' || literal[1] == 'X') {
           base = 16;
-        } else if (current.value[1] == 'b' || current.value[1] == 'B') {
+        } else if (literal[1] == 'b' || literal[1] == 'B') {
           base = 2;
-          parseValue = current.value.substr(2);
-        } else if (current.value[1] == 'o' || current.value[1] == 'O') {
+          parseValue = literal.substr(2);
+        } else if (literal[1] == 'o' || literal[1] == 'O') {
           base = 8;
-          parseValue = current.value.substr(2);
+          parseValue = literal.substr(2);
         }
       }
 
       (void)std::stoull(parseValue, nullptr, base);
     } catch (const std::exception &) {
       _diag.report(current.span, DiagnosticLevel::Error,
-                   "Invalid integer literal: " + current.value);
+                   "Invalid integer literal: " + literal);
       throw ParseError();
     }
 
-    auto constInt = _builder.makeConstInt(current.value);
+    auto constInt = _builder.makeConstInt(literal);
     _builder.setSpan(constInt.get(), current.span);
     return constInt;
   } else if (current.type == TokenType::FLOAT) {
     eat(TokenType::FLOAT);
-    auto constFloat = _builder.makeConstFloat(std::stod(current.value));
+    auto constFloat =
+        _builder.makeConstFloat(std::stod(Lexer::literalValue(current)));
     _builder.setSpan(constFloat.get(), current.span);
     return constFloat;
   } else if (current.type == TokenType::STRING) {
     eat(TokenType::STRING);
-    auto constStr = _builder.makeConstString(current.value);
+    auto constStr = _builder.makeConstString(Lexer::literalValue(current));
     _builder.setSpan(constStr.get(), current.span);
     return constStr;
   } else if (current.type == TokenType::CHAR) {
     eat(TokenType::CHAR);
-    auto constChar = _builder.makeConstChar(current.value);
+    auto constChar = _builder.makeConstChar(Lexer::literalValue(current));
     _builder.setSpan(constChar.get(), current.span);
     return constChar;
   } else if (current.type == TokenType::BOOL) {
@@ -1639,7 +1648,7 @@ std::unique_ptr<ExpressionNode> Parser::parsePrimaryExpression() {
     Token idToken = eat(TokenType::ID);
     if (_allowStructLiteral && peek().type == TokenType::LESS &&
         isGenericStructLiteralStart()) {
-      auto typeNode = _builder.makeType(idToken.value);
+      auto typeNode = _builder.makeType(std::string(idToken.value));
       _builder.setSpan(typeNode.get(), idToken.span);
       typeNode->genericArgs = parseGenericTypeArguments();
       if (!typeNode->genericArgs.empty()) {
@@ -1649,11 +1658,11 @@ std::unique_ptr<ExpressionNode> Parser::parsePrimaryExpression() {
       }
       return parseStructLiteral(std::move(typeNode));
     } else if (_allowStructLiteral && peek().type == TokenType::LBRACE) {
-      auto typeNode = _builder.makeType(idToken.value);
+      auto typeNode = _builder.makeType(std::string(idToken.value));
       _builder.setSpan(typeNode.get(), idToken.span);
       return parseStructLiteral(std::move(typeNode));
     } else {
-      auto constId = _builder.makeConstId(idToken.value);
+      auto constId = _builder.makeConstId(std::string(idToken.value));
       _builder.setSpan(constId.get(), idToken.span);
       return constId;
     }
@@ -1676,7 +1685,8 @@ std::unique_ptr<ExpressionNode> Parser::parsePrimaryExpression() {
     return parseArrayLiteral();
   }
   _diag.report(current.span, DiagnosticLevel::Error,
-               "Expected primary expression, got " + current.value);
+               "Expected primary expression, got " +
+                   std::string(current.value));
   throw ParseError();
 }
 int Parser::getPrecedence(TokenType type) {
@@ -1736,7 +1746,7 @@ Token Parser::eat(TokenType expectedType) {
   } else {
     _diag.report(current.span, DiagnosticLevel::Error,
                  "Expected " + tokenTypeToString(expectedType) + ", but got '" +
-                     current.value + "'");
+                     std::string(current.value) + "'");
     throw ParseError();
   }
 }
@@ -1744,7 +1754,7 @@ Token Parser::eat(TokenType expectedType) {
 SourceSpan Parser::pointAfter(const SourceSpan &span) const {
   size_t length = std::max<size_t>(span.length, 1);
   return SourceSpan(span.line, span.column + length, span.offset + span.length,
-                    1, span.sourceName);
+                    1, span.source);
 }
 
 void Parser::synchronize(SyncContext context) {
@@ -1821,10 +1831,10 @@ void Parser::synchronize(SyncContext context) {
 
 std::vector<std::string> Parser::parseQualifiedIdentifier() {
   std::vector<std::string> parts;
-  parts.push_back(eat(TokenType::ID).value);
+  parts.push_back(std::string(eat(TokenType::ID).value));
   while (peek().type == TokenType::DOT) {
     eat(TokenType::DOT);
-    parts.push_back(eat(TokenType::ID).value);
+    parts.push_back(std::string(eat(TokenType::ID).value));
   }
   return parts;
 }
@@ -1845,7 +1855,8 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
       eat(TokenType::LPAREN);
       auto payloadType = parseType();
       eat(TokenType::RPAREN);
-      entries.emplace_back(entryToken.value, std::move(payloadType));
+      entries.emplace_back(std::string(entryToken.value),
+                           std::move(payloadType));
     } else if (peek().type == TokenType::ASSIGN) {
       Token assignToken = eat(TokenType::ASSIGN);
 
@@ -1856,18 +1867,19 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
       }
 
       Token valueToken = eat(TokenType::INTEGER);
+      const std::string literal = Lexer::literalValue(valueToken);
 
       int base = 10;
-      std::string parseValue = valueToken.value;
-      if (valueToken.value.size() > 2 && valueToken.value[0] == '0') {
-        if (valueToken.value[1] == 'x' || valueToken.value[1] == 'X') {
+      std::string parseValue = literal;
+      if (literal.size() > 2 && literal[0] == '0') {
+        if (literal[1] == 'x' || literal[1] == 'X') {
           base = 16;
-        } else if (valueToken.value[1] == 'b' || valueToken.value[1] == 'B') {
+        } else if (literal[1] == 'b' || literal[1] == 'B') {
           base = 2;
-          parseValue = valueToken.value.substr(2);
-        } else if (valueToken.value[1] == 'o' || valueToken.value[1] == 'O') {
+          parseValue = literal.substr(2);
+        } else if (literal[1] == 'o' || literal[1] == 'O') {
           base = 8;
-          parseValue = valueToken.value.substr(2);
+          parseValue = literal.substr(2);
         }
       }
 
@@ -1882,7 +1894,7 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
             _diag.report(
                 valueToken.span, DiagnosticLevel::Error,
                 "Enum value out of range for signed 64-bit integer: -" +
-                    valueToken.value);
+                    literal);
             throw ParseError();
           }
 
@@ -1896,13 +1908,13 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
               static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
             _diag.report(valueToken.span, DiagnosticLevel::Error,
                          "Enum value out of range for signed 64-bit integer: " +
-                             valueToken.value);
+                             literal);
             throw ParseError();
           }
           signedValue = static_cast<int64_t>(unsignedValue);
         }
 
-        entries.emplace_back(entryToken.value, signedValue);
+        entries.emplace_back(std::string(entryToken.value), signedValue);
       } catch (const ParseError &) {
         throw;
       } catch (const std::exception &) {
@@ -1912,7 +1924,7 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
         throw ParseError();
       }
     } else {
-      entries.emplace_back(entryToken.value);
+      entries.emplace_back(std::string(entryToken.value));
     }
 
     if (peek().type != TokenType::COMMA) {
@@ -1924,8 +1936,8 @@ std::unique_ptr<EnumDecl> Parser::parseEnumDecl() {
 
   Token rbraceToken = eat(TokenType::RBRACE);
 
-  auto enumDecl =
-      _builder.makeEnumDecl(enumNameToken.value, std::move(entries));
+  auto enumDecl = _builder.makeEnumDecl(std::string(enumNameToken.value),
+                                        std::move(entries));
   _builder.setSpan(enumDecl.get(),
                    SourceSpan::merge(enumKeyword.span, rbraceToken.span));
   return enumDecl;
@@ -1938,7 +1950,8 @@ std::unique_ptr<TypeAliasDecl> Parser::parseTypeAliasDecl() {
   auto type = parseType();
   Token semiToken = eat(TokenType::SEMICOLON);
 
-  auto aliasDecl = _builder.makeTypeAliasDecl(nameToken.value, std::move(type));
+  auto aliasDecl =
+      _builder.makeTypeAliasDecl(std::string(nameToken.value), std::move(type));
   _builder.setSpan(aliasDecl.get(),
                    SourceSpan::merge(aliasToken.span, semiToken.span));
   return aliasDecl;
@@ -1967,7 +1980,8 @@ std::unique_ptr<RecordDecl> Parser::parseRecordDecl() {
   Token rbraceToken = eat(TokenType::RBRACE);
 
   auto recordDecl = _builder.makeRecordDecl(
-      recordNameToken.value, std::move(genericParams), std::move(fields));
+      std::string(recordNameToken.value), std::move(genericParams),
+      std::move(fields));
   recordDecl->genericConstraints_ = std::move(genericConstraints);
   _builder.setSpan(recordDecl.get(),
                    SourceSpan::merge(recordKeyword.span, rbraceToken.span));
@@ -1978,7 +1992,7 @@ std::unique_ptr<ClassDecl> Parser::parseClassDecl() {
   Token classKeyword = eat(TokenType::CLASS);
   Token classNameToken = eat(TokenType::ID);
 
-  auto classDecl = _builder.makeClassDecl(classNameToken.value);
+  auto classDecl = _builder.makeClassDecl(std::string(classNameToken.value));
   if (peek().type == TokenType::LESS && isTypeStartToken(peek(1).type)) {
     classDecl->genericParams_ = parseGenericParameterList();
   }
@@ -2057,8 +2071,8 @@ std::unique_ptr<StructDeclarationNode> Parser::parseStructDecl(bool isUnsafe) {
 
   eat(TokenType::RBRACE);
   auto decl = std::make_unique<StructDeclarationNode>(
-      structNameToken.value, std::move(genericParams), std::move(fields),
-      isUnsafe);
+      std::string(structNameToken.value), std::move(genericParams),
+      std::move(fields), isUnsafe);
   decl->genericConstraints_ = std::move(genericConstraints);
   return decl;
 }
@@ -2091,7 +2105,7 @@ Parser::parseStructLiteral(std::unique_ptr<TypeNode> type) {
       Token fieldName = eat(TokenType::ID);
       eat(TokenType::COLON);
       auto value = parseExpression();
-      fields.emplace_back(fieldName.value, std::move(value));
+      fields.emplace_back(std::string(fieldName.value), std::move(value));
 
       if (peek().type == TokenType::COMMA ||
           peek().type == TokenType::SEMICOLON) {
@@ -47,7 +47,7 @@ public:
     ParseError() : std::runtime_error("Parse error") {}
   };
 
-  Parser(const std::vector<Token> &toks, DiagnosticEngine &diag);
+  Parser(std::vector<Token> toks, DiagnosticEngine &diag);
   ~Parser();
   std::unique_ptr<RootNode> parse(); // Returns the root of the AST
 
@@ -29,8 +29,9 @@ std::unique_ptr<BindingDecl> Parser::parseBindingDecl(BindingKind kind) {
   }
 
   Token semicolon = eat(TokenType::SEMICOLON);
-  auto declaration = _builder.makeBindingDecl(name.value, std::move(type),
-                                              std::move(initializer), kind);
+  auto declaration =
+      _builder.makeBindingDecl(std::string(name.value), std::move(type),
+                               std::move(initializer), kind);
   _builder.setSpan(declaration.get(),
                    SourceSpan::merge(keyword.span, semicolon.span));
   return declaration;
@@ -52,8 +53,9 @@ std::unique_ptr<BindingDecl> Parser::parseForInitBindingDecl() {
   }
 
   auto declaration =
-      _builder.makeBindingDecl(varNameToken.value, std::move(typeNode),
-                               std::move(initializer), BindingKind::Mutable);
+      _builder.makeBindingDecl(std::string(varNameToken.value),
+                               std::move(typeNode), std::move(initializer),
+                               BindingKind::Mutable);
   _builder.setSpan(declaration.get(),
                    SourceSpan::merge(varKeyword.span, endSpan));
   return declaration;
@@ -1,7 +1,16 @@
 #ifndef ZAP_RUNTIME_ALLOCATION_INTERNAL_H
 #define ZAP_RUNTIME_ALLOCATION_INTERNAL_H
 
+#include <stddef.h>
+
 void zap_runtime_out_of_memory(void);
 
-#endif
+// Size-class pool behind zap_runtime_alloc (allocator.c). Blocks from
+// zap_runtime_alloc, zap_runtime_block_alloc or zap_runtime_block_realloc must
+// be released with zap_runtime_block_free, never free(). The allocation
+// functions return NULL when memory is exhausted.
+void *zap_runtime_block_alloc(size_t size);
+void *zap_runtime_block_realloc(void *block, size_t size);
+void zap_runtime_block_free(void *block);
 
+#endif
@@ -0,0 +1,213 @@
+#include "allocation_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Size-class allocator behind zap_runtime_alloc. ARC objects carry a 24-byte
+// header and most owned strings are short, so nearly every runtime
+// allocation is between 32 and 256 bytes. Those are carved out of 64 KiB
+// slab pages and recycled through one free list per size class; larger
+// requests go straight to malloc. Like the ARC contexts the pool is
+// single-threaded and takes no locks.
+//
+// Slab pages are aligned to their size, so masking a block address yields
+// its page; a hash set of page addresses tells slab blocks apart from
+// malloc'd ones when they are freed. Pages stay with their size class for
+// reuse once carved.
+//
+// Defining ZAP_RUNTIME_SYSTEM_ALLOCATOR (done automatically under
+// AddressSanitizer and MemorySanitizer) makes every block a plain malloc so
+// sanitizers keep seeing individual allocations.
+
+#if !defined(ZAP_RUNTIME_SYSTEM_ALLOCATOR)
+#if defined(__SANITIZE_ADDRESS__)
+#define ZAP_RUNTIME_SYSTEM_ALLOCATOR 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define ZAP_RUNTIME_SYSTEM_ALLOCATOR 1
+#endif
+#endif
+#endif
+
+#if defined(ZAP_RUNTIME_SYSTEM_ALLOCATOR)
+
+void *zap_runtime_block_alloc(size_t size) { return malloc(size ? size : 1); }
+
+void *zap_runtime_block_realloc(void *block, size_t size) {
+  return realloc(block, size ? size : 1);
+}
+
+void zap_runtime_block_free(void *block) { free(block); }
+
+#else
+
+#define ZAP_SLAB_PAGE_SIZE ((size_t)64 * 1024)
+#define ZAP_SLAB_PAGE_HEADER_SIZE ((size_t)64)
+#define ZAP_SLAB_MAX_BLOCK_SIZE ((size_t)256)
+#define ZAP_SLAB_CLASS_COUNT 12
+
+typedef struct zap_slab_page_t {
+  uint32_t block_size;
+  uint32_t size_class;
+} zap_slab_page_t;
+
+typedef struct zap_slab_class_t {
+  void *free_list;
+  char *bump;
+  char *bump_end;
+} zap_slab_class_t;
+
+_Static_assert(sizeof(zap_slab_page_t) <= ZAP_SLAB_PAGE_HEADER_SIZE,
+               "slab page header does not fit its reserved space");
+
+static const uint32_t zap_slab_class_sizes[ZAP_SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256};
+
+// Size class for each 16-byte step up to ZAP_SLAB_MAX_BLOCK_SIZE.
+static const uint8_t zap_slab_class_for_step[ZAP_SLAB_MAX_BLOCK_SIZE / 16 + 1] =
+    {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 9, 10, 10, 11, 11};
+
+static zap_slab_class_t zap_slab_classes[ZAP_SLAB_CLASS_COUNT];
+
+static uintptr_t *zap_slab_pages;
+static size_t zap_slab_page_capacity;
+static size_t zap_slab_page_count;
+static uintptr_t zap_slab_lowest_page = UINTPTR_MAX;
+static uintptr_t zap_slab_highest_page;
+
+static size_t zap_slab_page_slot(uintptr_t page, size_t capacity) {
+  uint64_t key = (uint64_t)(page / ZAP_SLAB_PAGE_SIZE);
+  return (size_t)((key * 0x9e3779b97f4a7c15ULL) >> 32) & (capacity - 1);
+}
+
+static void zap_slab_insert_page(uintptr_t *pages, size_t capacity,
+                                 uintptr_t page) {
+  size_t slot = zap_slab_page_slot(page, capacity);
+  while (pages[slot] != 0) {
+    slot = (slot + 1) & (capacity - 1);
+  }
+  pages[slot] = page;
+}
+
+static int zap_slab_register_page(uintptr_t page) {
+  if ((zap_slab_page_count + 1) * 2 > zap_slab_page_capacity) {
+    size_t capacity = zap_slab_page_capacity ? zap_slab_page_capacity * 2 : 64;
+    uintptr_t *pages = (uintptr_t *)calloc(capacity, sizeof(uintptr_t));
+    if (!pages) {
+      return 0;
+    }
+    for (size_t i = 0; i < zap_slab_page_capacity; ++i) {
+      if (zap_slab_pages[i] != 0) {
+        zap_slab_insert_page(pages, capacity, zap_slab_pages[i]);
+      }
+    }
+    free(zap_slab_pages);
+    zap_slab_pages = pages;
+    zap_slab_page_capacity = capacity;
+  }
+  zap_slab_insert_page(zap_slab_pages, zap_slab_page_capacity, page);
+  ++zap_slab_page_count;
+  if (page < zap_slab_lowest_page) {
+    zap_slab_lowest_page = page;
+  }
+  if (page > zap_slab_highest_page) {
+    zap_slab_highest_page = page;
+  }
+  return 1;
+}
+
+static zap_slab_page_t *zap_slab_page_of(const void *block) {
+  uintptr_t page = (uintptr_t)block & ~(uintptr_t)(ZAP_SLAB_PAGE_SIZE - 1);
+  if (page < zap_slab_lowest_page || page > zap_slab_highest_page) {
+    return NULL;
+  }
+  size_t slot = zap_slab_page_slot(page, zap_slab_page_capacity);
+  while (zap_slab_pages[slot] != 0) {
+    if (zap_slab_pages[slot] == page) {
+      return (zap_slab_page_t *)page;
+    }
+    slot = (slot + 1) & (zap_slab_page_capacity - 1);
+  }
+  return NULL;
+}
+
+static int zap_slab_refill(size_t size_class) {
+  void *memory = aligned_alloc(ZAP_SLAB_PAGE_SIZE, ZAP_SLAB_PAGE_SIZE);
+  if (!memory) {
+    return 0;
+  }
+  if (!zap_slab_register_page((uintptr_t)memory)) {
+    free(memory);
+    return 0;
+  }
+  zap_slab_page_t *page = (zap_slab_page_t *)memory;
+  page->block_size = zap_slab_class_sizes[size_class];
+  page->size_class = (uint32_t)size_class;
+
+  zap_slab_class_t *slab_class = &zap_slab_classes[size_class];
+  slab_class->bump = (char *)memory + ZAP_SLAB_PAGE_HEADER_SIZE;
+  slab_class->bump_end =
+      slab_class->bump + (ZAP_SLAB_PAGE_SIZE - ZAP_SLAB_PAGE_HEADER_SIZE) /
+                             page->block_size * page->block_size;
+  return 1;
+}
+
+void *zap_runtime_block_alloc(size_t size) {
+  if (size > ZAP_SLAB_MAX_BLOCK_SIZE) {
+    return malloc(size);
+  }
+  size_t size_class = zap_slab_class_for_step[(size + 15) / 16];
+  zap_slab_class_t *slab_class = &zap_slab_classes[size_class];
+  void *block = slab_class->free_list;
+  if (block) {
+    slab_class->free_list = *(void **)block;
+    return block;
+  }
+  if (slab_class->bump == slab_class->bump_end &&
+      !zap_slab_refill(size_class)) {
+    return NULL;
+  }
+  block = slab_class->bump;
+  slab_class->bump += zap_slab_class_sizes[size_class];
+  return block;
+}
+
+void zap_runtime_block_free(void *block) {
+  if (!block) {
+    return;
+  }
+  zap_slab_page_t *page = zap_slab_page_of(block);
+  if (!page) {
+    free(block);
+    return;
+  }
+  zap_slab_class_t *slab_class = &zap_slab_classes[page->size_class];
+  *(void **)block = slab_class->free_list;
+  slab_class->free_list = block;
+}
+
+void *zap_runtime_block_realloc(void *block, size_t size) {
+  if (!block) {
+    return zap_runtime_block_alloc(size);
+  }
+  zap_slab_page_t *page = zap_slab_page_of(block);
+  if (!page) {
+    // malloc'd blocks stay with malloc even when they shrink below the slab
+    // limit; zap_runtime_block_free() handles either kind.
+    return realloc(block, size ? size : 1);
+  }
+  if (size <= page->block_size) {
+    return block;
+  }
+  void *resized = zap_runtime_block_alloc(size);
+  if (!resized) {
+    return NULL;
+  }
+  memcpy(resized, block, page->block_size);
+  zap_runtime_block_free(block);
+  return resized;
+}
+
+#endif
@@ -6,10 +6,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+// Adaptive root threshold used once a collection budget is set: a collection
+// that traced N live objects waits for N / ZAP_ARC_LIVE_OBJECTS_PER_ROOT
+// buffered roots before tracing again, within these bounds.
+#define ZAP_ARC_LIVE_OBJECTS_PER_ROOT 64
+#define ZAP_ARC_MAX_ROOT_THRESHOLD 1024
+// Buffered roots below the threshold still start a collection after this many
+// safe points, so a lone self-cycle is never postponed indefinitely.
+#define ZAP_ARC_MAX_DEFERRED_SAFEPOINTS 64
+// Safe-point slices read the clock once per this many objects of work.
+#define ZAP_ARC_CLOCK_CHECK_INTERVAL 32
 
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
 static zap_runtime_ownership_counters_t zap_runtime_ownership_counters;
 static int zap_runtime_fail_arc_scratch_allocation = 0;
+static int zap_runtime_fail_allocation = 0;
 
 void zap_runtime_ownership_reset_counters(void) {
   memset(&zap_runtime_ownership_counters, 0,
@@ -55,9 +68,21 @@ uint64_t zap_runtime_ownership_destroy_calls(void) {
   return zap_runtime_ownership_counters.destroy_calls;
 }
 
+uint64_t zap_runtime_ownership_strong_retain_calls(void) {
+  return zap_runtime_ownership_counters.strong_retain_calls;
+}
+
+uint64_t zap_runtime_ownership_strong_release_calls(void) {
+  return zap_runtime_ownership_counters.strong_release_calls;
+}
+
 void zap_runtime_test_fail_next_arc_scratch_allocation(void) {
   zap_runtime_fail_arc_scratch_allocation = 1;
 }
+
+void zap_runtime_test_fail_next_allocation(void) {
+  zap_runtime_fail_allocation = 1;
+}
 #endif
 
 void zap_runtime_out_of_memory(void) {
@@ -72,7 +97,13 @@ static void zap_arc_graph_limit_exceeded(void) {
 }
 
 void *zap_runtime_alloc(size_t size) {
-  void *allocation = malloc(size);
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  if (zap_runtime_fail_allocation) {
+    zap_runtime_fail_allocation = 0;
+    zap_runtime_out_of_memory();
+  }
+#endif
+  void *allocation = zap_runtime_block_alloc(size);
   if (!allocation) {
     zap_runtime_out_of_memory();
   }
@@ -148,12 +179,30 @@ typedef struct {
   size_t len;
 } zap_arc_ptrmap_t;
 
+typedef enum {
+  ZAP_ARC_PHASE_IDLE,
+  ZAP_ARC_PHASE_DISCOVER,
+  ZAP_ARC_PHASE_COUNT,
+  ZAP_ARC_PHASE_MARK
+} zap_arc_phase_t;
+
 struct zap_arc_runtime_context_t {
   void **roots;
   size_t root_count;
   size_t root_capacity;
+  size_t root_threshold;
+  unsigned deferred_safepoints;
   int collecting;
   int collection_pending;
+  // Collection in progress. Every object in worklist[0, ws_count) carries
+  // ZAP_ARC_GC_TRACKED until the collection finishes.
+  zap_arc_phase_t phase;
+  int spans_safepoints;
+  size_t ws_count;
+  size_t cursor;
+  size_t sp;
+  uint64_t budget_objects;
+  uint64_t budget_nanoseconds;
   void **snap;
   size_t snap_cap;
   void **worklist;
@@ -182,6 +231,15 @@ zap_arc_context_release_storage(zap_arc_runtime_context_t *context) {
       header->gc_mark &= (uint8_t)~ZAP_ARC_GC_BUFFERED;
     }
   }
+  // Abandon a collection in progress: its objects belong to the program again,
+  // and the ones the program already deallocated are freed now.
+  for (size_t i = 0; i < context->ws_count; ++i) {
+    zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
+    header->gc_mark &= (uint8_t)~ZAP_ARC_GC_TRACKED;
+    if (header->gc_mark & ZAP_ARC_GC_DEALLOCATE_PENDING) {
+      zap_runtime_block_free(header);
+    }
+  }
   free(context->roots);
   free(context->snap);
   free(context->worklist);
@@ -228,22 +286,12 @@ void zap_arc_add_possible_root(zap_arc_runtime_context_t *context,
 
   header->gc_mark |= ZAP_ARC_GC_BUFFERED;
   context->roots[context->root_count++] = object;
-  if (context->root_count >= ZAP_ARC_COLLECTION_ROOT_THRESHOLD) {
-    context->collection_pending = 1;
-  }
+  context->collection_pending = 1;
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
   ++zap_runtime_ownership_counters.candidate_roots;
 #endif
 }
 
-void zap_arc_collect_at_safepoint(zap_arc_runtime_context_t *context) {
-  if (!context || !context->collection_pending || context->collecting) {
-    return;
-  }
-  context->collection_pending = 0;
-  zap_arc_cycle_collect(context);
-}
-
 void zap_arc_remove_possible_root(zap_arc_runtime_context_t *context,
                                   void *object) {
   if (!context || !object) {
@@ -262,6 +310,10 @@ void zap_arc_remove_possible_root(zap_arc_runtime_context_t *context,
       break;
     }
   }
+  if (context->root_count == 0 && context->phase == ZAP_ARC_PHASE_IDLE) {
+    context->collection_pending = 0;
+    context->deferred_safepoints = 0;
+  }
 }
 
 void zap_arc_deallocate(zap_arc_runtime_context_t *context, void *object) {
@@ -269,7 +321,14 @@ void zap_arc_deallocate(zap_arc_runtime_context_t *context, void *object) {
     return;
   }
   zap_arc_remove_possible_root(context, object);
-  free(object);
+  zap_arc_header_t *header = (zap_arc_header_t *)object;
+  if (header->gc_mark & ZAP_ARC_GC_TRACKED) {
+    // A collection in progress still indexes this object; it frees the
+    // storage when it finishes.
+    header->gc_mark |= ZAP_ARC_GC_DEALLOCATE_PENDING;
+    return;
+  }
+  zap_runtime_block_free(object);
 }
 
 static size_t zap_arc_hash_ptr(void *p) {
@@ -366,6 +425,7 @@ static void zap_arc_ws_push(void ***ws, size_t *count, size_t *cap,
     *cap = ncap;
   }
   zap_arc_ptrmap_put(map, object, (uint32_t)*count);
+  ((zap_arc_header_t *)object)->gc_mark |= ZAP_ARC_GC_TRACKED;
   (*ws)[(*count)++] = object;
 }
 
@@ -414,12 +474,15 @@ static void zap_arc_discover_child(void *context, void *child) {
 typedef struct {
   const zap_arc_ptrmap_t *map;
   int *incoming;
+  // When set, only references to objects not yet marked reachable count.
+  const uint8_t *reachable;
 } zap_arc_incoming_context_t;
 
 static void zap_arc_count_incoming(void *context, void *child) {
   zap_arc_incoming_context_t *state = (zap_arc_incoming_context_t *)context;
   uint32_t child_index;
-  if (child && zap_arc_ptrmap_get(state->map, child, &child_index)) {
+  if (child && zap_arc_ptrmap_get(state->map, child, &child_index) &&
+      (!state->reachable || !state->reachable[child_index])) {
     state->incoming[child_index] += 1;
   }
 }
@@ -441,15 +504,66 @@ static void zap_arc_mark_reachable(void *context, void *child) {
   }
 }
 
-void zap_arc_cycle_collect(zap_arc_runtime_context_t *context) {
-  if (!context || context->collecting || context->root_count == 0) {
-    return;
+typedef struct {
+  uint64_t remaining;
+  uint64_t deadline;
+  unsigned until_clock_check;
+} zap_arc_slice_t;
+
+static uint64_t zap_arc_now_nanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static zap_arc_slice_t
+zap_arc_safepoint_slice(const zap_arc_runtime_context_t *context) {
+  zap_arc_slice_t slice = {UINT64_MAX, 0, ZAP_ARC_CLOCK_CHECK_INTERVAL};
+  if (context->budget_objects) {
+    slice.remaining = context->budget_objects;
   }
-  context->collecting = 1;
-#if defined(ZAP_RUNTIME_INSTRUMENTATION)
-  ++zap_runtime_ownership_counters.collection_runs;
-#endif
+  if (context->budget_nanoseconds) {
+    slice.deadline = zap_arc_now_nanoseconds() + context->budget_nanoseconds;
+  }
+  return slice;
+}
 
+// Takes one object's worth of work from the slice; returns 0 once the slice
+// is used up.
+static int zap_arc_slice_take(zap_arc_slice_t *slice) {
+  if (slice->remaining == 0) {
+    return 0;
+  }
+  if (slice->deadline && --slice->until_clock_check == 0) {
+    slice->until_clock_check = ZAP_ARC_CLOCK_CHECK_INTERVAL;
+    if (zap_arc_now_nanoseconds() >= slice->deadline) {
+      slice->remaining = 0;
+      return 0;
+    }
+  }
+  if (slice->remaining != UINT64_MAX) {
+    --slice->remaining;
+  }
+  return 1;
+}
+
+static size_t zap_arc_root_threshold(const zap_arc_runtime_context_t *context) {
+  return context->root_threshold > ZAP_ARC_COLLECTION_ROOT_THRESHOLD
+             ? context->root_threshold
+             : ZAP_ARC_COLLECTION_ROOT_THRESHOLD;
+}
+
+static void zap_arc_trace_object(void *object, zap_arc_trace_visitor_t visitor,
+                                 void *visitor_context) {
+  zap_arc_header_t *header = (zap_arc_header_t *)object;
+  if (header->alive && header->type && header->type->trace_fn) {
+    header->type->trace_fn(object, visitor, visitor_context);
+  }
+}
+
+// Snapshots the buffered roots into a new collection. Returns 0 when there is
+// nothing to collect.
+static int zap_arc_begin_collection(zap_arc_runtime_context_t *context) {
   if (context->root_count > context->snap_cap) {
     void **next = (void **)zap_runtime_realloc_array(
         context->snap, context->root_count, sizeof(void *));
@@ -468,107 +582,278 @@ void zap_arc_cycle_collect(zap_arc_runtime_context_t *context) {
     roots[root_count++] = object;
   }
   context->root_count = 0;
-  context->collection_pending = 0;
+  context->deferred_safepoints = 0;
   if (root_count == 0) {
-    context->collecting = 0;
-    return;
+    return 0;
   }
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  ++zap_runtime_ownership_counters.collection_runs;
+#endif
 
   if (context->map.cap == 0) {
     zap_arc_ptrmap_init(&context->map, 64);
   }
   zap_arc_ptrmap_clear(&context->map);
-
-  size_t ws_count = 0;
+  context->ws_count = 0;
   for (size_t i = 0; i < root_count; ++i) {
-    zap_arc_ws_push(&context->worklist, &ws_count, &context->worklist_cap,
-                    &context->map, roots[i]);
+    zap_arc_ws_push(&context->worklist, &context->ws_count,
+                    &context->worklist_cap, &context->map, roots[i]);
+  }
+  context->phase = ZAP_ARC_PHASE_DISCOVER;
+  context->spans_safepoints = 0;
+  context->cursor = 0;
+  context->sp = 0;
+  return 1;
+}
+
+// Advances the trial deletion over the discovered graph until the slice runs
+// out. Returns 1 once every object has been classified. Objects marked
+// reachable are externally referenced or reachable from one that is.
+static int zap_arc_advance_collection(zap_arc_runtime_context_t *context,
+                                      zap_arc_slice_t *slice) {
+  if (context->phase == ZAP_ARC_PHASE_DISCOVER) {
+    zap_arc_discover_context_t discovery = {
+        &context->worklist, &context->ws_count, &context->worklist_cap,
+        &context->map};
+    for (; context->cursor < context->ws_count; ++context->cursor) {
+      if (!zap_arc_slice_take(slice)) {
+        return 0;
+      }
+      zap_arc_trace_object(context->worklist[context->cursor],
+                           zap_arc_discover_child, &discovery);
+    }
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+    zap_runtime_ownership_counters.visited_objects += context->ws_count;
+#endif
+    zap_arc_ensure_scratch(context, context->ws_count);
+    memset(context->incoming, 0, context->ws_count * sizeof(int));
+    memset(context->reachable, 0, context->ws_count * sizeof(uint8_t));
+    context->cursor = 0;
+    context->phase = ZAP_ARC_PHASE_COUNT;
+  }
+
+  if (context->phase == ZAP_ARC_PHASE_COUNT) {
+    zap_arc_incoming_context_t incoming_context = {&context->map,
+                                                   context->incoming, NULL};
+    for (; context->cursor < context->ws_count; ++context->cursor) {
+      if (!zap_arc_slice_take(slice)) {
+        return 0;
+      }
+      zap_arc_trace_object(context->worklist[context->cursor],
+                           zap_arc_count_incoming, &incoming_context);
+    }
+    context->cursor = 0;
+    context->sp = 0;
+    context->phase = ZAP_ARC_PHASE_MARK;
   }
-  for (size_t cursor = 0; cursor < ws_count; ++cursor) {
-    zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[cursor];
-    if (!header->alive || !header->metadata) {
+
+  zap_arc_reachable_context_t reachable_context = {
+      &context->map, context->reachable, context->stack, &context->sp};
+  for (;;) {
+    if (!zap_arc_slice_take(slice)) {
+      return 0;
+    }
+    if (context->sp) {
+      uint32_t index = context->stack[--context->sp];
+      zap_arc_trace_object(context->worklist[index], zap_arc_mark_reachable,
+                           &reachable_context);
       continue;
     }
-    if (header->metadata->trace_fn) {
-      zap_arc_discover_context_t discovery = {
-          &context->worklist, &ws_count, &context->worklist_cap, &context->map};
-      header->metadata->trace_fn(context->worklist[cursor],
-                                 zap_arc_discover_child, &discovery);
+    if (context->cursor == context->ws_count) {
+      return 1;
+    }
+    size_t i = context->cursor++;
+    zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
+    if (header->alive && header->strong_count > context->incoming[i] &&
+        !context->reachable[i]) {
+      context->reachable[i] = 1;
+      context->stack[context->sp++] = (uint32_t)i;
     }
   }
+}
 
-#if defined(ZAP_RUNTIME_INSTRUMENTATION)
-  zap_runtime_ownership_counters.visited_objects += ws_count;
-#endif
-
-  zap_arc_ensure_scratch(context, ws_count);
+// The program ran between the slices of this collection, so the counts it
+// used may be stale. Garbage cannot change once it is unreachable, so every
+// real garbage object is still a candidate; rerun trial deletion over the
+// candidates alone, with the program stopped, to drop any that were
+// referenced again in the meantime.
+static void zap_arc_recheck_candidates(zap_arc_runtime_context_t *context) {
   int *incoming = context->incoming;
   uint8_t *reachable = context->reachable;
-  uint32_t *stack = context->stack;
-  memset(incoming, 0, ws_count * sizeof(int));
-  memset(reachable, 0, ws_count * sizeof(uint8_t));
-
+  size_t ws_count = context->ws_count;
   for (size_t i = 0; i < ws_count; ++i) {
-    zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
-    if (!header->alive || !header->metadata) {
-      continue;
+    if (!reachable[i]) {
+      incoming[i] = 0;
     }
-    if (header->metadata->trace_fn) {
-      zap_arc_incoming_context_t incoming_context = {&context->map, incoming};
-      header->metadata->trace_fn(context->worklist[i], zap_arc_count_incoming,
-                                 &incoming_context);
+  }
+  zap_arc_incoming_context_t incoming_context = {&context->map, incoming,
+                                                 reachable};
+  for (size_t i = 0; i < ws_count; ++i) {
+    if (!reachable[i]) {
+      zap_arc_trace_object(context->worklist[i], zap_arc_count_incoming,
+                           &incoming_context);
     }
   }
-
   size_t sp = 0;
   for (size_t i = 0; i < ws_count; ++i) {
     zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
-    if (header->alive && header->strong_count > incoming[i] && !reachable[i]) {
+    if (!reachable[i] && header->alive && header->strong_count > incoming[i]) {
       reachable[i] = 1;
-      stack[sp++] = (uint32_t)i;
+      context->stack[sp++] = (uint32_t)i;
     }
   }
+  zap_arc_reachable_context_t reachable_context = {&context->map, reachable,
+                                                   context->stack, &sp};
   while (sp) {
-    uint32_t idx = stack[--sp];
-    zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[idx];
-    if (!header->alive || !header->metadata) {
-      continue;
-    }
-    if (header->metadata->trace_fn) {
-      zap_arc_reachable_context_t reachable_context = {&context->map, reachable,
-                                                       stack, &sp};
-      header->metadata->trace_fn(context->worklist[idx], zap_arc_mark_reachable,
-                                 &reachable_context);
-    }
+    uint32_t index = context->stack[--sp];
+    zap_arc_trace_object(context->worklist[index], zap_arc_mark_reachable,
+                         &reachable_context);
+  }
+}
+
+static void zap_arc_finish_collection(zap_arc_runtime_context_t *context) {
+  if (context->spans_safepoints) {
+    zap_arc_recheck_candidates(context);
   }
 
+  size_t ws_count = context->ws_count;
+  size_t reclaimed = 0;
   for (size_t i = 0; i < ws_count; ++i) {
     zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
-    if (!header->alive || reachable[i]) {
+    if (!header->alive || context->reachable[i]) {
       continue;
     }
-    header->gc_mark = ZAP_ARC_GC_GARBAGE;
+    header->gc_mark =
+        (uint8_t)((header->gc_mark &
+                   (ZAP_ARC_GC_BUFFERED | ZAP_ARC_GC_TRACKED)) |
+                  ZAP_ARC_GC_GARBAGE);
     header->alive = 0;
+    ++reclaimed;
+  }
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
-    ++zap_runtime_ownership_counters.reclaimed_objects;
+  zap_runtime_ownership_counters.reclaimed_objects += reclaimed;
 #endif
-  }
   for (size_t i = 0; i < ws_count; ++i) {
     zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
-    if ((header->gc_mark & ZAP_ARC_GC_GARBAGE) && header->destroy_fn) {
-      header->destroy_fn(context->worklist[i]);
+    if ((header->gc_mark & ZAP_ARC_GC_GARBAGE) && header->type &&
+        header->type->destroy_fn) {
+      header->type->destroy_fn(context->worklist[i]);
     }
   }
   for (size_t i = 0; i < ws_count; ++i) {
     zap_arc_header_t *header = (zap_arc_header_t *)context->worklist[i];
+    header->gc_mark &= (uint8_t)~ZAP_ARC_GC_TRACKED;
     if ((header->gc_mark & ZAP_ARC_GC_GARBAGE) && header->weak_count == 0) {
       zap_arc_deallocate(context, context->worklist[i]);
     } else if (header->gc_mark & ZAP_ARC_GC_GARBAGE) {
       header->gc_mark &= (uint8_t)~ZAP_ARC_GC_GARBAGE;
+    } else if (header->gc_mark & ZAP_ARC_GC_DEALLOCATE_PENDING) {
+      zap_runtime_block_free(header);
     }
   }
 
+  if (context->budget_objects || context->budget_nanoseconds) {
+    size_t threshold =
+        (ws_count - reclaimed) / ZAP_ARC_LIVE_OBJECTS_PER_ROOT;
+    context->root_threshold = threshold < ZAP_ARC_MAX_ROOT_THRESHOLD
+                                  ? threshold
+                                  : ZAP_ARC_MAX_ROOT_THRESHOLD;
+  }
+  context->phase = ZAP_ARC_PHASE_IDLE;
+  context->ws_count = 0;
+  context->cursor = 0;
+  context->sp = 0;
+}
+
+// Runs the collection in progress, or starts one from the buffered roots,
+// until it finishes or the slice is used up.
+static void zap_arc_collect_slice(zap_arc_runtime_context_t *context,
+                                  zap_arc_slice_t *slice) {
+  if (context->phase == ZAP_ARC_PHASE_IDLE) {
+    if (!zap_arc_begin_collection(context)) {
+      return;
+    }
+  } else {
+    context->spans_safepoints = 1;
+  }
+  context->collecting = 1;
+  if (zap_arc_advance_collection(context, slice)) {
+    zap_arc_finish_collection(context);
+  }
   context->collecting = 0;
+  if (context->phase != ZAP_ARC_PHASE_IDLE || context->root_count) {
+    context->collection_pending = 1;
+  }
+}
+
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+static void zap_arc_note_pause(uint64_t nanoseconds) {
+  zap_runtime_ownership_counters_t *counters = &zap_runtime_ownership_counters;
+  ++counters->collection_slices;
+  counters->pause_nanoseconds_total += nanoseconds;
+  if (nanoseconds > counters->pause_nanoseconds_max) {
+    counters->pause_nanoseconds_max = nanoseconds;
+  }
+  unsigned bucket = 0;
+  for (uint64_t micros = nanoseconds / 1000; micros; micros >>= 1) {
+    ++bucket;
+  }
+  if (bucket >= ZAP_ARC_PAUSE_HISTOGRAM_BUCKETS) {
+    bucket = ZAP_ARC_PAUSE_HISTOGRAM_BUCKETS - 1;
+  }
+  ++counters->pause_histogram[bucket];
+}
+#endif
+
+void zap_arc_set_collection_budget(zap_arc_runtime_context_t *context,
+                                   uint64_t max_objects,
+                                   uint64_t max_nanoseconds) {
+  if (!context) {
+    return;
+  }
+  context->budget_objects = max_objects;
+  context->budget_nanoseconds = max_nanoseconds;
+  if (!max_objects && !max_nanoseconds) {
+    context->root_threshold = ZAP_ARC_COLLECTION_ROOT_THRESHOLD;
+  }
+}
+
+void zap_arc_collect_at_safepoint(zap_arc_runtime_context_t *context) {
+  if (!context || !context->collection_pending || context->collecting) {
+    return;
+  }
+  if (context->phase == ZAP_ARC_PHASE_IDLE &&
+      context->root_count < zap_arc_root_threshold(context) &&
+      ++context->deferred_safepoints < ZAP_ARC_MAX_DEFERRED_SAFEPOINTS) {
+    return;
+  }
+  context->collection_pending = 0;
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  uint64_t start = zap_arc_now_nanoseconds();
+#endif
+  zap_arc_slice_t slice = zap_arc_safepoint_slice(context);
+  zap_arc_collect_slice(context, &slice);
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  zap_arc_note_pause(zap_arc_now_nanoseconds() - start);
+#endif
+}
+
+void zap_arc_cycle_collect(zap_arc_runtime_context_t *context) {
+  if (!context || context->collecting) {
+    return;
+  }
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  uint64_t start = zap_arc_now_nanoseconds();
+#endif
+  zap_arc_slice_t slice = {UINT64_MAX, 0, ZAP_ARC_CLOCK_CHECK_INTERVAL};
+  if (context->phase != ZAP_ARC_PHASE_IDLE) {
+    zap_arc_collect_slice(context, &slice);
+  }
+  zap_arc_collect_slice(context, &slice);
+  context->collection_pending = context->root_count != 0;
+#if defined(ZAP_RUNTIME_INSTRUMENTATION)
+  zap_arc_note_pause(zap_arc_now_nanoseconds() - start);
+#endif
 }
 
 __attribute__((destructor)) static void zap_arc_shutdown(void) {
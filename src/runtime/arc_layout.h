@@ -4,48 +4,61 @@
 #include <stdint.h>
 
 // Shared ARC object header ABI used by runtime (C) and codegen (C++).
-#define ZAP_ARC_ABI_VERSION 5
+#define ZAP_ARC_ABI_VERSION 6
 #define ZAP_ARC_STRONG_COUNT_INDEX 0
 #define ZAP_ARC_WEAK_COUNT_INDEX 1
 #define ZAP_ARC_ALIVE_INDEX 2
 #define ZAP_ARC_GC_MARK_INDEX 3
-#define ZAP_ARC_RELEASE_FN_INDEX 4
-#define ZAP_ARC_DESTROY_FN_INDEX 5
-#define ZAP_ARC_METADATA_INDEX 6
-#define ZAP_ARC_VTABLE_INDEX 7
-#define ZAP_ARC_FIELD_START_INDEX 8
+#define ZAP_ARC_TYPE_INDEX 4
+#define ZAP_ARC_FIELD_START_INDEX 5
 #define ZAP_ARC_HEADER_FIELD_COUNT ZAP_ARC_FIELD_START_INDEX
+// Field indices of zap_arc_type_t; the class vtable is laid out inline after
+// the fixed fields, at ZAP_ARC_TYPE_VTABLE_INDEX.
+#define ZAP_ARC_TYPE_RELEASE_FN_INDEX 0
+#define ZAP_ARC_TYPE_DESTROY_FN_INDEX 1
+#define ZAP_ARC_TYPE_TRACE_FN_INDEX 2
+#define ZAP_ARC_TYPE_VTABLE_INDEX 3
 // A self-cycle has one possible root, so a larger threshold would postpone its
-// finalization indefinitely when no other managed object is released.
+// finalization indefinitely when no other managed object is released. With a
+// collection budget set the runtime raises the threshold for large live graphs
+// but still collects a lone root after a bounded number of safe points.
 #define ZAP_ARC_COLLECTION_ROOT_THRESHOLD 1
+// Collector pause histogram: bucket 0 counts pauses under 1us, bucket k
+// counts pauses in [2^(k-1), 2^k) us and the last bucket all longer ones.
+#define ZAP_ARC_PAUSE_HISTOGRAM_BUCKETS 16
 
 // Flag bits packed into the gc_mark byte (index 3).
 #define ZAP_ARC_GC_GARBAGE 0x1
 #define ZAP_ARC_GC_BUFFERED 0x2
 #define ZAP_ARC_GC_FINALIZING 0x4
+// Set while an object is indexed by a collection in progress; deallocation is
+// deferred to the collector, which DEALLOCATE_PENDING records.
+#define ZAP_ARC_GC_TRACKED 0x8
+#define ZAP_ARC_GC_DEALLOCATE_PENDING 0x10
 
 typedef void (*zap_arc_trace_visitor_t)(void *context, void *child);
 typedef void (*zap_arc_trace_fn_t)(void *object,
                                    zap_arc_trace_visitor_t visitor,
                                    void *context);
 
-typedef struct zap_arc_metadata_t {
+// Per-class constants shared by every instance. Codegen emits one descriptor
+// per class, followed directly by that class's virtual method table.
+typedef struct zap_arc_type_t {
+  void (*release_fn)(void *);
+  // Finalizes the object and drops its fields; storage is deallocated
+  // separately.
+  void (*destroy_fn)(void *);
   zap_arc_trace_fn_t trace_fn;
-} zap_arc_metadata_t;
+} zap_arc_type_t;
 
 typedef struct zap_arc_runtime_context_t zap_arc_runtime_context_t;
 
 typedef struct zap_arc_header_t {
   int64_t strong_count;
-  int64_t weak_count;
+  uint32_t weak_count;
   uint8_t alive;
   uint8_t gc_mark;
-  void (*release_fn)(void *);
-  // Finalizes the object and drops its fields; storage is deallocated
-  // separately.
-  void (*destroy_fn)(void *);
-  const zap_arc_metadata_t *metadata;
-  void **vtable;
+  const zap_arc_type_t *type;
 } zap_arc_header_t;
 
 #if defined(ZAP_RUNTIME_INSTRUMENTATION)
@@ -60,6 +73,12 @@ typedef struct zap_runtime_ownership_counters_t {
   uint64_t collection_runs;
   uint64_t visited_objects;
   uint64_t reclaimed_objects;
+  // One pause per safe point that ran collector work, or per explicit
+  // zap_arc_cycle_collect() call.
+  uint64_t collection_slices;
+  uint64_t pause_nanoseconds_total;
+  uint64_t pause_nanoseconds_max;
+  uint64_t pause_histogram[ZAP_ARC_PAUSE_HISTOGRAM_BUCKETS];
 } zap_runtime_ownership_counters_t;
 #endif
 
@@ -82,9 +101,17 @@ void zap_arc_add_possible_root(zap_arc_runtime_context_t *context,
 void zap_arc_remove_possible_root(zap_arc_runtime_context_t *context,
                                   void *object);
 void zap_arc_deallocate(zap_arc_runtime_context_t *context, void *object);
+// Collects every buffered root, finishing any collection in progress.
 void zap_arc_cycle_collect(zap_arc_runtime_context_t *context);
 // Runs scheduled collection at a non-destructor function-return safe point.
 void zap_arc_collect_at_safepoint(zap_arc_runtime_context_t *context);
+// Bounds the collector work done at one safe point to max_objects traced
+// objects and, when max_nanoseconds is nonzero, roughly that much time. A
+// collection that does not fit resumes at later safe points. Zero for both,
+// the default, collects all buffered roots at the first safe point.
+void zap_arc_set_collection_budget(zap_arc_runtime_context_t *context,
+                                   uint64_t max_objects,
+                                   uint64_t max_nanoseconds);
 void *zap_runtime_alloc(size_t size);
 void zap_arc_strong_refcount_overflow(void);
 void zap_arc_weak_refcount_overflow(void);
@@ -104,8 +131,12 @@ void zap_runtime_ownership_note_destroy(void);
 uint64_t zap_runtime_ownership_copy_operations(void);
 uint64_t zap_runtime_ownership_drop_operations(void);
 uint64_t zap_runtime_ownership_destroy_calls(void);
+uint64_t zap_runtime_ownership_strong_retain_calls(void);
+uint64_t zap_runtime_ownership_strong_release_calls(void);
 // Test-only fault injection for the collector's scratch-storage allocation.
 void zap_runtime_test_fail_next_arc_scratch_allocation(void);
+// Test-only fault injection for the next zap_runtime_alloc() call.
+void zap_runtime_test_fail_next_allocation(void);
 #endif
 
 #if defined(__cplusplus)
@@ -120,14 +151,8 @@ ZAP_ARC_STATIC_ASSERT(ZAP_ARC_ALIVE_INDEX == 2,
                       "ARC ABI: alive index mismatch");
 ZAP_ARC_STATIC_ASSERT(ZAP_ARC_GC_MARK_INDEX == 3,
                       "ARC ABI: gc_mark index mismatch");
-ZAP_ARC_STATIC_ASSERT(ZAP_ARC_RELEASE_FN_INDEX == 4,
-                      "ARC ABI: release_fn index mismatch");
-ZAP_ARC_STATIC_ASSERT(ZAP_ARC_DESTROY_FN_INDEX == 5,
-                      "ARC ABI: destroy_fn index mismatch");
-ZAP_ARC_STATIC_ASSERT(ZAP_ARC_METADATA_INDEX == 6,
-                      "ARC ABI: metadata index mismatch");
-ZAP_ARC_STATIC_ASSERT(ZAP_ARC_VTABLE_INDEX == 7,
-                      "ARC ABI: vtable index mismatch");
+ZAP_ARC_STATIC_ASSERT(ZAP_ARC_TYPE_INDEX == 4,
+                      "ARC ABI: type index mismatch");
 ZAP_ARC_STATIC_ASSERT(ZAP_ARC_HEADER_FIELD_COUNT == ZAP_ARC_FIELD_START_INDEX,
                       "ARC ABI: header field count mismatch");
 ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, strong_count) == 0,
@@ -141,17 +166,21 @@ ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, alive) >
 ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, gc_mark) >
                           offsetof(zap_arc_header_t, alive),
                       "ARC ABI: gc_mark must be after alive");
-ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, release_fn) >
+ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, type) >
                           offsetof(zap_arc_header_t, gc_mark),
-                      "ARC ABI: release_fn must be after gc_mark");
-ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, destroy_fn) >
-                          offsetof(zap_arc_header_t, release_fn),
-                      "ARC ABI: destroy_fn must be after release_fn");
-ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, metadata) >
-                          offsetof(zap_arc_header_t, destroy_fn),
-                      "ARC ABI: metadata must be after destroy_fn");
-ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, vtable) >
-                          offsetof(zap_arc_header_t, metadata),
-                      "ARC ABI: vtable must be after metadata");
+                      "ARC ABI: type must be after gc_mark");
+ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_header_t, type) == 16,
+                      "ARC ABI: counts and flags must fit in two words");
+ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_type_t, release_fn) == 0,
+                      "ARC ABI: type release_fn offset mismatch");
+ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_type_t, destroy_fn) ==
+                          ZAP_ARC_TYPE_DESTROY_FN_INDEX * sizeof(void *),
+                      "ARC ABI: type destroy_fn offset mismatch");
+ZAP_ARC_STATIC_ASSERT(offsetof(zap_arc_type_t, trace_fn) ==
+                          ZAP_ARC_TYPE_TRACE_FN_INDEX * sizeof(void *),
+                      "ARC ABI: type trace_fn offset mismatch");
+ZAP_ARC_STATIC_ASSERT(sizeof(zap_arc_type_t) ==
+                          ZAP_ARC_TYPE_VTABLE_INDEX * sizeof(void *),
+                      "ARC ABI: type vtable offset mismatch");
 
 #undef ZAP_ARC_STATIC_ASSERT
@@ -1,6 +1,7 @@
 #include "string_layout.h"
 #include "allocation_internal.h"
 #include "arc_layout.h"
+#include "string_hash.h"
 #include "string_internal.h"
 
 #include <limits.h>
@@ -16,19 +17,58 @@ _Static_assert(offsetof(zap_string_header_t, refs) == 0,
                "String ABI: refs offset mismatch");
 _Static_assert(offsetof(zap_string_header_t, len) == sizeof(int64_t),
                "String ABI: len offset mismatch");
-_Static_assert(sizeof(zap_string_header_t) == 2 * sizeof(int64_t),
+_Static_assert(offsetof(zap_string_header_t, hash) == 2 * sizeof(int64_t),
+               "String ABI: hash offset mismatch");
+_Static_assert(sizeof(zap_string_header_t) == 3 * sizeof(int64_t),
                "String ABI: unexpected header padding");
 _Static_assert(offsetof(zap_string_t, ptr) == 0,
                "String ABI: ptr offset mismatch");
 _Static_assert(offsetof(zap_string_t, len) == sizeof(const char *),
                "String ABI: value len offset mismatch");
 
+// Every single-byte String is one of these immortal entries, so `"" + c`,
+// string.fromChar and one-character slices or keys neither allocate nor touch
+// a refcount. Their hash is left unset because immortal headers are never
+// written; hashing one byte on demand is cheap.
+typedef struct {
+  zap_string_header_t header;
+  char data[8];
+} zap_string_small_t;
+
+#define ZAP_STRING_SMALL(c)                                                    \
+  {{ZAP_STRING_IMMORTAL_REFCOUNT, 1, ZAP_STRING_HASH_UNSET}, {(char)(c), 0}}
+#define ZAP_STRING_SMALL4(c)                                                   \
+  ZAP_STRING_SMALL(c), ZAP_STRING_SMALL((c) + 1), ZAP_STRING_SMALL((c) + 2),   \
+      ZAP_STRING_SMALL((c) + 3)
+#define ZAP_STRING_SMALL16(c)                                                  \
+  ZAP_STRING_SMALL4(c), ZAP_STRING_SMALL4((c) + 4),                            \
+      ZAP_STRING_SMALL4((c) + 8), ZAP_STRING_SMALL4((c) + 12)
+#define ZAP_STRING_SMALL64(c)                                                  \
+  ZAP_STRING_SMALL16(c), ZAP_STRING_SMALL16((c) + 16),                         \
+      ZAP_STRING_SMALL16((c) + 32), ZAP_STRING_SMALL16((c) + 48)
+
+static zap_string_small_t zap_string_small_table[256] = {
+    ZAP_STRING_SMALL64(0), ZAP_STRING_SMALL64(64), ZAP_STRING_SMALL64(128),
+    ZAP_STRING_SMALL64(192)};
+
+#undef ZAP_STRING_SMALL64
+#undef ZAP_STRING_SMALL16
+#undef ZAP_STRING_SMALL4
+#undef ZAP_STRING_SMALL
+
+static char *zap_string_small(char c) {
+  return zap_string_small_table[(unsigned char)c].data;
+}
+
 char *string_concat_ptrlen(const char *a, long a_len, const char *b,
                            long b_len) {
   if (a_len < 0 || b_len < 0 || (size_t)a_len > SIZE_MAX - (size_t)b_len) {
     return NULL;
   }
   size_t total = (size_t)a_len + (size_t)b_len;
+  if (total == 1) {
+    return zap_string_small(a_len == 1 ? a[0] : b[0]);
+  }
   char *out = zap_string_alloc_owned(total);
   if (!out)
     return NULL;
@@ -40,6 +80,41 @@ char *string_concat_ptrlen(const char *a, long a_len, const char *b,
   return out;
 }
 
+// Lowering target for chains such as `a + b + 'c' + d`: the compiler passes
+// every operand as one {ptr, len} part so the result is sized and allocated
+// once instead of once per `+`.
+char *zap_string_concat_n(const zap_string_t *parts, int64_t count) {
+  if (count < 0 || (count > 0 && !parts)) {
+    return NULL;
+  }
+  size_t total = 0;
+  for (int64_t i = 0; i < count; ++i) {
+    if (parts[i].len < 0 || (size_t)parts[i].len > SIZE_MAX - total) {
+      return NULL;
+    }
+    total += (size_t)parts[i].len;
+  }
+  if (total == 1) {
+    for (int64_t i = 0; i < count; ++i) {
+      if (parts[i].len == 1) {
+        return zap_string_small(parts[i].ptr[0]);
+      }
+    }
+  }
+  char *out = zap_string_alloc_owned(total);
+  if (!out)
+    return NULL;
+  char *cursor = out;
+  for (int64_t i = 0; i < count; ++i) {
+    if (parts[i].len > 0) {
+      memcpy(cursor, parts[i].ptr, (size_t)parts[i].len);
+      cursor += parts[i].len;
+    }
+  }
+  out[total] = '\0';
+  return out;
+}
+
 static zap_string_header_t *zap_string_header_from_ptr(const char *ptr) {
   if (!ptr) {
     return NULL;
@@ -55,6 +130,7 @@ char *zap_string_alloc_owned(size_t len) {
       sizeof(zap_string_header_t) + len + 1);
   header->refs = 1;
   header->len = (int64_t)len;
+  header->hash = ZAP_STRING_HASH_UNSET;
   char *ptr = (char *)(header + 1);
   ptr[len] = '\0';
   return ptr;
@@ -75,7 +151,7 @@ void zap_string_release_ptr(const char *ptr) {
   }
   header->refs -= 1;
   if (header->refs <= 0) {
-    free(header);
+    zap_runtime_block_free(header);
   }
 }
 
@@ -98,6 +174,9 @@ zap_string_t zap_string_from_cstr(const char *cstr) {
   if (len == 0) {
     return (zap_string_t){.ptr = NULL, .len = 0};
   }
+  if (len == 1) {
+    return (zap_string_t){.ptr = zap_string_small(cstr[0]), .len = 1};
+  }
   char *out = zap_string_alloc_owned(len);
   if (!out) {
     return (zap_string_t){.ptr = NULL, .len = 0};
@@ -113,6 +192,9 @@ zap_string_t zap_string_from_ptrlen(const char *ptr, long len) {
   if (!ptr || len <= 0) {
     return (zap_string_t){.ptr = NULL, .len = 0};
   }
+  if (len == 1) {
+    return (zap_string_t){.ptr = zap_string_small(ptr[0]), .len = 1};
+  }
 
   char *out = zap_string_alloc_owned((size_t)len);
   if (!out) {
@@ -131,6 +213,85 @@ zap_string_t zap_string_retain(zap_string_t s) {
 
 void zap_string_release(zap_string_t s) { zap_string_release_ptr(s.ptr); }
 
+// Growable buffers back std/string TextBuf. The storage is laid out as an
+// owned String from the start (header, bytes, NUL), so finishing a buffer
+// hands the bytes over as a String without copying them.
+char *zap_string_buffer_reserve(char *data, int64_t capacity) {
+  if (capacity < 0 ||
+      (uint64_t)capacity > SIZE_MAX - sizeof(zap_string_header_t) - 1) {
+    zap_runtime_out_of_memory();
+  }
+  size_t size = sizeof(zap_string_header_t) + (size_t)capacity + 1;
+  zap_string_header_t *header = zap_string_header_from_ptr(data);
+  if (!header) {
+    header = (zap_string_header_t *)zap_runtime_alloc(size);
+    header->refs = 1;
+    header->len = 0;
+    header->hash = ZAP_STRING_HASH_UNSET;
+  } else {
+    header = (zap_string_header_t *)zap_runtime_block_realloc(header, size);
+    if (!header) {
+      zap_runtime_out_of_memory();
+    }
+  }
+  return (char *)(header + 1);
+}
+
+zap_string_t zap_string_buffer_finish(char *data, int64_t len,
+                                      int64_t capacity) {
+  if (!data || len <= 0) {
+    zap_string_buffer_free(data);
+    return (zap_string_t){.ptr = NULL, .len = 0};
+  }
+
+  if (len == 1) {
+    char c = data[0];
+    zap_string_buffer_free(data);
+    return (zap_string_t){.ptr = zap_string_small(c), .len = 1};
+  }
+
+  zap_string_header_t *header = zap_string_header_from_ptr(data);
+  // Give back slack above a quarter of the capacity; shrinking realloc stays
+  // in place on common allocators, so this does not copy either.
+  if (capacity - len > capacity / 4) {
+    zap_string_header_t *shrunk =
+        (zap_string_header_t *)zap_runtime_block_realloc(
+            header, sizeof(zap_string_header_t) + (size_t)len + 1);
+    if (shrunk) {
+      header = shrunk;
+    }
+  }
+  header->refs = 1;
+  header->len = len;
+  header->hash = ZAP_STRING_HASH_UNSET;
+  char *ptr = (char *)(header + 1);
+  ptr[len] = '\0';
+  return (zap_string_t){.ptr = ptr, .len = len};
+}
+
+void zap_string_buffer_free(char *data) {
+  zap_runtime_block_free(zap_string_header_from_ptr(data));
+}
+
+uint64_t zap_string_hash(zap_string_t s) {
+  if (!s.ptr || s.len <= 0) {
+    return zap_string_hash_bytes(NULL, 0);
+  }
+
+  zap_string_header_t *header = zap_string_header_from_ptr(s.ptr);
+  if (header->hash != ZAP_STRING_HASH_UNSET) {
+    return header->hash;
+  }
+
+  uint64_t hash = zap_string_hash_bytes(s.ptr, (size_t)s.len);
+  // Immortal strings may live in read-only data; literals arrive with the
+  // hash already filled in, anything else immortal is hashed on every call.
+  if (header->refs != ZAP_STRING_IMMORTAL_REFCOUNT) {
+    header->hash = hash;
+  }
+  return hash;
+}
+
 static zap_string_t zap_string_from_format(const char *format, ...) {
   va_list args;
   va_start(args, format);
@@ -198,6 +359,9 @@ zap_string_t slice(zap_string_t s, long start, long length) {
   if (length > available) {
     length = available;
   }
+  if (length == 1) {
+    return (zap_string_t){.ptr = zap_string_small(s.ptr[start]), .len = 1};
+  }
 
   char *out = zap_string_alloc_owned((size_t)length);
   if (!out) {
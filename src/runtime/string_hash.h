@@ -0,0 +1,121 @@
+#ifndef ZAP_RUNTIME_STRING_HASH_H
+#define ZAP_RUNTIME_STRING_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// String hash shared by the runtime and the compiler, which precomputes the
+// cached hash of every string literal. It is a wyhash-style multiply-mix hash
+// that consumes 16 bytes per step (48 on long inputs) and reads bytes in
+// little-endian order, so the result is the same on every host and target.
+// Zero is reserved to mean "not computed yet" in zap_string_header_t.
+
+#define ZAP_STRING_HASH_UNSET 0
+
+#if defined(__cplusplus)
+#define ZAP_STRING_HASH_INLINE inline
+#else
+#define ZAP_STRING_HASH_INLINE static inline
+#endif
+
+#define ZAP_STRING_HASH_SECRET0 0xa0761d6478bd642fULL
+#define ZAP_STRING_HASH_SECRET1 0xe7037ed1a0b428dbULL
+#define ZAP_STRING_HASH_SECRET2 0x8ebc6af09c88c6e3ULL
+#define ZAP_STRING_HASH_SECRET3 0x589965cc75374cc3ULL
+
+// Full 64x64->128 multiply; returns the low half and stores the high half.
+ZAP_STRING_HASH_INLINE uint64_t zap_string_hash_mul128(uint64_t a, uint64_t b,
+                                                       uint64_t *high) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)a * b;
+  *high = (uint64_t)(product >> 64);
+  return (uint64_t)product;
+#else
+  uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t carry = t < rl;
+  uint64_t low = t + (rm1 << 32);
+  carry += low < t;
+  *high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+  return low;
+#endif
+}
+
+ZAP_STRING_HASH_INLINE uint64_t zap_string_hash_mix(uint64_t a, uint64_t b) {
+  uint64_t high = 0;
+  uint64_t low = zap_string_hash_mul128(a, b, &high);
+  return low ^ high;
+}
+
+ZAP_STRING_HASH_INLINE uint64_t zap_string_hash_read64(const unsigned char *p) {
+  return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+         (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+         (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+ZAP_STRING_HASH_INLINE uint64_t zap_string_hash_read32(const unsigned char *p) {
+  return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+         (uint64_t)p[3] << 24;
+}
+
+ZAP_STRING_HASH_INLINE uint64_t zap_string_hash_bytes(const void *data,
+                                                      size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+  uint64_t seed = ZAP_STRING_HASH_SECRET0 ^
+                  zap_string_hash_mix(ZAP_STRING_HASH_SECRET0,
+                                      ZAP_STRING_HASH_SECRET1);
+  uint64_t a = 0;
+  uint64_t b = 0;
+
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t mid = (len >> 3) << 2;
+      a = zap_string_hash_read32(p) << 32 | zap_string_hash_read32(p + mid);
+      b = zap_string_hash_read32(p + len - 4) << 32 |
+          zap_string_hash_read32(p + len - 4 - mid);
+    } else if (len > 0) {
+      a = (uint64_t)p[0] << 16 | (uint64_t)p[len >> 1] << 8 | p[len - 1];
+    }
+  } else {
+    size_t remaining = len;
+    if (remaining > 48) {
+      uint64_t lane1 = seed;
+      uint64_t lane2 = seed;
+      do {
+        seed = zap_string_hash_mix(
+            zap_string_hash_read64(p) ^ ZAP_STRING_HASH_SECRET1,
+            zap_string_hash_read64(p + 8) ^ seed);
+        lane1 = zap_string_hash_mix(
+            zap_string_hash_read64(p + 16) ^ ZAP_STRING_HASH_SECRET2,
+            zap_string_hash_read64(p + 24) ^ lane1);
+        lane2 = zap_string_hash_mix(
+            zap_string_hash_read64(p + 32) ^ ZAP_STRING_HASH_SECRET3,
+            zap_string_hash_read64(p + 40) ^ lane2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (remaining > 16) {
+      seed = zap_string_hash_mix(
+          zap_string_hash_read64(p) ^ ZAP_STRING_HASH_SECRET1,
+          zap_string_hash_read64(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+    a = zap_string_hash_read64(p + remaining - 16);
+    b = zap_string_hash_read64(p + remaining - 8);
+  }
+
+  a ^= ZAP_STRING_HASH_SECRET1;
+  b ^= seed;
+  a = zap_string_hash_mul128(a, b, &b);
+  uint64_t hash = zap_string_hash_mix(a ^ ZAP_STRING_HASH_SECRET0 ^ len,
+                                      b ^ ZAP_STRING_HASH_SECRET1);
+  return hash == ZAP_STRING_HASH_UNSET ? 1 : hash;
+}
+
+#undef ZAP_STRING_HASH_INLINE
+
+#endif
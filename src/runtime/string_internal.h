@@ -4,6 +4,7 @@
 #include "string_layout.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #if defined(__GNUC__) || defined(__clang__)
 #define ZAP_RUNTIME_INTERNAL __attribute__((visibility("hidden")))
@@ -14,8 +15,19 @@
 ZAP_RUNTIME_INTERNAL char *zap_string_alloc_owned(size_t len);
 ZAP_RUNTIME_INTERNAL void zap_string_release_ptr(const char *ptr);
 ZAP_RUNTIME_INTERNAL char *zap_string_to_cstr(zap_string_t s);
+char *string_concat_ptrlen(const char *a, long a_len, const char *b,
+                           long b_len);
 zap_string_t zap_string_from_cstr(const char *cstr);
 zap_string_t zap_string_from_ptrlen(const char *ptr, long len);
+zap_string_t zap_string_retain(zap_string_t s);
+void zap_string_release(zap_string_t s);
+uint64_t zap_string_hash(zap_string_t s);
+char *zap_string_concat_n(const zap_string_t *parts, int64_t count);
+char *zap_string_buffer_reserve(char *data, int64_t capacity);
+zap_string_t zap_string_buffer_finish(char *data, int64_t len,
+                                      int64_t capacity);
+void zap_string_buffer_free(char *data);
+zap_string_t zap_to_string_i64(int64_t value);
 
 #undef ZAP_RUNTIME_INTERNAL
 
@@ -3,15 +3,21 @@
 #include <stdint.h>
 
 // Shared String ABI. A non-empty owned String points immediately after this
-// header. StringView never participates in this layout.
+// header. StringView never participates in this layout. `hash` caches
+// zap_string_hash_bytes() of the contents, or ZAP_STRING_HASH_UNSET until the
+// first zap_string_hash() call; literals are emitted with it precomputed.
+// Headers with refs == ZAP_STRING_IMMORTAL_REFCOUNT (literals and the shared
+// single-byte strings in string.c) are never retained, released or written.
 #define ZAP_STRING_REFCOUNT_INDEX 0
 #define ZAP_STRING_LENGTH_INDEX 1
-#define ZAP_STRING_DATA_INDEX 2
+#define ZAP_STRING_HASH_INDEX 2
+#define ZAP_STRING_DATA_INDEX 3
 #define ZAP_STRING_IMMORTAL_REFCOUNT INT64_MIN
 
 typedef struct {
   int64_t refs;
   int64_t len;
+  uint64_t hash;
 } zap_string_header_t;
 
 typedef struct {
@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sema {
+
+/// @brief Number of an interned identifier, handed out by internAtom().
+/// Equal names get equal atoms for the lifetime of the process, so scopes
+/// compare and hash names as integers. 'NoAtom' is never handed out.
+using Atom = uint32_t;
+inline constexpr Atom NoAtom = 0;
+
+namespace detail {
+
+/// @brief Process-wide identifier table. Binders may run on several
+/// threads at once, so the table is locked; each thread also keeps the
+/// atoms it has seen in a cache of its own, tried first without locking.
+struct AtomTable {
+  std::shared_mutex mutex;
+  std::deque<std::string> names{std::string()};
+  std::unordered_map<std::string_view, Atom> atoms;
+
+  static AtomTable &instance() {
+    static AtomTable table;
+    return table;
+  }
+
+  static std::unordered_map<std::string_view, Atom> &threadCache() {
+    thread_local std::unordered_map<std::string_view, Atom> cache;
+    return cache;
+  }
+};
+
+} // namespace detail
+
+/// @brief Returns the atom of @p name, registering it on first use.
+inline Atom internAtom(std::string_view name) {
+  auto &cache = detail::AtomTable::threadCache();
+  if (auto it = cache.find(name); it != cache.end()) {
+    return it->second;
+  }
+  auto &table = detail::AtomTable::instance();
+  std::unique_lock<std::shared_mutex> lock(table.mutex);
+  auto it = table.atoms.find(name);
+  if (it == table.atoms.end()) {
+    const auto atom = static_cast<Atom>(table.names.size());
+    it = table.atoms.emplace(table.names.emplace_back(name), atom).first;
+  }
+  cache.emplace(it->first, it->second);
+  return it->second;
+}
+
+/// @brief Returns the atom of @p name, or 'NoAtom' if nothing interned it
+/// yet, in which case no table can hold it either.
+inline Atom findAtom(std::string_view name) {
+  auto &cache = detail::AtomTable::threadCache();
+  if (auto it = cache.find(name); it != cache.end()) {
+    return it->second;
+  }
+  auto &table = detail::AtomTable::instance();
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+  auto it = table.atoms.find(name);
+  if (it == table.atoms.end()) {
+    return NoAtom;
+  }
+  cache.emplace(it->first, it->second);
+  return it->second;
+}
+
+/// @brief Returns the name @p atom stands for.
+inline const std::string &atomName(Atom atom) {
+  auto &table = detail::AtomTable::instance();
+  std::shared_lock<std::shared_mutex> lock(table.mutex);
+  return atom < table.names.size() ? table.names[atom] : table.names.front();
+}
+
+/// @brief Open-addressing hash map from atoms to @p T. Entries live in one
+/// array probed linearly, and an empty map allocates nothing, which suits
+/// the many block scopes that declare a name or two.
+template <typename T> class AtomMap {
+public:
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  T *find(Atom atom) noexcept {
+    return const_cast<T *>(std::as_const(*this).find(atom));
+  }
+  const T *find(Atom atom) const noexcept {
+    if (size_ == 0 || atom == NoAtom) {
+      return nullptr;
+    }
+    for (size_t i = slot(atom);; i = (i + 1) & mask()) {
+      if (entries_[i].first == atom) {
+        return &entries_[i].second;
+      }
+      if (entries_[i].first == NoAtom) {
+        return nullptr;
+      }
+    }
+  }
+
+  /// @brief Adds @p value under @p atom unless the atom is present.
+  /// Returns the entry and whether it was added.
+  std::pair<T *, bool> tryEmplace(Atom atom, T value) {
+    if (T *existing = find(atom)) {
+      return {existing, false};
+    }
+    if ((size_ + 1) * 4 > entries_.size() * 3) {
+      rehash(entries_.empty() ? 4 : entries_.size() * 2);
+    }
+    size_t i = slot(atom);
+    while (entries_[i].first != NoAtom) {
+      i = (i + 1) & mask();
+    }
+    entries_[i] = {atom, std::move(value)};
+    ++size_;
+    return {&entries_[i].second, true};
+  }
+
+  T &operator[](Atom atom) { return *tryEmplace(atom, T()).first; }
+
+  /// @brief Adds the entries of @p other whose atoms are not present yet.
+  void insert(const AtomMap &other) {
+    other.forEach([&](Atom atom, const T &value) { tryEmplace(atom, value); });
+  }
+
+  /// @brief Calls @p visit with every atom and value, in no set order.
+  template <typename Visit> void forEach(Visit &&visit) const {
+    for (const auto &[atom, value] : entries_) {
+      if (atom != NoAtom) {
+        visit(atom, value);
+      }
+    }
+  }
+
+private:
+  size_t mask() const noexcept { return entries_.size() - 1; }
+  size_t slot(Atom atom) const noexcept {
+    return (atom * 0x9E3779B1u) & mask();
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<std::pair<Atom, T>> old(capacity);
+    old.swap(entries_);
+    size_ = 0;
+    for (auto &[atom, value] : old) {
+      if (atom != NoAtom) {
+        tryEmplace(atom, std::move(value));
+      }
+    }
+  }
+
+  std::vector<std::pair<Atom, T>> entries_;
+  size_t size_ = 0;
+};
+
+} // namespace sema
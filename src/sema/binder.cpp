@@ -341,7 +341,8 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
   hadError_ = false;
   boundRoot_ = std::make_unique<BoundRootNode>();
   modules_.clear();
-  currentScope_.reset();
+  currentScope_ = nullptr;
+  blockScopes_.clear();
   currentFunction_.reset();
   currentModuleId_.clear();
   declaredFunctionSymbols_.clear();
@@ -353,9 +354,7 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
   functionGenericParamNames_.clear();
   genericFunctionInstantiations_.clear();
   genericTypeInstantiations_.clear();
-  genericFunctionDeclarationKeys_.clear();
-  genericInstantiationEmitted_.clear();
-  genericInstantiationInProgress_.clear();
+  genericInstantiationStats_ = {};
   activeGenericBindingsStack_.clear();
   syntheticLoopCounter_ = 0;
   unsafeDepth_ = 0;
@@ -371,10 +370,10 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
     }
     ModuleState state;
     state.info = module;
-    state.scope = std::make_shared<SymbolTable>(builtinScope_);
+    state.scope = std::make_unique<SymbolTable>(builtinScope_.get());
     state.symbol =
         std::make_shared<ModuleSymbol>(module->moduleName, module->moduleId);
-    modules_[module->moduleId] = state;
+    modules_[module->moduleId] = std::move(state);
   }
 
   for (auto &[_, module] : modules_) {
@@ -414,7 +413,7 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
 
   for (auto &[_, module] : modules_) {
     currentModuleId_ = module.info->moduleId;
-    currentScope_ = module.scope;
+    currentScope_ = module.scope.get();
     for (const auto &child : module.info->root->children) {
       if (dynamic_cast<RecordDecl *>(child.get()) ||
           dynamic_cast<StructDeclarationNode *>(child.get()) ||
@@ -429,7 +428,7 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
 
   for (auto &[_, module] : modules_) {
     currentModuleId_ = module.info->moduleId;
-    currentScope_ = module.scope;
+    currentScope_ = module.scope.get();
     for (const auto &child : module.info->root->children) {
       if (dynamic_cast<ClassDecl *>(child.get())) {
         child->accept(*this);
@@ -442,7 +441,7 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
 
   for (auto &[_, module] : modules_) {
     currentModuleId_ = module.info->moduleId;
-    currentScope_ = module.scope;
+    currentScope_ = module.scope.get();
     for (const auto &child : module.info->root->children) {
       if (dynamic_cast<ImportNode *>(child.get()) ||
           dynamic_cast<RecordDecl *>(child.get()) ||
@@ -460,7 +459,7 @@ std::unique_ptr<BoundRootNode> Binder::bind(std::vector<ModuleInfo *> modules) {
 }
 
 void Binder::initializeBuiltins() {
-  builtinScope_ = std::make_shared<SymbolTable>();
+  builtinScope_ = std::make_unique<SymbolTable>();
 
   auto declareType = [&](const std::string &name, zir::TypeKind kind) {
     builtinScope_->declare(name,
@@ -495,16 +494,18 @@ void Binder::initializeBuiltins() {
 
 std::string Binder::mangleName(const std::string &modulePath,
                                const std::string &name) const {
+  static constexpr char hexDigits[] = "0123456789ABCDEF";
   std::string mangled = "zap$";
+  mangled.reserve(mangled.size() + modulePath.size() + name.size() + 16);
   auto appendEscaped = [&](char c) {
     unsigned char uc = static_cast<unsigned char>(c);
     if (std::isalnum(uc)) {
       mangled += c;
       return;
     }
-    char buf[8];
-    std::snprintf(buf, sizeof(buf), "_%02X", static_cast<unsigned int>(uc));
-    mangled += buf;
+    mangled += '_';
+    mangled += hexDigits[uc >> 4U];
+    mangled += hexDigits[uc & 0x0FU];
   };
   for (char c : modulePath) {
     appendEscaped(c);
@@ -523,7 +524,7 @@ std::string Binder::functionSignatureKey(const FunctionSymbol &function) const {
   for (const auto &param : function.parameters) {
     key += param->is_ref ? "r1_" : "r0_";
     key += param->is_variadic_pack ? "v1_" : "v0_";
-    key += zir::typeMangleKey(param->type);
+    key += typeInterner_.mangleKey(param->type);
   }
   key += function.isCVariadic ? "c1" : "c0";
   return key;
@@ -701,7 +702,7 @@ Binder::addClassMethodOverload(ClassInfo &classInfo,
     return nullptr;
   }
 
-  auto &entry = classInfo.methods[method->name];
+  auto &entry = classInfo.methods[internAtom(method->name)];
   auto overloads = std::dynamic_pointer_cast<OverloadSetSymbol>(entry);
   auto updated = std::make_shared<OverloadSetSymbol>(
       method->name, method->moduleName, method->visibility);
@@ -724,12 +725,12 @@ Binder::addClassMethodOverload(ClassInfo &classInfo,
 
 int Binder::findOverriddenVtableSlot(const ClassInfo &classInfo,
                                      const FunctionSymbol &method) const {
-  auto existingIt = classInfo.methods.find(method.name);
-  if (existingIt == classInfo.methods.end()) {
+  const auto *existing = classInfo.methods.find(findAtom(method.name));
+  if (!existing) {
     return -1;
   }
 
-  for (const auto &candidate : collectOverloads(existingIt->second)) {
+  for (const auto &candidate : collectOverloads(*existing)) {
     if (candidate && candidate->vtableSlot >= 0 &&
         sameMethodDispatchSignature(*candidate, method)) {
       return candidate->vtableSlot;
@@ -918,12 +919,20 @@ std::string Binder::makeSyntheticLoopName(std::string_view prefix) {
 }
 
 void Binder::pushScope() {
-  currentScope_ = std::make_shared<SymbolTable>(currentScope_);
+  blockScopes_.push_back(std::make_unique<SymbolTable>(currentScope_));
+  currentScope_ = blockScopes_.back().get();
 }
 
 void Binder::popScope() {
-  if (currentScope_) {
-    currentScope_ = currentScope_->getParent();
+  if (!currentScope_) {
+    return;
+  }
+  auto *scope = currentScope_;
+  currentScope_ = scope->getParent();
+  // Below a scope left open by an early return, scopes are not innermost
+  // on the stack when popped; those are freed when binding ends.
+  if (!blockScopes_.empty() && blockScopes_.back().get() == scope) {
+    blockScopes_.pop_back();
   }
 }
 
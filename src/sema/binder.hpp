@@ -61,6 +61,14 @@ deriveValueExpressionFromBlock(const BoundBlock &block);
 std::unique_ptr<BoundExpression>
 deriveValueExpressionFromIf(const BoundIfStatement &stmt);
 
+/// @brief How often a generic function or type was asked for with type
+/// arguments it had been instantiated with before ('hits'), and how many
+/// instantiations were built and bound ('misses').
+struct GenericInstantiationStats {
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
 class Binder : public Visitor {
 public:
   Binder(zap::DiagnosticEngine &diag, bool allowUnsafe = true,
@@ -68,6 +76,9 @@ public:
   std::unique_ptr<BoundRootNode> bind(RootNode &root);
   std::unique_ptr<BoundRootNode> bind(std::vector<ModuleInfo> &modules);
   std::unique_ptr<BoundRootNode> bind(std::vector<ModuleInfo *> modules);
+  const GenericInstantiationStats &genericInstantiationStats() const {
+    return genericInstantiationStats_;
+  }
 
   void visit(RootNode &node) override;
   void visit(ImportNode &node) override;
@@ -124,8 +135,11 @@ private:
   zap::DiagnosticEngine &_diag;
   SemanticInfo *semanticInfo_ = nullptr;
   TargetInfo targetInfo_;
-  std::shared_ptr<SymbolTable> currentScope_;
-  std::shared_ptr<SymbolTable> builtinScope_;
+  SymbolTable *currentScope_ = nullptr;
+  std::unique_ptr<SymbolTable> builtinScope_;
+  /// @brief Scopes opened by pushScope(), innermost last. Scopes only point
+  /// at their parents, so this stack owns them until popScope().
+  std::vector<std::unique_ptr<SymbolTable>> blockScopes_;
   std::unique_ptr<BoundRootNode> boundRoot_;
 
   std::stack<std::unique_ptr<BoundExpression>> expressionStack_;
@@ -153,7 +167,7 @@ private:
 
   struct ModuleState {
     ModuleInfo *info = nullptr;
-    std::shared_ptr<SymbolTable> scope;
+    std::unique_ptr<SymbolTable> scope;
     std::shared_ptr<ModuleSymbol> symbol;
     bool valuesPredeclared = false;
     bool finalImportsApplied = false;
@@ -175,23 +189,41 @@ private:
       functionDeclarationModuleIds_;
   std::unordered_map<const FunctionSymbol *, std::vector<std::string>>
       functionGenericParamNames_;
-  std::unordered_map<std::string, std::shared_ptr<FunctionSymbol>>
+  /// @brief A generic declaration and its type arguments, in declaration
+  /// order, as identities interned by 'typeInterner_'. Equal arguments
+  /// intern to the same identity, so keys compare and hash by address.
+  struct GenericInstantiationKey {
+    const Symbol *declaration = nullptr;
+    std::vector<const zir::TypeId *> arguments;
+
+    bool operator==(const GenericInstantiationKey &other) const {
+      return declaration == other.declaration && arguments == other.arguments;
+    }
+  };
+  struct GenericInstantiationKeyHash {
+    size_t operator()(const GenericInstantiationKey &key) const noexcept;
+  };
+  GenericInstantiationKey genericInstantiationKey(
+      const Symbol &declaration,
+      const std::vector<std::shared_ptr<zir::Type>> &arguments) const;
+  // An instantiation is cached before its body is bound, so recursive uses
+  // find it and every instantiated body is bound once.
+  std::unordered_map<GenericInstantiationKey, std::shared_ptr<FunctionSymbol>,
+                     GenericInstantiationKeyHash>
       genericFunctionInstantiations_;
-  std::unordered_map<std::string, std::shared_ptr<TypeSymbol>>
+  std::unordered_map<GenericInstantiationKey, std::shared_ptr<TypeSymbol>,
+                     GenericInstantiationKeyHash>
       genericTypeInstantiations_;
-  std::unordered_map<const FunctionSymbol *, std::string>
-      genericFunctionDeclarationKeys_;
-  std::unordered_map<const FunctionSymbol *, bool> genericInstantiationEmitted_;
+  GenericInstantiationStats genericInstantiationStats_;
   std::vector<std::unordered_map<std::string, std::shared_ptr<zir::Type>>>
       activeGenericBindingsStack_;
-  std::vector<std::string> genericInstantiationInProgress_;
   struct ClassInfo {
     std::shared_ptr<TypeSymbol> typeSymbol;
     std::shared_ptr<zir::ClassType> classType;
     std::shared_ptr<FunctionSymbol> constructor;
     std::shared_ptr<FunctionSymbol> destructor;
-    std::map<std::string, std::shared_ptr<VariableSymbol>> fields;
-    std::map<std::string, std::shared_ptr<Symbol>> methods;
+    AtomMap<std::shared_ptr<VariableSymbol>> fields;
+    AtomMap<std::shared_ptr<Symbol>> methods;
     int nextVirtualSlot = 0;
     std::string ownerQualifiedName;
   };
@@ -271,6 +303,15 @@ private:
       std::shared_ptr<zir::Type> type,
       const std::unordered_map<std::string, std::shared_ptr<zir::Type>>
           &genericBindings) const;
+  /// @brief Generic instances substituted so far, by their original, so
+  /// that instances reached again through their own fields are shared.
+  using GenericSubstitutions =
+      std::unordered_map<const zir::Type *, std::shared_ptr<zir::Type>>;
+  std::shared_ptr<zir::Type> substituteGenericType(
+      std::shared_ptr<zir::Type> type,
+      const std::unordered_map<std::string, std::shared_ptr<zir::Type>>
+          &genericBindings,
+      GenericSubstitutions &substituted) const;
   bool validateGenericConstraints(
       const std::vector<GenericConstraint> &constraints,
       std::unordered_map<std::string, std::shared_ptr<zir::Type>> &bindings,
@@ -119,13 +119,14 @@ void Binder::visit(FunCall &node) {
         error(node.span, "Unknown class type: " + classType->getName());
         return;
       }
-      auto methodIt = infoIt->second.methods.find(member->member_);
-      if (methodIt == infoIt->second.methods.end()) {
+      const auto *method =
+          infoIt->second.methods.find(findAtom(member->member_));
+      if (!method) {
         error(node.span, "Class '" + classType->getName() +
                              "' has no method '" + member->member_ + "'.");
         return;
       }
-      auto candidates = collectOverloads(methodIt->second);
+      auto candidates = collectOverloads(*method);
       if (candidates.empty()) {
         error(node.span, "'" + member->member_ + "' is not a method.");
         return;
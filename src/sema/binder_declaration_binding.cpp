@@ -60,8 +60,7 @@ void Binder::visit(ClassDecl &node) {
           classInfo.destructor = baseIt->second.destructor;
         }
         classInfo.fields = baseIt->second.fields;
-        classInfo.methods.insert(baseIt->second.methods.begin(),
-                                 baseIt->second.methods.end());
+        classInfo.methods.insert(baseIt->second.methods);
         for (const auto &field : baseClass->getFields()) {
           classType->addField(field.name, field.type, field.visibility);
         }
@@ -77,7 +76,7 @@ void Binder::visit(ClassDecl &node) {
     }
     classType->addField(field->name, fieldType,
                         static_cast<int>(field->visibility_));
-    classInfo.fields[field->name] = std::make_shared<VariableSymbol>(
+    classInfo.fields[internAtom(field->name)] = std::make_shared<VariableSymbol>(
         field->name, fieldType, BindingKind::Mutable, false, field->name,
         modules_[currentModuleId_].info->moduleName, field->visibility_);
   }
@@ -373,6 +372,9 @@ void Binder::visit(BindingDecl &node) {
                 "' must be initialized with a compile-time expression: " +
                 failureReason + ".");
     } else {
+      // Symbols outlive the bound tree's arena, so their copy lives on the
+      // heap.
+      zap::ArenaScope heap(nullptr);
       symbol->constant_value =
           std::shared_ptr<BoundExpression>(initializer->clone());
     }
@@ -815,9 +815,9 @@ void Binder::visit(MemberAccessNode &node) {
       }
       auto infoIt = classInfos_.find(classType->getCodegenName());
       if (infoIt != classInfos_.end()) {
-        auto fieldIt = infoIt->second.fields.find(node.member_);
-        if (fieldIt != infoIt->second.fields.end()) {
-          auto fieldVis = fieldIt->second->visibility;
+        const auto *field = infoIt->second.fields.find(findAtom(node.member_));
+        if (field) {
+          auto fieldVis = (*field)->visibility;
           bool allowed = fieldVis == Visibility::Public ||
                          (!currentClassStack_.empty() &&
                           currentClassStack_.back() == classType->getName()) ||
@@ -828,7 +828,7 @@ void Binder::visit(MemberAccessNode &node) {
             return;
           }
           expressionStack_.push(std::make_unique<BoundMemberAccess>(
-              std::move(left), node.member_, fieldIt->second->type));
+              std::move(left), node.member_, (*field)->type));
           return;
         }
       }
@@ -841,9 +841,9 @@ void Binder::visit(MemberAccessNode &node) {
     }
     auto infoIt = classInfos_.find(classType->getCodegenName());
     if (infoIt != classInfos_.end()) {
-      auto fieldIt = infoIt->second.fields.find(node.member_);
-      if (fieldIt != infoIt->second.fields.end()) {
-        auto fieldVis = fieldIt->second->visibility;
+      const auto *field = infoIt->second.fields.find(findAtom(node.member_));
+      if (field) {
+        auto fieldVis = (*field)->visibility;
         bool allowed =
             fieldVis == Visibility::Public ||
             (!currentClassStack_.empty() &&
@@ -854,7 +854,7 @@ void Binder::visit(MemberAccessNode &node) {
           return;
         }
         expressionStack_.push(std::make_unique<BoundMemberAccess>(
-            std::move(left), node.member_, fieldIt->second->type));
+            std::move(left), node.member_, (*field)->type));
         return;
       }
     }
@@ -894,10 +894,10 @@ void Binder::visit(NewExpr &node) {
   }
 
   auto ctor = infoIt->second.constructor;
-  auto ctorIt = infoIt->second.methods.find("init");
-  auto ctorCandidates = ctorIt == infoIt->second.methods.end()
-                            ? std::vector<std::shared_ptr<FunctionSymbol>>{}
-                            : collectOverloads(ctorIt->second);
+  const auto *ctorMethods = infoIt->second.methods.find(findAtom("init"));
+  auto ctorCandidates = ctorMethods
+                            ? collectOverloads(*ctorMethods)
+                            : std::vector<std::shared_ptr<FunctionSymbol>>{};
   if (ctorCandidates.empty() && ctor) {
     ctorCandidates.push_back(ctor);
   }
@@ -29,12 +29,16 @@ std::shared_ptr<FunctionSymbol> Binder::ensureGenericFunctionInstantiation(
   }
 
   std::vector<std::string> missing;
+  std::vector<std::shared_ptr<zir::Type>> arguments;
+  arguments.reserve(baseFunction->genericParameterNames.size());
   for (const auto &name : baseFunction->genericParameterNames) {
     auto it =
         std::find_if(genericBindings.begin(), genericBindings.end(),
                      [&](const auto &entry) { return entry.first == name; });
     if (it == genericBindings.end()) {
       missing.push_back(name);
+    } else {
+      arguments.push_back(it->second);
     }
   }
   if (!missing.empty()) {
@@ -52,31 +56,10 @@ std::shared_ptr<FunctionSymbol> Binder::ensureGenericFunctionInstantiation(
     return nullptr;
   }
 
-  std::string cacheKey;
-  {
-    size_t estimatedSize = baseFunction->linkName.size() + 2 +
-                           baseFunction->genericParameterNames.size() * 16;
-    cacheKey.reserve(estimatedSize);
-    cacheKey += baseFunction->linkName;
-    cacheKey += '<';
-    for (size_t i = 0; i < baseFunction->genericParameterNames.size(); ++i) {
-      if (i != 0)
-        cacheKey += ',';
-      const auto &name = baseFunction->genericParameterNames[i];
-      auto it =
-          std::find_if(genericBindings.begin(), genericBindings.end(),
-                       [&](const auto &entry) { return entry.first == name; });
-      cacheKey += name;
-      cacheKey += '=';
-      cacheKey += (it != genericBindings.end() && it->second)
-                      ? typeInterner_.mangleKey(it->second)
-                      : "missing";
-    }
-    cacheKey += '>';
-  }
-
+  auto cacheKey = genericInstantiationKey(*baseFunction, arguments);
   auto cachedIt = genericFunctionInstantiations_.find(cacheKey);
   if (cachedIt != genericFunctionInstantiations_.end()) {
+    ++genericInstantiationStats_.hits;
     return cachedIt->second;
   }
 
@@ -150,44 +133,28 @@ std::shared_ptr<FunctionSymbol> Binder::ensureGenericFunctionInstantiation(
       genericSuffix += "$";
     }
     const auto &name = baseFunction->genericParameterNames[i];
-    auto it =
-        std::find_if(genericBindings.begin(), genericBindings.end(),
-                     [&](const auto &entry) { return entry.first == name; });
-    if (it == genericBindings.end() || !it->second) {
+    if (!arguments[i]) {
       error(callSpan, "Missing binding for generic parameter '" + name + "'.");
       return nullptr;
     }
     genericSuffix +=
-        sanitizeTypeName(name) + "_" + typeInterner_.mangleKey(it->second);
+        sanitizeTypeName(name) + "_" + typeInterner_.mangleKey(arguments[i]);
   }
   instantiated->linkName = baseFunction->linkName + "$g$" + genericSuffix;
 
-  genericFunctionInstantiations_[cacheKey] = instantiated;
+  genericFunctionInstantiations_.emplace(std::move(cacheKey), instantiated);
+  ++genericInstantiationStats_.misses;
   functionGenericParamNames_[instantiated.get()] = {};
   functionDeclarationNodes_[instantiated.get()] = declIt->second;
   functionDeclarationModuleIds_[instantiated.get()] = moduleId;
 
-  auto inProgressIt =
-      std::find(genericInstantiationInProgress_.begin(),
-                genericInstantiationInProgress_.end(), cacheKey);
-  if (inProgressIt != genericInstantiationInProgress_.end()) {
-    return instantiated;
-  }
-
-  auto emittedIt = genericInstantiationEmitted_.find(instantiated.get());
-  if (emittedIt != genericInstantiationEmitted_.end() && emittedIt->second) {
-    return instantiated;
-  }
-
-  genericInstantiationInProgress_.push_back(cacheKey);
-
   auto oldScope = currentScope_;
   auto oldFunction = currentFunction_;
   auto oldModuleId = currentModuleId_;
   int oldUnsafeDepth = unsafeDepth_;
 
   currentModuleId_ = moduleIt->second.info->moduleId;
-  currentScope_ = moduleIt->second.scope;
+  currentScope_ = moduleIt->second.scope.get();
   currentFunction_ = instantiated;
   if (instantiated->isUnsafe) {
     ++unsafeDepth_;
@@ -249,12 +216,31 @@ std::shared_ptr<FunctionSymbol> Binder::ensureGenericFunctionInstantiation(
 
   boundRoot_->functions.push_back(std::make_unique<BoundFunctionDeclaration>(
       instantiated, std::move(boundBody)));
-  genericInstantiationEmitted_[instantiated.get()] = true;
-
-  genericInstantiationInProgress_.pop_back();
   return instantiated;
 }
 
+Binder::GenericInstantiationKey Binder::genericInstantiationKey(
+    const Symbol &declaration,
+    const std::vector<std::shared_ptr<zir::Type>> &arguments) const {
+  GenericInstantiationKey key{&declaration, {}};
+  key.arguments.reserve(arguments.size());
+  for (const auto &argument : arguments) {
+    key.arguments.push_back(argument ? &typeInterner_.intern(argument)
+                                     : nullptr);
+  }
+  return key;
+}
+
+size_t Binder::GenericInstantiationKeyHash::operator()(
+    const GenericInstantiationKey &key) const noexcept {
+  size_t result = std::hash<const Symbol *>{}(key.declaration);
+  for (const auto *argument : key.arguments) {
+    result ^= std::hash<const zir::TypeId *>{}(argument) + 0x9e3779b9U +
+              (result << 6U) + (result >> 2U);
+  }
+  return result;
+}
+
 bool Binder::isGenericTypeParameterName(std::string_view name) const {
   if (activeGenericBindingsStack_.empty()) {
     return false;
@@ -267,9 +253,21 @@ std::shared_ptr<zir::Type> Binder::substituteGenericType(
     std::shared_ptr<zir::Type> type,
     const std::unordered_map<std::string, std::shared_ptr<zir::Type>>
         &genericBindings) const {
+  GenericSubstitutions substituted;
+  return substituteGenericType(std::move(type), genericBindings, substituted);
+}
+
+std::shared_ptr<zir::Type> Binder::substituteGenericType(
+    std::shared_ptr<zir::Type> type,
+    const std::unordered_map<std::string, std::shared_ptr<zir::Type>>
+        &genericBindings,
+    GenericSubstitutions &substituted) const {
   if (!type) {
     return nullptr;
   }
+  if (auto it = substituted.find(type.get()); it != substituted.end()) {
+    return it->second;
+  }
 
   if (type->getKind() == zir::TypeKind::Record) {
     auto record = std::static_pointer_cast<zir::RecordType>(type);
@@ -283,8 +281,8 @@ std::shared_ptr<zir::Type> Binder::substituteGenericType(
           fields[0].type->getKind() == zir::TypeKind::Pointer) {
         auto dataPtr =
             std::static_pointer_cast<zir::PointerType>(fields[0].type);
-        return makeVariadicViewType(
-            substituteGenericType(dataPtr->getBaseType(), genericBindings));
+        return makeVariadicViewType(substituteGenericType(
+            dataPtr->getBaseType(), genericBindings, substituted));
       }
       return type;
     }
@@ -292,22 +290,26 @@ std::shared_ptr<zir::Type> Binder::substituteGenericType(
       std::vector<std::shared_ptr<zir::Type>> substitutedArgs;
       substitutedArgs.reserve(record->getGenericArguments().size());
       for (const auto &arg : record->getGenericArguments()) {
-        substitutedArgs.push_back(substituteGenericType(arg, genericBindings));
+        substitutedArgs.push_back(
+            substituteGenericType(arg, genericBindings, substituted));
       }
 
-      auto substituted = std::make_shared<zir::RecordType>(
+      auto instance = std::make_shared<zir::RecordType>(
           renderGenericTypeName(record->getGenericBaseName(), substitutedArgs),
           renderGenericCodegenName(record->getGenericCodegenBaseName(),
                                    substitutedArgs));
-      substituted->setGenericInstance(record->getGenericBaseName(),
-                                      record->getGenericCodegenBaseName(),
-                                      substitutedArgs);
+      instance->setGenericInstance(record->getGenericBaseName(),
+                                   record->getGenericCodegenBaseName(),
+                                   substitutedArgs);
+      substituted.emplace(type.get(), instance);
+      boundRoot_->substitutedGenericTypes.push_back(instance);
       for (const auto &field : record->getFields()) {
-        substituted->addField(
-            field.name, substituteGenericType(field.type, genericBindings),
+        instance->addField(
+            field.name,
+            substituteGenericType(field.type, genericBindings, substituted),
             field.visibility);
       }
-      return substituted;
+      return instance;
     }
 
     return type;
@@ -323,45 +325,52 @@ std::shared_ptr<zir::Type> Binder::substituteGenericType(
       std::vector<std::shared_ptr<zir::Type>> substitutedArgs;
       substitutedArgs.reserve(classType->getGenericArguments().size());
       for (const auto &arg : classType->getGenericArguments()) {
-        substitutedArgs.push_back(substituteGenericType(arg, genericBindings));
+        substitutedArgs.push_back(
+            substituteGenericType(arg, genericBindings, substituted));
       }
 
-      auto substituted = std::make_shared<zir::ClassType>(
+      auto instance = std::make_shared<zir::ClassType>(
           renderGenericTypeName(classType->getGenericBaseName(),
                                 substitutedArgs),
           renderGenericCodegenName(classType->getGenericCodegenBaseName(),
                                    substitutedArgs));
-      substituted->setGenericInstance(classType->getGenericBaseName(),
-                                      classType->getGenericCodegenBaseName(),
-                                      substitutedArgs);
-      substituted->setWeak(classType->isWeak());
+      instance->setGenericInstance(classType->getGenericBaseName(),
+                                   classType->getGenericCodegenBaseName(),
+                                   substitutedArgs);
+      instance->setWeak(classType->isWeak());
+      substituted.emplace(type.get(), instance);
+      boundRoot_->substitutedGenericTypes.push_back(instance);
       if (auto base = classType->getBase()) {
-        auto substitutedBase = substituteGenericType(base, genericBindings);
+        auto substitutedBase =
+            substituteGenericType(base, genericBindings, substituted);
         if (substitutedBase &&
             substitutedBase->getKind() == zir::TypeKind::Class) {
-          substituted->setBase(
+          instance->setBase(
               std::static_pointer_cast<zir::ClassType>(substitutedBase));
         }
       }
       for (const auto &field : classType->getFields()) {
-        substituted->addField(
-            field.name, substituteGenericType(field.type, genericBindings),
+        instance->addField(
+            field.name,
+            substituteGenericType(field.type, genericBindings, substituted),
             field.visibility);
       }
-      return substituted;
+      return instance;
     }
     return type;
   }
 
   if (type->getKind() == zir::TypeKind::Pointer) {
     auto ptr = std::static_pointer_cast<zir::PointerType>(type);
-    auto base = substituteGenericType(ptr->getBaseType(), genericBindings);
+    auto base =
+        substituteGenericType(ptr->getBaseType(), genericBindings, substituted);
     return std::make_shared<zir::PointerType>(base);
   }
 
   if (type->getKind() == zir::TypeKind::Array) {
     auto arr = std::static_pointer_cast<zir::ArrayType>(type);
-    auto base = substituteGenericType(arr->getBaseType(), genericBindings);
+    auto base =
+        substituteGenericType(arr->getBaseType(), genericBindings, substituted);
     return std::make_shared<zir::ArrayType>(base, arr->getSize());
   }
 
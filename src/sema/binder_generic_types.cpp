@@ -21,7 +21,6 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
     return baseSymbol;
   }
 
-  std::string cacheKey = baseSymbol->linkName + "<";
   std::shared_ptr<zir::RecordType> instantiatedType;
   const RecordDecl *recordDecl = nullptr;
   const StructDeclarationNode *structDecl = nullptr;
@@ -101,6 +100,15 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
     genericBindings[baseSymbol->genericParameterNames[i]] = mapped;
   }
 
+  // Constraints only depend on the arguments, so a cached instantiation
+  // has already passed them.
+  auto cacheKey = genericInstantiationKey(*baseSymbol, genericArgs);
+  auto cachedIt = genericTypeInstantiations_.find(cacheKey);
+  if (cachedIt != genericTypeInstantiations_.end()) {
+    ++genericInstantiationStats_.hits;
+    return cachedIt->second;
+  }
+
   std::string constraintFailure;
   if (declGenericConstraints &&
       !validateGenericConstraints(*declGenericConstraints, genericBindings,
@@ -111,20 +119,6 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
     return nullptr;
   }
 
-  for (size_t i = 0; i < genericArgs.size(); ++i) {
-    if (i != 0) {
-      cacheKey += ",";
-    }
-    cacheKey +=
-        genericArgs[i] ? typeInterner_.mangleKey(genericArgs[i]) : "missing";
-  }
-  cacheKey += ">";
-
-  auto cachedIt = genericTypeInstantiations_.find(cacheKey);
-  if (cachedIt != genericTypeInstantiations_.end()) {
-    return cachedIt->second;
-  }
-
   auto moduleIdIt = typeDeclarationModuleIds_.find(baseSymbol.get());
   if (moduleIdIt == typeDeclarationModuleIds_.end()) {
     error(typeNode.span,
@@ -168,7 +162,8 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
   instantiatedSymbol->isPacked = baseSymbol->isPacked;
   instantiatedSymbol->genericArguments = {genericBindings.begin(),
                                           genericBindings.end()};
-  genericTypeInstantiations_[cacheKey] = instantiatedSymbol;
+  genericTypeInstantiations_.emplace(std::move(cacheKey), instantiatedSymbol);
+  ++genericInstantiationStats_.misses;
   boundRoot_->genericTypes.push_back(instantiatedType);
 
   if (classDecl) {
@@ -192,7 +187,7 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
     ++externTypeContextDepth_;
   }
 
-  currentScope_ = moduleIt->second.scope;
+  currentScope_ = moduleIt->second.scope.get();
   currentModuleId_ = moduleIt->second.info->moduleId;
 
   activeGenericBindingsStack_.push_back(genericBindings);
@@ -219,8 +214,7 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
           classInfo.destructor = baseIt->second.destructor;
         }
         classInfo.fields = baseIt->second.fields;
-        classInfo.methods.insert(baseIt->second.methods.begin(),
-                                 baseIt->second.methods.end());
+        classInfo.methods.insert(baseIt->second.methods);
         classInfo.nextVirtualSlot = baseIt->second.nextVirtualSlot;
       }
       for (const auto &field : baseClass->getFields()) {
@@ -248,7 +242,7 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
       auto instantiatedClassType =
           std::static_pointer_cast<zir::ClassType>(instantiatedType);
       auto &classInfo = classInfos_[instantiatedClassType->getCodegenName()];
-      classInfo.fields[field->name] = std::make_shared<VariableSymbol>(
+      classInfo.fields[internAtom(field->name)] = std::make_shared<VariableSymbol>(
           field->name, fieldType, BindingKind::Mutable, false, field->name,
           moduleIt->second.info->moduleName, field->visibility_);
     }
@@ -267,7 +261,7 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
     auto &classInfo = classInfos_[instantiatedClassType->getCodegenName()];
     auto oldScope = currentScope_;
     auto oldModuleId = currentModuleId_;
-    currentScope_ = moduleIt->second.scope;
+    currentScope_ = moduleIt->second.scope.get();
     currentModuleId_ = moduleIt->second.info->moduleId;
 
     for (const auto &methodDecl : classDecl->methods_) {
@@ -426,7 +420,7 @@ std::shared_ptr<TypeSymbol> Binder::instantiateGenericTypeSymbol(
       int oldUnsafeDepth = unsafeDepth_;
 
       currentModuleId_ = moduleIt->second.info->moduleId;
-      currentScope_ = moduleIt->second.scope;
+      currentScope_ = moduleIt->second.scope.get();
       currentFunction_ = methodSymbol;
       currentClassStack_.push_back(instantiatedClassType->getName());
       if (methodSymbol->isUnsafe) {
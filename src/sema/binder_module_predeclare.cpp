@@ -17,7 +17,7 @@ namespace sema {
 
 void Binder::predeclareModuleTypes(ModuleState &module) {
   currentModuleId_ = module.info->moduleId;
-  currentScope_ = module.scope;
+  currentScope_ = module.scope.get();
   std::vector<std::pair<EnumDecl *, std::shared_ptr<TypeSymbol>>>
       pendingPayloadEnums;
 
@@ -278,7 +278,7 @@ void Binder::predeclareModuleTypes(ModuleState &module) {
 
 void Binder::predeclareModuleAliases(ModuleState &module) {
   currentModuleId_ = module.info->moduleId;
-  currentScope_ = module.scope;
+  currentScope_ = module.scope.get();
 
   for (const auto &child : module.info->root->children) {
     if (auto aliasDecl = dynamic_cast<TypeAliasDecl *>(child.get())) {
@@ -460,7 +460,7 @@ void Binder::ensureModuleValuesReady(ModuleState &module) {
 
 void Binder::predeclareModuleValues(ModuleState &module) {
   currentModuleId_ = module.info->moduleId;
-  currentScope_ = module.scope;
+  currentScope_ = module.scope.get();
 
   for (const auto &child : module.info->root->children) {
     if (auto funDecl = dynamic_cast<FunDecl *>(child.get())) {
@@ -663,8 +663,7 @@ void Binder::predeclareModuleValues(ModuleState &module) {
             if (!hasOwnDtor) {
               classInfo.destructor = baseIt->second.destructor;
             }
-            classInfo.methods.insert(baseIt->second.methods.begin(),
-                                     baseIt->second.methods.end());
+            classInfo.methods.insert(baseIt->second.methods);
             classInfo.nextVirtualSlot = baseIt->second.nextVirtualSlot;
           }
         }
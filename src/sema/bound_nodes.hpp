@@ -1,5 +1,6 @@
 #pragma once
 #include "../ir/type.hpp"
+#include "../utils/arena.hpp"
 #include "symbol.hpp"
 #include <memory>
 #include <string>
@@ -100,6 +101,14 @@ class BoundNode {
 public:
   virtual ~BoundNode() = default;
   virtual void accept(BoundVisitor &v) = 0;
+
+  /// @brief Nodes come from the current 'zap::ArenaScope', or the heap.
+  static void *operator new(size_t size) {
+    return zap::detail::allocateNode(size);
+  }
+  static void operator delete(void *node, size_t size) noexcept {
+    zap::detail::releaseNode(node, size);
+  }
 };
 
 class BoundExpression : public BoundNode {
@@ -760,6 +769,9 @@ public:
     for (const auto &type : genericTypes) {
       type->clearFields();
     }
+    for (const auto &type : substitutedGenericTypes) {
+      type->clearFields();
+    }
   }
 
   std::vector<std::unique_ptr<BoundRecordDeclaration>> records;
@@ -774,6 +786,9 @@ public:
   // alive for semantic analysis and codegen, then release their field graph
   // when this compilation unit is discarded.
   std::vector<std::shared_ptr<zir::RecordType>> genericTypes;
+  // Copies of generic instances made while substituting a generic function's
+  // signature, released the same way. They are not declarations of their own.
+  std::vector<std::shared_ptr<zir::RecordType>> substitutedGenericTypes;
   void accept(BoundVisitor &v) override { v.visit(*this); }
 };
 
@@ -162,8 +162,8 @@ std::string_view Conversion::description() const {
 
 size_t ConversionClassifier::TypePairHash::operator()(
     const TypePair &pair) const noexcept {
-  size_t result = zir::TypeIdHash{}(pair.source);
-  result ^= zir::TypeIdHash{}(pair.target) + 0x9e3779b9U +
+  size_t result = std::hash<const zir::TypeId *>{}(pair.source);
+  result ^= std::hash<const zir::TypeId *>{}(pair.target) + 0x9e3779b9U +
             (result << 6U) + (result >> 2U);
   return result;
 }
@@ -200,7 +200,7 @@ std::optional<Conversion> ConversionClassifier::classifyImplicit(
   if (!source || !target) {
     return std::nullopt;
   }
-  const TypePair key{types_.intern(source), types_.intern(target)};
+  const TypePair key{&types_.intern(source), &types_.intern(target)};
   if (auto cached = implicitCache_.find(key); cached != implicitCache_.end()) {
     auto result = cached->second;
     if (result) {
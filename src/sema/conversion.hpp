@@ -91,9 +91,10 @@ public:
   void clear() const { implicitCache_.clear(); }
 
 private:
+  // Identities interned by 'types_', compared by address.
   struct TypePair {
-    zir::TypeId source;
-    zir::TypeId target;
+    const zir::TypeId *source;
+    const zir::TypeId *target;
 
     bool operator==(const TypePair &other) const {
       return source == other.source && target == other.target;
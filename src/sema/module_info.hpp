@@ -2,6 +2,7 @@
 
 #include "../ast/root_node.hpp"
 #include "../token/token.hpp"
+#include "../utils/arena.hpp"
 #include "../visibility.hpp"
 #include <memory>
 #include <string>
@@ -30,6 +31,7 @@ struct ModuleInfo {
   std::string sourceName;
   std::string sourceText;
   bool isEntry = false;
+  zap::ArenaRef arena; ///< Where the nodes of 'root' were allocated.
   std::unique_ptr<RootNode> root;
   std::vector<ResolvedImport> imports;
 };
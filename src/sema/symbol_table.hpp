@@ -1,41 +1,43 @@
 #pragma once
+#include "atom.hpp"
 #include "symbol.hpp"
-#include <map>
 #include <memory>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace sema {
 
+/// @brief One scope of names. Names are interned as atoms and kept in a
+/// flat hash map; the parent is not owned, so it has to outlive this
+/// scope: module scopes and the builtin scope live as long as the binder,
+/// block scopes are popped before their parents.
 class SymbolTable {
 public:
-  SymbolTable(std::shared_ptr<SymbolTable> parent = nullptr)
-      : parent_(std::move(parent)) {}
+  explicit SymbolTable(SymbolTable *parent = nullptr) noexcept
+      : parent_(parent) {}
 
-  bool declare(const std::string &name, std::shared_ptr<Symbol> symbol) {
-    if (symbols_.find(name) != symbols_.end()) {
-      return false; // Already declared in this scope
-    }
-    symbols_[name] = std::move(symbol);
-    return true;
+  bool declare(std::string_view name, std::shared_ptr<Symbol> symbol) {
+    // False if the name is already declared in this scope.
+    return symbols_.tryEmplace(internAtom(name), std::move(symbol)).second;
   }
 
   std::shared_ptr<OverloadSetSymbol>
   declareFunction(const std::string &name,
                   std::shared_ptr<FunctionSymbol> function) {
-    auto it = symbols_.find(name);
-    if (it == symbols_.end()) {
+    const Atom atom = internAtom(name);
+    auto *existing = symbols_.find(atom);
+    if (!existing) {
       auto set = std::make_shared<OverloadSetSymbol>(
           name, function ? function->moduleName : "");
       set->visibility = function ? function->visibility : Visibility::Private;
       if (function) {
         set->addOverload(function);
       }
-      symbols_[name] = set;
+      symbols_.tryEmplace(atom, set);
       return set;
     }
 
-    auto set = std::dynamic_pointer_cast<OverloadSetSymbol>(it->second);
+    auto set = std::dynamic_pointer_cast<OverloadSetSymbol>(*existing);
     if (!set) {
       return nullptr;
     }
@@ -45,30 +47,32 @@ public:
     return set;
   }
 
-  std::shared_ptr<Symbol> lookup(const std::string &name) const {
-    auto it = symbols_.find(name);
-    if (it != symbols_.end()) {
-      return it->second;
+  std::shared_ptr<Symbol> lookup(std::string_view name) const {
+    return lookup(findAtom(name));
+  }
+
+  std::shared_ptr<Symbol> lookup(Atom atom) const {
+    if (atom == NoAtom) {
+      return nullptr;
     }
-    if (parent_) {
-      return parent_->lookup(name);
+    for (const SymbolTable *scope = this; scope; scope = scope->parent_) {
+      if (const auto *symbol = scope->symbols_.find(atom)) {
+        return *symbol;
+      }
     }
     return nullptr;
   }
 
-  std::shared_ptr<Symbol> lookupLocal(const std::string &name) const {
-    auto it = symbols_.find(name);
-    if (it != symbols_.end()) {
-      return it->second;
-    }
-    return nullptr;
+  std::shared_ptr<Symbol> lookupLocal(std::string_view name) const {
+    const auto *symbol = symbols_.find(findAtom(name));
+    return symbol ? *symbol : nullptr;
   }
 
-  std::shared_ptr<SymbolTable> getParent() const { return parent_; }
+  SymbolTable *getParent() const { return parent_; }
 
 private:
-  std::shared_ptr<SymbolTable> parent_;
-  std::map<std::string, std::shared_ptr<Symbol>> symbols_;
+  SymbolTable *parent_;
+  AtomMap<std::shared_ptr<Symbol>> symbols_;
 };
 
 } // namespace sema
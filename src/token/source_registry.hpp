@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// @brief Number of a source file name, handed out by internSource(). Id 0
+/// is the empty name, so a default 'SourceSpan' belongs to no file.
+using SourceId = uint32_t;
+
+namespace detail {
+
+/// @brief Process-wide table of source names. Modules are lexed on several
+/// threads, so both directions are guarded; names live in a deque so the
+/// references sourceNameOf() hands out stay valid.
+struct SourceRegistry {
+  std::mutex mutex;
+  std::deque<std::string> names{std::string()};
+  std::unordered_map<std::string, SourceId> ids{{std::string(), 0}};
+
+  static SourceRegistry &instance() {
+    static SourceRegistry registry;
+    return registry;
+  }
+};
+
+} // namespace detail
+
+/// @brief Returns the id of @p name, registering it on first use.
+inline SourceId internSource(const std::string &name) {
+  auto &registry = detail::SourceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  const auto [entry, inserted] = registry.ids.try_emplace(
+      name, static_cast<SourceId>(registry.names.size()));
+  if (inserted) {
+    registry.names.push_back(name);
+  }
+  return entry->second;
+}
+
+/// @brief Returns the name registered for @p id, or the empty name.
+inline const std::string &sourceNameOf(SourceId id) {
+  auto &registry = detail::SourceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return id < registry.names.size() ? registry.names[id]
+                                    : registry.names.front();
+}
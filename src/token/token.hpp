@@ -1,5 +1,8 @@
 #pragma once
+#include "source_registry.hpp"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 
 /// @brief Determines the type the token will have.
@@ -103,21 +106,26 @@ enum TokenType {
 /// @brief Contains in-file related information like line, column, offset, and
 /// length.
 struct SourceSpan {
-  size_t line;            ///< Line of the source in the file.
-  size_t column;          ///< Column of the source in the file.
-  size_t offset;          ///< Offset of the source in the file.
-  size_t length;          ///< Length of the source.
-  std::string sourceName; ///< Source file this span belongs to.
+  uint32_t line;   ///< Line of the source in the file.
+  uint32_t column; ///< Column of the source in the file.
+  uint32_t offset; ///< Offset of the source in the file.
+  uint32_t length; ///< Length of the source.
+  SourceId source; ///< Source file this span belongs to, see internSource().
 
   /// @brief Basic constructor of the source span.
   /// @param l Line.
   /// @param c Column.
   /// @param o Offset.
   /// @param len Length.
+  /// @param source Interned source file name.
   SourceSpan(size_t l = 0, size_t c = 0, size_t o = 0, size_t len = 0,
-             std::string source = "") noexcept
-      : line(l), column(c), offset(o), length(len),
-        sourceName(std::move(source)) {}
+             SourceId source = 0) noexcept
+      : line(static_cast<uint32_t>(l)), column(static_cast<uint32_t>(c)),
+        offset(static_cast<uint32_t>(o)), length(static_cast<uint32_t>(len)),
+        source(source) {}
+
+  /// @brief Name of the source file this span belongs to.
+  const std::string &sourceName() const { return sourceNameOf(source); }
 
   /// @brief Merges two 'SourceSpan' classes.
   /// @param start From.
@@ -127,24 +135,27 @@ struct SourceSpan {
                           const SourceSpan &end) noexcept {
     size_t newLen = (end.offset + end.length) - start.offset;
     return SourceSpan(start.line, start.column, start.offset, newLen,
-                      start.sourceName);
+                      start.source);
   }
 };
 
 class Token {
 public:
-  SourceSpan span;   ///< Source of the token in the file.
-  TokenType type;    ///< Type of the token.
-  std::string value; ///< String of the token.
+  SourceSpan span;        ///< Source of the token in the file.
+  TokenType type;         ///< Type of the token.
+  std::string_view value; ///< Text of the token.
 
-  /// @brief Default constructor of the 'Token' class.
-  Token(TokenType type, const std::string &value, SourceSpan span)
+  /// @brief Default constructor of the 'Token' class. @p value must outlive
+  /// the token: the lexer points it into the source it was given. String,
+  /// char and number literals keep their source spelling, see
+  /// Lexer::literalValue().
+  Token(TokenType type, std::string_view value, SourceSpan span)
       : span(span), type(type), value(value) {}
 
   /// @brief Helper constructor for when we build span component-wise.
-  Token(TokenType type, const std::string &value, size_t line, size_t column,
-        size_t offset, size_t length)
-      : span(line, column, offset, length), type(type), value(value) {}
+  Token(TokenType type, std::string_view value, size_t line, size_t column,
+        size_t offset, size_t length, SourceId source = 0)
+      : span(line, column, offset, length, source), type(type), value(value) {}
 
   ~Token() noexcept = default;
 };
@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace zap {
+
+class ArenaRef;
+
+/// @brief Bump allocator for syntax and bound-tree nodes. Memory comes
+/// from chunks that grow from 4 KiB to 1 MiB and is only given back, all
+/// chunks at once, when the last 'ArenaRef' goes away. Whoever owns a tree
+/// holds a reference to its arena, declared before the tree so the tree is
+/// destroyed first; nodes that outlive their tree are allocated elsewhere.
+/// Only one thread allocates from an arena at a time, see 'ArenaScope';
+/// nodes may be freed on any thread, and those freed inside the arena's
+/// own scope, such as the binder's temporaries, are reused for nodes of the
+/// same size. Freeing a node anywhere else costs nothing.
+class Arena {
+public:
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  static ArenaRef create();
+
+  /// @brief Returns @p size bytes aligned like a pointer, which is as far
+  /// as any node class needs.
+  void *allocate(size_t size) {
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (size <= maxReusedSize) {
+      if (FreeBlock *block = free_[size / alignment]) {
+        free_[size / alignment] = block->next;
+        return block;
+      }
+    }
+    if (static_cast<size_t>(end_ - next_) < size) {
+      grow(size);
+    }
+    void *result = next_;
+    next_ += size;
+    bytesUsed_ += size;
+    return result;
+  }
+
+  /// @brief Takes back @p size bytes from allocate() for reuse. Only
+  /// called by the thread allocating from this arena.
+  void recycle(void *memory, size_t size) noexcept {
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (size <= maxReusedSize) {
+      auto *block = static_cast<FreeBlock *>(memory);
+      block->next = free_[size / alignment];
+      free_[size / alignment] = block;
+    }
+  }
+
+  size_t chunkCount() const noexcept { return chunks_.size(); }
+  size_t bytesUsed() const noexcept { return bytesUsed_; }
+  size_t bytesReserved() const noexcept { return bytesReserved_; }
+
+  static constexpr size_t alignment = alignof(void *);
+
+private:
+  friend class ArenaRef;
+
+  static constexpr size_t firstChunkSize = 4 * 1024;
+  static constexpr size_t maxChunkSize = 1024 * 1024;
+  static constexpr size_t maxReusedSize = 512;
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  Arena() = default;
+  ~Arena() {
+    for (void *chunk : chunks_) {
+      ::operator delete(chunk);
+    }
+  }
+
+  void retain() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void release() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  void grow(size_t size) {
+    nextChunkSize_ = std::min(nextChunkSize_ * 2, maxChunkSize);
+    const size_t chunkSize = std::max(size, nextChunkSize_);
+    chunks_.push_back(::operator new(chunkSize));
+    next_ = static_cast<char *>(chunks_.back());
+    end_ = next_ + chunkSize;
+    bytesReserved_ += chunkSize;
+  }
+
+  std::vector<void *> chunks_;
+  std::array<FreeBlock *, maxReusedSize / alignment + 1> free_{};
+  char *next_ = nullptr;
+  char *end_ = nullptr;
+  size_t nextChunkSize_ = firstChunkSize / 2;
+  size_t bytesUsed_ = 0;
+  size_t bytesReserved_ = 0;
+  std::atomic<size_t> refs_{0};
+};
+
+/// @brief Shared handle to an 'Arena'.
+class ArenaRef {
+public:
+  ArenaRef() noexcept = default;
+  explicit ArenaRef(Arena *arena) noexcept : arena_(arena) {
+    if (arena_) {
+      arena_->retain();
+    }
+  }
+  ArenaRef(const ArenaRef &other) noexcept : ArenaRef(other.arena_) {}
+  ArenaRef(ArenaRef &&other) noexcept
+      : arena_(std::exchange(other.arena_, nullptr)) {}
+  ArenaRef &operator=(ArenaRef other) noexcept {
+    std::swap(arena_, other.arena_);
+    return *this;
+  }
+  ~ArenaRef() {
+    if (arena_) {
+      arena_->release();
+    }
+  }
+
+  Arena *get() const noexcept { return arena_; }
+  Arena *operator->() const noexcept { return arena_; }
+  explicit operator bool() const noexcept { return arena_ != nullptr; }
+
+private:
+  Arena *arena_ = nullptr;
+};
+
+inline ArenaRef Arena::create() { return ArenaRef(new Arena()); }
+
+/// @brief Makes @p arena the one nodes created on this thread come from,
+/// until the scope ends. Scopes nest; without one, nodes use the heap.
+class ArenaScope {
+public:
+  explicit ArenaScope(Arena *arena) noexcept : previous_(current_) {
+    current_ = arena;
+  }
+  ~ArenaScope() { current_ = previous_; }
+
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+
+  static Arena *current() noexcept { return current_; }
+
+private:
+  Arena *previous_;
+  inline static thread_local Arena *current_ = nullptr;
+};
+
+namespace detail {
+
+// Every node is preceded by the arena it came from, or null for the heap,
+// so freeing it knows whether to recycle it, free it or leave it to the
+// arena's chunks.
+constexpr size_t nodeHeader = sizeof(Arena *);
+
+inline void *allocateNode(size_t size) {
+  Arena *arena = ArenaScope::current();
+  void *block;
+  if (arena) {
+    block = arena->allocate(nodeHeader + size);
+  } else {
+    block = ::operator new(nodeHeader + size);
+  }
+  *static_cast<Arena **>(block) = arena;
+  return static_cast<char *>(block) + nodeHeader;
+}
+
+inline void releaseNode(void *node, size_t size) noexcept {
+  if (!node) {
+    return;
+  }
+  void *block = static_cast<char *>(node) - nodeHeader;
+  Arena *arena = *static_cast<Arena **>(block);
+  if (!arena) {
+    ::operator delete(block);
+  } else if (arena == ArenaScope::current()) {
+    arena->recycle(block, nodeHeader + size);
+  }
+}
+
+} // namespace detail
+
+} // namespace zap
+
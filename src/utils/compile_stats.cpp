@@ -0,0 +1,231 @@
+#include "compile_stats.hpp"
+#include "stream.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <map>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace zap::stats {
+namespace {
+
+struct Phase {
+  std::string name;
+  double wallSeconds = 0;
+  double cpuSeconds = 0;
+  uint64_t peakRssKiB = 0;
+};
+
+struct Collector {
+  bool enabled = false;
+  double wallStart = 0;
+  double cpuStart = 0;
+  std::vector<Phase> phases;
+  std::vector<std::pair<std::string, uint64_t>> counters;
+  std::map<std::string, double> passTimes;
+  std::string passReport;
+};
+
+Collector &collector() {
+  static Collector instance;
+  return instance;
+}
+
+double wallSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double cpuSeconds() {
+#ifdef _WIN32
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#else
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+         static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) /
+             1e6;
+#endif
+}
+
+uint64_t peakRssKiB() {
+#ifdef _WIN32
+  return 0;
+#else
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+std::string format(const char *spec, double value) {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), spec, value);
+  return buffer;
+}
+
+std::string jsonString(const std::string &text) {
+  std::string quoted = "\"";
+  for (const char ch : text) {
+    if (ch == '"' || ch == '\\') {
+      quoted += '\\';
+      quoted += ch;
+    } else if (static_cast<unsigned char>(ch) < 0x20) {
+      char escape[8];
+      std::snprintf(escape, sizeof(escape), "\\u%04x", ch);
+      quoted += escape;
+    } else {
+      quoted += ch;
+    }
+  }
+  return quoted + '"';
+}
+
+Phase total() {
+  const auto &stats = collector();
+  return {"total", wallSeconds() - stats.wallStart,
+          cpuSeconds() - stats.cpuStart, peakRssKiB()};
+}
+
+} // namespace
+
+void enable() {
+  auto &stats = collector();
+  stats.enabled = true;
+  stats.wallStart = wallSeconds();
+  stats.cpuStart = cpuSeconds();
+}
+
+bool enabled() { return collector().enabled; }
+
+PhaseTimer::PhaseTimer(const char *name) : name_(name) {
+  if (enabled()) {
+    wallStart_ = wallSeconds();
+    cpuStart_ = cpuSeconds();
+  }
+}
+
+PhaseTimer::~PhaseTimer() {
+  auto &stats = collector();
+  if (!stats.enabled) {
+    return;
+  }
+  const double wall = wallSeconds() - wallStart_;
+  const double cpu = cpuSeconds() - cpuStart_;
+  for (auto &phase : stats.phases) {
+    if (phase.name == name_) {
+      phase.wallSeconds += wall;
+      phase.cpuSeconds += cpu;
+      phase.peakRssKiB = peakRssKiB();
+      return;
+    }
+  }
+  stats.phases.push_back({name_, wall, cpu, peakRssKiB()});
+}
+
+void count(const std::string &name, uint64_t value) {
+  auto &stats = collector();
+  if (!stats.enabled) {
+    return;
+  }
+  for (auto &counter : stats.counters) {
+    if (counter.first == name) {
+      counter.second += value;
+      return;
+    }
+  }
+  stats.counters.emplace_back(name, value);
+}
+
+void passTime(const std::string &pass, double wallSeconds) {
+  auto &stats = collector();
+  if (stats.enabled) {
+    stats.passTimes[pass] += wallSeconds;
+  }
+}
+
+void passReport(std::string report) {
+  auto &stats = collector();
+  if (stats.enabled) {
+    stats.passReport += report;
+  }
+}
+
+void printReport(Stream &os) {
+  const auto &stats = collector();
+  os << "===== zapc time report =====\n";
+  os << "  phase              wall (ms)   cpu (ms)  peak RSS (MiB)\n";
+  auto printPhase = [&](const Phase &phase) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "  %-16s %11.2f %10.2f %15.1f\n",
+                  phase.name.c_str(), phase.wallSeconds * 1000,
+                  phase.cpuSeconds * 1000, phase.peakRssKiB / 1024.0);
+    os << line;
+  };
+  for (const auto &phase : stats.phases) {
+    printPhase(phase);
+  }
+  printPhase(total());
+  if (!stats.counters.empty()) {
+    os << "\n  counter                          value\n";
+    for (const auto &[name, value] : stats.counters) {
+      char line[128];
+      std::snprintf(line, sizeof(line), "  %-28s %9llu\n", name.c_str(),
+                    static_cast<unsigned long long>(value));
+      os << line;
+    }
+  }
+  if (!stats.passReport.empty()) {
+    os << '\n' << stats.passReport;
+  }
+}
+
+bool writeJson(const std::filesystem::path &path) {
+  const auto &stats = collector();
+  std::ofstream out(path, std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  auto writePhase = [&](const Phase &phase) {
+    out << "{\"name\": " << jsonString(phase.name)
+        << ", \"wall\": " << format("%.6f", phase.wallSeconds)
+        << ", \"cpu\": " << format("%.6f", phase.cpuSeconds)
+        << ", \"peakRssKiB\": " << phase.peakRssKiB << "}";
+  };
+
+  out << "{\n  \"phases\": [";
+  const char *separator = "\n    ";
+  for (const auto &phase : stats.phases) {
+    out << separator;
+    writePhase(phase);
+    separator = ",\n    ";
+  }
+  out << "\n  ],\n  \"total\": ";
+  writePhase(total());
+  out << ",\n  \"counters\": {";
+  separator = "\n    ";
+  for (const auto &[name, value] : stats.counters) {
+    out << separator << jsonString(name) << ": " << value;
+    separator = ",\n    ";
+  }
+  out << "\n  },\n  \"passes\": {";
+  separator = "\n    ";
+  for (const auto &[pass, seconds] : stats.passTimes) {
+    out << separator << jsonString(pass) << ": " << format("%.6f", seconds);
+    separator = ",\n    ";
+  }
+  out << "\n  }\n}\n";
+  return static_cast<bool>(out.flush());
+}
+
+} // namespace zap::stats
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zap {
+class Stream;
+}
+
+namespace zap::stats {
+
+/// @brief Starts collecting phase timings and counters for this process.
+/// Until then every function below does nothing, so instrumented code costs
+/// one branch when no report was asked for.
+void enable();
+bool enabled();
+
+/// @brief Times one compiler phase from construction to destruction: wall
+/// and CPU time, and the peak resident set size once it ends. Phases with
+/// the same name add up; they are reported in the order they first ran.
+class PhaseTimer {
+public:
+  explicit PhaseTimer(const char *name);
+  ~PhaseTimer();
+
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+private:
+  const char *name_;
+  double wallStart_ = 0;
+  double cpuStart_ = 0;
+};
+
+/// @brief Adds @p value to the counter @p name.
+void count(const std::string &name, uint64_t value);
+
+/// @brief Records the time LLVM's pass instrumentation measured for one
+/// optimizer pass, in seconds.
+void passTime(const std::string &pass, double wallSeconds);
+
+/// @brief Keeps LLVM's own pass timing report for printReport().
+void passReport(std::string report);
+
+/// @brief Prints phases, counters and the LLVM pass report as text.
+void printReport(Stream &os);
+
+/// @brief Writes phases, counters and pass times to @p path as JSON.
+/// Returns false if the file cannot be written.
+bool writeJson(const std::filesystem::path &path);
+
+} // namespace zap::stats
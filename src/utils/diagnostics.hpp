@@ -230,7 +230,7 @@ computeUnderlineColumns(const SourceSpan &span, const std::string &lineContent,
     startByteInLine = span.offset - lineStartOffset;
   } else if (span.column > 0) {
     // Approx fallback when offset is unavailable: best-effort by characters.
-    startByteInLine = std::min(span.column - 1, lineContent.size());
+    startByteInLine = std::min<size_t>(span.column - 1, lineContent.size());
   }
   startByteInLine = clampToCodePointBoundary(lineContent, startByteInLine);
   startByteInLine = std::min(startByteInLine, lineContent.size());
@@ -692,8 +692,7 @@ private:
   }
 
   const std::string &sourceFor(const SourceSpan &span) const {
-    const std::string &name =
-        span.sourceName.empty() ? fileName : span.sourceName;
+    const std::string &name = span.source == 0 ? fileName : span.sourceName();
     auto it = sources_.find(name);
     if (it != sources_.end()) {
       return it->second;
@@ -702,14 +701,14 @@ private:
   }
 
   std::string fileNameFor(const SourceSpan &span) const {
-    return span.sourceName.empty() ? fileName : span.sourceName;
+    return span.source == 0 ? fileName : span.sourceName();
   }
 
   DiagnosticRange makeRange(SourceSpan span,
                             const std::string &rangeSource) const {
     DiagnosticPosition start{span.line, span.column, span.offset};
 
-    size_t endOffset = std::min(span.offset, rangeSource.size());
+    size_t endOffset = std::min<size_t>(span.offset, rangeSource.size());
     size_t remaining = span.length;
 
     size_t line = start.line;
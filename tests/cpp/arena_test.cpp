@@ -0,0 +1,88 @@
+#include "ast/bin_expr.hpp"
+#include "ast/const/const_int.hpp"
+#include "utils/arena.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+bool expect(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+  }
+  return condition;
+}
+
+bool testNodesComeFromTheCurrentScope() {
+  auto arena = zap::Arena::create();
+  std::unique_ptr<BinExpr> tree;
+  {
+    zap::ArenaScope scope(arena.get());
+    tree = std::make_unique<BinExpr>(std::make_unique<ConstInt>(int64_t{1}),
+                                     "+",
+                                     std::make_unique<ConstInt>(int64_t{2}));
+  }
+  const size_t used = arena->bytesUsed();
+  auto heapNode = std::make_unique<ConstInt>(int64_t{3});
+
+  return expect(used >= sizeof(BinExpr) + 2 * sizeof(ConstInt),
+                "nodes created in an arena scope did not use the arena") &&
+         expect(arena->bytesUsed() == used,
+                "a node created outside any scope used the arena") &&
+         expect(arena->chunkCount() == 1,
+                "a small tree needed more than one chunk");
+}
+
+bool testOwnersKeepTheirArenaAlive() {
+  // Declared before the tree, as owners do, so the tree goes first.
+  zap::ArenaRef owner;
+  std::unique_ptr<BinExpr> tree;
+  {
+    auto arena = zap::Arena::create();
+    owner = arena;
+    zap::ArenaScope scope(arena.get());
+    tree = std::make_unique<BinExpr>(std::make_unique<ConstInt>("40"), "+",
+                                     std::make_unique<ConstInt>("2"));
+  }
+  // The creating handle is gone; the owner's still holds the chunks.
+  auto *left = static_cast<ConstInt *>(tree->left_.get());
+  const bool intact = left->value_ == "40" && tree->op_ == "+";
+  const size_t used = owner->bytesUsed();
+  tree.reset();
+  return expect(intact, "a tree lost its storage while its owner held it") &&
+         expect(owner->bytesUsed() == used,
+                "a tree freed outside its arena's scope changed the arena");
+}
+
+bool testNodesFreedInScopeAreReused() {
+  auto arena = zap::Arena::create();
+  zap::ArenaScope scope(arena.get());
+  auto first = std::make_unique<ConstInt>(int64_t{1});
+  const void *firstAddress = first.get();
+  first.reset();
+  auto second = std::make_unique<ConstInt>(int64_t{2});
+  const bool reused = second.get() == firstAddress;
+
+  const size_t used = arena->bytesUsed();
+  {
+    zap::ArenaScope heapScope(nullptr);
+    second.reset();
+  }
+  auto third = std::make_unique<ConstInt>(int64_t{3});
+
+  return expect(reused, "a node freed in its arena's scope was not reused") &&
+         expect(arena->bytesUsed() > used,
+                "a node freed outside its arena's scope was reused");
+}
+
+} // namespace
+
+int main() {
+  bool ok = true;
+  ok = testNodesComeFromTheCurrentScope() && ok;
+  ok = testOwnersKeepTheirArenaAlive() && ok;
+  ok = testNodesFreedInScopeAreReused() && ok;
+  return ok ? 0 : 1;
+}
@@ -31,7 +31,9 @@ using zir::ResultBorrowContract;
 using zir::StoreInst;
 using zir::StoreMode;
 using zir::Type;
+using zir::NoValue;
 using zir::TypeKind;
+using zir::ValueId;
 using zir::ValueOwnership;
 using zir::VerificationErrorCode;
 using zir::VerificationResult;
@@ -41,9 +43,9 @@ std::shared_ptr<Type> primitive(TypeKind kind) {
   return std::make_shared<PrimitiveType>(kind);
 }
 
-std::shared_ptr<Register> reg(const std::string &name,
-                              const std::shared_ptr<Type> &type) {
-  return std::make_shared<Register>(name, type);
+ValueId reg(Function &function, const std::string &name,
+            const std::shared_ptr<Type> &type) {
+  return function.values.add<Register>(name, type);
 }
 
 bool expect(bool condition, const std::string &message) {
@@ -65,17 +67,15 @@ bool hasError(const VerificationResult &result, VerificationErrorCode code,
   return false;
 }
 
-void addOwnedStringAndView(BasicBlock &block, const std::string &name,
-                           const std::shared_ptr<zir::Value> &slot,
-                           StoreMode storeMode,
-                           std::shared_ptr<Register> &owner) {
+void addOwnedStringAndView(Function &function, BasicBlock &block,
+                           const std::string &name, ValueId slot,
+                           StoreMode storeMode, ValueId &owner) {
   const auto stringType = zir::makeStringType();
-  owner = reg(name + ".owner", stringType);
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto view = reg(name + ".view", zir::makeStringViewType());
+  owner = reg(function, name + ".owner", stringType);
+  function.getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto view = reg(function, name + ".view", zir::makeStringViewType());
   block.addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   block.addInstruction(std::make_unique<BorrowInst>(view, owner));
   block.addInstruction(std::make_unique<StoreInst>(view, slot, storeMode));
 }
@@ -87,34 +87,37 @@ bool testStorageProvenanceCrossesPassThroughBlocks() {
       std::make_unique<Function>("diamond", primitive(TypeKind::Void));
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(stringViewType));
+  auto slot =
+      reg(*function, "slot", std::make_shared<PointerType>(stringViewType));
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", primitive(TypeKind::Bool)), "left",
+      function->values.add<Constant>("true", primitive(TypeKind::Bool)), "left",
       "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  std::shared_ptr<Register> leftOwner;
-  addOwnedStringAndView(*left, "left", slot, StoreMode::Initialize, leftOwner);
+  ValueId leftOwner = NoValue;
+  addOwnedStringAndView(*function, *left, "left", slot, StoreMode::Initialize,
+                        leftOwner);
   left->addInstruction(std::make_unique<BranchInst>("left.forward"));
 
   auto leftForward = std::make_unique<BasicBlock>("left.forward");
   leftForward->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto right = std::make_unique<BasicBlock>("right");
-  std::shared_ptr<Register> rightOwner;
-  addOwnedStringAndView(*right, "right", slot, StoreMode::Assign, rightOwner);
+  ValueId rightOwner = NoValue;
+  addOwnedStringAndView(*function, *right, "right", slot, StoreMode::Assign,
+                        rightOwner);
   right->addInstruction(std::make_unique<BranchInst>("right.forward"));
 
   auto rightForward = std::make_unique<BasicBlock>("right.forward");
   rightForward->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto loaded = reg("loaded", stringViewType);
+  auto loaded = reg(*function, "loaded", stringViewType);
   merge->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   merge->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{loaded}));
+      NoValue, "consume", std::vector<ValueId>{loaded}));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
   const auto *leftForwardBlock = leftForward.get();
@@ -136,10 +139,10 @@ bool testStorageProvenanceCrossesPassThroughBlocks() {
       provenance.ownersOnEdge(loaded, *rightForwardBlock, *mergeBlock);
   const auto liveness = zir::analyzeOwnershipLiveness(module, *function);
   return expect(
-      leftOwners.count(leftOwner.get()) == 1 &&
-          leftOwners.count(rightOwner.get()) == 0 &&
-          rightOwners.count(rightOwner.get()) == 1 &&
-          rightOwners.count(leftOwner.get()) == 0 &&
+      leftOwners.count(leftOwner) == 1 &&
+          leftOwners.count(rightOwner) == 0 &&
+          rightOwners.count(rightOwner) == 1 &&
+          rightOwners.count(leftOwner) == 0 &&
           liveness.isLiveOnEdge(*leftForwardBlock, *mergeBlock, leftOwner) &&
           !liveness.isLiveOnEdge(*leftForwardBlock, *mergeBlock, rightOwner) &&
           liveness.isLiveOnEdge(*rightForwardBlock, *mergeBlock, rightOwner) &&
@@ -155,35 +158,34 @@ bool testPhiProvenanceSelectsIncomingOwner() {
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", primitive(TypeKind::Bool)), "left",
+      function->values.add<Constant>("true", primitive(TypeKind::Bool)), "left",
       "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  auto leftOwner = reg("left.owner", stringType);
-  leftOwner->setOwnership(ValueOwnership::OwnedStrong);
-  auto leftView = reg("left.view", stringViewType);
+  auto leftOwner = reg(*function, "left.owner", stringType);
+  function->getValue(leftOwner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto leftView = reg(*function, "left.view", stringViewType);
   left->addInstruction(std::make_unique<CallInst>(
-      leftOwner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      leftOwner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   left->addInstruction(std::make_unique<BorrowInst>(leftView, leftOwner));
   left->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto right = std::make_unique<BasicBlock>("right");
-  auto rightOwner = reg("right.owner", stringType);
-  rightOwner->setOwnership(ValueOwnership::OwnedStrong);
-  auto rightView = reg("right.view", stringViewType);
+  auto rightOwner = reg(*function, "right.owner", stringType);
+  function->getValue(rightOwner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto rightView = reg(*function, "right.view", stringViewType);
   right->addInstruction(std::make_unique<CallInst>(
-      rightOwner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      rightOwner, "make", std::vector<ValueId>{},
+      std::vector<bool>{}, NoValue));
   right->addInstruction(std::make_unique<BorrowInst>(rightView, rightOwner));
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto mergedView = reg("merged.view", stringViewType);
-  auto derivedView = reg("derived.view", stringViewType);
+  auto mergedView = reg(*function, "merged.view", stringViewType);
+  auto derivedView = reg(*function, "derived.view", stringViewType);
   merge->addInstruction(std::make_unique<PhiInst>(
       mergedView,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      std::vector<std::pair<std::string, ValueId>>{
           {"left", leftView}, {"right", rightView}}));
   merge->addInstruction(
       std::make_unique<CastInst>(derivedView, mergedView, stringViewType));
@@ -209,12 +211,12 @@ bool testPhiProvenanceSelectsIncomingOwner() {
       provenance.ownersOnEdge(derivedView, *leftBlock, *mergeBlock);
   const auto derivedRightOwners =
       provenance.ownersOnEdge(derivedView, *rightBlock, *mergeBlock);
-  return expect(allOwners.count(leftOwner.get()) == 1 &&
-                    allOwners.count(rightOwner.get()) == 1 &&
-                    leftOwners.count(leftOwner.get()) == 1 &&
-                    leftOwners.count(rightOwner.get()) == 0 &&
-                    rightOwners.count(rightOwner.get()) == 1 &&
-                    rightOwners.count(leftOwner.get()) == 0 &&
+  return expect(allOwners.count(leftOwner) == 1 &&
+                    allOwners.count(rightOwner) == 1 &&
+                    leftOwners.count(leftOwner) == 1 &&
+                    leftOwners.count(rightOwner) == 0 &&
+                    rightOwners.count(rightOwner) == 1 &&
+                    rightOwners.count(leftOwner) == 0 &&
                     derivedLeftOwners == leftOwners &&
                     derivedRightOwners == rightOwners,
                 "phi borrow provenance did not select its incoming edge owner");
@@ -226,20 +228,22 @@ bool testStorageProvenanceReachesLoopBackEdge() {
   auto function = std::make_unique<Function>("loop", primitive(TypeKind::Void));
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(stringViewType));
+  auto slot =
+      reg(*function, "slot", std::make_shared<PointerType>(stringViewType));
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
-  std::shared_ptr<Register> owner;
-  addOwnedStringAndView(*entry, "loop", slot, StoreMode::Initialize, owner);
+  ValueId owner = NoValue;
+  addOwnedStringAndView(*function, *entry, "loop", slot,
+                        StoreMode::Initialize, owner);
   entry->addInstruction(std::make_unique<BranchInst>("loop"));
 
   auto loop = std::make_unique<BasicBlock>("loop");
-  auto loaded = reg("loaded", stringViewType);
+  auto loaded = reg(*function, "loaded", stringViewType);
   loop->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   loop->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{loaded}));
+      NoValue, "consume", std::vector<ValueId>{loaded}));
   loop->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", primitive(TypeKind::Bool)), "loop",
+      function->values.add<Constant>("true", primitive(TypeKind::Bool)), "loop",
       "exit"));
 
   auto exit = std::make_unique<BasicBlock>("exit");
@@ -257,7 +261,7 @@ bool testStorageProvenanceReachesLoopBackEdge() {
   const auto backEdgeOwners =
       provenance.ownersOnEdge(loaded, *loopBlock, *loopBlock);
   const auto liveness = zir::analyzeOwnershipLiveness(module, *function);
-  return expect(backEdgeOwners.count(owner.get()) == 1 &&
+  return expect(backEdgeOwners.count(owner) == 1 &&
                     liveness.isLiveOnEdge(*entryBlock, *loopBlock, owner) &&
                     liveness.isLiveOnEdge(*loopBlock, *loopBlock, owner),
                 "storage borrow provenance did not reach the loop back-edge");
@@ -271,21 +275,21 @@ bool testVerifierReportsLocalOwnerThroughPhi() {
 
   auto function = std::make_unique<Function>("broken", stringViewType);
   auto callerView =
-      std::make_shared<zir::Argument>("caller.view", stringViewType);
+      function->values.add<zir::Argument>("caller.view", stringViewType);
   function->arguments.push_back(callerView);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", primitive(TypeKind::Bool)), "local",
-      "caller"));
+      function->values.add<Constant>("true", primitive(TypeKind::Bool)),
+      "local", "caller"));
 
   auto local = std::make_unique<BasicBlock>("local");
-  auto localOwner = reg("local.owner", stringType);
-  localOwner->setOwnership(ValueOwnership::OwnedStrong);
-  auto localView = reg("local.view", stringViewType);
+  auto localOwner = reg(*function, "local.owner", stringType);
+  function->getValue(localOwner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto localView = reg(*function, "local.view", stringViewType);
   local->addInstruction(std::make_unique<CallInst>(
-      localOwner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      localOwner, "make", std::vector<ValueId>{},
+      std::vector<bool>{}, NoValue));
   local->addInstruction(std::make_unique<BorrowInst>(localView, localOwner));
   local->addInstruction(std::make_unique<BranchInst>("merge"));
 
@@ -293,10 +297,10 @@ bool testVerifierReportsLocalOwnerThroughPhi() {
   caller->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto mergedView = reg("merged.view", stringViewType);
+  auto mergedView = reg(*function, "merged.view", stringViewType);
   merge->addInstruction(std::make_unique<PhiInst>(
       mergedView,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      std::vector<std::pair<std::string, ValueId>>{
           {"local", localView}, {"caller", callerView}}));
   merge->addInstruction(std::make_unique<ReturnInst>(mergedView));
 
@@ -316,24 +320,24 @@ bool testVerifierAllowsCallerBorrowPhiReturn() {
   const auto stringViewType = zir::makeStringViewType();
   Module module("borrowed-phi-return");
   auto function = std::make_unique<Function>("valid", stringViewType);
-  auto leftView = std::make_shared<zir::Argument>("left", stringViewType);
-  auto rightView = std::make_shared<zir::Argument>("right", stringViewType);
+  auto leftView = function->values.add<zir::Argument>("left", stringViewType);
+  auto rightView = function->values.add<zir::Argument>("right", stringViewType);
   function->arguments.push_back(leftView);
   function->arguments.push_back(rightView);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", primitive(TypeKind::Bool)), "left",
+      function->values.add<Constant>("true", primitive(TypeKind::Bool)), "left",
       "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto mergedView = reg("merged.view", stringViewType);
+  auto mergedView = reg(*function, "merged.view", stringViewType);
   merge->addInstruction(std::make_unique<PhiInst>(
       mergedView,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      std::vector<std::pair<std::string, ValueId>>{
           {"left", leftView}, {"right", rightView}}));
   merge->addInstruction(std::make_unique<ReturnInst>(mergedView));
 
@@ -357,13 +361,13 @@ bool testVerifierReportsOwnerThroughStorageAndDerivedView() {
   auto function = std::make_unique<Function>("broken", stringViewType);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto owner = reg("stored.owner", stringType);
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto view = reg("stored.view", stringViewType);
-  auto slot = reg("slot", std::make_shared<PointerType>(stringViewType));
+  auto owner = reg(*function, "stored.owner", stringType);
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto view = reg(*function, "stored.view", stringViewType);
+  auto slot =
+      reg(*function, "slot", std::make_shared<PointerType>(stringViewType));
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, owner));
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
@@ -375,8 +379,8 @@ bool testVerifierReportsOwnerThroughStorageAndDerivedView() {
   forward->addInstruction(std::make_unique<BranchInst>("exit"));
 
   auto exit = std::make_unique<BasicBlock>("exit");
-  auto loaded = reg("loaded.view", stringViewType);
-  auto derived = reg("derived.view", stringViewType);
+  auto loaded = reg(*function, "loaded.view", stringViewType);
+  auto derived = reg(*function, "derived.view", stringViewType);
   exit->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   exit->addInstruction(
       std::make_unique<CastInst>(derived, loaded, stringViewType));
@@ -401,17 +405,17 @@ bool testVerifierAllowsOverwrittenLocalBorrowReturn() {
   module.addExternalFunction(std::make_unique<Function>("make", stringType));
   auto function = std::make_unique<Function>("valid", stringViewType);
   auto callerView =
-      std::make_shared<zir::Argument>("caller.view", stringViewType);
+      function->values.add<zir::Argument>("caller.view", stringViewType);
   function->arguments.push_back(callerView);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto owner = reg("local.owner", stringType);
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto localView = reg("local.view", stringViewType);
-  auto slot = reg("slot", std::make_shared<PointerType>(stringViewType));
+  auto owner = reg(*function, "local.owner", stringType);
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto localView = reg(*function, "local.view", stringViewType);
+  auto slot =
+      reg(*function, "slot", std::make_shared<PointerType>(stringViewType));
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(localView, owner));
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
@@ -425,7 +429,7 @@ bool testVerifierAllowsOverwrittenLocalBorrowReturn() {
   overwrite->addInstruction(std::make_unique<BranchInst>("exit"));
 
   auto exit = std::make_unique<BasicBlock>("exit");
-  auto loaded = reg("loaded.view", stringViewType);
+  auto loaded = reg(*function, "loaded.view", stringViewType);
   exit->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   exit->addInstruction(std::make_unique<ReturnInst>(loaded));
 
@@ -445,7 +449,7 @@ bool testVerifierRejectsNoEscapeParameterReturn() {
   const auto stringViewType = zir::makeStringViewType();
   Module module("noescape-return");
   auto function = std::make_unique<Function>("broken", stringViewType);
-  auto view = std::make_shared<zir::Argument>(
+  auto view = function->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape);
   function->arguments.push_back(view);
@@ -466,18 +470,18 @@ bool testVerifierRejectsNoEscapeForwardingToUnspecifiedParameter() {
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
   consume->arguments.push_back(
-      std::make_shared<zir::Argument>("view", stringViewType));
+      consume->values.add<zir::Argument>("view", stringViewType));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto view = std::make_shared<zir::Argument>(
+  auto view = function->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape);
   function->arguments.push_back(view);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view}));
+      NoValue, "consume", std::vector<ValueId>{view}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -501,21 +505,20 @@ bool testVerifierRejectsLocalBorrowForwardingToUnspecifiedParameter() {
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
   consume->arguments.push_back(
-      std::make_shared<zir::Argument>("view", stringViewType));
+      consume->values.add<zir::Argument>("view", stringViewType));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto owner = reg("owner", zir::makeStringType());
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto view = reg("view", stringViewType);
+  auto owner = reg(*function, "owner", zir::makeStringType());
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto view = reg(*function, "view", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, owner));
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view}));
+      NoValue, "consume", std::vector<ValueId>{view}));
   entry->addInstruction(std::make_unique<zir::DestroyInst>(owner));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -534,24 +537,23 @@ bool testVerifierAllowsLocalBorrowForwardingToNoEscapeParameter() {
   addStringFactory(module);
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  consume->arguments.push_back(std::make_shared<zir::Argument>(
+  consume->arguments.push_back(consume->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto owner = reg("owner", zir::makeStringType());
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto view = reg("view", stringViewType);
+  auto owner = reg(*function, "owner", zir::makeStringType());
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto view = reg(*function, "view", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, owner));
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view},
-      std::vector<bool>{false}, nullptr));
+      NoValue, "consume", std::vector<ValueId>{view},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<zir::DestroyInst>(owner));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -568,21 +570,21 @@ bool testVerifierAllowsNoEscapeForwarding() {
   Module module("noescape-forwarding-valid");
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  consume->arguments.push_back(std::make_shared<zir::Argument>(
+  consume->arguments.push_back(consume->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto view = std::make_shared<zir::Argument>(
+  auto view = function->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape);
   function->arguments.push_back(view);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view},
-      std::vector<bool>{false}, nullptr));
+      NoValue, "consume", std::vector<ValueId>{view},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -598,18 +600,18 @@ bool testVerifierDerivesNoEscapeFromCalleeContract() {
   Module module("noescape-call-metadata");
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  consume->arguments.push_back(std::make_shared<zir::Argument>(
+  consume->arguments.push_back(consume->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto view = std::make_shared<zir::Argument>("view", stringViewType);
+  auto view = function->values.add<zir::Argument>("view", stringViewType);
   function->arguments.push_back(view);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view}));
+      NoValue, "consume", std::vector<ValueId>{view}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -625,7 +627,7 @@ makeBorrowingViewFunction(const std::string &name) {
   auto function =
       std::make_unique<Function>(name, zir::makeStringViewType());
   function->arguments.push_back(
-      std::make_shared<zir::Argument>("source", zir::makeStringViewType()));
+      function->values.add<zir::Argument>("source", zir::makeStringViewType()));
   function->resultBorrow = ResultBorrowContract::fromParameter(0);
   return function;
 }
@@ -638,17 +640,16 @@ bool testVerifierTracksBorrowedCallResultToLocalOwner() {
   auto function =
       std::make_unique<Function>("broken", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto owner = reg("owner", zir::makeStringType());
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto source = reg("source", stringViewType);
-  auto result = reg("result", stringViewType);
+  auto owner = reg(*function, "owner", zir::makeStringType());
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto source = reg(*function, "source", stringViewType);
+  auto result = reg(*function, "result", stringViewType);
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(source, owner));
   entry->addInstruction(std::make_unique<CallInst>(
-      result, "tail", std::vector<std::shared_ptr<zir::Value>>{source},
-      std::vector<bool>{false}, nullptr));
+      result, "tail", std::vector<ValueId>{source},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>(result));
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -668,23 +669,21 @@ bool testIndirectBorrowedCallResultExtendsTemporaryOwnerLiveness() {
           zir::ParameterOwnership::Borrow},
       std::vector<ParameterEscape>{ParameterEscape::Unspecified},
       ResultBorrowContract::fromParameter(0));
-  auto tail = std::make_shared<zir::FunctionReference>("tail", tailType);
   auto function =
       std::make_unique<Function>("temporary", primitive(TypeKind::Void));
+  auto tail = function->values.add<zir::FunctionReference>("tail", tailType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto owner = reg("owner", zir::makeStringType());
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto source = reg("source", stringViewType);
-  auto result = reg("result", stringViewType);
+  auto owner = reg(*function, "owner", zir::makeStringType());
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto source = reg(*function, "source", stringViewType);
+  auto result = reg(*function, "result", stringViewType);
   entry->addInstruction(std::make_unique<CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(source, owner));
   entry->addInstruction(std::make_unique<CallInst>(
-      result, tail, std::vector<std::shared_ptr<zir::Value>>{source}));
+      result, tail, std::vector<ValueId>{source}));
   entry->addInstruction(std::make_unique<CallInst>(
-      nullptr, "consume",
-      std::vector<std::shared_ptr<zir::Value>>{result}));
+      NoValue, "consume", std::vector<ValueId>{result}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   const auto *entryBlock = entry.get();
   function->addBlock(std::move(entry));
@@ -705,11 +704,11 @@ bool testVerifierAllowsForwardedBorrowedCallResult() {
 
   auto function = makeBorrowingViewFunction("forward");
   const auto source = function->arguments.front();
-  auto result = reg("result", stringViewType);
+  auto result = reg(*function, "result", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      result, "tail", std::vector<std::shared_ptr<zir::Value>>{source},
-      std::vector<bool>{false}, nullptr));
+      result, "tail", std::vector<ValueId>{source},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>(result));
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -727,15 +726,15 @@ bool testVerifierRejectsReturnedNoEscapeCallResult() {
 
   auto function =
       std::make_unique<Function>("broken", stringViewType);
-  auto source = std::make_shared<zir::Argument>(
+  auto source = function->values.add<zir::Argument>(
       "source", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, ParameterEscape::NoEscape);
   function->arguments.push_back(source);
-  auto result = reg("result", stringViewType);
+  auto result = reg(*function, "result", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      result, "tail", std::vector<std::shared_ptr<zir::Value>>{source},
-      std::vector<bool>{false}, nullptr));
+      result, "tail", std::vector<ValueId>{source},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>(result));
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -753,12 +752,12 @@ bool testVerifierDerivesResultBorrowFromCalleeContract() {
 
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", stringViewType);
+  auto source = function->values.add<zir::Argument>("source", stringViewType);
   function->arguments.push_back(source);
-  auto result = reg("result", stringViewType);
+  auto result = reg(*function, "result", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CallInst>(
-      result, "tail", std::vector<std::shared_ptr<zir::Value>>{source}));
+      result, "tail", std::vector<ValueId>{source}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
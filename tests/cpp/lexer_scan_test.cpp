@@ -0,0 +1,142 @@
+#include "lexer/lexer.hpp"
+#include "lexer/lexer_scan.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool expect(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+  }
+  return condition;
+}
+
+std::vector<const lexer_scan::Kernels *> vectorKernels() {
+  std::vector<const lexer_scan::Kernels *> result;
+  for (auto level : {lexer_scan::Level::Sse2, lexer_scan::Level::Avx2}) {
+    if (const auto *kernels = lexer_scan::kernelsFor(level)) {
+      result.push_back(kernels);
+    }
+  }
+  return result;
+}
+
+// Runs of one byte class with a few newlines, quotes, stars, backslashes
+// and non-ASCII bytes mixed in, so scans end at every offset of a block.
+std::string randomText(std::mt19937 &rng, size_t size) {
+  static const std::string alphabet = "aZ_09 \t\n\r\v\f\"\\*/.+\x80\xff";
+  std::string text;
+  while (text.size() < size) {
+    const char ch = alphabet[rng() % alphabet.size()];
+    text.append(rng() % 40, ch);
+  }
+  text.resize(size);
+  return text;
+}
+
+bool testKernelsMatchScalar() {
+  const auto &scalar = *lexer_scan::kernelsFor(lexer_scan::Level::Scalar);
+  std::mt19937 rng(7);
+  bool ok = true;
+  for (int round = 0; round < 200 && ok; ++round) {
+    const std::string text = randomText(rng, 1 + rng() % 300);
+    const char *data = text.data();
+    for (const auto *kernels : vectorKernels()) {
+      const std::string name = lexer_scan::levelName(kernels->level);
+      for (size_t pos = 0; pos < text.size() && ok; ++pos) {
+        size_t line = 1, column = 1, expectLine = 1, expectColumn = 1;
+        ok = expect(kernels->skipIdentifier(data, pos, text.size()) ==
+                        scalar.skipIdentifier(data, pos, text.size()),
+                    name + " identifier scan disagrees with scalar") &&
+             expect(kernels->skipDigits(data, pos, text.size()) ==
+                        scalar.skipDigits(data, pos, text.size()),
+                    name + " digit scan disagrees with scalar") &&
+             expect(kernels->skipWhitespace(data, pos, text.size(), line,
+                                            column) ==
+                            scalar.skipWhitespace(data, pos, text.size(),
+                                                  expectLine, expectColumn) &&
+                        line == expectLine && column == expectColumn,
+                    name + " whitespace scan disagrees with scalar") &&
+             expect(kernels->skipUntil(data, pos, text.size(), '"', '\\', line,
+                                       column) ==
+                            scalar.skipUntil(data, pos, text.size(), '"',
+                                             '\\', expectLine,
+                                             expectColumn) &&
+                        line == expectLine && column == expectColumn,
+                    name + " string scan disagrees with scalar");
+      }
+    }
+  }
+  return ok;
+}
+
+bool testWhitespaceCountsLines() {
+  const std::string text = std::string(40, ' ') + "\n\n" +
+                           std::string(37, '\t') + "\n   x";
+  bool ok = true;
+  for (auto level : {lexer_scan::Level::Scalar, lexer_scan::Level::Sse2,
+                     lexer_scan::Level::Avx2}) {
+    const auto *kernels = lexer_scan::kernelsFor(level);
+    if (!kernels) {
+      continue;
+    }
+    size_t line = 3, column = 5;
+    const size_t end =
+        kernels->skipWhitespace(text.data(), 0, text.size(), line, column);
+    ok = expect(end == text.size() - 1 && line == 6 && column == 4,
+                std::string(lexer_scan::levelName(level)) +
+                    " whitespace scan misplaced line or column") &&
+         ok;
+  }
+  return ok;
+}
+
+bool testLexerTokensAgreeAcrossLevels() {
+  std::string source;
+  for (int i = 0; i < 50; ++i) {
+    source += "/* block\n * comment " + std::to_string(i) + " */\n";
+    source += "fun f_" + std::to_string(i) + "(a: Int) Int {  // line\n";
+    source += "    let s = \"tab\\t quote\\\" long string literal " +
+              std::string(i, 'x') + "\";\n";
+    source += "    return a * 1_000 + 3.25_0 + 0x7f;\n}\n\n";
+  }
+  zap::DiagnosticEngine expectDiag(source, "scan.zp");
+  Lexer scalarLexer(expectDiag);
+  scalarLexer._scan = lexer_scan::kernelsFor(lexer_scan::Level::Scalar);
+  const auto expected = scalarLexer.tokenize(source);
+
+  bool ok = expect(!expectDiag.hadErrors(), "scalar lexer reported errors");
+  for (const auto *kernels : vectorKernels()) {
+    zap::DiagnosticEngine diag(source, "scan.zp");
+    Lexer lexer(diag);
+    lexer._scan = kernels;
+    const auto tokens = lexer.tokenize(source);
+    bool same = tokens.size() == expected.size();
+    for (size_t i = 0; same && i < tokens.size(); ++i) {
+      same = tokens[i].type == expected[i].type &&
+             tokens[i].value == expected[i].value &&
+             tokens[i].span.line == expected[i].span.line &&
+             tokens[i].span.column == expected[i].span.column &&
+             tokens[i].span.offset == expected[i].span.offset &&
+             tokens[i].span.length == expected[i].span.length;
+    }
+    ok = expect(same, std::string(lexer_scan::levelName(kernels->level)) +
+                          " lexer tokens differ from scalar") &&
+         ok;
+  }
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  bool ok = true;
+  ok = testKernelsMatchScalar() && ok;
+  ok = testWhitespaceCountsLines() && ok;
+  ok = testLexerTokensAgreeAcrossLevels() && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,469 @@
+#include "frontend/module_cache.hpp"
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+#include "utils/diagnostics.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr const char *sourceName = "/project/main.zp";
+
+constexpr const char *source = R"(import "std/io" { println };
+
+pub enum Color { Red, Green = 4, Blue }
+
+pub struct Point<T> {
+    x: T;
+    y: T;
+}
+
+class Counter {
+    priv count: Int;
+
+    fun init(start: Int) {
+        self.count = start;
+    }
+
+    pub fun next() Int {
+        self.count += 1;
+        return self.count;
+    }
+}
+
+fun scale(values: []Float64, factor: Float64) {
+    var i: Int = 0;
+    while i < values.len {
+        values[i] = values[i] * factor;
+        i = i + 1;
+    }
+}
+
+fun main() Int {
+    var counter: Counter = new Counter(1);
+    var point: Point<Int> = Point<Int> { x: 1, y: -2 };
+    var ready: Bool = counter.next() > 1 && point.y != 0;
+    if ready {
+        println("ready: " + 'c' as String);
+    } else {
+        return 1;
+    }
+    var values: [4]Float64;
+    scale(values, 2.5);
+    return 0;
+}
+)";
+
+void require(bool condition, const char *message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+    std::exit(1);
+  }
+}
+
+std::string readFile(const std::filesystem::path &path) {
+  std::ifstream input(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(input), {});
+}
+
+struct TemporaryDirectory {
+  std::filesystem::path path;
+
+  TemporaryDirectory() {
+    const auto suffix =
+        std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    path = std::filesystem::temp_directory_path() /
+           ("zap-module-cache-" + std::to_string(suffix));
+  }
+
+  ~TemporaryDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+  }
+};
+
+std::unique_ptr<RootNode> parse(const std::string &text) {
+  zap::DiagnosticEngine diagnostics(text, sourceName);
+  Lexer lexer(diagnostics);
+  zap::Parser parser(lexer.tokenize(text), diagnostics);
+  auto root = parser.parse();
+  require(root && diagnostics.diagnostics().empty(),
+          "test source did not parse cleanly");
+  return root;
+}
+
+// Prints the fields of every node the test source produces, read straight
+// from the node classes, so it does not share TreeWriter's idea of what a
+// node holds. A node kind it does not know fails the dump.
+class TreeDump : public Visitor {
+public:
+  std::string text() const { return out_.str(); }
+  bool failed() const { return failed_; }
+
+  void node(Node *node) {
+    if (!node) {
+      out_ << " -";
+      return;
+    }
+    node->accept(*this);
+  }
+
+  void visit(Node &) override { failed_ = true; }
+
+  void visit(RootNode &node) override {
+    open("Root", node);
+    nodes(node.children);
+    close();
+  }
+
+  void visit(ImportNode &node) override {
+    open("Import", node);
+    topLevel(node);
+    out_ << ' ' << node.path << " as " << node.moduleAlias;
+    for (const auto &binding : node.bindings) {
+      out_ << ' ' << binding.sourceName << '=' << binding.localName;
+    }
+    close();
+  }
+
+  void visit(EnumDecl &node) override {
+    open("Enum", node);
+    topLevel(node);
+    out_ << ' ' << node.name_;
+    for (const auto &entry : node.entries_) {
+      out_ << ' ' << entry.name_ << (entry.hasExplicitValue_ ? "=" : "~")
+           << entry.value_;
+      this->node(entry.payloadType_.get());
+    }
+    close();
+  }
+
+  void visit(StructDeclarationNode &node) override {
+    open("Struct", node);
+    topLevel(node);
+    out_ << ' ' << node.name_ << ' ' << node.isUnsafe_;
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    nodes(node.fields_);
+    close();
+  }
+
+  void visit(ClassDecl &node) override {
+    open("Class", node);
+    topLevel(node);
+    out_ << ' ' << node.name_;
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    this->node(node.baseType_.get());
+    nodes(node.fields_);
+    nodes(node.methods_);
+    close();
+  }
+
+  void visit(FunDecl &node) override {
+    open("Fun", node);
+    topLevel(node);
+    out_ << ' ' << node.name_ << ' ' << node.isExtern_ << node.isStatic_
+         << node.isUnsafe_ << node.returnsRef_ << ' '
+         << node.resultBorrowSource_.value_or("-");
+    nodes(node.genericParams_);
+    constraints(node.genericConstraints_);
+    nodes(node.params_);
+    this->node(node.returnType_.get());
+    this->node(node.body_.get());
+    this->node(node.lambdaExpr_.get());
+    close();
+  }
+
+  void visit(ParameterNode &node) override {
+    open("Param", node);
+    out_ << ' ' << node.name << ' ' << node.isRef << node.isSink
+         << node.isNoEscape << node.isVariadic << ' '
+         << static_cast<int>(node.visibility_);
+    this->node(node.type.get());
+    this->node(node.defaultValue.get());
+    close();
+  }
+
+  void visit(TypeNode &node) override {
+    open("Type", node);
+    out_ << ' ' << node.qualifiedName() << ' ' << node.isReference
+         << node.isPointer << node.isArray << node.isVarArgs << node.isWeak
+         << node.isFailable << node.isFunPtr << node.funPtrReturnsRef << ' '
+         << node.funPtrResultBorrowSource.value_or("-");
+    for (bool sink : node.funPtrParamSinks) {
+      out_ << " sink" << sink;
+    }
+    for (bool noEscape : node.funPtrParamNoEscapes) {
+      out_ << " noescape" << noEscape;
+    }
+    nodes(node.genericArgs);
+    this->node(node.defaultType.get());
+    nodes(node.funPtrParams);
+    this->node(node.funPtrReturn.get());
+    this->node(node.errorType.get());
+    this->node(node.arraySize.get());
+    this->node(node.baseType.get());
+    close();
+  }
+
+  void visit(BodyNode &node) override {
+    open("Body", node);
+    nodes(node.statements);
+    this->node(node.result.get());
+    close();
+  }
+
+  void visit(BindingDecl &node) override {
+    open("Binding", node);
+    topLevel(node);
+    out_ << ' ' << node.name_ << ' ' << static_cast<int>(node.kind_) << ' '
+         << node.isGlobal_ << node.isExternal_;
+    this->node(node.type_.get());
+    this->node(node.initializer_.get());
+    close();
+  }
+
+  void visit(ReturnNode &node) override {
+    open("Return", node);
+    this->node(node.returnValue.get());
+    close();
+  }
+
+  void visit(IfNode &node) override {
+    open("If", node);
+    this->node(node.condition_.get());
+    this->node(node.thenBody_.get());
+    this->node(node.elseBody_.get());
+    close();
+  }
+
+  void visit(WhileNode &node) override {
+    open("While", node);
+    this->node(node.condition_.get());
+    this->node(node.body_.get());
+    close();
+  }
+
+  void visit(AssignNode &node) override {
+    open("Assign", node);
+    out_ << ' ' << node.op_;
+    this->node(node.target_.get());
+    this->node(node.expr_.get());
+    close();
+  }
+
+  void visit(BinExpr &node) override {
+    open("Bin", node);
+    out_ << ' ' << node.op_;
+    this->node(node.left_.get());
+    this->node(node.right_.get());
+    close();
+  }
+
+  void visit(UnaryExpr &node) override {
+    open("Unary", node);
+    out_ << ' ' << node.op_;
+    this->node(node.expr_.get());
+    close();
+  }
+
+  void visit(CastExpr &node) override {
+    open("Cast", node);
+    this->node(node.expr_.get());
+    this->node(node.type_.get());
+    close();
+  }
+
+  void visit(MemberAccessNode &node) override {
+    open("Member", node);
+    out_ << ' ' << node.member_;
+    this->node(node.left_.get());
+    close();
+  }
+
+  void visit(IndexAccessNode &node) override {
+    open("Index", node);
+    this->node(node.left_.get());
+    this->node(node.index_.get());
+    close();
+  }
+
+  void visit(FunCall &node) override {
+    open("Call", node);
+    this->node(node.callee_.get());
+    nodes(node.genericArgs_);
+    arguments(node.params_);
+    close();
+  }
+
+  void visit(NewExpr &node) override {
+    open("New", node);
+    this->node(node.type_.get());
+    arguments(node.args_);
+    close();
+  }
+
+  void visit(StructLiteralNode &node) override {
+    open("StructLiteral", node);
+    this->node(node.type_.get());
+    for (const auto &field : node.fields_) {
+      out_ << ' ' << field.name;
+      this->node(field.value.get());
+    }
+    close();
+  }
+
+  void visit(ConstInt &node) override {
+    open("Int", node);
+    out_ << ' ' << node.value_ << ' ' << node.has_value_i64_ << ' '
+         << node.value_i64_ << ' ' << node.typeName_;
+    close();
+  }
+
+  void visit(ConstFloat &node) override {
+    open("Float", node);
+    out_ << ' ' << std::hexfloat << node.value_ << std::defaultfloat;
+    close();
+  }
+
+  void visit(ConstString &node) override {
+    open("String", node);
+    out_ << ' ' << node.value_;
+    close();
+  }
+
+  void visit(ConstChar &node) override {
+    open("Char", node);
+    out_ << ' ' << node.value_;
+    close();
+  }
+
+  void visit(ConstId &node) override {
+    open("Id", node);
+    out_ << ' ' << node.value_;
+    close();
+  }
+
+private:
+  std::ostringstream out_;
+  bool failed_ = false;
+
+  void span(const SourceSpan &span) {
+    out_ << ' ' << span.line << ':' << span.column << '@' << span.offset
+         << '+' << span.length << ' ' << span.sourceName();
+  }
+
+  void open(const char *kind, const Node &node) {
+    out_ << " (" << kind;
+    span(node.span);
+  }
+
+  void close() { out_ << ')'; }
+
+  template <typename T>
+  void nodes(const std::vector<std::unique_ptr<T>> &values) {
+    out_ << " [";
+    for (const auto &value : values) {
+      node(value.get());
+    }
+    out_ << " ]";
+  }
+
+  void topLevel(const TopLevel &declaration) {
+    out_ << ' ' << static_cast<int>(declaration.visibility_);
+    for (const auto &attribute : declaration.attributes_) {
+      out_ << " @" << attribute.name;
+      span(attribute.span);
+      for (const auto &argument : attribute.arguments) {
+        out_ << ' ' << static_cast<int>(argument.kind) << argument.name;
+        node(argument.value.get());
+      }
+    }
+  }
+
+  void constraints(const std::vector<GenericConstraint> &values) {
+    for (const auto &constraint : values) {
+      out_ << ' ' << constraint.parameterName << ':';
+      node(constraint.boundType.get());
+    }
+  }
+
+  void arguments(const std::vector<std::unique_ptr<Argument>> &values) {
+    out_ << " [";
+    for (const auto &argument : values) {
+      out_ << ' ' << argument->name << ' ' << argument->isRef
+           << argument->isSpread;
+      node(argument->value.get());
+    }
+    out_ << " ]";
+  }
+};
+
+std::string dump(RootNode &root) {
+  TreeDump dump;
+  dump.node(&root);
+  require(!dump.failed(), "test source has a node the dump does not know");
+  return dump.text();
+}
+
+std::filesystem::path onlyEntry(const std::filesystem::path &directory) {
+  std::filesystem::path entry;
+  for (const auto &file : std::filesystem::directory_iterator(directory)) {
+    require(entry.empty(), "cache holds more than one entry");
+    entry = file.path();
+  }
+  require(entry.extension() == ".zmi", "cache entry is not a .zmi file");
+  return entry;
+}
+
+} // namespace
+
+int main() {
+  using zap::frontend::ModuleCache;
+
+  TemporaryDirectory temporary;
+  const auto original = parse(source);
+  ModuleCache cache(temporary.path / "first", "zapc 1", 64);
+  require(!cache.load(source, sourceName), "empty cache returned a module");
+  cache.store(source, sourceName, *original);
+  const auto entry = onlyEntry(cache.directory());
+
+  auto loaded = cache.load(source, sourceName);
+  require(loaded != nullptr, "stored module was not loaded back");
+  require(loaded->children.size() == original->children.size(),
+          "loaded module has a different number of declarations");
+  require(loaded->children.back()->span.sourceName() == sourceName,
+          "loaded spans lost their source name");
+  require(dump(*loaded) == dump(*parse(source)),
+          "loaded module differs from a fresh parse");
+
+  // Storing the loaded tree again must reproduce the entry byte for byte,
+  // so the writer and the reader agree on the format.
+  ModuleCache copy(temporary.path / "second", "zapc 1", 64);
+  copy.store(source, sourceName, *loaded);
+  require(readFile(onlyEntry(copy.directory())) == readFile(entry),
+          "module did not survive a round trip through the cache");
+
+  require(!cache.load(std::string(source) + "\n", sourceName),
+          "edited source hit the cache");
+  require(!ModuleCache(cache.directory(), "zapc 2", 64)
+               .load(source, sourceName),
+          "another compiler hit the cache");
+  require(!ModuleCache(cache.directory(), "zapc 1", 32)
+               .load(source, sourceName),
+          "another word size hit the cache");
+
+  const auto contents = readFile(entry);
+  std::ofstream(entry, std::ios::binary | std::ios::trunc)
+      << contents.substr(0, contents.size() / 2);
+  require(!cache.load(source, sourceName), "truncated entry was loaded");
+  return 0;
+}
@@ -24,6 +24,7 @@ using zir::Register;
 using zir::ReturnInst;
 using zir::Type;
 using zir::TypeKind;
+using zir::ValueId;
 using zir::ValueOwnership;
 using zir::VerificationErrorCode;
 using zir::ZirVerifier;
@@ -32,9 +33,9 @@ std::shared_ptr<Type> primitive(TypeKind kind) {
   return std::make_shared<PrimitiveType>(kind);
 }
 
-std::shared_ptr<Register> reg(const std::string &name,
-                              const std::shared_ptr<Type> &type) {
-  return std::make_shared<Register>(name, type);
+ValueId reg(Function &function, const std::string &name,
+            const std::shared_ptr<Type> &type) {
+  return function.values.add<Register>(name, type);
 }
 
 bool expect(bool condition, const std::string &message) {
@@ -54,16 +55,15 @@ bool hasError(const zir::VerificationResult &result,
   return false;
 }
 
-std::shared_ptr<zir::Argument>
-addOwnedArgument(Function &function, const std::shared_ptr<Type> &type) {
-  auto value = std::make_shared<zir::Argument>("value", type);
-  value->setOwnership(ValueOwnership::Owned);
+ValueId addOwnedArgument(Function &function,
+                         const std::shared_ptr<Type> &type) {
+  auto value = function.values.add<zir::Argument>("value", type);
+  function.getValue(value)->setOwnership(ValueOwnership::Owned);
   function.arguments.push_back(value);
   return value;
 }
 
-bool hasDestroyBeforeReturn(const BasicBlock &block,
-                            const std::shared_ptr<zir::Value> &value) {
+bool hasDestroyBeforeReturn(const BasicBlock &block, ValueId value) {
   const auto &instructions = block.getInstructions();
   return instructions.size() == 2 &&
          instructions.front()->getOpCode() == OpCode::Destroy &&
@@ -73,7 +73,7 @@ bool hasDestroyBeforeReturn(const BasicBlock &block,
 }
 
 bool hasDestroyEdgeTo(const Function &function, const std::string &destination,
-                      const std::shared_ptr<zir::Value> &value) {
+                      ValueId value) {
   for (const auto &block : function.getBlocks()) {
     if (!block) {
       continue;
@@ -105,11 +105,12 @@ bool testLoopExitClosesOwnershipForZeroOneOrManyIterations() {
   entry->addInstruction(std::make_unique<BranchInst>("header"));
   auto header = std::make_unique<BasicBlock>("header");
   header->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "body", "exit"));
+      function->values.add<Constant>("true", boolean), "body", "exit"));
   auto body = std::make_unique<BasicBlock>("body");
-  auto comparison = reg("comparison", boolean);
+  auto comparison = reg(*function, "comparison", boolean);
   body->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, value, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, value,
+      function->values.add<Constant>("null", classType)));
   body->addInstruction(std::make_unique<BranchInst>("header"));
   auto exit = std::make_unique<BasicBlock>("exit");
   exit->addInstruction(std::make_unique<ReturnInst>());
@@ -140,19 +141,19 @@ bool testLoopBackEdgePhiTransfersOwnership() {
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<BranchInst>("header"));
   auto header = std::make_unique<BasicBlock>("header");
-  auto current = reg("current", classType);
-  current->setOwnership(ValueOwnership::Owned);
+  auto current = reg(*function, "current", classType);
+  function->getValue(current)->setOwnership(ValueOwnership::Owned);
   header->addInstruction(std::make_unique<PhiInst>(
       current,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      std::vector<std::pair<std::string, ValueId>>{
           {"entry", initial}, {"body", current}}));
   header->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "body", "exit"));
+      function->values.add<Constant>("true", boolean), "body", "exit"));
   auto body = std::make_unique<BasicBlock>("body");
-  auto comparison = reg("comparison", boolean);
+  auto comparison = reg(*function, "comparison", boolean);
   body->addInstruction(std::make_unique<CmpInst>(
       "eq", comparison, current,
-      std::make_shared<Constant>("null", classType)));
+      function->values.add<Constant>("null", classType)));
   body->addInstruction(std::make_unique<BranchInst>("header"));
   auto exit = std::make_unique<BasicBlock>("exit");
   exit->addInstruction(std::make_unique<ReturnInst>());
@@ -184,10 +185,10 @@ bool testBreakAndContinuePathsShareOneOwnershipClosure() {
   entry->addInstruction(std::make_unique<BranchInst>("header"));
   auto header = std::make_unique<BasicBlock>("header");
   header->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "body", "exit"));
+      function->values.add<Constant>("true", boolean), "body", "exit"));
   auto body = std::make_unique<BasicBlock>("body");
   body->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "continue", "break"));
+      function->values.add<Constant>("true", boolean), "continue", "break"));
   auto continueBlock = std::make_unique<BasicBlock>("continue");
   continueBlock->addInstruction(std::make_unique<BranchInst>("header"));
   auto breakBlock = std::make_unique<BasicBlock>("break");
@@ -221,8 +222,8 @@ bool testUnreachableOwnershipDoesNotAffectReachableCleanup() {
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<ReturnInst>());
   auto unreachable = std::make_unique<BasicBlock>("unreachable");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   unreachable->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   unreachable->addInstruction(std::make_unique<ReturnInst>());
 
@@ -251,11 +252,11 @@ bool testNestedDiamondClosesOwnershipExactlyOnce() {
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "outer.left",
+      function->values.add<Constant>("true", boolean), "outer.left",
       "outer.right"));
   auto outerLeft = std::make_unique<BasicBlock>("outer.left");
   outerLeft->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "inner.left",
+      function->values.add<Constant>("true", boolean), "inner.left",
       "inner.right"));
   auto innerLeft = std::make_unique<BasicBlock>("inner.left");
   innerLeft->addInstruction(std::make_unique<BranchInst>("merge"));
@@ -289,29 +290,30 @@ bool testUsedMixedOwnershipPhiIsRejected() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto owned = std::make_shared<zir::Argument>("owned", classType);
-  owned->setOwnership(ValueOwnership::Owned);
-  auto borrowed = std::make_shared<zir::Argument>("borrowed", classType);
+  auto owned = function->values.add<zir::Argument>("owned", classType);
+  function->getValue(owned)->setOwnership(ValueOwnership::Owned);
+  auto borrowed = function->values.add<zir::Argument>("borrowed", classType);
   function->arguments.push_back(owned);
   function->arguments.push_back(borrowed);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "owned.path",
+      function->values.add<Constant>("true", boolean), "owned.path",
       "borrowed.path"));
   auto ownedPath = std::make_unique<BasicBlock>("owned.path");
   ownedPath->addInstruction(std::make_unique<BranchInst>("merge"));
   auto borrowedPath = std::make_unique<BasicBlock>("borrowed.path");
   borrowedPath->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", classType);
+  auto result = reg(*function, "result", classType);
   merge->addInstruction(std::make_unique<PhiInst>(
       result,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      std::vector<std::pair<std::string, ValueId>>{
           {"owned.path", owned}, {"borrowed.path", borrowed}}));
-  auto comparison = reg("comparison", boolean);
+  auto comparison = reg(*function, "comparison", boolean);
   merge->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, result, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, result,
+      function->values.add<Constant>("null", classType)));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
   function->addBlock(std::move(entry));
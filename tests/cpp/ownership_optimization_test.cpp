@@ -0,0 +1,182 @@
+#include "ir/ownership_lowering.hpp"
+#include "ir/ownership_optimization.hpp"
+#include "ir/zir_verifier.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using zir::BasicBlock;
+using zir::ClassType;
+using zir::CmpInst;
+using zir::CondBranchInst;
+using zir::Constant;
+using zir::CopyInst;
+using zir::Function;
+using zir::Module;
+using zir::OpCode;
+using zir::PrimitiveType;
+using zir::Register;
+using zir::ReturnInst;
+using zir::Type;
+using zir::TypeKind;
+using zir::ValueId;
+using zir::ValueOwnership;
+using zir::ZirVerifier;
+
+std::shared_ptr<Type> primitive(TypeKind kind) {
+  return std::make_shared<PrimitiveType>(kind);
+}
+
+bool expect(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << "FAIL: " << message << '\n';
+  }
+  return condition;
+}
+
+ValueId addArgument(Function &function, const std::shared_ptr<Type> &type,
+                    ValueOwnership ownership) {
+  auto value = function.values.add<zir::Argument>("value", type);
+  function.getValue(value)->setOwnership(ownership);
+  function.arguments.push_back(value);
+  return value;
+}
+
+ValueId ownedCopy(Function &function, const std::shared_ptr<Type> &type) {
+  auto copy = function.values.add<Register>("copy", type);
+  function.getValue(copy)->setOwnership(ValueOwnership::Owned);
+  return copy;
+}
+
+size_t countOpCode(const Function &function, OpCode opcode) {
+  size_t count = 0;
+  for (const auto &block : function.getBlocks()) {
+    for (const auto &instruction : block->getInstructions()) {
+      if (instruction && instruction->getOpCode() == opcode) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+bool isValid(const Module &module) {
+  return ZirVerifier().verify(module).ok() &&
+         ZirVerifier().verifyOwnershipObligations(module).ok();
+}
+
+bool testLastUseCopyBecomesMove() {
+  Module module("ownership-last-use-copy");
+  auto classType = std::make_shared<ClassType>("Node");
+  auto function = std::make_unique<Function>("forward", classType);
+  auto value = addArgument(*function, classType, ValueOwnership::Owned);
+
+  auto entry = std::make_unique<BasicBlock>("entry");
+  auto copy = ownedCopy(*function, classType);
+  entry->addInstruction(std::make_unique<CopyInst>(copy, value));
+  entry->addInstruction(std::make_unique<ReturnInst>(copy));
+  function->addBlock(std::move(entry));
+  module.addFunction(std::move(function));
+
+  zir::lowerDeadOwnedResults(module);
+  zir::optimizeOwnershipOperations(module);
+  const auto &optimized = *module.getFunctions().front();
+  return expect(countOpCode(optimized, OpCode::Copy) == 0 &&
+                    countOpCode(optimized, OpCode::Move) == 1 &&
+                    countOpCode(optimized, OpCode::Destroy) == 0,
+                "last-use copy was not turned into a move") &&
+         expect(isValid(module), "last-use move produced invalid ZIR");
+}
+
+bool testCopyPairsWithDestroysOnEveryEdge() {
+  Module module("ownership-edge-copy");
+  auto classType = std::make_shared<ClassType>("Node");
+  auto boolean = primitive(TypeKind::Bool);
+  auto function = std::make_unique<Function>("branch", classType);
+  auto value = addArgument(*function, classType, ValueOwnership::Owned);
+
+  auto entry = std::make_unique<BasicBlock>("entry");
+  auto copy = ownedCopy(*function, classType);
+  entry->addInstruction(std::make_unique<CopyInst>(copy, value));
+  entry->addInstruction(std::make_unique<CondBranchInst>(
+      function->values.add<Constant>("true", boolean), "left", "right"));
+  auto left = std::make_unique<BasicBlock>("left");
+  left->addInstruction(std::make_unique<ReturnInst>(copy));
+  auto right = std::make_unique<BasicBlock>("right");
+  right->addInstruction(std::make_unique<ReturnInst>(copy));
+  function->addBlock(std::move(entry));
+  function->addBlock(std::move(left));
+  function->addBlock(std::move(right));
+  module.addFunction(std::move(function));
+
+  zir::lowerDeadOwnedResults(module);
+  zir::optimizeOwnershipOperations(module);
+  const auto &optimized = *module.getFunctions().front();
+  return expect(countOpCode(optimized, OpCode::Copy) == 0 &&
+                    countOpCode(optimized, OpCode::Destroy) == 0,
+                "copy was not paired with the destroys on both edges") &&
+         expect(isValid(module), "edge-paired move produced invalid ZIR");
+}
+
+bool testCopyBeforeLaterUseIsKept() {
+  Module module("ownership-live-copy");
+  auto classType = std::make_shared<ClassType>("Node");
+  auto boolean = primitive(TypeKind::Bool);
+  auto function = std::make_unique<Function>("keep", classType);
+  auto value = addArgument(*function, classType, ValueOwnership::Owned);
+
+  auto entry = std::make_unique<BasicBlock>("entry");
+  auto copy = ownedCopy(*function, classType);
+  entry->addInstruction(std::make_unique<CopyInst>(copy, value));
+  entry->addInstruction(std::make_unique<CmpInst>(
+      "eq", function->values.add<Register>("comparison", boolean), value,
+      function->values.add<Constant>("null", classType)));
+  entry->addInstruction(std::make_unique<ReturnInst>(copy));
+  function->addBlock(std::move(entry));
+  module.addFunction(std::move(function));
+
+  zir::lowerDeadOwnedResults(module);
+  zir::optimizeOwnershipOperations(module);
+  const auto &optimized = *module.getFunctions().front();
+  return expect(countOpCode(optimized, OpCode::Copy) == 1 &&
+                    countOpCode(optimized, OpCode::Destroy) == 1,
+                "copy of a value read afterwards was rewritten") &&
+         expect(isValid(module), "kept copy produced invalid ZIR");
+}
+
+bool testDeadCopyIsRemoved() {
+  Module module("ownership-dead-copy");
+  auto classType = std::make_shared<ClassType>("Node");
+  auto function =
+      std::make_unique<Function>("discard", primitive(TypeKind::Void));
+  auto value = addArgument(*function, classType, ValueOwnership::Borrowed);
+
+  auto entry = std::make_unique<BasicBlock>("entry");
+  entry->addInstruction(
+      std::make_unique<CopyInst>(ownedCopy(*function, classType), value));
+  entry->addInstruction(std::make_unique<ReturnInst>());
+  function->addBlock(std::move(entry));
+  module.addFunction(std::move(function));
+
+  zir::lowerDeadOwnedResults(module);
+  zir::optimizeOwnershipOperations(module);
+  const auto &optimized = *module.getFunctions().front();
+  return expect(optimized.getBlocks().front()->getInstructions().size() == 1,
+                "copy that was only destroyed was kept") &&
+         expect(isValid(module), "dead copy removal produced invalid ZIR");
+}
+
+} // namespace
+
+int main() {
+  bool ok = true;
+  ok = testLastUseCopyBecomesMove() && ok;
+  ok = testCopyPairsWithDestroysOnEveryEdge() && ok;
+  ok = testCopyBeforeLaterUseIsKept() && ok;
+  ok = testDeadCopyIsRemoved() && ok;
+  return ok ? 0 : 1;
+}
@@ -1,10 +1,16 @@
+#include "runtime/allocation_internal.h"
 #include "runtime/arc_layout.h"
+#include "runtime/string_hash.h"
+#include "runtime/string_internal.h"
 
 #include <stddef.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 typedef struct test_object_t {
@@ -48,22 +54,21 @@ static int expect(int condition, const char *message) {
   return condition;
 }
 
-static test_object_t *make_test_object(const zap_arc_metadata_t *metadata) {
+static test_object_t *make_test_object(const zap_arc_type_t *type) {
   test_object_t *object = (test_object_t *)calloc(1, sizeof(test_object_t));
   if (!object) {
     return NULL;
   }
   object->header.strong_count = 1;
   object->header.alive = 1;
-  object->header.destroy_fn = test_destroy;
-  object->header.metadata = metadata;
+  object->header.type = type;
   return object;
 }
 
 static int test_direct_events_and_allocation(void) {
   zap_runtime_ownership_reset_counters();
   void *allocation = zap_runtime_alloc(1);
-  free(allocation);
+  zap_runtime_block_free(allocation);
   zap_runtime_ownership_note_strong_retain();
   zap_runtime_ownership_note_strong_release();
   zap_runtime_ownership_note_copy();
@@ -85,11 +90,11 @@ static int test_direct_events_and_allocation(void) {
 }
 
 static int test_cycle_collection_events(void) {
-  static const zap_arc_metadata_t metadata = {trace_child};
-  test_object_t *first = make_test_object(&metadata);
-  test_object_t *second = make_test_object(&metadata);
-  reentrant_first = make_test_object(&metadata);
-  reentrant_second = make_test_object(&metadata);
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
+  test_object_t *first = make_test_object(&type);
+  test_object_t *second = make_test_object(&type);
+  reentrant_first = make_test_object(&type);
+  reentrant_second = make_test_object(&type);
   if (!expect(first != NULL && second != NULL && reentrant_first != NULL &&
                   reentrant_second != NULL,
               "failed to allocate cycle test objects")) {
@@ -174,15 +179,15 @@ static int test_retain_dead_object_fails(void) {
 }
 
 static int test_scratch_allocation_oom_fails(void) {
-  static const zap_arc_metadata_t metadata = {trace_child};
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
   pid_t child = fork();
   if (child < 0) {
     return expect(0, "failed to fork scratch-allocation OOM test");
   }
   if (child == 0) {
     zap_arc_runtime_context_t *context = zap_arc_context_create();
-    test_object_t *first = make_test_object(&metadata);
-    test_object_t *second = make_test_object(&metadata);
+    test_object_t *first = make_test_object(&type);
+    test_object_t *second = make_test_object(&type);
     if (!context || !first || !second) {
       _exit(2);
     }
@@ -204,9 +209,9 @@ static int test_scratch_allocation_oom_fails(void) {
 }
 
 static int test_removed_root_frees_collection_budget(void) {
-  static const zap_arc_metadata_t metadata = {trace_child};
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
   zap_arc_runtime_context_t *context = zap_arc_context_create();
-  test_object_t *removed = make_test_object(&metadata);
+  test_object_t *removed = make_test_object(&type);
   if (!expect(context && removed,
               "failed to allocate root-removal test objects")) {
     zap_arc_context_destroy(context);
@@ -232,13 +237,13 @@ static int test_removed_root_frees_collection_budget(void) {
 }
 
 static int test_context_isolation(void) {
-  static const zap_arc_metadata_t metadata = {trace_child};
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
   zap_arc_runtime_context_t *first_context = zap_arc_context_create();
   zap_arc_runtime_context_t *second_context = zap_arc_context_create();
-  test_object_t *first_a = make_test_object(&metadata);
-  test_object_t *first_b = make_test_object(&metadata);
-  test_object_t *second_a = make_test_object(&metadata);
-  test_object_t *second_b = make_test_object(&metadata);
+  test_object_t *first_a = make_test_object(&type);
+  test_object_t *first_b = make_test_object(&type);
+  test_object_t *second_a = make_test_object(&type);
+  test_object_t *second_b = make_test_object(&type);
   if (!expect(first_context && second_context && first_a && first_b &&
                   second_a && second_b,
               "failed to allocate isolated collector contexts")) {
@@ -293,7 +298,7 @@ static int test_context_isolation(void) {
   zap_arc_context_destroy(second_context);
 
   zap_arc_runtime_context_t *abandoned_context = zap_arc_context_create();
-  test_object_t *abandoned = make_test_object(&metadata);
+  test_object_t *abandoned = make_test_object(&type);
   if (!expect(abandoned_context && abandoned,
               "failed to allocate context cleanup test")) {
     zap_arc_context_destroy(abandoned_context);
@@ -309,12 +314,454 @@ static int test_context_isolation(void) {
   return passed;
 }
 
-int main(void) {
+static int make_ring(test_object_t **ring, size_t count,
+                     const zap_arc_type_t *type) {
+  for (size_t i = 0; i < count; ++i) {
+    ring[i] = make_test_object(type);
+    if (!ring[i]) {
+      for (size_t j = 0; j < i; ++j) {
+        free(ring[j]);
+      }
+      return 0;
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ring[i]->child = ring[(i + 1) % count];
+  }
+  return 1;
+}
+
+static int test_budgeted_collection_spans_safepoints(void) {
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
+  enum { RING_SIZE = 8 };
+  zap_arc_runtime_context_t *context = zap_arc_context_create();
+  test_object_t *ring[RING_SIZE];
+  if (!expect(context && make_ring(ring, RING_SIZE, &type),
+              "failed to allocate budgeted collection test")) {
+    zap_arc_context_destroy(context);
+    return 0;
+  }
+
+  destroy_count = 0;
+  schedule_reentrant_collection = 0;
+  runtime_context = NULL;
+  zap_arc_set_collection_budget(context, 2, 0);
+  zap_runtime_ownership_reset_counters();
+  zap_arc_add_possible_root(context, ring[0]);
+  int safepoints = 0;
+  while (destroy_count == 0 && safepoints < 100) {
+    zap_arc_collect_at_safepoint(context);
+    ++safepoints;
+  }
+
+  zap_runtime_ownership_counters_t counters = {0};
+  zap_runtime_ownership_snapshot_counters(&counters);
+  uint64_t histogram_total = 0;
+  for (size_t i = 0; i < ZAP_ARC_PAUSE_HISTOGRAM_BUCKETS; ++i) {
+    histogram_total += counters.pause_histogram[i];
+  }
+  int passed =
+      expect(safepoints > 1,
+             "budgeted collection finished within one safe point") &&
+      expect(destroy_count == RING_SIZE,
+             "budgeted collection did not reclaim the whole cycle") &&
+      expect(counters.collection_runs == 1,
+             "budgeted collection restarted between safe points") &&
+      expect(counters.collection_slices == (uint64_t)safepoints,
+             "collector pauses were not counted per safe point") &&
+      expect(histogram_total == counters.collection_slices,
+             "pause histogram does not cover every collector pause") &&
+      expect(counters.pause_nanoseconds_max <=
+                 counters.pause_nanoseconds_total,
+             "longest collector pause exceeds the total");
+  zap_arc_context_destroy(context);
+  return passed;
+}
+
+static int test_budgeted_collection_sees_program_changes(void) {
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
+  enum { RING_SIZE = 4 };
+  int passed = 1;
+  // Move the program's only reference into the cycle after every possible
+  // amount of collector progress.
+  for (int pause = 0; passed && pause < 16; ++pause) {
+    zap_arc_runtime_context_t *context = zap_arc_context_create();
+    test_object_t *ring[RING_SIZE];
+    if (!expect(context && make_ring(ring, RING_SIZE, &type),
+                "failed to allocate program-change collection test")) {
+      zap_arc_context_destroy(context);
+      return 0;
+    }
+    destroy_count = 0;
+    schedule_reentrant_collection = 0;
+    ring[RING_SIZE - 1]->header.strong_count = 2;
+    zap_arc_set_collection_budget(context, 1, 0);
+    zap_arc_add_possible_root(context, ring[0]);
+    for (int i = 0; i < pause; ++i) {
+      zap_arc_collect_at_safepoint(context);
+    }
+    ring[RING_SIZE - 1]->header.strong_count = 1;
+    ring[0]->header.strong_count = 2;
+    for (int i = 0; i < 100; ++i) {
+      zap_arc_collect_at_safepoint(context);
+    }
+    passed = expect(destroy_count == 0,
+                    "budgeted collection reclaimed a referenced cycle");
+
+    ring[0]->header.strong_count = 1;
+    zap_arc_add_possible_root(context, ring[0]);
+    zap_arc_cycle_collect(context);
+    passed = passed && expect(destroy_count == RING_SIZE,
+                              "released cycle was not reclaimed");
+    zap_arc_context_destroy(context);
+  }
+  return passed;
+}
+
+static int test_budgeted_collection_defers_deallocation(void) {
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
+  zap_arc_runtime_context_t *context = zap_arc_context_create();
+  test_object_t *parent = make_test_object(&type);
+  test_object_t *child = make_test_object(&type);
+  if (!expect(context && parent && child,
+              "failed to allocate deferred deallocation test")) {
+    zap_arc_context_destroy(context);
+    free(parent);
+    free(child);
+    return 0;
+  }
+  parent->header.strong_count = 2;
+  parent->child = child;
+  destroy_count = 0;
+  schedule_reentrant_collection = 0;
+  zap_arc_set_collection_budget(context, 1, 0);
+  zap_arc_add_possible_root(context, parent);
+  zap_arc_collect_at_safepoint(context);
+
+  // The program drops the child while the collector still indexes it.
+  parent->child = NULL;
+  child->header.strong_count = 0;
+  test_destroy(child);
+  zap_arc_deallocate(context, child);
+  int passed = expect(child->header.gc_mark & ZAP_ARC_GC_DEALLOCATE_PENDING,
+                      "tracked object was freed during a collection");
+  for (int i = 0; i < 100; ++i) {
+    zap_arc_collect_at_safepoint(context);
+  }
+  passed = passed &&
+           expect(destroy_count == 1,
+                  "collection destroyed a referenced object") &&
+           expect(parent->header.alive &&
+                      !(parent->header.gc_mark & ZAP_ARC_GC_TRACKED),
+                  "finished collection left its objects tracked");
+  zap_arc_context_destroy(context);
+  free(parent);
+  return passed;
+}
+
+static int test_root_threshold_adapts_to_live_graph(void) {
+  static const zap_arc_type_t type = {NULL, test_destroy, trace_child};
+  enum { CHAIN_LENGTH = 640 };
+  zap_arc_runtime_context_t *context = zap_arc_context_create();
+  test_object_t *chain[CHAIN_LENGTH];
+  test_object_t *self_cycle = make_test_object(&type);
+  size_t allocated = 0;
+  while (allocated < CHAIN_LENGTH &&
+         (chain[allocated] = make_test_object(&type)) != NULL) {
+    ++allocated;
+  }
+  if (!expect(context && self_cycle && allocated == CHAIN_LENGTH,
+              "failed to allocate adaptive threshold test")) {
+    zap_arc_context_destroy(context);
+    free(self_cycle);
+    for (size_t i = 0; i < allocated; ++i) {
+      free(chain[i]);
+    }
+    return 0;
+  }
+  for (size_t i = 0; i + 1 < CHAIN_LENGTH; ++i) {
+    chain[i]->child = chain[i + 1];
+  }
+  chain[0]->header.strong_count = 2;
+  self_cycle->child = self_cycle;
+  destroy_count = 0;
+  schedule_reentrant_collection = 0;
+  zap_arc_set_collection_budget(context, 1u << 20, 0);
+
+  // Tracing a large live graph raises the threshold ...
+  zap_arc_add_possible_root(context, chain[0]);
+  zap_arc_collect_at_safepoint(context);
+  zap_arc_add_possible_root(context, self_cycle);
+  zap_arc_collect_at_safepoint(context);
+  int passed = expect(destroy_count == 0,
+                      "a lone root was collected despite a raised threshold");
+  // ... but a lone self-cycle is still reclaimed after a bounded wait.
+  int safepoints = 1;
+  while (destroy_count == 0 && safepoints < 100) {
+    zap_arc_collect_at_safepoint(context);
+    ++safepoints;
+  }
+  passed = passed && expect(destroy_count == 1,
+                            "adaptive threshold postponed a self-cycle");
+  zap_arc_context_destroy(context);
+  for (size_t i = 0; i < allocated; ++i) {
+    free(chain[i]);
+  }
+  return passed;
+}
+
+static int test_string_hash_is_cached_and_content_based(void) {
+  static const char text[] = "the quick brown fox jumps over the lazy dog";
+  zap_string_t first = zap_string_from_cstr(text);
+  zap_string_t second = zap_string_from_ptrlen(text, (long)strlen(text));
+  zap_string_t other =
+      zap_string_from_cstr("the quick brown fox jumps over the lazy cat");
+  if (!expect(first.ptr && second.ptr && other.ptr,
+              "failed to allocate hash test strings")) {
+    return 0;
+  }
+
+  const zap_string_header_t *header =
+      (const zap_string_header_t *)(first.ptr - sizeof(zap_string_header_t));
+  int passed =
+      expect(header->hash == ZAP_STRING_HASH_UNSET,
+             "fresh string already has a cached hash") &&
+      expect(zap_string_hash(first) == zap_string_hash(second),
+             "equal strings hashed differently") &&
+      expect(header->hash == zap_string_hash_bytes(text, strlen(text)),
+             "string hash was not cached in the header") &&
+      expect(zap_string_hash(first) != zap_string_hash(other),
+             "distinct strings collided") &&
+      expect(zap_string_hash((zap_string_t){.ptr = NULL, .len = 0}) ==
+                 zap_string_hash_bytes("", 0),
+             "empty string hash does not match an empty literal");
+
+  zap_string_release(first);
+  zap_string_release(second);
+  zap_string_release(other);
+  return passed;
+}
+
+static int test_string_buffer_hands_over_storage(void) {
+  char *data = zap_string_buffer_reserve(NULL, 4);
+  memcpy(data, "zap-", 4);
+  data = zap_string_buffer_reserve(data, 64);
+  memcpy(data + 4, "buffer", 6);
+
+  zap_string_t built = zap_string_buffer_finish(data, 10, 64);
+  const zap_string_header_t *header =
+      (const zap_string_header_t *)(built.ptr - sizeof(zap_string_header_t));
+  int passed =
+      expect(built.len == 10 && memcmp(built.ptr, "zap-buffer", 11) == 0,
+             "finished buffer has the wrong contents") &&
+      expect(header->refs == 1 && header->len == 10 &&
+                 header->hash == ZAP_STRING_HASH_UNSET,
+             "finished buffer has a malformed string header");
+  zap_string_release(built);
+
+  zap_string_t empty =
+      zap_string_buffer_finish(zap_string_buffer_reserve(NULL, 8), 0, 8);
+  return passed && expect(empty.ptr == NULL && empty.len == 0,
+                          "empty buffer did not finish as the empty string");
+}
+
+static int test_string_concat_n_allocates_once(void) {
+  char dash = '-';
+  zap_string_t parts[] = {
+      {.ptr = "log", .len = 3},
+      {.ptr = &dash, .len = 1},
+      {.ptr = NULL, .len = 0},
+      {.ptr = "level=", .len = 6},
+      {.ptr = "warn", .len = 4},
+  };
+
+  zap_runtime_ownership_reset_counters();
+  char *joined = zap_string_concat_n(parts, 5);
+  zap_runtime_ownership_counters_t counters = {0};
+  zap_runtime_ownership_snapshot_counters(&counters);
+
+  const zap_string_header_t *header =
+      (const zap_string_header_t *)(joined - sizeof(zap_string_header_t));
+  int passed =
+      expect(memcmp(joined, "log-level=warn", 15) == 0,
+             "n-ary concat has the wrong contents") &&
+      expect(header->refs == 1 && header->len == 14,
+             "n-ary concat has a malformed string header") &&
+      expect(counters.allocations == 1,
+             "n-ary concat allocated more than once");
+  zap_string_release((zap_string_t){.ptr = joined, .len = 14});
+
+  zap_string_t negative[] = {{.ptr = "x", .len = -1}};
+  return passed && expect(zap_string_concat_n(negative, 1) == NULL,
+                          "n-ary concat accepted a negative length");
+}
+
+static int test_single_byte_strings_do_not_allocate(void) {
+  char z = 'z';
+  zap_string_t parts[] = {{.ptr = NULL, .len = 0}, {.ptr = &z, .len = 1}};
+
+  char *buffer = zap_string_buffer_reserve(NULL, 16);
+  buffer[0] = 'b';
+
+  zap_runtime_ownership_reset_counters();
+  char *concat = string_concat_ptrlen(NULL, 0, &z, 1);
+  char *joined = zap_string_concat_n(parts, 2);
+  zap_string_t from_ptr = zap_string_from_ptrlen("q", 1);
+  zap_string_t digit = zap_to_string_i64(7);
+  zap_string_t finished = zap_string_buffer_finish(buffer, 1, 16);
+  zap_runtime_ownership_counters_t counters = {0};
+  zap_runtime_ownership_snapshot_counters(&counters);
+
+  const zap_string_header_t *header =
+      (const zap_string_header_t *)(concat - sizeof(zap_string_header_t));
+  int passed =
+      expect(concat == joined && concat[0] == 'z' && concat[1] == '\0',
+             "single-byte concat did not return the shared string") &&
+      expect(header->refs == ZAP_STRING_IMMORTAL_REFCOUNT && header->len == 1,
+             "single-byte string is not immortal") &&
+      expect(from_ptr.len == 1 && from_ptr.ptr[0] == 'q' && digit.len == 1 &&
+                 digit.ptr[0] == '7' && finished.len == 1 &&
+                 finished.ptr[0] == 'b',
+             "single-byte strings have the wrong contents") &&
+      expect(zap_string_hash(from_ptr) == zap_string_hash_bytes("q", 1),
+             "single-byte string hashes differently") &&
+      expect(counters.allocations == 0,
+             "single-byte strings allocated storage");
+  zap_string_t shared = {.ptr = concat, .len = 1};
+  zap_string_release(zap_string_retain(shared));
+  zap_string_release(shared);
+  return passed &&
+         expect(concat[0] == 'z' &&
+                    header->refs == ZAP_STRING_IMMORTAL_REFCOUNT,
+                "retain/release touched a single-byte string");
+}
+
+static int test_allocation_oom_fails(void) {
+  pid_t child = fork();
+  if (child < 0) {
+    return expect(0, "failed to fork allocation OOM test");
+  }
+  if (child == 0) {
+    zap_runtime_test_fail_next_allocation();
+    (void)zap_runtime_alloc(64);
+    _exit(0);
+  }
+
+  int status = 0;
+  if (waitpid(child, &status, 0) != child) {
+    return expect(0, "failed to wait for allocation OOM test");
+  }
+  return expect(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT,
+                "allocation OOM did not abort");
+}
+
+static int test_pooled_blocks_keep_their_contents(void) {
+  enum { BLOCKS = 4096 };
+  static unsigned char *blocks[BLOCKS];
+  int passed = 1;
+  for (size_t i = 0; i < BLOCKS; ++i) {
+    size_t size = 1 + (i * 37) % 300;
+    blocks[i] = (unsigned char *)zap_runtime_alloc(size);
+    memset(blocks[i], (int)(i & 0xff), size);
+  }
+  for (size_t i = 0; i < BLOCKS; i += 2) {
+    zap_runtime_block_free(blocks[i]);
+    blocks[i] = NULL;
+  }
+  for (size_t i = 1; i < BLOCKS; i += 2) {
+    size_t size = 1 + (i * 37) % 300;
+    blocks[i] = (unsigned char *)zap_runtime_block_realloc(blocks[i], size + 200);
+    for (size_t j = 0; j < size && passed; ++j) {
+      passed = expect(blocks[i][j] == (unsigned char)(i & 0xff),
+                      "pooled block lost its contents");
+    }
+  }
+  for (size_t i = 1; i < BLOCKS; i += 2) {
+    zap_runtime_block_free(blocks[i]);
+  }
+
+  void *first = zap_runtime_alloc(48);
+  zap_runtime_block_free(first);
+  void *second = zap_runtime_alloc(40);
+  zap_runtime_block_free(second);
+#if !defined(ZAP_RUNTIME_SYSTEM_ALLOCATOR) && !defined(__SANITIZE_ADDRESS__)
+  passed = passed && expect(first == second,
+                            "freed block was not reused by its size class");
+#endif
+  return passed;
+}
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Allocation benchmark: a sliding window of live 32-256 byte blocks, the shape
+// of short-lived list nodes, map entries and strings. Each allocator runs in
+// its own child so the reported peak RSS belongs to that allocator alone.
+static void bench_allocator(const char *name, int pooled) {
+  enum { LIVE = 1 << 16, ROUNDS = 64 };
+  fflush(stdout);
+  pid_t child = fork();
+  if (child < 0) {
+    return;
+  }
+  if (child == 0) {
+    void **live = (void **)calloc(LIVE, sizeof(void *));
+    size_t operations = 0;
+    double start = now_seconds();
+    for (size_t round = 0; round < ROUNDS; ++round) {
+      for (size_t i = 0; i < LIVE; ++i) {
+        size_t slot = (i * 7919 + round) % LIVE;
+        size_t size = 32 + ((i + round) * 24) % 225;
+        if (pooled) {
+          zap_runtime_block_free(live[slot]);
+          live[slot] = zap_runtime_alloc(size);
+        } else {
+          free(live[slot]);
+          live[slot] = malloc(size);
+        }
+        *(volatile char *)live[slot] = (char)i;
+        ++operations;
+      }
+    }
+    double elapsed = now_seconds() - start;
+    printf("%-8s %8.2f ns/alloc+free %8.2f Mops/s\n", name,
+           elapsed * 1e9 / (double)operations,
+           (double)operations / elapsed / 1e6);
+    fflush(stdout);
+    _exit(0);
+  }
+
+  int status = 0;
+  struct rusage usage;
+  if (wait4(child, &status, 0, &usage) == child) {
+    printf("%-8s %8ld KiB peak RSS\n", name, usage.ru_maxrss);
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    bench_allocator("malloc", 0);
+    bench_allocator("pool", 1);
+    return 0;
+  }
   return test_direct_events_and_allocation() && test_cycle_collection_events() &&
                  test_retain_dead_object_fails() &&
                  test_scratch_allocation_oom_fails() &&
                  test_removed_root_frees_collection_budget() &&
-                 test_context_isolation()
+                 test_context_isolation() &&
+                 test_budgeted_collection_spans_safepoints() &&
+                 test_budgeted_collection_sees_program_changes() &&
+                 test_budgeted_collection_defers_deallocation() &&
+                 test_root_threshold_adapts_to_live_graph() &&
+                 test_string_hash_is_cached_and_content_based() &&
+                 test_string_buffer_hands_over_storage() &&
+                 test_string_concat_n_allocates_once() &&
+                 test_single_byte_strings_do_not_allocate() &&
+                 test_allocation_oom_fails() &&
+                 test_pooled_blocks_keep_their_contents()
              ? 0
              : 1;
 }
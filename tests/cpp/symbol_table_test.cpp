@@ -0,0 +1,91 @@
+#include "sema/symbol_table.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+bool expect(bool condition, const std::string &message) {
+  if (!condition) {
+    std::cerr << message << '\n';
+  }
+  return condition;
+}
+
+std::shared_ptr<sema::VariableSymbol> variable(const std::string &name) {
+  return std::make_shared<sema::VariableSymbol>(name, nullptr);
+}
+
+bool testAtomsIdentifyNames() {
+  const std::string spelled = "symbol_table_test_name";
+  const sema::Atom atom = sema::internAtom("symbol_table_test_name");
+
+  return expect(atom != sema::NoAtom, "a name was interned as 'NoAtom'") &&
+         expect(sema::internAtom(spelled) == atom,
+                "equal names were interned as different atoms") &&
+         expect(sema::findAtom(spelled) == atom,
+                "findAtom missed an interned name") &&
+         expect(sema::atomName(atom) == spelled,
+                "atomName did not return the interned name") &&
+         expect(sema::findAtom("symbol_table_test_never_interned") ==
+                    sema::NoAtom,
+                "findAtom returned an atom for a name never interned");
+}
+
+bool testAtomMapGrows() {
+  sema::AtomMap<int> map;
+  bool found = map.find(sema::internAtom("grow0")) == nullptr;
+  for (int i = 0; i < 1000; ++i) {
+    map[sema::internAtom("grow" + std::to_string(i))] = i;
+  }
+  for (int i = 0; i < 1000; ++i) {
+    const int *value = map.find(sema::internAtom("grow" + std::to_string(i)));
+    found = found && value && *value == i;
+  }
+
+  sema::AtomMap<int> other;
+  other[sema::internAtom("grow0")] = -1;
+  other[sema::internAtom("extra")] = 7;
+  map.insert(other);
+
+  return expect(found, "a value went missing while the map grew") &&
+         expect(map.size() == 1001, "insert added the wrong number of entries") &&
+         expect(*map.find(sema::internAtom("grow0")) == 0,
+                "insert replaced an entry that was already present") &&
+         expect(map.find(sema::NoAtom) == nullptr,
+                "'NoAtom' was found in a map");
+}
+
+bool testScopesShadowTheirParents() {
+  sema::SymbolTable module;
+  sema::SymbolTable block(&module);
+  sema::SymbolTable inner(&block);
+  auto outer = variable("value");
+  auto shadow = variable("value");
+  module.declare("value", outer);
+  module.declare("other", variable("other"));
+  block.declare("value", shadow);
+
+  return expect(!module.declare("value", variable("value")),
+                "a name was declared twice in one scope") &&
+         expect(inner.lookup("value") == shadow,
+                "lookup did not find the innermost declaration") &&
+         expect(inner.lookup("other") == module.lookup("other"),
+                "lookup did not reach the outermost scope") &&
+         expect(!inner.lookupLocal("value"),
+                "lookupLocal looked past its own scope") &&
+         expect(!inner.lookup("symbol_table_test_undeclared"),
+                "lookup found a name nothing declared") &&
+         expect(inner.getParent() == &block, "the parent was not kept");
+}
+
+} // namespace
+
+int main() {
+  bool ok = true;
+  ok = testAtomsIdentifyNames() && ok;
+  ok = testAtomMapGrows() && ok;
+  ok = testScopesShadowTheirParents() && ok;
+  return ok ? 0 : 1;
+}
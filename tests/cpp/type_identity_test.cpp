@@ -155,10 +155,16 @@ bool testNominalAndQualifiedTypes() {
 
 bool testInternerDeduplicatesIdentity() {
   TypeInterner types;
-  types.intern(primitive(TypeKind::UInt64));
-  types.intern(primitive(TypeKind::UInt64));
-  return expect(types.size() == 1,
-                "interner retained duplicate canonical identities");
+  const auto *first = &types.intern(primitive(TypeKind::UInt64));
+  // Enough other identities to rehash the interner's table.
+  for (uint64_t size = 1; size <= 256; ++size) {
+    types.intern(std::make_shared<ArrayType>(primitive(TypeKind::Int), size));
+  }
+  const auto *second = &types.intern(primitive(TypeKind::UInt64));
+  return expect(types.size() == 257,
+                "interner retained duplicate canonical identities") &&
+         expect(first == second,
+                "equal types did not intern to the same identity object");
 }
 
 bool testSyntheticRecordRolesAreNotNameProtocols() {
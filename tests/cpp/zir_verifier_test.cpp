@@ -29,6 +29,7 @@ using zir::FunctionReference;
 using zir::LoadInst;
 using zir::Module;
 using zir::MoveInst;
+using zir::NoValue;
 using zir::OpCode;
 using zir::OwnershipDestroyPlacementKind;
 using zir::OwnershipFlowAnalysis;
@@ -42,6 +43,7 @@ using zir::StoreInst;
 using zir::StoreMode;
 using zir::Type;
 using zir::TypeKind;
+using zir::ValueId;
 using zir::ValueOwnership;
 using zir::VerificationErrorCode;
 using zir::WeakLockInst;
@@ -51,9 +53,9 @@ std::shared_ptr<Type> primitive(TypeKind kind) {
   return std::make_shared<PrimitiveType>(kind);
 }
 
-std::shared_ptr<Register> reg(const std::string &name,
-                              const std::shared_ptr<Type> &type) {
-  return std::make_shared<Register>(name, type);
+ValueId reg(Function &function, const std::string &name,
+            const std::shared_ptr<Type> &type) {
+  return function.values.add<Register>(name, type);
 }
 
 bool hasError(const zir::VerificationResult &result,
@@ -72,34 +74,36 @@ std::unique_ptr<Function> validFunction() {
   auto function = std::make_unique<Function>("valid", i32);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(i32));
-  auto loaded = reg("loaded", i32);
-  auto condition = reg("condition", boolean);
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(i32));
+  auto loaded = reg(*function, "loaded", i32);
+  auto condition = reg(*function, "condition", boolean);
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, i32));
   entry->addInstruction(std::make_unique<StoreInst>(
-      std::make_shared<Constant>("4", i32), slot, zir::StoreMode::Assign));
+      function->values.add<Constant>("4", i32), slot, zir::StoreMode::Assign));
   entry->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   entry->addInstruction(std::make_unique<CmpInst>(
-      "eq", condition, loaded, std::make_shared<Constant>("4", i32)));
+      "eq", condition, loaded, function->values.add<Constant>("4", i32)));
   entry->addInstruction(
       std::make_unique<CondBranchInst>(condition, "left", "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  auto leftValue = reg("left.value", i32);
+  auto leftValue = reg(*function, "left.value", i32);
   left->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Add, leftValue, loaded, std::make_shared<Constant>("1", i32)));
+      OpCode::Add, leftValue, loaded,
+      function->values.add<Constant>("1", i32)));
   left->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto right = std::make_unique<BasicBlock>("right");
-  auto rightValue = reg("right.value", i32);
+  auto rightValue = reg(*function, "right.value", i32);
   right->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Sub, rightValue, loaded, std::make_shared<Constant>("1", i32)));
+      OpCode::Sub, rightValue, loaded,
+      function->values.add<Constant>("1", i32)));
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", i32);
+  auto result = reg(*function, "result", i32);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", leftValue}, {"right", rightValue}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
 
@@ -155,11 +159,11 @@ bool testInstructionAfterTerminator() {
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto dead = reg("dead", i32);
+  auto dead = reg(*function, "dead", i32);
   entry->addInstruction(std::make_unique<ReturnInst>());
   entry->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Add, dead, std::make_shared<Constant>("1", i32),
-      std::make_shared<Constant>("2", i32)));
+      OpCode::Add, dead, function->values.add<Constant>("1", i32),
+      function->values.add<Constant>("2", i32)));
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
   auto result = ZirVerifier().verify(module);
@@ -173,13 +177,13 @@ bool testUseBeforeDefinition() {
   auto i32 = primitive(TypeKind::Int32);
   auto function = std::make_unique<Function>("broken", i32);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("late", i32);
-  auto result = reg("result", i32);
+  auto value = reg(*function, "late", i32);
+  auto result = reg(*function, "result", i32);
   entry->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Add, result, value, std::make_shared<Constant>("1", i32)));
+      OpCode::Add, result, value, function->values.add<Constant>("1", i32)));
   entry->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Add, value, std::make_shared<Constant>("1", i32),
-      std::make_shared<Constant>("2", i32)));
+      OpCode::Add, value, function->values.add<Constant>("1", i32),
+      function->values.add<Constant>("2", i32)));
   entry->addInstruction(std::make_unique<ReturnInst>(result));
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -196,10 +200,10 @@ bool testStoreTypeMismatch() {
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(i32));
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(i32));
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, i32));
   entry->addInstruction(std::make_unique<StoreInst>(
-      std::make_shared<Constant>("1", i64), slot, zir::StoreMode::Assign));
+      function->values.add<Constant>("1", i64), slot, zir::StoreMode::Assign));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -210,8 +214,9 @@ bool testStoreTypeMismatch() {
 
 bool testStoreModeRendering() {
   auto i32 = primitive(TypeKind::Int32);
-  auto slot = reg("slot", std::make_shared<PointerType>(i32));
-  auto value = std::make_shared<Constant>("1", i32);
+  zir::ValueTable values;
+  auto slot = values.add<Register>("slot", std::make_shared<PointerType>(i32));
+  auto value = values.add<Constant>("1", i32);
   const std::vector<std::pair<StoreMode, std::string>> cases = {
       {StoreMode::Assign, "store.assign"},
       {StoreMode::Initialize, "store.initialize"},
@@ -220,7 +225,7 @@ bool testStoreModeRendering() {
   };
   for (const auto &[mode, prefix] : cases) {
     StoreInst store(value, slot, mode);
-    const std::string rendered = store.toString();
+    const std::string rendered = store.toString(values);
     if (!expect(rendered.compare(0, prefix.size(), prefix) == 0,
                 "store mode is missing from ZIR rendering")) {
       return false;
@@ -235,7 +240,7 @@ bool testAllocRequiresOwnedResult() {
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("node", classType);
+  auto result = reg(*function, "node", classType);
   entry->addInstruction(std::make_unique<zir::AllocInst>(result, classType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -253,10 +258,10 @@ bool testWeakLockRequiresOwnedStrongResult() {
   strongType->setWeak(false);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto weakValue = std::make_shared<zir::Argument>("weak", weakType);
+  auto weakValue = function->values.add<zir::Argument>("weak", weakType);
   function->arguments.push_back(weakValue);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("locked", strongType);
+  auto result = reg(*function, "locked", strongType);
   entry->addInstruction(std::make_unique<WeakLockInst>(result, weakValue));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -272,14 +277,14 @@ bool testManagedCallRequiresOwnedResult() {
   auto stringType = zir::makeStringType();
   auto functionType = std::make_shared<FunctionPointerType>(
       std::vector<std::shared_ptr<Type>>{}, stringType);
-  auto callee =
-      std::make_shared<FunctionReference>("make_string", functionType);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
+  auto callee =
+      function->values.add<FunctionReference>("make_string", functionType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("text", stringType);
+  auto result = reg(*function, "text", stringType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      result, callee, std::vector<std::shared_ptr<zir::Value>>{}));
+      result, callee, std::vector<ValueId>{}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -298,19 +303,20 @@ bool testRefCallDerivesResultTypeFromSignature() {
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto directResult = reg("direct", std::make_shared<PointerType>(i32));
+  auto directResult =
+      reg(*function, "direct", std::make_shared<PointerType>(i32));
   auto indirectResult =
-      reg("indirect", std::make_shared<PointerType>(i32));
+      reg(*function, "indirect", std::make_shared<PointerType>(i32));
   auto indirectType = std::make_shared<FunctionPointerType>(
       std::vector<std::shared_ptr<Type>>{}, i32,
       std::vector<zir::ParameterOwnership>{},
       std::vector<zir::ParameterEscape>{}, zir::ResultBorrowContract{}, true);
-  auto indirect = std::make_shared<FunctionReference>("get", indirectType);
+  auto indirect = function->values.add<FunctionReference>("get", indirectType);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      directResult, "get", std::vector<std::shared_ptr<zir::Value>>{}));
+      directResult, "get", std::vector<ValueId>{}));
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      indirectResult, indirect, std::vector<std::shared_ptr<zir::Value>>{}));
+      indirectResult, indirect, std::vector<ValueId>{}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -349,24 +355,26 @@ bool testPhiRequiresOwnershipMatchingIncomingValues() {
   auto boolean = primitive(TypeKind::Bool);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto leftValue = std::make_shared<zir::Argument>("left.value", stringType);
-  auto rightValue = std::make_shared<zir::Argument>("right.value", stringType);
-  leftValue->setOwnership(ValueOwnership::Owned);
-  rightValue->setOwnership(ValueOwnership::Owned);
+  auto leftValue =
+      function->values.add<zir::Argument>("left.value", stringType);
+  auto rightValue =
+      function->values.add<zir::Argument>("right.value", stringType);
+  function->getValue(leftValue)->setOwnership(ValueOwnership::Owned);
+  function->getValue(rightValue)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(leftValue);
   function->arguments.push_back(rightValue);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", stringType);
+  auto result = reg(*function, "result", stringType);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", leftValue}, {"right", rightValue}}));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
@@ -387,11 +395,11 @@ bool testManagedInitializationRequiresOwnershipTransfer() {
   auto stringType = zir::makeStringType();
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", stringType);
+  auto value = function->values.add<zir::Argument>("value", stringType);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(stringType));
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(stringType));
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, stringType));
   entry->addInstruction(
       std::make_unique<StoreInst>(value, slot, StoreMode::Initialize));
@@ -411,12 +419,12 @@ bool testCastRequiresOwnershipMatchingSourceAndTarget() {
   weakType->setWeak(true);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", strongType);
-  source->setOwnership(ValueOwnership::Owned);
+  auto source = function->values.add<zir::Argument>("source", strongType);
+  function->getValue(source)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(source);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("result", weakType);
+  auto result = reg(*function, "result", weakType);
   entry->addInstruction(std::make_unique<CastInst>(result, source, weakType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -432,8 +440,8 @@ bool testCallRequiresOwnershipMatchingArguments() {
   auto stringType = zir::makeStringType();
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto argument = std::make_shared<zir::Argument>("argument", stringType);
-  argument->setOwnership(ValueOwnership::Owned);
+  auto argument = function->values.add<zir::Argument>("argument", stringType);
+  function->getValue(argument)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(argument);
 
   auto entry = std::make_unique<BasicBlock>("entry");
@@ -442,10 +450,10 @@ bool testCallRequiresOwnershipMatchingArguments() {
       primitive(TypeKind::Void),
       std::vector<zir::ParameterOwnership>{
           zir::ParameterOwnership::Transfer});
-  auto callee = std::make_shared<FunctionReference>("callee", calleeType);
-  argument->setOwnership(ValueOwnership::Borrowed);
+  auto callee = function->values.add<FunctionReference>("callee", calleeType);
+  function->getValue(argument)->setOwnership(ValueOwnership::Borrowed);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, callee, std::vector<std::shared_ptr<zir::Value>>{argument}));
+      NoValue, callee, std::vector<ValueId>{argument}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -463,23 +471,22 @@ bool testIndirectCallDerivesNoEscapeFromFunctionType() {
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto owner = reg("owner", stringType);
-  owner->setOwnership(ValueOwnership::OwnedStrong);
-  auto view = reg("view", stringViewType);
+  auto owner = reg(*function, "owner", stringType);
+  function->getValue(owner)->setOwnership(ValueOwnership::OwnedStrong);
+  auto view = reg(*function, "view", stringViewType);
   auto calleeType = std::make_shared<FunctionPointerType>(
       std::vector<std::shared_ptr<Type>>{stringViewType},
       primitive(TypeKind::Void),
       std::vector<zir::ParameterOwnership>{zir::ParameterOwnership::Borrow},
       std::vector<zir::ParameterEscape>{zir::ParameterEscape::NoEscape});
-  auto callee = std::make_shared<FunctionReference>("consume", calleeType);
+  auto callee = function->values.add<FunctionReference>("consume", calleeType);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      owner, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owner, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, owner));
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, callee, std::vector<std::shared_ptr<zir::Value>>{view}));
+      NoValue, callee, std::vector<ValueId>{view}));
   entry->addInstruction(std::make_unique<DestroyInst>(owner));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -495,10 +502,10 @@ bool testCallConsumesExplicitManagedCopy() {
 
   auto callee =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  auto parameter = std::make_shared<zir::Argument>(
+  auto parameter = callee->values.add<zir::Argument>(
       "value", stringType, false, false, nullptr,
       zir::ParameterOwnership::Transfer);
-  parameter->setOwnership(ValueOwnership::OwnedStrong);
+  callee->getValue(parameter)->setOwnership(ValueOwnership::OwnedStrong);
   callee->arguments.push_back(parameter);
   auto calleeEntry = std::make_unique<BasicBlock>("entry");
   calleeEntry->addInstruction(std::make_unique<DestroyInst>(parameter));
@@ -508,16 +515,16 @@ bool testCallConsumesExplicitManagedCopy() {
 
   auto caller =
       std::make_unique<Function>("caller", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", stringType);
+  auto source = caller->values.add<zir::Argument>("source", stringType);
   caller->arguments.push_back(source);
-  auto copied = reg("copied", stringType);
-  copied->setOwnership(ValueOwnership::OwnedStrong);
+  auto copied = reg(*caller, "copied", stringType);
+  caller->getValue(copied)->setOwnership(ValueOwnership::OwnedStrong);
   auto callerEntry = std::make_unique<BasicBlock>("entry");
   callerEntry->addInstruction(std::make_unique<CopyInst>(copied, source));
   auto call = std::make_unique<zir::CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{copied},
-      std::vector<bool>{false}, nullptr);
-  const auto callText = call->toString();
+      NoValue, "consume", std::vector<ValueId>{copied},
+      std::vector<bool>{false}, NoValue);
+  const auto callText = call->toString(caller->values);
   callerEntry->addInstruction(std::move(call));
   callerEntry->addInstruction(std::make_unique<ReturnInst>());
   caller->addBlock(std::move(callerEntry));
@@ -536,16 +543,16 @@ bool testOwnershipTransferAcrossControlFlow() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("broken", classType);
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "consume", "skip"));
+      function->values.add<Constant>("true", boolean), "consume", "skip"));
 
   auto consume = std::make_unique<BasicBlock>("consume");
-  auto slot = reg("slot", std::make_shared<PointerType>(classType));
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(classType));
   consume->addInstruction(std::make_unique<zir::AllocaInst>(slot, classType));
   consume->addInstruction(
       std::make_unique<StoreInst>(value, slot, StoreMode::Assign));
@@ -574,16 +581,16 @@ bool testPhiTransfersOwnershipOnIncomingEdge() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("broken", classType);
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  auto slot = reg("slot", std::make_shared<PointerType>(classType));
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(classType));
   left->addInstruction(std::make_unique<zir::AllocaInst>(slot, classType));
   left->addInstruction(
       std::make_unique<StoreInst>(value, slot, StoreMode::Assign));
@@ -593,10 +600,10 @@ bool testPhiTransfersOwnershipOnIncomingEdge() {
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", classType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "result", classType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", value}, {"right", value}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
 
@@ -617,23 +624,23 @@ bool testPhiAllowsSeparateAlternativeOwnershipTransfers() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("valid", classType);
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", classType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "result", classType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", value}, {"right", value}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
 
@@ -654,22 +661,22 @@ bool testOwnershipLivenessTracksPhiEdges() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("liveness", classType);
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", classType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "result", classType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", value}, {"right", value}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
 
@@ -697,12 +704,12 @@ bool testOwnershipFlowTracksEdgesMergesAndLoops() {
 
   auto branchFunction =
       std::make_unique<Function>("branch", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = branchFunction->values.add<zir::Argument>("value", classType);
+  branchFunction->getValue(value)->setOwnership(ValueOwnership::Owned);
   branchFunction->arguments.push_back(value);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      branchFunction->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<DestroyInst>(value));
   left->addInstruction(std::make_unique<BranchInst>("exit"));
@@ -736,13 +743,13 @@ bool testOwnershipFlowTracksEdgesMergesAndLoops() {
   auto loopFunction =
       std::make_unique<Function>("loop", primitive(TypeKind::Void));
   auto loopEntry = std::make_unique<BasicBlock>("entry");
-  auto node = reg("node", classType);
-  node->setOwnership(ValueOwnership::Owned);
+  auto node = reg(*loopFunction, "node", classType);
+  loopFunction->getValue(node)->setOwnership(ValueOwnership::Owned);
   loopEntry->addInstruction(std::make_unique<zir::AllocInst>(node, classType));
   loopEntry->addInstruction(std::make_unique<BranchInst>("loop"));
   auto loop = std::make_unique<BasicBlock>("loop");
   loop->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "loop", "exit"));
+      loopFunction->values.add<Constant>("true", boolean), "loop", "exit"));
   auto loopExit = std::make_unique<BasicBlock>("exit");
   loopExit->addInstruction(std::make_unique<ReturnInst>());
   auto *loopEntryBlock = loopEntry.get();
@@ -790,10 +797,10 @@ bool testOwnershipFlowRejectsTransferAfterPartialDefinition() {
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
-  auto node = reg("node", classType);
-  node->setOwnership(ValueOwnership::Owned);
+  auto node = reg(*function, "node", classType);
+  function->getValue(node)->setOwnership(ValueOwnership::Owned);
   left->addInstruction(std::make_unique<zir::AllocInst>(node, classType));
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
@@ -843,7 +850,7 @@ bool testControlFlowGraphBuildsEdgesAndReachability() {
   auto function = std::make_unique<Function>("cfg", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
@@ -881,13 +888,52 @@ bool testControlFlowGraphBuildsEdgesAndReachability() {
                 "control-flow graph did not calculate dominators");
 }
 
+bool testBranchesResolveBlocksById() {
+  auto function = validFunction();
+  const auto &blocks = function->getBlocks();
+  const auto &entryBranch =
+      static_cast<const CondBranchInst &>(*blocks[0]->getInstructions().back());
+  const auto &leftBranch =
+      static_cast<const BranchInst &>(*blocks[1]->getInstructions().back());
+  const auto &phi =
+      static_cast<const PhiInst &>(*blocks[3]->getInstructions().front());
+
+  auto late = std::make_unique<BasicBlock>("late");
+  late->addInstruction(std::make_unique<ReturnInst>(
+      function->values.add<Constant>("0", primitive(TypeKind::Int32))));
+  blocks[3]->addInstruction(std::make_unique<BranchInst>("late"));
+  const auto lateId =
+      static_cast<const BranchInst &>(*blocks[3]->getInstructions().back())
+          .getTargetBlock();
+  auto *lateBlock = late.get();
+  function->addBlock(std::move(late));
+
+  return expect(function->getBlock(entryBranch.getTrueBlock()) ==
+                        blocks[1].get() &&
+                    function->getBlock(entryBranch.getFalseBlock()) ==
+                        blocks[2].get() &&
+                    function->getBlock(leftBranch.getTargetBlock()) ==
+                        blocks[3].get(),
+                "branches did not resolve their targets to block ids") &&
+         expect(function->getBlock(phi.getIncomingBlock(0)) ==
+                        blocks[1].get() &&
+                    phi.findIncoming(blocks[2]->id) != nullptr &&
+                    phi.findIncoming(blocks[0]->id) == nullptr,
+                "phi did not resolve its incoming blocks to block ids") &&
+         expect(lateId != zir::NoBlock && lateBlock->id == lateId &&
+                    function->getBlock(lateId) == lateBlock &&
+                    function->getBlock(
+                        function->internBlockLabel("missing")) == nullptr,
+                "branch to a later block did not share its block id");
+}
+
 bool testDestroyConsumesOwnedValue() {
   Module module("release-ownership");
   auto stringType = zir::makeStringType();
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", stringType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", stringType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
@@ -909,15 +955,16 @@ bool testUseAfterDestroyIsRejected() {
   auto boolean = primitive(TypeKind::Bool);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto comparison = reg("comparison", boolean);
+  auto comparison = reg(*function, "comparison", boolean);
   entry->addInstruction(std::make_unique<DestroyInst>(value));
   entry->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, value, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, value,
+      function->values.add<Constant>("null", classType)));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -932,10 +979,10 @@ bool testUseAfterMoveIsRejected() {
   auto classType = std::make_shared<ClassType>("Node");
   auto function = std::make_unique<Function>("broken", classType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
-  auto moved = reg("moved", classType);
-  moved->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
+  auto moved = reg(*function, "moved", classType);
+  function->getValue(moved)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<MoveInst>(moved, value));
   entry->addInstruction(std::make_unique<DestroyInst>(value));
@@ -955,11 +1002,11 @@ bool testCopyCreatesIndependentOwnership() {
   auto classType = std::make_shared<ClassType>("Node");
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", classType);
-  source->setOwnership(ValueOwnership::Owned);
+  auto source = function->values.add<zir::Argument>("source", classType);
+  function->getValue(source)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(source);
-  auto copied = reg("copied", classType);
-  copied->setOwnership(ValueOwnership::Owned);
+  auto copied = reg(*function, "copied", classType);
+  function->getValue(copied)->setOwnership(ValueOwnership::Owned);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CopyInst>(copied, source));
@@ -969,13 +1016,9 @@ bool testCopyCreatesIndependentOwnership() {
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
 
-  const auto &copy = module.getFunctions()
-                         .front()
-                         ->getBlocks()
-                         .front()
-                         ->getInstructions()
-                         .front();
-  return expect(copy->toString().rfind("%copied = copy ", 0) == 0,
+  const auto &valid = *module.getFunctions().front();
+  const auto &copy = valid.getBlocks().front()->getInstructions().front();
+  return expect(copy->toString(valid.values).rfind("%copied = copy ", 0) == 0,
                 "copy instruction did not render its owned result") &&
          expect(ZirVerifier().verify(module).ok(),
                 "copy with independently destroyed ownership was rejected") &&
@@ -988,11 +1031,11 @@ bool testMoveTransfersOwnershipIntoInitialization() {
   auto classType = std::make_shared<ClassType>("Node");
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto slot = reg("slot", std::make_shared<PointerType>(classType));
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::OwnedStrong);
-  auto moved = reg("moved", classType);
-  moved->setOwnership(ValueOwnership::OwnedStrong);
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(classType));
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::OwnedStrong);
+  auto moved = reg(*function, "moved", classType);
+  function->getValue(moved)->setOwnership(ValueOwnership::OwnedStrong);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, classType));
@@ -1016,12 +1059,12 @@ bool testWeakCopyTransfersWeakOwnership() {
   weakType->setWeak(true);
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", weakType);
+  auto source = function->values.add<zir::Argument>("source", weakType);
   function->arguments.push_back(source);
 
-  auto copied = reg("copied", weakType);
-  copied->setOwnership(ValueOwnership::OwnedWeak);
-  auto slot = reg("slot", std::make_shared<PointerType>(weakType));
+  auto copied = reg(*function, "copied", weakType);
+  function->getValue(copied)->setOwnership(ValueOwnership::OwnedWeak);
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(weakType));
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, weakType));
   entry->addInstruction(std::make_unique<CopyInst>(copied, source));
@@ -1043,11 +1086,11 @@ bool testWeakCopyRejectsStrongOwnership() {
   weakType->setWeak(true);
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", weakType);
+  auto source = function->values.add<zir::Argument>("source", weakType);
   function->arguments.push_back(source);
 
-  auto copied = reg("copied", weakType);
-  copied->setOwnership(ValueOwnership::OwnedStrong);
+  auto copied = reg(*function, "copied", weakType);
+  function->getValue(copied)->setOwnership(ValueOwnership::OwnedStrong);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CopyInst>(copied, source));
   entry->addInstruction(std::make_unique<DestroyInst>(copied));
@@ -1066,8 +1109,8 @@ bool testOwnershipExitObligationsReportLiveValues() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   auto *entryBlock = entry.get();
@@ -1081,7 +1124,7 @@ bool testOwnershipExitObligationsReportLiveValues() {
   return expect(obligations.size() == 1 &&
                     obligations.front().block == entryBlock &&
                     obligations.front().instructionIndex == 1 &&
-                    obligations.front().value == value.get() &&
+                    obligations.front().value == value &&
                     obligations.front().state == OwnershipFlowState::Live,
                 "exit obligations did not report a live owned value");
 }
@@ -1092,8 +1135,8 @@ bool testOwnershipClosurePlanConnectsDefinitionAndExit() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   auto *entryBlock = entry.get();
@@ -1105,7 +1148,7 @@ bool testOwnershipClosurePlanConnectsDefinitionAndExit() {
                                  {entryBlock});
   const auto plans = analysis.analyzeOwnershipClosurePlans();
   return expect(
-      plans.size() == 1 && plans.front().value == value.get() &&
+      plans.size() == 1 && plans.front().value == value &&
           plans.front().definition.block == entryBlock &&
           plans.front().definition.instructionIndex == 0 &&
           plans.front().liveExits.size() == 1 &&
@@ -1126,13 +1169,13 @@ bool testOwnershipClosurePlanUsesCriticalLiveEdge() {
   auto boolean = primitive(TypeKind::Bool);
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "exit", "closed"));
+      function->values.add<Constant>("true", boolean), "exit", "closed"));
   auto closed = std::make_unique<BasicBlock>("closed");
   closed->addInstruction(std::make_unique<DestroyInst>(value));
   closed->addInstruction(std::make_unique<BranchInst>("exit"));
@@ -1171,10 +1214,10 @@ bool testOwnershipExitObligationsAllowMovedReturn() {
   auto classType = std::make_shared<ClassType>("Node");
   auto function = std::make_unique<Function>("valid", classType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
-  auto moved = reg("moved", classType);
-  moved->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
+  auto moved = reg(*function, "moved", classType);
+  function->getValue(moved)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<MoveInst>(moved, value));
   entry->addInstruction(std::make_unique<ReturnInst>(moved));
@@ -1199,8 +1242,8 @@ bool testOwnershipObligationVerifierReportsLiveValues() {
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -1222,10 +1265,10 @@ bool testOwnershipExitObligationsTrackPartialDefinitions() {
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "defines", "skips"));
+      function->values.add<Constant>("true", boolean), "defines", "skips"));
   auto defines = std::make_unique<BasicBlock>("defines");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   defines->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   defines->addInstruction(std::make_unique<BranchInst>("exit"));
   auto skips = std::make_unique<BasicBlock>("skips");
@@ -1260,7 +1303,7 @@ bool testOwnershipExitObligationsTrackPartialDefinitions() {
       static_cast<unsigned char>(OwnershipFlowState::Live));
   const auto plans = analysis.analyzeOwnershipClosurePlans();
   return expect(
-      obligations.size() == 1 && obligations.front().value == value.get() &&
+      obligations.size() == 1 && obligations.front().value == value &&
           obligations.front().state == expectedState && plans.size() == 1 &&
           plans.front().destroyPlacements.size() == 1 &&
           plans.front().destroyPlacements.front().kind ==
@@ -1277,21 +1320,21 @@ bool testOwnershipExitObligationsAllowPhiTransfer() {
   auto classType = std::make_shared<ClassType>("Node");
   auto boolean = primitive(TypeKind::Bool);
   auto function = std::make_unique<Function>("valid", classType);
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", classType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "result", classType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      result, std::vector<std::pair<std::string, ValueId>>{
                   {"left", value}, {"right", value}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
   auto *entryBlock = entry.get();
@@ -1327,13 +1370,13 @@ bool testOwnershipExitObligationsTrackLoops() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(value, classType));
   entry->addInstruction(std::make_unique<BranchInst>("loop"));
   auto loop = std::make_unique<BasicBlock>("loop");
   loop->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "loop", "exit"));
+      function->values.add<Constant>("true", boolean), "loop", "exit"));
   auto exit = std::make_unique<BasicBlock>("exit");
   exit->addInstruction(std::make_unique<ReturnInst>());
   auto *entryBlock = entry.get();
@@ -1356,7 +1399,7 @@ bool testOwnershipExitObligationsTrackLoops() {
   const auto obligations = analysis.analyzeExitObligations();
   const auto plans = analysis.analyzeOwnershipClosurePlans();
   return expect(
-      obligations.size() == 1 && obligations.front().value == value.get() &&
+      obligations.size() == 1 && obligations.front().value == value &&
           obligations.front().state == OwnershipFlowState::Live &&
           plans.size() == 1 && plans.front().destroyPlacements.size() == 1 &&
           plans.front().destroyPlacements.front().kind ==
@@ -1372,12 +1415,12 @@ bool testBorrowPreservesOwnedString() {
   auto stringViewType = zir::makeStringViewType();
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", stringType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", stringType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto view = reg("view", stringViewType);
+  auto view = reg(*function, "view", stringViewType);
   entry->addInstruction(std::make_unique<BorrowInst>(view, value));
   entry->addInstruction(std::make_unique<DestroyInst>(value));
   entry->addInstruction(std::make_unique<ReturnInst>());
@@ -1393,12 +1436,12 @@ bool testBorrowRequiresStringOwnerAndBorrowedStringView() {
   auto stringViewType = zir::makeStringViewType();
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto owner = std::make_shared<zir::Argument>("owner", stringViewType);
+  auto owner = function->values.add<zir::Argument>("owner", stringViewType);
   function->arguments.push_back(owner);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("result", stringViewType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "result", stringViewType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<BorrowInst>(result, owner));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
@@ -1416,23 +1459,23 @@ bool testDestroyRejectsLiveBorrowedStringView() {
   auto stringViewType = zir::makeStringViewType();
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  consume->arguments.push_back(std::make_shared<zir::Argument>(
+  consume->arguments.push_back(consume->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, zir::ParameterEscape::NoEscape));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
-  auto text = std::make_shared<zir::Argument>("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
+  auto text = function->values.add<zir::Argument>("text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(text);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto view = reg("view", stringViewType);
+  auto view = reg(*function, "view", stringViewType);
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(std::make_unique<DestroyInst>(text));
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view},
-      std::vector<bool>{false}, nullptr));
+      NoValue, "consume", std::vector<ValueId>{view},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -1452,44 +1495,40 @@ bool testOwnershipLivenessTracksBorrowPhiEdges() {
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
   consume->arguments.push_back(
-      std::make_shared<zir::Argument>("view", stringViewType));
+      consume->values.add<zir::Argument>("view", stringViewType));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  auto leftText = reg("left.text", stringType);
-  leftText->setOwnership(ValueOwnership::Owned);
-  auto leftView = reg("left.view", stringViewType);
+  auto leftText = reg(*function, "left.text", stringType);
+  function->getValue(leftText)->setOwnership(ValueOwnership::Owned);
+  auto leftView = reg(*function, "left.view", stringViewType);
   left->addInstruction(std::make_unique<zir::CallInst>(
-      leftText, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      leftText, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   left->addInstruction(std::make_unique<BorrowInst>(leftView, leftText));
   left->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto right = std::make_unique<BasicBlock>("right");
-  auto rightText = reg("right.text", stringType);
-  rightText->setOwnership(ValueOwnership::Owned);
-  auto rightView = reg("right.view", stringViewType);
+  auto rightText = reg(*function, "right.text", stringType);
+  function->getValue(rightText)->setOwnership(ValueOwnership::Owned);
+  auto rightView = reg(*function, "right.view", stringViewType);
   right->addInstruction(std::make_unique<zir::CallInst>(
-      rightText, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      rightText, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   right->addInstruction(std::make_unique<BorrowInst>(rightView, rightText));
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto mergedView = reg("merged.view", stringViewType);
+  auto mergedView = reg(*function, "merged.view", stringViewType);
   merge->addInstruction(std::make_unique<PhiInst>(
-      mergedView,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      mergedView, std::vector<std::pair<std::string, ValueId>>{
           {"left", leftView}, {"right", rightView}}));
   merge->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, "consume",
-      std::vector<std::shared_ptr<zir::Value>>{mergedView}));
+      NoValue, "consume", std::vector<ValueId>{mergedView}));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
   auto *leftBlock = left.get();
@@ -1529,47 +1568,45 @@ bool testOwnershipLivenessTracksBorrowedViewsThroughLocalStorage() {
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
   consume->arguments.push_back(
-      std::make_shared<zir::Argument>("view", stringViewType));
+      consume->values.add<zir::Argument>("view", stringViewType));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", stringViewPointer);
+  auto slot = reg(*function, "slot", stringViewPointer);
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
 
   auto left = std::make_unique<BasicBlock>("left");
-  auto leftText = reg("left.text", stringType);
-  leftText->setOwnership(ValueOwnership::Owned);
-  auto leftView = reg("left.view", stringViewType);
+  auto leftText = reg(*function, "left.text", stringType);
+  function->getValue(leftText)->setOwnership(ValueOwnership::Owned);
+  auto leftView = reg(*function, "left.view", stringViewType);
   left->addInstruction(std::make_unique<zir::CallInst>(
-      leftText, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      leftText, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   left->addInstruction(std::make_unique<BorrowInst>(leftView, leftText));
   left->addInstruction(
       std::make_unique<StoreInst>(leftView, slot, StoreMode::Initialize));
   left->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto right = std::make_unique<BasicBlock>("right");
-  auto rightText = reg("right.text", stringType);
-  rightText->setOwnership(ValueOwnership::Owned);
-  auto rightView = reg("right.view", stringViewType);
+  auto rightText = reg(*function, "right.text", stringType);
+  function->getValue(rightText)->setOwnership(ValueOwnership::Owned);
+  auto rightView = reg(*function, "right.view", stringViewType);
   right->addInstruction(std::make_unique<zir::CallInst>(
-      rightText, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      rightText, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   right->addInstruction(std::make_unique<BorrowInst>(rightView, rightText));
   right->addInstruction(
       std::make_unique<StoreInst>(rightView, slot, StoreMode::Assign));
   right->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto loaded = reg("loaded", stringViewType);
+  auto loaded = reg(*function, "loaded", stringViewType);
   merge->addInstruction(std::make_unique<LoadInst>(loaded, slot));
   merge->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{loaded}));
+      NoValue, "consume", std::vector<ValueId>{loaded}));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
   auto *leftBlock = left.get();
@@ -1601,12 +1638,11 @@ bool testReturnRejectsFunctionLocalStringView() {
 
   auto function = std::make_unique<Function>("broken", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto text = reg("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
-  auto view = reg("view", stringViewType);
+  auto text = reg(*function, "text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
+  auto view = reg(*function, "view", stringViewType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      text, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      text, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(std::make_unique<ReturnInst>(view));
   function->addBlock(std::move(entry));
@@ -1622,8 +1658,8 @@ bool testReturnAllowsBorrowedStringView() {
   auto stringType = zir::makeStringType();
   auto stringViewType = zir::makeStringViewType();
   auto function = std::make_unique<Function>("valid", stringViewType);
-  auto text = std::make_shared<zir::Argument>("text", stringType);
-  auto view = reg("view", stringViewType);
+  auto text = function->values.add<zir::Argument>("text", stringType);
+  auto view = reg(*function, "view", stringViewType);
   function->arguments.push_back(text);
 
   auto entry = std::make_unique<BasicBlock>("entry");
@@ -1646,14 +1682,13 @@ bool testReturnRejectsStringViewLoadedFromLocalStorage() {
 
   auto function = std::make_unique<Function>("broken", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto text = reg("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
-  auto view = reg("view", stringViewType);
-  auto slot = reg("slot", stringViewPointer);
-  auto loaded = reg("loaded", stringViewType);
+  auto text = reg(*function, "text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
+  auto view = reg(*function, "view", stringViewType);
+  auto slot = reg(*function, "slot", stringViewPointer);
+  auto loaded = reg(*function, "loaded", stringViewType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      text, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      text, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(
       std::make_unique<zir::AllocaInst>(slot, stringViewType));
@@ -1679,13 +1714,12 @@ bool testReturnRejectsCastFunctionLocalStringView() {
 
   auto function = std::make_unique<Function>("broken", stringViewType);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto text = reg("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
-  auto view = reg("view", stringViewType);
-  auto castView = reg("cast.view", stringViewType);
+  auto text = reg(*function, "text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
+  auto view = reg(*function, "view", stringViewType);
+  auto castView = reg(*function, "cast.view", stringViewType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      text, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      text, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(
       std::make_unique<CastInst>(castView, view, stringViewType));
@@ -1710,15 +1744,14 @@ bool testStoreRejectsEscapingFunctionLocalStringView() {
   auto function =
       std::make_unique<Function>("broken", primitive(TypeKind::Void));
   auto destination =
-      std::make_shared<zir::Argument>("destination", stringViewPointer);
+      function->values.add<zir::Argument>("destination", stringViewPointer);
   function->arguments.push_back(destination);
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto text = reg("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
-  auto view = reg("view", stringViewType);
+  auto text = reg(*function, "text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
+  auto view = reg(*function, "view", stringViewType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      text, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      text, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(
       std::make_unique<StoreInst>(view, destination, StoreMode::Assign));
@@ -1738,19 +1771,20 @@ bool testOwnershipLoweringReleasesDeadOwnedResults() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto result = reg("node", classType);
-  result->setOwnership(ValueOwnership::Owned);
+  auto result = reg(*function, "node", classType);
+  function->getValue(result)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(result, classType));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
 
   zir::lowerDeadOwnedResults(module);
-  const auto &instructions =
-      module.getFunctions().front()->getBlocks().front()->getInstructions();
+  const auto &lowered = *module.getFunctions().front();
+  const auto &instructions = lowered.getBlocks().front()->getInstructions();
   return expect(instructions.size() == 3 &&
                     instructions[1]->getOpCode() == OpCode::Destroy &&
-                    instructions[1]->toString().rfind("destroy ", 0) == 0,
+                    instructions[1]->toString(lowered.values).rfind(
+                        "destroy ", 0) == 0,
                 "ownership lowering did not destroy a dead owned result") &&
          expect(ZirVerifier().verify(module).ok(),
                 "ownership-lowered ZIR was rejected by the verifier");
@@ -1762,28 +1796,29 @@ bool testOwnershipLoweringPreservesManagedAssignmentCopy() {
   auto boolean = primitive(TypeKind::Bool);
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto source = std::make_shared<zir::Argument>("source", classType);
-  source->setOwnership(ValueOwnership::Owned);
+  auto source = function->values.add<zir::Argument>("source", classType);
+  function->getValue(source)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(source);
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto slot = reg("slot", std::make_shared<PointerType>(classType));
-  auto copied = reg("copied", classType);
-  copied->setOwnership(ValueOwnership::Owned);
-  auto comparison = reg("comparison", boolean);
+  auto slot = reg(*function, "slot", std::make_shared<PointerType>(classType));
+  auto copied = reg(*function, "copied", classType);
+  function->getValue(copied)->setOwnership(ValueOwnership::Owned);
+  auto comparison = reg(*function, "comparison", boolean);
   entry->addInstruction(std::make_unique<zir::AllocaInst>(slot, classType));
   entry->addInstruction(std::make_unique<CopyInst>(copied, source));
   entry->addInstruction(
       std::make_unique<StoreInst>(copied, slot, StoreMode::Assign));
   entry->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, source, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, source,
+      function->values.add<Constant>("null", classType)));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
 
   zir::lowerDeadOwnedResults(module);
-  const auto &instructions =
-      module.getFunctions().front()->getBlocks().front()->getInstructions();
+  const auto &lowered = *module.getFunctions().front();
+  const auto &instructions = lowered.getBlocks().front()->getInstructions();
   if (instructions.size() < 3 || instructions[1]->getOpCode() != OpCode::Copy ||
       instructions[2]->getOpCode() != OpCode::Store) {
     return expect(false, "managed assignment copy was not preserved");
@@ -1792,7 +1827,7 @@ bool testOwnershipLoweringPreservesManagedAssignmentCopy() {
   const auto &store = static_cast<const StoreInst &>(*instructions[2]);
   return expect(instructions.size() == 6 &&
                     store.getSource() == copy.getResult() &&
-                    store.getSource()->getOwnership() ==
+                    lowered.getValue(store.getSource())->getOwnership() ==
                         ValueOwnership::Owned &&
                     instructions[3]->getOpCode() == OpCode::Cmp &&
                     instructions[4]->getOpCode() == OpCode::Destroy,
@@ -1808,8 +1843,8 @@ bool testOwnershipLoweringClosesUnambiguousOwnedArgumentAtReturn() {
   auto classType = std::make_shared<ClassType>("Node");
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<ReturnInst>());
@@ -1836,13 +1871,13 @@ bool testOwnershipLoweringClosesSimpleEdgeObligations() {
   auto boolean = primitive(TypeKind::Bool);
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "live", "closed"));
+      function->values.add<Constant>("true", boolean), "live", "closed"));
   auto live = std::make_unique<BasicBlock>("live");
   live->addInstruction(std::make_unique<BranchInst>("exit"));
   auto closed = std::make_unique<BasicBlock>("closed");
@@ -1876,26 +1911,25 @@ bool testOwnershipLoweringClosesCriticalEdgeObligations() {
   auto i32 = primitive(TypeKind::Int32);
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto value = std::make_shared<zir::Argument>("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = function->values.add<zir::Argument>("value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   function->arguments.push_back(value);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "exit", "closed"));
+      function->values.add<Constant>("true", boolean), "exit", "closed"));
   auto closed = std::make_unique<BasicBlock>("closed");
   closed->addInstruction(std::make_unique<DestroyInst>(value));
   closed->addInstruction(std::make_unique<BranchInst>("exit"));
   auto exit = std::make_unique<BasicBlock>("exit");
-  auto selected = reg("selected", i32);
-  auto comparison = reg("comparison", boolean);
+  auto selected = reg(*function, "selected", i32);
+  auto comparison = reg(*function, "comparison", boolean);
   exit->addInstruction(std::make_unique<PhiInst>(
-      selected,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
-          {"entry", std::make_shared<Constant>("1", i32)},
-          {"closed", std::make_shared<Constant>("2", i32)}}));
+      selected, std::vector<std::pair<std::string, ValueId>>{
+          {"entry", function->values.add<Constant>("1", i32)},
+          {"closed", function->values.add<Constant>("2", i32)}}));
   exit->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, selected, std::make_shared<Constant>("1", i32)));
+      "eq", comparison, selected, function->values.add<Constant>("1", i32)));
   exit->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   function->addBlock(std::move(closed));
@@ -1930,12 +1964,13 @@ bool testOwnershipLoweringReleasesAtLastLocalUse() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto node = reg("node", classType);
-  node->setOwnership(ValueOwnership::Owned);
-  auto comparison = reg("comparison", boolean);
+  auto node = reg(*function, "node", classType);
+  function->getValue(node)->setOwnership(ValueOwnership::Owned);
+  auto comparison = reg(*function, "comparison", boolean);
   entry->addInstruction(std::make_unique<zir::AllocInst>(node, classType));
   entry->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, node, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, node,
+      function->values.add<Constant>("null", classType)));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -1958,7 +1993,7 @@ bool testOwnershipLoweringReleasesOwnerAfterBorrowUse() {
   module.addExternalFunction(std::move(make));
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
-  consume->arguments.push_back(std::make_shared<zir::Argument>(
+  consume->arguments.push_back(consume->values.add<zir::Argument>(
       "view", stringViewType, false, false, nullptr,
       zir::ParameterOwnership::Borrow, zir::ParameterEscape::NoEscape));
   module.addExternalFunction(std::move(consume));
@@ -1966,16 +2001,15 @@ bool testOwnershipLoweringReleasesOwnerAfterBorrowUse() {
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto text = reg("text", stringType);
-  text->setOwnership(ValueOwnership::Owned);
-  auto view = reg("view", stringViewType);
+  auto text = reg(*function, "text", stringType);
+  function->getValue(text)->setOwnership(ValueOwnership::Owned);
+  auto view = reg(*function, "view", stringViewType);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      text, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      text, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<BorrowInst>(view, text));
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{view},
-      std::vector<bool>{false}, nullptr));
+      NoValue, "consume", std::vector<ValueId>{view},
+      std::vector<bool>{false}, NoValue));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -2000,19 +2034,18 @@ bool testCallBorrowAllowsOwnedValueToBeReleasedAfterward() {
   auto consume =
       std::make_unique<Function>("consume", primitive(TypeKind::Void));
   consume->arguments.push_back(
-      std::make_shared<zir::Argument>("value", classType));
+      consume->values.add<zir::Argument>("value", classType));
   module.addExternalFunction(std::move(consume));
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto value = reg("value", classType);
-  value->setOwnership(ValueOwnership::Owned);
+  auto value = reg(*function, "value", classType);
+  function->getValue(value)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      value, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      value, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   entry->addInstruction(std::make_unique<zir::CallInst>(
-      nullptr, "consume", std::vector<std::shared_ptr<zir::Value>>{value}));
+      NoValue, "consume", std::vector<ValueId>{value}));
   entry->addInstruction(std::make_unique<ReturnInst>());
   function->addBlock(std::move(entry));
   module.addFunction(std::move(function));
@@ -2035,16 +2068,17 @@ bool testOwnershipLoweringReleasesOnDeadCfgEdge() {
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
 
   auto entry = std::make_unique<BasicBlock>("entry");
-  auto node = reg("node", classType);
-  node->setOwnership(ValueOwnership::Owned);
+  auto node = reg(*function, "node", classType);
+  function->getValue(node)->setOwnership(ValueOwnership::Owned);
   entry->addInstruction(std::make_unique<zir::AllocInst>(node, classType));
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "live", "dead"));
+      function->values.add<Constant>("true", boolean), "live", "dead"));
 
   auto live = std::make_unique<BasicBlock>("live");
-  auto comparison = reg("comparison", boolean);
+  auto comparison = reg(*function, "comparison", boolean);
   live->addInstruction(std::make_unique<CmpInst>(
-      "eq", comparison, node, std::make_shared<Constant>("null", classType)));
+      "eq", comparison, node,
+      function->values.add<Constant>("null", classType)));
   live->addInstruction(std::make_unique<ReturnInst>());
 
   auto dead = std::make_unique<BasicBlock>("dead");
@@ -2079,32 +2113,30 @@ bool testOwnershipLoweringRemovesUnusedBorrowedPhiBeforeCleanup() {
 
   auto function =
       std::make_unique<Function>("valid", primitive(TypeKind::Void));
-  auto borrowed = std::make_shared<zir::Argument>("borrowed", stringType);
-  borrowed->setOwnership(ValueOwnership::Borrowed);
+  auto borrowed = function->values.add<zir::Argument>("borrowed", stringType);
+  function->getValue(borrowed)->setOwnership(ValueOwnership::Borrowed);
   function->arguments.push_back(borrowed);
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "borrowed.path",
+      function->values.add<Constant>("true", boolean), "borrowed.path",
       "owned.path"));
 
   auto borrowedPath = std::make_unique<BasicBlock>("borrowed.path");
   borrowedPath->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto ownedPath = std::make_unique<BasicBlock>("owned.path");
-  auto owned = reg("owned", stringType);
-  owned->setOwnership(ValueOwnership::Owned);
+  auto owned = reg(*function, "owned", stringType);
+  function->getValue(owned)->setOwnership(ValueOwnership::Owned);
   ownedPath->addInstruction(std::make_unique<zir::CallInst>(
-      owned, "make", std::vector<std::shared_ptr<zir::Value>>{},
-      std::vector<bool>{}, nullptr));
+      owned, "make", std::vector<ValueId>{}, std::vector<bool>{}, NoValue));
   ownedPath->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto unused = reg("unused", stringType);
-  unused->setOwnership(ValueOwnership::Borrowed);
+  auto unused = reg(*function, "unused", stringType);
+  function->getValue(unused)->setOwnership(ValueOwnership::Borrowed);
   merge->addInstruction(std::make_unique<PhiInst>(
-      unused,
-      std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
+      unused, std::vector<std::pair<std::string, ValueId>>{
           {"borrowed.path", borrowed}, {"owned.path", owned}}));
   merge->addInstruction(std::make_unique<ReturnInst>());
 
@@ -2140,13 +2172,13 @@ bool testDominanceViolation() {
 
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "defines", "skips"));
+      function->values.add<Constant>("true", boolean), "defines", "skips"));
 
   auto defines = std::make_unique<BasicBlock>("defines");
-  auto onePathValue = reg("one.path", i32);
+  auto onePathValue = reg(*function, "one.path", i32);
   defines->addInstruction(std::make_unique<zir::BinaryInst>(
-      OpCode::Add, onePathValue, std::make_shared<Constant>("1", i32),
-      std::make_shared<Constant>("2", i32)));
+      OpCode::Add, onePathValue, function->values.add<Constant>("1", i32),
+      function->values.add<Constant>("2", i32)));
   defines->addInstruction(std::make_unique<BranchInst>("merge"));
 
   auto skips = std::make_unique<BasicBlock>("skips");
@@ -2172,16 +2204,16 @@ bool testPhiRequiresEveryPredecessor() {
   auto function = std::make_unique<Function>("broken", i32);
   auto entry = std::make_unique<BasicBlock>("entry");
   entry->addInstruction(std::make_unique<CondBranchInst>(
-      std::make_shared<Constant>("true", boolean), "left", "right"));
+      function->values.add<Constant>("true", boolean), "left", "right"));
   auto left = std::make_unique<BasicBlock>("left");
   left->addInstruction(std::make_unique<BranchInst>("merge"));
   auto right = std::make_unique<BasicBlock>("right");
   right->addInstruction(std::make_unique<BranchInst>("merge"));
   auto merge = std::make_unique<BasicBlock>("merge");
-  auto result = reg("result", i32);
+  auto result = reg(*function, "result", i32);
   merge->addInstruction(std::make_unique<PhiInst>(
-      result, std::vector<std::pair<std::string, std::shared_ptr<zir::Value>>>{
-                  {"left", std::make_shared<Constant>("1", i32)}}));
+      result, std::vector<std::pair<std::string, ValueId>>{
+                  {"left", function->values.add<Constant>("1", i32)}}));
   merge->addInstruction(std::make_unique<ReturnInst>(result));
   function->addBlock(std::move(entry));
   function->addBlock(std::move(left));
@@ -2222,6 +2254,7 @@ int main() {
   ok = testOwnershipFlowTracksEdgesMergesAndLoops() && ok;
   ok = testOwnershipFlowRejectsTransferAfterPartialDefinition() && ok;
   ok = testControlFlowGraphBuildsEdgesAndReachability() && ok;
+  ok = testBranchesResolveBlocksById() && ok;
   ok = testDestroyConsumesOwnedValue() && ok;
   ok = testUseAfterDestroyIsRejected() && ok;
   ok = testUseAfterMoveIsRejected() && ok;
@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+INPUT="${2:-}"
+OUTPUT="${3:-}"
+
+if [[ -z "$ZAPC" || -z "$INPUT" || -z "$OUTPUT" ]]; then
+    echo "Usage: $0 <zapc> <input.zp> <output>" >&2
+    exit 1
+fi
+
+"$ZAPC" "$INPUT" -S -emit-llvm -o "$OUTPUT"
+
+# Node sits on a cycle and Owner can reach one; both must stay traceable.
+for traced_class in Node Owner; do
+    if ! grep -Eq "define internal void @__zap_arc_trace_[A-Za-z0-9_]*${traced_class}\(" "$OUTPUT"; then
+        echo "Expected a trace function for class '$traced_class'." >&2
+        exit 1
+    fi
+done
+
+# Payload and Box cannot reach a cycle, so the collector never traces them.
+for acyclic_class in Payload Box; do
+    if grep -Eq "@__zap_arc_trace_[A-Za-z0-9_]*${acyclic_class}\(" "$OUTPUT"; then
+        echo "Acyclic class '$acyclic_class' still has a trace function." >&2
+        exit 1
+    fi
+done
+
+if [[ "$(grep -c 'call void @zap_arc_add_possible_root' "$OUTPUT")" -ne 1 ]]; then
+    echo "Expected only the cyclic class to buffer possible roots." >&2
+    exit 1
+fi
+
+echo "Class acyclicity check passed successfully."
@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+OUTPUT_DIR="${2:-}"
+
+if [[ -z "$ZAPC" || -z "$OUTPUT_DIR" || $# -lt 3 ]]; then
+    echo "Usage: $0 <zapc> <output-dir> <input>..." >&2
+    exit 1
+fi
+shift 2
+
+mkdir -p "$OUTPUT_DIR"
+
+for input in "$@"; do
+    name="$(basename "$input" .zp)"
+    expected=""
+    for build in "1 1" "4 1" "4 3"; do
+        read -r units jobs <<<"$build"
+        binary="$OUTPUT_DIR/$name-$units-$jobs"
+        if ! compile_output=$("$ZAPC" "$input" -O2 \
+                "--codegen-units=$units" "--jobs=$jobs" \
+                -o "$binary" 2>&1); then
+            echo "$name failed to compile with $units units on $jobs" \
+                 "threads:" >&2
+            echo "$compile_output" >&2
+            exit 1
+        fi
+        if ! run_output=$("$binary" 2>&1); then
+            echo "$name failed with $units units on $jobs threads:" >&2
+            echo "$run_output" >&2
+            exit 1
+        fi
+        if [[ -z "$expected" ]]; then
+            expected="$run_output"
+        elif [[ "$run_output" != "$expected" ]]; then
+            echo "$name prints different output with $units units:" >&2
+            diff <(echo "$expected") <(echo "$run_output") >&2 || true
+            exit 1
+        fi
+    done
+
+    # The split only depends on the number of units, never on the threads.
+    if ! cmp -s "$OUTPUT_DIR/$name-4-1" "$OUTPUT_DIR/$name-4-3"; then
+        echo "$name differs between 1 and 3 code generation threads" >&2
+        exit 1
+    fi
+done
+
+echo "Codegen units test passed successfully."
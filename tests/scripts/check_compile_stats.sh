@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+INPUT="${2:-}"
+OUTPUT_DIR="${3:-}"
+
+if [[ -z "$ZAPC" || -z "$INPUT" || -z "$OUTPUT_DIR" ]]; then
+    echo "Usage: $0 <zapc> <input> <output-dir>" >&2
+    exit 1
+fi
+
+mkdir -p "$OUTPUT_DIR"
+stats="$OUTPUT_DIR/stats.json"
+rm -f "$stats"
+
+if ! report=$("$ZAPC" "$INPUT" -O2 --time-report "--stats=$stats" \
+        -o "$OUTPUT_DIR/program" 2>&1); then
+    echo "compilation with --time-report failed:" >&2
+    echo "$report" >&2
+    exit 1
+fi
+
+for phase in load bind zir "zir passes" "llvm ir" optimize emit link total; do
+    if ! grep -Eq "^  $phase +[0-9]" <<<"$report"; then
+        echo "--time-report lacks the '$phase' phase:" >&2
+        echo "$report" >&2
+        exit 1
+    fi
+    if [[ "$phase" != total ]] &&
+       ! grep -Fq "{\"name\": \"$phase\", \"wall\": " "$stats"; then
+        echo "--stats lacks the '$phase' phase" >&2
+        cat "$stats" >&2
+        exit 1
+    fi
+done
+
+for counter in modules tokens "ast nodes" "bound functions" \
+               "zir instructions" "llvm instructions"; do
+    if ! grep -Eq "^    \"$counter\": [1-9][0-9]*,?$" "$stats"; then
+        echo "--stats lacks a positive '$counter' counter" >&2
+        cat "$stats" >&2
+        exit 1
+    fi
+done
+
+if ! grep -Eq '^    "[A-Za-z]+Pass": [0-9.]+,?$' "$stats"; then
+    echo "--stats lacks optimizer pass times" >&2
+    cat "$stats" >&2
+    exit 1
+fi
+
+echo "Compile statistics test passed successfully."
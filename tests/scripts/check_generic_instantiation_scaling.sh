@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+STRESS_DIR="${2:-}"
+OUTPUT_DIR="${3:-}"
+
+if [[ -z "$ZAPC" || -z "$STRESS_DIR" || -z "$OUTPUT_DIR" ]]; then
+    echo "Usage: $0 <zapc> <generic-instantiation-stress-dir> <output-dir>" >&2
+    exit 1
+fi
+
+# Builds the stress program with <copies> copies of mods/user0.zp, each
+# asking for the same generic instantiations, and prints the instantiation
+# hit and miss counters and the generic function and type instances bound.
+counter() {
+    grep -o "\"$2\": [0-9]*" "$1" | grep -o '[0-9]*$' || true
+}
+
+measure() {
+    local copies="$1"
+    local dir="$OUTPUT_DIR/copies-$copies"
+    rm -rf "$dir"
+    mkdir -p "$dir/mods"
+    for module in "$STRESS_DIR"/mods/*.zp; do
+        [[ "$(basename "$module")" == user* ]] || cp "$module" "$dir/mods/"
+    done
+    {
+        echo 'import "mods";'
+        echo
+        echo 'fun main() Int {'
+        echo '  var failures: Int = 0;'
+        for ((copy = 0; copy < copies; copy++)); do
+            cp "$STRESS_DIR/mods/user0.zp" "$dir/mods/user$copy.zp"
+            echo "  failures = failures + user$copy.run();"
+        done
+        echo '  return failures;'
+        echo '}'
+    } >"$dir/main.zp"
+
+    local stats="$dir/stats.json"
+    if ! output=$("$ZAPC" "$dir/main.zp" -emit-zir "--stats=$stats" \
+            -o "$dir/main.zir" 2>&1); then
+        echo "the stress program with $copies modules failed to compile:" >&2
+        echo "$output" >&2
+        exit 1
+    fi
+    local hits misses functions types
+    hits=$(counter "$stats" "generic instantiation hits")
+    misses=$(counter "$stats" "generic instantiation misses")
+    functions=$(counter "$stats" "generic function instances")
+    types=$(counter "$stats" "generic type instances")
+    if [[ -z "$hits" || -z "$misses" || -z "$functions" || -z "$types" ]]; then
+        echo "--stats lacks the generic instantiation counters" >&2
+        cat "$stats" >&2
+        exit 1
+    fi
+    echo "$hits $misses $functions $types"
+}
+
+report() {
+    echo "$1 modules: $2 hits, $3 misses, $4 generic function and $5" \
+         "generic type instances"
+}
+
+read -r small_hits small_misses small_functions small_types < <(measure 16)
+read -r mid_hits mid_misses mid_functions mid_types < <(measure 32)
+read -r large_hits large_misses large_functions large_types < <(measure 64)
+report 16 "$small_hits" "$small_misses" "$small_functions" "$small_types"
+report 32 "$mid_hits" "$mid_misses" "$mid_functions" "$mid_types"
+report 64 "$large_hits" "$large_misses" "$large_functions" "$large_types"
+
+# Modules repeat instantiations that exist already, so only hits grow.
+if [[ "$mid_misses" != "$small_misses" ||
+      "$large_misses" != "$small_misses" ]]; then
+    echo "more modules built more instantiations ($small_misses," \
+         "$mid_misses, $large_misses); repeated instantiations are not" \
+         "reused" >&2
+    exit 1
+fi
+if [[ "$large_functions" != "$small_functions" ||
+      "$large_types" != "$small_types" ]]; then
+    echo "more modules bound more generic instances" >&2
+    exit 1
+fi
+# Every added copy reuses the same instantiations, so hits grow by the
+# same amount per module: 32 more modules add twice what 16 more did.
+if (( mid_hits <= small_hits ||
+      large_hits - mid_hits != 2 * (mid_hits - small_hits) )); then
+    echo "instantiation hits do not grow linearly with the modules:" \
+         "$small_hits, $mid_hits, $large_hits" >&2
+    exit 1
+fi
+
+echo "Generic instantiation scaling test passed successfully."
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+OUTPUT_DIR="${2:-}"
+
+if [[ -z "$ZAPC" || -z "$OUTPUT_DIR" || $# -lt 3 ]]; then
+    echo "Usage: $0 <zapc> <output-dir> <input>..." >&2
+    exit 1
+fi
+shift 2
+
+rm -rf "$OUTPUT_DIR"
+mkdir -p "$OUTPUT_DIR"
+cache="$OUTPUT_DIR/cache"
+
+for input in "$@"; do
+    name="$(basename "$input" .zp)"
+    "$ZAPC" "$input" -o "$OUTPUT_DIR/$name-cc"
+    expected="$("$OUTPUT_DIR/$name-cc" 2>&1)" || {
+        echo "$name failed when linked with cc" >&2
+        exit 1
+    }
+
+    # The first build asks cc for its link line and caches it, the second
+    # one reads it back.
+    for attempt in first second; do
+        binary="$OUTPUT_DIR/$name-lld-$attempt"
+        if ! compile_output=$("$ZAPC" "$input" --linker=lld \
+                "--cache-dir=$cache" -o "$binary" 2>&1); then
+            echo "$name failed to link with lld ($attempt build):" >&2
+            echo "$compile_output" >&2
+            exit 1
+        fi
+        if ! run_output=$("$binary" 2>&1); then
+            echo "$name failed when linked with lld ($attempt build):" >&2
+            echo "$run_output" >&2
+            exit 1
+        fi
+        if [[ "$run_output" != "$expected" ]]; then
+            echo "$name prints different output when linked with lld:" >&2
+            diff <(echo "$expected") <(echo "$run_output") >&2 || true
+            exit 1
+        fi
+    done
+done
+
+if [[ ! -s "$cache/link" ]]; then
+    echo "the system link line was not cached" >&2
+    exit 1
+fi
+
+echo "LLD link test passed successfully."
@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ZAPC="${1:-}"
+OUTPUT_DIR="${2:-}"
+
+if [[ -z "$ZAPC" || -z "$OUTPUT_DIR" || $# -lt 3 ]]; then
+    echo "Usage: $0 <zapc> <output-dir> <input>..." >&2
+    exit 1
+fi
+shift 2
+
+mkdir -p "$OUTPUT_DIR"
+
+for input in "$@"; do
+    name="$(basename "$input" .zp)"
+    for runtime in bitcode object; do
+        binary="$OUTPUT_DIR/$name-$runtime"
+        if ! compile_output=$("$ZAPC" "$input" -O2 "--runtime=$runtime" \
+                -o "$binary" 2>&1); then
+            echo "$name failed to compile with --runtime=$runtime:" >&2
+            echo "$compile_output" >&2
+            exit 1
+        fi
+        if [[ "$compile_output" == *"cannot use runtime bitcode"* ||
+              "$compile_output" == *"runtime bitcode not found"* ]]; then
+            echo "$name fell back to the runtime object:" >&2
+            echo "$compile_output" >&2
+            exit 1
+        fi
+        if ! run_output=$("$binary" 2>&1); then
+            echo "$name failed with --runtime=$runtime:" >&2
+            echo "$run_output" >&2
+            exit 1
+        fi
+    done
+
+    # Linked as bitcode, the runtime is internal to the program, so none of
+    # its entry points is exported any more.
+    exported="$(nm -g --defined-only "$OUTPUT_DIR/$name-bitcode" |
+                awk '{print $3}')"
+    if grep -Eq '^zap_(arc|string)_' <<<"$exported"; then
+        echo "$name exports runtime symbols despite --runtime=bitcode:" >&2
+        grep -E '^zap_(arc|string)_' <<<"$exported" >&2
+        exit 1
+    fi
+    exported="$(nm -g --defined-only "$OUTPUT_DIR/$name-object" |
+                awk '{print $3}')"
+    if ! grep -Fxq zap_string_release_ptr <<<"$exported"; then
+        echo "$name does not export the runtime with --runtime=object" >&2
+        exit 1
+    fi
+done
+
+echo "Runtime bitcode test passed successfully."